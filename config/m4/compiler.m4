@@ -377,6 +377,24 @@ CHECK_SPECIFIC_ATTRIBUTE([optimize], [NOOPTIMIZE],
                          [int foo (int arg) __attribute__ ((optimize("O0")));])
 
 
+#
+# Check for compiler support of per-function x86 target attributes, which are
+# used by memcpy implementations selected at runtime by the CPU flags.
+#
+CHECK_SPECIFIC_ATTRIBUTE([target_avx2], [TARGET_AVX2],
+                         [#include <immintrin.h>
+                          __attribute__((target("avx2")))
+                          void foo(__m256i *d, const __m256i *s) {
+                              _mm256_stream_si256(d, _mm256_loadu_si256(s));
+                          }])
+CHECK_SPECIFIC_ATTRIBUTE([target_avx512f], [TARGET_AVX512F],
+                         [#include <immintrin.h>
+                          __attribute__((target("avx512f")))
+                          void foo(__m512i *d, const __m512i *s) {
+                              _mm512_stream_si512(d, _mm512_loadu_si512(s));
+                          }])
+
+
 #
 # Compile code with frame pointer. Optimizations usually omit the frame pointer,
 # but if we are profiling the code with callgraph we need it.
@@ -95,6 +95,18 @@ AC_CHECK_DECLS([ethtool_cmd_speed, SPEED_UNKNOWN], [], [],
                [#include <linux/ethtool.h>])
 
 
+#
+# io_uring definitions
+#
+AC_CHECK_DECLS([__NR_io_uring_setup,
+                __NR_io_uring_register,
+                IORING_FEAT_NODROP,
+                IORING_REGISTER_PBUF_RING,
+                IORING_RECV_MULTISHOT], [], [],
+               [#include <sys/syscall.h>
+                #include <linux/io_uring.h>])
+
+
 #
 # PowerPC query for TB frequency
 #
@@ -193,6 +205,12 @@ AC_CHECK_HEADERS([sys/capability.h],
 AC_CHECK_DECLS([PR_SET_PTRACER], [], [], [#include <sys/prctl.h>])
 
 
+#
+# Check for cross memory attach
+#
+AC_CHECK_FUNCS([process_vm_readv])
+
+
 #
 # ipv6 s6_addr32/__u6_addr32 shortcuts for in6_addr
 # ip header structure layout name
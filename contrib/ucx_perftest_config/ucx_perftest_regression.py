@@ -0,0 +1,351 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+#
+# See file LICENSE for terms.
+#
+
+"""
+Run the ucx_perftest regression suite and compare its results with a baseline.
+
+  run      Run the suite over loopback (server and client on this host) for
+           every requested transport, several times, and write all results as
+           JSON lines (ucx_perftest -j output, with "transport" and "run" keys
+           added).
+  compare  Compare two result files. Every test is summarized by the mean of
+           its primary metric over all runs and a confidence interval; a test
+           is reported as a regression if it is slower than the baseline by
+           more than the threshold and the difference is statistically
+           significant (Welch's t-test). Exits with status 1 on regression.
+
+Examples:
+  ucx_perftest_regression.py run --runs 5 --output baseline.json
+  ucx_perftest_regression.py run --runs 5 --output current.json
+  ucx_perftest_regression.py compare baseline.json current.json
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+
+# Transports to run the suite over. "uct_tl" is the UCT transport name used
+# for UCT level tests, and "uct_suites" are the UCT batch files it supports.
+# UCT "self" and "intra" connect only within one process, so they cannot be
+# measured by a client/server ucx_perftest pair.
+TRANSPORTS = {
+    "shm": {"env": {"UCX_TLS": "shm"}, "uct_tl": "posix",
+            "uct_suites": ["regression_uct_am", "regression_uct_rma"]},
+    "tcp": {"env": {"UCX_TLS": "tcp"}, "uct_tl": "tcp",
+            "uct_suites": ["regression_uct_am"]},
+}
+
+UCP_SUITES = ["regression_ucp"]
+
+# Two-sided 95%/99% Student's t critical values for 1..30 degrees of freedom
+T_CRITICAL = {
+    0.95: [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+           2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+           2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052,
+           2.048, 2.045, 2.042],
+    0.99: [63.657, 9.925, 5.841, 4.604, 4.032, 3.707, 3.499, 3.355, 3.250,
+           3.169, 3.106, 3.055, 3.012, 2.977, 2.947, 2.921, 2.898, 2.878,
+           2.861, 2.845, 2.831, 2.819, 2.807, 2.797, 2.787, 2.779, 2.771,
+           2.763, 2.756, 2.750],
+}
+T_CRITICAL_INF = {0.95: 1.960, 0.99: 2.576}
+
+
+def t_critical(confidence, dof):
+    if dof < 1:
+        return float("inf")
+    table = T_CRITICAL[confidence]
+    if dof > len(table):
+        return T_CRITICAL_INF[confidence]
+    return table[int(dof) - 1]
+
+
+def find_tool(name, hint_dir):
+    path = os.path.join(hint_dir, name)
+    if os.access(path, os.X_OK):
+        return path
+    # build tree layout: src/tools/perf/ucx_perftest, src/tools/info/ucx_info
+    path = os.path.join(hint_dir, os.pardir, "info", name)
+    if os.access(path, os.X_OK):
+        return os.path.normpath(path)
+    return shutil.which(name)
+
+
+def find_uct_device(ucx_info, tl_name, env):
+    """Return the first device of a UCT transport, as reported by ucx_info"""
+    output = subprocess.check_output([ucx_info, "-d"], env=env,
+                                     universal_newlines=True)
+    transport = None
+    for line in output.splitlines():
+        match = re.match(r"#\s+Transport: (\S+)", line)
+        if match:
+            transport = match.group(1)
+            continue
+        match = re.match(r"#\s+Device: (\S+)", line)
+        if match and (transport == tl_name):
+            return match.group(1)
+    return None
+
+
+def scale_suite(suite_path, scale, tmpdir):
+    """Create a copy of the batch file with scaled iteration counts"""
+    scaled_path = os.path.join(tmpdir, os.path.basename(suite_path))
+    with open(suite_path) as src, open(scaled_path, "w") as dst:
+        for line in src:
+            dst.write(re.sub(r"-n\s+(\d+)",
+                             lambda m: "-n %d" % max(1, int(int(m.group(1)) *
+                                                            scale)),
+                             line))
+    return scaled_path
+
+
+def run_perftest_pair(perftest, args, env, port, timeout):
+    """Run ucx_perftest server and client on localhost, return client output"""
+    server = subprocess.Popen([perftest, "-p", str(port)] + args, env=env,
+                              stdout=subprocess.DEVNULL,
+                              stderr=subprocess.DEVNULL)
+    try:
+        time.sleep(1)
+        client = subprocess.run([perftest, "localhost", "-p", str(port)] + args,
+                                env=env, stdout=subprocess.PIPE,
+                                universal_newlines=True, timeout=timeout)
+        server.wait(timeout=timeout)
+    finally:
+        if server.poll() is None:
+            server.kill()
+            server.wait()
+
+    if client.returncode != 0:
+        sys.stderr.write("warning: '%s' exited with status %d\n" %
+                         (" ".join(args), client.returncode))
+    return client.stdout
+
+
+def cmd_run(opts):
+    perftest = opts.perftest or find_tool("ucx_perftest",
+                                          os.path.dirname(sys.argv[0]))
+    if perftest is None:
+        sys.exit("ucx_perftest not found, use --perftest")
+    ucx_info = opts.ucx_info or find_tool("ucx_info",
+                                          os.path.dirname(perftest))
+    suite_dir = opts.suite_dir or os.path.dirname(os.path.abspath(__file__))
+
+    output = open(opts.output, "w") if opts.output else sys.stdout
+    tmpdir  = tempfile.mkdtemp()
+    port    = opts.port
+    try:
+        for transport in opts.transports.split(","):
+            tl_config = TRANSPORTS[transport]
+            env = dict(os.environ)
+            env.update(tl_config["env"])
+
+            runs = [(suite, []) for suite in UCP_SUITES]
+            device = None
+            if ucx_info is not None:
+                device = find_uct_device(ucx_info, tl_config["uct_tl"], env)
+            if device is not None:
+                runs += [(suite, ["-x", tl_config["uct_tl"], "-d", device])
+                         for suite in tl_config["uct_suites"]]
+            else:
+                sys.stderr.write("warning: no UCT device for '%s', skipping "
+                                 "UCT tests\n" % tl_config["uct_tl"])
+
+            for run in range(opts.runs):
+                for suite, extra_args in runs:
+                    suite_path = os.path.join(suite_dir, suite)
+                    if opts.iter_scale != 1.0:
+                        suite_path = scale_suite(suite_path, opts.iter_scale,
+                                                 tmpdir)
+                    args = ["-j", "-b", suite_path] + extra_args
+                    if opts.warmup is not None:
+                        args += ["-w", str(opts.warmup)]
+                    if opts.cpus:
+                        args += ["-c", opts.cpus]
+                    sys.stderr.write("[%s run %d/%d] %s\n" %
+                                     (transport, run + 1, opts.runs, suite))
+                    stdout = run_perftest_pair(perftest, args, env, port,
+                                               opts.timeout)
+                    port += 1
+                    for line in stdout.splitlines():
+                        if not line.startswith("{"):
+                            continue
+                        record              = json.loads(line)
+                        record["transport"] = transport
+                        record["run"]       = run
+                        output.write(json.dumps(record, sort_keys=True) + "\n")
+                    output.flush()
+    finally:
+        shutil.rmtree(tmpdir)
+        if output is not sys.stdout:
+            output.close()
+
+
+def primary_metric(record, metric):
+    """Return (name, value, higher_is_better) of the metric to compare"""
+    if metric == "auto":
+        metric = "latency" if record["test_type"] == "pingpong" else "msgrate"
+    if metric == "latency":
+        return ("latency", record["result"]["latency"]["overall"], False)
+    elif metric == "bandwidth":
+        return ("bandwidth", record["result"]["bandwidth"]["overall"], True)
+    return ("msgrate", record["result"]["msgrate"]["overall"], True)
+
+
+def load_results(path, metric):
+    """Group the metric values of all runs by test"""
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("{"):
+                continue
+            record = json.loads(line)
+            key = (record.get("transport", "-"), record["name"],
+                   record["msg_size"], record["threads"])
+            name, value, higher_is_better = primary_metric(record, metric)
+            entry = results.setdefault(key, {"metric": name, "values": [],
+                                             "higher": higher_is_better})
+            entry["values"].append(value)
+    return results
+
+
+class Summary(object):
+    def __init__(self, values, confidence):
+        self.n    = len(values)
+        self.mean = statistics.mean(values)
+        self.var  = statistics.variance(values) if self.n > 1 else 0.0
+        self.ci   = (t_critical(confidence, self.n - 1) *
+                     math.sqrt(self.var / self.n)) if self.n > 1 else 0.0
+
+    def __str__(self):
+        if self.n > 1:
+            return "%.3f +- %.3f" % (self.mean, self.ci)
+        return "%.3f" % self.mean
+
+
+def is_significant(base, cur, confidence):
+    """Welch's t-test for the difference of two means"""
+    if (base.n < 2) or (cur.n < 2):
+        return None
+    se2 = (base.var / base.n) + (cur.var / cur.n)
+    if se2 == 0:
+        return base.mean != cur.mean
+    dof = se2 ** 2 / (((base.var / base.n) ** 2 / (base.n - 1)) +
+                      ((cur.var / cur.n) ** 2 / (cur.n - 1)))
+    t = abs(base.mean - cur.mean) / math.sqrt(se2)
+    return t > t_critical(confidence, math.floor(dof))
+
+
+def cmd_compare(opts):
+    baseline = load_results(opts.baseline, opts.metric)
+    current  = load_results(opts.current, opts.metric)
+    num_regressions = 0
+
+    for key in sorted(set(baseline) | set(current)):
+        test_name = "%s %s size=%d threads=%d" % key
+        if key not in baseline:
+            print("%-12s %s" % ("NEW", test_name))
+            continue
+        if key not in current:
+            print("%-12s %s" % ("MISSING", test_name))
+            continue
+
+        entry  = baseline[key]
+        base   = Summary(entry["values"], opts.confidence)
+        cur    = Summary(current[key]["values"], opts.confidence)
+        change = ((cur.mean - base.mean) / base.mean * 100.0
+                  if base.mean else 0.0)
+        worse  = (change < -opts.threshold) if entry["higher"] else \
+                 (change > opts.threshold)
+        better = (change > opts.threshold) if entry["higher"] else \
+                 (change < -opts.threshold)
+
+        significant = is_significant(base, cur, opts.confidence)
+        if significant is None:
+            # not enough runs for statistics, rely on the threshold only
+            significant = True
+
+        if worse and significant:
+            status = "REGRESSION"
+            num_regressions += 1
+        elif better and significant:
+            status = "IMPROVEMENT"
+        else:
+            status = "OK"
+
+        if (status != "OK") or opts.verbose:
+            print("%-12s %s %s: baseline %s, current %s (%+.1f%%)" %
+                  (status, test_name, entry["metric"], base, cur, change))
+
+    print("%d regression(s) found" % num_regressions)
+    return 1 if num_regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter)
+    sub = parser.add_subparsers(dest="command")
+    sub.required = True
+
+    run = sub.add_parser("run", help="run the regression suite")
+    run.add_argument("--perftest", help="path to ucx_perftest")
+    run.add_argument("--ucx-info", help="path to ucx_info")
+    run.add_argument("--suite-dir",
+                     help="directory of the batch files (default: script directory)")
+    run.add_argument("--transports", default=",".join(sorted(TRANSPORTS)),
+                     help="comma-separated list of: %s (default: all)" %
+                          ", ".join(sorted(TRANSPORTS)))
+    run.add_argument("--runs", type=int, default=5,
+                     help="number of runs of every test (default: 5)")
+    run.add_argument("--iter-scale", type=float, default=1.0,
+                     help="scale factor for iteration counts (default: 1)")
+    run.add_argument("--warmup", type=int,
+                     help="number of warm-up iterations (ucx_perftest -w)")
+    run.add_argument("--cpus", help="CPU list for ucx_perftest -c")
+    run.add_argument("--port", type=int, default=13337,
+                     help="first TCP port for server/client setup")
+    run.add_argument("--timeout", type=int, default=1800,
+                     help="timeout of a single suite run in seconds")
+    run.add_argument("--output", help="output file (default: stdout)")
+
+    compare = sub.add_parser("compare", help="compare results with baseline")
+    compare.add_argument("baseline", help="baseline results file")
+    compare.add_argument("current", help="current results file")
+    compare.add_argument("--threshold", type=float, default=5.0,
+                         help="minimal change in percent to report "
+                              "(default: 5)")
+    compare.add_argument("--confidence", type=float, default=0.95,
+                         choices=sorted(T_CRITICAL),
+                         help="confidence level (default: 0.95)")
+    compare.add_argument("--metric", default="auto",
+                         choices=["auto", "latency", "bandwidth", "msgrate"],
+                         help="metric to compare; auto uses latency for "
+                              "ping-pong tests and message rate otherwise")
+    compare.add_argument("-v", "--verbose", action="store_true",
+                         help="print unchanged tests as well")
+
+    opts = parser.parse_args()
+    if opts.command == "run":
+        for transport in opts.transports.split(","):
+            if transport not in TRANSPORTS:
+                parser.error("unknown transport '%s'" % transport)
+        cmd_run(opts)
+        return 0
+    return cmd_compare(opts)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
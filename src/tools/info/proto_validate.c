@@ -0,0 +1,649 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2020.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ucx_info.h"
+
+#include <ucp/core/ucp_ep.h>
+#include <ucp/core/ucp_ep.inl>
+#include <ucp/core/ucp_worker.h>
+#include <ucp/proto/proto_select.h>
+#include <ucs/datastruct/linear_func.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/string.h>
+#include <ucs/time/time.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+
+#define PVAL_TAG              0xc0ffee
+#define PVAL_MAX_SIZE         (4 * UCS_MBYTE)
+#define PVAL_WARMUP_ITERS     10
+#define PVAL_MIN_ITERS        10
+#define PVAL_MAX_ITERS        10000
+#define PVAL_MIN_TIME_SEC     0.02
+#define PVAL_TIMEOUT_SEC      10.0
+#define PVAL_SIZES_PER_RANGE  3
+#define PVAL_THRESH_SIZES     6
+#define PVAL_THRESH_ROUNDS    3
+#define PVAL_TOLERANCE        0.1 /* Minimal relative difference to prefer
+                                     one protocol over another */
+
+
+typedef struct {
+    ucp_context_h          context;
+    ucp_worker_h           worker;
+    ucp_ep_h               ep;
+    void                   *send_buffer;
+    void                   *recv_buffer;
+} pval_ctx_t;
+
+
+typedef struct {
+    size_t                 size;
+    double                 predicted; /* seconds */
+    double                 measured;  /* seconds */
+} pval_sample_t;
+
+
+/* Tag send protocols for contiguous host memory, in the order of message size */
+typedef enum {
+    PVAL_PROTO_SHORT,
+    PVAL_PROTO_BCOPY,
+    PVAL_PROTO_ZCOPY,
+    PVAL_PROTO_RNDV,
+    PVAL_PROTO_LAST
+} pval_proto_t;
+
+
+/* Tag send thresholds of the endpoint configuration, which select the protocol */
+typedef struct {
+    ucp_memtype_thresh_t   max_eager_short;
+    ssize_t                eager_max_short;
+    size_t                 zcopy_thresh;
+    ucp_rndv_thresh_t      rndv_rma_thresh;
+    ucp_rndv_thresh_t      rndv_am_thresh;
+} pval_thresh_t;
+
+
+static const char *pval_proto_names[] = {
+    [PVAL_PROTO_SHORT] = "eager_short",
+    [PVAL_PROTO_BCOPY] = "eager_bcopy",
+    [PVAL_PROTO_ZCOPY] = "eager_zcopy",
+    [PVAL_PROTO_RNDV]  = "rndv"
+};
+
+
+static ucs_status_t pval_wait(pval_ctx_t *ctx, void *request,
+                              ucs_time_t deadline)
+{
+    ucs_status_t status;
+
+    if (request == NULL) {
+        return UCS_OK;
+    } else if (UCS_PTR_IS_ERR(request)) {
+        return UCS_PTR_STATUS(request);
+    }
+
+    while ((status = ucp_request_check_status(request)) == UCS_INPROGRESS) {
+        ucp_worker_progress(ctx->worker);
+        if (ucs_get_time() > deadline) {
+            status = UCS_ERR_TIMED_OUT;
+            break;
+        }
+    }
+
+    ucp_request_free(request);
+    return status;
+}
+
+static ucs_status_t pval_transfer(pval_ctx_t *ctx, size_t size)
+{
+    ucs_time_t deadline = ucs_get_time() +
+                          ucs_time_from_sec(PVAL_TIMEOUT_SEC);
+    ucp_request_param_t param;
+    ucs_status_t status;
+    void *rreq, *sreq;
+
+    param.op_attr_mask = 0;
+
+    rreq = ucp_tag_recv_nbx(ctx->worker, ctx->recv_buffer, size, PVAL_TAG,
+                            (ucp_tag_t)-1, &param);
+    sreq = ucp_tag_send_nbx(ctx->ep, ctx->send_buffer, size, PVAL_TAG,
+                            &param);
+
+    status = pval_wait(ctx, sreq, deadline);
+    if (status != UCS_OK) {
+        pval_wait(ctx, rreq, deadline);
+        return status;
+    }
+
+    return pval_wait(ctx, rreq, deadline);
+}
+
+/* Average time of a single tag send, including its matching receive */
+static ucs_status_t pval_measure(pval_ctx_t *ctx, size_t size, double *time_p)
+{
+    ucs_time_t start_time, min_time, elapsed;
+    ucs_status_t status;
+    unsigned iters;
+
+    for (iters = 0; iters < PVAL_WARMUP_ITERS; ++iters) {
+        status = pval_transfer(ctx, size);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+
+    min_time   = ucs_time_from_sec(PVAL_MIN_TIME_SEC);
+    start_time = ucs_get_time();
+    iters      = 0;
+    do {
+        status = pval_transfer(ctx, size);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        ++iters;
+        elapsed = ucs_get_time() - start_time;
+    } while (((elapsed < min_time) || (iters < PVAL_MIN_ITERS)) &&
+             (iters < PVAL_MAX_ITERS));
+
+    *time_p = ucs_time_to_sec(elapsed) / iters;
+    return UCS_OK;
+}
+
+static double pval_predict(const ucp_proto_perf_range_t *perf_range,
+                           size_t size)
+{
+    while (size > perf_range->max_length) {
+        ++perf_range;
+    }
+
+    return ucs_linear_func_apply(perf_range->perf, size);
+}
+
+/*
+ * Measure the first, the last, and a geometric middle message size of every
+ * range, and print the measured time next to the model estimation.
+ */
+static void pval_validate_elem(pval_ctx_t *ctx,
+                               const ucp_proto_select_elem_t *select_elem,
+                               unsigned *num_samples_p)
+{
+    const ucp_proto_threshold_elem_t *thresh_elem = select_elem->thresholds;
+    size_t sizes[PVAL_SIZES_PER_RANGE];
+    size_t range_start, range_end;
+    pval_sample_t sample;
+    ucs_status_t status;
+    unsigned i;
+
+    printf("#   %10s  %-18s %12s %14s\n", "SIZE", "MODEL PROTOCOL",
+           "MODEL (ns)", "MEASURED (ns)");
+
+    range_start = 0;
+    do {
+        range_end = thresh_elem->max_msg_length;
+        if (range_start > PVAL_MAX_SIZE) {
+            break;
+        }
+
+        sizes[0] = range_start;
+        sizes[2] = ucs_min(range_end, PVAL_MAX_SIZE);
+        sizes[1] = (size_t)sqrt((double)ucs_max(sizes[0], 1) * sizes[2]);
+
+        for (i = 0; i < PVAL_SIZES_PER_RANGE; ++i) {
+            if ((i > 0) && (sizes[i] <= sizes[i - 1])) {
+                continue;
+            }
+
+            sample.size      = sizes[i];
+            sample.predicted = pval_predict(select_elem->perf_ranges,
+                                            sample.size);
+            status           = pval_measure(ctx, sample.size,
+                                            &sample.measured);
+            if (status != UCS_OK) {
+                printf("#   %10zu  %-18s < %s >\n", sample.size,
+                       thresh_elem->proto_config.proto->name,
+                       ucs_status_string(status));
+                return;
+            }
+
+            printf("#   %10zu  %-18s %12.0f %14.0f\n", sample.size,
+                   thresh_elem->proto_config.proto->name,
+                   sample.predicted * 1e9, sample.measured * 1e9);
+            ++(*num_samples_p);
+        }
+
+        range_start = range_end + 1;
+        ++thresh_elem;
+    } while (range_end != SIZE_MAX);
+}
+
+static void pval_thresh_save(const ucp_ep_config_t *config,
+                             pval_thresh_t *thresh)
+{
+    thresh->max_eager_short = config->tag.max_eager_short;
+    thresh->eager_max_short = config->tag.eager.max_short;
+    thresh->zcopy_thresh    =
+            config->tag.eager.mem_type_zcopy_thresh[UCS_MEMORY_TYPE_HOST];
+    thresh->rndv_rma_thresh = config->tag.rndv.rma_thresh;
+    thresh->rndv_am_thresh  = config->tag.rndv.am_thresh;
+}
+
+static void pval_thresh_restore(ucp_ep_config_t *config,
+                                const pval_thresh_t *thresh)
+{
+    config->tag.max_eager_short = thresh->max_eager_short;
+    config->tag.eager.max_short = thresh->eager_max_short;
+    config->tag.eager.mem_type_zcopy_thresh[UCS_MEMORY_TYPE_HOST] =
+            thresh->zcopy_thresh;
+    config->tag.rndv.rma_thresh = thresh->rndv_rma_thresh;
+    config->tag.rndv.am_thresh  = thresh->rndv_am_thresh;
+}
+
+/*
+ * Override the endpoint thresholds, so that a message of the given size is
+ * sent by the given protocol.
+ */
+static void pval_thresh_force(ucp_ep_config_t *config, pval_proto_t proto,
+                              size_t size)
+{
+    ssize_t max_short   = (proto == PVAL_PROTO_SHORT) ? (ssize_t)size : -1;
+    size_t zcopy_thresh = (proto == PVAL_PROTO_ZCOPY) ? 0 : SIZE_MAX;
+    size_t rndv_thresh  = (proto == PVAL_PROTO_RNDV)  ? 0 : SIZE_MAX;
+
+    config->tag.max_eager_short.memtype_off = max_short;
+    config->tag.max_eager_short.memtype_on  = max_short;
+    config->tag.eager.max_short             = max_short;
+    config->tag.eager.mem_type_zcopy_thresh[UCS_MEMORY_TYPE_HOST] =
+            zcopy_thresh;
+    config->tag.rndv.rma_thresh.remote      = rndv_thresh;
+    config->tag.rndv.am_thresh.remote       = rndv_thresh;
+}
+
+/*
+ * Find the first message size of every protocol which the endpoint uses for
+ * a tag send of contiguous host memory, following the logic of
+ * ucp_tag_send_nbx(). SIZE_MAX means the protocol is not used.
+ */
+static void pval_thresh_starts(ucp_context_h context,
+                               const ucp_ep_config_t *config,
+                               size_t starts[PVAL_PROTO_LAST])
+{
+    const ucp_memtype_thresh_t *max_eager_short = &config->tag.max_eager_short;
+    size_t zcopy_thresh, rndv_thresh;
+    ssize_t max_short;
+
+    max_short = ucs_max(max_eager_short->memtype_off, -1);
+    if (ucp_memory_type_cache_is_empty(context)) {
+        max_short = ucs_max(max_short, max_eager_short->memtype_on);
+    }
+
+    rndv_thresh = ucs_min(config->tag.rndv.rma_thresh.remote,
+                          config->tag.rndv.am_thresh.remote);
+    if (config->tag.eager.max_zcopy == 0) {
+        zcopy_thresh = rndv_thresh;
+    } else {
+        zcopy_thresh = ucs_min(rndv_thresh,
+                               config->tag.eager.mem_type_zcopy_thresh[
+                                       UCS_MEMORY_TYPE_HOST]);
+    }
+
+    /* Short is checked first, so other protocols start after its range */
+    starts[PVAL_PROTO_SHORT] = (max_short >= 0) ? 0 : SIZE_MAX;
+    starts[PVAL_PROTO_BCOPY] = max_short + 1;
+    starts[PVAL_PROTO_ZCOPY] = ucs_max(zcopy_thresh, starts[PVAL_PROTO_BCOPY]);
+    starts[PVAL_PROTO_RNDV]  = ucs_max(rndv_thresh, starts[PVAL_PROTO_BCOPY]);
+
+    /* Drop protocols whose range is empty */
+    if (starts[PVAL_PROTO_BCOPY] >= starts[PVAL_PROTO_ZCOPY]) {
+        starts[PVAL_PROTO_BCOPY] = SIZE_MAX;
+    }
+    if (starts[PVAL_PROTO_ZCOPY] >= starts[PVAL_PROTO_RNDV]) {
+        starts[PVAL_PROTO_ZCOPY] = SIZE_MAX;
+    }
+}
+
+/*
+ * Measure both protocols around the threshold which switches from 'lower' to
+ * 'upper', and report whether the measured crossover point agrees with it.
+ * Returns whether the threshold disagrees with the measurements.
+ */
+static int pval_check_threshold(pval_ctx_t *ctx, pval_proto_t lower,
+                                pval_proto_t upper, size_t thresh,
+                                ssize_t max_short)
+{
+    ucp_ep_config_t *config = ucp_ep_config(ctx->ep);
+    pval_sample_t samples[PVAL_THRESH_SIZES][2];
+    size_t crossover, early_size, late_size;
+    unsigned i, j, round, num_samples;
+    pval_thresh_t saved;
+    double time;
+    ucs_status_t status;
+    size_t size;
+
+    printf("#\n");
+    printf("# %s -> %s at %zu\n", pval_proto_names[lower],
+           pval_proto_names[upper], thresh);
+    printf("#   %10s  %16s %16s\n", "SIZE", pval_proto_names[lower],
+           pval_proto_names[upper]);
+
+    pval_thresh_save(config, &saved);
+
+    /* Sizes from thresh/4 to thresh*4, including the last size before the
+     * threshold, which both protocols can send */
+    num_samples = 0;
+    for (i = 0; i < PVAL_THRESH_SIZES; ++i) {
+        size = (i < 2) ? (thresh >> (2 - i)) :
+               (i == 2) ? (thresh - 1) : (thresh << (i - 3));
+        if ((size == 0) || (size > PVAL_MAX_SIZE) ||
+            ((num_samples > 0) &&
+             (size == samples[num_samples - 1][0].size)) ||
+            ((lower == PVAL_PROTO_SHORT) && ((ssize_t)size > max_short))) {
+            continue;
+        }
+
+        /* Alternate the protocols and keep the best time of each, to reduce
+         * the effect of noise on the comparison */
+        for (j = 0; j < 2; ++j) {
+            samples[num_samples][j].size     = size;
+            samples[num_samples][j].measured = INFINITY;
+        }
+
+        for (round = 0; round < (PVAL_THRESH_ROUNDS * 2); ++round) {
+            j = round % 2;
+            pval_thresh_force(config, (j == 0) ? lower : upper, size);
+            status = pval_measure(ctx, size, &time);
+            pval_thresh_restore(config, &saved);
+            if (status != UCS_OK) {
+                printf("#   %10zu  < %s >\n", size, ucs_status_string(status));
+                return 0;
+            }
+
+            samples[num_samples][j].measured =
+                    ucs_min(samples[num_samples][j].measured, time);
+        }
+
+        printf("#   %10zu  %16.0f %16.0f\n", size,
+               samples[num_samples][0].measured * 1e9,
+               samples[num_samples][1].measured * 1e9);
+        ++num_samples;
+    }
+
+    if (num_samples == 0) {
+        printf("#   < no message sizes to compare >\n");
+        return 0;
+    }
+
+    /* The crossover is the smallest size from which 'upper' is not slower */
+    crossover = SIZE_MAX;
+    for (i = num_samples; i > 0; --i) {
+        if (samples[i - 1][1].measured >
+            (samples[i - 1][0].measured * (1.0 + PVAL_TOLERANCE))) {
+            break;
+        }
+        crossover = samples[i - 1][0].size;
+    }
+
+    /* Largest size below the threshold where 'upper' is clearly faster, and
+     * largest size above it where 'lower' is clearly faster */
+    early_size = 0;
+    late_size  = 0;
+    for (i = 0; i < num_samples; ++i) {
+        size = samples[i][0].size;
+        if ((size < thresh) &&
+            (samples[i][1].measured <
+             (samples[i][0].measured * (1.0 - PVAL_TOLERANCE)))) {
+            early_size = size;
+        } else if ((size >= thresh) &&
+                   (samples[i][0].measured <
+                    (samples[i][1].measured * (1.0 - PVAL_TOLERANCE)))) {
+            late_size = size;
+        }
+    }
+
+    if (crossover == SIZE_MAX) {
+        printf("#   measured crossover: above %zu\n",
+               samples[num_samples - 1][0].size);
+    } else {
+        printf("#   measured crossover: %zu\n", crossover);
+    }
+
+    if (late_size != 0) {
+        printf("#   DISAGREE: threshold %zu is too low, %s is faster at %zu\n",
+               thresh, pval_proto_names[lower], late_size);
+        return 1;
+    } else if (early_size != 0) {
+        printf("#   DISAGREE: threshold %zu is too high, %s is faster at %zu\n",
+               thresh, pval_proto_names[upper], early_size);
+        return 1;
+    }
+
+    printf("#   agrees with the threshold\n");
+    return 0;
+}
+
+/*
+ * Compare every threshold which the endpoint configuration uses to switch tag
+ * send protocols with the measured crossover point of the protocols around it.
+ */
+static void pval_validate_thresholds(pval_ctx_t *ctx)
+{
+    const ucp_ep_config_t *config = ucp_ep_config(ctx->ep);
+    unsigned num_checked          = 0;
+    unsigned num_disagree         = 0;
+    size_t starts[PVAL_PROTO_LAST];
+    pval_proto_t lower, upper;
+
+    pval_thresh_starts(ctx->context, config, starts);
+
+    printf("#\n");
+    printf("# Endpoint tag send protocols:");
+    for (upper = 0; upper < PVAL_PROTO_LAST; ++upper) {
+        if (starts[upper] != SIZE_MAX) {
+            printf(" %s from %zu", pval_proto_names[upper], starts[upper]);
+        }
+    }
+    printf("\n");
+    printf("# Each protocol is forced on both sides of the threshold\n");
+
+    lower = PVAL_PROTO_LAST;
+    for (upper = 0; upper < PVAL_PROTO_LAST; ++upper) {
+        if (starts[upper] == SIZE_MAX) {
+            continue;
+        }
+
+        if (lower != PVAL_PROTO_LAST) {
+            if (starts[upper] > PVAL_MAX_SIZE) {
+                printf("#\n");
+                printf("# %s -> %s at %zu: above the largest measured "
+                       "size\n", pval_proto_names[lower],
+                       pval_proto_names[upper], starts[upper]);
+            } else {
+                num_disagree += pval_check_threshold(
+                        ctx, lower, upper, starts[upper],
+                        config->tag.eager.max_short);
+                ++num_checked;
+            }
+        }
+
+        lower = upper;
+    }
+
+    printf("#\n");
+    printf("# %u of %u thresholds disagree with the measurements\n",
+           num_disagree, num_checked);
+}
+
+static ucs_status_t pval_ctx_init(pval_ctx_t *ctx, unsigned dev_type_bitmap,
+                                  const ucp_ep_params_t *base_ep_params)
+{
+    ucp_worker_params_t worker_params;
+    ucp_ep_params_t ep_params;
+    ucp_address_t *address;
+    size_t address_length;
+    ucp_config_t *config;
+    ucp_params_t params;
+    ucs_status_t status;
+
+    status = ucp_config_read(NULL, NULL, &config);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucp_config_modify(config, "PROTO_ENABLE", "y");
+    if (!(dev_type_bitmap & UCS_BIT(UCT_DEVICE_TYPE_SELF))) {
+        ucp_config_modify(config, "SELF_DEVICES", "");
+    }
+    if (!(dev_type_bitmap & UCS_BIT(UCT_DEVICE_TYPE_SHM))) {
+        ucp_config_modify(config, "SHM_DEVICES", "");
+    }
+    if (!(dev_type_bitmap & UCS_BIT(UCT_DEVICE_TYPE_NET))) {
+        ucp_config_modify(config, "NET_DEVICES", "");
+    }
+
+    params.field_mask = UCP_PARAM_FIELD_FEATURES;
+    params.features   = UCP_FEATURE_TAG;
+
+    status = ucp_init(&params, config, &ctx->context);
+    ucp_config_release(config);
+    if (status != UCS_OK) {
+        printf("<Failed to create UCP context>\n");
+        return status;
+    }
+
+    worker_params.field_mask  = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+    worker_params.thread_mode = UCS_THREAD_MODE_SINGLE;
+
+    status = ucp_worker_create(ctx->context, &worker_params, &ctx->worker);
+    if (status != UCS_OK) {
+        printf("<Failed to create UCP worker>\n");
+        goto err_cleanup_context;
+    }
+
+    status = ucp_worker_get_address(ctx->worker, &address, &address_length);
+    if (status != UCS_OK) {
+        printf("<Failed to get UCP worker address>\n");
+        goto err_destroy_worker;
+    }
+
+    ep_params             = *base_ep_params;
+    ep_params.field_mask |= UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address     = address;
+
+    status = ucp_ep_create(ctx->worker, &ep_params, &ctx->ep);
+    ucp_worker_release_address(ctx->worker, address);
+    if (status != UCS_OK) {
+        printf("<Failed to create UCP endpoint>\n");
+        goto err_destroy_worker;
+    }
+
+    ctx->send_buffer = ucs_calloc(1, PVAL_MAX_SIZE, "pval_send_buffer");
+    ctx->recv_buffer = ucs_calloc(1, PVAL_MAX_SIZE, "pval_recv_buffer");
+    if ((ctx->send_buffer == NULL) || (ctx->recv_buffer == NULL)) {
+        printf("<Failed to allocate buffers>\n");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free_buffers;
+    }
+
+    /* Complete wireup, so the endpoint has its final configuration */
+    status = pval_transfer(ctx, 0);
+    if (status != UCS_OK) {
+        printf("<Failed to send a message: %s>\n", ucs_status_string(status));
+        goto err_free_buffers;
+    }
+
+    return UCS_OK;
+
+err_free_buffers:
+    ucs_free(ctx->recv_buffer);
+    ucs_free(ctx->send_buffer);
+    ucp_ep_destroy(ctx->ep);
+err_destroy_worker:
+    ucp_worker_destroy(ctx->worker);
+err_cleanup_context:
+    ucp_cleanup(ctx->context);
+    return status;
+}
+
+static void pval_ctx_cleanup(pval_ctx_t *ctx)
+{
+    ucs_free(ctx->recv_buffer);
+    ucs_free(ctx->send_buffer);
+    ucp_ep_destroy(ctx->ep);
+    ucp_worker_destroy(ctx->worker);
+    ucp_cleanup(ctx->context);
+}
+
+void validate_ucp_proto_perf(unsigned dev_type_bitmap,
+                             const ucp_ep_params_t *base_ep_params)
+{
+    const ucp_proto_select_elem_t *select_elem;
+    ucp_proto_select_param_t select_param;
+    unsigned num_samples = 0;
+    ucs_string_buffer_t strb;
+    ucp_ep_config_t *config;
+    ucs_status_t status;
+    pval_ctx_t ctx;
+
+    status = pval_ctx_init(&ctx, dev_type_bitmap, base_ep_params);
+    if (status != UCS_OK) {
+        return;
+    }
+
+    select_param.op_id      = UCP_OP_ID_TAG_SEND;
+    select_param.op_flags   = 0;
+    select_param.dt_class   = UCP_DATATYPE_CONTIG;
+    select_param.mem_type   = UCS_MEMORY_TYPE_HOST;
+    select_param.sys_dev    = 0;
+    select_param.sg_count   = 1;
+    select_param.padding[0] = 0;
+    select_param.padding[1] = 0;
+
+    config      = ucp_ep_config(ctx.ep);
+    select_elem = ucp_proto_select_lookup_slow(ctx.worker,
+                                               &config->proto_select,
+                                               ctx.ep->cfg_index,
+                                               UCP_WORKER_CFG_INDEX_NULL,
+                                               &select_param);
+
+    ucp_proto_select_param_str(&select_param, &strb);
+    printf("#\n");
+    printf("# Protocol performance model validation: %s, loopback\n",
+           ucs_string_buffer_cstr(&strb));
+    printf("# Measured time is the average time to complete a send and its "
+           "matching receive\n");
+    printf("# NOTE: tag send does not dispatch through the protocol selection "
+           "in this\n");
+    printf("#       version, so the measured time is of the regular tag send "
+           "path and\n");
+    printf("#       may use a different protocol than the model entry. No "
+           "verdict is made\n");
+    printf("#       on the model; the verdicts below are on the endpoint "
+           "thresholds\n");
+    printf("#\n");
+    ucs_string_buffer_cleanup(&strb);
+
+    if (select_elem == NULL) {
+        printf("# < no protocols were selected >\n");
+        goto out;
+    }
+
+    pval_validate_elem(&ctx, select_elem, &num_samples);
+
+    printf("#\n");
+    printf("# %u sizes measured\n", num_samples);
+
+out:
+    pval_validate_thresholds(&ctx);
+    printf("#\n");
+    pval_ctx_cleanup(&ctx);
+}
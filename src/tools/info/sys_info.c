@@ -14,6 +14,7 @@
 #include <ucs/time/time.h>
 #include <ucs/config/parser.h>
 #include <ucs/config/global_opts.h>
+#include <ucs/memory/numa.h>
 #include <sys/mman.h>
 #include <string.h>
 
@@ -86,6 +87,8 @@ void print_sys_info()
     printf("# Timer frequency: %.3f MHz\n", ucs_get_cpu_clocks_per_sec() / 1e6);
     printf("# CPU vendor: %s\n", cpu_vendor_names[ucs_arch_get_cpu_vendor()]);
     printf("# CPU model: %s\n", cpu_model_names[ucs_arch_get_cpu_model()]);
+    printf("# NUMA nodes: %u, current CPU on node %d\n", ucs_numa_num_nodes(),
+           ucs_numa_current_node());
     ucs_arch_print_memcpy_limits(&ucs_global_opts.arch);
     printf("# Memcpy bandwidth:\n");
     for (size = 4096; size <= 256 * UCS_MBYTE; size *= 2) {
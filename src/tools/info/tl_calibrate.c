@@ -0,0 +1,638 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2020.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ucx_info.h"
+
+#include <uct/base/uct_tuning.h>
+#include <ucs/async/async.h>
+#include <ucs/config/global_opts.h>
+#include <ucs/debug/log.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/string.h>
+#include <ucs/sys/sys.h>
+#include <ucs/time/time.h>
+#include <string.h>
+#include <stdlib.h>
+#include <alloca.h>
+
+
+#define CALIB_AM_ID           0
+#define CALIB_SHORT_ITERS     10000
+#define CALIB_LAT_ITERS       2000
+#define CALIB_LAT_WARMUP      100
+#define CALIB_BW_BYTES        (32 * UCS_MBYTE)
+#define CALIB_BW_MIN_ITERS    200
+#define CALIB_BW_MIN_SIZE     64
+#define CALIB_BW_MAX_SIZE     (64 * UCS_KBYTE)
+#define CALIB_MAX_SAMPLES     16
+#define CALIB_TIMEOUT_SEC     10.0
+
+
+typedef struct {
+    size_t                 count;
+    size_t                 bytes;
+} calib_rx_t;
+
+
+typedef struct {
+    uct_worker_h           worker;
+    uct_iface_h            iface[2];
+    uct_ep_h               ep[2];       /* ep[i] sends to iface[!i] */
+    calib_rx_t             rx[2];
+    calib_rx_t             *rx_p[2];    /* Receive counters of iface[i] */
+    uct_iface_attr_t       attr;
+    char                   *buffer;
+} calib_ctx_t;
+
+
+typedef struct {
+    uct_tuning_entry_t     entry;
+    unsigned               num_samples;
+    struct {
+        size_t             size;
+        double             bandwidth;
+    } samples[CALIB_MAX_SAMPLES];
+} calib_result_t;
+
+
+typedef struct {
+    calib_result_t         *results;
+    unsigned               count;
+} calib_results_t;
+
+
+typedef struct {
+    const char             *buffer;
+    size_t                 length;
+} calib_pack_arg_t;
+
+
+static ucs_status_t calib_am_handler(void *arg, void *data, size_t length,
+                                     unsigned flags)
+{
+    calib_rx_t *rx = arg;
+
+    ++rx->count;
+    rx->bytes += length;
+    return UCS_OK;
+}
+
+static size_t calib_pack_cb(void *dest, void *arg)
+{
+    calib_pack_arg_t *pack_arg = arg;
+
+    memcpy(dest, pack_arg->buffer, pack_arg->length);
+    return pack_arg->length;
+}
+
+static ucs_status_t calib_wait_rx(calib_ctx_t *ctx, const calib_rx_t *rx,
+                                  size_t count)
+{
+    ucs_time_t deadline = ucs_get_time() +
+                          ucs_time_from_sec(CALIB_TIMEOUT_SEC);
+
+    while (rx->count < count) {
+        uct_worker_progress(ctx->worker);
+        if (ucs_get_time() > deadline) {
+            return UCS_ERR_TIMED_OUT;
+        }
+    }
+
+    return UCS_OK;
+}
+
+static ucs_status_t calib_send_short(calib_ctx_t *ctx, int index)
+{
+    ucs_time_t deadline = ucs_get_time() +
+                          ucs_time_from_sec(CALIB_TIMEOUT_SEC);
+    ucs_status_t status;
+
+    for (;;) {
+        status = uct_ep_am_short(ctx->ep[index], CALIB_AM_ID, 0, NULL, 0);
+        if (status != UCS_ERR_NO_RESOURCE) {
+            return status;
+        }
+
+        uct_worker_progress(ctx->worker);
+        if (ucs_get_time() > deadline) {
+            return UCS_ERR_TIMED_OUT;
+        }
+    }
+}
+
+/* Average CPU time of a successful am_short call */
+static ucs_status_t calib_measure_overhead(calib_ctx_t *ctx, double *overhead_p)
+{
+    size_t expected = ctx->rx_p[1]->count + CALIB_SHORT_ITERS;
+    ucs_time_t elapsed, start;
+    ucs_status_t status;
+    unsigned count, n;
+
+    /* make sure the connection is established */
+    status = calib_send_short(ctx, 0);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ++expected;
+    elapsed = 0;
+    count   = 0;
+    while (count < CALIB_SHORT_ITERS) {
+        start = ucs_get_time();
+        for (n = 0; (n < 16) && (count + n < CALIB_SHORT_ITERS); ++n) {
+            status = uct_ep_am_short(ctx->ep[0], CALIB_AM_ID, 0, NULL, 0);
+            if (status != UCS_OK) {
+                break;
+            }
+        }
+        elapsed += ucs_get_time() - start;
+        count   += n;
+
+        if ((status != UCS_OK) && (status != UCS_ERR_NO_RESOURCE)) {
+            return status;
+        }
+
+        uct_worker_progress(ctx->worker);
+    }
+
+    status = calib_wait_rx(ctx, ctx->rx_p[1], expected);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    *overhead_p = ucs_time_to_sec(elapsed) / CALIB_SHORT_ITERS;
+    return UCS_OK;
+}
+
+/* Half of the round trip time of a ping-pong with short messages */
+static ucs_status_t calib_measure_latency(calib_ctx_t *ctx, double *latency_p)
+{
+    ucs_time_t start = 0;
+    ucs_status_t status;
+    size_t expected;
+    unsigned i;
+
+    for (i = 0; i < CALIB_LAT_WARMUP + CALIB_LAT_ITERS; ++i) {
+        if (i == CALIB_LAT_WARMUP) {
+            start = ucs_get_time();
+        }
+
+        expected = ctx->rx_p[1]->count + 1;
+        status   = calib_send_short(ctx, 0);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        status = calib_wait_rx(ctx, ctx->rx_p[1], expected);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        expected = ctx->rx_p[0]->count + 1;
+        status   = calib_send_short(ctx, 1);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        status = calib_wait_rx(ctx, ctx->rx_p[0], expected);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+
+    *latency_p = ucs_time_to_sec(ucs_get_time() - start) /
+                 (CALIB_LAT_ITERS * 2);
+    return UCS_OK;
+}
+
+/* Streaming bandwidth of bcopy messages of a given size */
+static ucs_status_t calib_measure_bandwidth(calib_ctx_t *ctx, size_t size,
+                                            double *bandwidth_p)
+{
+    calib_pack_arg_t pack_arg = {ctx->buffer, size};
+    size_t iters              = ucs_max(CALIB_BW_BYTES / size,
+                                        CALIB_BW_MIN_ITERS);
+    ucs_time_t deadline, start;
+    size_t expected, count;
+    ucs_status_t status;
+    ssize_t packed;
+
+    start    = ucs_get_time();
+    deadline = start + ucs_time_from_sec(CALIB_TIMEOUT_SEC);
+    expected = ctx->rx_p[1]->count + iters;
+    count    = 0;
+    while (count < iters) {
+        packed = uct_ep_am_bcopy(ctx->ep[0], CALIB_AM_ID, calib_pack_cb,
+                                 &pack_arg, 0);
+        if (packed >= 0) {
+            ++count;
+            continue;
+        } else if (packed != UCS_ERR_NO_RESOURCE) {
+            return (ucs_status_t)packed;
+        }
+
+        uct_worker_progress(ctx->worker);
+        if (ucs_get_time() > deadline) {
+            return UCS_ERR_TIMED_OUT;
+        }
+    }
+
+    status = calib_wait_rx(ctx, ctx->rx_p[1], expected);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    *bandwidth_p = (size * iters) / ucs_time_to_sec(ucs_get_time() - start);
+    return UCS_OK;
+}
+
+static ucs_status_t calib_iface_open(calib_ctx_t *ctx, uct_md_h md,
+                                     const uct_tl_resource_desc_t *resource,
+                                     int index)
+{
+    uct_iface_params_t iface_params = {
+        .field_mask            = UCT_IFACE_PARAM_FIELD_OPEN_MODE   |
+                                 UCT_IFACE_PARAM_FIELD_DEVICE      |
+                                 UCT_IFACE_PARAM_FIELD_STATS_ROOT  |
+                                 UCT_IFACE_PARAM_FIELD_RX_HEADROOM |
+                                 UCT_IFACE_PARAM_FIELD_CPU_MASK,
+        .open_mode             = UCT_IFACE_OPEN_MODE_DEVICE,
+        .mode.device.tl_name   = resource->tl_name,
+        .mode.device.dev_name  = resource->dev_name,
+        .stats_root            = ucs_stats_get_root(),
+        .rx_headroom           = 0
+    };
+    uct_iface_config_t *iface_config;
+    ucs_status_t status;
+
+    UCS_CPU_ZERO(&iface_params.cpu_mask);
+    status = uct_md_iface_config_read(md, resource->tl_name, NULL, NULL,
+                                      &iface_config);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = uct_iface_open(md, ctx->worker, &iface_params, iface_config,
+                            &ctx->iface[index]);
+    uct_config_release(iface_config);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = uct_iface_set_am_handler(ctx->iface[index], CALIB_AM_ID,
+                                      calib_am_handler, &ctx->rx[index], 0);
+    if (status != UCS_OK) {
+        uct_iface_close(ctx->iface[index]);
+        return status;
+    }
+
+    ctx->rx_p[index] = &ctx->rx[index];
+    uct_iface_progress_enable(ctx->iface[index],
+                              UCT_PROGRESS_SEND | UCT_PROGRESS_RECV);
+    return UCS_OK;
+}
+
+static ucs_status_t calib_ep_create(calib_ctx_t *ctx, int index)
+{
+    uct_iface_h peer_iface = ctx->iface[!index];
+    uct_device_addr_t *dev_addr;
+    uct_iface_addr_t *iface_addr;
+    uct_ep_params_t ep_params;
+    ucs_status_t status;
+
+    dev_addr   = alloca(ctx->attr.device_addr_len);
+    iface_addr = alloca(ctx->attr.iface_addr_len);
+
+    status = uct_iface_get_device_address(peer_iface, dev_addr);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = uct_iface_get_address(peer_iface, iface_addr);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    if (!uct_iface_is_reachable(ctx->iface[index], dev_addr, iface_addr)) {
+        return UCS_ERR_UNREACHABLE;
+    }
+
+    ep_params.field_mask = UCT_EP_PARAM_FIELD_IFACE    |
+                           UCT_EP_PARAM_FIELD_DEV_ADDR |
+                           UCT_EP_PARAM_FIELD_IFACE_ADDR;
+    ep_params.iface      = ctx->iface[index];
+    ep_params.dev_addr   = dev_addr;
+    ep_params.iface_addr = iface_addr;
+    return uct_ep_create(&ep_params, &ctx->ep[index]);
+}
+
+static void calib_cleanup(calib_ctx_t *ctx)
+{
+    int i;
+
+    for (i = 0; i < 2; ++i) {
+        if (ctx->ep[i] != NULL) {
+            uct_ep_destroy(ctx->ep[i]);
+        }
+    }
+
+    if (ctx->iface[1] != ctx->iface[0]) {
+        uct_iface_close(ctx->iface[1]);
+    }
+    uct_iface_close(ctx->iface[0]);
+    ucs_free(ctx->buffer);
+}
+
+/*
+ * Connect two interfaces of the device to each other, or an interface to
+ * itself if the transport can reach only the same interface (e.g "self").
+ */
+static ucs_status_t calib_setup(calib_ctx_t *ctx, uct_md_h md,
+                                const uct_tl_resource_desc_t *resource)
+{
+    const uint64_t required_flags = UCT_IFACE_FLAG_AM_SHORT |
+                                    UCT_IFACE_FLAG_AM_BCOPY |
+                                    UCT_IFACE_FLAG_CONNECT_TO_IFACE;
+    ucs_status_t status;
+
+    status = calib_iface_open(ctx, md, resource, 0);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = uct_iface_query(ctx->iface[0], &ctx->attr);
+    if (status != UCS_OK) {
+        goto err_close_iface;
+    }
+
+    if (!ucs_test_all_flags(ctx->attr.cap.flags, required_flags)) {
+        status = UCS_ERR_UNSUPPORTED;
+        goto err_close_iface;
+    }
+
+    ctx->buffer = ucs_calloc(1, ctx->attr.cap.am.max_bcopy, "calib_buffer");
+    if (ctx->buffer == NULL) {
+        status = UCS_ERR_NO_MEMORY;
+        goto err_close_iface;
+    }
+
+    status = calib_iface_open(ctx, md, resource, 1);
+    if (status != UCS_OK) {
+        goto err_free_buffer;
+    }
+
+    status = calib_ep_create(ctx, 0);
+    if (status == UCS_ERR_UNREACHABLE) {
+        uct_iface_close(ctx->iface[1]);
+        ctx->iface[1] = ctx->iface[0];
+        ctx->rx_p[1]  = ctx->rx_p[0];
+        status        = calib_ep_create(ctx, 0);
+    }
+    if (status != UCS_OK) {
+        goto err_cleanup;
+    }
+
+    status = calib_ep_create(ctx, 1);
+    if (status != UCS_OK) {
+        goto err_cleanup;
+    }
+
+    return UCS_OK;
+
+err_cleanup:
+    calib_cleanup(ctx);
+    return status;
+err_free_buffer:
+    ucs_free(ctx->buffer);
+err_close_iface:
+    uct_iface_close(ctx->iface[0]);
+    return status;
+}
+
+static ucs_status_t calib_run(uct_md_h md,
+                              const uct_tl_resource_desc_t *resource,
+                              calib_result_t *result)
+{
+    ucs_async_context_t *async;
+    calib_ctx_t ctx  = {0};
+    double bandwidth = 0;
+    double best_bw;
+    ucs_status_t status;
+    size_t size;
+
+    memset(result, 0, sizeof(*result));
+    ucs_strncpy_zero(result->entry.tl_name, resource->tl_name,
+                     sizeof(result->entry.tl_name));
+    ucs_strncpy_zero(result->entry.dev_name, resource->dev_name,
+                     sizeof(result->entry.dev_name));
+
+    status = ucs_async_context_create(UCS_ASYNC_MODE_THREAD_SPINLOCK, &async);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = uct_worker_create(async, UCS_THREAD_MODE_SINGLE, &ctx.worker);
+    if (status != UCS_OK) {
+        goto out_async_ctx_destroy;
+    }
+
+    status = calib_setup(&ctx, md, resource);
+    if (status != UCS_OK) {
+        goto out_worker_destroy;
+    }
+
+    status = calib_measure_overhead(&ctx, &result->entry.perf.overhead);
+    if (status != UCS_OK) {
+        goto out_cleanup;
+    }
+
+    status = calib_measure_latency(&ctx, &result->entry.perf.latency);
+    if (status != UCS_OK) {
+        goto out_cleanup;
+    }
+
+    /* the model adds the send overhead to the latency */
+    if (result->entry.perf.latency > result->entry.perf.overhead) {
+        result->entry.perf.latency -= result->entry.perf.overhead;
+    }
+
+    best_bw = 0;
+    for (size = CALIB_BW_MIN_SIZE;
+         (size <= ucs_min(ctx.attr.cap.am.max_bcopy, CALIB_BW_MAX_SIZE)) &&
+         (result->num_samples < CALIB_MAX_SAMPLES);
+         size *= 2) {
+        status = calib_measure_bandwidth(&ctx, size, &bandwidth);
+        if (status != UCS_OK) {
+            goto out_cleanup;
+        }
+
+        result->samples[result->num_samples].size      = size;
+        result->samples[result->num_samples].bandwidth = bandwidth;
+        ++result->num_samples;
+        best_bw = ucs_max(best_bw, bandwidth);
+    }
+
+    result->entry.perf.bandwidth = best_bw;
+
+out_cleanup:
+    calib_cleanup(&ctx);
+out_worker_destroy:
+    uct_worker_destroy(ctx.worker);
+out_async_ctx_destroy:
+    ucs_async_context_destroy(async);
+    return status;
+}
+
+static void calib_md(uct_component_h component, const char *md_name,
+                     const char *req_tl_name, calib_results_t *results)
+{
+    uct_tl_resource_desc_t *resources;
+    unsigned i, num_resources;
+    uct_md_config_t *md_config;
+    calib_result_t *result;
+    ucs_status_t status;
+    uct_md_h md;
+
+    status = uct_md_config_read(component, NULL, NULL, &md_config);
+    if (status != UCS_OK) {
+        return;
+    }
+
+    status = uct_md_open(component, md_name, md_config, &md);
+    uct_config_release(md_config);
+    if (status != UCS_OK) {
+        return;
+    }
+
+    status = uct_md_query_tl_resources(md, &resources, &num_resources);
+    if (status != UCS_OK) {
+        goto out_close_md;
+    }
+
+    for (i = 0; i < num_resources; ++i) {
+        if ((req_tl_name != NULL) &&
+            strcmp(resources[i].tl_name, req_tl_name)) {
+            continue;
+        }
+
+        result = ucs_realloc(results->results,
+                             sizeof(*result) * (results->count + 1),
+                             "calib_results");
+        if (result == NULL) {
+            break;
+        }
+
+        results->results = result;
+        result           = &results->results[results->count];
+
+        fprintf(stderr, "calibrating %s/%s... ", resources[i].tl_name,
+                resources[i].dev_name);
+        status = calib_run(md, &resources[i], result);
+        if (status == UCS_OK) {
+            fprintf(stderr, "done\n");
+            ++results->count;
+        } else {
+            fprintf(stderr, "skipped (%s)\n", ucs_status_string(status));
+        }
+    }
+
+    uct_release_tl_resource_list(resources);
+out_close_md:
+    uct_md_close(md);
+}
+
+static void calib_print_profile(FILE *stream, const calib_results_t *results)
+{
+    const calib_result_t *result;
+    unsigned i;
+
+    fprintf(stream, "#\n");
+    fprintf(stream, "# UCX transport tuning profile, measured on %s\n",
+            ucs_get_host_name());
+    fprintf(stream, "# Format: <tl>/<dev> overhead=<nsec> latency=<nsec> "
+            "bandwidth=<MB/s>\n");
+    fprintf(stream, "#\n");
+
+    for (result = results->results;
+         result < results->results + results->count; ++result) {
+        fprintf(stream, "#\n");
+        for (i = 0; i < result->num_samples; ++i) {
+            fprintf(stream, "#   %s/%s %7zu bytes: %.2f MB/s\n",
+                    result->entry.tl_name, result->entry.dev_name,
+                    result->samples[i].size,
+                    result->samples[i].bandwidth / UCS_MBYTE);
+        }
+        uct_tuning_entry_print(stream, &result->entry);
+    }
+}
+
+void calibrate_uct_transports(const char *req_tl_name)
+{
+    calib_results_t results = {NULL, 0};
+    uct_component_attr_t component_attr;
+    uct_component_h *components;
+    unsigned i, j, num_components;
+    const char *path;
+    ucs_status_t status;
+    FILE *stream;
+
+    status = uct_query_components(&components, &num_components);
+    if (status != UCS_OK) {
+        printf("#   < failed to query UCT components >\n");
+        return;
+    }
+
+    /* measure the transports without applying a previous profile */
+    path                        = ucs_global_opts.tuning_path;
+    ucs_global_opts.tuning_path = "";
+
+    for (i = 0; i < num_components; ++i) {
+        component_attr.field_mask = UCT_COMPONENT_ATTR_FIELD_MD_RESOURCE_COUNT;
+        status = uct_component_query(components[i], &component_attr);
+        if (status != UCS_OK) {
+            continue;
+        }
+
+        component_attr.field_mask   = UCT_COMPONENT_ATTR_FIELD_MD_RESOURCES;
+        component_attr.md_resources =
+                alloca(sizeof(*component_attr.md_resources) *
+                       component_attr.md_resource_count);
+        status = uct_component_query(components[i], &component_attr);
+        if (status != UCS_OK) {
+            continue;
+        }
+
+        for (j = 0; j < component_attr.md_resource_count; ++j) {
+            calib_md(components[i], component_attr.md_resources[j].md_name,
+                     req_tl_name, &results);
+        }
+    }
+
+    uct_release_component_list(components);
+    ucs_global_opts.tuning_path = (char*)path;
+
+    if (strlen(path)) {
+        stream = fopen(path, "w");
+        if (stream == NULL) {
+            printf("# < failed to open '%s' for writing: %m >\n", path);
+            goto out;
+        }
+
+        calib_print_profile(stream, &results);
+        fclose(stream);
+        printf("# wrote %u entries to tuning profile '%s'\n", results.count,
+               path);
+    } else {
+        calib_print_profile(stdout, &results);
+    }
+
+out:
+    ucs_free(results.results);
+}
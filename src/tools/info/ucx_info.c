@@ -30,6 +30,12 @@ static void usage() {
     printf("  -c              Show UCX configuration\n");
     printf("  -a              Show also hidden configuration\n");
     printf("  -f              Display fully decorated output\n");
+    printf("  -T              Measure transports performance and write a tuning profile\n");
+    printf("                  to UCX_TUNING_PATH (or standard output, if not set)\n");
+    printf("  -P              Measure tag send on a loopback endpoint for every protocol\n");
+    printf("                  range, show it next to the protocol performance model, and\n");
+    printf("                  compare the endpoint protocol thresholds with measured\n");
+    printf("                  crossover points\n");
     printf("\nUCP information (-u is required):\n");
     printf("  -p              Show UCP context information\n");
     printf("  -w              Show UCP worker information\n");
@@ -43,7 +49,7 @@ static void usage() {
     printf("                  Modifiers to use in combination with above features:\n");
     printf("                    'e' : error handling\n");
     printf("\nOther settings:\n");
-    printf("  -t <name>       Filter devices information using specified transport (requires -d)\n");
+    printf("  -t <name>       Filter devices information using specified transport (requires -d or -T)\n");
     printf("  -n <count>      Estimated UCP endpoint count (for ucp_init)\n");
     printf("  -N <count>      Estimated UCP endpoint count per node (for ucp_init)\n");
     printf("  -D <type>       Set which device types to use when creating UCP context:\n");
@@ -77,7 +83,7 @@ int main(int argc, char **argv)
     mem_size                 = NULL;
     dev_type_bitmap          = UINT_MAX;
     ucp_ep_params.field_mask = 0;
-    while ((c = getopt(argc, argv, "fahvcydbswpet:n:u:D:m:N:")) != -1) {
+    while ((c = getopt(argc, argv, "fahvcydbswpePTt:n:u:D:m:N:")) != -1) {
         switch (c) {
         case 'f':
             print_flags |= UCS_CONFIG_PRINT_CONFIG | UCS_CONFIG_PRINT_HEADER | UCS_CONFIG_PRINT_DOC;
@@ -112,6 +118,12 @@ int main(int argc, char **argv)
         case 'e':
             print_opts |= PRINT_UCP_EP;
             break;
+        case 'T':
+            print_opts |= CALIBRATE_TRANSPORTS;
+            break;
+        case 'P':
+            print_opts |= VALIDATE_PROTO_PERF;
+            break;
         case 'm':
             print_opts |= PRINT_MEM_MAP;
             mem_size = optarg;
@@ -201,6 +213,10 @@ int main(int argc, char **argv)
         print_uct_info(print_opts, print_flags, tl_name);
     }
 
+    if (print_opts & CALIBRATE_TRANSPORTS) {
+        calibrate_uct_transports(tl_name);
+    }
+
     if (print_flags & UCS_CONFIG_PRINT_CONFIG) {
         ucs_config_parser_print_all_opts(stdout, UCS_DEFAULT_ENV_PREFIX,
                                          print_flags);
@@ -216,5 +232,9 @@ int main(int argc, char **argv)
                        ucp_num_eps, ucp_num_ppn, dev_type_bitmap, mem_size);
     }
 
+    if (print_opts & VALIDATE_PROTO_PERF) {
+        validate_ucp_proto_perf(dev_type_bitmap, &ucp_ep_params);
+    }
+
     return 0;
 }
@@ -41,6 +41,7 @@ typedef enum {
     UCX_PERF_CMD_TAG,
     UCX_PERF_CMD_TAG_SYNC,
     UCX_PERF_CMD_STREAM,
+    UCX_PERF_CMD_PUT_BATCH,
     UCX_PERF_CMD_LAST
 } ucx_perf_cmd_t;
 
@@ -84,7 +85,9 @@ enum ucx_perf_test_flags {
     UCX_PERF_TEST_FLAG_TAG_UNEXP_PROBE  = UCS_BIT(5), /* For tag tests, use probe to get unexpected receive */
     UCX_PERF_TEST_FLAG_VERBOSE          = UCS_BIT(7), /* Print error messages */
     UCX_PERF_TEST_FLAG_STREAM_RECV_DATA = UCS_BIT(8), /* For stream tests, use recv data API */
-    UCX_PERF_TEST_FLAG_FLUSH_EP         = UCS_BIT(9)  /* Issue flush on endpoint instead of worker */
+    UCX_PERF_TEST_FLAG_FLUSH_EP         = UCS_BIT(9), /* Issue flush on endpoint instead of worker */
+    UCX_PERF_TEST_FLAG_CQ               = UCS_BIT(10) /* For tag and stream tests, get completions
+                                                         from the worker completion queue */
 };
 
 
@@ -400,6 +400,7 @@ static ucs_status_t ucx_perf_test_check_params(ucx_perf_params_t *params)
         ((params->send_mem_type != UCS_MEMORY_TYPE_HOST) ||
          (params->recv_mem_type != UCS_MEMORY_TYPE_HOST)) &&
         ((params->command == UCX_PERF_CMD_PUT) ||
+         (params->command == UCX_PERF_CMD_PUT_BATCH) ||
          (params->command == UCX_PERF_CMD_GET) ||
          (params->command == UCX_PERF_CMD_ADD) ||
          (params->command == UCX_PERF_CMD_FADD) ||
@@ -946,6 +947,7 @@ static ucs_status_t ucp_perf_test_fill_params(ucx_perf_params_t *params,
     message_size = ucx_perf_get_message_size(params);
     switch (params->command) {
     case UCX_PERF_CMD_PUT:
+    case UCX_PERF_CMD_PUT_BATCH:
     case UCX_PERF_CMD_GET:
         ucp_params->features |= UCP_FEATURE_RMA;
         break;
@@ -1696,6 +1698,11 @@ static ucs_status_t ucp_perf_setup(ucx_perf_context_t *perf)
 
     worker_params.field_mask  = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
     worker_params.thread_mode = perf->params.thread_mode;
+    if (perf->params.flags & UCX_PERF_TEST_FLAG_CQ) {
+        /* Both sides may have a full window of outstanding operations */
+        worker_params.field_mask |= UCP_WORKER_PARAM_FIELD_CQ_SIZE;
+        worker_params.cq_size     = 2 * perf->params.max_outstanding;
+    }
 
     for (i = 0; i < thread_count; i++) {
         perf->ucp.tctx[i].tid              = i;
@@ -14,6 +14,7 @@
 
 extern "C" {
 #include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
 #include <ucs/sys/math.h>
 #include <ucs/sys/sys.h>
 }
@@ -37,12 +38,53 @@ public:
     ucp_perf_test_runner(ucx_perf_context_t &perf) :
         m_perf(perf),
         m_outstanding(0),
-        m_max_outstanding(m_perf.params.max_outstanding)
+        m_max_outstanding(m_perf.params.max_outstanding),
+        m_batch_ops(NULL)
 
     {
         ucs_assert_always(m_max_outstanding > 0);
     }
 
+    ~ucp_perf_test_runner()
+    {
+        ucs_free(m_batch_ops);
+    }
+
+    /**
+     * Make ucp_put_batch_op_t ops[msg_size_cnt] array, each element of which
+     * puts one scatter-gather entry of the send buffer to the remote buffer
+     */
+    ucs_status_t create_batch_ops(void *buffer, uint64_t remote_addr,
+                                  ucp_rkey_h rkey)
+    {
+        const size_t count = m_perf.params.msg_size_cnt;
+        size_t offset, it;
+
+        m_batch_ops = (ucp_put_batch_op_t*)ucs_malloc(count *
+                                                      sizeof(*m_batch_ops),
+                                                      "ucp_put_batch_ops");
+        if (m_batch_ops == NULL) {
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        offset = 0;
+        for (it = 0; it < count; ++it) {
+            m_batch_ops[it].ep          = m_perf.ucp.ep;
+            m_batch_ops[it].buffer      = (char*)buffer + offset;
+            m_batch_ops[it].length      = m_perf.params.msg_size_list[it];
+            m_batch_ops[it].remote_addr = remote_addr + offset;
+            m_batch_ops[it].rkey        = rkey;
+
+            if (m_perf.params.iov_stride) {
+                offset += m_perf.params.iov_stride;
+            } else {
+                offset += m_batch_ops[it].length;
+            }
+        }
+
+        return UCS_OK;
+    }
+
     void create_iov_buffer(ucp_dt_iov_t *iov, void *buffer)
     {
         size_t iov_length_it, iov_it;
@@ -89,16 +131,58 @@ public:
         }
     }
 
+    void UCS_F_ALWAYS_INLINE progress_cq() {
+        static const unsigned max_entries = 16;
+        ucp_cq_entry_t entries[max_entries];
+        unsigned i, count;
+
+        do {
+            count = ucp_worker_cq_poll(m_perf.ucp.worker, entries, max_entries);
+            for (i = 0; i < count; ++i) {
+                op_completed();
+                ucp_request_free(entries[i].request);
+            }
+        } while (count == max_entries);
+    }
+
+    void UCS_F_ALWAYS_INLINE progress_worker() {
+        ucp_worker_progress(m_perf.ucp.worker);
+        if (m_perf.params.flags & UCX_PERF_TEST_FLAG_CQ) {
+            progress_cq();
+        }
+    }
+
     void UCS_F_ALWAYS_INLINE progress_responder() {
         if (!(FLAGS & UCX_PERF_TEST_FLAG_ONE_SIDED) &&
             !(m_perf.params.flags & UCX_PERF_TEST_FLAG_ONE_SIDED))
         {
-            ucp_worker_progress(m_perf.ucp.worker);
+            progress_worker();
         }
     }
 
     void UCS_F_ALWAYS_INLINE progress_requestor() {
-        ucp_worker_progress(m_perf.ucp.worker);
+        progress_worker();
+    }
+
+    void *send_cq(ucp_ep_h ep, void *buffer, unsigned length,
+                  ucp_datatype_t datatype)
+    {
+        ucp_request_param_t param;
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_DATATYPE | UCP_OP_ATTR_FLAG_CQ;
+        param.datatype     = datatype;
+
+        /* coverity[switch_selector_expr_is_constant] */
+        switch (CMD) {
+        case UCX_PERF_CMD_TAG:
+            return ucp_tag_send_nbx(ep, buffer, length, TAG, &param);
+        case UCX_PERF_CMD_TAG_SYNC:
+            return ucp_tag_send_sync_nbx(ep, buffer, length, TAG, &param);
+        case UCX_PERF_CMD_STREAM:
+            return ucp_stream_send_nbx(ep, buffer, length, &param);
+        default:
+            return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM);
+        }
     }
 
     ssize_t UCS_F_ALWAYS_INLINE wait_stream_recv(void *request)
@@ -128,6 +212,15 @@ public:
         ucp_request_free(request);
     }
 
+    static void send_nbx_cb(void *request, ucs_status_t status,
+                            void *user_data)
+    {
+        ucp_perf_test_runner *test = (ucp_perf_test_runner*)user_data;
+
+        test->op_completed();
+        ucp_request_free(request);
+    }
+
     static void tag_recv_cb(void *request, ucs_status_t status,
                             ucp_tag_recv_info_t *info)
     {
@@ -169,6 +262,15 @@ public:
         case UCX_PERF_CMD_TAG_SYNC:
         case UCX_PERF_CMD_STREAM:
             wait_window(1, true);
+            if (m_perf.params.flags & UCX_PERF_TEST_FLAG_CQ) {
+                /* Every returned request is reported to the completion queue */
+                request = send_cq(ep, buffer, length, datatype);
+                if (ucs_likely(!UCS_PTR_IS_PTR(request))) {
+                    return UCS_PTR_STATUS(request);
+                }
+                op_started();
+                return UCS_OK;
+            }
             /* coverity[switch_selector_expr_is_constant] */
             switch (CMD) {
             case UCX_PERF_CMD_TAG:
@@ -206,6 +308,8 @@ public:
                 return UCS_ERR_INVALID_PARAM;
             }
             return ucp_put(ep, buffer, length, remote_addr, rkey);
+        case UCX_PERF_CMD_PUT_BATCH:
+            return send_batch(buffer, length);
         case UCX_PERF_CMD_GET:
             return ucp_get(ep, buffer, length, remote_addr, rkey);
         case UCX_PERF_CMD_ADD:
@@ -245,6 +349,26 @@ public:
         }
     }
 
+    ucs_status_t recv_cq(ucp_worker_h worker, void *buffer, unsigned length,
+                         ucp_datatype_t datatype)
+    {
+        ucp_request_param_t param;
+        void *request;
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_DATATYPE | UCP_OP_ATTR_FLAG_CQ;
+        param.datatype     = datatype;
+
+        request = ucp_tag_recv_nbx(worker, buffer, length, TAG, TAG_MASK,
+                                   &param);
+        if (ucs_likely(!UCS_PTR_IS_PTR(request))) {
+            return UCS_PTR_STATUS(request);
+        }
+
+        /* Reported to the completion queue even if already completed */
+        op_started();
+        return UCS_OK;
+    }
+
     ucs_status_t UCS_F_ALWAYS_INLINE
     recv(ucp_worker_h worker, ucp_ep_h ep, void *buffer, unsigned length,
          ucp_datatype_t datatype, uint8_t sn)
@@ -263,6 +387,9 @@ public:
                     progress_responder();
                 }
             }
+            if (m_perf.params.flags & UCX_PERF_TEST_FLAG_CQ) {
+                return recv_cq(worker, buffer, length, datatype);
+            }
             request = ucp_tag_recv_nb(worker, buffer, length, datatype, TAG, TAG_MASK,
                                       tag_recv_cb);
             if (ucs_likely(!UCS_PTR_IS_PTR(request))) {
@@ -290,6 +417,14 @@ public:
             default:
                 return UCS_ERR_INVALID_PARAM;
             }
+        case UCX_PERF_CMD_PUT_BATCH:
+            /* coverity[switch_selector_expr_is_constant] */
+            switch (TYPE) {
+            case UCX_PERF_TEST_TYPE_STREAM_UNI:
+                return UCS_OK;
+            default:
+                return UCS_ERR_INVALID_PARAM;
+            }
         case UCX_PERF_CMD_GET:
         case UCX_PERF_CMD_ADD:
         case UCX_PERF_CMD_FADD:
@@ -321,7 +456,7 @@ public:
     {
         volatile uint8_t *ptr = (uint8_t*)buffer;
 
-        if ((CMD == UCX_PERF_CMD_PUT) &&
+        if (((CMD == UCX_PERF_CMD_PUT) || (CMD == UCX_PERF_CMD_PUT_BATCH)) &&
             (TYPE == UCX_PERF_TEST_TYPE_STREAM_UNI)) {
             while (*ptr != UCP_PERF_LAST_ITER_SN) {
                 progress_responder();
@@ -335,7 +470,7 @@ public:
     ucs_status_t send_last_iter(ucp_ep_h ep, void *buffer,
                                 uint64_t remote_addr, ucp_rkey_h rkey)
     {
-        if ((CMD == UCX_PERF_CMD_PUT) &&
+        if (((CMD == UCX_PERF_CMD_PUT) || (CMD == UCX_PERF_CMD_PUT_BATCH)) &&
             (TYPE == UCX_PERF_TEST_TYPE_STREAM_UNI)) {
             fence();
             *(uint8_t*)buffer = UCP_PERF_LAST_ITER_SN;
@@ -436,6 +571,7 @@ public:
 
     ucs_status_t run_stream_uni()
     {
+        ucs_status_t status;
         unsigned my_index;
         ucp_worker_h worker;
         ucp_ep_h ep;
@@ -475,6 +611,13 @@ public:
                                                    m_perf.ucp.recv_iov, &recv_length,
                                                    &recv_buffer);
 
+        if ((CMD == UCX_PERF_CMD_PUT_BATCH) && (my_index == 1)) {
+            status = create_batch_ops(send_buffer, remote_addr, rkey);
+            if (status != UCS_OK) {
+                return status;
+            }
+        }
+
         if (my_index == 0) {
             UCX_PERF_TEST_FOREACH(&m_perf) {
                 recv(worker, ep, recv_buffer, recv_length, recv_datatype, sn);
@@ -520,6 +663,29 @@ public:
     }
 
 private:
+    ucs_status_t UCS_F_ALWAYS_INLINE
+    send_batch(void *buffer, unsigned length)
+    {
+        ucp_request_param_t param;
+        void *request;
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                             UCP_OP_ATTR_FIELD_USER_DATA;
+        param.cb.send      = send_nbx_cb;
+        param.user_data    = this;
+
+        wait_window(1, true);
+        *((uint8_t*)buffer + length - 1) = 0;
+        request = ucp_put_batch_nbx(m_perf.ucp.worker, m_batch_ops,
+                                    m_perf.params.msg_size_cnt, &param);
+        if (ucs_likely(!UCS_PTR_IS_PTR(request))) {
+            return UCS_PTR_STATUS(request);
+        }
+
+        op_started();
+        return UCS_OK;
+    }
+
     ucs_status_t UCS_F_ALWAYS_INLINE
     recv_stream_data(ucp_ep_h ep, unsigned length, ucp_datatype_t datatype)
     {
@@ -581,6 +747,7 @@ private:
     ucx_perf_context_t &m_perf;
     unsigned           m_outstanding;
     const unsigned     m_max_outstanding;
+    ucp_put_batch_op_t *m_batch_ops;
 };
 
 
@@ -626,6 +793,7 @@ ucs_status_t ucp_perf_test_dispatch(ucx_perf_context_t *perf)
     UCS_PP_FOREACH(TEST_CASE_ALL_OSD, perf,
         (UCX_PERF_CMD_PUT,   UCX_PERF_TEST_TYPE_PINGPONG),
         (UCX_PERF_CMD_PUT,   UCX_PERF_TEST_TYPE_STREAM_UNI),
+        (UCX_PERF_CMD_PUT_BATCH, UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_GET,   UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_ADD,   UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_FADD,  UCX_PERF_TEST_TYPE_STREAM_UNI),
@@ -31,6 +31,7 @@
 #include <sys/types.h>
 #include <sys/poll.h>
 #include <locale.h>
+#include <time.h>
 #if defined (HAVE_MPI)
 #  include <mpi.h>
 #elif defined (HAVE_RTE)
@@ -40,16 +41,20 @@
 #define MAX_BATCH_FILES         32
 #define MAX_CPUS                1024
 #define TL_RESOURCE_NAME_NONE   "<none>"
-#define TEST_PARAMS_ARGS        "t:n:s:W:O:w:D:i:H:oSCqM:r:T:d:x:A:BUm:"
+#define TEST_PARAMS_ARGS        "t:n:s:W:O:w:D:i:H:oSCqM:r:T:d:x:A:BUQm:"
 #define TEST_ID_UNDEFINED       -1
 
+/* Process environment variables */
+extern char **environ;
+
 enum {
     TEST_FLAG_PRINT_RESULTS = UCS_BIT(0),
     TEST_FLAG_PRINT_TEST    = UCS_BIT(1),
     TEST_FLAG_SET_AFFINITY  = UCS_BIT(8),
     TEST_FLAG_NUMERIC_FMT   = UCS_BIT(9),
     TEST_FLAG_PRINT_FINAL   = UCS_BIT(10),
-    TEST_FLAG_PRINT_CSV     = UCS_BIT(11)
+    TEST_FLAG_PRINT_CSV     = UCS_BIT(11),
+    TEST_FLAG_PRINT_JSON    = UCS_BIT(12)
 };
 
 typedef struct sock_rte_group {
@@ -141,6 +146,10 @@ test_type_t tests[] = {
     {"ucp_put_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_PUT, UCX_PERF_TEST_TYPE_STREAM_UNI,
      "put bandwidth", "overhead", 32},
 
+    {"ucp_put_batch_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_PUT_BATCH,
+     UCX_PERF_TEST_TYPE_STREAM_UNI,
+     "batched put bandwidth / message rate", "overhead", 32},
+
     {"ucp_get", UCX_PERF_API_UCP, UCX_PERF_CMD_GET, UCX_PERF_TEST_TYPE_STREAM_UNI,
      "get latency / bandwidth / message rate", "latency", 1},
 
@@ -226,7 +235,8 @@ static void print_progress(char **test_names, unsigned num_names,
     unsigned i;
 
     if (!(flags & TEST_FLAG_PRINT_RESULTS) ||
-        (!final && (flags & TEST_FLAG_PRINT_FINAL)))
+        (!final && (flags & TEST_FLAG_PRINT_FINAL)) ||
+        (flags & TEST_FLAG_PRINT_JSON)) /* printed by print_json_result() */
     {
         return;
     }
@@ -286,6 +296,10 @@ static void print_header(struct perftest_context *ctx)
     test_type_t *test;
     unsigned i;
 
+    if (ctx->flags & TEST_FLAG_PRINT_JSON) {
+        return;
+    }
+
     test = (ctx->params.test_id == TEST_ID_UNDEFINED) ? NULL :
            &tests[ctx->params.test_id];
 
@@ -349,7 +363,8 @@ static void print_test_name(struct perftest_context *ctx)
     char buf[200];
     unsigned i, pos;
 
-    if (!(ctx->flags & TEST_FLAG_PRINT_CSV) && (ctx->num_batch_files > 0)) {
+    if (!(ctx->flags & (TEST_FLAG_PRINT_CSV | TEST_FLAG_PRINT_JSON)) &&
+        (ctx->num_batch_files > 0)) {
         strcpy(buf, "+--------------+---------+---------+---------+----------+----------+-----------+-----------+");
 
         pos = 1;
@@ -368,6 +383,157 @@ static void print_test_name(struct perftest_context *ctx)
     }
 }
 
+static void print_json_string(const char *str)
+{
+    const char *p;
+
+    putchar('"');
+    for (p = str; *p != '\0'; ++p) {
+        if ((*p == '"') || (*p == '\\')) {
+            printf("\\%c", *p);
+        } else if ((unsigned char)*p < 0x20) {
+            printf("\\u%04x", (unsigned char)*p);
+        } else {
+            putchar(*p);
+        }
+    }
+    putchar('"');
+}
+
+static void print_json_env(void)
+{
+    const char *sep = "";
+    char **envp;
+    char *value;
+    int name_len;
+
+    printf("{");
+    for (envp = environ; *envp != NULL; ++envp) {
+        value = strchr(*envp, '=');
+        if (strncmp(*envp, "UCX_", 4) || (value == NULL)) {
+            continue;
+        }
+
+        name_len = value - *envp;
+        printf("%s\"%.*s\":", sep, name_len, *envp);
+        print_json_string(value + 1);
+        sep = ",";
+    }
+    printf("}");
+}
+
+/*
+ * Print the result of a single test as one line of JSON, together with the
+ * test parameters and the environment it was measured in, so results of
+ * different runs can be collected and compared by scripts.
+ */
+static void print_json_result(struct perftest_context *ctx,
+                              const perftest_params_t *params,
+                              const ucx_perf_result_t *result)
+{
+    static const char *api_names[] = {
+        [UCX_PERF_API_UCT] = "uct",
+        [UCX_PERF_API_UCP] = "ucp"
+    };
+    static const char *test_type_names[] = {
+        [UCX_PERF_TEST_TYPE_PINGPONG]   = "pingpong",
+        [UCX_PERF_TEST_TYPE_STREAM_UNI] = "stream_uni",
+        [UCX_PERF_TEST_TYPE_STREAM_BI]  = "stream_bi"
+    };
+    static const char *uct_layout_names[] = {
+        [UCT_PERF_DATA_LAYOUT_SHORT] = "short",
+        [UCT_PERF_DATA_LAYOUT_BCOPY] = "bcopy",
+        [UCT_PERF_DATA_LAYOUT_ZCOPY] = "zcopy"
+    };
+    static const char *ucp_datatype_names[] = {
+        [UCP_PERF_DATATYPE_CONTIG] = "contig",
+        [UCP_PERF_DATATYPE_IOV]    = "iov"
+    };
+    static const char *thread_mode_names[] = {
+        [UCS_THREAD_MODE_SINGLE]     = "single",
+        [UCS_THREAD_MODE_SERIALIZED] = "serialized",
+        [UCS_THREAD_MODE_MULTI]      = "multi"
+    };
+    const ucx_perf_params_t *perf_params = &params->super;
+    const test_type_t *test              = &tests[params->test_id];
+    char timestamp[32];
+    struct tm tm;
+    time_t now;
+    unsigned i;
+
+    now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ",
+             gmtime_r(&now, &tm));
+
+    /* test identification */
+    printf("{\"name\":\"");
+    if (ctx->num_batch_files == 0) {
+        printf("%s", test->name);
+    }
+    for (i = 0; i < ctx->num_batch_files; ++i) {
+        printf("%s%s", (i == 0) ? "" : "/", ctx->test_names[i]);
+    }
+    printf("\",\"test\":\"%s\",\"api\":\"%s\",\"test_type\":\"%s\"",
+           test->name, api_names[perf_params->api],
+           test_type_names[perf_params->test_type]);
+
+    /* test parameters */
+    if (perf_params->api == UCX_PERF_API_UCT) {
+        printf(",\"tl\":\"%s\",\"dev\":\"%s\",\"data_layout\":\"%s\"",
+               perf_params->uct.tl_name, perf_params->uct.dev_name,
+               uct_layout_names[perf_params->uct.data_layout]);
+        printf(",\"fc_window\":%u", perf_params->uct.fc_window);
+    } else {
+        printf(",\"data_layout\":\"%s,%s\"",
+               ucp_datatype_names[perf_params->ucp.send_datatype],
+               ucp_datatype_names[perf_params->ucp.recv_datatype]);
+    }
+    printf(",\"msg_size\":%zu,\"msg_size_list\":[",
+           ucx_perf_get_message_size(perf_params));
+    for (i = 0; i < perf_params->msg_size_cnt; ++i) {
+        printf("%s%zu", (i == 0) ? "" : ",", perf_params->msg_size_list[i]);
+    }
+    printf("],\"iov_stride\":%zu,\"am_hdr_size\":%zu", perf_params->iov_stride,
+           perf_params->am_hdr_size);
+    printf(",\"send_mem\":\"%s\",\"recv_mem\":\"%s\"",
+           ucs_memory_type_names[perf_params->send_mem_type],
+           ucs_memory_type_names[perf_params->recv_mem_type]);
+    printf(",\"threads\":%u,\"thread_mode\":\"%s\"", perf_params->thread_count,
+           thread_mode_names[perf_params->thread_mode]);
+    printf(",\"max_outstanding\":%u,\"warmup_iter\":%"PRIu64
+           ",\"max_iter\":%"PRIu64",\"flags\":\"0x%x\"",
+           perf_params->max_outstanding, perf_params->warmup_iter,
+           perf_params->max_iter, perf_params->flags);
+
+    /* environment */
+    printf(",\"version\":\"%s\",\"host\":", ucp_get_version_string());
+    print_json_string(ucs_get_host_name());
+    printf(",\"timestamp\":\"%s\",\"affinity\":[", timestamp);
+    if (ctx->flags & TEST_FLAG_SET_AFFINITY) {
+        for (i = 0; i < ctx->num_cpus; ++i) {
+            printf("%s%u", (i == 0) ? "" : ",", ctx->cpus[i]);
+        }
+    }
+    printf("],\"env\":");
+    print_json_env();
+
+    /* results: latency in usec, bandwidth in MB/s, message rate in msg/s */
+    printf(",\"result\":{\"iterations\":%"PRIu64",\"elapsed_time\":%.6f"
+           ",\"bytes\":%"PRIu64, result->iters, result->elapsed_time,
+           result->bytes);
+    printf(",\"latency\":{\"typical\":%.3f,\"average\":%.3f,\"overall\":%.3f}",
+           result->latency.typical * 1000000.0,
+           result->latency.moment_average * 1000000.0,
+           result->latency.total_average * 1000000.0);
+    printf(",\"bandwidth\":{\"average\":%.2f,\"overall\":%.2f}",
+           result->bandwidth.moment_average / (1024.0 * 1024.0),
+           result->bandwidth.total_average / (1024.0 * 1024.0));
+    printf(",\"msgrate\":{\"average\":%.0f,\"overall\":%.0f}}}\n",
+           result->msgrate.moment_average, result->msgrate.total_average);
+
+    fflush(stdout);
+}
+
 static void print_memory_type_usage(void)
 {
     ucs_memory_type_t it;
@@ -415,6 +581,7 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("     -s <size>      list of scatter-gather sizes for single message (%zu)\n",
                                 ctx->params.super.msg_size_list[0]);
     printf("                    for example: \"-s 16,48,8192,8192,14\"\n");
+    printf("                    for ucp_put_batch_bw, every entry is a put in the batch\n");
     printf("     -m <send mem type>[,<recv mem type>]\n");
     printf("                    memory type of message for sender and receiver (host)\n");
     print_memory_type_usage();
@@ -442,6 +609,8 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("     -N             use numeric formatting (thousands separator)\n");
     printf("     -f             print only final numbers\n");
     printf("     -v             print CSV-formatted output\n");
+    printf("     -j             print final results as JSON, one object per line,\n");
+    printf("                    including test parameters and environment\n");
     printf("\n");
     printf("  UCT only:\n");
     printf("     -d <device>    device to use for testing\n");
@@ -471,6 +640,8 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("                        iov    - Scatter-gather list\n");
     printf("     -C             use wild-card tag for tag tests\n");
     printf("     -U             force unexpected flow by using tag probe\n");
+    printf("     -Q             get completions of tag and stream operations from the\n");
+    printf("                    worker completion queue, instead of callbacks\n");
     printf("     -r <mode>      receive mode for stream tests (recv)\n");
     printf("                        recv       : Use ucp_stream_recv_nb\n");
     printf("                        recv_data  : Use ucp_stream_recv_data_nb\n");
@@ -706,6 +877,9 @@ static ucs_status_t parse_test_params(perftest_params_t *params, char opt,
     case 'U':
         params->super.flags |= UCX_PERF_TEST_FLAG_TAG_UNEXP_PROBE;
         return UCS_OK;
+    case 'Q':
+        params->super.flags |= UCX_PERF_TEST_FLAG_CQ;
+        return UCS_OK;
     case 'M':
         if (!strcmp(opt_arg, "single")) {
             params->super.thread_mode = UCS_THREAD_MODE_SINGLE;
@@ -883,7 +1057,7 @@ static ucs_status_t parse_opts(struct perftest_context *ctx, int mpi_initialized
     ctx->mpi                    = mpi_initialized;
 
     optind = 1;
-    while ((c = getopt (argc, argv, "p:b:Nfvc:P:h" TEST_PARAMS_ARGS)) != -1) {
+    while ((c = getopt (argc, argv, "p:b:Nfvjc:P:h" TEST_PARAMS_ARGS)) != -1) {
         switch (c) {
         case 'p':
             ctx->port = atoi(optarg);
@@ -902,6 +1076,9 @@ static ucs_status_t parse_opts(struct perftest_context *ctx, int mpi_initialized
         case 'v':
             ctx->flags |= TEST_FLAG_PRINT_CSV;
             break;
+        case 'j':
+            ctx->flags |= TEST_FLAG_PRINT_JSON;
+            break;
         case 'c':
             ctx->flags |= TEST_FLAG_SET_AFFINITY;
             status = parse_cpus(optarg, ctx);
@@ -1582,7 +1759,12 @@ static ucs_status_t run_test_recurs(struct perftest_context *ctx,
 
     if (depth >= ctx->num_batch_files) {
         print_test_name(ctx);
-        return ucx_perf_run(&parent_params->super, &result);
+        status = ucx_perf_run(&parent_params->super, &result);
+        if ((status == UCS_OK) && (ctx->flags & TEST_FLAG_PRINT_JSON) &&
+            (ctx->flags & TEST_FLAG_PRINT_RESULTS)) {
+            print_json_result(ctx, parent_params, &result);
+        }
+        return status;
     }
 
     batch_file = fopen(ctx->batch_files[depth], "r");
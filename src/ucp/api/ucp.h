@@ -165,8 +165,10 @@ enum ucp_worker_params_field {
     UCP_WORKER_PARAM_FIELD_CPU_MASK     = UCS_BIT(1), /**< Worker's CPU bitmap */
     UCP_WORKER_PARAM_FIELD_EVENTS       = UCS_BIT(2), /**< Worker's events bitmap */
     UCP_WORKER_PARAM_FIELD_USER_DATA    = UCS_BIT(3), /**< User data */
-    UCP_WORKER_PARAM_FIELD_EVENT_FD     = UCS_BIT(4)  /**< External event file
+    UCP_WORKER_PARAM_FIELD_EVENT_FD     = UCS_BIT(4), /**< External event file
                                                            descriptor */
+    UCP_WORKER_PARAM_FIELD_CQ_SIZE      = UCS_BIT(5)  /**< Completion queue
+                                                           size */
 };
 
 
@@ -604,10 +606,16 @@ typedef enum {
                                                         synchronization with the
                                                         remote peer before releasing
                                                         the local send buffer */
-    UCP_OP_ATTR_FLAG_FORCE_IMM_CMPL = UCS_BIT(18)  /**< force immediate complete
+    UCP_OP_ATTR_FLAG_FORCE_IMM_CMPL = UCS_BIT(18), /**< force immediate complete
                                                         operation, fail if the
                                                         operation cannot be
                                                         completed immediately */
+    UCP_OP_ATTR_FLAG_CQ             = UCS_BIT(19)  /**< report the completion to
+                                                        the worker completion
+                                                        queue, see
+                                                        @ref ucp_worker_cq_poll.
+                                                        Ignored if a callback is
+                                                        set */
 } ucp_op_attr_t;
 
 
@@ -1101,6 +1109,16 @@ typedef struct ucp_worker_params {
      */
     int                     event_fd;
 
+    /**
+     * Initial number of entries in the worker completion queue, which collects
+     * completions of operations posted with @ref UCP_OP_ATTR_FLAG_CQ.
+     * This value is optional.
+     * If it's not set (along with its corresponding bit in the field_mask -
+     * UCP_WORKER_PARAM_FIELD_CQ_SIZE), a default size is used. The completion
+     * queue grows on demand, so completions are never dropped.
+     */
+    unsigned                cq_size;
+
 } ucp_worker_params_t;
 
 
@@ -1317,6 +1335,26 @@ struct ucp_tag_recv_info {
 };
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Worker completion queue entry
+ *
+ * The completion queue entry describes an operation which was posted with
+ * @ref UCP_OP_ATTR_FLAG_CQ and completed. It is filled by
+ * @ref ucp_worker_cq_poll.
+ */
+typedef struct ucp_cq_entry {
+    /** Request handle which was returned when the operation was posted. The
+     *  application must release it with @ref ucp_request_free. */
+    void                                   *request;
+    /** User data passed in @ref ucp_request_param_t::user_data, or NULL if
+     *  @ref UCP_OP_ATTR_FIELD_USER_DATA was not set */
+    void                                   *user_data;
+    /** Completion status of the operation */
+    ucs_status_t                           status;
+} ucp_cq_entry_t;
+
+
 /**
  * @ingroup UCP_CONTEXT
  * @brief Operation parameters passed to @ref ucp_tag_send_nbx,
@@ -1416,6 +1454,23 @@ typedef struct {
 } ucp_request_param_t;
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Remote memory put operation descriptor.
+ *
+ * The structure describes a single element of a batch of remote memory put
+ * operations submitted by @ref ucp_put_batch_nbx.
+ */
+typedef struct ucp_put_batch_op {
+    ucp_ep_h      ep;          /**< Remote endpoint handle */
+    const void    *buffer;     /**< Pointer to the local source address */
+    size_t        length;      /**< Length of the data to put, in bytes */
+    uint64_t      remote_addr; /**< Destination remote memory address */
+    ucp_rkey_h    rkey;        /**< Remote memory key associated with
+                                    @a remote_addr */
+} ucp_put_batch_op_t;
+
+
 /**
  * @ingroup UCP_WORKER
  * @brief Active Message handler parameters passed to
@@ -1823,6 +1878,39 @@ void ucp_worker_release_address(ucp_worker_h worker, ucp_address_t *address);
 unsigned ucp_worker_progress(ucp_worker_h worker);
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Retrieve completed operations from the worker completion queue.
+ *
+ * This routine moves up to @a max_entries completions of operations posted
+ * with @ref UCP_OP_ATTR_FLAG_CQ from the worker completion queue to the
+ * @a entries array, in the order they were completed. Operations are completed
+ * by @ref ucp_worker_progress, so the application typically calls this routine
+ * after progressing the worker, instead of handling a callback per request.
+ *
+ * @note
+ * @li Every request handle returned by a non-blocking routine which was called
+ * with @ref UCP_OP_ATTR_FLAG_CQ is reported exactly once, and must be
+ * released with @ref ucp_request_free only after it was retrieved by this
+ * routine. An operation which completes immediately returns its status
+ * instead of a request handle, and is not reported, unless
+ * @ref UCP_OP_ATTR_FLAG_NO_IMM_CMPL is set.
+ * @li Releasing a request before it is completed cancels its report.
+ * @li If the completion queue cannot be extended, an operation which would
+ * complete immediately with @ref UCP_OP_ATTR_FLAG_NO_IMM_CMPL returns
+ * UCS_ERR_NO_MEMORY, and a later completion is not reported, so it can be
+ * detected only by @ref ucp_request_check_status.
+ *
+ * @param [in]  worker       Worker to poll.
+ * @param [out] entries      Array of completion entries to fill.
+ * @param [in]  max_entries  Size of the @a entries array.
+ *
+ * @return Number of entries which were filled.
+ */
+unsigned ucp_worker_cq_poll(ucp_worker_h worker, ucp_cq_entry_t *entries,
+                            unsigned max_entries);
+
+
 /**
  * @ingroup UCP_WORKER
  * @brief Poll for endpoints that are ready to consume streaming data.
@@ -1902,6 +1990,10 @@ ucs_status_t ucp_worker_get_efd(ucp_worker_h worker, int *fd);
  * notification and may not progress some of the requests as it would when
  * calling @ref ucp_worker_progress (which is not invoked in that duration).
  *
+ * @note If UCX_WAIT_SPIN_TIME configuration parameter is set, this routine
+ * first calls @ref ucp_worker_progress repeatedly, for up to the configured
+ * time, and returns without blocking if any events were processed.
+ *
  * @note UCP @ref ucp_feature "features" have to be triggered
  *   with @ref UCP_FEATURE_WAKEUP to select proper transport
  *
@@ -2133,6 +2225,39 @@ ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
                            ucp_ep_h *ep_p);
 
 
+/**
+ * @ingroup UCP_ENDPOINT
+ * @brief Create and connect multiple endpoints.
+ *
+ * This routine creates @a count endpoints on a @ref ucp_worker_h
+ * "local worker", as if @ref ucp_ep_create was called for every element of
+ * @a params. All endpoints are created before any of their connection
+ * establishment messages is sent, which allows the worker to reuse the
+ * transport selection between endpoints with the same remote address layout
+ * and to send the connection messages grouped by transport.
+ *
+ * @param [in]  worker      Handle to the worker; the endpoints
+ *                          are associated with the worker.
+ * @param [in]  count       Number of endpoints to create.
+ * @param [in]  params      Array of @a count @ref ucp_ep_params_t
+ *                          configurations, one per endpoint.
+ * @param [out] eps         Array of @a count handles, filled with the created
+ *                          endpoints.
+ *
+ * @return Error code as defined by @ref ucs_status_t. On failure, none of the
+ *         endpoints is returned. Endpoints which are already known to their
+ *         peers, because their connection establishment has started or because
+ *         they were matched to a connection request of the peer, are closed
+ *         as by @ref ucp_ep_close_nbx in flush mode, and released by the
+ *         library in the background.
+ *
+ * @note Only ucp_ep_params_t::address is supported as the destination of the
+ *       endpoints.
+ */
+ucs_status_t ucp_ep_create_bulk(ucp_worker_h worker, size_t count,
+                                const ucp_ep_params_t *params, ucp_ep_h *eps);
+
+
 /**
  * @ingroup UCP_ENDPOINT
  *
@@ -3594,6 +3719,51 @@ ucs_status_ptr_t ucp_put_nbx(ucp_ep_h ep, const void *buffer, size_t count,
                              const ucp_request_param_t *param);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Non-blocking batch of remote memory put operations.
+ *
+ * This routine initiates a batch of @a count remote memory put operations,
+ * described by the @a ops array, possibly targeting several endpoints of the
+ * same @a worker. The worker is locked only once for the whole batch, and a
+ * single request is used to track completion of all operations in the batch.
+ * Adjacent operations on the same endpoint and remote key, whose local and
+ * remote buffers are contiguous, are coalesced into a single transfer.
+ * The routine returns immediately and @b does @b not guarantee re-usability
+ * of the source buffers. If all operations were completed immediately, the
+ * routine returns UCS_OK and the call-back routine @a param.cb.send is
+ * @b not invoked. Otherwise, the call-back is invoked once all operations
+ * in the batch are completed, with the status of the first failed operation,
+ * or UCS_OK if all operations succeeded.
+ *
+ * @note If an error is detected while the batch is being submitted, the
+ *       remaining operations are not started, while the ones which were
+ *       already started are completed as usual.
+ *
+ * @param [in]  worker  Worker which all endpoints in @a ops belong to.
+ * @param [in]  ops     Array of put operation descriptors.
+ * @param [in]  count   Number of elements in the @a ops array.
+ * @param [in]  param   Operation parameters, see @ref ucp_request_param_t.
+ *
+ * @return UCS_OK               - All operations were completed immediately.
+ * @return UCS_PTR_IS_ERR(_ptr) - The operation failed.
+ * @return otherwise            - Operations were scheduled and can be
+ *                                completed at any point in time. The request
+ *                                handle is returned to the application in
+ *                                order to track progress of the batch. The
+ *                                application is responsible for releasing
+ *                                the handle using @ref ucp_request_free
+ *                                "ucp_request_free()" routine.
+ *
+ * @note Only the datatype ucp_dt_make_contig(1) is supported
+ * for @a param->datatype, and @ref UCP_OP_ATTR_FLAG_FORCE_IMM_CMPL is not
+ * supported.
+ */
+ucs_status_ptr_t ucp_put_batch_nbx(ucp_worker_h worker,
+                                   const ucp_put_batch_op_t *ops, size_t count,
+                                   const ucp_request_param_t *param);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Non-blocking implicit remote memory get operation.
@@ -748,7 +748,8 @@ ucp_am_send_req(ucp_request_t *req, size_t count,
      */
     status = ucp_request_send(req, 0);
     if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
-        ucp_request_imm_cmpl_param(param, req, status, send);
+        ucp_request_imm_cmpl_param(param, req, req->send.ep->worker,
+                                   status, send);
     }
 
     ucp_request_set_send_callback_param(param, req, send);
@@ -765,6 +766,7 @@ ucp_am_try_send_short(ucp_ep_h ep, uint16_t id, uint32_t flags,
                    ((length == 0) || (header_length == 0)) &&
                    ((ssize_t)(length + header_length) <=
                     ucp_ep_config(ep)->am.max_short))) {
+        ucp_ep_keepalive_skip(ep);
         return ucp_am_send_short(ep, id, flags, header, header_length,
                                  buffer, length);
     }
@@ -1238,8 +1240,22 @@ ucs_status_t ucp_am_rndv_process_rts(void *arg, void *data, size_t length,
     param.recv_attr = UCP_AM_RECV_ATTR_FLAG_DATA | UCP_AM_RECV_ATTR_FLAG_RNDV;
     param.reply_ep  = ucp_am_hdr_reply_ep(worker, rts->am.flags,
                                           rts->super.sreq.ep_id);
+
+    /* The rendezvous receive may complete inside the callback, if the data
+     * is fetched synchronously, and the descriptor can't be released before
+     * the callback returns */
+    desc->flags    |= UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS;
     status          = am_cb->cb(am_cb->context, hdr, rts->am.header_length,
                                 desc + 1, rts->super.size, &param);
+    if (!(desc->flags & UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS)) {
+        /* the receive was completed by the callback */
+        if (!(desc->flags & UCP_RECV_DESC_FLAG_UCT_DESC)) {
+            ucp_recv_desc_release(desc);
+        }
+        return UCS_OK;
+    }
+
+    desc->flags &= ~UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS;
     if (status != UCS_INPROGRESS) {
         /* TODO: Check that recv was not called and if not, send
          * reject to the peer. */
@@ -202,6 +202,25 @@ static ucs_config_field_t ucp_config_table[] = {
    "Add debugging information to worker address.",
    ucs_offsetof(ucp_config_t, ctx.address_debug_info), UCS_CONFIG_TYPE_BOOL},
 
+  {"ADDRESS_COMPACT", "n",
+   "Pack each distinct set of transport performance attributes only once in\n"
+   "the worker address, and refer to it from every transport which has it.\n"
+   "All peers must support this address format.",
+   ucs_offsetof(ucp_config_t, ctx.address_compact), UCS_CONFIG_TYPE_BOOL},
+
+  {"ADDRESS_DIGEST", "n",
+   "When UCX_ADDRESS_COMPACT is enabled, pack a short digest of transport\n"
+   "performance attributes instead of the attributes themselves. The remote\n"
+   "peer resolves the digest against its own transports, so it must have\n"
+   "transports with identical attributes, otherwise the address is rejected.",
+   ucs_offsetof(ucp_config_t, ctx.address_digest), UCS_CONFIG_TYPE_BOOL},
+
+  {"ADDRESS_CACHE_SIZE", "1024",
+   "Maximal number of unpacked remote worker addresses to keep in the worker\n"
+   "cache, to speed up creating multiple endpoints to the same remote worker.\n"
+   "0 disables the cache.",
+   ucs_offsetof(ucp_config_t, ctx.address_cache_size), UCS_CONFIG_TYPE_UINT},
+
   {"MAX_WORKER_NAME", UCS_PP_MAKE_STRING(UCP_WORKER_NAME_MAX),
    "Maximal length of worker name. Sent to remote peer as part of worker address\n"
    "if UCX_ADDRESS_DEBUG_INFO is set to 'yes'",
@@ -212,6 +231,17 @@ static ucs_config_field_t ucp_config_table[] = {
    "y      - Use mutex for multithreading support in UCP.\n",
    ucs_offsetof(ucp_config_t, ctx.use_mt_mutex), UCS_CONFIG_TYPE_BOOL},
 
+  {"WAIT_SPIN_TIME", "0us",
+   "Maximal time to busy-poll the worker in ucp_worker_wait() before arming the\n"
+   "event file descriptors and blocking. 0 - block immediately.",
+   ucs_offsetof(ucp_config_t, ctx.wait_spin_time), UCS_CONFIG_TYPE_TIME_UNITS},
+
+  {"WAIT_SPIN_ADAPTIVE", "y",
+   "Adapt the busy-poll time of ucp_worker_wait() to the recently observed time\n"
+   "between events: spin for up to twice the average idle time, and don't spin\n"
+   "at all if events arrive less frequently than UCX_WAIT_SPIN_TIME.",
+   ucs_offsetof(ucp_config_t, ctx.wait_spin_adaptive), UCS_CONFIG_TYPE_BOOL},
+
   {"ADAPTIVE_PROGRESS", "y",
    "Enable adaptive progress mechanism, which turns on polling only on active\n"
    "transport interfaces.",
@@ -246,6 +276,25 @@ static ucs_config_field_t ucp_config_table[] = {
    "mode will be used for messages sent with eager protocol only.",
    ucs_offsetof(ucp_config_t, ctx.tm_sw_rndv), UCS_CONFIG_TYPE_BOOL},
 
+  {"TAG_UNEXP_MEM_LIMIT", "inf",
+   "Maximal amount of memory held by unexpected tagged messages on a worker.\n"
+   "Above this limit, unexpected messages are always copied out of transport\n"
+   "receive buffers, and if UCX_TAG_EAGER_FC is enabled, the peers are asked to\n"
+   "send by rendezvous protocol until the usage drops below half of the limit.\n"
+   "Only peers which the worker has endpoints to can be asked.",
+   ucs_offsetof(ucp_config_t, ctx.tag_unexp_mem_limit), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"TAG_UNEXP_DESC_MAX", "inf",
+   "Maximal number of unexpected tagged messages which may keep transport\n"
+   "receive buffers. Above this number, unexpected messages are copied, so the\n"
+   "receive buffers are returned to the transport right away.",
+   ucs_offsetof(ucp_config_t, ctx.tag_unexp_desc_max), UCS_CONFIG_TYPE_UINT},
+
+  {"TAG_EAGER_FC", "n",
+   "Enable eager flow control: when the unexpected memory limit of a worker is\n"
+   "exceeded, ask its peers to send tagged messages by rendezvous protocol.",
+   ucs_offsetof(ucp_config_t, ctx.tag_eager_fc), UCS_CONFIG_TYPE_BOOL},
+
   {"NUM_EPS", "auto",
    "An optimization hint of how many endpoints would be created on this context.\n"
    "Does not affect semantics, but only transport selection criteria and the\n"
@@ -273,7 +322,8 @@ static ucs_config_field_t ucp_config_table[] = {
    ucs_offsetof(ucp_config_t, ctx.enable_memtype_cache), UCS_CONFIG_TYPE_BOOL},
 
   {"FLUSH_WORKER_EPS", "y",
-   "Enable flushing the worker by flushing its endpoints. Allows completing\n"
+   "Enable flushing the worker by flushing its endpoints which issued RMA or\n"
+   "atomic operations since the previous worker flush. Allows completing\n"
    "the flush operation in a bounded time even if there are new requests on\n"
    "another thread, or incoming active messages, but consumes more resources.",
    ucs_offsetof(ucp_config_t, ctx.flush_worker_eps), UCS_CONFIG_TYPE_BOOL},
@@ -302,7 +352,8 @@ static ucs_config_field_t ucp_config_table[] = {
    ucs_offsetof(ucp_config_t, ctx.proto_enable), UCS_CONFIG_TYPE_BOOL},
 
   {"KEEPALIVE_TIMEOUT", "0us",
-   "Time period between keepalive rounds (0 - disabled).",
+   "Time period between keepalive checks of an endpoint, an endpoint which sent\n"
+   "data during this period is not checked (0 - disabled).",
    ucs_offsetof(ucp_config_t, ctx.keepalive_timeout), UCS_CONFIG_TYPE_TIME_UNITS},
 
   {"KEEPALIVE_NUM_EPS", "0",
@@ -74,14 +74,32 @@ typedef struct ucp_context_config {
     size_t                                 tm_max_bb_size;
     /** Enabling SW rndv protocol with tag offload mode */
     int                                    tm_sw_rndv;
+    /** Memory budget of a worker for unexpected tagged messages */
+    size_t                                 tag_unexp_mem_limit;
+    /** Maximal number of unexpected tagged messages which keep transport
+     *  receive descriptors */
+    unsigned                               tag_unexp_desc_max;
+    /** Ask the peers to send by rendezvous when the unexpected memory budget
+     *  is exceeded */
+    int                                    tag_eager_fc;
     /** Pack debug information in worker address */
     int                                    address_debug_info;
+    /** Pack a deduplicated table of iface attributes in worker address */
+    int                                    address_compact;
+    /** Pack digests instead of iface attributes in compact worker address */
+    int                                    address_digest;
+    /** Maximal number of cached unpacked remote worker addresses */
+    unsigned                               address_cache_size;
     /** Maximal size of worker name for debugging */
     unsigned                               max_worker_name;
     /** Atomic mode */
     ucp_atomic_mode_t                      atomic_mode;
     /** If use mutex for MT support or not */
     int                                    use_mt_mutex;
+    /** Maximal time to progress the worker before blocking in wait */
+    ucs_time_t                             wait_spin_time;
+    /** Adapt the wait spin time to the observed time between events */
+    int                                    wait_spin_adaptive;
     /** On-demand progress */
     int                                    adaptive_progress;
     /** Eager-am multi-lane support */
@@ -104,7 +122,7 @@ typedef struct ucp_context_config {
     size_t                                 listener_backlog;
     /** Enable new protocol selection logic */
     int                                    proto_enable;
-    /** Time period between keepalive rounds (0 - disabled) */
+    /** Time period between keepalive checks of an endpoint (0 - disabled) */
     ucs_time_t                             keepalive_timeout;
     /** Maximal number of endpoints to check on every keepalive round
      * (0 - disabled, inf - check all endpoints on every round) */
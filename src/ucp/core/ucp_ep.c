@@ -25,6 +25,7 @@
 #include <ucp/rndv/rndv.h>
 #include <ucp/stream/stream.h>
 #include <ucp/core/ucp_listener.h>
+#include <ucs/algorithm/qsort_r.h>
 #include <ucs/datastruct/queue.h>
 #include <ucs/debug/memtrack.h>
 #include <ucs/debug/log.h>
@@ -104,6 +105,7 @@ ucs_status_t ucp_ep_create_base(ucp_worker_h worker, const char *peer_name,
     ep->cfg_index                 = UCP_WORKER_CFG_INDEX_NULL;
     ep->worker                    = worker;
     ep->am_lane                   = UCP_NULL_LANE;
+    ep->keepalive_skip            = 0;
     ep->flags                     = 0;
     ep->conn_sn                   = UCP_EP_MATCH_CONN_SN_MAX;
     ucp_ep_ext_gen(ep)->user_data = NULL;
@@ -212,6 +214,7 @@ void ucp_ep_delete(ucp_ep_h ep)
     ucs_callbackq_remove_if(&ep->worker->uct->progress_q,
                             ucp_wireup_msg_ack_cb_pred, ep);
     ucp_worker_keepalive_remove_ep(ep);
+    ucp_tag_eager_fc_set_throttled(ep, 0);
     ucs_list_del(&ucp_ep_ext_gen(ep)->ep_list);
     ucs_assert(ucp_ep_ext_gen(ep)->ids->local != UCP_EP_ID_INVALID);
     status = ucs_ptr_map_del(&ep->worker->ptr_map, ucp_ep_local_id(ep));
@@ -624,16 +627,32 @@ ucp_ep_create_api_conn_request(ucp_worker_h worker,
     return status;
 }
 
+/*
+ * If send_request_p is NULL, the wireup request is sent right away. Otherwise,
+ * it is set to whether the caller should send the wireup request. If matched_p
+ * is not NULL, it is set to whether the endpoint was created by a wireup
+ * request of the peer, which already knows about it.
+ */
 static ucs_status_t
 ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
-                                 const ucp_ep_params_t *params, ucp_ep_h *ep_p)
+                                 const ucp_ep_params_t *params, ucp_ep_h *ep_p,
+                                 int *send_request_p, int *matched_p)
 {
     ucp_unpacked_address_t remote_address;
     ucp_ep_match_conn_sn_t conn_sn;
     ucs_status_t status;
     unsigned flags;
+    int cached;
     ucp_ep_h ep;
 
+    if (send_request_p != NULL) {
+        *send_request_p = 0;
+    }
+
+    if (matched_p != NULL) {
+        *matched_p = 0;
+    }
+
     if (!(params->field_mask & UCP_EP_PARAM_FIELD_REMOTE_ADDRESS)) {
         status = UCS_ERR_INVALID_PARAM;
         ucs_error("remote worker address is missing");
@@ -642,8 +661,8 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
 
     UCP_CHECK_PARAM_NON_NULL(params->address, status, goto out);
 
-    status = ucp_address_unpack(worker, params->address,
-                                UCP_ADDRESS_PACK_FLAGS_ALL, &remote_address);
+    status = ucp_address_unpack_cached(worker, params->address,
+                                       &remote_address, &cached);
     if (status != UCS_OK) {
         goto out;
     }
@@ -672,6 +691,9 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
 
         ucp_ep_flush_state_reset(ep);
         ucp_stream_ep_activate(ep);
+        if (matched_p != NULL) {
+            *matched_p = 1;
+        }
         goto out_free_address;
     }
 
@@ -709,16 +731,22 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
     /* if needed, send initial wireup message */
     if (!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED)) {
         ucs_assert(!(ep->flags & UCP_EP_FLAG_CONNECT_REQ_QUEUED));
-        status = ucp_wireup_send_request(ep);
-        if (status != UCS_OK) {
-            goto out_free_address;
+        if (send_request_p != NULL) {
+            *send_request_p = 1;
+        } else {
+            status = ucp_wireup_send_request(ep);
+            if (status != UCS_OK) {
+                goto out_free_address;
+            }
         }
     }
 
     status = UCS_OK;
 
 out_free_address:
-    ucs_free(remote_address.address_list);
+    if (!cached) {
+        ucs_free(remote_address.address_list);
+    }
 out:
     if (status == UCS_OK) {
         *ep_p = ep;
@@ -741,7 +769,8 @@ ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
     } else if (params->field_mask & UCP_EP_PARAM_FIELD_CONN_REQUEST) {
         status = ucp_ep_create_api_conn_request(worker, params, &ep);
     } else if (params->field_mask & UCP_EP_PARAM_FIELD_REMOTE_ADDRESS) {
-        status = ucp_ep_create_api_to_worker_addr(worker, params, &ep);
+        status = ucp_ep_create_api_to_worker_addr(worker, params, &ep, NULL,
+                                                  NULL);
     } else {
         status = UCS_ERR_INVALID_PARAM;
     }
@@ -755,6 +784,105 @@ ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
     return status;
 }
 
+static ucp_rsc_index_t ucp_ep_wireup_msg_rsc_index(ucp_ep_h ep)
+{
+    return ucp_ep_get_rsc_index(ep, ucp_ep_get_wireup_msg_lane(ep));
+}
+
+static int ucp_ep_wireup_msg_rsc_compare(const void *elem1, const void *elem2,
+                                         void *arg)
+{
+    ucp_ep_h *eps = arg;
+
+    return (int)ucp_ep_wireup_msg_rsc_index(eps[*(const size_t*)elem1]) -
+           (int)ucp_ep_wireup_msg_rsc_index(eps[*(const size_t*)elem2]);
+}
+
+ucs_status_t ucp_ep_create_bulk(ucp_worker_h worker, size_t count,
+                                const ucp_ep_params_t *params, ucp_ep_h *eps)
+{
+    size_t *request_eps; /* indexes of the endpoints which send a request */
+    uint8_t *peer_known; /* whether the peer of each endpoint knows about it */
+    size_t i, num_request_eps;
+    ucs_status_t status;
+    int send_request, matched;
+    unsigned flags;
+    void *request;
+
+    request_eps = ucs_malloc(sizeof(*request_eps) * count, "request_eps");
+    peer_known  = ucs_calloc(count, sizeof(*peer_known), "ep_peer_known");
+    if (((request_eps == NULL) || (peer_known == NULL)) && (count > 0)) {
+        status = UCS_ERR_NO_MEMORY;
+        goto out_free;
+    }
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    /* Create all endpoints, and defer sending wireup requests until all of
+     * them are created */
+    num_request_eps = 0;
+    for (i = 0; i < count; ++i) {
+        flags = UCP_PARAM_VALUE(EP, &params[i], flags, FLAGS, 0);
+        if ((flags & UCP_EP_PARAMS_FLAGS_CLIENT_SERVER) ||
+            (params[i].field_mask & UCP_EP_PARAM_FIELD_CONN_REQUEST)) {
+            ucs_error("bulk endpoint creation supports only remote worker "
+                      "addresses");
+            status = UCS_ERR_INVALID_PARAM;
+            goto err_release_eps;
+        }
+
+        status = ucp_ep_create_api_to_worker_addr(worker, &params[i], &eps[i],
+                                                  &send_request, &matched);
+        if (status != UCS_OK) {
+            goto err_release_eps;
+        }
+
+        eps[i]->flags |= UCP_EP_FLAG_USED;
+        peer_known[i]  = matched;
+        if (send_request) {
+            request_eps[num_request_eps++] = i;
+        }
+    }
+
+    /* Send the wireup requests grouped by the transport they are sent on */
+    ucs_qsort_r(request_eps, num_request_eps, sizeof(*request_eps),
+                ucp_ep_wireup_msg_rsc_compare, eps);
+    for (i = 0; i < num_request_eps; ++i) {
+        status = ucp_wireup_send_request(eps[request_eps[i]]);
+        if (status != UCS_OK) {
+            i = count;
+            goto err_release_eps;
+        }
+
+        peer_known[request_eps[i]] = 1;
+    }
+
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    status = UCS_OK;
+    goto out_free;
+
+err_release_eps:
+    /* The peers of the endpoints which were matched to their wireup requests,
+     * or whose requests were sent, may already use them. Close them as the
+     * user would, and let them complete in the background. No other peer knows
+     * about the remaining endpoints. */
+    while (i-- > 0) {
+        if (peer_known[i]) {
+            request = ucp_ep_close_nbx(eps[i], &ucp_request_null_param);
+            if (UCS_PTR_IS_PTR(request)) {
+                ucp_request_free(request);
+            }
+        } else {
+            ucp_ep_destroy_internal(eps[i]);
+        }
+    }
+    UCS_ASYNC_UNBLOCK(&worker->async);
+out_free:
+    ucs_free(peer_known);
+    ucs_free(request_eps);
+    return status;
+}
+
 ucs_status_ptr_t ucp_ep_modify_nb(ucp_ep_h ep, const ucp_ep_params_t *params)
 {
     ucp_worker_h worker = ep->worker;
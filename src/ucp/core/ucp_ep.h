@@ -65,6 +65,8 @@ enum {
     UCP_EP_FLAG_INDIRECT_ID            = UCS_BIT(14),/* protocols on this endpoint will send
                                                         indirect endpoint id instead of pointer,
                                                         can be replaced with looking at local ID */
+    UCP_EP_FLAG_RMA_DIRTY              = UCS_BIT(15),/* EP issued RMA/AMO since the last flush,
+                                                        and is at the head of worker all_eps */
 
     /* DEBUG bits */
     UCP_EP_FLAG_CONNECT_REQ_SENT       = UCS_BIT(16),/* DEBUG: Connection request was sent */
@@ -348,6 +350,8 @@ typedef struct ucp_ep {
     ucp_worker_cfg_index_t        cfg_index;     /* Configuration index */
     ucp_ep_match_conn_sn_t        conn_sn;       /* Sequence number for remote connection */
     ucp_lane_index_t              am_lane;       /* Cached value */
+    uint8_t                       keepalive_skip; /* Data was sent since the last
+                                                     keepalive check */
     ucp_ep_flags_t                flags;         /* Endpoint flags */
 
     /* TODO allocate ep dynamically according to number of lanes */
@@ -285,4 +285,10 @@ static UCS_F_ALWAYS_INLINE int ucp_ep_keepalive_is_enabled(ucp_ep_h ep)
            (ucp_ep_config(ep)->key.ep_check_map != 0) &&
            !(ep->flags & UCP_EP_FLAG_FAILED);
 }
+
+/* Sending data checks the connection, so the next keepalive can be skipped */
+static UCS_F_ALWAYS_INLINE void ucp_ep_keepalive_skip(ucp_ep_h ep)
+{
+    ep->keepalive_skip = 1;
+}
 #endif
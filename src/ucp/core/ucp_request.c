@@ -66,7 +66,8 @@ ucs_status_t ucp_stream_recv_request_test(void *request, size_t *length_p)
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_request_release_common(void *request, uint8_t cb_flag, const char *debug_name)
+ucp_request_release_common(void *request, uint32_t cb_flag,
+                           const char *debug_name)
 {
     ucp_request_t *req = (ucp_request_t*)request - 1;
     ucp_worker_h UCS_V_UNUSED worker = ucs_container_of(ucs_mpool_obj_owner(req),
@@ -85,7 +86,10 @@ ucp_request_release_common(void *request, uint8_t cb_flag, const char *debug_nam
     if (ucs_likely(flags & UCP_REQUEST_FLAG_COMPLETED)) {
         ucp_request_put(req);
     } else {
-        req->flags = (flags | UCP_REQUEST_FLAG_RELEASED) & ~cb_flag;
+        /* A released request is not reported to the completion queue, since
+         * the application would not be able to free it */
+        req->flags = (flags | UCP_REQUEST_FLAG_RELEASED) &
+                     ~(cb_flag | UCP_REQUEST_FLAG_CQ);
     }
 
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
@@ -44,6 +44,7 @@ enum {
     UCP_REQUEST_FLAG_CALLBACK             = UCS_BIT(6),
     UCP_REQUEST_FLAG_RECV                 = UCS_BIT(7),
     UCP_REQUEST_FLAG_SYNC                 = UCS_BIT(8),
+    UCP_REQUEST_FLAG_CQ                   = UCS_BIT(9),
     UCP_REQUEST_FLAG_OFFLOADED            = UCS_BIT(10),
     UCP_REQUEST_FLAG_BLOCK_OFFLOAD        = UCS_BIT(11),
     UCP_REQUEST_FLAG_STREAM_RECV_WAITALL  = UCS_BIT(12),
@@ -85,9 +86,12 @@ enum {
     UCP_RECV_DESC_FLAG_EAGER_LAST     = UCS_BIT(5), /* Last fragment of eager tag message.
                                                        Used by tag offload protocol. */
     UCP_RECV_DESC_FLAG_RNDV           = UCS_BIT(6), /* Rendezvous request */
-    UCP_RECV_DESC_FLAG_MALLOC         = UCS_BIT(7)  /* Descriptor was allocated with malloc
+    UCP_RECV_DESC_FLAG_MALLOC         = UCS_BIT(7), /* Descriptor was allocated with malloc
                                                        and must be freed, not returned to the
                                                        memory pool or UCT */
+    UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS = UCS_BIT(8) /* AM callback is being invoked on the
+                                                        descriptor, it is released when the
+                                                        callback returns */
 };
 
 
@@ -332,8 +336,16 @@ struct ucp_request {
             ucp_send_nbx_callback_t cb;         /* Completion callback */
             uct_worker_cb_id_t      prog_id;    /* Progress callback ID */
             int                     comp_count; /* Countdown to request completion */
-            ucp_ep_ext_gen_t        *next_ep;   /* Next endpoint to flush */
+            int                     flush_eps;  /* Whether endpoints with
+                                                   outstanding RMA/AMO should
+                                                   be flushed */
         } flush_worker;
+
+        struct {
+            ucp_worker_h            worker;     /* Worker of the batch */
+            ucp_send_nbx_callback_t cb;         /* Completion callback */
+            size_t                  comp_count; /* Countdown to request completion */
+        } put_batch;
     };
 };
 
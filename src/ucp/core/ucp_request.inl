@@ -22,7 +22,7 @@
 
 
 #define UCP_REQUEST_FLAGS_FMT \
-    "%c%c%c%c%c%c%c"
+    "%c%c%c%c%c%c%c%c"
 
 #define UCP_REQUEST_FLAGS_ARG(_flags) \
     (((_flags) & UCP_REQUEST_FLAG_COMPLETED)       ? 'd' : '-'), \
@@ -30,6 +30,7 @@
     (((_flags) & UCP_REQUEST_FLAG_EXPECTED)        ? 'e' : '-'), \
     (((_flags) & UCP_REQUEST_FLAG_LOCAL_COMPLETED) ? 'L' : '-'), \
     (((_flags) & UCP_REQUEST_FLAG_CALLBACK)        ? 'c' : '-'), \
+    (((_flags) & UCP_REQUEST_FLAG_CQ)              ? 'q' : '-'), \
     (((_flags) & UCP_REQUEST_FLAG_RECV)            ? 'r' : '-'), \
     (((_flags) & UCP_REQUEST_FLAG_SYNC)            ? 's' : '-')
 
@@ -61,11 +62,15 @@
         _req; \
     })
 
-#define ucp_request_complete(_req, _cb, _status, ...) \
+#define ucp_request_complete(_req, _worker, _cb, _status, ...) \
     { \
         (_req)->status = (_status); \
         if (ucs_likely((_req)->flags & UCP_REQUEST_FLAG_CALLBACK)) { \
             (_req)->_cb((_req) + 1, (_status), ## __VA_ARGS__); \
+        } else if (ucs_unlikely((_req)->flags & UCP_REQUEST_FLAG_CQ)) { \
+            /* if the queue cannot grow, the completion is reported only by \
+             * ucp_request_check_status() */ \
+            ucp_request_cq_push(_worker, _req, _status); \
         } \
         if (ucs_unlikely(((_req)->flags  |= UCP_REQUEST_FLAG_COMPLETED) & \
                          UCP_REQUEST_FLAG_RELEASED)) { \
@@ -104,15 +109,27 @@
     }
 
 
-#define ucp_request_cb_param(_param, _req, _cb, ...) \
-    if ((_param)->op_attr_mask & UCP_OP_ATTR_FIELD_CALLBACK) { \
-        param->cb._cb(req + 1, status, ##__VA_ARGS__, param->user_data); \
-    }
+/* Returns UCS_ERR_NO_MEMORY if the completion could not be queued */
+#define ucp_request_cb_param(_param, _req, _worker, _cb, ...) \
+    ({ \
+        ucs_status_t __cb_status = UCS_OK; \
+        if ((_param)->op_attr_mask & UCP_OP_ATTR_FIELD_CALLBACK) { \
+            param->cb._cb(req + 1, status, ##__VA_ARGS__, param->user_data); \
+        } else if ((_param)->op_attr_mask & UCP_OP_ATTR_FLAG_CQ) { \
+            (_req)->user_data = ucp_request_param_user_data(_param); \
+            __cb_status       = ucp_request_cq_push(_worker, _req, status); \
+        } \
+        __cb_status; \
+    })
 
 
-#define ucp_request_imm_cmpl_param(_param, _req, _status, _cb, ...) \
+#define ucp_request_imm_cmpl_param(_param, _req, _worker, _status, _cb, ...) \
     if ((_param)->op_attr_mask & UCP_OP_ATTR_FLAG_NO_IMM_CMPL) { \
-        ucp_request_cb_param(_param, _req, _cb, ##__VA_ARGS__); \
+        if (ucs_unlikely(ucp_request_cb_param(_param, _req, _worker, _cb, \
+                                              ##__VA_ARGS__) != UCS_OK)) { \
+            ucp_request_put_param(_param, _req); \
+            return UCS_STATUS_PTR(UCS_ERR_NO_MEMORY); \
+        } \
         ucs_trace_req("request %p completed, but immediate completion is " \
                       "prohibited, status %s", _req, \
                       ucs_status_string(_status)); \
@@ -125,9 +142,18 @@
 #define ucp_request_set_callback_param(_param, _param_cb, _req, _req_cb) \
     if ((_param)->op_attr_mask & UCP_OP_ATTR_FIELD_CALLBACK) { \
         ucp_request_set_callback(_req, _req_cb.cb, (_param)->cb._param_cb, \
-                                 ((_param)->op_attr_mask & \
-                                  UCP_OP_ATTR_FIELD_USER_DATA) ? \
-                                 (_param)->user_data : NULL); \
+                                 ucp_request_param_user_data(_param)); \
+    } else if ((_param)->op_attr_mask & UCP_OP_ATTR_FLAG_CQ) { \
+        ucp_request_set_cq(_req, ucp_request_param_user_data(_param)); \
+    }
+
+
+#define ucp_request_set_cq(_req, _user_data) \
+    { \
+        (_req)->user_data = _user_data; \
+        (_req)->flags    |= UCP_REQUEST_FLAG_CQ; \
+        ucs_trace_data("request %p completion queue, user data: %p", \
+                       _req, _user_data); \
     }
 
 
@@ -150,6 +176,32 @@ ucp_request_put(ucp_request_t *req)
     ucs_mpool_put_inline(req);
 }
 
+/* Add a completed request to the worker completion queue */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_request_cq_push(ucp_worker_h worker, ucp_request_t *req,
+                    ucs_status_t status)
+{
+    ucp_cq_entry_t *entry;
+    ucs_status_t grow_status;
+
+    if (ucs_unlikely((worker->cq.tail - worker->cq.head) == worker->cq.size)) {
+        grow_status = ucp_worker_cq_grow(worker);
+        if (grow_status != UCS_OK) {
+            return grow_status;
+        }
+    }
+
+    ucs_trace_req("request %p (%p) added to completion queue of worker %p, %s",
+                  req, req + 1, worker, ucs_status_string(status));
+
+    entry            = &worker->cq.entries[worker->cq.tail++ &
+                                           (worker->cq.size - 1)];
+    entry->request   = req + 1;
+    entry->user_data = req->user_data;
+    entry->status    = status;
+    return UCS_OK;
+}
+
 static UCS_F_ALWAYS_INLINE void
 ucp_request_complete_send(ucp_request_t *req, ucs_status_t status)
 {
@@ -157,7 +209,8 @@ ucp_request_complete_send(ucp_request_t *req, ucs_status_t status)
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_send", status);
-    ucp_request_complete(req, send.cb, status, req->user_data);
+    ucp_request_complete(req, req->send.ep->worker, send.cb, status,
+                         req->user_data);
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -169,8 +222,8 @@ ucp_request_complete_tag_recv(ucp_request_t *req, ucs_status_t status)
                   req->recv.tag.info.sender_tag, req->recv.tag.info.length,
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_recv", status);
-    ucp_request_complete(req, recv.tag.cb, status, &req->recv.tag.info,
-                         req->user_data);
+    ucp_request_complete(req, req->recv.worker, recv.tag.cb, status,
+                         &req->recv.tag.info, req->user_data);
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -190,8 +243,8 @@ ucp_request_complete_stream_recv(ucp_request_t *req, ucp_ep_ext_proto_t* ep_ext,
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
                   req->recv.stream.length, ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_recv", status);
-    ucp_request_complete(req, recv.stream.cb, status, req->recv.stream.length,
-                         req->user_data);
+    ucp_request_complete(req, req->recv.worker, recv.stream.cb, status,
+                         req->recv.stream.length, req->user_data);
 }
 
 static UCS_F_ALWAYS_INLINE int
@@ -268,6 +321,8 @@ static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_request_send(ucp_request_t *req, unsigned pending_flags)
 {
     ucs_status_t status = UCS_ERR_NOT_IMPLEMENTED;
+
+    ucp_ep_keepalive_skip(req->send.ep);
     while (!ucp_request_try_send(req, &status, pending_flags));
     return status;
 }
@@ -638,9 +693,16 @@ ucp_request_complete_am_recv(ucp_request_t *req, ucs_status_t status)
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
                   req->recv.length, ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_recv", status);
-    ucp_recv_desc_release(req->recv.am.desc);
-    ucp_request_complete(req, recv.am.cb, status, req->recv.length,
-                         req->user_data);
+    if (ucs_unlikely(req->recv.am.desc->flags &
+                     UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS)) {
+        /* completed from the AM callback, the descriptor is released after
+         * the callback returns */
+        req->recv.am.desc->flags &= ~UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS;
+    } else {
+        ucp_recv_desc_release(req->recv.am.desc);
+    }
+    ucp_request_complete(req, req->recv.worker, recv.am.cb, status,
+                         req->recv.length, req->user_data);
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -719,6 +781,13 @@ ucp_send_request_get_ep_remote_id(ucp_request_t *req)
     return ucp_ep_remote_id(req->send.ep);
 }
 
+static UCS_F_ALWAYS_INLINE void *
+ucp_request_param_user_data(const ucp_request_param_t *param)
+{
+    return (param->op_attr_mask & UCP_OP_ATTR_FIELD_USER_DATA) ?
+           param->user_data : NULL;
+}
+
 static UCS_F_ALWAYS_INLINE uint32_t
 ucp_request_param_flags(const ucp_request_param_t *param)
 {
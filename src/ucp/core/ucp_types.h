@@ -48,6 +48,8 @@ typedef struct ucp_recv_desc            ucp_recv_desc_t;
 typedef struct ucp_address_iface_attr   ucp_address_iface_attr_t;
 typedef struct ucp_address_entry        ucp_address_entry_t;
 typedef struct ucp_unpacked_address     ucp_unpacked_address_t;
+typedef struct ucp_address_cache_entry  ucp_address_cache_entry_t;
+typedef struct ucp_wireup_select_cache_entry ucp_wireup_select_cache_entry_t;
 typedef struct ucp_wireup_ep            ucp_wireup_ep_t;
 typedef struct ucp_request_send_proto   ucp_request_send_proto_t;
 typedef struct ucp_worker_iface         ucp_worker_iface_t;
@@ -111,6 +113,8 @@ enum {
                                           defined AM */
     UCP_AM_ID_SINGLE_REPLY      =  26, /* Single fragment user defined AM
                                           carrying remote ep for reply */
+    UCP_AM_ID_EAGER_FC          =  27, /* Eager flow control: stop or resume
+                                          sending tagged messages by eager */
     UCP_AM_ID_LAST
 };
 
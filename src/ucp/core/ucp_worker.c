@@ -35,6 +35,9 @@
 #define UCP_WORKER_HEADROOM_SIZE \
     (sizeof(ucp_recv_desc_t) + UCP_WORKER_HEADROOM_PRIV_SIZE)
 
+/* Number of keepalive timer ticks per keepalive period */
+#define UCP_WORKER_KEEPALIVE_SLOTS 8
+
 typedef enum ucp_worker_event_fd_op {
     UCP_WORKER_EPFD_OP_ADD,
     UCP_WORKER_EPFD_OP_DEL
@@ -73,7 +76,15 @@ static ucs_stats_class_t ucp_worker_stats_class = {
         [UCP_WORKER_STAT_TAG_RX_RNDV_UNEXP]        = "rx_rndv_rts_unexp",
         [UCP_WORKER_STAT_TAG_RX_RNDV_GET_ZCOPY]    = "rx_rndv_get_zcopy",
         [UCP_WORKER_STAT_TAG_RX_RNDV_SEND_RTR]     = "rx_rndv_send_rtr",
-        [UCP_WORKER_STAT_TAG_RX_RNDV_RKEY_PTR]     = "rx_rndv_rkey_ptr"
+        [UCP_WORKER_STAT_TAG_RX_RNDV_RKEY_PTR]     = "rx_rndv_rkey_ptr",
+        [UCP_WORKER_STAT_TAG_RX_UNEXP_COMPACT]     = "rx_unexp_compact",
+        [UCP_WORKER_STAT_TAG_RX_UNEXP_OVER_LIMIT]  = "rx_unexp_over_limit",
+        [UCP_WORKER_STAT_TAG_EAGER_FC_THROTTLE]    = "eager_fc_throttle",
+        [UCP_WORKER_STAT_TAG_EAGER_FC_RESUME]      = "eager_fc_resume",
+        [UCP_WORKER_STAT_WAIT_SPIN]                = "wait_spin",
+        [UCP_WORKER_STAT_WAIT_SLEEP]               = "wait_sleep",
+        [UCP_WORKER_STAT_ADDRESS_CACHE_HIT]        = "address_cache_hit",
+        [UCP_WORKER_STAT_ADDRESS_CACHE_MISS]       = "address_cache_miss"
     }
 };
 #endif
@@ -114,6 +125,10 @@ KHASH_IMPL(ucp_worker_discard_uct_ep_hash, uct_ep_h, char, 0,
            ucp_worker_discard_uct_ep_hash_key, kh_int64_hash_equal);
 
 
+KHASH_IMPL(ucp_worker_keepalive_hash, ucp_ep_h, ucp_worker_keepalive_timer_t*,
+           1, ucp_worker_discard_uct_ep_hash_key, kh_int64_hash_equal);
+
+
 static ucs_status_t ucp_worker_wakeup_ctl_fd(ucp_worker_h worker,
                                              ucp_worker_event_fd_op_t op,
                                              int event_fd)
@@ -1867,11 +1882,6 @@ ucp_worker_add_rkey_config(ucp_worker_h worker, const ucp_rkey_config_key_t *key
     return UCS_OK;
 }
 
-static UCS_F_ALWAYS_INLINE void ucp_worker_keepalive_reset(ucp_worker_h worker)
-{
-    worker->keepalive.iter = &worker->all_eps;
-}
-
 static void ucp_worker_destroy_ep_configs(ucp_worker_h worker)
 {
     unsigned i;
@@ -1883,6 +1893,205 @@ static void ucp_worker_destroy_ep_configs(ucp_worker_h worker)
     worker->ep_config_count = 0;
 }
 
+static int ucp_worker_keepalive_is_enabled(ucp_worker_h worker)
+{
+    return (worker->context->config.ext.keepalive_timeout != 0) &&
+           (worker->context->config.ext.keepalive_num_eps != 0);
+}
+
+static ucs_status_t ucp_worker_keepalive_init(ucp_worker_h worker)
+{
+    worker->keepalive.timer_id    = -1;
+    worker->keepalive.cb_id       = UCS_CALLBACKQ_ID_NULL;
+    worker->keepalive.round_count = 0;
+    kh_init_inplace(ucp_worker_keepalive_hash, &worker->keepalive.timers);
+
+    if (!ucp_worker_keepalive_is_enabled(worker)) {
+        return UCS_OK;
+    }
+
+    /* Every endpoint is checked within one slot of its deadline */
+    return ucs_twheel_init(&worker->keepalive.wheel,
+                           worker->context->config.ext.keepalive_timeout /
+                           UCP_WORKER_KEEPALIVE_SLOTS, ucs_get_time());
+}
+
+static void ucp_worker_keepalive_cleanup(ucp_worker_h worker)
+{
+    ucp_worker_keepalive_timer_t *timer;
+    ucs_status_t status;
+
+    if (worker->keepalive.timer_id >= 0) {
+        status = ucs_async_remove_handler(worker->keepalive.timer_id, 1);
+        if (status != UCS_OK) {
+            ucs_warn("worker %p: failed to remove keepalive timer %d: %s",
+                     worker, worker->keepalive.timer_id,
+                     ucs_status_string(status));
+        }
+        worker->keepalive.timer_id = -1;
+    }
+
+    uct_worker_progress_unregister_safe(worker->uct, &worker->keepalive.cb_id);
+
+    kh_foreach_value(&worker->keepalive.timers, timer, {
+        ucs_free(timer);
+    })
+    kh_destroy_inplace(ucp_worker_keepalive_hash, &worker->keepalive.timers);
+
+    if (ucp_worker_keepalive_is_enabled(worker)) {
+        ucs_twheel_cleanup(&worker->keepalive.wheel);
+    }
+}
+
+static unsigned ucp_worker_keepalive_progress(void *arg)
+{
+    ucp_worker_h worker = (ucp_worker_h)arg;
+    unsigned ep_keepalive_count;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    /* Run the timers of the endpoints whose deadline has passed */
+    worker->keepalive.round_count = 0;
+    ucs_twheel_sweep(&worker->keepalive.wheel, ucs_get_time());
+    ep_keepalive_count = worker->keepalive.round_count;
+
+    /* The async timer registers the callback again on the next tick */
+    uct_worker_progress_unregister_safe(worker->uct, &worker->keepalive.cb_id);
+
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return ep_keepalive_count;
+}
+
+static void ucp_worker_keepalive_timer_handler(int id, int events, void *arg)
+{
+    ucp_worker_h worker = (ucp_worker_h)arg;
+
+    /* Keepalive is progressed only when some endpoint deadline has passed, so
+     * it adds nothing to the worker progress otherwise */
+    if (ucs_twheel_is_expired(&worker->keepalive.wheel, ucs_get_time())) {
+        uct_worker_progress_register_safe(worker->uct,
+                                          ucp_worker_keepalive_progress,
+                                          worker, 0, &worker->keepalive.cb_id);
+        ucp_worker_signal_internal(worker);
+    }
+}
+
+static void ucp_worker_keepalive_timer_cb(ucs_wtimer_t *self)
+{
+    ucp_worker_keepalive_timer_t *timer =
+            ucs_derived_of(self, ucp_worker_keepalive_timer_t);
+    ucp_ep_h ep         = timer->ep;
+    ucp_worker_h worker = ep->worker;
+    ucs_time_t timeout  = worker->context->config.ext.keepalive_timeout;
+
+    if (!ucp_ep_keepalive_is_enabled(ep)) {
+        /* Scheduled again if the endpoint is reconfigured */
+        return;
+    }
+
+    if (worker->keepalive.round_count >=
+        worker->context->config.ext.keepalive_num_eps) {
+        /* Too many endpoints in this round, check on the next one */
+        ucs_wtimer_add(&worker->keepalive.wheel, self,
+                       worker->keepalive.wheel.res);
+        return;
+    }
+
+    ucs_wtimer_add(&worker->keepalive.wheel, self, timeout);
+
+    if (ep->keepalive_skip) {
+        /* The endpoint sent data since the last check */
+        ep->keepalive_skip = 0;
+        return;
+    }
+
+    /* Must be last, since a failed check may destroy the endpoint */
+    ++worker->keepalive.round_count;
+    ucp_ep_do_keepalive(ep);
+}
+
+void ucp_worker_keepalive_add_ep(ucp_ep_h ep)
+{
+    ucp_worker_h worker = ep->worker;
+    ucp_worker_keepalive_timer_t *timer;
+    ucs_status_t status;
+    khiter_t iter;
+    int ret;
+
+    if (ucp_ep_config(ep)->key.err_mode == UCP_ERR_HANDLING_MODE_NONE) {
+        return;
+    }
+
+    if (!ucp_worker_keepalive_is_enabled(worker)) {
+        return;
+    }
+
+    iter = kh_put(ucp_worker_keepalive_hash, &worker->keepalive.timers, ep,
+                  &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        ucs_error("ep %p: failed to add keepalive timer", ep);
+        return;
+    }
+
+    if (ret == UCS_KH_PUT_KEY_PRESENT) {
+        timer = kh_value(&worker->keepalive.timers, iter);
+    } else {
+        timer = ucs_malloc(sizeof(*timer), "ucp_keepalive_timer");
+        if (timer == NULL) {
+            ucs_error("ep %p: failed to allocate keepalive timer", ep);
+            kh_del(ucp_worker_keepalive_hash, &worker->keepalive.timers, iter);
+            return;
+        }
+
+        ucs_wtimer_init(&timer->super, ucp_worker_keepalive_timer_cb);
+        timer->ep                                  = ep;
+        kh_value(&worker->keepalive.timers, iter) = timer;
+    }
+
+    if (worker->keepalive.timer_id < 0) {
+        status = ucs_async_add_timer(worker->async.mode,
+                                     worker->keepalive.wheel.res,
+                                     ucp_worker_keepalive_timer_handler,
+                                     worker, &worker->async,
+                                     &worker->keepalive.timer_id);
+        if (status != UCS_OK) {
+            ucs_error("worker %p: failed to add keepalive timer: %s", worker,
+                      ucs_status_string(status));
+            return;
+        }
+    }
+
+    if (ucs_twheel_is_empty(&worker->keepalive.wheel)) {
+        /* The wheel is not swept while it is empty, so bring it up to date
+         * before scheduling a deadline relative to now */
+        ucs_twheel_sweep(&worker->keepalive.wheel, ucs_get_time());
+    }
+
+    ucs_wtimer_add(&worker->keepalive.wheel, &timer->super,
+                   worker->context->config.ext.keepalive_timeout);
+}
+
+void ucp_worker_keepalive_remove_ep(ucp_ep_h ep)
+{
+    ucp_worker_h worker = ep->worker;
+    ucp_worker_keepalive_timer_t *timer;
+    khiter_t iter;
+
+    if (!ucp_worker_keepalive_is_enabled(worker)) {
+        return;
+    }
+
+    iter = kh_get(ucp_worker_keepalive_hash, &worker->keepalive.timers, ep);
+    if (iter == kh_end(&worker->keepalive.timers)) {
+        return;
+    }
+
+    timer = kh_value(&worker->keepalive.timers, iter);
+    ucs_wtimer_remove(&worker->keepalive.wheel, &timer->super);
+    kh_del(ucp_worker_keepalive_hash, &worker->keepalive.timers, iter);
+    ucs_free(timer);
+}
+
 ucs_status_t ucp_worker_create(ucp_context_h context,
                                const ucp_worker_params_t *params,
                                ucp_worker_h *worker_p)
@@ -1920,6 +2129,7 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     worker->context              = context;
     worker->uuid                 = ucs_generate_uuid((uintptr_t)worker);
     worker->flush_ops_count      = 0;
+    worker->rma_dirty_tl_bitmap  = 0;
     worker->inprogress           = 0;
     worker->rkey_config_count    = 0;
     worker->ep_config_count      = 0;
@@ -1927,15 +2137,23 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     worker->num_ifaces           = 0;
     worker->am_message_id        = ucs_generate_uuid(0);
     worker->rkey_ptr_cb_id       = UCS_CALLBACKQ_ID_NULL;
-    worker->keepalive.cb_id      = UCS_CALLBACKQ_ID_NULL;
-    worker->keepalive.last_round = 0;
-    ucp_worker_keepalive_reset(worker);
+    worker->wait.avg_idle        = context->config.ext.wait_spin_time / 2;
     ucs_queue_head_init(&worker->rkey_ptr_reqs);
     ucs_list_head_init(&worker->arm_ifaces);
     ucs_list_head_init(&worker->stream_ready_eps);
     ucs_list_head_init(&worker->all_eps);
     kh_init_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
     kh_init_inplace(ucp_worker_discard_uct_ep_hash, &worker->discard_uct_ep_hash);
+    ucp_address_cache_init(worker);
+
+    worker->cq.entries           = NULL;
+    worker->cq.size              = 0;
+    worker->cq.head              = 0;
+    worker->cq.tail              = 0;
+    worker->cq.init_size         = ucs_roundup_pow2(
+            ((params->field_mask & UCP_WORKER_PARAM_FIELD_CQ_SIZE) &&
+             (params->cq_size > 0)) ?
+            params->cq_size : UCP_WORKER_CQ_DEFAULT_SIZE);
 
     UCS_STATIC_ASSERT(sizeof(ucp_ep_ext_gen_t) <= sizeof(ucp_ep_t));
     if (context->config.features & (UCP_FEATURE_STREAM | UCP_FEATURE_AM)) {
@@ -1989,10 +2207,15 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         goto err_destroy_async;
     }
 
+    status = ucp_worker_keepalive_init(worker);
+    if (status != UCS_OK) {
+        goto err_destroy_uct_worker;
+    }
+
     /* Create UCS event set which combines events from all transports */
     status = ucp_worker_wakeup_init(worker, params);
     if (status != UCS_OK) {
-        goto err_destroy_uct_worker;
+        goto err_keepalive_cleanup;
     }
 
     if (params->field_mask & UCP_WORKER_PARAM_FIELD_CPU_MASK) {
@@ -2035,6 +2258,9 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         goto err_destroy_mpools;
     }
 
+    worker->tm.unexpected.max_length   = context->config.ext.tag_unexp_mem_limit;
+    worker->tm.unexpected.max_uct_desc = context->config.ext.tag_unexp_desc_max;
+
     /* Initialize UCP AMs */
     status = ucp_am_init(worker);
     if (status != UCS_OK) {
@@ -2065,6 +2291,8 @@ err_close_ifaces:
 err_conn_match_cleanup:
     ucs_conn_match_cleanup(&worker->conn_match_ctx);
     ucp_worker_wakeup_cleanup(worker);
+err_keepalive_cleanup:
+    ucp_worker_keepalive_cleanup(worker);
 err_destroy_uct_worker:
     uct_worker_destroy(worker->uct);
 err_destroy_async:
@@ -2077,6 +2305,8 @@ err_destroy_ptr_map:
     ucs_ptr_map_destroy(&worker->ptr_map);
 err_free:
     ucs_strided_alloc_cleanup(&worker->ep_alloc);
+    ucp_address_cache_cleanup(worker);
+    ucp_wireup_select_cache_cleanup(worker);
     kh_destroy_inplace(ucp_worker_discard_uct_ep_hash,
                        &worker->discard_uct_ep_hash);
     kh_destroy_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
@@ -2101,6 +2331,8 @@ void ucp_worker_destroy(ucp_worker_h worker)
 
     UCS_ASYNC_BLOCK(&worker->async);
     uct_worker_progress_unregister_safe(worker->uct, &worker->keepalive.cb_id);
+    uct_worker_progress_unregister_safe(worker->uct,
+                                        &worker->tm.eager_fc.cb_id);
     ucp_worker_destroy_eps(worker);
     ucp_worker_remove_am_handlers(worker);
     ucp_am_cleanup(worker);
@@ -2119,16 +2351,25 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucp_worker_close_ifaces(worker);
     ucs_conn_match_cleanup(&worker->conn_match_ctx);
     ucp_worker_wakeup_cleanup(worker);
+    ucp_worker_keepalive_cleanup(worker);
     uct_worker_destroy(worker->uct);
     ucs_async_context_cleanup(&worker->async);
     UCS_STATS_NODE_FREE(worker->tm_offload_stats);
     UCS_STATS_NODE_FREE(worker->stats);
     ucs_ptr_map_destroy(&worker->ptr_map);
     ucs_strided_alloc_cleanup(&worker->ep_alloc);
+    ucp_address_cache_cleanup(worker);
+    ucp_wireup_select_cache_cleanup(worker);
     kh_destroy_inplace(ucp_worker_discard_uct_ep_hash,
                        &worker->discard_uct_ep_hash);
     kh_destroy_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
     ucp_worker_destroy_ep_configs(worker);
+
+    if (worker->cq.head != worker->cq.tail) {
+        ucs_warn("worker %p: %u completions were not retrieved from the "
+                 "completion queue", worker, worker->cq.tail - worker->cq.head);
+    }
+    ucs_free(worker->cq.entries);
     ucs_free(worker);
 }
 
@@ -2177,6 +2418,58 @@ ucs_status_t ucp_worker_query(ucp_worker_h worker,
     return status;
 }
 
+ucs_status_t ucp_worker_cq_grow(ucp_worker_h worker)
+{
+    unsigned count    = worker->cq.tail - worker->cq.head;
+    unsigned new_size = (worker->cq.size == 0) ? worker->cq.init_size :
+                        (worker->cq.size * 2);
+    ucp_cq_entry_t *entries;
+    unsigned i;
+
+    ucs_assert(count == worker->cq.size);
+
+    entries = ucs_malloc(sizeof(*entries) * new_size, "ucp_worker_cq");
+    if (entries == NULL) {
+        ucs_error("worker %p: failed to allocate completion queue of %u entries",
+                  worker, new_size);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    /* Unroll the ring, so the oldest completion is at index 0 */
+    for (i = 0; i < count; ++i) {
+        entries[i] = worker->cq.entries[(worker->cq.head + i) &
+                                        (worker->cq.size - 1)];
+    }
+
+    ucs_debug("worker %p: completion queue size %u -> %u", worker,
+              worker->cq.size, new_size);
+
+    ucs_free(worker->cq.entries);
+    worker->cq.entries = entries;
+    worker->cq.size    = new_size;
+    worker->cq.head    = 0;
+    worker->cq.tail    = count;
+    return UCS_OK;
+}
+
+unsigned ucp_worker_cq_poll(ucp_worker_h worker, ucp_cq_entry_t *entries,
+                            unsigned max_entries)
+{
+    unsigned count, i;
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    count = ucs_min(worker->cq.tail - worker->cq.head, max_entries);
+    for (i = 0; i < count; ++i) {
+        entries[i] = worker->cq.entries[worker->cq.head++ &
+                                        (worker->cq.size - 1)];
+    }
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+
+    return count;
+}
+
 unsigned ucp_worker_progress(ucp_worker_h worker)
 {
     unsigned count;
@@ -2303,11 +2596,60 @@ void ucp_worker_wait_mem(ucp_worker_h worker, void *address)
     ucs_arch_wait_mem(address);
 }
 
+static void ucp_worker_wait_update_idle(ucp_worker_h worker,
+                                        ucs_time_t idle_time)
+{
+    /* Exponential moving average, with weight 1/8 for the new sample */
+    worker->wait.avg_idle = ((worker->wait.avg_idle * 7) + idle_time) / 8;
+}
+
+static ucs_time_t ucp_worker_wait_spin_time(ucp_worker_h worker)
+{
+    ucs_time_t max_spin_time = worker->context->config.ext.wait_spin_time;
+
+    if (!worker->context->config.ext.wait_spin_adaptive) {
+        return max_spin_time;
+    }
+
+    /* Spinning is a waste if events are less frequent than the limit */
+    if (worker->wait.avg_idle > max_spin_time) {
+        return 0;
+    }
+
+    return ucs_min(max_spin_time, 2 * worker->wait.avg_idle);
+}
+
+/* Progress the worker for up to the spin time, return nonzero if found events */
+static unsigned ucp_worker_wait_spin(ucp_worker_h worker, ucs_time_t start_time)
+{
+    ucs_time_t spin_time = ucp_worker_wait_spin_time(worker);
+    ucs_time_t current_time;
+    unsigned count;
+
+    if (spin_time == 0) {
+        return 0;
+    }
+
+    do {
+        count        = ucp_worker_progress(worker);
+        current_time = ucs_get_time();
+        if (count > 0) {
+            ucp_worker_wait_update_idle(worker, current_time - start_time);
+            UCS_STATS_UPDATE_COUNTER(worker->stats, UCP_WORKER_STAT_WAIT_SPIN,
+                                     1);
+            return count;
+        }
+    } while ((current_time - start_time) < spin_time);
+
+    return 0;
+}
+
 ucs_status_t ucp_worker_wait(ucp_worker_h worker)
 {
     ucp_worker_iface_t *wiface;
     struct pollfd *pfd;
     ucs_status_t status;
+    ucs_time_t start_time = 0;
     nfds_t nfds;
     int ret;
 
@@ -2316,6 +2658,13 @@ ucs_status_t ucp_worker_wait(ucp_worker_h worker)
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_WAKEUP,
                                     return UCS_ERR_INVALID_PARAM);
 
+    if (worker->context->config.ext.wait_spin_time > 0) {
+        start_time = ucs_get_time();
+        if (ucp_worker_wait_spin(worker, start_time)) {
+            return UCS_OK;
+        }
+    }
+
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     status = ucp_worker_arm(worker);
@@ -2353,10 +2702,15 @@ ucs_status_t ucp_worker_wait(ucp_worker_h worker)
     /* poll is thread safe system call, though can have unpredictable results
      * because of using the same descriptor in multiple threads.
      */
+    UCS_STATS_UPDATE_COUNTER(worker->stats, UCP_WORKER_STAT_WAIT_SLEEP, 1);
     for (;;) {
         ret = poll(pfd, nfds, -1);
         if (ret >= 0) {
             ucs_assertv(ret == 1, "ret=%d", ret);
+            if (worker->context->config.ext.wait_spin_time > 0) {
+                ucp_worker_wait_update_idle(worker,
+                                            ucs_get_time() - start_time);
+            }
             status = UCS_OK;
             goto out;
         } else {
@@ -2447,89 +2801,6 @@ void ucp_worker_print_info(ucp_worker_h worker, FILE *stream)
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
 }
 
-static int ucp_worker_keepalive_is_enabled(ucp_worker_h worker)
-{
-    return (worker->context->config.ext.keepalive_timeout != 0) &&
-           (worker->context->config.ext.keepalive_num_eps != 0);
-}
-
-static unsigned ucp_worker_keepalive_progress(void *arg)
-{
-    ucp_worker_h worker = (ucp_worker_h)arg;
-    ucs_time_t now      = ucs_get_time();
-    unsigned ep_keepalive_count;
-    ucp_ep_ext_gen_t *ep_ext;
-    ucs_list_link_t *iter_begin;
-
-    if (ucs_likely((now - worker->keepalive.last_round) <
-                   worker->context->config.ext.keepalive_timeout)) {
-        return 0;
-    }
-
-    worker->keepalive.last_round = now;
-    ep_keepalive_count           = 0;
-    iter_begin                   = worker->keepalive.iter;
-    /* use own loop for elements because standard for_each skips
-     * head element */
-    /* TODO: use more optimal algo to enumerate EPs to keepalive
-     * (linked list) */
-    do {
-        ep_ext = ucs_list_next(worker->keepalive.iter,
-                               ucp_ep_ext_gen_t, ep_list);
-        worker->keepalive.iter = &ep_ext->ep_list;
-        if (worker->keepalive.iter == &worker->all_eps) {
-            continue;
-        }
-
-        ep_keepalive_count += ucp_ep_do_keepalive(ucp_ep_from_ext_gen(ep_ext));
-    } while ((iter_begin != &ep_ext->ep_list) &&
-             (ep_keepalive_count < worker->context->config.ext.keepalive_num_eps));
-
-    if (ep_keepalive_count == 0) {
-        /* remove keepalive progress if no relevant endpoints remaine */
-        uct_worker_progress_unregister_safe(worker->uct,
-                                            &worker->keepalive.cb_id);
-    }
-
-    return ep_keepalive_count;
-}
-
-void ucp_worker_keepalive_add_ep(ucp_ep_h ep)
-{
-    ucp_worker_h worker = ep->worker;
-
-    if (ucp_ep_config(ep)->key.err_mode == UCP_ERR_HANDLING_MODE_NONE) {
-        return;
-    }
-
-    if (!ucp_worker_keepalive_is_enabled(worker)) {
-        return;
-    }
-
-    uct_worker_progress_register_safe(worker->uct,
-                                      ucp_worker_keepalive_progress, worker, 0,
-                                      &worker->keepalive.cb_id);
-}
-
-/* EP is removed from worker */
-void ucp_worker_keepalive_remove_ep(ucp_ep_h ep)
-{
-    ucp_worker_h worker = ep->worker;
-    ucp_ep_ext_gen_t *ep_ext;
-
-    if (!ucp_worker_keepalive_is_enabled(worker)) {
-        ucs_assert(worker->keepalive.iter == &worker->all_eps);
-        return;
-    }
-
-    /* EP is removed from worker all_eps, so we can't use list->next value */
-    if (worker->keepalive.iter == &ucp_ep_ext_gen(ep)->ep_list) {
-        ep_ext = ucs_list_next(worker->keepalive.iter,
-                               ucp_ep_ext_gen_t, ep_list);
-        worker->keepalive.iter = &ep_ext->ep_list;
-    }
-}
-
 static unsigned ucp_worker_discard_uct_ep_destroy_progress(void *arg)
 {
     ucp_request_t *req  = (ucp_request_t*)arg;
@@ -21,6 +21,11 @@
 #include <ucs/datastruct/conn_match.h>
 #include <ucs/datastruct/ptr_map.h>
 #include <ucs/arch/bitops.h>
+#include <ucs/time/timer_wheel.h>
+
+
+/* Maximal number of transport layouts whose lane selection is cached */
+#define UCP_WIREUP_SELECT_CACHE_SIZE  UCP_WORKER_MAX_EP_CONFIG
 
 
 /* The size of the private buffer in UCT descriptor headroom, which UCP may
@@ -29,6 +34,10 @@
 #define UCP_WORKER_HEADROOM_PRIV_SIZE 32
 
 
+/* Default initial number of entries in the worker completion queue */
+#define UCP_WORKER_CQ_DEFAULT_SIZE    256
+
+
 #if ENABLE_MT
 
 #define UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(_worker)                 \
@@ -103,6 +112,24 @@ enum {
     UCP_WORKER_STAT_TAG_RX_RNDV_SEND_RTR,
     UCP_WORKER_STAT_TAG_RX_RNDV_RKEY_PTR,
 
+    /* Number of unexpected messages copied out of transport descriptors, and
+     * number of times the unexpected memory budget was exceeded */
+    UCP_WORKER_STAT_TAG_RX_UNEXP_COMPACT,
+    UCP_WORKER_STAT_TAG_RX_UNEXP_OVER_LIMIT,
+
+    /* Number of times peers asked to stop and to resume eager protocol */
+    UCP_WORKER_STAT_TAG_EAGER_FC_THROTTLE,
+    UCP_WORKER_STAT_TAG_EAGER_FC_RESUME,
+
+    /* Number of ucp_worker_wait() calls which found events while spinning,
+     * and which blocked on the event file descriptor */
+    UCP_WORKER_STAT_WAIT_SPIN,
+    UCP_WORKER_STAT_WAIT_SLEEP,
+
+    /* Number of remote worker addresses found in/added to the address cache */
+    UCP_WORKER_STAT_ADDRESS_CACHE_HIT,
+    UCP_WORKER_STAT_ADDRESS_CACHE_MISS,
+
     UCP_WORKER_STAT_LAST
 };
 
@@ -177,6 +204,23 @@ KHASH_TYPE(ucp_worker_discard_uct_ep_hash, uct_ep_h, char);
 typedef khash_t(ucp_worker_discard_uct_ep_hash) ucp_worker_discard_uct_ep_hash_t;
 
 
+/* Hash map of cached unpacked remote worker addresses, by remote worker UUID */
+KHASH_TYPE(ucp_worker_address_cache, uint64_t, ucp_address_cache_entry_t*);
+typedef khash_t(ucp_worker_address_cache) ucp_worker_address_cache_hash_t;
+
+
+/* Keepalive deadline of an endpoint */
+typedef struct {
+    ucs_wtimer_t                     super;
+    ucp_ep_h                         ep;
+} ucp_worker_keepalive_timer_t;
+
+
+/* Hash map of keepalive timers, by endpoint */
+KHASH_TYPE(ucp_worker_keepalive_hash, ucp_ep_h, ucp_worker_keepalive_timer_t*);
+typedef khash_t(ucp_worker_keepalive_hash) ucp_worker_keepalive_hash_t;
+
+
 /**
  * UCP worker iface, which encapsulates UCT iface, its attributes and
  * some auxiliary info needed for tag matching offloads.
@@ -236,7 +280,11 @@ typedef struct ucp_worker {
     void                             *user_data;          /* User-defined data */
     ucs_strided_alloc_t              ep_alloc;            /* Endpoint allocator */
     ucs_list_link_t                  stream_ready_eps;    /* List of EPs with received stream data */
-    ucs_list_link_t                  all_eps;             /* List of all endpoints */
+    ucs_list_link_t                  all_eps;             /* List of all endpoints, EPs which
+                                                             issued RMA/AMO since the last
+                                                             worker flush are first */
+    uint64_t                         rma_dirty_tl_bitmap; /* Map of tl resources which issued
+                                                             RMA/AMO since the last fence */
     ucs_conn_match_ctx_t             conn_match_ctx;      /* Endpoint-to-endpoint matching context */
     ucp_worker_iface_t               **ifaces;            /* Array of pointers to interfaces,
                                                              one for each resource */
@@ -272,10 +320,43 @@ typedef struct ucp_worker {
     ucp_rkey_config_t                rkey_config[UCP_WORKER_MAX_RKEY_CONFIG];
 
     struct {
+        ucs_time_t                   avg_idle;            /* Average time until an event */
+    } wait;
+
+    struct {
+        ucp_worker_address_cache_hash_t hash;             /* Remote UUID -> entry */
+        ucs_list_link_t              lru;                 /* Entries, most recent first */
+        unsigned                     count;               /* Number of entries */
+        uint64_t                     digest_map;          /* Which digests are valid */
+        uint32_t                     digests[UCP_MAX_RESOURCES]; /* Digests of local
+                                                             iface attributes */
+    } address_cache;
+
+    struct {
+        ucp_wireup_select_cache_entry_t *entries[UCP_WIREUP_SELECT_CACHE_SIZE];
+        unsigned                     next;                /* Next entry to
+                                                             replace */
+    } select_cache;                                       /* Lanes selected by
+                                                             transport layout */
+
+    struct {
+        ucs_twheel_t                 wheel;               /* Keepalive deadlines of EPs */
+        ucp_worker_keepalive_hash_t  timers;              /* Keepalive timers by EP */
+        int                          timer_id;            /* Async timer which schedules
+                                                             the keepalive callback */
         uct_worker_cb_id_t           cb_id;               /* Keepalive callback id */
-        ucs_time_t                   last_round;          /* Last round timespamp */
-        ucs_list_link_t              *iter;               /* Last EP processed keepalive */
+        unsigned                     round_count;         /* EPs checked in the current
+                                                             round */
     } keepalive;
+
+    struct {
+        ucp_cq_entry_t               *entries;            /* Ring of completions, allocated
+                                                             on first use */
+        unsigned                     size;                /* Ring size, power of 2 */
+        unsigned                     init_size;           /* Size of the first allocation */
+        unsigned                     head;                /* Next entry to poll */
+        unsigned                     tail;                /* Next entry to fill */
+    } cq;                                                 /* Completion queue */
 } ucp_worker_t;
 
 
@@ -323,11 +404,12 @@ ucs_status_t ucp_worker_set_ep_failed(ucp_worker_h worker, ucp_ep_h ucp_ep,
                                       uct_ep_h uct_ep, ucp_lane_index_t lane,
                                       ucs_status_t status);
 
-void ucp_worker_keepalive_add_ep(ucp_ep_h );
+void ucp_worker_keepalive_add_ep(ucp_ep_h ep);
 
-/* EP should be removed from worker all_eps prior to call this function */
 void ucp_worker_keepalive_remove_ep(ucp_ep_h ep);
 
+ucs_status_t ucp_worker_cq_grow(ucp_worker_h worker);
+
 /* must be called with async lock held */
 void ucp_worker_discard_uct_ep(ucp_worker_h worker, uct_ep_h uct_ep,
                                unsigned ep_flush_flags,
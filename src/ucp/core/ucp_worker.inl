@@ -59,6 +59,28 @@ ucp_worker_get_ep_by_id(ucp_worker_h worker, ucs_ptr_map_key_t id)
     return ep;
 }
 
+/**
+ * Look up an endpoint by an id received from the remote side, and run
+ * @a _action if the endpoint does not exist anymore or was already closed.
+ * Only indirect ids can be found missing; a direct id is the endpoint pointer.
+ */
+#define UCP_WORKER_GET_VALID_EP_BY_ID(_ep_p, _worker, _ep_id, _action, \
+                                      _fmt_str, ...) \
+    { \
+        ucs_assert((_ep_id) != UCP_EP_ID_INVALID); \
+        *(_ep_p) = (ucp_ep_h)ucs_ptr_map_get(&(_worker)->ptr_map, (_ep_id)); \
+        if (ucs_unlikely((*(_ep_p) == NULL) || \
+                         ((*(_ep_p))->flags & UCP_EP_FLAG_CLOSED))) { \
+            ucs_trace_data("worker %p: ep id 0x%" PRIx64 " was not found or" \
+                           " closed, drop " _fmt_str, (_worker), \
+                           (uint64_t)(_ep_id), ## __VA_ARGS__); \
+            _action; \
+        } \
+        ucs_assertv((*(_ep_p))->worker == (_worker), \
+                    "worker=%p ep=%p ep->worker=%p", (_worker), *(_ep_p), \
+                    (*(_ep_p))->worker); \
+    }
+
 static UCS_F_ALWAYS_INLINE ucs_ptr_map_key_t
 ucp_worker_get_request_id(ucp_worker_h worker, ucp_request_t *req, int indirect)
 {
@@ -198,6 +198,8 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_atomic_op_nbx,
         goto out;
     }
 
+    ucp_ep_rma_mark_dirty(ep, rkey->cache.amo_lane);
+
     req = ucp_request_get_param(ep->worker, param,
                                 {status_p = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
                                  goto out;});
@@ -244,6 +246,8 @@ ucs_status_t ucp_atomic_post(ucp_ep_h ep, ucp_atomic_post_op_t opcode, uint64_t
         goto out;
     }
 
+    ucp_ep_rma_mark_dirty(ep, rkey->cache.amo_lane);
+
     req = ucp_request_get(ep->worker);
     if (ucs_unlikely(NULL == req)) {
         status = UCS_ERR_NO_MEMORY;
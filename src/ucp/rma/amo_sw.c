@@ -253,7 +253,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_atomic_req_handler, (arg, data, length, am_fl
         req->send.atomic_reply.req_id = atomicreqh->req.req_id;
         req->send.length              = atomicreqh->length;
         req->send.uct.func            = ucp_progress_atomic_reply;
-        ucp_request_send(req, 0);
+        ucp_request_send(req, UCT_PENDING_FLAG_PRIO_HIGH);
     }
 
     return UCS_OK;
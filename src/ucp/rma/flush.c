@@ -406,6 +406,36 @@ static ucs_status_t ucp_worker_flush_check(ucp_worker_h worker)
     return UCS_OK;
 }
 
+static ucp_ep_h ucp_worker_rma_dirty_head(ucp_worker_h worker)
+{
+    ucp_ep_h ep;
+
+    if (ucs_list_is_empty(&worker->all_eps)) {
+        return NULL;
+    }
+
+    ep = ucp_ep_from_ext_gen(ucs_list_head(&worker->all_eps, ucp_ep_ext_gen_t,
+                                           ep_list));
+    return (ep->flags & UCP_EP_FLAG_RMA_DIRTY) ? ep : NULL;
+}
+
+static void ucp_worker_rma_dirty_reset(ucp_worker_h worker)
+{
+    ucp_ep_ext_gen_t *ep_ext;
+    ucp_ep_h ep;
+
+    /* All interfaces are flushed, so no endpoint has outstanding RMA/AMO.
+     * Dirty endpoints are first in the list, so stop at the first clean one. */
+    ucs_list_for_each(ep_ext, &worker->all_eps, ep_list) {
+        ep = ucp_ep_from_ext_gen(ep_ext);
+        if (!(ep->flags & UCP_EP_FLAG_RMA_DIRTY)) {
+            break;
+        }
+
+        ep->flags &= ~UCP_EP_FLAG_RMA_DIRTY;
+    }
+}
+
 static void ucp_worker_flush_complete_one(ucp_request_t *req, ucs_status_t status,
                                           int force_progress_unreg)
 {
@@ -422,32 +452,75 @@ static void ucp_worker_flush_complete_one(ucp_request_t *req, ucs_status_t statu
 
     if (complete) {
         ucs_assert(status != UCS_INPROGRESS);
-        ucp_request_complete(req, flush_worker.cb, status, req->user_data);
+        ucp_request_complete(req, req->flush_worker.worker, flush_worker.cb,
+                             status, req->user_data);
     }
 }
 
 static void ucp_worker_flush_ep_flushed_cb(ucp_request_t *req)
 {
-    ucp_worker_flush_complete_one(req->send.flush.worker_req, UCS_OK, 0);
+    ucp_request_t *worker_req = req->send.flush.worker_req;
+
+    --worker_req->flush_worker.worker->flush_ops_count;
+    ucp_worker_flush_complete_one(worker_req, UCS_OK, 0);
     ucp_request_put(req);
 }
 
-static unsigned ucp_worker_flush_progress(void *arg)
+static void ucp_worker_flush_dirty_eps(ucp_request_t *req)
 {
-    ucp_request_t *req        = arg;
-    ucp_worker_h worker       = req->flush_worker.worker;
-    ucp_ep_ext_gen_t *next_ep = req->flush_worker.next_ep;
+    ucp_worker_h worker = req->flush_worker.worker;
     void *ep_flush_request;
     ucs_status_t status;
     ucp_ep_h ep;
 
+    /* Dirty endpoints are first in the list of all endpoints. Move each one
+     * to the tail before flushing it, so the loop ends at the first clean
+     * endpoint, and an endpoint destroyed meanwhile is simply unlinked. */
+    while ((ep = ucp_worker_rma_dirty_head(worker)) != NULL) {
+        ep->flags &= ~UCP_EP_FLAG_RMA_DIRTY;
+        ucs_list_del(&ucp_ep_ext_gen(ep)->ep_list);
+        ucs_list_add_tail(&worker->all_eps, &ucp_ep_ext_gen(ep)->ep_list);
+
+        ep_flush_request = ucp_ep_flush_internal(ep, UCT_FLUSH_FLAG_LOCAL,
+                                                 UCP_REQUEST_FLAG_RELEASED,
+                                                 &ucp_request_null_param, req,
+                                                 ucp_worker_flush_ep_flushed_cb,
+                                                 "flush_worker");
+        if (UCS_PTR_IS_ERR(ep_flush_request)) {
+            /* endpoint flush resulted in an error */
+            status = UCS_PTR_STATUS(ep_flush_request);
+            ucs_warn("ucp_ep_flush_internal() failed: %s",
+                     ucs_status_string(status));
+        } else if (ep_flush_request != NULL) {
+            /* endpoint flush started, increment refcount. Also count it as a
+             * pending worker operation, so a concurrent worker flush, which
+             * no longer sees this endpoint as dirty, would wait for it. */
+            ++req->flush_worker.comp_count;
+            ++worker->flush_ops_count;
+        }
+    }
+}
+
+static unsigned ucp_worker_flush_progress(void *arg)
+{
+    ucp_request_t *req  = arg;
+    ucp_worker_h worker = req->flush_worker.worker;
+    ucs_status_t status;
+
     if (worker->flush_ops_count == 0) {
         /* all scheduled progress operations on worker were completed */
         status = ucp_worker_flush_check(worker);
-        if ((status == UCS_OK) || (&next_ep->ep_list == &worker->all_eps)) {
-            /* If all ifaces are flushed, or we finished going over all
-             * endpoints, no need to progress this request actively anymore
-             * and we complete the flush operation with UCS_OK status. */
+        if (status == UCS_OK) {
+            ucp_worker_rma_dirty_reset(worker);
+        }
+
+        if ((status == UCS_OK) ||
+            (worker->context->config.ext.flush_worker_eps &&
+             !req->flush_worker.flush_eps)) {
+            /* If all ifaces are flushed, or we started flushing all endpoints
+             * with outstanding RMA/AMO, no need to progress this request
+             * actively anymore and we complete the flush operation with
+             * UCS_OK status. */
             ucp_worker_flush_complete_one(req, UCS_OK, 1);
             goto out;
         } else if (status != UCS_INPROGRESS) {
@@ -459,28 +532,11 @@ static unsigned ucp_worker_flush_progress(void *arg)
         }
     }
 
-    if ((worker->context->config.ext.flush_worker_eps) &&
-        (&next_ep->ep_list != &worker->all_eps)) {
-        /* Some endpoints are not flushed yet. Take next endpoint from the list
-         * and start flush operation on it.
-         */
-        ep                        = ucp_ep_from_ext_gen(next_ep);
-        req->flush_worker.next_ep = ucs_list_next(&next_ep->ep_list,
-                                                  ucp_ep_ext_gen_t, ep_list);
-
-        ep_flush_request = ucp_ep_flush_internal(ep, UCT_FLUSH_FLAG_LOCAL,
-                                                 UCP_REQUEST_FLAG_RELEASED,
-                                                 &ucp_request_null_param, req,
-                                                 ucp_worker_flush_ep_flushed_cb,
-                                                 "flush_worker");
-        if (UCS_PTR_IS_ERR(ep_flush_request)) {
-            /* endpoint flush resulted in an error */
-            status = UCS_PTR_STATUS(ep_flush_request);
-            ucs_warn("ucp_ep_flush_internal() failed: %s", ucs_status_string(status));
-        } else if (ep_flush_request != NULL) {
-            /* endpoint flush started, increment refcount */
-            ++req->flush_worker.comp_count;
-        }
+    if (req->flush_worker.flush_eps) {
+        /* Start flush operation on all endpoints which issued RMA/AMO since
+         * the last worker flush, so they are flushed in parallel */
+        req->flush_worker.flush_eps = 0;
+        ucp_worker_flush_dirty_eps(req);
     }
 
 out:
@@ -496,6 +552,10 @@ ucp_worker_flush_nbx_internal(ucp_worker_h worker,
 
     if (!worker->flush_ops_count) {
         status = ucp_worker_flush_check(worker);
+        if (status == UCS_OK) {
+            ucp_worker_rma_dirty_reset(worker);
+        }
+
         if ((status != UCS_INPROGRESS) && (status != UCS_ERR_NO_RESOURCE)) {
             /* UCS_OK is returned here as well */
             return UCS_STATUS_PTR(status);
@@ -511,8 +571,7 @@ ucp_worker_flush_nbx_internal(ucp_worker_h worker,
     req->flush_worker.comp_count = 1; /* counting starts from 1, and decremented
                                          when finished going over all endpoints */
     req->flush_worker.prog_id    = UCS_CALLBACKQ_ID_NULL;
-    req->flush_worker.next_ep    = ucs_list_head(&worker->all_eps,
-                                                 ucp_ep_ext_gen_t, ep_list);
+    req->flush_worker.flush_eps  = worker->context->config.ext.flush_worker_eps;
 
     ucp_request_set_send_callback_param(param, req, flush_worker);
     uct_worker_progress_register_safe(worker->uct, ucp_worker_flush_progress,
@@ -589,7 +648,9 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_worker_fence, (worker), ucp_worker_h worker)
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
-    ucs_for_each_bit(rsc_index, worker->context->tl_bitmap) {
+    /* Only interfaces which issued RMA/AMO since the last fence have
+     * operations to order */
+    ucs_for_each_bit(rsc_index, worker->rma_dirty_tl_bitmap) {
         wiface = ucp_worker_iface(worker, rsc_index);
         if (wiface->iface == NULL) {
             continue;
@@ -600,7 +661,8 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_worker_fence, (worker), ucp_worker_h worker)
             goto out;
         }
     }
-    status = UCS_OK;
+    worker->rma_dirty_tl_bitmap = 0;
+    status                      = UCS_OK;
 
 out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
@@ -10,6 +10,7 @@
 #include "rma.h"
 
 #include <ucp/api/ucp.h>
+#include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_request.inl>
 #include <ucs/debug/log.h>
 
@@ -39,7 +40,8 @@ ucp_rma_send_request(ucp_request_t *req, const ucp_request_param_t *param)
     ucs_status_t status = ucp_request_send(req, 0);
 
     if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
-        ucp_request_imm_cmpl_param(param, req, status, send);
+        ucp_request_imm_cmpl_param(param, req, req->send.ep->worker,
+                                   status, send);
     }
 
     ucs_trace_req("returning request %p, status %s", req,
@@ -73,6 +75,31 @@ static inline ucs_status_t ucp_rma_wait(ucp_worker_h worker, void *user_req,
     }
 }
 
+/**
+ * Remember that RMA/AMO operations were issued on the endpoint lane, so the
+ * next worker flush and fence would have to consider them.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_ep_rma_mark_dirty(ucp_ep_h ep, ucp_lane_index_t lane)
+{
+    ucp_worker_h worker = ep->worker;
+
+    worker->rma_dirty_tl_bitmap |= UCS_BIT(ucp_ep_get_rsc_index(ep, lane));
+
+    /* Memory type endpoints are not on the list of all endpoints, since the
+     * worker flush does not flush them; their list element is self-linked */
+    if (ucs_unlikely(ucs_list_is_empty(&ucp_ep_ext_gen(ep)->ep_list))) {
+        return;
+    }
+
+    if (!(ep->flags & UCP_EP_FLAG_RMA_DIRTY)) {
+        /* Keep dirty endpoints at the head of the list of all endpoints */
+        ep->flags |= UCP_EP_FLAG_RMA_DIRTY;
+        ucs_list_del(&ucp_ep_ext_gen(ep)->ep_list);
+        ucs_list_add_head(&worker->all_eps, &ucp_ep_ext_gen(ep)->ep_list);
+    }
+}
+
 static inline void ucp_ep_rma_remote_request_sent(ucp_ep_t *ep)
 {
     ++ucp_ep_flush_state(ep)->send_sn;
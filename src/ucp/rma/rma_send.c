@@ -229,6 +229,8 @@ ucs_status_ptr_t ucp_put_nbx(ucp_ep_h ep, const void *buffer, size_t count,
         goto out_unlock;
     }
 
+    ucp_ep_rma_mark_dirty(ep, rkey->cache.rma_lane);
+
     /* Fast path for a single short message */
     if (ucs_likely(!(param->op_attr_mask & UCP_OP_ATTR_FLAG_NO_IMM_CMPL) &&
                     ((ssize_t)count <= rkey->cache.max_put_short))) {
@@ -254,6 +256,169 @@ out_unlock:
     return ptr_status;
 }
 
+static void ucp_put_batch_complete_one(ucp_request_t *req, ucs_status_t status)
+{
+    if (ucs_unlikely(status != UCS_OK) && (req->status == UCS_OK)) {
+        req->status = status;
+    }
+
+    ucs_assert(req->put_batch.comp_count > 0);
+    if (--req->put_batch.comp_count == 0) {
+        ucp_request_complete(req, req->put_batch.worker, put_batch.cb,
+                             req->status, req->user_data);
+    }
+}
+
+static void ucp_put_batch_op_completed(void *request, ucs_status_t status,
+                                       void *user_data)
+{
+    ucp_put_batch_complete_one((ucp_request_t*)user_data, status);
+}
+
+static UCS_F_ALWAYS_INLINE int
+ucp_put_batch_op_is_adjacent(const ucp_put_batch_op_t *op,
+                             const ucp_put_batch_op_t *next_op)
+{
+    return (next_op->ep == op->ep) && (next_op->rkey == op->rkey) &&
+           (next_op->buffer == UCS_PTR_BYTE_OFFSET(op->buffer, op->length)) &&
+           (next_op->remote_addr == (op->remote_addr + op->length));
+}
+
+static ucs_status_t
+ucp_put_batch_post(ucp_request_t *batch_req, ucp_ep_h ep, const void *buffer,
+                   size_t length, uint64_t remote_addr, ucp_rkey_h rkey)
+{
+    ucp_ep_rma_config_t *rma_config;
+    ucs_status_t status;
+    ucp_request_t *req;
+
+    status = UCP_RKEY_RESOLVE(rkey, ep, rma);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucp_ep_rma_mark_dirty(ep, rkey->cache.rma_lane);
+
+    if ((ssize_t)length <= rkey->cache.max_put_short) {
+        status = UCS_PROFILE_CALL(uct_ep_put_short,
+                                  ep->uct_eps[rkey->cache.rma_lane], buffer,
+                                  length, remote_addr, rkey->cache.rma_rkey);
+        if (ucs_likely(status != UCS_ERR_NO_RESOURCE)) {
+            return status;
+        }
+    }
+
+    req = ucp_request_get(ep->worker);
+    if (ucs_unlikely(req == NULL)) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    rma_config = &ucp_ep_config(ep)->rma[rkey->cache.rma_lane];
+    status     = ucp_rma_request_init(req, ep, buffer, length, remote_addr,
+                                      rkey, rkey->cache.rma_proto->progress_put,
+                                      rma_config->put_zcopy_thresh,
+                                      UCP_REQUEST_FLAG_RELEASED);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucp_request_put(req);
+        return status;
+    }
+
+    /* The internal request is released on completion, after reporting its
+     * status to the batch request */
+    ucp_request_set_callback(req, send.cb, ucp_put_batch_op_completed,
+                             batch_req);
+    ++batch_req->put_batch.comp_count;
+    ucp_request_send(req, 0);
+    return UCS_OK;
+}
+
+ucs_status_ptr_t ucp_put_batch_nbx(ucp_worker_h worker,
+                                   const ucp_put_batch_op_t *ops, size_t count,
+                                   const ucp_request_param_t *param)
+{
+    const ucp_put_batch_op_t *op, *last_op, *ops_end;
+    ucs_status_ptr_t ptr_status;
+    ucs_status_t status;
+    ucp_request_t *req;
+    size_t length;
+
+    UCP_RMA_CHECK_CONTIG1(param);
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_RMA,
+                                    return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
+
+    if (ucs_unlikely(param->op_attr_mask & UCP_OP_ATTR_FLAG_FORCE_IMM_CMPL)) {
+        return UCS_STATUS_PTR(UCS_ERR_UNSUPPORTED);
+    }
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    ucs_trace_req("put_batch_nbx worker %p ops %p count %zu cb %p", worker,
+                  ops, count,
+                  (param->op_attr_mask & UCP_OP_ATTR_FIELD_CALLBACK) ?
+                  param->cb.send : NULL);
+
+    req = ucp_request_get_param(worker, param,
+                                {ptr_status = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
+                                 goto out_unlock;});
+
+    req->flags                = 0;
+    req->status               = UCS_OK;
+    req->put_batch.worker     = worker;
+    req->put_batch.comp_count = 1; /* counting starts from 1, and decremented
+                                      when all operations were posted */
+
+    ops_end = ops + count;
+    for (op = ops; op < ops_end; op = last_op + 1) {
+        /* Coalesce adjacent operations into a single transfer */
+        length = op->length;
+        for (last_op = op; ((last_op + 1) < ops_end) &&
+                           ucp_put_batch_op_is_adjacent(last_op, last_op + 1);
+             ++last_op) {
+            length += (last_op + 1)->length;
+        }
+
+        if (length == 0) {
+            continue;
+        }
+
+        ucs_assert(op->ep->worker == worker);
+        if (ENABLE_PARAMS_CHECK && ucs_unlikely(op->buffer == NULL)) {
+            status = UCS_ERR_INVALID_PARAM;
+        } else {
+            status = ucp_put_batch_post(req, op->ep, op->buffer, length,
+                                        op->remote_addr, op->rkey);
+        }
+        if (ucs_unlikely(status != UCS_OK)) {
+            req->status = status;
+            break;
+        }
+    }
+
+    if (--req->put_batch.comp_count == 0) {
+        status = req->status;
+        if (param->op_attr_mask & UCP_OP_ATTR_FLAG_NO_IMM_CMPL) {
+            if (ucp_request_cb_param(param, req, worker, send) != UCS_OK) {
+                ucp_request_put_param(param, req);
+                ptr_status = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
+                goto out_unlock;
+            }
+        } else {
+            ucp_request_put_param(param, req);
+            ptr_status = UCS_STATUS_PTR(status);
+            goto out_unlock;
+        }
+        req->flags |= UCP_REQUEST_FLAG_COMPLETED;
+    } else {
+        ucp_request_set_send_callback_param(param, req, put_batch);
+    }
+
+    ptr_status = req + 1;
+
+out_unlock:
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+    return ptr_status;
+}
+
 ucs_status_t ucp_get_nbi(ucp_ep_h ep, void *buffer, size_t length,
                          uint64_t remote_addr, ucp_rkey_h rkey)
 {
@@ -310,6 +475,8 @@ ucs_status_ptr_t ucp_get_nbx(ucp_ep_h ep, void *buffer, size_t count,
         goto out_unlock;
     }
 
+    ucp_ep_rma_mark_dirty(ep, rkey->cache.rma_lane);
+
     rma_config = &ucp_ep_config(ep)->rma[rkey->cache.rma_lane];
     ptr_status = ucp_rma_nonblocking(ep, buffer, count, remote_addr, rkey,
                                      rkey->cache.rma_proto->progress_get,
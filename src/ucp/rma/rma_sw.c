@@ -141,7 +141,7 @@ void ucp_rma_sw_send_cmpl(ucp_ep_h ep)
 
     req->send.ep       = ep;
     req->send.uct.func = ucp_progress_rma_cmpl;
-    ucp_request_send(req, 0);
+    ucp_request_send(req, UCT_PENDING_FLAG_PRIO_HIGH);
 }
 
 UCS_PROFILE_FUNC(ucs_status_t, ucp_put_handler, (arg, data, length, am_flags),
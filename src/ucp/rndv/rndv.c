@@ -279,7 +279,7 @@ static void ucp_rndv_req_send_ats(ucp_request_t *rndv_req, ucp_request_t *rreq,
     rndv_req->send.proto.remote_req_id = remote_req_id;
     rndv_req->send.proto.comp_cb       = ucp_request_put;
 
-    ucp_request_send(rndv_req, 0);
+    ucp_request_send(rndv_req, UCT_PENDING_FLAG_PRIO_HIGH);
 }
 
 UCS_PROFILE_FUNC_VOID(ucp_rndv_complete_rma_put_zcopy, (sreq),
@@ -312,7 +312,7 @@ static void ucp_rndv_send_atp(ucp_request_t *sreq,
     sreq->send.proto.remote_req_id = remote_req_id;
     sreq->send.proto.comp_cb       = ucp_rndv_complete_rma_put_zcopy;
 
-    ucp_request_send(sreq, 0);
+    ucp_request_send(sreq, UCT_PENDING_FLAG_PRIO_HIGH);
 }
 
 UCS_PROFILE_FUNC_VOID(ucp_rndv_complete_frag_rma_put_zcopy, (fsreq),
@@ -348,7 +348,7 @@ static void ucp_rndv_send_frag_atp(ucp_request_t *fsreq,
     fsreq->send.proto.remote_req_id = req_id;
     fsreq->send.proto.comp_cb       = ucp_rndv_complete_frag_rma_put_zcopy;
 
-    ucp_request_send(fsreq, 0);
+    ucp_request_send(fsreq, UCT_PENDING_FLAG_PRIO_HIGH);
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -415,7 +415,7 @@ static void ucp_rndv_req_send_rtr(ucp_request_t *rndv_req, ucp_request_t *rreq,
     rndv_req->send.rndv_rtr.length = recv_length;
     rndv_req->send.rndv_rtr.offset = offset;
 
-    ucp_request_send(rndv_req, 0);
+    ucp_request_send(rndv_req, UCT_PENDING_FLAG_PRIO_HIGH);
 }
 
 static ucp_lane_index_t
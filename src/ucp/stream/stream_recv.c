@@ -260,6 +260,8 @@ ucp_stream_recv_request_init(ucp_request_t *req, ucp_ep_h ep, void *buffer,
         req->recv.stream.cb = param->cb.recv_stream;
         req->user_data      = (param->op_attr_mask & UCP_OP_ATTR_FIELD_USER_DATA) ?
                               param->user_data : NULL;
+    } else if (param->op_attr_mask & UCP_OP_ATTR_FLAG_CQ) {
+        ucp_request_set_cq(req, ucp_request_param_user_data(param));
     }
 }
 
@@ -445,9 +447,10 @@ ucp_stream_am_data_process(ucp_worker_t *worker, ucp_ep_ext_proto_t *ep_ext,
         /* reset offset to improve locality */
         rdesc->payload_offset = sizeof(*rdesc) + sizeof(*am_data);
         rdesc->flags          = 0;
-        memcpy(ucp_stream_rdesc_payload(rdesc),
-               UCS_PTR_BYTE_OFFSET(am_data, rdesc_tmp.payload_offset),
-               rdesc_tmp.length);
+        ucs_memcpy_relaxed(ucp_stream_rdesc_payload(rdesc),
+                           UCS_PTR_BYTE_OFFSET(am_data,
+                                               rdesc_tmp.payload_offset),
+                           rdesc_tmp.length);
     } else {
         /* slowpath */
         rdesc                  = (ucp_recv_desc_t *)am_data - 1;
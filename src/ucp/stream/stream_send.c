@@ -78,7 +78,8 @@ ucp_stream_send_req(ucp_request_t *req, size_t count,
      */
     status = ucp_request_send(req, 0);
     if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
-        ucp_request_imm_cmpl_param(param, req, status, send);
+        ucp_request_imm_cmpl_param(param, req, req->send.ep->worker,
+                                   status, send);
     }
 
     ucp_request_set_send_callback_param(param, req, send);
@@ -61,6 +61,15 @@ typedef struct {
 } UCS_S_PACKED ucp_eager_sync_first_hdr_t;
 
 
+/*
+ * EAGER_FC
+ */
+typedef struct {
+    uint64_t                  ep_id;    /* Endpoint ID on the receiver */
+    uint8_t                   throttle; /* Whether to send by rendezvous */
+} UCS_S_PACKED ucp_eager_fc_hdr_t;
+
+
 extern const ucp_request_send_proto_t ucp_tag_eager_proto;
 extern const ucp_request_send_proto_t ucp_tag_eager_sync_proto;
 
@@ -77,4 +86,22 @@ void ucp_tag_eager_sync_zcopy_req_complete(ucp_request_t *req, ucs_status_t stat
 
 void ucp_tag_eager_sync_zcopy_completion(uct_completion_t *self, ucs_status_t status);
 
+void ucp_tag_eager_fc_schedule(ucp_worker_h worker);
+
+void ucp_tag_eager_fc_set_throttled(ucp_ep_h ep, int throttled);
+
+
+/*
+ * Whether the peer of the endpoint asked to send tagged messages by
+ * rendezvous protocol, because its unexpected memory budget is exhausted.
+ */
+static UCS_F_ALWAYS_INLINE int ucp_tag_eager_is_throttled(ucp_ep_h ep)
+{
+    khash_t(ucp_tag_ep_set) *throttled_eps =
+            &ep->worker->tm.eager_fc.throttled_eps;
+
+    return ucs_unlikely(kh_size(throttled_eps) != 0) &&
+           (kh_get(ucp_tag_ep_set, throttled_eps, ep) != kh_end(throttled_eps));
+}
+
 #endif
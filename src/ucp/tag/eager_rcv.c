@@ -59,7 +59,9 @@ ucp_eager_offload_handler(void *arg, void *data, size_t length,
         status = UCS_OK;
     } else {
         status = ucp_recv_desc_init(worker, data, length, sizeof(ucp_tag_t),
-                                    tl_flags, sizeof(ucp_tag_t), flags,
+                                    ucp_tag_unexp_desc_flags(&worker->tm,
+                                                             tl_flags),
+                                    sizeof(ucp_tag_t), flags,
                                     sizeof(ucp_tag_t), &rdesc);
         if (!UCS_STATUS_IS_ERR(status)) {
             rdesc_hdr  = (ucp_tag_t*)(rdesc + 1);
@@ -120,8 +122,10 @@ ucp_eager_tagged_handler(void *arg, void *data, size_t length, unsigned am_flags
 
         status = UCS_OK;
     } else {
-        status = ucp_recv_desc_init(worker, data, length, 0, am_flags, hdr_len,
-                                    flags, priv_length, &rdesc);
+        status = ucp_recv_desc_init(worker, data, length, 0,
+                                    ucp_tag_unexp_desc_flags(&worker->tm,
+                                                             am_flags),
+                                    hdr_len, flags, priv_length, &rdesc);
         if (!UCS_STATUS_IS_ERR(status)) {
             ucp_tag_unexp_recv(&worker->tm, rdesc, recv_tag);
         }
@@ -286,6 +290,21 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_sync_ack_handler,
     return UCS_OK;
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_fc_handler,
+                 (arg, data, length, am_flags),
+                 void *arg, void *data, size_t length, unsigned am_flags)
+{
+    ucp_worker_h worker        = arg;
+    ucp_eager_fc_hdr_t *fc_hdr = data;
+    ucp_ep_h ep;
+
+    UCP_WORKER_GET_VALID_EP_BY_ID(&ep, worker, fc_hdr->ep_id, return UCS_OK,
+                                  "eager flow control throttle=%d",
+                                  fc_hdr->throttle);
+    ucp_tag_eager_fc_set_throttled(ep, fc_hdr->throttle);
+    return UCS_OK;
+}
+
 #define ucp_tag_eager_offload_priv(_flags, _data, _length, _priv_type) \
     ({ \
          size_t _priv_len = sizeof(_priv_type); \
@@ -439,6 +458,7 @@ static void ucp_eager_dump(ucp_worker_h worker, uct_am_trace_type_t type,
     const ucp_eager_sync_hdr_t *eagers_hdr       = data;
     const ucp_reply_hdr_t *rep_hdr               = data;
     const ucp_offload_ssend_hdr_t *off_rep_hdr   = data;
+    const ucp_eager_fc_hdr_t *fc_hdr             = data;
     size_t header_len;
     char *p;
 
@@ -485,6 +505,11 @@ static void ucp_eager_dump(ucp_worker_h worker, uct_am_trace_type_t type,
                  off_rep_hdr->sender_tag, off_rep_hdr->ep_id);
         header_len = sizeof(*rep_hdr);
         break;
+    case UCP_AM_ID_EAGER_FC:
+        snprintf(buffer, max, "EGR_FC ep_id 0x%"PRIx64" %s", fc_hdr->ep_id,
+                 fc_hdr->throttle ? "throttle" : "resume");
+        header_len = sizeof(*fc_hdr);
+        break;
     default:
         return;
     }
@@ -508,6 +533,8 @@ UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_SYNC_ACK,
               ucp_eager_sync_ack_handler, ucp_eager_dump, 0);
 UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_OFFLOAD_SYNC_ACK,
               ucp_eager_offload_sync_ack_handler, ucp_eager_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_FC, ucp_eager_fc_handler,
+              ucp_eager_dump, 0);
 
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_ONLY);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_FIRST);
@@ -516,3 +543,4 @@ UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_SYNC_ONLY);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_SYNC_FIRST);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_SYNC_ACK);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_OFFLOAD_SYNC_ACK);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_FC);
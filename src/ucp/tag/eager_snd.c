@@ -349,3 +349,116 @@ void ucp_tag_eager_sync_send_ack(ucp_worker_h worker, void *hdr, uint16_t recv_f
 
     ucp_request_send(req, 0);
 }
+
+static size_t ucp_tag_eager_fc_pack(void *dest, void *arg)
+{
+    ucp_request_t *req         = arg;
+    ucp_eager_fc_hdr_t *fc_hdr = dest;
+
+    /* Send the current state, so the last message which reaches the peer
+     * always carries the most recent state */
+    fc_hdr->ep_id    = ucp_send_request_get_ep_remote_id(req);
+    fc_hdr->throttle = req->send.ep->worker->tm.eager_fc.throttle_sent;
+    return sizeof(*fc_hdr);
+}
+
+static ucs_status_t ucp_tag_eager_fc_progress_send(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucs_status_t status;
+
+    status = ucp_do_am_single(self, UCP_AM_ID_EAGER_FC, ucp_tag_eager_fc_pack,
+                              sizeof(ucp_eager_fc_hdr_t));
+    if (status == UCS_OK) {
+        ucp_request_put(req);
+    }
+    return status;
+}
+
+static unsigned ucp_tag_eager_fc_progress(void *arg)
+{
+    ucp_worker_h worker = arg;
+    unsigned count      = 0;
+    ucp_ep_ext_gen_t *ep_ext;
+    ucp_request_t *req;
+    ucp_ep_h ep;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    uct_worker_progress_unregister_safe(worker->uct,
+                                        &worker->tm.eager_fc.cb_id);
+    if (worker->tm.eager_fc.throttle_sent == worker->tm.unexpected.over_limit) {
+        goto out;
+    }
+
+    worker->tm.eager_fc.throttle_sent = worker->tm.unexpected.over_limit;
+    ucs_debug("worker %p: asking peers to %s eager protocol", worker,
+              worker->tm.eager_fc.throttle_sent ? "stop" : "resume");
+
+    /* The eager header does not identify the sender, so notify all peers.
+     * Peers without a known remote endpoint ID get the notification after
+     * the ID is resolved by wireup. */
+    ucs_list_for_each(ep_ext, &worker->all_eps, ep_list) {
+        ep = ucp_ep_from_ext_gen(ep_ext);
+        if ((ep->flags & (UCP_EP_FLAG_FAILED | UCP_EP_FLAG_CLOSED)) ||
+            (ucp_ep_resolve_remote_id(ep, ucp_ep_get_am_lane(ep)) != UCS_OK)) {
+            continue;
+        }
+
+        req = ucp_request_get(worker);
+        if (req == NULL) {
+            ucs_error("worker %p: failed to allocate eager flow control "
+                      "request", worker);
+            break;
+        }
+
+        req->flags         = 0;
+        req->send.ep       = ep;
+        req->send.uct.func = ucp_tag_eager_fc_progress_send;
+        ucp_request_send(req, 0);
+        ++count;
+    }
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return count;
+}
+
+void ucp_tag_eager_fc_schedule(ucp_worker_h worker)
+{
+    /* Called from the receive path, so send the notifications later from the
+     * progress context */
+    uct_worker_progress_register_safe(worker->uct, ucp_tag_eager_fc_progress,
+                                      worker, 0, &worker->tm.eager_fc.cb_id);
+}
+
+void ucp_tag_eager_fc_set_throttled(ucp_ep_h ep, int throttled)
+{
+    khash_t(ucp_tag_ep_set) *throttled_eps =
+            &ep->worker->tm.eager_fc.throttled_eps;
+    khiter_t iter;
+    int ret;
+
+    if (!throttled) {
+        iter = kh_get(ucp_tag_ep_set, throttled_eps, ep);
+        if (iter != kh_end(throttled_eps)) {
+            kh_del(ucp_tag_ep_set, throttled_eps, iter);
+            UCS_STATS_UPDATE_COUNTER(ep->worker->stats,
+                                     UCP_WORKER_STAT_TAG_EAGER_FC_RESUME, 1);
+        }
+        return;
+    }
+
+    if (!ucp_ep_config_test_rndv_support(ucp_ep_config(ep))) {
+        /* Eager is the only protocol available to this peer */
+        return;
+    }
+
+    kh_put(ucp_tag_ep_set, throttled_eps, ep, &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        ucs_warn("ep %p: failed to switch to rendezvous protocol", ep);
+    } else if (ret != UCS_KH_PUT_KEY_PRESENT) {
+        UCS_STATS_UPDATE_COUNTER(ep->worker->stats,
+                                 UCP_WORKER_STAT_TAG_EAGER_FC_THROTTLE, 1);
+    }
+}
@@ -22,6 +22,11 @@ ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm)
     tm->expected.sw_all_count = 0;
     ucs_queue_head_init(&tm->expected.wildcard.queue);
     ucs_list_head_init(&tm->unexpected.all);
+    tm->unexpected.length         = 0;
+    tm->unexpected.max_length     = SIZE_MAX;
+    tm->unexpected.uct_desc_count = 0;
+    tm->unexpected.max_uct_desc   = UINT_MAX;
+    tm->unexpected.over_limit     = 0;
 
     tm->expected.hash = ucs_malloc(sizeof(*tm->expected.hash) * hash_size,
                                    "ucp_tm_exp_hash");
@@ -44,6 +49,9 @@ ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm)
     }
 
     kh_init_inplace(ucp_tag_frag_hash, &tm->frag_hash);
+    kh_init_inplace(ucp_tag_ep_set, &tm->eager_fc.throttled_eps);
+    tm->eager_fc.throttle_sent = 0;
+    tm->eager_fc.cb_id         = UCS_CALLBACKQ_ID_NULL;
     ucs_queue_head_init(&tm->offload.sync_reqs);
     kh_init_inplace(ucp_tag_offload_hash, &tm->offload.tag_hash);
     tm->offload.thresh       = SIZE_MAX;
@@ -56,13 +64,17 @@ void ucp_tag_match_cleanup(ucp_tag_match_t *tm)
 {
     ucp_recv_desc_t *rdesc, *tmp_rdesc;
 
+    /* Do not notify the peers while releasing the descriptors */
+    tm->unexpected.over_limit = 0;
+
     ucs_list_for_each_safe(rdesc, tmp_rdesc, &tm->unexpected.all,
                            tag_list[UCP_RDESC_ALL_LIST]) {
         ucs_warn("unexpected tag-receive descriptor %p was not matched", rdesc);
-        ucp_tag_unexp_remove(rdesc);
+        ucp_tag_unexp_remove(tm, rdesc);
         ucp_recv_desc_release(rdesc);
     }
 
+    kh_destroy_inplace(ucp_tag_ep_set, &tm->eager_fc.throttled_eps);
     kh_destroy_inplace(ucp_tag_offload_hash, &tm->offload.tag_hash);
     kh_destroy_inplace(ucp_tag_frag_hash, &tm->frag_hash);
     ucs_free(tm->unexpected.hash);
@@ -74,6 +86,38 @@ int ucp_tag_unexp_is_empty(ucp_tag_match_t *tm)
     return ucs_list_is_empty(&tm->unexpected.all);
 }
 
+void ucp_tag_unexp_limit_update(ucp_tag_match_t *tm)
+{
+    ucp_worker_h worker = ucs_container_of(tm, ucp_worker_t, tm);
+    int over_limit;
+
+    if (tm->unexpected.length > tm->unexpected.max_length) {
+        over_limit = 1;
+    } else if (tm->unexpected.length <= (tm->unexpected.max_length / 2)) {
+        over_limit = 0;
+    } else {
+        return;
+    }
+
+    if (over_limit == tm->unexpected.over_limit) {
+        return;
+    }
+
+    ucs_debug("worker %p: unexpected messages length %zu is %s the limit %zu",
+              worker, tm->unexpected.length, over_limit ? "above" : "below",
+              tm->unexpected.max_length);
+
+    tm->unexpected.over_limit = over_limit;
+    if (over_limit) {
+        UCS_STATS_UPDATE_COUNTER(worker->stats,
+                                 UCP_WORKER_STAT_TAG_RX_UNEXP_OVER_LIMIT, 1);
+    }
+
+    if (worker->context->config.ext.tag_eager_fc) {
+        ucp_tag_eager_fc_schedule(worker);
+    }
+}
+
 int ucp_tag_exp_remove(ucp_tag_match_t *tm, ucp_request_t *req)
 {
     ucp_request_queue_t *req_queue = ucp_tag_exp_get_req_queue(tm, req);
@@ -55,6 +55,15 @@ KHASH_INIT(ucp_tag_frag_hash, uint64_t, ucp_tag_frag_match_t, 1,
            kh_int64_hash_func, kh_int64_hash_equal);
 
 
+#define ucp_tag_ep_set_hash_key(_ep) \
+    kh_int64_hash_func((uintptr_t)(_ep))
+
+
+/* Hash set of endpoints */
+KHASH_INIT(ucp_tag_ep_set, ucp_ep_h, char, 0, ucp_tag_ep_set_hash_key,
+           kh_int64_hash_equal);
+
+
 /**
  * Tag-matching context
  */
@@ -73,8 +82,27 @@ typedef struct ucp_tag_match {
     struct {
         ucs_list_link_t       all;        /* Linked list of all tags */
         ucs_list_link_t       *hash;      /* Hash table of unexpected tags */
+        size_t                length;     /* Total length of unexpected descriptors */
+        size_t                max_length; /* Memory budget for unexpected descriptors */
+        unsigned              uct_desc_count; /* Number of unexpected descriptors
+                                                 which hold a transport descriptor */
+        unsigned              max_uct_desc; /* Above this number, unexpected data
+                                               is copied out of transport
+                                               descriptors */
+        int                   over_limit; /* Memory budget was exceeded, until the
+                                             length drops below half of it */
     } unexpected;
 
+    /* Eager flow control */
+    struct {
+        khash_t(ucp_tag_ep_set) throttled_eps; /* Endpoints whose peers asked to
+                                                  send by rendezvous */
+        int                   throttle_sent;   /* Whether peers were asked to
+                                                  send by rendezvous */
+        uct_worker_cb_id_t    cb_id;           /* Callback which notifies the
+                                                  peers about a state change */
+    } eager_fc;
+
     /* Hash for fragment assembly, the key is a globally unique tag message id */
     khash_t(ucp_tag_frag_hash) frag_hash;
 
@@ -109,6 +137,8 @@ int ucp_tag_exp_remove(ucp_tag_match_t *tm, ucp_request_t *req);
 
 int ucp_tag_unexp_is_empty(ucp_tag_match_t *tm);
 
+void ucp_tag_unexp_limit_update(ucp_tag_match_t *tm);
+
 ucp_request_t*
 ucp_tag_exp_search_all(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
                        ucp_tag_t tag);
@@ -138,10 +138,18 @@ ucp_tag_unexp_get_list_for_tag(ucp_tag_match_t *tm, ucp_tag_t tag)
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_unexp_remove(ucp_recv_desc_t *rdesc)
+ucp_tag_unexp_remove(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc)
 {
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_HASH_LIST]);
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_ALL_LIST] );
+
+    ucs_assert(tm->unexpected.length >= rdesc->length);
+    tm->unexpected.length         -= rdesc->length;
+    tm->unexpected.uct_desc_count -= !!(rdesc->flags &
+                                        UCP_RECV_DESC_FLAG_UCT_DESC);
+    if (ucs_unlikely(tm->unexpected.over_limit)) {
+        ucp_tag_unexp_limit_update(tm);
+    }
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -153,6 +161,13 @@ ucp_tag_unexp_recv(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc, ucp_tag_t tag)
     ucs_list_add_tail(hash_list,           &rdesc->tag_list[UCP_RDESC_HASH_LIST]);
     ucs_list_add_tail(&tm->unexpected.all, &rdesc->tag_list[UCP_RDESC_ALL_LIST]);
 
+    tm->unexpected.length         += rdesc->length;
+    tm->unexpected.uct_desc_count += !!(rdesc->flags &
+                                        UCP_RECV_DESC_FLAG_UCT_DESC);
+    if (ucs_unlikely(tm->unexpected.length > tm->unexpected.max_length)) {
+        ucp_tag_unexp_limit_update(tm);
+    }
+
     ucs_trace_req("unexp "UCP_RECV_DESC_FMT" tag %"PRIx64,
                   UCP_RECV_DESC_ARG(rdesc), tag);
 }
@@ -164,6 +179,26 @@ ucp_tag_unexp_list_next(ucp_recv_desc_t *rdesc, int i_list)
                          tag_list[i_list]);
 }
 
+/*
+ * Returns the transport flags to initialize an unexpected receive descriptor
+ * with. When too many unexpected messages hold transport descriptors, or the
+ * unexpected memory budget is exceeded, the data is copied so the transport
+ * descriptor is returned to its receive pool right away.
+ */
+static UCS_F_ALWAYS_INLINE unsigned
+ucp_tag_unexp_desc_flags(ucp_tag_match_t *tm, unsigned am_flags)
+{
+    if (ucs_likely(!(am_flags & UCT_CB_PARAM_FLAG_DESC)) ||
+        ucs_likely((tm->unexpected.uct_desc_count < tm->unexpected.max_uct_desc) &&
+                   !tm->unexpected.over_limit)) {
+        return am_flags;
+    }
+
+    UCS_STATS_UPDATE_COUNTER(ucs_container_of(tm, ucp_worker_t, tm)->stats,
+                             UCP_WORKER_STAT_TAG_RX_UNEXP_COMPACT, 1);
+    return am_flags & ~UCT_CB_PARAM_FLAG_DESC;
+}
+
 /* search unexpected queue for tag/mask, if found return the received desc,
  * otherwise return NULL
  */
@@ -202,7 +237,7 @@ ucp_tag_unexp_search(ucp_tag_match_t *tm, ucp_tag_t tag, uint64_t tag_mask,
                           "%s tag %"PRIx64"/%"PRIx64, UCP_RECV_DESC_ARG(rdesc),
                           title, tag, tag_mask);
             if (rem) {
-                ucp_tag_unexp_remove(rdesc);
+                ucp_tag_unexp_remove(tm, rdesc);
             }
             return rdesc;
         }
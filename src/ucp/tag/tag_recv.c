@@ -27,7 +27,9 @@ ucp_tag_recv_common(ucp_worker_h worker, void *buffer, size_t count,
 {
     unsigned common_flags = UCP_REQUEST_FLAG_RECV | UCP_REQUEST_FLAG_EXPECTED;
     uint32_t req_flags    = (param->op_attr_mask & UCP_OP_ATTR_FIELD_CALLBACK) ?
-                            UCP_REQUEST_FLAG_CALLBACK : 0;
+                            UCP_REQUEST_FLAG_CALLBACK :
+                            (param->op_attr_mask & UCP_OP_ATTR_FLAG_CQ) ?
+                            UCP_REQUEST_FLAG_CQ : 0;
     ucp_eager_first_hdr_t *eagerf_hdr;
     ucp_request_queue_t *req_queue;
     ucs_memory_type_t memory_type;
@@ -69,7 +71,7 @@ ucp_tag_recv_common(ucp_worker_h worker, void *buffer, size_t count,
         req->status = status;
         UCS_PROFILE_REQUEST_EVENT(req, "complete_recv", 0);
 
-        ucp_request_imm_cmpl_param(param, req, status, recv,
+        ucp_request_imm_cmpl_param(param, req, worker, status, recv,
                                    &req->recv.tag.info);
     }
 
@@ -102,6 +104,8 @@ ucp_tag_recv_common(ucp_worker_h worker, void *buffer, size_t count,
     if (param->op_attr_mask & UCP_OP_ATTR_FIELD_CALLBACK) {
         req->recv.tag.cb    = param->cb.recv;
         req->user_data      = param->user_data;
+    } else if (param->op_attr_mask & UCP_OP_ATTR_FLAG_CQ) {
+        req->user_data      = ucp_request_param_user_data(param);
     }
 
     if (ucs_log_is_enabled(UCS_LOG_LEVEL_TRACE_REQ)) {
@@ -55,7 +55,8 @@ ucs_status_t ucp_tag_rndv_process_rts(ucp_worker_h worker,
      * (and therefore keep fast search by ucp_tag_unexp_search())
      */
     status = ucp_recv_desc_init(worker, rts_hdr, length, sizeof(*rdesc_hdr),
-                                tl_flags, sizeof(*rts_hdr) + sizeof(*rdesc_hdr),
+                                ucp_tag_unexp_desc_flags(&worker->tm, tl_flags),
+                                sizeof(*rts_hdr) + sizeof(*rdesc_hdr),
                                 UCP_RECV_DESC_FLAG_RNDV,
                                 sizeof(*rdesc_hdr), &rdesc);
     if (!UCS_STATUS_IS_ERR(status)) {
@@ -64,6 +64,13 @@ ucp_tag_send_req(ucp_request_t *req, size_t dt_count,
     rndv_thresh = ucp_tag_get_rndv_threshold(req, dt_count, msg_config->max_iov,
                                              rndv_rma_thresh, rndv_am_thresh);
 
+    if (ucs_unlikely(ucp_tag_eager_is_throttled(req->send.ep))) {
+        /* The peer is out of memory for unexpected messages, so send any
+         * data by rendezvous protocol */
+        max_short   = -1;
+        rndv_thresh = 1;
+    }
+
     if (!(param->op_attr_mask & UCP_OP_ATTR_FLAG_FAST_CMPL) ||
         ucs_unlikely(!UCP_MEM_IS_ACCESSIBLE_FROM_CPU(req->send.mem_type))) {
         zcopy_thresh = ucp_proto_get_zcopy_threshold(req, msg_config, dt_count,
@@ -111,7 +118,8 @@ ucp_tag_send_req(ucp_request_t *req, size_t dt_count,
      */
     status = ucp_request_send(req, 0);
     if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
-        ucp_request_imm_cmpl_param(param, req, status, send);
+        ucp_request_imm_cmpl_param(param, req, req->send.ep->worker,
+                                   status, send);
     }
 
     ucp_request_set_send_callback_param(param, req, send);
@@ -153,8 +161,11 @@ ucp_tag_send_inline(ucp_ep_h ep, const void *buffer, size_t length, ucp_tag_t ta
 {
     ucs_status_t status;
 
-    if (ucp_tag_eager_is_inline(ep, &ucp_ep_config(ep)->tag.max_eager_short,
-                                length)) {
+    if (ucs_unlikely(ucp_tag_eager_is_throttled(ep))) {
+        return UCS_ERR_NO_RESOURCE;
+    } else if (ucp_tag_eager_is_inline(ep,
+                                       &ucp_ep_config(ep)->tag.max_eager_short,
+                                       length)) {
         UCS_STATIC_ASSERT(sizeof(ucp_tag_t) == sizeof(ucp_eager_hdr_t));
         UCS_STATIC_ASSERT(sizeof(ucp_tag_t) == sizeof(uint64_t));
         status = uct_ep_am_short(ucp_ep_get_am_uct_ep(ep), UCP_AM_ID_EAGER_ONLY,
@@ -170,6 +181,7 @@ ucp_tag_send_inline(ucp_ep_h ep, const void *buffer, size_t length, ucp_tag_t ta
 
     if (status != UCS_ERR_NO_RESOURCE) {
         UCP_EP_STAT_TAG_OP(ep, EAGER);
+        ucp_ep_keepalive_skip(ep);
     }
 
     return status;
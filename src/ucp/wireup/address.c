@@ -13,6 +13,7 @@
 
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_ep.inl>
+#include <ucs/algorithm/crc.h>
 #include <ucs/arch/bitops.h>
 #include <ucs/debug/log.h>
 #include <inttypes.h>
@@ -22,6 +23,7 @@
  * Packed address layout:
  *
  * [ header(8bit) | uuid(64bit) | worker_name(string) ]
+ * [ num_attrs(8bit) | attr1 | attr2 | ... ]       (compact mode only)
  * [ device1_md_index | device1_address(var) ]
  *    [ tl1_name_csum(string) | tl1_info | tl1_address(var) ]
  *    [ tl2_name_csum(string) | tl2_info | tl2_address(var) ]
@@ -35,6 +37,13 @@
  *   * For ep address, lane index contains the LAST flag.
  *   * In non unified mode tl_info contains iface attributes. LAST flag is set in
  *     iface address length.
+ *   * In compact mode (non unified only), every distinct set of iface
+ *     attributes is packed once in the attributes table after the worker
+ *     name, and tl_info contains only the index of its entry in the table.
+ *     A table entry contains either the iface attributes, or, if the
+ *     address has UCP_ADDRESS_HEADER_FLAG_ATTR_DIGEST, their digest and
+ *     latency overhead, which are resolved by the peer against its own
+ *     iface attributes.
  *   * If a device does not have tl addresses, it's md_index will have the flag
  *     EMPTY.
  *   * If the address list is empty, then it will contain only a single md_index
@@ -89,6 +98,26 @@ typedef struct {
 } ucp_address_unified_iface_attr_t;
 
 
+/* Digest of iface attributes, packed in compact mode instead of the attributes
+ * when all peers are expected to have the same transports. Latency overhead
+ * depends on device NUMA locality, so it is packed as is and excluded from
+ * the digest. The atomic flags are packed in the same bits as in
+ * ucp_address_packed_iface_attr_t::prio_cap_flags.
+ */
+typedef struct {
+    uint32_t         digest;
+    float            lat_ovh;
+} UCS_S_PACKED ucp_address_digest_iface_attr_t;
+
+
+/* Table of distinct iface attributes, packed in compact mode */
+typedef struct {
+    ucp_address_packed_iface_attr_t attrs[UCP_MAX_RESOURCES];
+    uint8_t                         index[UCP_MAX_RESOURCES]; /* by rsc_index */
+    ucp_rsc_index_t                 count;
+} ucp_address_attr_table_t;
+
+
 #define UCP_ADDRESS_FLAG_ATOMIC32     UCS_BIT(30) /* 32bit atomic operations */
 #define UCP_ADDRESS_FLAG_ATOMIC64     UCS_BIT(31) /* 64bit atomic operations */
 
@@ -116,6 +145,13 @@ typedef struct {
 
 #define UCP_ADDRESS_HEADER_VERSION_MASK     UCS_MASK(4) /* Version - 4 bits */
 #define UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO  UCS_BIT(4)  /* Address has debug info */
+#define UCP_ADDRESS_HEADER_FLAG_ATTR_TABLE  UCS_BIT(5)  /* Address has iface
+                                                           attributes table */
+#define UCP_ADDRESS_HEADER_FLAG_ATTR_DIGEST UCS_BIT(6)  /* Attributes table
+                                                           contains digests */
+
+#define UCP_ADDRESS_ATOMIC_FLAGS      (UCP_ADDRESS_FLAG_ATOMIC32 | \
+                                       UCP_ADDRESS_FLAG_ATOMIC64)
 
 /* Enumeration of UCP address versions.
  * Every release which changes the address binary format must bump this number.
@@ -127,10 +163,31 @@ enum {
 };
 
 
+KHASH_IMPL(ucp_worker_address_cache, uint64_t, ucp_address_cache_entry_t*, 1,
+           kh_int64_hash_func, kh_int64_hash_equal);
+
+
+static int ucp_address_is_compact(ucp_worker_t *worker)
+{
+    return worker->context->config.ext.address_compact &&
+           !ucp_worker_is_unified_mode(worker);
+}
+
 static size_t ucp_address_iface_attr_size(ucp_worker_t *worker)
 {
-    return ucp_worker_is_unified_mode(worker) ?
-           sizeof(ucp_address_unified_iface_attr_t) :
+    if (ucp_worker_is_unified_mode(worker)) {
+        return sizeof(ucp_address_unified_iface_attr_t);
+    } else if (ucp_address_is_compact(worker)) {
+        return sizeof(uint8_t); /* index in attributes table */
+    } else {
+        return sizeof(ucp_address_packed_iface_attr_t);
+    }
+}
+
+static size_t ucp_address_attr_table_entry_size(ucp_worker_t *worker)
+{
+    return worker->context->config.ext.address_digest ?
+           sizeof(ucp_address_digest_iface_attr_t) :
            sizeof(ucp_address_packed_iface_attr_t);
 }
 
@@ -267,6 +324,7 @@ ucp_address_gather_devices(ucp_worker_h worker, ucp_ep_h ep, uint64_t tl_bitmap,
 static size_t ucp_address_packed_size(ucp_worker_h worker,
                                       const ucp_address_packed_device_t *devices,
                                       ucp_rsc_index_t num_devices,
+                                      const ucp_address_attr_table_t *attr_table,
                                       uint64_t pack_flags)
 {
     size_t size = 0;
@@ -284,6 +342,11 @@ static size_t ucp_address_packed_size(ucp_worker_h worker,
         size += strlen(ucp_worker_get_name(worker)) + 1;
     }
 
+    if (attr_table != NULL) {
+        size += 1;                      /* number of table entries */
+        size += attr_table->count * ucp_address_attr_table_entry_size(worker);
+    }
+
     if (num_devices == 0) {
         size += 1;                      /* NULL md_index */
     } else {
@@ -361,35 +424,17 @@ static uint64_t ucp_address_unpack_flags(uint32_t input_flags,
     return result_flags;
 }
 
-static int ucp_address_pack_iface_attr(ucp_worker_h worker, void *ptr,
-                                       ucp_rsc_index_t rsc_index,
-                                       const uct_iface_attr_t *iface_attr,
-                                       int enable_atomics)
+static ucs_status_t
+ucp_address_pack_packed_attr(ucp_address_packed_iface_attr_t *packed,
+                             const uct_iface_attr_t *iface_attr,
+                             int enable_atomics)
 {
-    ucp_address_packed_iface_attr_t  *packed;
-    ucp_address_unified_iface_attr_t *unified;
-
     /* check if at least one of bandwidth values is 0 */
     if ((iface_attr->bandwidth.dedicated * iface_attr->bandwidth.shared) != 0) {
         ucs_error("Incorrect bandwidth value: one of bandwidth dedicated/shared must be zero");
-        return -1;
-    }
-
-
-    if (ucp_worker_is_unified_mode(worker)) {
-        /* In unified mode all workers have the same transports and tl bitmap.
-         * Just send rsc index, so the remote peer could fetch iface attributes
-         * from its local iface. Also send latency overhead, because it
-         * depends on device NUMA locality. */
-        unified            = ptr;
-        unified->rsc_index = rsc_index;
-        unified->lat_ovh   = enable_atomics ? -iface_attr->latency.c :
-                                               iface_attr->latency.c;
-
-        return sizeof(*unified);
+        return UCS_ERR_INVALID_PARAM;
     }
 
-    packed                 = ptr;
     packed->prio_cap_flags = ((uint8_t)iface_attr->priority);
     packed->overhead       = iface_attr->overhead;
     packed->bandwidth      = iface_attr->bandwidth.dedicated - iface_attr->bandwidth.shared;
@@ -422,19 +467,252 @@ static int ucp_address_pack_iface_attr(ucp_worker_h worker, void *ptr,
         }
     }
 
-    return sizeof(*packed);
+    return UCS_OK;
+}
+
+static int ucp_address_pack_iface_attr(ucp_worker_h worker, void *ptr,
+                                       ucp_rsc_index_t rsc_index,
+                                       const uct_iface_attr_t *iface_attr,
+                                       int enable_atomics)
+{
+    ucp_address_unified_iface_attr_t *unified;
+    ucs_status_t status;
+
+    if (ucp_worker_is_unified_mode(worker)) {
+        /* In unified mode all workers have the same transports and tl bitmap.
+         * Just send rsc index, so the remote peer could fetch iface attributes
+         * from its local iface. Also send latency overhead, because it
+         * depends on device NUMA locality. */
+        unified            = ptr;
+        unified->rsc_index = rsc_index;
+        unified->lat_ovh   = enable_atomics ? -iface_attr->latency.c :
+                                               iface_attr->latency.c;
+
+        return sizeof(*unified);
+    }
+
+    status = ucp_address_pack_packed_attr(ptr, iface_attr, enable_atomics);
+    if (status != UCS_OK) {
+        return -1;
+    }
+
+    return sizeof(ucp_address_packed_iface_attr_t);
+}
+
+static uint32_t
+ucp_address_attr_digest(const ucp_address_packed_iface_attr_t *packed)
+{
+    ucp_address_packed_iface_attr_t attr = *packed;
+
+    attr.lat_ovh         = 0;
+    attr.prio_cap_flags &= ~UCP_ADDRESS_ATOMIC_FLAGS;
+    return (ucs_crc32(0, &attr, sizeof(attr)) & ~UCP_ADDRESS_ATOMIC_FLAGS) |
+           (packed->prio_cap_flags & UCP_ADDRESS_ATOMIC_FLAGS);
+}
+
+static ucs_status_t
+ucp_address_gather_attrs(ucp_worker_h worker, uint64_t tl_bitmap,
+                         ucp_address_attr_table_t *attr_table)
+{
+    ucp_address_packed_iface_attr_t *packed;
+    uct_iface_attr_t *iface_attr;
+    ucp_rsc_index_t rsc_index;
+    ucs_status_t status;
+    uint8_t index;
+
+    attr_table->count = 0;
+    ucs_for_each_bit(rsc_index, tl_bitmap & worker->context->tl_bitmap) {
+        iface_attr = ucp_worker_iface_get_attr(worker, rsc_index);
+        if (!ucp_worker_iface_can_connect(iface_attr)) {
+            continue;
+        }
+
+        packed = &attr_table->attrs[attr_table->count];
+        memset(packed, 0, sizeof(*packed));
+        status = ucp_address_pack_packed_attr(packed, iface_attr,
+                                              worker->atomic_tls &
+                                              UCS_BIT(rsc_index));
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        /* Reuse an existing entry with the same attributes */
+        for (index = 0; index < attr_table->count; ++index) {
+            if (!memcmp(&attr_table->attrs[index], packed, sizeof(*packed))) {
+                break;
+            }
+        }
+
+        attr_table->index[rsc_index] = index;
+        if (index == attr_table->count) {
+            ++attr_table->count;
+        }
+    }
+
+    return UCS_OK;
+}
+
+static void* ucp_address_pack_attr_table(ucp_worker_h worker, void *ptr,
+                                         const ucp_address_attr_table_t *attr_table)
+{
+    ucp_address_digest_iface_attr_t *digest;
+    const ucp_address_packed_iface_attr_t *packed;
+
+    *(uint8_t*)ptr = attr_table->count;
+    ptr            = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+
+    for (packed = attr_table->attrs;
+         packed < (attr_table->attrs + attr_table->count); ++packed) {
+        if (worker->context->config.ext.address_digest) {
+            digest          = ptr;
+            digest->digest  = ucp_address_attr_digest(packed);
+            digest->lat_ovh = packed->lat_ovh;
+            ptr             = UCS_PTR_TYPE_OFFSET(ptr, *digest);
+        } else {
+            memcpy(ptr, packed, sizeof(*packed));
+            ptr = UCS_PTR_TYPE_OFFSET(ptr, *packed);
+        }
+    }
+
+    return ptr;
+}
+
+static ucs_status_t
+ucp_address_pack_local_attr(ucp_worker_h worker, ucp_rsc_index_t rsc_index,
+                            ucp_address_packed_iface_attr_t *packed)
+{
+    memset(packed, 0, sizeof(*packed));
+    return ucp_address_pack_packed_attr(packed,
+                                        ucp_worker_iface_get_attr(worker,
+                                                                  rsc_index),
+                                        0);
+}
+
+/* Find local iface attributes which match a digest packed by the peer */
+static ucs_status_t
+ucp_address_resolve_attr_digest(ucp_worker_h worker,
+                                const ucp_address_digest_iface_attr_t *digest,
+                                ucp_address_packed_iface_attr_t *packed)
+{
+    uint32_t *local_digests = worker->address_cache.digests;
+    ucp_rsc_index_t rsc_index;
+    ucs_status_t status;
+
+    ucs_for_each_bit(rsc_index, worker->context->tl_bitmap) {
+        /* Calculate the local digest on first use. A local digest never has
+         * atomic flags set, so they mark an iface which can't be packed. */
+        if (!(worker->address_cache.digest_map & UCS_BIT(rsc_index))) {
+            status = ucp_address_pack_local_attr(worker, rsc_index, packed);
+            local_digests[rsc_index] = (status == UCS_OK) ?
+                                       ucp_address_attr_digest(packed) :
+                                       UCP_ADDRESS_ATOMIC_FLAGS;
+            worker->address_cache.digest_map |= UCS_BIT(rsc_index);
+        }
+
+        if (local_digests[rsc_index] ==
+            (digest->digest & ~UCP_ADDRESS_ATOMIC_FLAGS)) {
+            status = ucp_address_pack_local_attr(worker, rsc_index, packed);
+            ucs_assert_always(status == UCS_OK);
+            packed->lat_ovh         = digest->lat_ovh;
+            packed->prio_cap_flags |= digest->digest &
+                                      UCP_ADDRESS_ATOMIC_FLAGS;
+            return UCS_OK;
+        }
+    }
+
+    return UCS_ERR_UNREACHABLE;
+}
+
+static const void*
+ucp_address_unpack_attr_table(ucp_worker_h worker, const void *ptr,
+                              uint8_t address_header, unsigned unpack_flags,
+                              ucp_address_attr_table_t *attr_table)
+{
+    const ucp_address_digest_iface_attr_t *digest;
+    ucp_address_packed_iface_attr_t *packed;
+    ucs_status_t status;
+
+    attr_table->count = *(const uint8_t*)ptr;
+    ptr               = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+    if (attr_table->count > UCP_MAX_RESOURCES) {
+        if (!(unpack_flags & UCP_ADDRESS_PACK_FLAG_NO_TRACE)) {
+            ucs_error("failed to parse address: number of attributes %d "
+                      "exceeds %d", attr_table->count, UCP_MAX_RESOURCES);
+        }
+        return NULL;
+    }
+
+    for (packed = attr_table->attrs;
+         packed < (attr_table->attrs + attr_table->count); ++packed) {
+        if (!(address_header & UCP_ADDRESS_HEADER_FLAG_ATTR_DIGEST)) {
+            memcpy(packed, ptr, sizeof(*packed));
+            ptr = UCS_PTR_TYPE_OFFSET(ptr, *packed);
+            continue;
+        }
+
+        digest = ptr;
+        status = ucp_address_resolve_attr_digest(worker, digest, packed);
+        if (status != UCS_OK) {
+            if (!(unpack_flags & UCP_ADDRESS_PACK_FLAG_NO_TRACE)) {
+                ucs_error("failed to parse address: no local transport "
+                          "matches attributes digest 0x%x (remote peer "
+                          "should not set UCX_ADDRESS_DIGEST)",
+                          digest->digest);
+            }
+            return NULL;
+        }
+
+        ptr = UCS_PTR_TYPE_OFFSET(ptr, *digest);
+    }
+
+    return ptr;
+}
+
+static void
+ucp_address_unpack_packed_attr(ucp_address_iface_attr_t *iface_attr,
+                               const ucp_address_packed_iface_attr_t *packed)
+{
+    iface_attr->priority            = packed->prio_cap_flags & UCS_MASK(8);
+    iface_attr->overhead            = packed->overhead;
+    iface_attr->bandwidth.dedicated = ucs_max(0.0, packed->bandwidth);
+    iface_attr->bandwidth.shared    = ucs_max(0.0, -packed->bandwidth);
+    iface_attr->lat_ovh             = packed->lat_ovh;
+
+    /* Unpack iface flags */
+    iface_attr->cap_flags =
+        ucp_address_unpack_flags(packed->prio_cap_flags,
+                                 UCP_ADDRESS_IFACE_FLAGS, 8);
+
+    /* Unpack iface event flags */
+    iface_attr->event_flags =
+        ucp_address_unpack_flags(packed->prio_cap_flags,
+                                 UCP_ADDRESS_IFACE_EVENT_FLAGS,
+                                 8 + ucs_popcount(UCP_ADDRESS_IFACE_FLAGS));
+
+    /* Unpack iface 32-bit atomic operations */
+    if (packed->prio_cap_flags & UCP_ADDRESS_FLAG_ATOMIC32) {
+        iface_attr->atomic.atomic32.op_flags  |= UCP_ATOMIC_OP_MASK;
+        iface_attr->atomic.atomic32.fop_flags |= UCP_ATOMIC_FOP_MASK;
+    }
+
+    /* Unpack iface 64-bit atomic operations */
+    if (packed->prio_cap_flags & UCP_ADDRESS_FLAG_ATOMIC64) {
+        iface_attr->atomic.atomic64.op_flags  |= UCP_ATOMIC_OP_MASK;
+        iface_attr->atomic.atomic64.fop_flags |= UCP_ATOMIC_FOP_MASK;
+    }
 }
 
 static ucs_status_t
 ucp_address_unpack_iface_attr(ucp_worker_t *worker,
                               ucp_address_iface_attr_t *iface_attr,
                               const void *ptr, unsigned unpack_flags,
+                              const ucp_address_attr_table_t *attr_table,
                               size_t *size_p)
 {
-    const ucp_address_packed_iface_attr_t *packed;
     const ucp_address_unified_iface_attr_t *unified;
     ucp_worker_iface_t *wiface;
     ucp_rsc_index_t rsc_idx;
+    uint8_t index;
 
     if (ucp_worker_is_unified_mode(worker)) {
         /* Address contains resources index and iface latency overhead
@@ -468,37 +746,23 @@ ucp_address_unpack_iface_attr(ucp_worker_t *worker,
         return UCS_OK;
     }
 
-    packed                          = ptr;
-    iface_attr->priority            = packed->prio_cap_flags & UCS_MASK(8);
-    iface_attr->overhead            = packed->overhead;
-    iface_attr->bandwidth.dedicated = ucs_max(0.0, packed->bandwidth);
-    iface_attr->bandwidth.shared    = ucs_max(0.0, -packed->bandwidth);
-    iface_attr->lat_ovh             = packed->lat_ovh;
-
-    /* Unpack iface flags */
-    iface_attr->cap_flags =
-        ucp_address_unpack_flags(packed->prio_cap_flags,
-                                 UCP_ADDRESS_IFACE_FLAGS, 8);
-
-    /* Unpack iface event flags */
-    iface_attr->event_flags =
-        ucp_address_unpack_flags(packed->prio_cap_flags,
-                                 UCP_ADDRESS_IFACE_EVENT_FLAGS,
-                                 8 + ucs_popcount(UCP_ADDRESS_IFACE_FLAGS));
+    if (attr_table != NULL) {
+        index = *(const uint8_t*)ptr;
+        if (index >= attr_table->count) {
+            if (!(unpack_flags & UCP_ADDRESS_PACK_FLAG_NO_TRACE)) {
+                ucs_error("failed to unpack address, attributes index %d is "
+                          "not valid", index);
+            }
+            return UCS_ERR_INVALID_ADDR;
+        }
 
-    /* Unpack iface 32-bit atomic operations */
-    if (packed->prio_cap_flags & UCP_ADDRESS_FLAG_ATOMIC32) {
-        iface_attr->atomic.atomic32.op_flags  |= UCP_ATOMIC_OP_MASK;
-        iface_attr->atomic.atomic32.fop_flags |= UCP_ATOMIC_FOP_MASK;
-    }
-    
-    /* Unpack iface 64-bit atomic operations */
-    if (packed->prio_cap_flags & UCP_ADDRESS_FLAG_ATOMIC64) {
-        iface_attr->atomic.atomic64.op_flags  |= UCP_ATOMIC_OP_MASK;
-        iface_attr->atomic.atomic64.fop_flags |= UCP_ATOMIC_FOP_MASK;
+        ucp_address_unpack_packed_attr(iface_attr, &attr_table->attrs[index]);
+        *size_p = sizeof(index);
+        return UCS_OK;
     }
 
-    *size_p = sizeof(*packed);
+    ucp_address_unpack_packed_attr(iface_attr, ptr);
+    *size_p = sizeof(ucp_address_packed_iface_attr_t);
     return UCS_OK;
 }
 
@@ -578,7 +842,8 @@ static ucs_status_t ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep,
                                         uint64_t tl_bitmap, unsigned pack_flags,
                                         const ucp_lane_index_t *lanes2remote,
                                         const ucp_address_packed_device_t *devices,
-                                        ucp_rsc_index_t num_devices)
+                                        ucp_rsc_index_t num_devices,
+                                        const ucp_address_attr_table_t *attr_table)
 {
     ucp_context_h context       = worker->context;
     uint64_t md_flags_pack_mask = (UCT_MD_FLAG_REG | UCT_MD_FLAG_ALLOC);
@@ -624,6 +889,15 @@ static ucs_status_t ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep,
         }
     }
 
+    if (attr_table != NULL) {
+        *address_header_p |= UCP_ADDRESS_HEADER_FLAG_ATTR_TABLE;
+        if (context->config.ext.address_digest) {
+            *address_header_p |= UCP_ADDRESS_HEADER_FLAG_ATTR_DIGEST;
+        }
+
+        ptr = ucp_address_pack_attr_table(worker, ptr, attr_table);
+    }
+
     if (num_devices == 0) {
         *((uint8_t*)ptr) = UCP_NULL_RESOURCE;
         ptr = UCS_PTR_TYPE_OFFSET(ptr, UCP_NULL_RESOURCE);
@@ -694,11 +968,16 @@ static ucs_status_t ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep,
                                       context->tl_rscs[rsc_index].tl_name_csum);
 
             /* Transport information */
-            enable_amo = worker->atomic_tls & UCS_BIT(rsc_index);
-            attr_len   = ucp_address_pack_iface_attr(worker, ptr, rsc_index,
-                                                     iface_attr, enable_amo);
-            if (attr_len < 0) {
-                return UCS_ERR_INVALID_ADDR;
+            if (attr_table != NULL) {
+                *(uint8_t*)ptr = attr_table->index[rsc_index];
+                attr_len       = sizeof(uint8_t);
+            } else {
+                enable_amo = worker->atomic_tls & UCS_BIT(rsc_index);
+                attr_len   = ucp_address_pack_iface_attr(worker, ptr, rsc_index,
+                                                         iface_attr, enable_amo);
+                if (attr_len < 0) {
+                    return UCS_ERR_INVALID_ADDR;
+                }
             }
 
             ucp_address_memcheck(context, ptr, attr_len, rsc_index);
@@ -831,6 +1110,8 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
                               const ucp_lane_index_t *lanes2remote,
                               size_t *size_p, void **buffer_p)
 {
+    ucp_address_attr_table_t *attr_table = NULL;
+    ucp_address_attr_table_t attr_table_buf;
     ucp_address_packed_device_t *devices;
     ucp_rsc_index_t num_devices;
     ucs_status_t status;
@@ -848,8 +1129,18 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
         goto out;
     }
 
+    /* Collect distinct iface attributes */
+    if (ucp_address_is_compact(worker)) {
+        attr_table = &attr_table_buf;
+        status     = ucp_address_gather_attrs(worker, tl_bitmap, attr_table);
+        if (status != UCS_OK) {
+            goto out_free_devices;
+        }
+    }
+
     /* Calculate packed size */
-    size = ucp_address_packed_size(worker, devices, num_devices, pack_flags);
+    size = ucp_address_packed_size(worker, devices, num_devices, attr_table,
+                                   pack_flags);
 
     /* Allocate address */
     buffer = ucs_malloc(size, "ucp_address");
@@ -862,7 +1153,7 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
 
     /* Pack the address */
     status = ucp_address_do_pack(worker, ep, buffer, size, tl_bitmap, pack_flags,
-                                 lanes2remote, devices, num_devices);
+                                 lanes2remote, devices, num_devices, attr_table);
     if (status != UCS_OK) {
         ucs_free(buffer);
         goto out_free_devices;
@@ -880,10 +1171,14 @@ out:
     return status;
 }
 
-ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
-                                unsigned unpack_flags,
-                                ucp_unpacked_address_t *unpacked_address)
+static ucs_status_t
+ucp_address_do_unpack(ucp_worker_t *worker, const void *buffer,
+                      unsigned unpack_flags,
+                      ucp_unpacked_address_t *unpacked_address,
+                      size_t *length_p)
 {
+    ucp_address_attr_table_t *attr_table = NULL;
+    ucp_address_attr_table_t attr_table_buf;
     ucp_address_entry_t *address_list, *address;
     uint8_t address_header, address_version;
     ucp_address_entry_ep_addr_t *ep_addr;
@@ -934,8 +1229,19 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
                          sizeof(unpacked_address->name));
     }
 
+    if (address_header & UCP_ADDRESS_HEADER_FLAG_ATTR_TABLE) {
+        attr_table = &attr_table_buf;
+        ptr        = ucp_address_unpack_attr_table(worker, ptr, address_header,
+                                                   unpack_flags, attr_table);
+        if (ptr == NULL) {
+            return UCS_ERR_UNREACHABLE;
+        }
+    }
+
     /* Empty address list */
     if (*(uint8_t*)ptr == UCP_NULL_RESOURCE) {
+        *length_p = UCS_PTR_BYTE_DIFF(buffer,
+                                      UCS_PTR_TYPE_OFFSET(ptr, uint8_t));
         return UCS_OK;
     }
 
@@ -995,7 +1301,8 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
             address->dev_num_paths = dev_num_paths;
 
             status = ucp_address_unpack_iface_attr(worker, &address->iface_attr,
-                                                   ptr, unpack_flags, &attr_len);
+                                                   ptr, unpack_flags,
+                                                   attr_table, &attr_len);
             if (status != UCS_OK) {
                 goto err_free;
             }
@@ -1064,9 +1371,203 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
 
     unpacked_address->address_count = address - address_list;
     unpacked_address->address_list  = address_list;
+    *length_p                       = UCS_PTR_BYTE_DIFF(buffer, ptr);
     return UCS_OK;
 
 err_free:
     ucs_free(address_list);
     return UCS_ERR_INVALID_PARAM;
 }
+
+ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
+                                unsigned unpack_flags,
+                                ucp_unpacked_address_t *unpacked_address)
+{
+    size_t length;
+
+    return ucp_address_do_unpack(worker, buffer, unpack_flags,
+                                 unpacked_address, &length);
+}
+
+static void ucp_address_cache_entry_remove(ucp_worker_h worker,
+                                           ucp_address_cache_entry_t *entry)
+{
+    khiter_t iter;
+
+    iter = kh_get(ucp_worker_address_cache, &worker->address_cache.hash,
+                  entry->unpacked.uuid);
+    ucs_assert(iter != kh_end(&worker->address_cache.hash));
+    kh_del(ucp_worker_address_cache, &worker->address_cache.hash, iter);
+    ucs_list_del(&entry->list);
+    --worker->address_cache.count;
+    ucs_free(entry);
+}
+
+static ucs_status_t
+ucp_address_cache_add(ucp_worker_h worker, const void *buffer, size_t length,
+                      const ucp_unpacked_address_t *unpacked_address,
+                      ucp_address_cache_entry_t **entry_p)
+{
+    size_t list_size = unpacked_address->address_count *
+                       sizeof(*unpacked_address->address_list);
+    ptrdiff_t offset;
+    ucp_address_cache_entry_t *entry;
+    ucp_address_entry_t *ae;
+    unsigned i;
+    khiter_t iter;
+    int ret;
+
+    if (worker->address_cache.count >=
+        worker->context->config.ext.address_cache_size) {
+        ucp_address_cache_entry_remove(worker,
+                                       ucs_list_tail(&worker->address_cache.lru,
+                                                     ucp_address_cache_entry_t,
+                                                     list));
+    }
+
+    /* Allocate the entry, the address list and the packed address copy in a
+     * single buffer */
+    entry = ucs_malloc(sizeof(*entry) + list_size + length,
+                       "ucp_address_cache_entry");
+    if (entry == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    iter = kh_put(ucp_worker_address_cache, &worker->address_cache.hash,
+                  unpacked_address->uuid, &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        ucs_free(entry);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ucs_assert(ret != UCS_KH_PUT_KEY_PRESENT);
+    kh_value(&worker->address_cache.hash, iter) = entry;
+
+    entry->unpacked              = *unpacked_address;
+    entry->unpacked.address_list = (ucp_address_entry_t*)(entry + 1);
+    entry->length                = length;
+    entry->buffer                = UCS_PTR_BYTE_OFFSET(entry + 1, list_size);
+    memcpy((void*)entry->buffer, buffer, length);
+    if (list_size > 0) {
+        memcpy(entry->unpacked.address_list, unpacked_address->address_list,
+               list_size);
+    }
+
+    /* Make the address entries point into the copy of the packed address */
+    offset = UCS_PTR_BYTE_DIFF(buffer, entry->buffer);
+    ucp_unpacked_address_for_each(ae, &entry->unpacked) {
+        if (ae->dev_addr != NULL) {
+            ae->dev_addr = UCS_PTR_BYTE_OFFSET(ae->dev_addr, offset);
+        }
+        if (ae->iface_addr != NULL) {
+            ae->iface_addr = UCS_PTR_BYTE_OFFSET(ae->iface_addr, offset);
+        }
+        for (i = 0; i < ae->num_ep_addrs; ++i) {
+            ae->ep_addrs[i].addr = UCS_PTR_BYTE_OFFSET(ae->ep_addrs[i].addr,
+                                                       offset);
+        }
+    }
+
+    ucs_list_add_head(&worker->address_cache.lru, &entry->list);
+    ++worker->address_cache.count;
+    *entry_p = entry;
+    return UCS_OK;
+}
+
+/*
+ * The packed address does not carry its length, so it is compared with the
+ * cached one byte by byte, up to the first difference. The address layout is
+ * determined by the bytes before each field, so an address which is equal to
+ * the cached one so far continues at least as far as the cached one does, and
+ * the comparison never reads past its end.
+ */
+static int ucp_address_cache_entry_match(const ucp_address_cache_entry_t *entry,
+                                         const void *buffer)
+{
+    const uint8_t *cached_ptr = entry->buffer;
+    const uint8_t *ptr        = buffer;
+    size_t i;
+
+    for (i = 0; i < entry->length; ++i) {
+        if (cached_ptr[i] != ptr[i]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+ucs_status_t ucp_address_unpack_cached(ucp_worker_h worker, const void *buffer,
+                                       ucp_unpacked_address_t *unpacked_address,
+                                       int *cached_p)
+{
+    ucp_address_cache_entry_t *entry;
+    ucs_status_t status;
+    uint64_t uuid;
+    size_t length;
+    khiter_t iter;
+
+    if (worker->context->config.ext.address_cache_size == 0) {
+        *cached_p = 0;
+        return ucp_address_unpack(worker, buffer, UCP_ADDRESS_PACK_FLAGS_ALL,
+                                  unpacked_address);
+    }
+
+    /* The address is a valid cache hit only if it was not changed since it was
+     * cached, for example if the remote worker was re-created with the same
+     * UUID by a checkpoint/restart */
+    uuid = *(const uint64_t*)UCS_PTR_TYPE_OFFSET(buffer, uint8_t);
+    iter = kh_get(ucp_worker_address_cache, &worker->address_cache.hash, uuid);
+    if (iter != kh_end(&worker->address_cache.hash)) {
+        entry = kh_value(&worker->address_cache.hash, iter);
+        if (ucp_address_cache_entry_match(entry, buffer)) {
+            UCS_STATS_UPDATE_COUNTER(worker->stats,
+                                     UCP_WORKER_STAT_ADDRESS_CACHE_HIT, 1);
+            ucs_list_del(&entry->list);
+            ucs_list_add_head(&worker->address_cache.lru, &entry->list);
+            goto out;
+        }
+
+        ucp_address_cache_entry_remove(worker, entry);
+    }
+
+    UCS_STATS_UPDATE_COUNTER(worker->stats, UCP_WORKER_STAT_ADDRESS_CACHE_MISS,
+                             1);
+
+    status = ucp_address_do_unpack(worker, buffer, UCP_ADDRESS_PACK_FLAGS_ALL,
+                                   unpacked_address, &length);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucp_address_cache_add(worker, buffer, length, unpacked_address,
+                                   &entry);
+    ucs_free(unpacked_address->address_list);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+out:
+    *unpacked_address = entry->unpacked;
+    *cached_p         = 1;
+    return UCS_OK;
+}
+
+void ucp_address_cache_init(ucp_worker_h worker)
+{
+    kh_init_inplace(ucp_worker_address_cache, &worker->address_cache.hash);
+    ucs_list_head_init(&worker->address_cache.lru);
+    worker->address_cache.count      = 0;
+    worker->address_cache.digest_map = 0;
+}
+
+void ucp_address_cache_cleanup(ucp_worker_h worker)
+{
+    ucp_address_cache_entry_t *entry, *tmp;
+
+    ucs_list_for_each_safe(entry, tmp, &worker->address_cache.lru, list) {
+        ucs_free(entry);
+    }
+
+    kh_destroy_inplace(ucp_worker_address_cache, &worker->address_cache.hash);
+}
@@ -105,6 +105,18 @@ struct ucp_unpacked_address {
 };
 
 
+/**
+ * Cached unpacked remote worker address.
+ */
+struct ucp_address_cache_entry {
+    ucs_list_link_t            list;            /* Element in worker LRU list */
+    size_t                     length;          /* Packed address length */
+    const void                 *buffer;         /* Copy of the packed address */
+    ucp_unpacked_address_t     unpacked;        /* Unpacked address, which
+                                                   points into the buffer */
+};
+
+
 /* Iterate over entries in an unpacked address */
 #define ucp_unpacked_address_for_each(_elem, _unpacked_address) \
     for (_elem = (_unpacked_address)->address_list; \
@@ -166,4 +178,35 @@ ucs_status_t ucp_address_unpack(ucp_worker_h worker, const void *buffer,
                                 ucp_unpacked_address_t *unpacked_address);
 
 
+/**
+ * Unpack a full worker address, using the worker cache of unpacked addresses.
+ *
+ * @param [in]  worker           Worker object.
+ * @param [in]  buffer           Worker address packed with
+ *                               @ref UCP_ADDRESS_PACK_FLAGS_ALL.
+ * @param [out] unpacked_address Filled with remote address data.
+ * @param [out] cached_p         Set to 1 if the address list is owned by the
+ *                               cache and must not be released by the caller,
+ *                               or to 0 if it should be released by ucs_free().
+ *
+ * @note A cached address is valid until the next call to this function, or
+ *       until the worker is destroyed.
+ */
+ucs_status_t ucp_address_unpack_cached(ucp_worker_h worker, const void *buffer,
+                                       ucp_unpacked_address_t *unpacked_address,
+                                       int *cached_p);
+
+
+/**
+ * Initialize the worker cache of unpacked remote addresses.
+ */
+void ucp_address_cache_init(ucp_worker_h worker);
+
+
+/**
+ * Release all entries in the worker cache of unpacked remote addresses.
+ */
+void ucp_address_cache_cleanup(ucp_worker_h worker);
+
+
 #endif
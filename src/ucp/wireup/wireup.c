@@ -192,7 +192,7 @@ ucp_wireup_msg_send(ucp_ep_h ep, uint8_t type, uint64_t tl_bitmap,
 
     req->send.buffer = address;
 
-    ucp_request_send(req, 0);
+    ucp_request_send(req, UCT_PENDING_FLAG_PRIO_HIGH);
     return UCS_OK;
 }
 
@@ -966,6 +966,107 @@ int ucp_wireup_is_reachable(ucp_ep_h ep, ucp_rsc_index_t rsc_index,
             uct_iface_is_reachable(wiface->iface, ae->dev_addr, ae->iface_addr));
 }
 
+static void
+ucp_wireup_select_layout_init(ucp_ep_h ep,
+                              const ucp_unpacked_address_t *remote_address,
+                              ucp_wireup_select_layout_t *layout)
+{
+    ucp_context_h context = ep->worker->context;
+    const ucp_address_entry_t *ae;
+    ucp_rsc_index_t rsc_index;
+
+    /* Zero the padding, since layouts are compared by memcmp() */
+    memset(layout, 0, sizeof(*layout) * remote_address->address_count);
+
+    ucp_unpacked_address_for_each(ae, remote_address) {
+        layout->reachable_tls = 0;
+        ucs_for_each_bit(rsc_index, context->tl_bitmap) {
+            if (ucp_wireup_is_reachable(ep, rsc_index, ae)) {
+                layout->reachable_tls |= UCS_BIT(rsc_index);
+            }
+        }
+
+        layout->cap_flags           = ae->iface_attr.cap_flags;
+        layout->event_flags         = ae->iface_attr.event_flags;
+        layout->md_flags            = ae->md_flags;
+        layout->overhead            = ae->iface_attr.overhead;
+        layout->bandwidth_dedicated = ae->iface_attr.bandwidth.dedicated;
+        layout->bandwidth_shared    = ae->iface_attr.bandwidth.shared;
+        layout->lat_ovh             = ae->iface_attr.lat_ovh;
+        layout->atomic              = ae->iface_attr.atomic;
+        layout->priority            = ae->iface_attr.priority;
+        layout->dev_num_paths       = ae->dev_num_paths;
+        layout->tl_name_csum        = ae->tl_name_csum;
+        layout->md_index            = ae->md_index;
+        layout->dev_index           = ae->dev_index;
+        ++layout;
+    }
+}
+
+static ucp_wireup_select_cache_entry_t*
+ucp_wireup_select_cache_find(ucp_worker_h worker, unsigned ep_init_flags,
+                             uint64_t tl_bitmap, unsigned address_count,
+                             const ucp_wireup_select_layout_t *layout)
+{
+    ucp_wireup_select_cache_entry_t *entry;
+    unsigned i;
+
+    for (i = 0; i < UCP_WIREUP_SELECT_CACHE_SIZE; ++i) {
+        entry = worker->select_cache.entries[i];
+        if ((entry != NULL) && (entry->ep_init_flags == ep_init_flags) &&
+            (entry->tl_bitmap == tl_bitmap) &&
+            (entry->address_count == address_count) &&
+            !memcmp(entry->layout, layout, sizeof(*layout) * address_count)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+ucp_wireup_select_cache_add(ucp_worker_h worker, unsigned ep_init_flags,
+                            uint64_t tl_bitmap, unsigned address_count,
+                            const ucp_wireup_select_layout_t *layout,
+                            ucp_worker_cfg_index_t cfg_index,
+                            const unsigned *addr_indices)
+{
+    size_t layout_size = sizeof(*layout) * address_count;
+    ucp_wireup_select_cache_entry_t **entry_p;
+
+    /* Replace the oldest entry */
+    entry_p = &worker->select_cache.entries[worker->select_cache.next];
+    ucs_free(*entry_p);
+
+    *entry_p = ucs_malloc(sizeof(**entry_p) + layout_size,
+                          "ucp_wireup_select_cache_entry");
+    if (*entry_p == NULL) {
+        /* The cache is only an optimization */
+        return;
+    }
+
+    (*entry_p)->ep_init_flags = ep_init_flags;
+    (*entry_p)->tl_bitmap     = tl_bitmap;
+    (*entry_p)->address_count = address_count;
+    (*entry_p)->cfg_index     = cfg_index;
+    memcpy((*entry_p)->addr_indices, addr_indices,
+           sizeof((*entry_p)->addr_indices));
+    memcpy((*entry_p)->layout, layout, layout_size);
+
+    worker->select_cache.next = (worker->select_cache.next + 1) %
+                                UCP_WIREUP_SELECT_CACHE_SIZE;
+}
+
+void ucp_wireup_select_cache_cleanup(ucp_worker_h worker)
+{
+    unsigned i;
+
+    for (i = 0; i < UCP_WIREUP_SELECT_CACHE_SIZE; ++i) {
+        ucs_free(worker->select_cache.entries[i]);
+        worker->select_cache.entries[i] = NULL;
+    }
+}
+
 static void
 ucp_wireup_get_reachable_mds(ucp_ep_h ep,
                              const ucp_unpacked_address_t *remote_address,
@@ -1037,6 +1138,8 @@ ucs_status_t ucp_wireup_init_lanes(ucp_ep_h ep, unsigned ep_init_flags,
     ucp_worker_h worker    = ep->worker;
     uint64_t tl_bitmap     = local_tl_bitmap & worker->context->tl_bitmap;
     ucp_rsc_index_t cm_idx = UCP_NULL_RESOURCE;
+    ucp_wireup_select_layout_t *layout = NULL;
+    ucp_wireup_select_cache_entry_t *cache_entry;
     ucp_ep_config_key_t key;
     ucp_worker_cfg_index_t new_cfg_index;
     ucp_lane_index_t lane;
@@ -1051,6 +1154,22 @@ ucs_status_t ucp_wireup_init_lanes(ucp_ep_h ep, unsigned ep_init_flags,
     ucp_ep_config_key_reset(&key);
     ucp_ep_config_key_set_err_mode(&key, ep_init_flags);
 
+    /* A new endpoint to an address with the same transport layout as a
+     * previous one would select the same lanes and configuration */
+    if (ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL) {
+        layout = ucs_alloca(sizeof(*layout) * remote_address->address_count);
+        ucp_wireup_select_layout_init(ep, remote_address, layout);
+        cache_entry = ucp_wireup_select_cache_find(
+                worker, ep_init_flags, tl_bitmap,
+                remote_address->address_count, layout);
+        if (cache_entry != NULL) {
+            memcpy(addr_indices, cache_entry->addr_indices,
+                   sizeof(cache_entry->addr_indices));
+            new_cfg_index = cache_entry->cfg_index;
+            goto out_set_config;
+        }
+    }
+
     status = ucp_wireup_select_lanes(ep, ep_init_flags, tl_bitmap,
                                      remote_address, addr_indices, &key);
     if (status != UCS_OK) {
@@ -1069,6 +1188,13 @@ ucs_status_t ucp_wireup_init_lanes(ucp_ep_h ep, unsigned ep_init_flags,
         return status;
     }
 
+    if (layout != NULL) {
+        ucp_wireup_select_cache_add(worker, ep_init_flags, tl_bitmap,
+                                    remote_address->address_count, layout,
+                                    new_cfg_index, addr_indices);
+    }
+
+out_set_config:
     if (ep->cfg_index == new_cfg_index) {
         return UCS_OK; /* No change */
     }
@@ -1100,7 +1226,7 @@ ucs_status_t ucp_wireup_init_lanes(ucp_ep_h ep, unsigned ep_init_flags,
     }
 
     ep->cfg_index = new_cfg_index;
-    ep->am_lane   = key.am_lane;
+    ep->am_lane   = ucp_ep_config(ep)->key.am_lane;
 
     snprintf(str, sizeof(str), "ep %p", ep);
     ucp_wireup_print_config(worker, &ucp_ep_config(ep)->key, str,
@@ -1115,7 +1241,7 @@ ucs_status_t ucp_wireup_init_lanes(ucp_ep_h ep, unsigned ep_init_flags,
         }
 
         status = ucp_wireup_connect_lane(ep, ep_init_flags, lane,
-                                         key.lanes[lane].path_index,
+                                         ucp_ep_get_path_index(ep, lane),
                                          remote_address, addr_indices[lane]);
         if (status != UCS_OK) {
             return status;
@@ -1253,7 +1379,8 @@ ucs_status_t ucp_wireup_connect_remote(ucp_ep_h ep, ucp_lane_index_t lane)
         status = uct_ep_pending_add(ep->uct_eps[lane], &req->send.uct,
                                     (req->send.uct.func == ucp_wireup_msg_progress) ||
                                     (req->send.uct.func == ucp_wireup_ep_progress_pending) ?
-                                    UCT_CB_FLAG_ASYNC : 0);
+                                    (UCT_CB_FLAG_ASYNC |
+                                     UCT_PENDING_FLAG_PRIO_HIGH) : 0);
         if (status != UCS_OK) {
             ucs_fatal("wireup proxy function must always return UCS_OK");
         }
@@ -87,6 +87,43 @@ typedef struct {
 } ucp_wireup_select_info_t;
 
 
+/**
+ * Transport layout of a remote address entry, which is all the information
+ * used by lane selection, except the actual transport addresses.
+ */
+typedef struct {
+    uint64_t                    reachable_tls;       /* Local resources which
+                                                        can reach the entry */
+    uint64_t                    cap_flags;
+    uint64_t                    event_flags;
+    uint64_t                    md_flags;
+    double                      overhead;
+    double                      bandwidth_dedicated;
+    double                      bandwidth_shared;
+    double                      lat_ovh;
+    ucp_tl_iface_atomic_flags_t atomic;
+    int                         priority;
+    unsigned                    dev_num_paths;
+    uint16_t                    tl_name_csum;
+    ucp_md_index_t              md_index;
+    ucp_rsc_index_t             dev_index;
+} ucp_wireup_select_layout_t;
+
+
+/**
+ * Lanes selected for a remote address with a given transport layout.
+ */
+struct ucp_wireup_select_cache_entry {
+    unsigned                    ep_init_flags;
+    uint64_t                    tl_bitmap;
+    unsigned                    address_count;
+    ucp_worker_cfg_index_t      cfg_index;
+    unsigned                    addr_indices[UCP_MAX_LANES];
+    ucp_wireup_select_layout_t  layout[0];           /* One for each address
+                                                        entry */
+};
+
+
 ucs_status_t ucp_wireup_send_request(ucp_ep_h ep);
 
 ucs_status_t ucp_wireup_send_pre_request(ucp_ep_h ep);
@@ -115,6 +152,8 @@ int ucp_wireup_msg_ack_cb_pred(const ucs_callbackq_elem_t *elem, void *arg);
 int ucp_wireup_is_reachable(ucp_ep_h ep, ucp_rsc_index_t rsc_index,
                             const ucp_address_entry_t *ae);
 
+void ucp_wireup_select_cache_cleanup(ucp_worker_h worker);
+
 ucs_status_t ucp_wireup_init_lanes(ucp_ep_h ep, unsigned ep_init_flags,
                                    uint64_t local_tl_bitmap,
                                    const ucp_unpacked_address_t *remote_address,
@@ -16,6 +16,9 @@
 #include <ucs/sys/math.h>
 #include <ucs/sys/sys.h>
 #include <ucs/sys/string.h>
+#include <ucs/time/time.h>
+#include <immintrin.h>
+#include <float.h>
 
 #define X86_CPUID_GENUINEINTEL    "GenuntelineI" /* GenuineIntel in magic notation */
 #define X86_CPUID_AUTHENTICAMD    "AuthcAMDenti" /* AuthenticAMD in magic notation */
@@ -27,6 +30,12 @@
 #define X86_CPUID_GET_CACHE_INFO  0x00000002u
 #define X86_CPUID_GET_LEAF4_INFO  0x00000004u
 
+/* Size classes which are measured by memcpy calibration */
+#define X86_MEMCPY_CALIB_MIN_CLASS   10 /* 1k */
+#define X86_MEMCPY_CALIB_MAX_CLASS   24 /* 16m */
+#define X86_MEMCPY_CALIB_MIN_BYTES   (4 * UCS_MBYTE)
+#define X86_MEMCPY_CALIB_ROUNDS      3
+
 #define X86_CPU_CACHE_RESERVED    0x80000000
 #define X86_CPU_CACHE_TAG_L1_ONLY 0x40
 #define X86_CPU_CACHE_TAG_LEAF4   0xff
@@ -434,10 +443,19 @@ int ucs_arch_get_cpu_flag()
             }
         }
         if (base_value >= 7) {
-            ucs_x86_cpuid(X86_CPUID_GET_EXTD_VALUE, &_eax, &_ebx, &_ecx, &_edx);
+            /* extended features leaf requires sub-leaf 0 in ecx */
+            ucs_x86_cpuid_ecx(X86_CPUID_GET_EXTD_VALUE, 0, &_eax, &_ebx, &_ecx,
+                              &_edx);
             if ((result & UCS_CPU_FLAG_AVX) && (_ebx & (1 << 5))) {
                 result |= UCS_CPU_FLAG_AVX2;
             }
+            if ((result & UCS_CPU_FLAG_AVX) && (_ebx & (1 << 16))) {
+                /* OS must save opmask and ZMM registers state */
+                ucs_x86_xgetbv(0, _eax, _edx);
+                if ((_eax & 0xe6) == 0xe6) {
+                    result |= UCS_CPU_FLAG_AVX512F;
+                }
+            }
         }
         cpu_flag = result;
     }
@@ -461,6 +479,318 @@ ucs_cpu_vendor_t ucs_arch_get_cpu_vendor()
     return UCS_CPU_VENDOR_UNKNOWN;
 }
 
+ucs_x86_memcpy_func_t ucs_x86_memcpy_dispatch[UCS_X86_MEMCPY_SIZE_CLASSES];
+size_t ucs_x86_memcpy_dispatch_min = SIZE_MAX;
+
+static ucs_x86_memcpy_kernel_t ucs_x86_memcpy_kernels[UCS_X86_MEMCPY_SIZE_CLASSES];
+
+static const char *ucs_x86_memcpy_kernel_names[] = {
+    [UCS_X86_MEMCPY_LIBC]      = "libc",
+    [UCS_X86_MEMCPY_BUILTIN]   = "built-in",
+    [UCS_X86_MEMCPY_AVX2]      = "avx2",
+    [UCS_X86_MEMCPY_AVX2_NT]   = "avx2 non-temporal",
+    [UCS_X86_MEMCPY_AVX512]    = "avx512",
+    [UCS_X86_MEMCPY_AVX512_NT] = "avx512 non-temporal"
+};
+
+static void ucs_x86_memcpy_libc(void *dst, const void *src, size_t len)
+{
+    memcpy(dst, src, len);
+}
+
+static void ucs_x86_memcpy_builtin(void *dst, const void *src, size_t len)
+{
+    asm volatile ("rep movsb"
+                  : "=D" (dst),
+                  "=S" (src),
+                  "=c" (len)
+                  : "0" (dst),
+                  "1" (src),
+                  "2" (len)
+                  : "memory");
+}
+
+/*
+ * The vector kernels copy the unaligned tail by an overlapping vector, so they
+ * require len >= vector size. The overlapping parts are written twice with the
+ * same data, so the order of temporal and non-temporal stores does not matter.
+ */
+#define UCS_X86_MEMCPY_VEC(_vec_t, _load, _store, _vec_store, _align_dst, \
+                           _dst, _src, _len) \
+    { \
+        const size_t vsize = sizeof(_vec_t); \
+        char *d            = (char*)(_dst); \
+        const char *s      = (const char*)(_src); \
+        size_t n           = (_len); \
+        size_t head; \
+        _vec_t v0, v1, v2, v3; \
+        \
+        if (n < vsize) { \
+            memcpy(d, s, n); \
+            return; \
+        } \
+        \
+        if (_align_dst) { \
+            head = -(uintptr_t)d & (vsize - 1); \
+            if (head != 0) { \
+                _store((_vec_t*)d, _load((const _vec_t*)s)); \
+                d += head; \
+                s += head; \
+                n -= head; \
+            } \
+        } \
+        \
+        while (n >= (4 * vsize)) { \
+            v0 = _load((const _vec_t*)(s + (0 * vsize))); \
+            v1 = _load((const _vec_t*)(s + (1 * vsize))); \
+            v2 = _load((const _vec_t*)(s + (2 * vsize))); \
+            v3 = _load((const _vec_t*)(s + (3 * vsize))); \
+            _vec_store((_vec_t*)(d + (0 * vsize)), v0); \
+            _vec_store((_vec_t*)(d + (1 * vsize)), v1); \
+            _vec_store((_vec_t*)(d + (2 * vsize)), v2); \
+            _vec_store((_vec_t*)(d + (3 * vsize)), v3); \
+            d += 4 * vsize; \
+            s += 4 * vsize; \
+            n -= 4 * vsize; \
+        } \
+        \
+        while (n >= vsize) { \
+            _vec_store((_vec_t*)d, _load((const _vec_t*)s)); \
+            d += vsize; \
+            s += vsize; \
+            n -= vsize; \
+        } \
+        \
+        if (n > 0) { \
+            _store((_vec_t*)(d + n - vsize), \
+                   _load((const _vec_t*)(s + n - vsize))); \
+        } \
+    }
+
+#if HAVE_ATTRIBUTE_TARGET_AVX2
+static void UCS_F_TARGET("avx2")
+ucs_x86_memcpy_avx2(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_VEC(__m256i, _mm256_loadu_si256, _mm256_storeu_si256,
+                       _mm256_storeu_si256, 0, dst, src, len);
+}
+
+static void UCS_F_TARGET("avx2")
+ucs_x86_memcpy_avx2_nt(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_VEC(__m256i, _mm256_loadu_si256, _mm256_storeu_si256,
+                       _mm256_stream_si256, 1, dst, src, len);
+    _mm_sfence();
+}
+#endif
+
+#if HAVE_ATTRIBUTE_TARGET_AVX512F
+static void UCS_F_TARGET("avx512f")
+ucs_x86_memcpy_avx512(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_VEC(__m512i, _mm512_loadu_si512, _mm512_storeu_si512,
+                       _mm512_storeu_si512, 0, dst, src, len);
+}
+
+static void UCS_F_TARGET("avx512f")
+ucs_x86_memcpy_avx512_nt(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_VEC(__m512i, _mm512_loadu_si512, _mm512_storeu_si512,
+                       _mm512_stream_si512, 1, dst, src, len);
+    _mm_sfence();
+}
+#endif
+
+const char *ucs_x86_memcpy_kernel_name(ucs_x86_memcpy_kernel_t kernel)
+{
+    return ucs_x86_memcpy_kernel_names[kernel];
+}
+
+ucs_x86_memcpy_func_t ucs_x86_memcpy_kernel_func(ucs_x86_memcpy_kernel_t kernel)
+{
+    int UCS_V_UNUSED cpu_flags = ucs_arch_get_cpu_flag();
+
+    switch (kernel) {
+    case UCS_X86_MEMCPY_LIBC:
+        return ucs_x86_memcpy_libc;
+    case UCS_X86_MEMCPY_BUILTIN:
+        return ucs_x86_memcpy_builtin;
+#if HAVE_ATTRIBUTE_TARGET_AVX2
+    case UCS_X86_MEMCPY_AVX2:
+        return (cpu_flags & UCS_CPU_FLAG_AVX2) ? ucs_x86_memcpy_avx2 : NULL;
+    case UCS_X86_MEMCPY_AVX2_NT:
+        return (cpu_flags & UCS_CPU_FLAG_AVX2) ? ucs_x86_memcpy_avx2_nt : NULL;
+#endif
+#if HAVE_ATTRIBUTE_TARGET_AVX512F
+    case UCS_X86_MEMCPY_AVX512:
+        return (cpu_flags & UCS_CPU_FLAG_AVX512F) ? ucs_x86_memcpy_avx512 :
+                                                     NULL;
+    case UCS_X86_MEMCPY_AVX512_NT:
+        return (cpu_flags & UCS_CPU_FLAG_AVX512F) ? ucs_x86_memcpy_avx512_nt :
+                                                     NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+ucs_x86_memcpy_kernel_t ucs_x86_memcpy_get_kernel(size_t len)
+{
+    if (len < ucs_x86_memcpy_dispatch_min) {
+        return UCS_X86_MEMCPY_LIBC;
+    }
+
+    return ucs_x86_memcpy_kernels[__ucs_ilog2_u64(len)];
+}
+
+static void ucs_x86_memcpy_set_kernel(unsigned size_class,
+                                      ucs_x86_memcpy_kernel_t kernel)
+{
+    ucs_x86_memcpy_kernels[size_class]  = kernel;
+    ucs_x86_memcpy_dispatch[size_class] = ucs_x86_memcpy_kernel_func(kernel);
+}
+
+static double ucs_x86_memcpy_measure(ucs_x86_memcpy_func_t func, void *dst,
+                                     const void *src, size_t len)
+{
+    unsigned iters = ucs_max(X86_MEMCPY_CALIB_MIN_BYTES / len, 1);
+    double best_time, time;
+    ucs_time_t start;
+    unsigned round, i;
+
+    func(dst, src, len); /* warmup */
+
+    best_time = DBL_MAX;
+    for (round = 0; round < X86_MEMCPY_CALIB_ROUNDS; ++round) {
+        start = ucs_get_time();
+        for (i = 0; i < iters; ++i) {
+            func(dst, src, len);
+        }
+        time      = ucs_time_to_sec(ucs_get_time() - start) / iters;
+        best_time = ucs_min(best_time, time);
+    }
+
+    return best_time;
+}
+
+/* Select the fastest implementation for every size class in the calibrated
+ * range, the larger size classes use the selection of the largest one */
+static void ucs_x86_memcpy_calibrate()
+{
+    size_t max_len = UCS_BIT(X86_MEMCPY_CALIB_MAX_CLASS);
+    ucs_x86_memcpy_kernel_t kernel, best_kernel;
+    ucs_x86_memcpy_func_t func;
+    double best_time, time;
+    unsigned size_class;
+    void *src, *dst;
+
+    src = ucs_malloc(max_len, "memcpy_calib_src");
+    dst = ucs_malloc(max_len, "memcpy_calib_dst");
+    if ((src == NULL) || (dst == NULL)) {
+        ucs_warn("failed to allocate buffers for memcpy calibration");
+        goto out;
+    }
+
+    memset(src, 0x5a, max_len);
+    memset(dst, 0, max_len);
+
+    best_kernel = UCS_X86_MEMCPY_LIBC;
+    for (size_class = X86_MEMCPY_CALIB_MIN_CLASS;
+         size_class <= X86_MEMCPY_CALIB_MAX_CLASS; ++size_class) {
+        best_time = DBL_MAX;
+        for (kernel = 0; kernel < UCS_X86_MEMCPY_LAST; ++kernel) {
+            func = ucs_x86_memcpy_kernel_func(kernel);
+            if ((func == NULL) ||
+                ((kernel == UCS_X86_MEMCPY_BUILTIN) && !ENABLE_BUILTIN_MEMCPY)) {
+                continue;
+            }
+
+            time = ucs_x86_memcpy_measure(func, dst, src, UCS_BIT(size_class));
+            ucs_trace("memcpy %s size %zu: %.2f GB/s",
+                      ucs_x86_memcpy_kernel_name(kernel), UCS_BIT(size_class),
+                      UCS_BIT(size_class) / time / UCS_GBYTE);
+            if (time < best_time) {
+                best_time   = time;
+                best_kernel = kernel;
+            }
+        }
+
+        ucs_x86_memcpy_set_kernel(size_class, best_kernel);
+    }
+
+    for (; size_class < UCS_X86_MEMCPY_SIZE_CLASSES; ++size_class) {
+        ucs_x86_memcpy_set_kernel(size_class, best_kernel);
+    }
+
+out:
+    ucs_free(dst);
+    ucs_free(src);
+}
+
+static ucs_x86_memcpy_kernel_t ucs_x86_memcpy_best_nt_kernel()
+{
+    if (ucs_x86_memcpy_kernel_func(UCS_X86_MEMCPY_AVX512_NT) != NULL) {
+        return UCS_X86_MEMCPY_AVX512_NT;
+    } else if (ucs_x86_memcpy_kernel_func(UCS_X86_MEMCPY_AVX2_NT) != NULL) {
+        return UCS_X86_MEMCPY_AVX2_NT;
+    }
+
+    return UCS_X86_MEMCPY_LIBC;
+}
+
+static void ucs_x86_memcpy_init()
+{
+    size_t nt_min = ucs_global_opts.arch.nt_memcpy_min;
+    ucs_x86_memcpy_kernel_t nt_kernel, kernel;
+    unsigned size_class;
+    size_t llc_size;
+
+    for (size_class = 0; size_class < UCS_X86_MEMCPY_SIZE_CLASSES;
+         ++size_class) {
+        ucs_x86_memcpy_set_kernel(size_class, UCS_X86_MEMCPY_LIBC);
+    }
+
+    if (ucs_global_opts.arch.memcpy_calibrate) {
+        ucs_x86_memcpy_calibrate();
+    } else {
+        nt_kernel = ucs_x86_memcpy_best_nt_kernel();
+        if (nt_min == UCS_MEMUNITS_AUTO) {
+            llc_size = ucs_cpu_get_cache_size(UCS_CPU_CACHE_L3);
+            nt_min   = (llc_size == 0) ? UCS_MEMUNITS_INF : (llc_size / 2);
+        }
+
+        /* A size class uses an implementation only if the whole class is
+         * inside the configured range */
+        for (size_class = 0; size_class < UCS_X86_MEMCPY_SIZE_CLASSES;
+             ++size_class) {
+            if ((nt_kernel != UCS_X86_MEMCPY_LIBC) &&
+                (UCS_BIT(size_class) >= nt_min)) {
+                kernel = nt_kernel;
+#if ENABLE_BUILTIN_MEMCPY
+            } else if ((UCS_BIT(size_class) >=
+                        ucs_global_opts.arch.builtin_memcpy_min) &&
+                       ((size_class + 1) < UCS_X86_MEMCPY_SIZE_CLASSES) &&
+                       (UCS_BIT(size_class + 1) <=
+                        ucs_global_opts.arch.builtin_memcpy_max)) {
+                kernel = UCS_X86_MEMCPY_BUILTIN;
+#endif
+            } else {
+                continue;
+            }
+
+            ucs_x86_memcpy_set_kernel(size_class, kernel);
+        }
+    }
+
+    for (size_class = 0; size_class < UCS_X86_MEMCPY_SIZE_CLASSES;
+         ++size_class) {
+        if (ucs_x86_memcpy_kernels[size_class] != UCS_X86_MEMCPY_LIBC) {
+            ucs_x86_memcpy_dispatch_min = UCS_BIT(size_class);
+            break;
+        }
+    }
+}
+
 #if ENABLE_BUILTIN_MEMCPY
 static size_t ucs_cpu_memcpy_thresh(size_t user_val, size_t auto_val)
 {
@@ -488,6 +818,7 @@ void ucs_cpu_init()
         ucs_cpu_memcpy_thresh(ucs_global_opts.arch.builtin_memcpy_max,
                               ucs_cpu_builtin_memcpy[ucs_arch_get_cpu_vendor()].max);
 #endif
+    ucs_x86_memcpy_init();
 }
 
 ucs_status_t ucs_arch_get_cache_size(size_t *cache_sizes)
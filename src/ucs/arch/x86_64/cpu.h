@@ -9,6 +9,7 @@
 #define UCS_ASM_X86_64_H_
 
 #include <ucs/sys/compiler.h>
+#include <ucs/arch/bitops.h>
 #include <ucs/arch/generic/cpu.h>
 #include <ucs/sys/compiler_def.h>
 #include <ucs/config/types.h>
@@ -42,8 +43,34 @@ BEGIN_C_DECLS
 #define ucs_memory_cpu_load_fence()   ucs_compiler_fence()
 #define ucs_memory_cpu_wc_fence()     asm volatile ("sfence" ::: "memory")
 
+/* Number of memcpy size classes, by log2 of the length */
+#define UCS_X86_MEMCPY_SIZE_CLASSES   64
+
+
+/**
+ * memcpy implementations which can be selected per size class
+ */
+typedef enum {
+    UCS_X86_MEMCPY_LIBC,        /* memcpy() from libc */
+    UCS_X86_MEMCPY_BUILTIN,     /* "rep movsb" */
+    UCS_X86_MEMCPY_AVX2,        /* AVX2 loads and stores */
+    UCS_X86_MEMCPY_AVX2_NT,     /* AVX2 loads and non-temporal stores */
+    UCS_X86_MEMCPY_AVX512,      /* AVX-512 loads and stores */
+    UCS_X86_MEMCPY_AVX512_NT,   /* AVX-512 loads and non-temporal stores */
+    UCS_X86_MEMCPY_LAST
+} ucs_x86_memcpy_kernel_t;
+
+
+typedef void (*ucs_x86_memcpy_func_t)(void *dst, const void *src, size_t len);
+
+
 extern ucs_ternary_value_t ucs_arch_x86_enable_rdtsc;
 
+/* Selected memcpy implementation for every size class, and the minimal length
+ * which is not copied by libc memcpy() */
+extern ucs_x86_memcpy_func_t ucs_x86_memcpy_dispatch[UCS_X86_MEMCPY_SIZE_CLASSES];
+extern size_t ucs_x86_memcpy_dispatch_min;
+
 double ucs_arch_get_clocks_per_sec();
 double ucs_x86_init_tsc_freq();
 
@@ -53,6 +80,9 @@ ucs_cpu_vendor_t ucs_arch_get_cpu_vendor();
 void ucs_cpu_init();
 ucs_status_t ucs_arch_get_cache_size(size_t *cache_sizes);
 void ucs_x86_memcpy_sse_movntdqa(void *dst, const void *src, size_t len);
+const char *ucs_x86_memcpy_kernel_name(ucs_x86_memcpy_kernel_t kernel);
+ucs_x86_memcpy_func_t ucs_x86_memcpy_kernel_func(ucs_x86_memcpy_kernel_t kernel);
+ucs_x86_memcpy_kernel_t ucs_x86_memcpy_get_kernel(size_t len);
 
 static inline int ucs_arch_x86_rdtsc_enabled()
 {
@@ -93,20 +123,13 @@ static inline void ucs_arch_clear_cache(void *start, void *end)
 
 static inline void *ucs_memcpy_relaxed(void *dst, const void *src, size_t len)
 {
-#if ENABLE_BUILTIN_MEMCPY
-    if (ucs_unlikely((len > ucs_global_opts.arch.builtin_memcpy_min) &&
-                     (len < ucs_global_opts.arch.builtin_memcpy_max))) {
-        asm volatile ("rep movsb"
-                      : "=D" (dst),
-                      "=S" (src),
-                      "=c" (len)
-                      : "0" (dst),
-                      "1" (src),
-                      "2" (len)
-                      : "memory");
+    /* Implementation is selected during init by CPU features, configuration
+     * and optional calibration, see ucs_cpu_init() */
+    if (ucs_unlikely(len >= ucs_x86_memcpy_dispatch_min)) {
+        ucs_x86_memcpy_dispatch[__ucs_ilog2_u64(len)](dst, src, len);
         return dst;
     }
-#endif
+
     return memcpy(dst, src, len);
 }
 
@@ -11,7 +11,9 @@
 #endif
 
 #include <ucs/arch/global_opts.h>
+#include <ucs/arch/cpu.h>
 #include <ucs/config/parser.h>
+#include <ucs/sys/string.h>
 
 ucs_config_field_t ucs_arch_global_opts_table[] = {
 #if ENABLE_BUILTIN_MEMCPY
@@ -23,22 +25,57 @@ ucs_config_field_t ucs_arch_global_opts_table[] = {
    "Maximal threshold of buffer length for using built-in memcpy.",
    ucs_offsetof(ucs_arch_global_opts_t, builtin_memcpy_max), UCS_CONFIG_TYPE_MEMUNITS},
 #endif
+
+  {"NT_MEMCPY_MIN", "inf",
+   "Minimal threshold of buffer length for using memcpy with non-temporal stores,\n"
+   "if supported by the CPU. \"auto\" means half of the last level cache size,\n"
+   "\"inf\" disables non-temporal stores.",
+   ucs_offsetof(ucs_arch_global_opts_t, nt_memcpy_min), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"MEMCPY_CALIBRATE", "n",
+   "Measure all memcpy implementations supported by the CPU during startup, and\n"
+   "select the fastest one for every range of buffer lengths. Overrides the\n"
+   "thresholds above.",
+   ucs_offsetof(ucs_arch_global_opts_t, memcpy_calibrate), UCS_CONFIG_TYPE_BOOL},
+
   {NULL}
 };
 
 
 void ucs_arch_print_memcpy_limits(ucs_arch_global_opts_t *config)
 {
-#if ENABLE_BUILTIN_MEMCPY
+    ucs_x86_memcpy_kernel_t kernel, prev_kernel;
     char min_thresh_str[32];
     char max_thresh_str[32];
+    size_t min_len, max_len;
+    unsigned i, start;
 
-    ucs_config_sprintf_memunits(min_thresh_str, sizeof(min_thresh_str),
-                                &config->builtin_memcpy_min, NULL);
-    ucs_config_sprintf_memunits(max_thresh_str, sizeof(max_thresh_str),
-                                &config->builtin_memcpy_max, NULL);
-    printf("# Using built-in memcpy() for size %s..%s\n", min_thresh_str, max_thresh_str);
-#endif
+    /* Print ranges of size classes which use the same implementation */
+    start = 0;
+    for (i = 1; i <= UCS_X86_MEMCPY_SIZE_CLASSES; ++i) {
+        prev_kernel = ucs_x86_memcpy_get_kernel(UCS_BIT(start));
+        if (i < UCS_X86_MEMCPY_SIZE_CLASSES) {
+            kernel = ucs_x86_memcpy_get_kernel(UCS_BIT(i));
+            if (kernel == prev_kernel) {
+                continue;
+            }
+            max_len = UCS_BIT(i);
+        } else {
+            max_len = UCS_MEMUNITS_INF;
+        }
+
+        min_len = (start == 0) ? 0 : UCS_BIT(start);
+        if (prev_kernel != UCS_X86_MEMCPY_LIBC) {
+            ucs_config_sprintf_memunits(min_thresh_str, sizeof(min_thresh_str),
+                                        &min_len, NULL);
+            ucs_config_sprintf_memunits(max_thresh_str, sizeof(max_thresh_str),
+                                        &max_len, NULL);
+            printf("# Using %s memcpy() for size %s..%s\n",
+                   ucs_x86_memcpy_kernel_name(prev_kernel), min_thresh_str,
+                   max_thresh_str);
+        }
+        start = i;
+    }
 }
 
 #endif
@@ -15,13 +15,17 @@ BEGIN_C_DECLS
 
 #define UCS_ARCH_GLOBAL_OPTS_INITALIZER {   \
     .builtin_memcpy_min = UCS_MEMUNITS_AUTO, \
-    .builtin_memcpy_max = UCS_MEMUNITS_AUTO  \
+    .builtin_memcpy_max = UCS_MEMUNITS_AUTO, \
+    .nt_memcpy_min      = UCS_MEMUNITS_AUTO, \
+    .memcpy_calibrate   = 0                  \
 }
 
 /* built-in memcpy config */
 typedef struct ucs_arch_global_opts {
     size_t builtin_memcpy_min;
     size_t builtin_memcpy_max;
+    size_t nt_memcpy_min;
+    int    memcpy_calibrate;
 } ucs_arch_global_opts_t;
 
 END_C_DECLS
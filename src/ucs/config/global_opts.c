@@ -41,6 +41,7 @@ ucs_global_opts_t ucs_global_opts = {
     .stats_dest            = "",
     .tuning_path           = "",
     .memtrack_dest         = "",
+    .memtrack_sample       = 0,
     .stats_trigger         = "exit",
     .profile_mode          = 0,
     .profile_file          = "",
@@ -102,6 +103,19 @@ static ucs_config_field_t ucs_global_opts_table[] = {
   "Enable output of ucs_print(). This option is intended for use by the library developers.\n",
   ucs_offsetof(ucs_global_opts_t, log_print_enable), UCS_CONFIG_TYPE_BOOL},
 
+ {"LOG_ASYNC", "n",
+  "Write log messages to the log file from a background thread. Messages are\n"
+  "formatted by the calling thread and passed to the writer through a per-thread\n"
+  "ring buffer. If the ring buffer is full, the message is dropped, and the number\n"
+  "of dropped messages is reported in the log.",
+  ucs_offsetof(ucs_global_opts_t, log_async), UCS_CONFIG_TYPE_BOOL},
+
+ {"LOG_ASYNC_BUFFER", "64k",
+  "Size of the per-thread ring buffer used when LOG_ASYNC is enabled. It is\n"
+  "rounded up to a power of 2, and to at least twice the size of a log message.",
+  ucs_offsetof(ucs_global_opts_t, log_async_buffer_size),
+  UCS_CONFIG_TYPE_MEMUNITS},
+
 #if ENABLE_DEBUG_DATA
  {"MPOOL_FIFO", "n",
   "Enable FIFO behavior for memory pool, instead of LIFO. Useful for\n"
@@ -203,8 +217,22 @@ static ucs_config_field_t ucs_global_opts_table[] = {
   "  stdout            - print to standard output.\n"
   "  stderr            - print to standard error.\n",
   ucs_offsetof(ucs_global_opts_t, memtrack_dest), UCS_CONFIG_TYPE_STRING},
+
+ {"MEMTRACK_SAMPLE", "0",
+  "Track a random sample of the allocations, with this average number of bytes\n"
+  "between sampled allocations. Every sample stands for the memory allocated\n"
+  "since the previous one, so the report shows estimated current and peak usage\n"
+  "per allocation name, at a small fraction of the cost. The value 0 tracks\n"
+  "every allocation exactly.",
+  ucs_offsetof(ucs_global_opts_t, memtrack_sample), UCS_CONFIG_TYPE_MEMUNITS},
 #endif
 
+  {"TUNING_PATH", "",
+   "Path of a transport performance profile produced by \"ucx_info -T\".\n"
+   "If not empty, the measured overhead, latency and bandwidth of the listed\n"
+   "transport devices replace the transport estimations.",
+   ucs_offsetof(ucs_global_opts_t, tuning_path), UCS_CONFIG_TYPE_STRING},
+
   {"PROFILE_MODE", "",
    "Profile collection modes. If none is specified, profiling is disabled.\n"
    " - log   - Record all timestamps.\n"
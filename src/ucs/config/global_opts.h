@@ -48,6 +48,12 @@ typedef struct {
     /* Enable ucs_print() output */
     int                        log_print_enable;
 
+    /* Write log messages from a background thread */
+    int                        log_async;
+
+    /* Size of the per-thread ring buffer for asynchronous logging */
+    size_t                     log_async_buffer_size;
+
     /* Enable FIFO behavior for memory pool, instead of LIFO. Useful for
      * debugging because object pointers are not recycled. */
     int                        mpool_fifo;
@@ -86,7 +92,7 @@ typedef struct {
     /* Trigger to dump statistics */
     char                       *stats_trigger;
 
-    /* Named pipe file path for tuning.
+    /* Path of transport performance profile, written by "ucx_info -T"
      */
     char                       *tuning_path;
 
@@ -100,6 +106,9 @@ typedef struct {
      */
     char                       *memtrack_dest;
 
+    /* Average number of bytes between sampled allocations, 0 - track all */
+    size_t                     memtrack_sample;
+
     /* Profiling mode */
     unsigned                   profile_mode;
 
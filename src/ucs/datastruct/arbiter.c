@@ -16,7 +16,20 @@
 
 void ucs_arbiter_init(ucs_arbiter_t *arbiter)
 {
-    ucs_list_head_init(&arbiter->list);
+    ucs_arbiter_prio_t prio;
+
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        ucs_list_head_init(&arbiter->list[prio]);
+    }
+
+    arbiter->weight     = 0;
+    arbiter->prio_count = 0;
+}
+
+void ucs_arbiter_set_weight(ucs_arbiter_t *arbiter, unsigned weight)
+{
+    arbiter->weight     = weight;
+    arbiter->prio_count = 0;
 }
 
 void ucs_arbiter_group_init(ucs_arbiter_group_t *group)
@@ -203,15 +216,17 @@ int ucs_arbiter_group_is_scheduled(ucs_arbiter_group_t *group)
 
 static void
 ucs_arbiter_schedule_head_if_not_scheduled(ucs_arbiter_t *arbiter,
+                                           ucs_arbiter_prio_t prio,
                                            ucs_arbiter_elem_t *head)
 {
     if (!ucs_arbiter_group_head_is_scheduled(head)) {
-        ucs_list_add_tail(&arbiter->list, &head->list);
+        ucs_list_add_tail(&arbiter->list[prio], &head->list);
     }
 }
 
 void ucs_arbiter_group_schedule_nonempty(ucs_arbiter_t *arbiter,
-                                         ucs_arbiter_group_t *group)
+                                         ucs_arbiter_group_t *group,
+                                         ucs_arbiter_prio_t prio)
 {
     ucs_arbiter_elem_t *tail = group->tail;
     ucs_arbiter_elem_t *head;
@@ -220,7 +235,8 @@ void ucs_arbiter_group_schedule_nonempty(ucs_arbiter_t *arbiter,
     head = tail->next;
 
     ucs_assert(head != NULL);
-    ucs_arbiter_schedule_head_if_not_scheduled(arbiter, head);
+    ucs_assert(prio < UCS_ARBITER_PRIO_LAST);
+    ucs_arbiter_schedule_head_if_not_scheduled(arbiter, prio, head);
     UCS_ARBITER_GROUP_ARBITER_SET(group, arbiter);
 }
 
@@ -265,22 +281,56 @@ ucs_arbiter_group_head_replace(ucs_arbiter_group_t *group,
     group->tail->next = new_group_head;
 }
 
+/* Select the list of the next group to dispatch */
+static UCS_F_ALWAYS_INLINE ucs_list_link_t *
+ucs_arbiter_next_list(ucs_arbiter_t *arbiter)
+{
+    ucs_list_link_t *high_list   = &arbiter->list[UCS_ARBITER_PRIO_HIGH];
+    ucs_list_link_t *normal_list = &arbiter->list[UCS_ARBITER_PRIO_NORMAL];
+
+    if (ucs_likely(ucs_list_is_empty(high_list))) {
+        arbiter->prio_count = 0;
+        return normal_list;
+    }
+
+    if ((arbiter->weight == 0) || ucs_list_is_empty(normal_list)) {
+        return high_list;
+    }
+
+    if (arbiter->prio_count < arbiter->weight) {
+        ++arbiter->prio_count;
+        return high_list;
+    }
+
+    /* Let a normal priority group through */
+    arbiter->prio_count = 0;
+    return normal_list;
+}
+
 void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
                                    ucs_arbiter_callback_t cb, void *cb_arg)
 {
+    ucs_list_link_t resched_list[UCS_ARBITER_PRIO_LAST];
     ucs_arbiter_elem_t *group_head;
     ucs_arbiter_cb_result_t result;
     unsigned group_dispatch_count;
     ucs_arbiter_group_t *group;
-    UCS_LIST_HEAD(resched_list);
+    ucs_list_link_t *group_list;
     ucs_arbiter_elem_t dummy;
+    ucs_arbiter_prio_t prio;
+
+    ucs_assert(!ucs_arbiter_is_empty(arbiter));
 
-    ucs_assert(!ucs_list_is_empty(&arbiter->list));
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        ucs_list_head_init(&resched_list[prio]);
+    }
 
     ucs_arbiter_group_head_reset(&dummy);
 
     do {
-        group_head = ucs_list_extract_head(&arbiter->list, ucs_arbiter_elem_t,
+        /* the group keeps its priority class when it's put back */
+        group_list = ucs_arbiter_next_list(arbiter);
+        group_head = ucs_list_extract_head(group_list, ucs_arbiter_elem_t,
                                            list);
         ucs_assert(group_head != NULL);
 
@@ -352,14 +402,16 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
 
                     if (result == UCS_ARBITER_CB_RESULT_NEXT_GROUP) {
                         /* add to arbiter tail */
-                        ucs_list_add_tail(&arbiter->list, &group_head->list);
+                        ucs_list_add_tail(group_list, &group_head->list);
                     } else if (result == UCS_ARBITER_CB_RESULT_RESCHED_GROUP) {
                         /* add to resched list */
-                        ucs_list_add_tail(&resched_list, &group_head->list);
+                        ucs_list_add_tail(&resched_list[group_list -
+                                                        arbiter->list],
+                                          &group_head->list);
                     } else if (result == UCS_ARBITER_CB_RESULT_STOP) {
                         /* exit the outmost loop and make sure that next dispatch()
                          * will continue from the current group */
-                        ucs_list_add_head(&arbiter->list, &group_head->list);
+                        ucs_list_add_head(group_list, &group_head->list);
                         goto out;
                     } else {
                         ucs_bug("unexpected return value from arbiter callback");
@@ -390,57 +442,63 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
                 break;
             } else if (group_dispatch_count >= per_group) {
                 /* add to arbiter tail and continue to next group */
-                ucs_list_add_tail(&arbiter->list, &group_head->list);
+                ucs_list_add_tail(group_list, &group_head->list);
                 break;
             }
 
             /* continue with new group head */
             ucs_arbiter_group_head_reset(group_head);
         }
-    } while (!ucs_list_is_empty(&arbiter->list));
+    } while (!ucs_arbiter_is_empty(arbiter));
 
 out:
-    ucs_list_splice_tail(&arbiter->list, &resched_list);
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        ucs_list_splice_tail(&arbiter->list[prio], &resched_list[prio]);
+    }
 }
 
 void ucs_arbiter_dump(ucs_arbiter_t *arbiter, FILE *stream)
 {
     static const int max_groups = 100;
     ucs_arbiter_elem_t *group_head, *elem;
+    ucs_arbiter_prio_t prio;
     int count;
 
     fprintf(stream, "-------\n");
-    if (ucs_list_is_empty(&arbiter->list)) {
+    if (ucs_arbiter_is_empty(arbiter)) {
         fprintf(stream, "(empty)\n");
         goto out;
     }
 
     count = 0;
-    ucs_list_for_each(group_head, &arbiter->list, list) {
-        elem = group_head;
-        if (ucs_list_head(&arbiter->list, ucs_arbiter_elem_t, list) == group_head) {
-            fprintf(stream, "=> ");
-        } else {
-            fprintf(stream, " * ");
-        }
-        do {
-            fprintf(stream, "[%p", elem);
-            if (elem == group_head) {
-                fprintf(stream, " prev_g:%p", elem->list.prev);
-                fprintf(stream, " next_g:%p", elem->list.next);
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        ucs_list_for_each(group_head, &arbiter->list[prio], list) {
+            elem = group_head;
+            if (ucs_list_head(&arbiter->list[prio], ucs_arbiter_elem_t,
+                              list) == group_head) {
+                fprintf(stream, "%d=> ", prio);
+            } else {
+                fprintf(stream, "%d * ", prio);
             }
-            fprintf(stream, " next_e:%p grp:%p]", elem->next, elem->group);
-            if (elem->next != group_head) {
-                fprintf(stream, "->");
+            do {
+                fprintf(stream, "[%p", elem);
+                if (elem == group_head) {
+                    fprintf(stream, " prev_g:%p", elem->list.prev);
+                    fprintf(stream, " next_g:%p", elem->list.next);
+                }
+                fprintf(stream, " next_e:%p grp:%p]", elem->next, elem->group);
+                if (elem->next != group_head) {
+                    fprintf(stream, "->");
+                }
+                elem = elem->next;
+            } while (elem != group_head);
+            fprintf(stream, "\n");
+            ++count;
+            if (count > max_groups) {
+                fprintf(stream, "more than %d groups - not printing any more\n",
+                        max_groups);
+                goto out;
             }
-            elem = elem->next;
-        } while (elem != group_head);
-        fprintf(stream, "\n");
-        ++count;
-        if (count > max_groups) {
-            fprintf(stream, "more than %d groups - not printing any more\n",
-                    max_groups);
-            break;
         }
     }
 
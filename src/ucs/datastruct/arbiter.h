@@ -26,6 +26,13 @@
  * is rescheduled it's moved to the tail of the list. At any point a group head
  * can be removed from the "middle" of the list.
  *
+ * A group is scheduled in a priority class (see @ref ucs_arbiter_prio_t), and
+ * the arbiter keeps a separate list for each class. The group stays in its
+ * class until it's descheduled or becomes empty. Groups of the high priority
+ * class are dispatched before normal priority groups, either strictly or, if a
+ * weight is set by @ref ucs_arbiter_set_weight, letting one normal priority
+ * group through after every "weight" high priority groups.
+ *
  * The groups and elements are arranged like this:
  *  - every arbitrated element points to the group (head).
  *  - first element in the group points to previous and next group (list)
@@ -82,6 +89,17 @@ typedef struct ucs_arbiter_group  ucs_arbiter_group_t;
 typedef struct ucs_arbiter_elem   ucs_arbiter_elem_t;
 
 
+/**
+ * Priority classes of arbiter groups.
+ */
+typedef enum {
+    UCS_ARBITER_PRIO_HIGH,    /* Latency-sensitive work, such as small control
+                                 messages */
+    UCS_ARBITER_PRIO_NORMAL,  /* Default class */
+    UCS_ARBITER_PRIO_LAST
+} ucs_arbiter_prio_t;
+
+
 /**
  * Arbitration callback result codes.
  */
@@ -146,7 +164,12 @@ typedef ucs_arbiter_cb_result_t (*ucs_arbiter_callback_t)(ucs_arbiter_t *arbiter
  * Top-level arbiter.
  */
 struct ucs_arbiter {
-    ucs_list_link_t         list;
+    ucs_list_link_t         list[UCS_ARBITER_PRIO_LAST]; /* Scheduled groups of
+                                                           each priority class */
+    unsigned                weight;     /* High priority groups to dispatch per
+                                           normal priority group, 0 - strict */
+    unsigned                prio_count; /* High priority groups dispatched since
+                                           the last normal priority group */
 };
 
 
@@ -180,6 +203,18 @@ void ucs_arbiter_init(ucs_arbiter_t *arbiter);
 void ucs_arbiter_cleanup(ucs_arbiter_t *arbiter);
 
 
+/**
+ * Set how high priority groups are preferred over normal priority groups.
+ *
+ * @param [in]  arbiter  Arbiter object.
+ * @param [in]  weight   Number of high priority groups to dispatch before
+ *                       letting one normal priority group through, when both
+ *                       classes have scheduled groups. 0 (the default) means
+ *                       strict priority.
+ */
+void ucs_arbiter_set_weight(ucs_arbiter_t *arbiter, unsigned weight);
+
+
 /**
  * Initialize a group object.
  *
@@ -244,7 +279,8 @@ void ucs_arbiter_dump(ucs_arbiter_t *arbiter, FILE *stream);
 
 /* Internal function */
 void ucs_arbiter_group_schedule_nonempty(ucs_arbiter_t *arbiter,
-                                         ucs_arbiter_group_t *group);
+                                         ucs_arbiter_group_t *group,
+                                         ucs_arbiter_prio_t prio);
 
 
 /* Internal function */
@@ -264,7 +300,8 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
  */
 static inline int ucs_arbiter_is_empty(ucs_arbiter_t *arbiter)
 {
-    return ucs_list_is_empty(&arbiter->list);
+    return ucs_list_is_empty(&arbiter->list[UCS_ARBITER_PRIO_NORMAL]) &&
+           ucs_list_is_empty(&arbiter->list[UCS_ARBITER_PRIO_HIGH]);
 }
 
 
@@ -298,7 +335,27 @@ static inline void ucs_arbiter_group_schedule(ucs_arbiter_t *arbiter,
                                               ucs_arbiter_group_t *group)
 {
     if (ucs_unlikely(!ucs_arbiter_group_is_empty(group))) {
-        ucs_arbiter_group_schedule_nonempty(arbiter, group);
+        ucs_arbiter_group_schedule_nonempty(arbiter, group,
+                                            UCS_ARBITER_PRIO_NORMAL);
+    }
+}
+
+
+/**
+ * Schedule a group for arbitration in a given priority class. If the group is
+ * already scheduled, the operation will have no effect, and the group keeps its
+ * current priority class.
+ *
+ * @param [in]  arbiter  Arbiter object to schedule the group on.
+ * @param [in]  group    Group to schedule.
+ * @param [in]  prio     Priority class of the group.
+ */
+static inline void ucs_arbiter_group_schedule_prio(ucs_arbiter_t *arbiter,
+                                                   ucs_arbiter_group_t *group,
+                                                   ucs_arbiter_prio_t prio)
+{
+    if (ucs_unlikely(!ucs_arbiter_group_is_empty(group))) {
+        ucs_arbiter_group_schedule_nonempty(arbiter, group, prio);
     }
 }
 
@@ -18,6 +18,22 @@
 #include <ucs/sys/sys.h>
 
 
+/* Process-wide state of memory pool thread-local caches */
+static struct {
+    pthread_mutex_t lock;        /* Protects the fields below, and the thread
+                                    cache tables against concurrent pool
+                                    cleanup and thread exit */
+    int             key_created; /* Whether ucs_mpool_tcache_key is valid */
+    uint64_t        used;        /* Bitmap of used cache table indices */
+} ucs_mpool_tcache_global = {
+    .lock        = PTHREAD_MUTEX_INITIALIZER,
+    .key_created = 0,
+    .used        = 0
+};
+
+pthread_key_t ucs_mpool_tcache_key;
+
+
 static inline unsigned ucs_mpool_elem_total_size(ucs_mpool_data_t *data)
 {
     return ucs_align_up_pow2(data->elem_size, data->alignment);
@@ -67,6 +83,7 @@ ucs_status_t ucs_mpool_init(ucs_mpool_t *mp, size_t priv_size,
     }
 
     mp->freelist              = NULL;
+    mp->tcache                = NULL;
     mp->data->elem_size       = sizeof(ucs_mpool_elem_t) + elem_size;
     mp->data->alignment       = alignment;
     mp->data->align_offset    = sizeof(ucs_mpool_elem_t) + align_offset;
@@ -94,6 +111,198 @@ err_strdup:
     return UCS_ERR_NO_MEMORY;
 }
 
+/* Move up to 'count' elements from a thread cache to the shared freelist.
+ * Must be called with the pool lock held. */
+static void ucs_mpool_tcache_flush(ucs_mpool_t *mp, ucs_mpool_thread_cache_t *tc,
+                                   unsigned count)
+{
+    ucs_mpool_elem_t *elem;
+
+    while ((count-- > 0) && (tc->freelist != NULL)) {
+        elem = tc->freelist;
+        VALGRIND_MAKE_MEM_DEFINED(elem, sizeof *elem);
+        tc->freelist = elem->next;
+        --tc->count;
+        ucs_mpool_add_to_freelist(mp, elem,
+                                  ENABLE_DEBUG_DATA && ucs_global_opts.mpool_fifo);
+        VALGRIND_MAKE_MEM_NOACCESS(elem, sizeof *elem);
+    }
+}
+
+static void ucs_mpool_tcache_thread_cleanup(void *arg)
+{
+    ucs_mpool_thread_caches_t *table = arg;
+    ucs_mpool_thread_cache_t *tc;
+    ucs_mpool_t *mp;
+    unsigned i;
+
+    pthread_mutex_lock(&ucs_mpool_tcache_global.lock);
+    for (i = 0; i < UCS_MPOOL_TCACHE_MAX; ++i) {
+        tc = table->caches[i];
+        if (tc == NULL) {
+            continue;
+        }
+
+        mp = tc->mp;
+        ucs_spin_lock(&mp->tcache->lock);
+        ucs_mpool_tcache_flush(mp, tc, UINT_MAX);
+        ucs_list_del(&tc->list);
+        ucs_spin_unlock(&mp->tcache->lock);
+        ucs_free(tc);
+    }
+    pthread_mutex_unlock(&ucs_mpool_tcache_global.lock);
+
+    ucs_free(table);
+}
+
+static ucs_mpool_thread_cache_t *ucs_mpool_tcache_get_thread(ucs_mpool_t *mp)
+{
+    ucs_mpool_tcache_t *tcache = mp->tcache;
+    ucs_mpool_thread_caches_t *table;
+    ucs_mpool_thread_cache_t *tc;
+    int ret;
+
+    table = pthread_getspecific(ucs_mpool_tcache_key);
+    if (table == NULL) {
+        table = ucs_calloc(1, sizeof(*table), "mpool_thread_caches");
+        if (table == NULL) {
+            return NULL;
+        }
+
+        ret = pthread_setspecific(ucs_mpool_tcache_key, table);
+        if (ret != 0) {
+            ucs_free(table);
+            return NULL;
+        }
+    }
+
+    tc = table->caches[tcache->index];
+    if (tc != NULL) {
+        return tc;
+    }
+
+    tc = ucs_malloc(sizeof(*tc), "mpool_thread_cache");
+    if (tc == NULL) {
+        return NULL;
+    }
+
+    tc->freelist = NULL;
+    tc->count    = 0;
+    tc->mp       = mp;
+    tc->slot_p   = &table->caches[tcache->index];
+    *tc->slot_p  = tc;
+
+    ucs_spin_lock(&tcache->lock);
+    ucs_list_add_tail(&tcache->caches, &tc->list);
+    ucs_spin_unlock(&tcache->lock);
+    return tc;
+}
+
+/* Must be called with the pool lock held */
+static ucs_mpool_elem_t *ucs_mpool_tcache_shared_get(ucs_mpool_t *mp, int grow)
+{
+    ucs_mpool_elem_t *elem;
+
+    if ((mp->freelist == NULL) && grow) {
+        ucs_mpool_grow(mp, mp->data->elems_per_chunk);
+    }
+
+    elem = mp->freelist;
+    if (elem != NULL) {
+        VALGRIND_MAKE_MEM_DEFINED(elem, sizeof *elem);
+        mp->freelist = elem->next;
+    }
+
+    return elem;
+}
+
+ucs_status_t ucs_mpool_tcache_enable(ucs_mpool_t *mp, unsigned max_elems)
+{
+    ucs_mpool_tcache_t *tcache;
+    ucs_status_t status;
+    int ret;
+
+    ucs_assert(mp->tcache == NULL);
+    ucs_assert(mp->data->chunks == NULL);
+
+    tcache = ucs_malloc(sizeof(*tcache), "mpool_tcache");
+    if (tcache == NULL) {
+        ucs_error("failed to allocate thread cache for mpool %s",
+                  ucs_mpool_name(mp));
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    status = ucs_spinlock_init(&tcache->lock, 0);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    pthread_mutex_lock(&ucs_mpool_tcache_global.lock);
+
+    /* All pools share one key, created on first use */
+    if (!ucs_mpool_tcache_global.key_created) {
+        ret = pthread_key_create(&ucs_mpool_tcache_key,
+                                 ucs_mpool_tcache_thread_cleanup);
+        if (ret != 0) {
+            ucs_debug("failed to create mpool thread cache key: %s",
+                      strerror(ret));
+            status = UCS_ERR_NO_RESOURCE;
+            goto err_unlock;
+        }
+
+        ucs_mpool_tcache_global.key_created = 1;
+    }
+
+    if (ucs_mpool_tcache_global.used == UINT64_MAX) {
+        ucs_debug("mpool %s: too many pools with thread caches (max: %d)",
+                  ucs_mpool_name(mp), UCS_MPOOL_TCACHE_MAX);
+        status = UCS_ERR_EXCEEDS_LIMIT;
+        goto err_unlock;
+    }
+
+    tcache->index = ucs_ffs64(~ucs_mpool_tcache_global.used);
+    ucs_mpool_tcache_global.used |= UCS_BIT(tcache->index);
+    pthread_mutex_unlock(&ucs_mpool_tcache_global.lock);
+
+    tcache->max_elems = max_elems;
+    tcache->batch     = ucs_max(max_elems / 2, 1);
+    ucs_list_head_init(&tcache->caches);
+    mp->tcache        = tcache;
+
+    ucs_debug("mpool %s: enabled thread caches of %u elements",
+              ucs_mpool_name(mp), max_elems);
+    return UCS_OK;
+
+err_unlock:
+    pthread_mutex_unlock(&ucs_mpool_tcache_global.lock);
+    ucs_spinlock_destroy(&tcache->lock);
+err_free:
+    ucs_free(tcache);
+    return status;
+}
+
+static void ucs_mpool_tcache_cleanup(ucs_mpool_t *mp)
+{
+    ucs_mpool_tcache_t *tcache = mp->tcache;
+    ucs_mpool_thread_cache_t *tc, *tmp;
+
+    /* Release the caches of all threads, and detach them from the thread
+     * tables, so the table index can be reused by another pool */
+    pthread_mutex_lock(&ucs_mpool_tcache_global.lock);
+    ucs_list_for_each_safe(tc, tmp, &tcache->caches, list) {
+        ucs_mpool_tcache_flush(mp, tc, UINT_MAX);
+        *tc->slot_p = NULL;
+        ucs_list_del(&tc->list);
+        ucs_free(tc);
+    }
+    ucs_mpool_tcache_global.used &= ~UCS_BIT(tcache->index);
+    pthread_mutex_unlock(&ucs_mpool_tcache_global.lock);
+
+    ucs_spinlock_destroy(&tcache->lock);
+    ucs_free(tcache);
+    mp->tcache = NULL;
+}
+
 void ucs_mpool_cleanup(ucs_mpool_t *mp, int leak_check)
 {
     ucs_mpool_chunk_t *chunk, *next_chunk;
@@ -101,6 +310,10 @@ void ucs_mpool_cleanup(ucs_mpool_t *mp, int leak_check)
     ucs_mpool_data_t *data = mp->data;
     void *obj;
 
+    if (mp->tcache != NULL) {
+        ucs_mpool_tcache_cleanup(mp);
+    }
+
     /* Cleanup all elements in the freelist and set their header to NULL to mark
      * them as released for the leak check.
      */
@@ -157,7 +370,22 @@ const char *ucs_mpool_name(ucs_mpool_t *mp)
 
 int ucs_mpool_is_empty(ucs_mpool_t *mp)
 {
-    return (mp->freelist == NULL) && (mp->data->quota == 0);
+    ucs_mpool_thread_cache_t *tc;
+    int is_empty;
+
+    if (mp->tcache == NULL) {
+        return (mp->freelist == NULL) && (mp->data->quota == 0);
+    }
+
+    tc = ucs_mpool_tcache_lookup(mp);
+    if ((tc != NULL) && (tc->freelist != NULL)) {
+        return 0;
+    }
+
+    ucs_spin_lock(&mp->tcache->lock);
+    is_empty = (mp->freelist == NULL) && (mp->data->quota == 0);
+    ucs_spin_unlock(&mp->tcache->lock);
+    return is_empty;
 }
 
 void *ucs_mpool_get(ucs_mpool_t *mp)
@@ -170,6 +398,16 @@ void ucs_mpool_put(void *obj)
     ucs_mpool_put_inline(obj);
 }
 
+void *ucs_mpool_tcache_get(ucs_mpool_t *mp)
+{
+    return ucs_mpool_tcache_get_inline(mp);
+}
+
+void ucs_mpool_tcache_put(void *obj)
+{
+    ucs_mpool_tcache_put_inline(obj);
+}
+
 void ucs_mpool_grow(ucs_mpool_t *mp, unsigned num_elems)
 {
     ucs_mpool_data_t *data = mp->data;
@@ -242,6 +480,70 @@ void *ucs_mpool_get_grow(ucs_mpool_t *mp)
     return ucs_mpool_get(mp);
 }
 
+void *ucs_mpool_tcache_get_refill(ucs_mpool_t *mp)
+{
+    ucs_mpool_tcache_t *tcache = mp->tcache;
+    ucs_mpool_thread_cache_t *tc;
+    ucs_mpool_elem_t *elem, *cached_elem;
+    unsigned i;
+    void *obj;
+
+    tc = ucs_mpool_tcache_get_thread(mp);
+
+    ucs_spin_lock(&tcache->lock);
+    elem = ucs_mpool_tcache_shared_get(mp, 1);
+    if ((elem != NULL) && (tc != NULL)) {
+        /* Prefetch a batch of elements to the thread cache, but don't allocate
+         * a new chunk just to fill it */
+        for (i = 1; i < tcache->batch; ++i) {
+            cached_elem = ucs_mpool_tcache_shared_get(mp, 0);
+            if (cached_elem == NULL) {
+                break;
+            }
+
+            cached_elem->next = tc->freelist;
+            tc->freelist      = cached_elem;
+            ++tc->count;
+            VALGRIND_MAKE_MEM_NOACCESS(cached_elem, sizeof *cached_elem);
+        }
+    }
+    ucs_spin_unlock(&tcache->lock);
+
+    if (elem == NULL) {
+        return NULL;
+    }
+
+    elem->mpool = mp;
+    VALGRIND_MAKE_MEM_NOACCESS(elem, sizeof *elem);
+
+    obj = elem + 1;
+    VALGRIND_MEMPOOL_ALLOC(mp, obj, mp->data->elem_size - sizeof(ucs_mpool_elem_t));
+    return obj;
+}
+
+void ucs_mpool_tcache_put_drain(ucs_mpool_t *mp, ucs_mpool_elem_t *elem)
+{
+    ucs_mpool_tcache_t *tcache = mp->tcache;
+    ucs_mpool_thread_cache_t *tc;
+
+    tc = ucs_mpool_tcache_get_thread(mp);
+    if ((tc != NULL) && (tc->count < tcache->max_elems)) {
+        /* First put from this thread, the cache was just created */
+        elem->next   = tc->freelist;
+        tc->freelist = elem;
+        ++tc->count;
+        return;
+    }
+
+    ucs_spin_lock(&tcache->lock);
+    ucs_mpool_add_to_freelist(mp, elem,
+                              ENABLE_DEBUG_DATA && ucs_global_opts.mpool_fifo);
+    if (tc != NULL) {
+        ucs_mpool_tcache_flush(mp, tc, tcache->batch);
+    }
+    ucs_spin_unlock(&tcache->lock);
+}
+
 ucs_status_t ucs_mpool_chunk_malloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p)
 {
     *chunk_p = ucs_malloc(*size_p, ucs_mpool_name(mp));
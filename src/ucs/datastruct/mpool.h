@@ -9,6 +9,8 @@
 
 #include <stddef.h>
 #include <ucs/type/status.h>
+#include <ucs/type/spinlock.h>
+#include <ucs/datastruct/list.h>
 #include <ucs/sys/compiler_def.h>
 
 BEGIN_C_DECLS
@@ -20,6 +22,8 @@ typedef union  ucs_mpool_elem    ucs_mpool_elem_t;
 typedef struct ucs_mpool         ucs_mpool_t;
 typedef struct ucs_mpool_data    ucs_mpool_data_t;
 typedef struct ucs_mpool_ops     ucs_mpool_ops_t;
+typedef struct ucs_mpool_tcache  ucs_mpool_tcache_t;
+typedef struct ucs_mpool_thread_cache ucs_mpool_thread_cache_t;
 
 
 /**
@@ -64,6 +68,7 @@ struct ucs_mpool_chunk {
 struct ucs_mpool {
     ucs_mpool_elem_t       *freelist;  /* List of available elements */
     ucs_mpool_data_t       *data;      /* Slow-path data */
+    ucs_mpool_tcache_t     *tcache;    /* Thread-local caches, NULL if disabled */
 };
 
 
@@ -83,6 +88,51 @@ struct ucs_mpool_data {
 };
 
 
+/**
+ * Maximal number of memory pools which can have thread-local caches enabled
+ * at the same time.
+ */
+#define UCS_MPOOL_TCACHE_MAX       64
+
+
+/**
+ * Thread-local caches of a memory pool. Every thread which gets or puts
+ * objects keeps a bounded private list of free elements, and moves elements
+ * from/to the shared freelist in batches, under the pool lock.
+ */
+struct ucs_mpool_tcache {
+    unsigned               index;      /* Index in the per-thread cache tables */
+    unsigned               max_elems;  /* Maximal number of cached elements */
+    unsigned               batch;      /* How many elements to refill/drain */
+    ucs_spinlock_t         lock;       /* Protects the shared freelist */
+    ucs_list_link_t        caches;     /* List of all thread caches */
+};
+
+
+/**
+ * Per-thread cache of free elements.
+ */
+struct ucs_mpool_thread_cache {
+    ucs_mpool_elem_t       *freelist;  /* List of cached elements */
+    unsigned               count;      /* Number of cached elements */
+    ucs_mpool_t            *mp;        /* Memory pool which owns the cache */
+    ucs_mpool_thread_cache_t **slot_p; /* Entry in the thread's cache table */
+    ucs_list_link_t        list;       /* Entry in ucs_mpool_tcache_t::caches */
+};
+
+
+/**
+ * Thread-local caches of the current thread, indexed by
+ * ucs_mpool_tcache_t::index. All memory pools share one thread-specific key.
+ */
+typedef struct ucs_mpool_thread_caches {
+    ucs_mpool_thread_cache_t *caches[UCS_MPOOL_TCACHE_MAX];
+} ucs_mpool_thread_caches_t;
+
+
+extern pthread_key_t ucs_mpool_tcache_key;
+
+
 /**
  * Defines callbacks for memory pool operations.
  */
@@ -152,6 +202,27 @@ ucs_status_t ucs_mpool_init(ucs_mpool_t *mp, size_t priv_size,
                             ucs_mpool_ops_t *ops, const char *name);
 
 
+/**
+ * Enable thread-local caches for a memory pool, which make it safe to get and
+ * put objects with @ref ucs_mpool_tcache_get and @ref ucs_mpool_tcache_put
+ * from multiple threads concurrently, without an external lock.
+ * Objects are taken from a thread-local list when possible, and moved from/to
+ * the shared freelist in batches of half the cache size.
+ * Must be called before any object is allocated from the pool, and the pool
+ * must not be cleaned up while other threads are still using it. Once enabled,
+ * @ref ucs_mpool_get and @ref ucs_mpool_put must not be used on the pool.
+ * At most @ref UCS_MPOOL_TCACHE_MAX pools can have thread-local caches at the
+ * same time.
+ *
+ * @param mp               Memory pool structure.
+ * @param max_elems        Maximal number of free objects cached per thread.
+ *
+ * @return UCS status code, UCS_ERR_EXCEEDS_LIMIT if too many pools already have
+ *         thread-local caches.
+ */
+ucs_status_t ucs_mpool_tcache_enable(ucs_mpool_t *mp, unsigned max_elems);
+
+
 /**
  * Cleanup a memory pool and release all its memory.
  *
@@ -206,6 +277,27 @@ void *ucs_mpool_get(ucs_mpool_t *mp);
 void ucs_mpool_put(void *obj);
 
 
+/**
+ * Get an element from a memory pool with thread-local caches. If the caches
+ * are not enabled for the pool, this is the same as @ref ucs_mpool_get, and
+ * requires the same external serialization.
+ *
+ * @param mp               Memory pool structure.
+ *
+ * @return New allocated object, or NULL if cannot allocate.
+ */
+void *ucs_mpool_tcache_get(ucs_mpool_t *mp);
+
+
+/**
+ * Return an object to a memory pool with thread-local caches. If the caches
+ * are not enabled for the pool, this is the same as @ref ucs_mpool_put.
+ *
+ * @param obj              Object to return.
+ */
+void ucs_mpool_tcache_put(void *obj);
+
+
 /**
  * Grow the memory pool by a specified amount of elements.
  *
@@ -226,6 +318,29 @@ void ucs_mpool_grow(ucs_mpool_t *mp, unsigned num_elems);
 void *ucs_mpool_get_grow(ucs_mpool_t *mp);
 
 
+/**
+ * Refill the thread-local cache of the current thread from the shared
+ * freelist, and allocate an object from it.
+ * Used internally by ucs_mpool_tcache_get().
+ *
+ * @param mp               Memory pool structure.
+ *
+ * @return New allocated object, or NULL if cannot allocate.
+ */
+void *ucs_mpool_tcache_get_refill(ucs_mpool_t *mp);
+
+
+/**
+ * Return an element to the shared freelist, together with a batch of elements
+ * from the thread-local cache of the current thread.
+ * Used internally by ucs_mpool_tcache_put().
+ *
+ * @param mp               Memory pool structure.
+ * @param elem             Element to return.
+ */
+void ucs_mpool_tcache_put_drain(ucs_mpool_t *mp, ucs_mpool_elem_t *elem);
+
+
 /**
  * heap-based chunk allocator.
  */
@@ -14,6 +14,16 @@
 #include <ucs/sys/sys.h>
 
 
+static UCS_F_ALWAYS_INLINE ucs_mpool_thread_cache_t *
+ucs_mpool_tcache_lookup(ucs_mpool_t *mp)
+{
+    ucs_mpool_thread_caches_t *table;
+
+    table = (ucs_mpool_thread_caches_t*)pthread_getspecific(
+            ucs_mpool_tcache_key);
+    return (table == NULL) ? NULL : table->caches[mp->tcache->index];
+}
+
 static inline void *ucs_mpool_get_inline(ucs_mpool_t *mp)
 {
     ucs_mpool_elem_t *elem;
@@ -59,7 +69,12 @@ static inline void ucs_mpool_add_to_freelist(ucs_mpool_t *mp, ucs_mpool_elem_t *
 
 static inline ucs_mpool_elem_t *ucs_mpool_obj_to_elem(void *obj)
 {
-    ucs_mpool_elem_t *elem = (ucs_mpool_elem_t*)obj - 1;
+    /* Use integer arithmetic, since the compiler may see that 'obj' points to
+     * an object which was not allocated from a memory pool, on a code path
+     * which is never taken for such objects, and report the header access as
+     * out of bounds */
+    ucs_mpool_elem_t *elem = (ucs_mpool_elem_t*)((uintptr_t)obj -
+                                                 sizeof(ucs_mpool_elem_t));
     VALGRIND_MAKE_MEM_DEFINED(elem, sizeof *elem);
     return elem;
 }
@@ -82,4 +97,57 @@ static inline void ucs_mpool_put_inline(void *obj)
     VALGRIND_MEMPOOL_FREE(mp, obj);
 }
 
+static inline void *ucs_mpool_tcache_get_inline(ucs_mpool_t *mp)
+{
+    ucs_mpool_thread_cache_t *tc;
+    ucs_mpool_elem_t *elem;
+    void *obj;
+
+    if (ucs_unlikely(mp->tcache == NULL)) {
+        return ucs_mpool_get_inline(mp);
+    }
+
+    tc = ucs_mpool_tcache_lookup(mp);
+    if (ucs_unlikely((tc == NULL) || (tc->freelist == NULL))) {
+        return ucs_mpool_tcache_get_refill(mp);
+    }
+
+    /* Disconnect an element from the thread cache */
+    elem = tc->freelist;
+    VALGRIND_MAKE_MEM_DEFINED(elem, sizeof *elem);
+    tc->freelist = elem->next;
+    --tc->count;
+    elem->mpool = mp;
+    VALGRIND_MAKE_MEM_NOACCESS(elem, sizeof *elem);
+
+    obj = elem + 1;
+    VALGRIND_MEMPOOL_ALLOC(mp, obj, mp->data->elem_size - sizeof(ucs_mpool_elem_t));
+    return obj;
+}
+
+static inline void ucs_mpool_tcache_put_inline(void *obj)
+{
+    ucs_mpool_thread_cache_t *tc;
+    ucs_mpool_elem_t *elem;
+    ucs_mpool_t *mp;
+
+    elem = ucs_mpool_obj_to_elem(obj);
+    mp   = elem->mpool;
+    if (ucs_unlikely(mp->tcache == NULL)) {
+        ucs_mpool_put_inline(obj);
+        return;
+    }
+
+    tc = ucs_mpool_tcache_lookup(mp);
+    if (ucs_unlikely((tc == NULL) || (tc->count >= mp->tcache->max_elems))) {
+        ucs_mpool_tcache_put_drain(mp, elem);
+    } else {
+        elem->next   = tc->freelist;
+        tc->freelist = elem;
+        ++tc->count;
+    }
+    VALGRIND_MAKE_MEM_NOACCESS(elem, sizeof *elem);
+    VALGRIND_MEMPOOL_FREE(mp, obj);
+}
+
 #endif
@@ -0,0 +1,46 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2020.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ptr_map.inl"
+
+#include <ucs/sys/math.h>
+#include <string.h>
+
+
+#define UCS_PTR_MAP_INITIAL_CAPACITY    64
+
+
+ucs_status_t ucs_ptr_map_grow(ucs_ptr_map_t *map)
+{
+    ucs_ptr_map_slot_t *slots;
+    uint32_t capacity;
+
+    if (map->capacity == UCS_PTR_MAP_SLOT_NONE) {
+        /* the last index is reserved for the free list end mark */
+        ucs_error("ptr map %p: reached the maximal number of slots", map);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    capacity = (map->capacity == 0) ? UCS_PTR_MAP_INITIAL_CAPACITY :
+               ucs_min((uint64_t)map->capacity * 2, UCS_PTR_MAP_SLOT_NONE);
+    slots    = ucs_realloc(map->slots, sizeof(*slots) * capacity,
+                           "ptr_map_slots");
+    if (slots == NULL) {
+        ucs_error("ptr map %p: failed to grow to %u slots", map, capacity);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    /* new slots start from generation 0 */
+    memset(slots + map->capacity, 0,
+           sizeof(*slots) * (capacity - map->capacity));
+    map->slots    = slots;
+    map->capacity = capacity;
+    return UCS_OK;
+}
@@ -7,8 +7,6 @@
 #ifndef UCS_PTR_MAP_H_
 #define UCS_PTR_MAP_H_
 
-#include "khash.h"
-
 #include <ucs/sys/compiler.h>
 #include <ucs/type/status.h>
 
@@ -29,19 +27,45 @@ BEGIN_C_DECLS
 typedef uintptr_t ucs_ptr_map_key_t;
 
 
-KHASH_TYPE(ucs_ptr_map_impl, ucs_ptr_map_key_t, void*);
-typedef khash_t(ucs_ptr_map_impl) ucs_ptr_hash_t;
+/**
+ * Slot of the indirect pointers table.
+ */
+typedef struct ucs_ptr_map_slot {
+    ucs_ptr_map_key_t    key;       /**< Key of the stored pointer. If the slot
+                                         is free, the indirect flag is cleared
+                                         and only the generation is kept. */
+    union {
+        void             *ptr;      /**< Stored pointer */
+        uint32_t         next_free; /**< Next free slot index */
+    };
+} ucs_ptr_map_slot_t;
 
 
 /**
  * Associative container key -> object pointer.
+ *
+ * Indirect keys encode an index in a dense slot table and the generation of
+ * the slot, so lookup is a bounds check and a compare, and a key of a removed
+ * object is never confused with a key of an object which reused its slot.
  */
 typedef struct ucs_ptr_map {
-    uint64_t        next_id; /**< Generator of unique keys per map. */
-    ucs_ptr_hash_t  hash;    /**< Hash table to store indirect key to pointer
-                                  associations. */
+    ucs_ptr_map_slot_t   *slots;     /**< Slot table */
+    uint32_t             capacity;   /**< Number of allocated slots */
+    uint32_t             length;     /**< Number of slots ever used */
+    uint32_t             free_head;  /**< Head of the free slots list */
+    uint32_t             count;      /**< Number of stored indirect pointers */
 } ucs_ptr_map_t;
 
+
+/**
+ * Grow the slot table of a pointer map.
+ *
+ * @param [in]  map     Map whose slot table is full.
+ * @return      UCS_OK on success otherwise error code as defined by
+ *              @ref ucs_status_t.
+ */
+ucs_status_t ucs_ptr_map_grow(ucs_ptr_map_t *map);
+
 END_C_DECLS
 
 #endif
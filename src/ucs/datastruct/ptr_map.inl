@@ -10,6 +10,7 @@
 #include "ptr_map.h"
 
 #include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
 
 BEGIN_C_DECLS
 
@@ -20,8 +21,19 @@ BEGIN_C_DECLS
 #define UCS_PTR_MAP_KEY_INDIRECT_FLAG   UCS_BIT(0)
 
 
-KHASH_IMPL(ucs_ptr_map_impl, ucs_ptr_map_key_t, void*, 1,
-           kh_int64_hash_func, kh_int64_hash_equal);
+/**
+ * Indirect key layout: the slot index in bits [1..32], and the slot generation
+ * in the remaining upper bits.
+ */
+#define UCS_PTR_MAP_KEY_INDEX_SHIFT     1
+#define UCS_PTR_MAP_KEY_GEN_SHIFT       33
+
+
+/**
+ * End of the free slots list.
+ */
+#define UCS_PTR_MAP_SLOT_NONE           UINT32_MAX
+
 
 /**
  * Initialize a pointer map.
@@ -32,8 +44,11 @@ KHASH_IMPL(ucs_ptr_map_impl, ucs_ptr_map_key_t, void*, 1,
  */
 static inline ucs_status_t ucs_ptr_map_init(ucs_ptr_map_t *map)
 {
-    map->next_id = 0;
-    kh_init_inplace(ucs_ptr_map_impl, &map->hash);
+    map->slots     = NULL;
+    map->capacity  = 0;
+    map->length    = 0;
+    map->free_head = UCS_PTR_MAP_SLOT_NONE;
+    map->count     = 0;
     return UCS_OK;
 }
 
@@ -44,13 +59,12 @@ static inline ucs_status_t ucs_ptr_map_init(ucs_ptr_map_t *map)
  */
 static inline void ucs_ptr_map_destroy(ucs_ptr_map_t *map)
 {
-    size_t size = kh_size(&map->hash);
-
-    if (size != 0) {
-        ucs_warn("ptr map %p contains %zd elements on destroy", map, size);
+    if (map->count != 0) {
+        ucs_warn("ptr map %p contains %u elements on destroy", map,
+                 map->count);
     }
 
-    kh_destroy_inplace(ucs_ptr_map_impl, &map->hash);
+    ucs_free(map->slots);
 }
 
 /**
@@ -59,7 +73,7 @@ static inline void ucs_ptr_map_destroy(ucs_ptr_map_t *map)
  * @param [in]  map       Container.
  * @param [in]  ptr       Object pointer.
  * @param [in]  indirect  If nonzero, the pointer @a ptr is stored in the
- *                        internal hash table, associated with a unique indirect
+ *                        internal slot table, associated with a unique indirect
  *                        key which is returned from this function. Otherwise,
  *                        the returned value is the integer representation of
  *                        the pointer @ptr.
@@ -73,8 +87,9 @@ static UCS_F_ALWAYS_INLINE ucs_status_t
 ucs_ptr_map_put(ucs_ptr_map_t *map, void *ptr, int indirect,
                 ucs_ptr_map_key_t *key)
 {
-    khiter_t iter;
-    int ret;
+    ucs_ptr_map_slot_t *slot;
+    ucs_status_t status;
+    uint32_t index;
 
     if (ucs_likely(!indirect)) {
         *key = (uintptr_t)ptr;
@@ -82,20 +97,52 @@ ucs_ptr_map_put(ucs_ptr_map_t *map, void *ptr, int indirect,
         return UCS_OK;
     }
 
-    *key = (map->next_id += UCS_PTR_MAP_KEY_MIN_ALIGN) |
-           UCS_PTR_MAP_KEY_INDIRECT_FLAG;
-
-    iter = kh_put(ucs_ptr_map_impl, &map->hash, *key, &ret);
-    if (ucs_unlikely(ret == UCS_KH_PUT_FAILED)) {
-        return UCS_ERR_NO_MEMORY;
-    } else if (ucs_unlikely(ret == UCS_KH_PUT_KEY_PRESENT)) {
-        return UCS_ERR_ALREADY_EXISTS;
+    if (map->free_head != UCS_PTR_MAP_SLOT_NONE) {
+        index          = map->free_head;
+        slot           = &map->slots[index];
+        map->free_head = slot->next_free;
+    } else {
+        if (ucs_unlikely(map->length == map->capacity)) {
+            status = ucs_ptr_map_grow(map);
+            if (status != UCS_OK) {
+                return status;
+            }
+        }
+
+        index = map->length++;
+        slot  = &map->slots[index];
     }
 
-    kh_value(&map->hash, iter) = ptr;
+    /* bump the slot generation, so the keys of its previous objects become
+     * stale */
+    slot->key = (((slot->key >> UCS_PTR_MAP_KEY_GEN_SHIFT) + 1) <<
+                 UCS_PTR_MAP_KEY_GEN_SHIFT) |
+                ((ucs_ptr_map_key_t)index << UCS_PTR_MAP_KEY_INDEX_SHIFT) |
+                UCS_PTR_MAP_KEY_INDIRECT_FLAG;
+    slot->ptr = ptr;
+    *key      = slot->key;
+    ++map->count;
     return UCS_OK;
 }
 
+/**
+ * Find the slot of an indirect key.
+ *
+ * @return the slot holding the key, or NULL if the key is unknown or stale.
+ */
+static UCS_F_ALWAYS_INLINE ucs_ptr_map_slot_t*
+ucs_ptr_map_slot_get(const ucs_ptr_map_t *map, ucs_ptr_map_key_t key)
+{
+    uint32_t index = (uint32_t)(key >> UCS_PTR_MAP_KEY_INDEX_SHIFT);
+
+    if (ucs_unlikely(index >= map->length) ||
+        ucs_unlikely(map->slots[index].key != key)) {
+        return NULL;
+    }
+
+    return &map->slots[index];
+}
+
 /**
  * Get a pointer value from the map by its key.
  *
@@ -106,15 +153,14 @@ ucs_ptr_map_put(ucs_ptr_map_t *map, void *ptr, int indirect,
 static UCS_F_ALWAYS_INLINE void*
 ucs_ptr_map_get(const ucs_ptr_map_t *map, ucs_ptr_map_key_t key)
 {
-    khiter_t iter;
+    ucs_ptr_map_slot_t *slot;
 
     if (ucs_likely(!(key & UCS_PTR_MAP_KEY_INDIRECT_FLAG))) {
         return (void*)key;
     }
 
-    iter = kh_get(ucs_ptr_map_impl, &map->hash, key);
-    return ucs_unlikely(iter == kh_end(&map->hash)) ? NULL :
-           kh_value(&map->hash, iter);
+    slot = ucs_ptr_map_slot_get(map, key);
+    return (slot == NULL) ? NULL : slot->ptr;
 }
 
 /**
@@ -127,20 +173,23 @@ ucs_ptr_map_get(const ucs_ptr_map_t *map, ucs_ptr_map_key_t key)
 static UCS_F_ALWAYS_INLINE void*
 ucs_ptr_map_extract(ucs_ptr_map_t *map, ucs_ptr_map_key_t key)
 {
-    khiter_t iter;
+    ucs_ptr_map_slot_t *slot;
     void *value;
 
     if (ucs_likely(!(key & UCS_PTR_MAP_KEY_INDIRECT_FLAG))) {
         return (void*)key;
     }
 
-    iter = kh_get(ucs_ptr_map_impl, &map->hash, key);
-    if (ucs_unlikely(iter == kh_end(&map->hash))) {
+    slot = ucs_ptr_map_slot_get(map, key);
+    if (ucs_unlikely(slot == NULL)) {
         return NULL;
     }
 
-    value = kh_value(&map->hash, iter);
-    kh_del(ucs_ptr_map_impl, &map->hash, iter);
+    value           = slot->ptr;
+    slot->key      &= ~UCS_PTR_MAP_KEY_INDIRECT_FLAG;
+    slot->next_free = map->free_head;
+    map->free_head  = slot - map->slots;
+    --map->count;
     return value;
 }
 
@@ -150,7 +199,7 @@ ucs_ptr_map_extract(ucs_ptr_map_t *map, ucs_ptr_map_key_t key)
  * @param [in]  map     Container.
  * @param [in]  key     Key to object pointer.
  * @return       - UCS_OK on success
- *               - UCS_ERR_NO_ELEM if the key is not found in the internal hash
+ *               - UCS_ERR_NO_ELEM if the key is not found in the internal slot
  *                 table.
  */
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -16,7 +16,9 @@
 #include <ucs/sys/string.h>
 #include <ucs/sys/sys.h>
 #include <ucs/sys/math.h>
+#include <ucs/arch/atomic.h>
 #include <ucs/config/parser.h>
+#include <ucs/time/time.h>
 
 #define UCS_MAX_LOG_HANDLERS    32
 
@@ -26,17 +28,44 @@
 #define UCS_LOG_PROC_DATA_FMT   "[%s:%-5d:%d]"
 #define UCS_LOG_SHORT_FMT       UCS_LOG_TIME_FMT" "UCS_LOG_FILE_FMT" " \
                                 UCS_LOG_METADATA_FMT" ""%s\n"
-#define UCS_LOG_FMT             UCS_LOG_TIME_FMT" "UCS_LOG_PROC_DATA_FMT" " \
-                                UCS_LOG_FILE_FMT" "UCS_LOG_METADATA_FMT" ""%s\n"
+#define UCS_LOG_PREFIX_FMT      UCS_LOG_TIME_FMT" "UCS_LOG_PROC_DATA_FMT" " \
+                                UCS_LOG_FILE_FMT" "UCS_LOG_METADATA_FMT" "
+#define UCS_LOG_FMT             UCS_LOG_PREFIX_FMT"%s\n"
+#define UCS_LOG_PREFIX_MAX      256
 
 #define UCS_LOG_TIME_ARG(_tv)  (_tv)->tv_sec, (_tv)->tv_usec
 #define UCS_LOG_SHORT_ARG(_short_file, _line, _level, _comp_conf, _tv, _message) \
     UCS_LOG_TIME_ARG(_tv), _short_file, _line, (_comp_conf)->name, \
     ucs_log_level_names[_level], _message
-#define UCS_LOG_ARG(_short_file, _line, _level, _comp_conf, _tv, _message) \
+#define UCS_LOG_PREFIX_ARG(_short_file, _line, _level, _comp_conf, _tv) \
     UCS_LOG_TIME_ARG(_tv), ucs_log_hostname, ucs_log_pid, \
     ucs_log_get_thread_num(),_short_file, _line, (_comp_conf)->name, \
-    ucs_log_level_names[_level], _message
+    ucs_log_level_names[_level]
+#define UCS_LOG_ARG(_short_file, _line, _level, _comp_conf, _tv, _message) \
+    UCS_LOG_PREFIX_ARG(_short_file, _line, _level, _comp_conf, _tv), _message
+
+/* Bounds for the idle sleep of the asynchronous log writer, in microseconds */
+#define UCS_LOG_ASYNC_IDLE_MIN  50
+#define UCS_LOG_ASYNC_IDLE_MAX  1000
+
+/* How long ucs_log_flush() waits for the asynchronous log writer, in seconds */
+#define UCS_LOG_ASYNC_FLUSH_TIMEOUT 1.0
+
+
+/*
+ * Single-producer single-consumer ring of formatted log lines. Every record is
+ * a 32-bit length followed by the text of the line. The producer is the thread
+ * which owns the ring, and the consumer is the log writer thread.
+ */
+typedef struct ucs_log_ring {
+    struct ucs_log_ring *next;      /* Next ring in the global list */
+    volatile uint32_t   in_use;     /* Whether a thread owns the ring */
+    volatile uint64_t   head;       /* Producer position */
+    volatile uint64_t   tail;       /* Consumer position */
+    volatile uint64_t   dropped;    /* Messages which did not fit the ring */
+    uint64_t            reported;   /* Dropped messages already reported */
+    char                data[0];
+} ucs_log_ring_t;
 
 const char *ucs_log_level_names[] = {
     [UCS_LOG_LEVEL_FATAL]        = "FATAL",
@@ -68,6 +97,19 @@ static pthread_spinlock_t threads_lock      = 0;
 static pthread_t threads[128]               = {0};
 static ucs_log_func_t ucs_log_handlers[UCS_MAX_LOG_HANDLERS];
 
+static struct {
+    int                       enabled;     /* Writer thread is running */
+    volatile int              stop;        /* Writer thread should exit */
+    pthread_t                 thread;      /* Writer thread */
+    pthread_key_t             key;         /* Ring of the current thread */
+    ucs_log_ring_t * volatile rings;       /* All rings, never shrinks */
+    volatile uint64_t         lost;        /* Messages without a ring */
+    uint64_t                  lost_reported;
+    size_t                    ring_size;   /* Power of 2 */
+    volatile uint64_t         flush_req;   /* Flush requests counter */
+    volatile uint64_t         flush_done;  /* Last request handled by writer */
+} ucs_log_async;
+
 
 static int ucs_log_get_thread_num(void)
 {
@@ -102,9 +144,34 @@ unlock_and_return_i:
     return i;
 }
 
+static void ucs_log_async_flush()
+{
+    ucs_time_t deadline;
+    uint64_t req;
+
+    /* The writer thread itself must not wait for its own progress */
+    if (pthread_equal(pthread_self(), ucs_log_async.thread)) {
+        return;
+    }
+
+    /* The log file is owned by the writer thread, so ask it to write out all
+     * messages pushed so far and sync the file */
+    req      = ucs_atomic_fadd64(&ucs_log_async.flush_req, 1) + 1;
+    deadline = ucs_get_time() +
+               ucs_time_from_sec(UCS_LOG_ASYNC_FLUSH_TIMEOUT);
+    while ((int64_t)(ucs_log_async.flush_done - req) < 0) {
+        if (ucs_get_time() > deadline) {
+            break;
+        }
+        usleep(UCS_LOG_ASYNC_IDLE_MIN);
+    }
+}
+
 void ucs_log_flush()
 {
-    if (ucs_log_file != NULL) {
+    if (ucs_log_async.enabled) {
+        ucs_log_async_flush();
+    } else if (ucs_log_file != NULL) {
         fflush(ucs_log_file);
         fsync(fileno(ucs_log_file));
     }
@@ -198,6 +265,310 @@ static void ucs_log_handle_file_max_size(int log_entry_len)
                            &next_token, NULL);
 }
 
+static void ucs_log_ring_copy_in(ucs_log_ring_t *ring, uint64_t pos,
+                                 const void *src, size_t length)
+{
+    size_t offset = pos & (ucs_log_async.ring_size - 1);
+    size_t first  = ucs_min(length, ucs_log_async.ring_size - offset);
+
+    memcpy(ring->data + offset, src, first);
+    memcpy(ring->data, UCS_PTR_BYTE_OFFSET(src, first), length - first);
+}
+
+static void ucs_log_ring_copy_out(ucs_log_ring_t *ring, uint64_t pos,
+                                  void *dst, size_t length)
+{
+    size_t offset = pos & (ucs_log_async.ring_size - 1);
+    size_t first  = ucs_min(length, ucs_log_async.ring_size - offset);
+
+    memcpy(dst, ring->data + offset, first);
+    memcpy(UCS_PTR_BYTE_OFFSET(dst, first), ring->data, length - first);
+}
+
+static void ucs_log_ring_release(void *arg)
+{
+    ucs_log_ring_t *ring = arg;
+
+    /* Pending records are still written out; the ring can be taken over by a
+     * new thread, which continues to append after them */
+    ucs_memory_cpu_store_fence();
+    ring->in_use = 0;
+}
+
+static ucs_log_ring_t *ucs_log_ring_get()
+{
+    ucs_log_ring_t *ring, *head;
+
+    ring = pthread_getspecific(ucs_log_async.key);
+    if (ucs_likely(ring != NULL)) {
+        return ring;
+    }
+
+    /* Reuse a ring released by a thread which has exited, to keep the memory
+     * bounded by the maximal number of concurrent threads */
+    for (ring = ucs_log_async.rings; ring != NULL; ring = ring->next) {
+        if ((ring->in_use == 0) &&
+            (ucs_atomic_cswap32(&ring->in_use, 0, 1) == 0)) {
+            goto out;
+        }
+    }
+
+    /* Not allocated by ucs_malloc(), since memtrack may print log messages */
+    ring = calloc(1, sizeof(*ring) + ucs_log_async.ring_size);
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    ring->in_use = 1;
+    do {
+        head       = ucs_log_async.rings;
+        ring->next = head;
+        ucs_memory_cpu_store_fence();
+    } while (ucs_atomic_cswap64((volatile uint64_t*)&ucs_log_async.rings,
+                                (uintptr_t)head, (uintptr_t)ring) !=
+             (uintptr_t)head);
+
+out:
+    pthread_setspecific(ucs_log_async.key, ring);
+    return ring;
+}
+
+static void ucs_log_async_push(const char *prefix, size_t prefix_len,
+                               const char *message)
+{
+    size_t message_len = strlen(message);
+    uint32_t length    = prefix_len + message_len + 1;
+    ucs_log_ring_t *ring;
+    uint64_t head;
+
+    ring = ucs_log_ring_get();
+    if (ring == NULL) {
+        ucs_atomic_add64(&ucs_log_async.lost, 1);
+        return;
+    }
+
+    head = ring->head;
+    ucs_memory_cpu_fence();
+    if ((head - ring->tail + sizeof(length) + length) >
+        ucs_log_async.ring_size) {
+        ++ring->dropped;
+        return;
+    }
+
+    /* Make sure the consumer is done reading the space we are about to use */
+    ucs_memory_cpu_fence();
+
+    ucs_log_ring_copy_in(ring, head, &length, sizeof(length));
+    head += sizeof(length);
+    ucs_log_ring_copy_in(ring, head, prefix, prefix_len);
+    head += prefix_len;
+    ucs_log_ring_copy_in(ring, head, message, message_len);
+    head += message_len;
+    ucs_log_ring_copy_in(ring, head, "\n", 1);
+    head += 1;
+
+    ucs_memory_cpu_store_fence();
+    ring->head = head;
+}
+
+static void ucs_log_async_print(const char *short_file, int line,
+                                ucs_log_level_t level,
+                                const ucs_log_component_config_t *comp_conf,
+                                const struct timeval *tv, const char *message)
+{
+    char prefix[UCS_LOG_PREFIX_MAX];
+    int prefix_len;
+
+    prefix_len = snprintf(prefix, sizeof(prefix), UCS_LOG_PREFIX_FMT,
+                          UCS_LOG_PREFIX_ARG(short_file, line, level,
+                                             comp_conf, tv));
+    if (prefix_len < 0) {
+        return;
+    }
+
+    ucs_log_async_push(prefix, ucs_min(prefix_len, sizeof(prefix) - 1),
+                       message);
+}
+
+static void ucs_log_async_write_segment(ucs_log_ring_t *ring, uint64_t pos,
+                                        size_t length)
+{
+    size_t offset = pos & (ucs_log_async.ring_size - 1);
+    size_t first  = ucs_min(length, ucs_log_async.ring_size - offset);
+    size_t ret;
+
+    ret  = fwrite(ring->data + offset, 1, first, ucs_log_file);
+    ret += fwrite(ring->data, 1, length - first, ucs_log_file);
+    (void)ret;
+}
+
+static void ucs_log_async_report_dropped(uint64_t count)
+{
+    char message[64];
+    struct timeval tv;
+    int log_entry_len;
+
+    gettimeofday(&tv, NULL);
+    ucs_snprintf_zero(message, sizeof(message), "dropped %" PRIu64
+                      " log messages", count);
+    if (ucs_log_file_close) {
+        log_entry_len = snprintf(NULL, 0, UCS_LOG_FMT,
+                                 UCS_LOG_ARG(ucs_basename(__FILE__), __LINE__,
+                                             UCS_LOG_LEVEL_WARN,
+                                             &ucs_global_opts.log_component,
+                                             &tv, message));
+        ucs_log_handle_file_max_size(log_entry_len);
+    }
+
+    fprintf(ucs_log_file, UCS_LOG_FMT,
+            UCS_LOG_ARG(ucs_basename(__FILE__), __LINE__, UCS_LOG_LEVEL_WARN,
+                        &ucs_global_opts.log_component, &tv, message));
+}
+
+static unsigned ucs_log_async_drain()
+{
+    uint64_t dropped, lost, head, tail;
+    unsigned count = 0;
+    ucs_log_ring_t *ring;
+    uint32_t length;
+
+    dropped = 0;
+    for (ring = ucs_log_async.rings; ring != NULL; ring = ring->next) {
+        head = ring->head;
+        ucs_memory_cpu_load_fence();
+
+        for (tail = ring->tail; tail != head;
+             tail += sizeof(length) + length) {
+            ucs_log_ring_copy_out(ring, tail, &length, sizeof(length));
+            if (ucs_log_file_close) { /* non-stdout/stderr */
+                ucs_log_handle_file_max_size(length);
+            }
+
+            ucs_log_async_write_segment(ring, tail + sizeof(length), length);
+            ++count;
+        }
+
+        /* Release the space only after the records were copied out */
+        ucs_memory_cpu_fence();
+        ring->tail = tail;
+
+        dropped       += ring->dropped - ring->reported;
+        ring->reported = ring->dropped;
+    }
+
+    lost                         = ucs_log_async.lost;
+    dropped                     += lost - ucs_log_async.lost_reported;
+    ucs_log_async.lost_reported  = lost;
+
+    if (dropped > 0) {
+        ucs_log_async_report_dropped(dropped);
+        ++count;
+    }
+
+    return count;
+}
+
+static void *ucs_log_async_thread_func(void *arg)
+{
+    unsigned idle_usec = UCS_LOG_ASYNC_IDLE_MIN;
+    uint64_t flush_req;
+    unsigned count;
+    int stop;
+
+    for (;;) {
+        /* Read the requests before draining, so everything pushed before a
+         * request was made is written out before it is acknowledged */
+        stop      = ucs_log_async.stop;
+        flush_req = ucs_log_async.flush_req;
+        ucs_memory_cpu_fence();
+
+        count = ucs_log_async_drain();
+        if (count > 0) {
+            fflush(ucs_log_file);
+        }
+
+        if (flush_req != ucs_log_async.flush_done) {
+            fflush(ucs_log_file);
+            fsync(fileno(ucs_log_file));
+            ucs_memory_cpu_store_fence();
+            ucs_log_async.flush_done = flush_req;
+        }
+
+        if (count > 0) {
+            idle_usec = UCS_LOG_ASYNC_IDLE_MIN;
+        } else if (stop) {
+            break;
+        } else {
+            usleep(idle_usec);
+            idle_usec = ucs_min(idle_usec * 2, UCS_LOG_ASYNC_IDLE_MAX);
+        }
+    }
+
+    return NULL;
+}
+
+static void ucs_log_async_init()
+{
+    size_t record_max;
+    int ret;
+
+    record_max              = sizeof(uint32_t) + UCS_LOG_PREFIX_MAX +
+                              ucs_log_get_buffer_size() + 1;
+    ucs_log_async.ring_size = ucs_roundup_pow2(
+            ucs_config_memunits_get(ucs_global_opts.log_async_buffer_size,
+                                    2 * record_max, UCS_GBYTE));
+    ucs_log_async.ring_size = ucs_max(ucs_log_async.ring_size,
+                                      ucs_roundup_pow2(2 * record_max));
+    ucs_log_async.rings         = NULL;
+    ucs_log_async.lost          = 0;
+    ucs_log_async.lost_reported = 0;
+    ucs_log_async.flush_req     = 0;
+    ucs_log_async.flush_done    = 0;
+    ucs_log_async.stop          = 0;
+
+    ret = pthread_key_create(&ucs_log_async.key, ucs_log_ring_release);
+    if (ret != 0) {
+        ucs_warn("failed to create log ring key: %s, using synchronous "
+                 "logging", strerror(ret));
+        return;
+    }
+
+    ret = pthread_create(&ucs_log_async.thread, NULL,
+                         ucs_log_async_thread_func, NULL);
+    if (ret != 0) {
+        pthread_key_delete(ucs_log_async.key);
+        ucs_warn("failed to create log writer thread: %s, using synchronous "
+                 "logging", strerror(ret));
+        return;
+    }
+
+    ucs_log_async.enabled = 1;
+}
+
+static void ucs_log_async_cleanup()
+{
+    ucs_log_ring_t *ring, *next;
+
+    if (!ucs_log_async.enabled) {
+        return;
+    }
+
+    /* The writer thread drains all rings before it exits */
+    ucs_log_async.stop = 1;
+    pthread_join(ucs_log_async.thread, NULL);
+    ucs_log_async.enabled = 0;
+
+    /* After the key is deleted, thread exit destructors are no longer called,
+     * so the rings can be released here */
+    pthread_key_delete(ucs_log_async.key);
+
+    for (ring = ucs_log_async.rings; ring != NULL; ring = next) {
+        next = ring->next;
+        free(ring);
+    }
+    ucs_log_async.rings = NULL;
+}
+
 static void ucs_log_print(size_t buffer_size, const char *short_file, int line,
                           ucs_log_level_t level,
                           const ucs_log_component_config_t *comp_conf,
@@ -212,6 +583,8 @@ static void ucs_log_print(size_t buffer_size, const char *short_file, int line,
                 UCS_LOG_SHORT_ARG(short_file, line, level,
                                   comp_conf, tv, message));
         VALGRIND_PRINTF("%s", log_buf);
+    } else if (ucs_log_async.enabled) {
+        ucs_log_async_print(short_file, line, level, comp_conf, tv, message);
     } else if (ucs_log_initialized) {
         if (ucs_log_file_close) { /* non-stdout/stderr */
             /* get log entry size */
@@ -413,6 +786,7 @@ void ucs_log_early_init()
     ucs_log_file          = NULL;
     ucs_log_file_last_idx = 0;
     ucs_log_file_close    = 0;
+    ucs_log_async.enabled = 0;
     threads_count         = 0;
     pthread_spin_init(&threads_lock, 0);
 }
@@ -452,12 +826,17 @@ void ucs_log_init()
                                &ucs_log_file, &ucs_log_file_close,
                                &next_token, &ucs_log_file_base_name);
     }
+
+    if (ucs_global_opts.log_async && !RUNNING_ON_VALGRIND) {
+        ucs_log_async_init();
+    }
 }
 
 void ucs_log_cleanup()
 {
     ucs_assert(ucs_log_initialized);
 
+    ucs_log_async_cleanup();
     ucs_log_flush();
     if (ucs_log_file_close) {
         fclose(ucs_log_file);
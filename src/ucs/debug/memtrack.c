@@ -10,27 +10,58 @@
 
 #include "memtrack.h"
 
+#include <ucs/arch/atomic.h>
 #include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/list.h>
 #include <ucs/debug/log.h>
 #include <ucs/stats/stats.h>
 #include <ucs/sys/sys.h>
 #include <ucs/sys/math.h>
+#include <ucs/time/time.h>
 #ifdef HAVE_MALLOC_H
 #include <malloc.h>
 #endif
 #include <stdio.h>
+#include <math.h>
 
 
 #ifdef ENABLE_MEMTRACK
 
 #define UCS_MEMTRACK_FORMAT_STRING    ("%22s: size: %9lu / %9lu\tcount: %9u / %9u\n")
 
+/* Table of sampled allocations: open addressing, with bounded probing */
+#define UCS_MEMTRACK_SAMPLE_SLOTS     32768
+#define UCS_MEMTRACK_SAMPLE_PROBES    64
+#define UCS_MEMTRACK_SAMPLE_EMPTY     0
+#define UCS_MEMTRACK_SAMPLE_DELETED   1
+
 
 typedef struct ucs_memtrack_ptr {
     size_t                  size;   /* Length of allocated buffer */
     ucs_memtrack_entry_t    *entry; /* Entry which tracks this allocation */
 } ucs_memtrack_ptr_t;
 
+
+/* Sampled allocation, which stands for all allocations made since the previous
+ * sample of the same thread */
+typedef struct ucs_memtrack_sample {
+    volatile uint64_t       ptr;    /* Address, or EMPTY/DELETED */
+    ucs_memtrack_entry_t    *entry; /* Entry which tracks this allocation */
+    size_t                  size;   /* Estimated number of bytes */
+    unsigned                count;  /* Estimated number of blocks */
+} ucs_memtrack_sample_t;
+
+
+/* Per-thread sampling state */
+typedef struct ucs_memtrack_thread {
+    ucs_list_link_t         list;        /* Entry in the list of threads */
+    ssize_t                 bytes_left;  /* Bytes to allocate until next sample */
+    uint64_t                rand_state;  /* State of the random generator */
+    uint64_t                alloc_count; /* Allocations not reported to stats */
+    uint64_t                alloc_size;  /* Bytes not reported to stats */
+} ucs_memtrack_thread_t;
+
+
 KHASH_MAP_INIT_INT64(ucs_memtrack_ptr_hash, ucs_memtrack_ptr_t)
 KHASH_MAP_INIT_STR(ucs_memtrack_entry_hash, ucs_memtrack_entry_t*);
 
@@ -40,6 +71,14 @@ typedef struct ucs_memtrack_context {
     ucs_memtrack_entry_t             total;
     khash_t(ucs_memtrack_ptr_hash)   ptrs;
     khash_t(ucs_memtrack_entry_hash) entries;
+
+    /* Sampling mode: average number of bytes between samples, or 0 to track
+     * all allocations */
+    size_t                           sample_bytes;
+    pthread_key_t                    thread_key;
+    ucs_list_link_t                  threads;
+    ucs_memtrack_sample_t            *samples;
+    volatile uint64_t                samples_lost;
     UCS_STATS_NODE_DECLARE(stats)
 } ucs_memtrack_context_t;
 
@@ -108,6 +147,218 @@ static void ucs_memtrack_entry_update(ucs_memtrack_entry_t *entry, ssize_t size)
     entry->peak_size   = ucs_max(entry->peak_size,  entry->size);
 }
 
+static void ucs_memtrack_atomic_max64(volatile size_t *ptr, size_t value)
+{
+    size_t prev;
+
+    do {
+        prev = *ptr;
+        if (prev >= value) {
+            return;
+        }
+    } while (ucs_atomic_cswap64((volatile uint64_t*)ptr, prev, value) != prev);
+}
+
+static void ucs_memtrack_atomic_max32(volatile unsigned *ptr, unsigned value)
+{
+    unsigned prev;
+
+    do {
+        prev = *ptr;
+        if (prev >= value) {
+            return;
+        }
+    } while (ucs_atomic_cswap32((volatile uint32_t*)ptr, prev, value) != prev);
+}
+
+/* Lock-free version of ucs_memtrack_entry_update(), used in sampling mode */
+static void ucs_memtrack_entry_update_atomic(ucs_memtrack_entry_t *entry,
+                                             ssize_t size, int count)
+{
+    size_t new_size;
+    unsigned new_count;
+
+    new_size  = ucs_atomic_fadd64((volatile uint64_t*)&entry->size, size) +
+                size;
+    new_count = ucs_atomic_fadd32((volatile uint32_t*)&entry->count, count) +
+                count;
+    if (size > 0) {
+        ucs_memtrack_atomic_max64(&entry->peak_size, new_size);
+        ucs_memtrack_atomic_max32(&entry->peak_count, new_count);
+    }
+}
+
+static uint64_t ucs_memtrack_thread_rand(ucs_memtrack_thread_t *thread)
+{
+    /* xorshift64* */
+    thread->rand_state ^= thread->rand_state >> 12;
+    thread->rand_state ^= thread->rand_state << 25;
+    thread->rand_state ^= thread->rand_state >> 27;
+    return thread->rand_state * 2685821657736338717ull;
+}
+
+/* Distance to the next sample is exponentially distributed, so allocations are
+ * sampled as a Poisson process over the allocated bytes */
+static ssize_t ucs_memtrack_sample_interval(ucs_memtrack_thread_t *thread)
+{
+    double u = ((ucs_memtrack_thread_rand(thread) >> 11) + 1) * 0x1p-53;
+
+    return (ssize_t)(-log(u) * ucs_memtrack_context.sample_bytes) + 1;
+}
+
+static void ucs_memtrack_thread_flush_stats(ucs_memtrack_thread_t *thread)
+{
+    UCS_STATS_UPDATE_COUNTER(ucs_memtrack_context.stats,
+                             UCS_MEMTRACK_STAT_ALLOCATION_COUNT,
+                             thread->alloc_count);
+    UCS_STATS_UPDATE_COUNTER(ucs_memtrack_context.stats,
+                             UCS_MEMTRACK_STAT_ALLOCATION_SIZE,
+                             thread->alloc_size);
+    thread->alloc_count = 0;
+    thread->alloc_size  = 0;
+}
+
+static void ucs_memtrack_thread_cleanup(void *arg)
+{
+    ucs_memtrack_thread_t *thread = arg;
+
+    pthread_mutex_lock(&ucs_memtrack_context.lock);
+    ucs_memtrack_thread_flush_stats(thread);
+    ucs_list_del(&thread->list);
+    pthread_mutex_unlock(&ucs_memtrack_context.lock);
+    free(thread);
+}
+
+static ucs_memtrack_thread_t *ucs_memtrack_thread_get()
+{
+    ucs_memtrack_thread_t *thread;
+
+    thread = pthread_getspecific(ucs_memtrack_context.thread_key);
+    if (ucs_likely(thread != NULL)) {
+        return thread;
+    }
+
+    /* Not using ucs_malloc(), to avoid recursion */
+    thread = malloc(sizeof(*thread));
+    if (thread == NULL) {
+        return NULL;
+    }
+
+    thread->rand_state  = ucs_get_tid() ^ ucs_get_time() ^
+                          (uintptr_t)thread;
+    thread->rand_state |= 1; /* Must not be 0 */
+    thread->alloc_count = 0;
+    thread->alloc_size  = 0;
+    thread->bytes_left  = ucs_memtrack_sample_interval(thread);
+
+    pthread_mutex_lock(&ucs_memtrack_context.lock);
+    ucs_list_add_tail(&ucs_memtrack_context.threads, &thread->list);
+    pthread_mutex_unlock(&ucs_memtrack_context.lock);
+
+    pthread_setspecific(ucs_memtrack_context.thread_key, thread);
+    return thread;
+}
+
+static inline ucs_memtrack_sample_t *ucs_memtrack_sample_slot(void *ptr,
+                                                              unsigned i)
+{
+    khint32_t hash = kh_int64_hash_func((uintptr_t)ptr);
+
+    return &ucs_memtrack_context.samples[(hash + i) &
+                                         (UCS_MEMTRACK_SAMPLE_SLOTS - 1)];
+}
+
+static void ucs_memtrack_sample_add(void *ptr, ucs_memtrack_entry_t *entry,
+                                    size_t size, unsigned count)
+{
+    ucs_memtrack_sample_t *sample;
+    uint64_t value;
+    unsigned i;
+
+    for (i = 0; i < UCS_MEMTRACK_SAMPLE_PROBES; ++i) {
+        sample = ucs_memtrack_sample_slot(ptr, i);
+        value  = sample->ptr;
+        if (((value == UCS_MEMTRACK_SAMPLE_EMPTY) ||
+             (value == UCS_MEMTRACK_SAMPLE_DELETED)) &&
+            (ucs_atomic_cswap64(&sample->ptr, value, (uintptr_t)ptr) ==
+             value)) {
+            /* The slot is not looked up before the allocation is returned
+             * to the user, so it's safe to fill it after publishing */
+            sample->entry = entry;
+            sample->size  = size;
+            sample->count = count;
+            ucs_memtrack_entry_update_atomic(entry, size, count);
+            ucs_memtrack_entry_update_atomic(&ucs_memtrack_context.total, size,
+                                             count);
+            return;
+        }
+    }
+
+    ucs_atomic_add64(&ucs_memtrack_context.samples_lost, 1);
+}
+
+static void ucs_memtrack_sample_remove(void *ptr)
+{
+    ucs_memtrack_sample_t *sample;
+    uint64_t value;
+    unsigned i;
+
+    for (i = 0; i < UCS_MEMTRACK_SAMPLE_PROBES; ++i) {
+        sample = ucs_memtrack_sample_slot(ptr, i);
+        value  = sample->ptr;
+        if (value == UCS_MEMTRACK_SAMPLE_EMPTY) {
+            return; /* not sampled */
+        } else if (value == (uintptr_t)ptr) {
+            ucs_memtrack_entry_update_atomic(sample->entry,
+                                             -(ssize_t)sample->size,
+                                             -(int)sample->count);
+            ucs_memtrack_entry_update_atomic(&ucs_memtrack_context.total,
+                                             -(ssize_t)sample->size,
+                                             -(int)sample->count);
+            sample->ptr = UCS_MEMTRACK_SAMPLE_DELETED;
+            return;
+        }
+    }
+}
+
+static void ucs_memtrack_sampled_allocated(void *ptr, size_t size,
+                                           const char *name)
+{
+    ucs_memtrack_thread_t *thread;
+    ucs_memtrack_entry_t *entry;
+    double probability;
+    size_t est_size;
+
+    thread = ucs_memtrack_thread_get();
+    if (thread == NULL) {
+        return;
+    }
+
+    ++thread->alloc_count;
+    thread->alloc_size += size;
+    thread->bytes_left -= size;
+    if (ucs_likely(thread->bytes_left > 0)) {
+        return;
+    }
+
+    thread->bytes_left = ucs_memtrack_sample_interval(thread);
+
+    /* Unbiased estimate of the amount of memory this sample stands for: an
+     * allocation of 'size' bytes is sampled with probability 1-exp(-size/R) */
+    probability = -expm1(-(double)size / ucs_memtrack_context.sample_bytes);
+    est_size    = (size_t)(size / probability);
+
+    pthread_mutex_lock(&ucs_memtrack_context.lock);
+    entry = ucs_memtrack_entry_get(name);
+    ucs_memtrack_thread_flush_stats(thread);
+    pthread_mutex_unlock(&ucs_memtrack_context.lock);
+
+    if (entry != NULL) {
+        ucs_memtrack_sample_add(ptr, entry, est_size,
+                                ucs_max((unsigned)(1.0 / probability), 1));
+    }
+}
+
 void ucs_memtrack_allocated(void *ptr, size_t size, const char *name)
 {
     ucs_memtrack_entry_t *entry;
@@ -124,6 +375,11 @@ void ucs_memtrack_allocated(void *ptr, size_t size, const char *name)
         return;
     }
 
+    if (ucs_memtrack_context.sample_bytes != 0) {
+        ucs_memtrack_sampled_allocated(ptr, size, name);
+        return;
+    }
+
     pthread_mutex_lock(&ucs_memtrack_context.lock);
 
     entry = ucs_memtrack_entry_get(name);
@@ -159,6 +415,11 @@ void ucs_memtrack_releasing(void* ptr)
         return;
     }
 
+    if (ucs_memtrack_context.sample_bytes != 0) {
+        ucs_memtrack_sample_remove(ptr);
+        return;
+    }
+
     pthread_mutex_lock(&ucs_memtrack_context.lock);
 
     iter = kh_get(ucs_memtrack_ptr_hash, &ucs_memtrack_context.ptrs, (uintptr_t)ptr);
@@ -294,6 +555,11 @@ static void ucs_memtrack_dump_internal(FILE* output_stream)
     qsort(all_entries, num_entries, sizeof(*all_entries), ucs_memtrack_cmp_entries);
 
     /* print title */
+    if (ucs_memtrack_context.sample_bytes != 0) {
+        fprintf(output_stream, "sampled: 1 per %zu bytes, %"PRIu64" samples "
+                "lost\n", ucs_memtrack_context.sample_bytes,
+                ucs_memtrack_context.samples_lost);
+    }
     fprintf(output_stream, "%31s current / peak  %16s current / peak\n", "", "");
     fprintf(output_stream, UCS_MEMTRACK_FORMAT_STRING, "TOTAL",
             ucs_memtrack_context.total.size, ucs_memtrack_context.total.peak_size,
@@ -334,6 +600,57 @@ static void ucs_memtrack_generate_report()
     }
 }
 
+static void ucs_memtrack_sampling_init()
+{
+    int ret;
+
+    ucs_memtrack_context.samples_lost = 0;
+    ucs_list_head_init(&ucs_memtrack_context.threads);
+
+    ucs_memtrack_context.samples = calloc(UCS_MEMTRACK_SAMPLE_SLOTS,
+                                          sizeof(ucs_memtrack_sample_t));
+    if (ucs_memtrack_context.samples == NULL) {
+        ucs_warn("failed to allocate memtrack samples table, tracking all "
+                 "allocations");
+        goto err;
+    }
+
+    ret = pthread_key_create(&ucs_memtrack_context.thread_key,
+                             ucs_memtrack_thread_cleanup);
+    if (ret != 0) {
+        ucs_warn("failed to create memtrack thread key: %s, tracking all "
+                 "allocations", strerror(ret));
+        goto err_free;
+    }
+
+    ucs_debug("memtrack sampling 1 per %zu bytes",
+              ucs_memtrack_context.sample_bytes);
+    return;
+
+err_free:
+    free(ucs_memtrack_context.samples);
+err:
+    ucs_memtrack_context.sample_bytes = 0;
+}
+
+static void ucs_memtrack_sampling_cleanup()
+{
+    ucs_memtrack_thread_t *thread, *tmp;
+
+    /* After the key is deleted, thread exit destructors are no longer called,
+     * so the states of all threads can be released here */
+    pthread_key_delete(ucs_memtrack_context.thread_key);
+
+    ucs_list_for_each_safe(thread, tmp, &ucs_memtrack_context.threads, list) {
+        ucs_list_del(&thread->list);
+        free(thread);
+    }
+
+    free(ucs_memtrack_context.samples);
+    ucs_memtrack_context.samples      = NULL;
+    ucs_memtrack_context.sample_bytes = 0;
+}
+
 void ucs_memtrack_init()
 {
     ucs_status_t status;
@@ -358,6 +675,11 @@ void ucs_memtrack_init()
         return;
     }
 
+    ucs_memtrack_context.sample_bytes = ucs_global_opts.memtrack_sample;
+    if (ucs_memtrack_context.sample_bytes != 0) {
+        ucs_memtrack_sampling_init();
+    }
+
     ucs_debug("memtrack enabled");
     ucs_memtrack_context.enabled = 1;
 }
@@ -374,6 +696,9 @@ void ucs_memtrack_cleanup()
 
     /* disable before releasing the stats node */
     ucs_memtrack_context.enabled = 0;
+    if (ucs_memtrack_context.sample_bytes != 0) {
+        ucs_memtrack_sampling_cleanup();
+    }
     UCS_STATS_NODE_FREE(ucs_memtrack_context.stats);
 
     /* cleanup entries */
@@ -12,6 +12,9 @@
 
 #include <ucs/debug/assert.h>
 #include <ucs/debug/log.h>
+#include <ucs/profile/profile.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/sys.h>
 #include <stdint.h>
 #include <sched.h>
 
@@ -71,4 +74,197 @@ int ucs_numa_node_of_cpu(int cpu)
     return cpu_numa_nodes[cpu] - 1;
 }
 
+unsigned ucs_numa_num_nodes(void)
+{
+    if (numa_available() < 0) {
+        return 1;
+    }
+
+    return ucs_max(numa_num_configured_nodes(), 1);
+}
+
+int ucs_numa_current_node(void)
+{
+    int cpu, node;
+
+    cpu = sched_getcpu();
+    if ((cpu < 0) || (cpu >= __CPU_SETSIZE) || (numa_available() < 0)) {
+        return 0;
+    }
+
+    node = ucs_numa_node_of_cpu(cpu);
+    return (node < 0) ? 0 : node;
+}
+
+static ucs_status_t ucs_numa_policy_mask(int node, ucs_numa_policy_t policy,
+                                         int *mode_p,
+                                         struct bitmask **nodemask_p)
+{
+    struct bitmask *nodemask;
+
+    switch (policy) {
+    case UCS_NUMA_POLICY_BIND:
+        *mode_p = MPOL_BIND;
+        break;
+    case UCS_NUMA_POLICY_PREFERRED:
+        *mode_p = MPOL_PREFERRED;
+        break;
+    default:
+        ucs_error("unexpected numa policy %d", policy);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if ((numa_available() < 0) || (node < 0) || (node > numa_max_node())) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    nodemask = numa_allocate_nodemask();
+    if (nodemask == NULL) {
+        ucs_warn("failed to allocate numa node mask");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    numa_bitmask_clearall(nodemask);
+    numa_bitmask_setbit(nodemask, node);
+    *nodemask_p = nodemask;
+    return UCS_OK;
+}
+
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length, int node,
+                               ucs_numa_policy_t policy)
+{
+    struct bitmask *nodemask;
+    uintptr_t start, end;
+    ucs_status_t status;
+    int mode, ret;
+
+    if (policy == UCS_NUMA_POLICY_DEFAULT) {
+        return UCS_OK;
+    }
+
+    status = ucs_numa_policy_mask(node, policy, &mode, &nodemask);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    start = ucs_align_down_pow2((uintptr_t)address, ucs_get_page_size());
+    end   = ucs_align_up_pow2((uintptr_t)address + length,
+                              ucs_get_page_size());
+    ucs_trace("0x%"PRIxPTR"..0x%"PRIxPTR": setting numa policy %s node %d",
+              start, end, ucs_numa_policy_names[policy], node);
+
+    ret = UCS_PROFILE_CALL(mbind, (void*)start, end - start, mode,
+                           numa_nodemask_p(nodemask),
+                           numa_nodemask_size(nodemask), MPOL_MF_MOVE);
+    if (ret < 0) {
+        ucs_debug("mbind(addr=0x%"PRIxPTR" length=%zu policy=%d node=%d) "
+                  "failed: %m", start, (size_t)(end - start), mode, node);
+        status = UCS_ERR_IO_ERROR;
+    } else {
+        status = UCS_OK;
+    }
+
+    numa_free_nodemask(nodemask);
+    return status;
+}
+
+ucs_status_t ucs_numa_thread_policy_set(int node, ucs_numa_policy_t policy,
+                                        ucs_numa_thread_policy_t *prev)
+{
+    struct bitmask *nodemask, *prev_nodemask;
+    ucs_status_t status;
+    int mode, prev_mode;
+
+    prev->nodemask = NULL;
+
+    if (policy == UCS_NUMA_POLICY_DEFAULT) {
+        return UCS_OK;
+    }
+
+    status = ucs_numa_policy_mask(node, policy, &mode, &nodemask);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    prev_nodemask = numa_allocate_nodemask();
+    if (prev_nodemask == NULL) {
+        ucs_warn("failed to allocate numa node mask");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free_nodemask;
+    }
+
+    if (get_mempolicy(&prev_mode, numa_nodemask_p(prev_nodemask),
+                      numa_nodemask_size(prev_nodemask) + 1, NULL, 0) < 0) {
+        ucs_debug("get_mempolicy() failed: %m");
+        status = UCS_ERR_IO_ERROR;
+        goto err_free_prev_nodemask;
+    }
+
+    if (set_mempolicy(mode, numa_nodemask_p(nodemask),
+                      numa_nodemask_size(nodemask) + 1) < 0) {
+        ucs_debug("set_mempolicy(policy=%d node=%d) failed: %m", mode, node);
+        status = UCS_ERR_IO_ERROR;
+        goto err_free_prev_nodemask;
+    }
+
+    ucs_trace("set thread numa policy %s node %d",
+              ucs_numa_policy_names[policy], node);
+    prev->mode     = prev_mode;
+    prev->nodemask = prev_nodemask;
+    numa_free_nodemask(nodemask);
+    return UCS_OK;
+
+err_free_prev_nodemask:
+    numa_free_nodemask(prev_nodemask);
+err_free_nodemask:
+    numa_free_nodemask(nodemask);
+    return status;
+}
+
+void ucs_numa_thread_policy_restore(ucs_numa_thread_policy_t *prev)
+{
+    struct bitmask *prev_nodemask = prev->nodemask;
+
+    if (prev_nodemask == NULL) {
+        return;
+    }
+
+    if (set_mempolicy(prev->mode, numa_nodemask_p(prev_nodemask),
+                      numa_nodemask_size(prev_nodemask) + 1) < 0) {
+        ucs_warn("failed to restore thread numa policy %d: %m", prev->mode);
+    }
+
+    numa_free_nodemask(prev_nodemask);
+    prev->nodemask = NULL;
+}
+
+#else
+
+unsigned ucs_numa_num_nodes(void)
+{
+    return 1;
+}
+
+int ucs_numa_current_node(void)
+{
+    return 0;
+}
+
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length, int node,
+                               ucs_numa_policy_t policy)
+{
+    return (policy == UCS_NUMA_POLICY_DEFAULT) ? UCS_OK : UCS_ERR_UNSUPPORTED;
+}
+
+ucs_status_t ucs_numa_thread_policy_set(int node, ucs_numa_policy_t policy,
+                                        ucs_numa_thread_policy_t *prev)
+{
+    prev->nodemask = NULL;
+    return (policy == UCS_NUMA_POLICY_DEFAULT) ? UCS_OK : UCS_ERR_UNSUPPORTED;
+}
+
+void ucs_numa_thread_policy_restore(ucs_numa_thread_policy_t *prev)
+{
+}
+
 #endif
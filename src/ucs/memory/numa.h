@@ -12,6 +12,7 @@
 #endif
 
 #include <ucs/debug/memtrack.h>
+#include <ucs/type/status.h>
 
 #if HAVE_NUMA
 #include <numaif.h>
@@ -56,10 +57,76 @@ typedef enum {
 } ucs_numa_policy_t;
 
 
+/**
+ * Memory policy of a thread, saved by @ref ucs_numa_thread_policy_set.
+ */
+typedef struct ucs_numa_thread_policy {
+    int                         mode;      /* Memory policy mode */
+    void                        *nodemask; /* Node mask of the policy, NULL if
+                                            * the policy was not changed */
+} ucs_numa_thread_policy_t;
+
+
 extern const char *ucs_numa_policy_names[];
 
 
 int ucs_numa_node_of_cpu(int cpu);
 
 
+/**
+ * @return Number of NUMA nodes configured in the system, or 1 if NUMA is not
+ *         supported.
+ */
+unsigned ucs_numa_num_nodes(void);
+
+
+/**
+ * @return NUMA node of the CPU the calling thread is currently running on, or
+ *         0 if NUMA is not supported.
+ */
+int ucs_numa_current_node(void);
+
+
+/**
+ * Set the memory policy of a memory range to a single NUMA node. Pages of the
+ * range which were already allocated are migrated to the node.
+ *
+ * @param [in]  address  Start of the memory range.
+ * @param [in]  length   Length of the memory range.
+ * @param [in]  node     NUMA node to place the memory on.
+ * @param [in]  policy   Memory policy to set. @ref UCS_NUMA_POLICY_DEFAULT
+ *                       leaves the range unchanged.
+ *
+ * @return UCS_OK if the policy was set, or an error code otherwise.
+ */
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length, int node,
+                               ucs_numa_policy_t policy);
+
+
+/**
+ * Set the memory policy of the calling thread to a single NUMA node, so pages
+ * which are faulted in by the thread, e.g while a memory region is allocated
+ * and initialized, are placed on that node. The previous policy has to be
+ * restored by @ref ucs_numa_thread_policy_restore.
+ *
+ * @param [in]  node     NUMA node to place the memory on.
+ * @param [in]  policy   Memory policy to set. @ref UCS_NUMA_POLICY_DEFAULT
+ *                       leaves the thread policy unchanged.
+ * @param [out] prev     Filled with the previous policy of the thread.
+ *
+ * @return UCS_OK if the policy was set, or an error code otherwise. In both
+ *         cases it's safe to pass @a prev to @ref ucs_numa_thread_policy_restore.
+ */
+ucs_status_t ucs_numa_thread_policy_set(int node, ucs_numa_policy_t policy,
+                                        ucs_numa_thread_policy_t *prev);
+
+
+/**
+ * Restore the memory policy of the calling thread.
+ *
+ * @param [in]  prev     Policy saved by @ref ucs_numa_thread_policy_set.
+ */
+void ucs_numa_thread_policy_restore(ucs_numa_thread_policy_t *prev);
+
+
 #endif
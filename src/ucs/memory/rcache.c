@@ -19,6 +19,7 @@
 #include <ucs/sys/sys.h>
 #include <ucs/type/spinlock.h>
 #include <ucm/api/ucm.h>
+#include <sched.h>
 
 #include "rcache.h"
 #include "rcache_int.h"
@@ -101,6 +102,21 @@ static ucs_stats_class_t ucs_rcache_stats_class = {
 static pthread_mutex_t ucs_rcache_global_list_lock = PTHREAD_MUTEX_INITIALIZER;
 static UCS_LIST_HEAD(ucs_rcache_global_list);
 
+/* Process-wide state of the per-thread lookup states */
+static struct {
+    pthread_mutex_t lock;        /* Protects the fields below, and the thread
+                                    tables against concurrent rcache cleanup
+                                    and thread exit */
+    int             key_created; /* Whether ucs_rcache_thread_key is valid */
+    uint64_t        used;        /* Bitmap of used thread table indices */
+} ucs_rcache_thread_global = {
+    .lock        = PTHREAD_MUTEX_INITIALIZER,
+    .key_created = 0,
+    .used        = 0
+};
+
+static pthread_key_t ucs_rcache_thread_key;
+
 static void __ucs_rcache_region_log(const char *file, int line, const char *function,
                                     ucs_log_level_t level, ucs_rcache_t *rcache,
                                     ucs_rcache_region_t *region, const char *fmt,
@@ -288,6 +304,197 @@ static void ucs_rcache_find_regions(ucs_rcache_t *rcache, ucs_pgt_addr_t from,
                              ucs_rcache_region_collect_callback, list);
 }
 
+/* Wait for all lock-free readers to leave the page table */
+static void ucs_rcache_readers_drain(ucs_rcache_t *rcache)
+{
+    ucs_rcache_reader_slot_t *slot;
+
+    /* The atomic operation orders the flag store before reading the slots,
+     * pairing with the slot increment done by the readers */
+    ucs_atomic_swap32(&rcache->writer, 1);
+    for (slot = rcache->readers;
+         slot < (rcache->readers + UCS_RCACHE_READER_SLOTS); ++slot) {
+        while (slot->count != 0) {
+            sched_yield();
+        }
+    }
+}
+
+static void ucs_rcache_pgt_wrlock(ucs_rcache_t *rcache)
+{
+    pthread_rwlock_wrlock(&rcache->pgt_lock);
+    ucs_rcache_readers_drain(rcache);
+}
+
+static UCS_F_ALWAYS_INLINE ucs_rcache_thread_t *
+ucs_rcache_thread_lookup(ucs_rcache_t *rcache)
+{
+    ucs_rcache_thread_table_t *table;
+
+    if (rcache->thread_index == UCS_RCACHE_THREAD_INDEX_NONE) {
+        return NULL;
+    }
+
+    table = pthread_getspecific(ucs_rcache_thread_key);
+    return (table == NULL) ? NULL : table->threads[rcache->thread_index];
+}
+
+static int ucs_rcache_pgt_trywrlock(ucs_rcache_t *rcache)
+{
+    ucs_rcache_thread_t *thread;
+
+    /* A memory event from within a lookup of the same thread would wait for
+     * itself to leave the page table */
+    thread = ucs_rcache_thread_lookup(rcache);
+    if ((thread != NULL) && thread->in_lookup) {
+        return 0;
+    }
+
+    if (pthread_rwlock_trywrlock(&rcache->pgt_lock)) {
+        return 0;
+    }
+
+    ucs_rcache_readers_drain(rcache);
+    return 1;
+}
+
+static void ucs_rcache_pgt_unlock(ucs_rcache_t *rcache)
+{
+    ucs_memory_cpu_store_fence();
+    rcache->writer = 0;
+    pthread_rwlock_unlock(&rcache->pgt_lock);
+}
+
+static void ucs_rcache_thread_cleanup(void *arg)
+{
+    ucs_rcache_thread_table_t *table = arg;
+    ucs_rcache_thread_t *thread;
+    ucs_rcache_t *rcache;
+    unsigned i;
+
+    pthread_mutex_lock(&ucs_rcache_thread_global.lock);
+    for (i = 0; i < UCS_RCACHE_THREAD_TABLE_SIZE; ++i) {
+        thread = table->threads[i];
+        if (thread == NULL) {
+            continue;
+        }
+
+        rcache = thread->rcache;
+        ucs_spin_lock(&rcache->lock);
+        ucs_list_del(&thread->list);
+        ucs_spin_unlock(&rcache->lock);
+        ucs_free(thread);
+    }
+    pthread_mutex_unlock(&ucs_rcache_thread_global.lock);
+
+    ucs_free(table);
+}
+
+/* Returns NULL if the lookup must take the page table lock */
+static ucs_rcache_thread_t *ucs_rcache_thread_get(ucs_rcache_t *rcache)
+{
+    ucs_rcache_thread_table_t *table;
+    ucs_rcache_thread_t *thread;
+    int ret;
+
+    if (rcache->thread_index == UCS_RCACHE_THREAD_INDEX_NONE) {
+        return NULL;
+    }
+
+    table = pthread_getspecific(ucs_rcache_thread_key);
+    if (ucs_likely(table != NULL)) {
+        thread = table->threads[rcache->thread_index];
+        if (ucs_likely(thread != NULL)) {
+            return thread;
+        }
+    } else {
+        table = ucs_calloc(1, sizeof(*table), "rcache_thread_table");
+        if (table == NULL) {
+            return NULL;
+        }
+
+        ret = pthread_setspecific(ucs_rcache_thread_key, table);
+        if (ret != 0) {
+            ucs_free(table);
+            return NULL;
+        }
+    }
+
+    thread = ucs_calloc(1, sizeof(*thread), "rcache_thread");
+    if (thread == NULL) {
+        return NULL;
+    }
+
+    thread->rcache   = rcache;
+    thread->entry_p  = &table->threads[rcache->thread_index];
+    *thread->entry_p = thread;
+
+    ucs_spin_lock(&rcache->lock);
+    thread->slot = &rcache->readers[rcache->next_slot++ %
+                                    UCS_RCACHE_READER_SLOTS];
+    ucs_list_add_tail(&rcache->threads, &thread->list);
+    ucs_spin_unlock(&rcache->lock);
+    return thread;
+}
+
+/*
+ * Take an index in the per-thread tables. If there is none, or the shared key
+ * cannot be created, the cache works without lock-free lookups.
+ */
+static void ucs_rcache_thread_index_init(ucs_rcache_t *rcache)
+{
+    int ret;
+
+    rcache->thread_index = UCS_RCACHE_THREAD_INDEX_NONE;
+
+    pthread_mutex_lock(&ucs_rcache_thread_global.lock);
+
+    /* All caches share one key, created on first use */
+    if (!ucs_rcache_thread_global.key_created) {
+        ret = pthread_key_create(&ucs_rcache_thread_key,
+                                 ucs_rcache_thread_cleanup);
+        if (ret != 0) {
+            ucs_debug("failed to create rcache thread key: %s", strerror(ret));
+            goto out_unlock;
+        }
+
+        ucs_rcache_thread_global.key_created = 1;
+    }
+
+    if (ucs_rcache_thread_global.used == UINT64_MAX) {
+        ucs_debug("rcache %s: too many caches with lock-free lookup (max: %d)",
+                  rcache->name, UCS_RCACHE_THREAD_TABLE_SIZE);
+        goto out_unlock;
+    }
+
+    rcache->thread_index = ucs_ffs64(~ucs_rcache_thread_global.used);
+    ucs_rcache_thread_global.used |= UCS_BIT(rcache->thread_index);
+
+out_unlock:
+    pthread_mutex_unlock(&ucs_rcache_thread_global.lock);
+}
+
+/* Release the states of all threads, and detach them from the thread tables,
+ * so the table index can be reused by another cache */
+static void ucs_rcache_thread_index_cleanup(ucs_rcache_t *rcache)
+{
+    ucs_rcache_thread_t *thread, *tmp;
+
+    if (rcache->thread_index == UCS_RCACHE_THREAD_INDEX_NONE) {
+        ucs_assert(ucs_list_is_empty(&rcache->threads));
+        return;
+    }
+
+    pthread_mutex_lock(&ucs_rcache_thread_global.lock);
+    ucs_list_for_each_safe(thread, tmp, &rcache->threads, list) {
+        *thread->entry_p = NULL;
+        ucs_list_del(&thread->list);
+        ucs_free(thread);
+    }
+    ucs_rcache_thread_global.used &= ~UCS_BIT(rcache->thread_index);
+    pthread_mutex_unlock(&ucs_rcache_thread_global.lock);
+}
+
 /* Lock must be held in write mode */
 static void ucs_mem_region_destroy_internal(ucs_rcache_t *rcache,
                                             ucs_rcache_region_t *region)
@@ -336,13 +543,13 @@ static inline void ucs_rcache_region_put_internal(ucs_rcache_t *rcache,
 
     /* Destroy region and de-register memory */
     if (flags & UCS_RCACHE_REGION_PUT_FLAG_TAKE_PGLOCK) {
-        pthread_rwlock_wrlock(&rcache->pgt_lock);
+        ucs_rcache_pgt_wrlock(rcache);
     }
 
     ucs_mem_region_destroy_internal(rcache, region);
 
     if (flags & UCS_RCACHE_REGION_PUT_FLAG_TAKE_PGLOCK) {
-        pthread_rwlock_unlock(&rcache->pgt_lock);
+        ucs_rcache_pgt_unlock(rcache);
     }
 }
 
@@ -365,6 +572,7 @@ static void ucs_rcache_region_invalidate(ucs_rcache_t *rcache,
                                    ucs_status_string(status));
         }
         region->flags &= ~UCS_RCACHE_REGION_FLAG_PGTABLE;
+        ++rcache->inv_gen;
     } else {
         ucs_assert(!(flags & UCS_RCACHE_REGION_PUT_FLAG_IN_PGTABLE));
     }
@@ -470,12 +678,12 @@ static void ucs_rcache_unmapped_callback(ucm_event_type_t event_type,
      * This way we avoid queuing endless events on the invalidation queue when
      * no rcache operations are performed to clean it.
      */
-    if (!pthread_rwlock_trywrlock(&rcache->pgt_lock)) {
+    if (ucs_rcache_pgt_trywrlock(rcache)) {
         ucs_rcache_invalidate_range(rcache, start, end,
                                     UCS_RCACHE_REGION_PUT_FLAG_ADD_TO_GC);
         UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_UNMAPS, 1);
         ucs_rcache_check_inv_queue(rcache, UCS_RCACHE_REGION_PUT_FLAG_ADD_TO_GC);
-        pthread_rwlock_unlock(&rcache->pgt_lock);
+        ucs_rcache_pgt_unlock(rcache);
         return;
     }
 
@@ -507,6 +715,7 @@ static void ucs_rcache_purge(ucs_rcache_t *rcache)
     ucs_list_head_init(&region_list);
     ucs_pgtable_purge(&rcache->pgtable, ucs_rcache_region_collect_callback,
                       &region_list);
+    ++rcache->inv_gen;
     ucs_list_for_each_safe(region, tmp, &region_list, list) {
         if (region->flags & UCS_RCACHE_REGION_FLAG_PGTABLE) {
             region->flags &= ~UCS_RCACHE_REGION_FLAG_PGTABLE;
@@ -659,7 +868,7 @@ ucs_rcache_create_region(ucs_rcache_t *rcache, void *address, size_t length,
     ucs_trace_func("rcache=%s, address=%p, length=%zu", rcache->name, address,
                    length);
 
-    pthread_rwlock_wrlock(&rcache->pgt_lock);
+    ucs_rcache_pgt_wrlock(rcache);
 
 retry:
     /* Align to page size */
@@ -763,7 +972,7 @@ retry:
 out_set_region:
     *region_p = region;
 out_unlock:
-    pthread_rwlock_unlock(&rcache->pgt_lock);
+    ucs_rcache_pgt_unlock(rcache);
     return status;
 }
 
@@ -773,38 +982,89 @@ void ucs_rcache_region_hold(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
     ucs_rcache_region_trace(rcache, region, "hold");
 }
 
+/*
+ * Look up a region without taking the page table lock. Must be called from
+ * within a reader slot, while no writer modifies the page table.
+ */
+static UCS_F_ALWAYS_INLINE ucs_rcache_region_t *
+ucs_rcache_lookup_unsafe(ucs_rcache_t *rcache, ucs_rcache_thread_t *thread,
+                         ucs_pgt_addr_t start, size_t length, int prot)
+{
+    ucs_rcache_region_t **cached;
+    ucs_pgt_region_t *pgt_region;
+    ucs_rcache_region_t *region;
+
+    /* Cached regions are valid as long as no region left the page table */
+    if (ucs_unlikely(thread->inv_gen != rcache->inv_gen)) {
+        memset(thread->regions, 0, sizeof(thread->regions));
+        thread->inv_gen = rcache->inv_gen;
+    }
+
+    cached = &thread->regions[(start / rcache->params.alignment) %
+                              UCS_RCACHE_THREAD_CACHE_SIZE];
+    region = *cached;
+    if ((region != NULL) && (start >= region->super.start) &&
+        ((start + length) <= region->super.end) &&
+        ucs_rcache_region_test(region, prot)) {
+        return region;
+    }
+
+    pgt_region = UCS_PROFILE_CALL(ucs_pgtable_lookup, &rcache->pgtable, start);
+    if (ucs_likely(pgt_region != NULL)) {
+        region = ucs_derived_of(pgt_region, ucs_rcache_region_t);
+        if (((start + length) <= region->super.end) &&
+            ucs_rcache_region_test(region, prot))
+        {
+            *cached = region;
+            return region;
+        }
+    }
+
+    return NULL;
+}
+
 ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
                             int prot, void *arg, ucs_rcache_region_t **region_p)
 {
     ucs_pgt_addr_t start = (uintptr_t)address;
-    ucs_pgt_region_t *pgt_region;
     ucs_rcache_region_t *region;
+    ucs_rcache_thread_t *thread;
 
     ucs_trace_func("rcache=%s, address=%p, length=%zu", rcache->name, address,
                    length);
 
-    pthread_rwlock_rdlock(&rcache->pgt_lock);
     UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_GETS, 1);
-    if (ucs_queue_is_empty(&rcache->inv_q)) {
-        pgt_region = UCS_PROFILE_CALL(ucs_pgtable_lookup, &rcache->pgtable,
-                                      start);
-        if (ucs_likely(pgt_region != NULL)) {
-            region = ucs_derived_of(pgt_region, ucs_rcache_region_t);
-            if (((start + length) <= region->super.end) &&
-                ucs_rcache_region_test(region, prot))
-            {
+
+    thread = ucs_rcache_thread_get(rcache);
+    if (ucs_likely(thread != NULL)) {
+        /* Enter the reader slot before checking for a writer; the writer sets
+         * the flag before waiting for the slots to become empty */
+        region            = NULL;
+        thread->in_lookup = 1;
+        ucs_atomic_fadd32(&thread->slot->count, 1);
+        if (ucs_likely(!rcache->writer &&
+                       ucs_queue_is_empty(&rcache->inv_q))) {
+            region = ucs_rcache_lookup_unsafe(rcache, thread, start, length,
+                                              prot);
+            if (ucs_likely(region != NULL)) {
+                /* The page table holds a reference, so the region can not be
+                 * released before leaving the reader slot */
                 ucs_rcache_region_hold(rcache, region);
-                ucs_rcache_region_validate_pfn(rcache, region);
-                *region_p = region;
-                UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_HITS_FAST, 1);
-                pthread_rwlock_unlock(&rcache->pgt_lock);
-                return UCS_OK;
             }
         }
+        ucs_atomic_fsub32(&thread->slot->count, 1);
+        thread->in_lookup = 0;
+
+        if (ucs_likely(region != NULL)) {
+            ucs_rcache_region_validate_pfn(rcache, region);
+            *region_p = region;
+            UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_HITS_FAST, 1);
+            return UCS_OK;
+        }
     }
-    pthread_rwlock_unlock(&rcache->pgt_lock);
 
     /* Fall back to slow version (with rw lock) in following cases:
+     * - page table is being modified
      * - invalidation list not empty
      * - could not find cached region
      * - found unregistered region
@@ -841,9 +1101,9 @@ static void ucs_rcache_before_fork(void)
              *   again on-demand.
              * - Other use cases shouldn't be affected
              */
-            pthread_rwlock_wrlock(&rcache->pgt_lock);
+            ucs_rcache_pgt_wrlock(rcache);
             ucs_rcache_invalidate_range(rcache, 0, UCS_PGT_ADDR_MAX, 0);
-            pthread_rwlock_unlock(&rcache->pgt_lock);
+            ucs_rcache_pgt_unlock(rcache);
         }
     }
     pthread_mutex_unlock(&ucs_rcache_global_list_lock);
@@ -949,11 +1209,18 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
 
     ucs_queue_head_init(&self->inv_q);
     ucs_list_head_init(&self->gc_list);
+    ucs_list_head_init(&self->threads);
+    memset(self->readers, 0, sizeof(self->readers));
+    self->writer    = 0;
+    self->inv_gen   = 0;
+    self->next_slot = 0;
+
+    ucs_rcache_thread_index_init(self);
 
     status = ucm_set_event_handler(params->ucm_events, params->ucm_event_priority,
                                    ucs_rcache_unmapped_callback, self);
     if (status != UCS_OK) {
-        goto err_destroy_mp;
+        goto err_cleanup_threads;
     }
 
     status = ucs_rcache_global_list_add(self);
@@ -966,7 +1233,8 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
 err_unset_event:
     ucm_unset_event_handler(self->params.ucm_events, ucs_rcache_unmapped_callback,
                             self);
-err_destroy_mp:
+err_cleanup_threads:
+    ucs_rcache_thread_index_cleanup(self);
     ucs_mpool_cleanup(&self->mp, 1);
 err_cleanup_pgtable:
     ucs_pgtable_cleanup(&self->pgtable);
@@ -991,6 +1259,7 @@ static UCS_CLASS_CLEANUP_FUNC(ucs_rcache_t)
     ucs_rcache_check_gc_list(self);
     ucs_rcache_purge(self);
 
+    ucs_rcache_thread_index_cleanup(self);
     ucs_mpool_cleanup(&self->mp, 1);
     ucs_pgtable_cleanup(&self->pgtable);
     ucs_spinlock_destroy(&self->lock);
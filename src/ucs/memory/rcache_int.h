@@ -7,7 +7,23 @@
 #ifndef UCS_REG_CACHE_INT_H_
 #define UCS_REG_CACHE_INT_H_
 
+#include <ucs/arch/cpu.h>
 #include <ucs/type/spinlock.h>
+#include <pthread.h>
+
+
+/* Number of reader slots used by the lock-free lookup path */
+#define UCS_RCACHE_READER_SLOTS         64
+
+/* Number of recently used regions kept in the per-thread lookup cache */
+#define UCS_RCACHE_THREAD_CACHE_SIZE    8
+
+/* Maximal number of registration caches which can have per-thread lookup
+ * states at the same time. Other caches always take the page table lock. */
+#define UCS_RCACHE_THREAD_TABLE_SIZE    64
+
+/* Thread table index of a cache without per-thread lookup states */
+#define UCS_RCACHE_THREAD_INDEX_NONE    UINT_MAX
 
 
 /* Names of rcache stats counters */
@@ -27,11 +43,58 @@ enum {
 };
 
 
+/**
+ * Counter of lock-free readers which are currently looking up the page table.
+ * Each thread is assigned one of the slots, and every slot resides on its own
+ * cache line, so readers running on different threads do not share any
+ * written memory.
+ */
+typedef struct ucs_rcache_reader_slot {
+    volatile uint32_t        count;    /**< Number of readers inside the lookup */
+    char                     pad[UCS_SYS_CACHE_LINE_SIZE - sizeof(uint32_t)];
+} ucs_rcache_reader_slot_t;
+
+
+/**
+ * Per-thread state of the lookup path.
+ */
+typedef struct ucs_rcache_thread {
+    ucs_rcache_reader_slot_t *slot;    /**< Reader slot of the thread */
+    int                      in_lookup; /**< Whether the thread is inside a
+                                             lock-free lookup */
+    uint64_t                 inv_gen;  /**< Invalidation generation of the
+                                            cached regions */
+    ucs_rcache_region_t      *regions[UCS_RCACHE_THREAD_CACHE_SIZE];
+                                       /**< Recently used regions, not
+                                            referenced by the cache */
+    ucs_rcache_t             *rcache;  /**< Owning registration cache */
+    struct ucs_rcache_thread **entry_p; /**< Entry in the thread's table */
+    ucs_list_link_t          list;     /**< Entry in ucs_rcache_t::threads */
+} ucs_rcache_thread_t;
+
+
+/**
+ * Lookup states of the current thread, indexed by ucs_rcache_t::thread_index.
+ * All registration caches share one thread-specific key.
+ */
+typedef struct ucs_rcache_thread_table {
+    ucs_rcache_thread_t      *threads[UCS_RCACHE_THREAD_TABLE_SIZE];
+} ucs_rcache_thread_table_t;
+
+
 struct ucs_rcache {
     ucs_rcache_params_t      params;   /**< rcache parameters (immutable) */
 
     pthread_rwlock_t         pgt_lock; /**< Protects the page table and all
-                                            regions whose refcount is 0 */
+                                            regions whose refcount is 0.
+                                            Page table lookups on the fast path
+                                            do not take it, they use
+                                            'readers' instead. */
+    volatile uint32_t        writer;   /**< Set while the page table is locked
+                                            for modification. Lock-free readers
+                                            fall back to the slow path. */
+    volatile uint64_t        inv_gen;  /**< Incremented whenever a region is
+                                            removed from the page table */
     ucs_pgtable_t            pgtable;  /**< page table to hold the regions */
 
 
@@ -51,11 +114,20 @@ struct ucs_rcache {
                                             memory events */
     ucs_list_link_t          gc_list;  /**< list for regions to destroy, regions
                                             could not be destroyed from memhook */
+    unsigned                 thread_index; /**< Index in the per-thread
+                                                 tables, or
+                                                 UCS_RCACHE_THREAD_INDEX_NONE */
+    ucs_list_link_t          threads;  /**< Per-thread states, protected by
+                                            'lock' */
+    unsigned                 next_slot; /**< Reader slot of the next thread */
 
     char                     *name;    /**< Name of the cache, for debug purpose */
     UCS_STATS_NODE_DECLARE(stats)
 
     ucs_list_link_t          list;     /**< list entry in global ucs_rcache list */
+
+    ucs_rcache_reader_slot_t readers[UCS_RCACHE_READER_SLOTS];
+                                       /**< Lock-free readers counters */
 };
 
 #endif
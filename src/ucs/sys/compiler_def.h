@@ -51,6 +51,9 @@
 /* Non-null return */
 #define UCS_F_NON_NULL __attribute__((nonnull))
 
+/* Compile the function for a specific instruction set, e.g "avx2" */
+#define UCS_F_TARGET(_target) __attribute__((target(_target)))
+
 /* Always inline the function */
 #ifdef __GNUC__
 #define UCS_F_ALWAYS_INLINE      inline __attribute__ ((always_inline))
@@ -199,7 +199,7 @@ const char *ucs_socket_getname_str(int fd, char *str, size_t max_size)
                             str, max_size);
 }
 
-static ucs_status_t ucs_socket_check_errno(int io_errno)
+ucs_status_t ucs_socket_check_errno(int io_errno)
 {
     if ((io_errno == EAGAIN) || (io_errno == EWOULDBLOCK) || (io_errno == EINTR)) {
         /* IO operation or connection establishment procedure was interrupted
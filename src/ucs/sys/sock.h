@@ -238,6 +238,17 @@ ucs_status_t ucs_socket_server_init(const struct sockaddr *saddr, socklen_t sock
 int ucs_socket_max_conn();
 
 
+/**
+ * Convert the error of a socket operation to the UCS status.
+ *
+ * @param [in]  io_errno          Error number of the failed operation.
+ *
+ * @return UCS_ERR_NO_PROGRESS if the operation has to be retried, otherwise
+ *         the error code which corresponds to @a io_errno.
+ */
+ucs_status_t ucs_socket_check_errno(int io_errno);
+
+
 /**
  * Non-blocking send operation sends data on the connected (or bound
  * connectionless) socket referred to by the file descriptor `fd`.
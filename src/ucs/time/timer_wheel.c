@@ -80,6 +80,29 @@ void __ucs_wtimer_add(ucs_twheel_t *t, ucs_wtimer_t *timer, ucs_time_t delta)
     t->count++;
 }
 
+int ucs_twheel_is_expired(ucs_twheel_t *t, ucs_time_t current_time)
+{
+    uint64_t slot, num_slots;
+
+    if (ucs_twheel_is_empty(t)) {
+        return 0;
+    }
+
+    /* Same slots as dispatched by __ucs_twheel_sweep() */
+    num_slots = (current_time - t->now) >> t->res_order;
+    if (ucs_unlikely(num_slots >= t->num_slots)) {
+        num_slots = t->num_slots - 1;
+    }
+
+    for (slot = 0; slot < num_slots; ++slot) {
+        if (!ucs_list_is_empty(&t->wheel[(t->current + slot) % t->num_slots])) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 void __ucs_twheel_sweep(ucs_twheel_t *t, ucs_time_t current_time)
 {
     ucs_wtimer_t *timer;
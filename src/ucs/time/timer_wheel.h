@@ -104,6 +104,15 @@ static UCS_F_ALWAYS_INLINE int ucs_twheel_is_empty(ucs_twheel_t *t)
     return !t->count;
 }
 
+
+/**
+ * Check if sweeping the timer wheel would dispatch any timers.
+ * @param twheel        Timer wheel to check.
+ * @param current_time  Current time to check the timers for.
+ * @return Nonzero if some timers expired by current_time.
+ */
+int ucs_twheel_is_expired(ucs_twheel_t *t, ucs_time_t current_time);
+
 /**
  * Add a one shot timer.
  *
@@ -563,6 +563,26 @@ enum uct_cb_flags {
 };
 
 
+/**
+ * @ingroup UCT_RESOURCE
+ * @brief Pending request flags.
+ *
+ * List of flags for @ref uct_ep_pending_add, which may be combined with
+ * @ref uct_cb_flags.
+ */
+enum uct_pending_flags {
+    UCT_PENDING_FLAG_PRIO_HIGH = UCS_BIT(3)  /**< The request is a small,
+                                                  latency-sensitive control
+                                                  operation. The transport may
+                                                  dispatch it before normal
+                                                  pending requests of the same
+                                                  and of other endpoints. Not
+                                                  for requests whose order
+                                                  relative to other operations
+                                                  on the endpoint matters. */
+};
+
+
 /**
  * @ingroup UCT_RESOURCE
  * @brief Mode in which to open the interface.
@@ -2758,7 +2778,8 @@ UCT_INLINE_API ucs_status_t uct_ep_atomic64_fetch(uct_ep_h ep, uct_atomic_op_t o
  *                    the "func" field.
  *                    After being passed to the function, the request is owned by UCT,
  *                    until the callback is called and returns UCS_OK.
- * @param [in]  flags Flags that control pending request processing (see @ref uct_cb_flags)
+ * @param [in]  flags Flags that control pending request processing (see
+ *                    @ref uct_cb_flags and @ref uct_pending_flags)
  *
  * @return UCS_OK       - request added to pending queue
  *         UCS_ERR_BUSY - request was not added to pending queue, because send
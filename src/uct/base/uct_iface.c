@@ -156,7 +156,16 @@ void uct_iface_mpool_empty_warn(uct_base_iface_t *iface, ucs_mpool_t *mp)
 
 ucs_status_t uct_iface_query(uct_iface_h iface, uct_iface_attr_t *iface_attr)
 {
-    return iface->ops.iface_query(iface, iface_attr);
+    uct_base_iface_t *base_iface = ucs_derived_of(iface, uct_base_iface_t);
+    ucs_status_t status;
+
+    status = iface->ops.iface_query(iface, iface_attr);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    uct_tuning_perf_apply(&base_iface->tuning, iface_attr);
+    return UCS_OK;
 }
 
 ucs_status_t uct_iface_get_device_address(uct_iface_h iface, uct_device_addr_t *addr)
@@ -475,6 +484,7 @@ UCS_CLASS_INIT_FUNC(uct_base_iface_t, uct_iface_ops_t *ops, uct_md_h md,
                                UCT_IFACE_PARAM_FIELD_ERR_HANDLER_ARG) ?
                               params->err_handler_arg : NULL;
     self->progress_flags    = 0;
+    memset(&self->tuning, 0, sizeof(self->tuning));
     uct_worker_progress_init(&self->prog);
 
     for (id = 0; id < UCT_AM_ID_MAX; ++id) {
@@ -8,6 +8,7 @@
 #define UCT_IFACE_H_
 
 #include "uct_worker.h"
+#include "uct_tuning.h"
 
 #include <uct/api/uct.h>
 #include <uct/base/uct_component.h>
@@ -223,6 +224,9 @@ typedef struct uct_base_iface {
         size_t              max_num_eps;
     } config;
 
+    uct_tuning_perf_t       tuning;           /* Measured performance from the
+                                                 tuning profile */
+
     UCS_STATS_NODE_DECLARE(stats)            /* Statistics */
 } uct_base_iface_t;
 
@@ -439,6 +443,101 @@ uct_pending_req_priv_arb_elem(uct_pending_req_t *req)
     } while (0)
 
 
+/**
+ * @return Arbiter priority class of a pending request added with @a flags.
+ */
+static UCS_F_ALWAYS_INLINE ucs_arbiter_prio_t
+uct_pending_req_prio(unsigned flags)
+{
+    return (flags & UCT_PENDING_FLAG_PRIO_HIGH) ? UCS_ARBITER_PRIO_HIGH :
+                                                  UCS_ARBITER_PRIO_NORMAL;
+}
+
+
+/**
+ * Private data of a pending request for TLs which keep an array of arbiter
+ * groups per endpoint, indexed by priority class.
+ */
+typedef struct {
+    uct_pending_req_priv_arb_t arb;
+    uint8_t                    prio; /* Priority class, ucs_arbiter_prio_t */
+} uct_pending_req_priv_arb_prio_t;
+
+
+/**
+ * @return Priority class of a pending request which was added by
+ *         @ref uct_pending_req_arb_prio_push.
+ */
+static UCS_F_ALWAYS_INLINE ucs_arbiter_prio_t
+uct_pending_req_priv_arb_prio(ucs_arbiter_elem_t *elem)
+{
+    return (ucs_arbiter_prio_t)ucs_container_of(elem,
+                                                uct_pending_req_priv_arb_prio_t,
+                                                arb.arb_elem)->prio;
+}
+
+
+/**
+ * Add a pending request to the arbiter group of its priority class, and
+ * schedule the group on the arbiter.
+ */
+static UCS_F_ALWAYS_INLINE void
+uct_pending_req_arb_prio_push(ucs_arbiter_t *arbiter,
+                              ucs_arbiter_group_t *groups,
+                              uct_pending_req_t *req, unsigned flags)
+{
+    uct_pending_req_priv_arb_prio_t *priv =
+        (uct_pending_req_priv_arb_prio_t*)&req->priv;
+    ucs_arbiter_prio_t prio               = uct_pending_req_prio(flags);
+
+    UCS_STATIC_ASSERT(sizeof(*priv) <= UCT_PENDING_REQ_PRIV_LEN);
+    priv->prio = prio;
+    uct_pending_req_arb_group_push(&groups[prio], req);
+    ucs_arbiter_group_schedule_prio(arbiter, &groups[prio], prio);
+}
+
+
+static inline void uct_pending_arb_groups_init(ucs_arbiter_group_t *groups)
+{
+    int prio;
+
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        ucs_arbiter_group_init(&groups[prio]);
+    }
+}
+
+
+static inline void uct_pending_arb_groups_cleanup(ucs_arbiter_group_t *groups)
+{
+    int prio;
+
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        ucs_arbiter_group_cleanup(&groups[prio]);
+    }
+}
+
+
+/**
+ * @return Whether all arbiter groups of the array are empty.
+ */
+static UCS_F_ALWAYS_INLINE int
+uct_pending_arb_groups_is_empty(ucs_arbiter_group_t *groups)
+{
+    return ucs_arbiter_group_is_empty(&groups[UCS_ARBITER_PRIO_NORMAL]) &&
+           ucs_arbiter_group_is_empty(&groups[UCS_ARBITER_PRIO_HIGH]);
+}
+
+
+/**
+ * Get the structure which contains the array of arbiter groups @a _member,
+ * from the group of a pending request added by @ref
+ * uct_pending_req_arb_prio_push.
+ */
+#define uct_pending_arb_group_container(_group, _elem, _type, _member) \
+    ucs_container_of((_group) - uct_pending_req_priv_arb_prio(_elem), _type, \
+                     _member)
+
+
 /**
  * Base structure for private data held inside a pending request for TLs
  * which use ucs_queue_t to progress pending requests.
@@ -224,6 +224,7 @@ ucs_status_t uct_iface_open(uct_md_h md, uct_worker_h worker,
                             const uct_iface_config_t *config,
                             uct_iface_h *iface_p)
 {
+    uct_base_iface_t *iface;
     uct_md_attr_t md_attr;
     ucs_status_t status;
     uct_tl_t *tl;
@@ -253,7 +254,22 @@ ucs_status_t uct_iface_open(uct_md_h md, uct_worker_h worker,
         return UCS_ERR_NO_DEVICE;
     }
 
-    return tl->iface_open(md, worker, params, config, iface_p);
+    status = tl->iface_open(md, worker, params, config, iface_p);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    if (params->open_mode & UCT_IFACE_OPEN_MODE_DEVICE) {
+        iface = ucs_derived_of(*iface_p, uct_base_iface_t);
+        if (uct_tuning_find(params->mode.device.tl_name,
+                            params->mode.device.dev_name, &iface->tuning)) {
+            ucs_debug("using measured performance for %s/%s from tuning "
+                      "profile", params->mode.device.tl_name,
+                      params->mode.device.dev_name);
+        }
+    }
+
+    return UCS_OK;
 }
 
 ucs_status_t uct_md_config_read(uct_component_h component,
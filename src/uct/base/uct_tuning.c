@@ -0,0 +1,203 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2020.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "uct_tuning.h"
+
+#include <ucs/config/global_opts.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/preprocessor.h>
+#include <ucs/sys/string.h>
+#include <ucs/type/spinlock.h>
+#include <string.h>
+
+
+/*
+ * Tuning profile file format: one line per transport device,
+ *
+ *   <tl_name>/<dev_name> overhead=<nsec> latency=<nsec> bandwidth=<MB/s>
+ *
+ * Empty lines and lines starting with '#' are ignored. Any of the values may
+ * be omitted, in which case the transport estimation is used.
+ */
+
+
+static struct {
+    ucs_recursive_spinlock_t lock;
+    char                     *path;    /* Path the profile was loaded from */
+    uct_tuning_entry_t       *entries;
+    unsigned                 count;
+} uct_tuning_profile;
+
+
+UCS_STATIC_INIT {
+    ucs_recursive_spinlock_init(&uct_tuning_profile.lock, 0);
+}
+
+UCS_STATIC_CLEANUP {
+    ucs_free(uct_tuning_profile.entries);
+    ucs_free(uct_tuning_profile.path);
+    ucs_recursive_spinlock_destroy(&uct_tuning_profile.lock);
+}
+
+static int uct_tuning_parse_line(char *line, const char *path, unsigned lineno,
+                                 uct_tuning_entry_t *entry)
+{
+    char *token, *saveptr, *value, *sep;
+    double number;
+
+    token = strtok_r(line, " \t\r\n", &saveptr);
+    if ((token == NULL) || (token[0] == '#')) {
+        return 0;
+    }
+
+    sep = strchr(token, '/');
+    if ((sep == NULL) || (sep == token) || (sep[1] == '\0')) {
+        ucs_warn("%s:%u: invalid transport device '%s'", path, lineno, token);
+        return 0;
+    }
+
+    *sep = '\0';
+    memset(entry, 0, sizeof(*entry));
+    ucs_strncpy_zero(entry->tl_name, token, sizeof(entry->tl_name));
+    ucs_strncpy_zero(entry->dev_name, sep + 1, sizeof(entry->dev_name));
+
+    while ((token = strtok_r(NULL, " \t\r\n", &saveptr)) != NULL) {
+        value = strchr(token, '=');
+        if ((value == NULL) || (sscanf(value + 1, "%lf", &number) != 1) ||
+            (number < 0)) {
+            ucs_warn("%s:%u: invalid value '%s'", path, lineno, token);
+            continue;
+        }
+
+        *value = '\0';
+        if (!strcmp(token, "overhead")) {
+            entry->perf.overhead  = number * 1e-9;
+        } else if (!strcmp(token, "latency")) {
+            entry->perf.latency   = number * 1e-9;
+        } else if (!strcmp(token, "bandwidth")) {
+            entry->perf.bandwidth = number * UCS_MBYTE;
+        } else {
+            ucs_warn("%s:%u: unknown parameter '%s'", path, lineno, token);
+        }
+    }
+
+    return 1;
+}
+
+static void uct_tuning_profile_load(const char *path)
+{
+    uct_tuning_entry_t entry, *entries;
+    unsigned lineno;
+    char line[256];
+    FILE *stream;
+
+    ucs_free(uct_tuning_profile.entries);
+    ucs_free(uct_tuning_profile.path);
+    uct_tuning_profile.entries = NULL;
+    uct_tuning_profile.count   = 0;
+    uct_tuning_profile.path    = ucs_strdup(path, "tuning_path");
+
+    if (!strlen(path)) {
+        return;
+    }
+
+    stream = fopen(path, "r");
+    if (stream == NULL) {
+        ucs_warn("failed to open tuning profile '%s': %m", path);
+        return;
+    }
+
+    lineno = 0;
+    while (fgets(line, sizeof(line), stream) != NULL) {
+        ++lineno;
+        if (!uct_tuning_parse_line(line, path, lineno, &entry)) {
+            continue;
+        }
+
+        entries = ucs_realloc(uct_tuning_profile.entries,
+                              sizeof(*entries) * (uct_tuning_profile.count + 1),
+                              "tuning_entries");
+        if (entries == NULL) {
+            ucs_error("failed to allocate tuning profile entry");
+            break;
+        }
+
+        entries[uct_tuning_profile.count++] = entry;
+        uct_tuning_profile.entries          = entries;
+    }
+
+    fclose(stream);
+    ucs_debug("loaded %u entries from tuning profile '%s'",
+              uct_tuning_profile.count, path);
+}
+
+int uct_tuning_find(const char *tl_name, const char *dev_name,
+                    uct_tuning_perf_t *perf)
+{
+    const char *path = ucs_global_opts.tuning_path;
+    uct_tuning_entry_t *entry;
+    int found;
+
+    memset(perf, 0, sizeof(*perf));
+    if ((uct_tuning_profile.path == NULL) && !strlen(path)) {
+        return 0;
+    }
+
+    found = 0;
+    ucs_recursive_spin_lock(&uct_tuning_profile.lock);
+
+    if ((uct_tuning_profile.path == NULL) ||
+        strcmp(uct_tuning_profile.path, path)) {
+        uct_tuning_profile_load(path);
+    }
+
+    for (entry = uct_tuning_profile.entries;
+         entry < uct_tuning_profile.entries + uct_tuning_profile.count;
+         ++entry) {
+        if (!strcmp(entry->tl_name, tl_name) &&
+            !strcmp(entry->dev_name, dev_name)) {
+            *perf = entry->perf;
+            found = 1;
+            /* later entries override earlier ones */
+        }
+    }
+
+    ucs_recursive_spin_unlock(&uct_tuning_profile.lock);
+    return found;
+}
+
+void uct_tuning_perf_apply(const uct_tuning_perf_t *perf,
+                           uct_iface_attr_t *iface_attr)
+{
+    if (perf->overhead > 0) {
+        iface_attr->overhead = perf->overhead;
+    }
+
+    if (perf->latency > 0) {
+        iface_attr->latency.c = perf->latency;
+    }
+
+    if (perf->bandwidth > 0) {
+        if (iface_attr->bandwidth.dedicated > 0) {
+            iface_attr->bandwidth.dedicated = perf->bandwidth;
+        } else {
+            iface_attr->bandwidth.shared    = perf->bandwidth;
+        }
+    }
+}
+
+void uct_tuning_entry_print(FILE *stream, const uct_tuning_entry_t *entry)
+{
+    fprintf(stream, "%s/%s overhead=%.1f latency=%.1f bandwidth=%.2f\n",
+            entry->tl_name, entry->dev_name, entry->perf.overhead * 1e9,
+            entry->perf.latency * 1e9, entry->perf.bandwidth / UCS_MBYTE);
+}
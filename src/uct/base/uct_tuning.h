@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2020.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCT_TUNING_H_
+#define UCT_TUNING_H_
+
+#include <uct/api/uct.h>
+#include <stdio.h>
+
+
+/**
+ * Measured performance of a transport device, loaded from the tuning profile
+ * (UCX_TUNING_PATH). A zero field means "not measured", and the value reported
+ * by the transport is used instead.
+ */
+typedef struct uct_tuning_perf {
+    double                 overhead;   /* Send overhead, seconds */
+    double                 latency;    /* One-way latency, seconds */
+    double                 bandwidth;  /* Bandwidth, bytes/second */
+} uct_tuning_perf_t;
+
+
+/**
+ * Tuning profile entry
+ */
+typedef struct uct_tuning_entry {
+    char                   tl_name[UCT_TL_NAME_MAX];
+    char                   dev_name[UCT_DEVICE_NAME_MAX];
+    uct_tuning_perf_t      perf;
+} uct_tuning_entry_t;
+
+
+/**
+ * Look up the measured performance of a transport device in the tuning
+ * profile. The profile is loaded on first use, and reloaded if the configured
+ * path has changed.
+ *
+ * @param [in]  tl_name   Transport name.
+ * @param [in]  dev_name  Device name.
+ * @param [out] perf      Filled with the measured performance, or with zeros
+ *                        if the device is not in the profile.
+ *
+ * @return Nonzero if the device was found in the profile.
+ */
+int uct_tuning_find(const char *tl_name, const char *dev_name,
+                    uct_tuning_perf_t *perf);
+
+
+/**
+ * Replace the estimated performance in interface attributes by the measured
+ * values which are set in @a perf.
+ */
+void uct_tuning_perf_apply(const uct_tuning_perf_t *perf,
+                           uct_iface_attr_t *iface_attr);
+
+
+/**
+ * Print a tuning profile entry in the format which is parsed by
+ * @ref uct_tuning_find.
+ */
+void uct_tuning_entry_print(FILE *stream, const uct_tuning_entry_t *entry);
+
+#endif
@@ -9,6 +9,10 @@
 #  include "config.h"
 #endif
 
+#ifndef _GNU_SOURCE
+#  define _GNU_SOURCE
+#endif
+
 #include "sm_iface.h"
 
 #include <uct/base/uct_md.h>
@@ -16,6 +20,13 @@
 #include <ucs/sys/sys.h>
 #include <ucs/arch/cpu.h>
 #include <ucs/type/init_once.h>
+#include <sys/prctl.h>
+#include <sys/uio.h>
+#include <string.h>
+
+#if HAVE_SYS_CAPABILITY_H
+#  include <sys/capability.h>
+#endif
 
 
 #define UCS_SM_IFACE_ADDR_FLAG_EXT UCS_BIT(63)
@@ -115,6 +126,111 @@ int uct_sm_iface_is_reachable(const uct_iface_h tl_iface,
     return ext_addr->ipc_ns == my_addr.ipc_ns;
 }
 
+#if HAVE_PROCESS_VM_READV
+static int uct_sm_iface_test_ptrace_scope()
+{
+    static const char *ptrace_scope_file = "/proc/sys/kernel/yama/ptrace_scope";
+    const char *extra_info_str;
+    int cma_supported;
+    char buffer[32];
+    ssize_t nread;
+    char *value;
+
+    /* Check if ptrace_scope allows using CMA.
+     * See https://www.kernel.org/doc/Documentation/security/Yama.txt
+     */
+    nread = ucs_read_file(buffer, sizeof(buffer) - 1, 1, "%s", ptrace_scope_file);
+    if (nread < 0) {
+        /* Cannot read file - assume that Yama security module is not enabled */
+        ucs_debug("could not read '%s' - assuming Yama security is not enforced",
+                  ptrace_scope_file);
+        return 1;
+    }
+
+    ucs_assert(nread < sizeof(buffer));
+    extra_info_str = "";
+    cma_supported  = 0;
+    buffer[nread]  = '\0';
+    value          = ucs_strtrim(buffer);
+    if(!strcmp(value, "0")) {
+        /* ptrace scope 0 allow attaching within same UID */
+        cma_supported = 1;
+    } else if (!strcmp(value, "1")) {
+        /* ptrace scope 1 allows attaching with explicit permission by prctl() */
+#if HAVE_DECL_PR_SET_PTRACER
+        int ret = prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+        if (!ret) {
+            extra_info_str = ", enabled PR_SET_PTRACER_ANY";
+            cma_supported  = 1;
+        } else {
+            extra_info_str = " and prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY) failed";
+        }
+#else
+        extra_info_str = " but no PR_SET_PTRACER";
+#endif
+    } else if (!strcmp(value, "2")) {
+        /* ptrace scope 2 means only a process with CAP_SYS_PTRACE can attach */
+#if HAVE_SYS_CAPABILITY_H
+        ucs_status_t status;
+        uint32_t ecap;
+
+        status = ucs_sys_get_proc_cap(&ecap);
+        UCS_STATIC_ASSERT(CAP_SYS_PTRACE < 32);
+        if ((status == UCS_OK) && (ecap & CAP_SYS_PTRACE)) {
+            extra_info_str = ", process has CAP_SYS_PTRACE";
+            cma_supported = 1;
+        } else
+#endif
+            extra_info_str = " but no CAP_SYS_PTRACE";
+    } else {
+        /* ptrace scope 3 means attach is completely disabled on the system */
+    }
+
+    /* coverity[result_independent_of_operands] */
+    ucs_log(cma_supported ? UCS_LOG_LEVEL_TRACE : UCS_LOG_LEVEL_DEBUG,
+            "ptrace_scope is %s%s, CMA is %ssupported",
+            value, extra_info_str, cma_supported ? "" : "un");
+    return cma_supported;
+}
+
+static int uct_sm_iface_test_writev()
+{
+    uint64_t test_dst       = 0;
+    uint64_t test_src       = 0;
+    struct iovec local_iov  = {.iov_base = &test_src,
+                               .iov_len = sizeof(test_src)};
+    struct iovec remote_iov = {.iov_base = &test_dst,
+                               .iov_len = sizeof(test_dst)};
+    ssize_t delivered;
+
+    delivered = process_vm_writev(getpid(), &local_iov, 1, &remote_iov, 1, 0);
+    if (delivered != sizeof(test_dst)) {
+        ucs_debug("CMA is disabled:"
+                  "process_vm_writev delivered %zu instead of %zu",
+                   delivered, sizeof(test_dst));
+        return 0;
+    }
+
+    return 1;
+}
+#endif
+
+int uct_sm_iface_cma_is_supported()
+{
+    static int cma_supported = -1;
+
+#if HAVE_PROCESS_VM_READV
+    if (cma_supported == -1) {
+        cma_supported = uct_sm_iface_test_writev() &&
+                        uct_sm_iface_test_ptrace_scope();
+    }
+#else
+    cma_supported = 0;
+#endif
+
+    return cma_supported;
+}
+
 ucs_status_t uct_sm_iface_fence(uct_iface_t *tl_iface, unsigned flags)
 {
     ucs_memory_cpu_fence();
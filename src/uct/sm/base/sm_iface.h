@@ -46,6 +46,14 @@ ucs_status_t uct_sm_iface_fence(uct_iface_t *tl_iface, unsigned flags);
 
 size_t uct_sm_iface_get_device_addr_len();
 
+/**
+ * Check if cross memory attach (process_vm_readv/writev) can be used to access
+ * the memory of other processes of the same user.
+ *
+ * @return Nonzero if CMA is supported.
+ */
+int uct_sm_iface_cma_is_supported();
+
 ucs_status_t uct_sm_ep_fence(uct_ep_t *tl_ep, unsigned flags);
 
 UCS_CLASS_DECLARE(uct_sm_iface_t, uct_iface_ops_t*, uct_md_h, uct_worker_h,
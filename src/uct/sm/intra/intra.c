@@ -0,0 +1,984 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "intra.h"
+
+#include <uct/sm/base/sm_ep.h>
+#include <uct/sm/self/self.h>
+#include <uct/base/uct_iov.inl>
+#include <ucs/arch/atomic.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/sys/string.h>
+#include <ucs/type/class.h>
+#include <sys/eventfd.h>
+#include <sched.h>
+
+
+/* Receive FIFOs of all interfaces of the process */
+static UCS_LIST_HEAD(uct_intra_fifo_list);
+static pthread_mutex_t uct_intra_fifo_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* Forward declarations */
+static uct_iface_ops_t uct_intra_iface_ops;
+
+static ucs_arbiter_cb_result_t
+uct_intra_ep_process_pending(ucs_arbiter_t *arbiter, ucs_arbiter_group_t *group,
+                             ucs_arbiter_elem_t *elem, void *arg);
+
+static void uct_intra_ep_pending_purge(uct_ep_h tl_ep,
+                                       uct_pending_purge_callback_t cb,
+                                       void *arg);
+
+
+static ucs_config_field_t uct_intra_iface_config_table[] = {
+    {"SM_", "", NULL,
+     ucs_offsetof(uct_intra_iface_config_t, super),
+     UCS_CONFIG_TYPE_TABLE(uct_sm_iface_config_table)},
+
+    {"FIFO_SIZE", "64",
+     "Size of the receive FIFO of the intra-process transport.",
+     ucs_offsetof(uct_intra_iface_config_t, fifo_size), UCS_CONFIG_TYPE_UINT},
+
+    {"SEG_SIZE", "8256",
+     "Size of receive buffers for copy-out sends.",
+     ucs_offsetof(uct_intra_iface_config_t, seg_size), UCS_CONFIG_TYPE_MEMUNITS},
+
+    {"FIFO_MAX_POLL", UCS_PP_MAKE_STRING(UCT_INTRA_IFACE_FIFO_MAX_POLL),
+     "Maximal number of receive completions to pick during RX poll",
+     ucs_offsetof(uct_intra_iface_config_t, fifo_max_poll), UCS_CONFIG_TYPE_ULUNITS},
+
+    UCT_IFACE_MPOOL_CONFIG_FIELDS("RX_", -1, 512, "receive",
+                                  ucs_offsetof(uct_intra_iface_config_t, mp), ""),
+
+    {NULL}
+};
+
+
+/*
+ * The identifier of the process is regenerated after fork(), so that the
+ * interfaces of a child process are never reachable from its parent and vice
+ * versa, even though they share the virtual addresses.
+ */
+static uct_intra_device_addr_t uct_intra_process_id()
+{
+    static uct_intra_device_addr_t process_id = 0;
+    static pid_t process_pid                  = -1;
+    uct_intra_device_addr_t id;
+
+    pthread_mutex_lock(&uct_intra_fifo_lock);
+    if (process_pid != getpid()) {
+        process_pid = getpid();
+        process_id  = ucs_generate_uuid((uintptr_t)&process_id);
+    }
+    id = process_id;
+    pthread_mutex_unlock(&uct_intra_fifo_lock);
+
+    return id;
+}
+
+static void uct_intra_fifo_release(uct_intra_fifo_t *fifo)
+{
+    if (ucs_atomic_fsub32(&fifo->refcount, 1) != 1) {
+        return;
+    }
+
+    close(fifo->signal_fd);
+    ucs_free(fifo);
+}
+
+static uct_intra_fifo_t *uct_intra_fifo_get(uct_intra_iface_addr_t id)
+{
+    uct_intra_fifo_t *fifo;
+
+    pthread_mutex_lock(&uct_intra_fifo_lock);
+    ucs_list_for_each(fifo, &uct_intra_fifo_list, list) {
+        if (fifo->id == id) {
+            ucs_atomic_add32(&fifo->refcount, 1);
+            goto out;
+        }
+    }
+    fifo = NULL;
+out:
+    pthread_mutex_unlock(&uct_intra_fifo_lock);
+    return fifo;
+}
+
+static UCS_F_ALWAYS_INLINE void*
+uct_intra_iface_desc_data(uct_intra_iface_t *iface, void *desc)
+{
+    return UCS_PTR_BYTE_OFFSET(desc, sizeof(uct_recv_desc_t) +
+                                     iface->rx_headroom);
+}
+
+static void uct_intra_iface_release_desc(uct_recv_desc_t *self, void *desc)
+{
+    ucs_mpool_put(UCS_PTR_BYTE_OFFSET(desc, -sizeof(uct_recv_desc_t)));
+}
+
+static void uct_intra_iface_assign_desc(uct_intra_iface_t *iface,
+                                        uct_intra_fifo_elem_t *elem, void *desc)
+{
+    elem->desc = desc;
+    elem->data = uct_intra_iface_desc_data(iface, desc);
+}
+
+static ucs_status_t uct_intra_iface_query(uct_iface_h tl_iface,
+                                          uct_iface_attr_t *attr)
+{
+    uct_intra_iface_t *iface = ucs_derived_of(tl_iface, uct_intra_iface_t);
+
+    uct_base_iface_query(&iface->super.super, attr);
+
+    attr->iface_addr_len          = sizeof(uct_intra_iface_addr_t);
+    attr->device_addr_len         = sizeof(uct_intra_device_addr_t);
+    attr->ep_addr_len             = 0;
+    attr->max_conn_priv           = 0;
+    attr->cap.flags               = UCT_IFACE_FLAG_CONNECT_TO_IFACE |
+                                    UCT_IFACE_FLAG_AM_SHORT         |
+                                    UCT_IFACE_FLAG_AM_BCOPY         |
+                                    UCT_IFACE_FLAG_PUT_SHORT        |
+                                    UCT_IFACE_FLAG_PUT_BCOPY        |
+                                    UCT_IFACE_FLAG_PUT_ZCOPY        |
+                                    UCT_IFACE_FLAG_GET_BCOPY        |
+                                    UCT_IFACE_FLAG_GET_ZCOPY        |
+                                    UCT_IFACE_FLAG_ATOMIC_CPU       |
+                                    UCT_IFACE_FLAG_PENDING          |
+                                    UCT_IFACE_FLAG_CB_SYNC          |
+                                    UCT_IFACE_FLAG_EP_CHECK;
+    attr->cap.event_flags         = UCT_IFACE_FLAG_EVENT_SEND_COMP  |
+                                    UCT_IFACE_FLAG_EVENT_RECV       |
+                                    UCT_IFACE_FLAG_EVENT_FD;
+
+    attr->cap.atomic32.op_flags   =
+    attr->cap.atomic64.op_flags   = UCS_BIT(UCT_ATOMIC_OP_ADD)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_AND)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_OR)      |
+                                    UCS_BIT(UCT_ATOMIC_OP_XOR);
+    attr->cap.atomic32.fop_flags  =
+    attr->cap.atomic64.fop_flags  = UCS_BIT(UCT_ATOMIC_OP_ADD)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_AND)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_OR)      |
+                                    UCS_BIT(UCT_ATOMIC_OP_XOR)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_SWAP)    |
+                                    UCS_BIT(UCT_ATOMIC_OP_CSWAP);
+
+    attr->cap.put.max_short       = UINT_MAX;
+    attr->cap.put.max_bcopy       = SIZE_MAX;
+    attr->cap.put.min_zcopy       = 0;
+    attr->cap.put.max_zcopy       = SIZE_MAX;
+    attr->cap.put.opt_zcopy_align = UCS_SYS_CACHE_LINE_SIZE;
+    attr->cap.put.align_mtu       = attr->cap.put.opt_zcopy_align;
+    attr->cap.put.max_iov         = UCT_SM_MAX_IOV;
+
+    attr->cap.get.max_bcopy       = SIZE_MAX;
+    attr->cap.get.min_zcopy       = 0;
+    attr->cap.get.max_zcopy       = SIZE_MAX;
+    attr->cap.get.opt_zcopy_align = UCS_SYS_CACHE_LINE_SIZE;
+    attr->cap.get.align_mtu       = attr->cap.get.opt_zcopy_align;
+    attr->cap.get.max_iov         = UCT_SM_MAX_IOV;
+
+    attr->cap.am.max_short        = iface->config.seg_size;
+    attr->cap.am.max_bcopy        = iface->config.seg_size;
+    attr->cap.am.min_zcopy        = 0;
+    attr->cap.am.max_zcopy        = 0;
+    attr->cap.am.opt_zcopy_align  = 1;
+    attr->cap.am.align_mtu        = attr->cap.am.opt_zcopy_align;
+    attr->cap.am.max_hdr          = 0;
+    attr->cap.am.max_iov          = 1;
+
+    /* no segment mapping and no kernel involvement - cheaper than MM */
+    attr->latency                 = ucs_linear_func_make(40e-9, 0); /* 40 ns */
+    attr->bandwidth.dedicated     = iface->super.config.bandwidth;
+    attr->bandwidth.shared        = 0;
+    attr->overhead                = 10e-9; /* 10 ns */
+    attr->priority                = 0;
+
+    return UCS_OK;
+}
+
+static ucs_status_t uct_intra_iface_get_device_address(uct_iface_h tl_iface,
+                                                       uct_device_addr_t *addr)
+{
+    *(uct_intra_device_addr_t*)addr = uct_intra_process_id();
+    return UCS_OK;
+}
+
+static ucs_status_t uct_intra_iface_get_address(uct_iface_h tl_iface,
+                                                uct_iface_addr_t *addr)
+{
+    uct_intra_iface_t *iface = ucs_derived_of(tl_iface, uct_intra_iface_t);
+
+    *(uct_intra_iface_addr_t*)addr = iface->recv_fifo->id;
+    return UCS_OK;
+}
+
+static int uct_intra_iface_is_reachable(const uct_iface_h tl_iface,
+                                        const uct_device_addr_t *dev_addr,
+                                        const uct_iface_addr_t *iface_addr)
+{
+    /* the peer must be in the same address space */
+    return (dev_addr != NULL) && (iface_addr != NULL) &&
+           (*(const uct_intra_device_addr_t*)dev_addr == uct_intra_process_id());
+}
+
+static ucs_status_t uct_intra_iface_flush(uct_iface_h tl_iface, unsigned flags,
+                                          uct_completion_t *comp)
+{
+    uct_intra_iface_t *iface = ucs_derived_of(tl_iface, uct_intra_iface_t);
+
+    if (comp != NULL) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    if (!ucs_arbiter_is_empty(&iface->arbiter)) {
+        UCT_TL_IFACE_STAT_FLUSH_WAIT(&iface->super.super);
+        return UCS_INPROGRESS;
+    }
+
+    ucs_memory_cpu_store_fence();
+    UCT_TL_IFACE_STAT_FLUSH(&iface->super.super);
+    return UCS_OK;
+}
+
+static UCS_F_ALWAYS_INLINE unsigned
+uct_intra_iface_poll_fifo(uct_intra_iface_t *iface)
+{
+    uct_intra_fifo_t *fifo = iface->recv_fifo;
+    uct_intra_fifo_elem_t *elem;
+    ucs_status_t status;
+    void *desc;
+
+    elem = &fifo->elems[iface->read_index & fifo->mask];
+    if (elem->seq != (iface->read_index + 1)) {
+        return 0;
+    }
+
+    /* make sure there is a descriptor to replace the one which could be
+     * passed to the user */
+    if (ucs_unlikely(iface->last_recv_desc == NULL)) {
+        UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
+                                 iface->last_recv_desc, return 0);
+    }
+
+    /* read the element contents after its sequence number */
+    ucs_memory_cpu_load_fence();
+
+    uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_RECV,
+                       elem->am_id, elem->data, elem->length, "RX: AM");
+
+    status = uct_iface_invoke_am(&iface->super.super, elem->am_id, elem->data,
+                                 elem->length, UCT_CB_PARAM_FLAG_DESC);
+    if (status == UCS_INPROGRESS) {
+        /* the user keeps the descriptor, hand it over without copying the
+         * payload and attach a spare descriptor to the element */
+        desc = UCS_PTR_BYTE_OFFSET(elem->desc, sizeof(uct_recv_desc_t));
+        uct_recv_desc(desc) = &iface->release_desc;
+        uct_intra_iface_assign_desc(iface, elem, iface->last_recv_desc);
+        UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
+                                 iface->last_recv_desc,
+                                 ucs_debug("recv mpool is empty"));
+    }
+
+    /* release the element to the senders for the next round */
+    ucs_memory_cpu_store_fence();
+    elem->seq = iface->read_index + fifo->mask + 1;
+    ++iface->read_index;
+    return 1;
+}
+
+static unsigned uct_intra_iface_progress(uct_iface_h tl_iface)
+{
+    uct_intra_iface_t *iface = ucs_derived_of(tl_iface, uct_intra_iface_t);
+    unsigned total_count     = 0;
+    unsigned count;
+
+    /* progress receive */
+    do {
+        count        = uct_intra_iface_poll_fifo(iface);
+        total_count += count;
+    } while ((count != 0) && (total_count < iface->config.fifo_max_poll));
+
+    /* progress the pending sends (if there are any) */
+    ucs_arbiter_dispatch(&iface->arbiter, 1, uct_intra_ep_process_pending,
+                         &total_count);
+
+    return total_count;
+}
+
+static ucs_status_t uct_intra_iface_event_fd_get(uct_iface_h tl_iface, int *fd_p)
+{
+    *fd_p = ucs_derived_of(tl_iface, uct_intra_iface_t)->recv_fifo->signal_fd;
+    return UCS_OK;
+}
+
+static ucs_status_t uct_intra_iface_event_arm(uct_iface_h tl_iface,
+                                              unsigned events)
+{
+    uct_intra_iface_t *iface = ucs_derived_of(tl_iface, uct_intra_iface_t);
+    uct_intra_fifo_t *fifo   = iface->recv_fifo;
+    uint64_t head, prev_head;
+    uint64_t dummy;
+    ssize_t ret;
+
+    /* sends are completed when posted, so only receives are waited for */
+    head = fifo->head;
+    if ((head & ~UCT_INTRA_FIFO_HEAD_FLAGS) != iface->read_index) {
+        /* there are elements which are being written or not read yet */
+        return UCS_ERR_BUSY;
+    }
+
+    /* make the next sender which claims a FIFO element signal the receiver */
+    if (!(head & UCT_INTRA_FIFO_HEAD_EVENT_ARMED)) {
+        prev_head = ucs_atomic_cswap64(&fifo->head, head,
+                                       head | UCT_INTRA_FIFO_HEAD_EVENT_ARMED);
+        if (prev_head != head) {
+            /* race with sender; need to retry */
+            return UCS_ERR_BUSY;
+        }
+    }
+
+    ret = read(fifo->signal_fd, &dummy, sizeof(dummy));
+    if (ret > 0) {
+        return UCS_ERR_BUSY;
+    } else if ((ret == -1) && (errno == EINTR)) {
+        return UCS_ERR_BUSY;
+    } else if ((ret == -1) && (errno != EAGAIN)) {
+        ucs_error("failed to read from intra iface event fd: %m");
+        return UCS_ERR_IO_ERROR;
+    }
+
+    return UCS_OK;
+}
+
+static UCS_CLASS_INIT_FUNC(uct_intra_iface_t, uct_md_h md, uct_worker_h worker,
+                           const uct_iface_params_t *params,
+                           const uct_iface_config_t *tl_config)
+{
+    uct_intra_iface_config_t *config = ucs_derived_of(tl_config,
+                                                      uct_intra_iface_config_t);
+    uct_intra_fifo_t *fifo;
+    ucs_status_t status;
+    size_t fifo_length;
+    unsigned i;
+    int ret;
+
+    UCT_CHECK_PARAM(params->field_mask & UCT_IFACE_PARAM_FIELD_OPEN_MODE,
+                    "UCT_IFACE_PARAM_FIELD_OPEN_MODE is not defined");
+    if (!(params->open_mode & UCT_IFACE_OPEN_MODE_DEVICE)) {
+        ucs_error("intra transport supports only UCT_IFACE_OPEN_MODE_DEVICE");
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    if ((config->fifo_size <= 1) || !ucs_is_pow2(config->fifo_size)) {
+        ucs_error("the intra FIFO size must be a power of two and bigger than 1");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if (config->seg_size <= sizeof(uint64_t)) {
+        ucs_error("the intra segment size (%zu) must be larger than %zu",
+                  config->seg_size, sizeof(uint64_t));
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    UCS_CLASS_CALL_SUPER_INIT(uct_sm_iface_t, &uct_intra_iface_ops, md, worker,
+                              params, tl_config);
+
+    self->config.fifo_size     = config->fifo_size;
+    self->config.seg_size      = config->seg_size;
+    self->config.fifo_max_poll = (config->fifo_max_poll == UCS_ULUNITS_AUTO) ?
+                                 UCT_INTRA_IFACE_FIFO_MAX_POLL :
+                                 ucs_max(ucs_min(config->fifo_max_poll,
+                                                 UINT_MAX), 1);
+    self->rx_headroom          = (params->field_mask &
+                                  UCT_IFACE_PARAM_FIELD_RX_HEADROOM) ?
+                                 params->rx_headroom : 0;
+    self->release_desc.cb      = uct_intra_iface_release_desc;
+    self->read_index           = 0;
+    self->pending_ep           = NULL;
+
+    fifo_length = sizeof(*fifo) +
+                  (self->config.fifo_size * sizeof(*fifo->elems));
+    ret         = ucs_posix_memalign((void**)&fifo, UCS_SYS_CACHE_LINE_SIZE,
+                                     fifo_length, "intra_recv_fifo");
+    if (ret != 0) {
+        ucs_error("failed to allocate intra receive FIFO");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    memset(fifo, 0, fifo_length);
+
+    fifo->signal_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fifo->signal_fd < 0) {
+        ucs_error("failed to create intra iface event fd: %m");
+        status = UCS_ERR_IO_ERROR;
+        goto err_free_fifo;
+    }
+
+    fifo->head      = 0;
+    fifo->id        = ucs_generate_uuid((uintptr_t)self);
+    fifo->refcount  = 1;
+    fifo->mask      = self->config.fifo_size - 1;
+    self->recv_fifo = fifo;
+
+    status = uct_iface_mpool_init(&self->super.super, &self->recv_desc_mp,
+                                  sizeof(uct_recv_desc_t) + self->rx_headroom +
+                                  self->config.seg_size,
+                                  sizeof(uct_recv_desc_t),
+                                  UCS_SYS_CACHE_LINE_SIZE, &config->mp,
+                                  config->mp.bufs_grow, NULL, "intra_recv_desc");
+    if (status != UCS_OK) {
+        goto err_close_fd;
+    }
+
+    self->last_recv_desc = ucs_mpool_get(&self->recv_desc_mp);
+    if (self->last_recv_desc == NULL) {
+        ucs_error("failed to get the first intra receive descriptor");
+        status = UCS_ERR_NO_RESOURCE;
+        goto err_cleanup_mpool;
+    }
+
+    for (i = 0; i < self->config.fifo_size; ++i) {
+        fifo->elems[i].seq = i;
+        fifo->elems[i].desc = ucs_mpool_get(&self->recv_desc_mp);
+        if (fifo->elems[i].desc == NULL) {
+            ucs_error("failed to allocate intra receive descriptor");
+            status = UCS_ERR_NO_RESOURCE;
+            goto err_free_descs;
+        }
+
+        uct_intra_iface_assign_desc(self, &fifo->elems[i],
+                                    fifo->elems[i].desc);
+    }
+
+    ucs_arbiter_init(&self->arbiter);
+
+    /* publish the FIFO to the other interfaces of the process */
+    pthread_mutex_lock(&uct_intra_fifo_lock);
+    ucs_list_add_tail(&uct_intra_fifo_list, &fifo->list);
+    pthread_mutex_unlock(&uct_intra_fifo_lock);
+
+    ucs_debug("created intra iface %p id 0x%"PRIx64" fifo_size %u seg_size %zu",
+              self, fifo->id, self->config.fifo_size, self->config.seg_size);
+    return UCS_OK;
+
+err_free_descs:
+    while (i-- > 0) {
+        ucs_mpool_put(fifo->elems[i].desc);
+    }
+    ucs_mpool_put(self->last_recv_desc);
+err_cleanup_mpool:
+    ucs_mpool_cleanup(&self->recv_desc_mp, 1);
+err_close_fd:
+    close(fifo->signal_fd);
+err_free_fifo:
+    ucs_free(fifo);
+    return status;
+}
+
+static UCS_CLASS_CLEANUP_FUNC(uct_intra_iface_t)
+{
+    uct_intra_fifo_t *fifo = self->recv_fifo;
+    uint64_t head, index;
+
+    uct_base_iface_progress_disable(&self->super.super.super,
+                                    UCT_PROGRESS_SEND | UCT_PROGRESS_RECV);
+
+    pthread_mutex_lock(&uct_intra_fifo_lock);
+    ucs_list_del(&fifo->list);
+    pthread_mutex_unlock(&uct_intra_fifo_lock);
+
+    /* prevent the senders from claiming more elements, and wait for the ones
+     * which were already claimed to be written, before releasing their
+     * descriptors */
+    head = ucs_atomic_for64(&fifo->head, UCT_INTRA_FIFO_HEAD_CLOSED) &
+           ~UCT_INTRA_FIFO_HEAD_FLAGS;
+    for (index = self->read_index; index < head; ++index) {
+        while (fifo->elems[index & fifo->mask].seq != (index + 1)) {
+            sched_yield();
+        }
+    }
+
+    if (head != self->read_index) {
+        ucs_debug("intra iface %p: dropping %"PRIu64" unread messages", self,
+                  head - self->read_index);
+    }
+
+    for (index = 0; index < self->config.fifo_size; ++index) {
+        ucs_mpool_put(fifo->elems[index].desc);
+    }
+
+    ucs_mpool_put(self->last_recv_desc);
+    ucs_mpool_cleanup(&self->recv_desc_mp, 1);
+    ucs_arbiter_cleanup(&self->arbiter);
+    uct_intra_fifo_release(fifo);
+}
+
+UCS_CLASS_DEFINE(uct_intra_iface_t, uct_sm_iface_t);
+
+static UCS_CLASS_DEFINE_DELETE_FUNC(uct_intra_iface_t, uct_iface_t);
+
+static UCS_CLASS_DEFINE_NEW_FUNC(uct_intra_iface_t, uct_iface_t, uct_md_h,
+                                 uct_worker_h, const uct_iface_params_t*,
+                                 const uct_iface_config_t*);
+
+static UCS_CLASS_INIT_FUNC(uct_intra_ep_t, const uct_ep_params_t *params)
+{
+    uct_intra_iface_t *iface = ucs_derived_of(params->iface, uct_intra_iface_t);
+
+    UCT_EP_PARAMS_CHECK_DEV_IFACE_ADDRS(params);
+    UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super.super);
+
+    self->fifo = uct_intra_fifo_get(
+                        *(const uct_intra_iface_addr_t*)params->iface_addr);
+    if (self->fifo == NULL) {
+        ucs_error("intra iface 0x%"PRIx64" does not exist",
+                  *(const uct_intra_iface_addr_t*)params->iface_addr);
+        return UCS_ERR_UNREACHABLE;
+    }
+
+    uct_pending_arb_groups_init(self->arb_group);
+    ucs_debug("intra: ep connected: %p, to fifo 0x%"PRIx64, self,
+              self->fifo->id);
+    return UCS_OK;
+}
+
+static UCS_CLASS_CLEANUP_FUNC(uct_intra_ep_t)
+{
+    uct_intra_ep_pending_purge(&self->super.super, NULL, NULL);
+    uct_pending_arb_groups_cleanup(self->arb_group);
+    uct_intra_fifo_release(self->fifo);
+}
+
+UCS_CLASS_DEFINE(uct_intra_ep_t, uct_base_ep_t);
+static UCS_CLASS_DEFINE_NEW_FUNC(uct_intra_ep_t, uct_ep_t, const uct_ep_params_t*);
+static UCS_CLASS_DEFINE_DELETE_FUNC(uct_intra_ep_t, uct_ep_t);
+
+static UCS_F_ALWAYS_INLINE int
+uct_intra_ep_has_tx_resources(uct_intra_ep_t *ep)
+{
+    uct_intra_fifo_t *fifo = ep->fifo;
+    uint64_t head          = fifo->head;
+    uint64_t index         = head & ~UCT_INTRA_FIFO_HEAD_FLAGS;
+
+    return (head & UCT_INTRA_FIFO_HEAD_CLOSED) ||
+           (fifo->elems[index & fifo->mask].seq == index);
+}
+
+/*
+ * Claim the next element of the peer's receive FIFO, write the message to its
+ * receive descriptor and publish it.
+ */
+static UCS_F_ALWAYS_INLINE ssize_t
+uct_intra_ep_am_common_send(uct_intra_ep_t *ep, uint8_t am_id, int is_short,
+                            uint64_t header, const void *payload,
+                            unsigned length, uct_pack_callback_t pack_cb,
+                            void *arg)
+{
+    uct_intra_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                              uct_intra_iface_t);
+    uct_intra_fifo_t *fifo   = ep->fifo;
+    uct_intra_fifo_elem_t *elem;
+    uint64_t head, prev_head, index;
+    uint64_t signal = 1;
+    int64_t diff;
+    size_t size;
+
+    UCT_CHECK_AM_ID(am_id);
+
+    if (ucs_unlikely(!uct_pending_arb_groups_is_empty(ep->arb_group) &&
+                     (iface->pending_ep != ep))) {
+        /* don't overtake the pending sends of this endpoint */
+        UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    head = fifo->head;
+    for (;;) {
+        if (ucs_unlikely(head & UCT_INTRA_FIFO_HEAD_CLOSED)) {
+            /* the receiver is gone, the message cannot be delivered */
+            ucs_debug("intra ep %p: fifo 0x%"PRIx64" is closed, failed to send "
+                      "am_id %d", ep, fifo->id, am_id);
+            return UCS_ERR_CONNECTION_RESET;
+        }
+
+        index = head & ~UCT_INTRA_FIFO_HEAD_FLAGS;
+        elem  = &fifo->elems[index & fifo->mask];
+        diff  = (int64_t)(elem->seq - index);
+        if (diff == 0) {
+            /* the element is free - try to claim it */
+            prev_head = ucs_atomic_cswap64(&fifo->head, head, index + 1);
+            if (prev_head == head) {
+                break;
+            }
+
+            head = prev_head;
+        } else if (diff < 0) {
+            /* the receiver did not release the element yet - FIFO is full */
+            UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
+            return UCS_ERR_NO_RESOURCE;
+        } else {
+            /* another sender claimed the element */
+            head = fifo->head;
+        }
+    }
+
+    if (is_short) {
+        uct_am_short_fill_data(elem->data, header, payload, length);
+        size = sizeof(header) + length;
+        uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_SEND, am_id,
+                           elem->data, size, "TX: AM_SHORT");
+        UCT_TL_EP_STAT_OP(&ep->super, AM, SHORT, size);
+    } else {
+        size = pack_cb(elem->data, arg);
+        ucs_assertv(size <= iface->config.seg_size, "size=%zu seg_size=%zu",
+                    size, iface->config.seg_size);
+        uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_SEND, am_id,
+                           elem->data, size, "TX: AM_BCOPY");
+        UCT_TL_EP_STAT_OP(&ep->super, AM, BCOPY, size);
+    }
+
+    elem->am_id  = am_id;
+    elem->length = size;
+
+    /* publish the element after its contents */
+    ucs_memory_cpu_store_fence();
+    elem->seq = index + 1;
+
+    if (ucs_unlikely(head & UCT_INTRA_FIFO_HEAD_EVENT_ARMED)) {
+        /* the receiver waits for an event, and the flag was cleared when
+         * the element was claimed */
+        if (write(fifo->signal_fd, &signal, sizeof(signal)) < 0) {
+            ucs_debug("failed to signal intra fifo 0x%"PRIx64": %m",
+                      fifo->id);
+        }
+    }
+
+    return is_short ? UCS_OK : size;
+}
+
+static ucs_status_t uct_intra_ep_am_short(uct_ep_h tl_ep, uint8_t id,
+                                          uint64_t header, const void *payload,
+                                          unsigned length)
+{
+    uct_intra_ep_t *ep       = ucs_derived_of(tl_ep, uct_intra_ep_t);
+    uct_intra_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_intra_iface_t);
+
+    UCT_CHECK_LENGTH(length + sizeof(header), 0, iface->config.seg_size,
+                     "am_short");
+    return (ucs_status_t)uct_intra_ep_am_common_send(ep, id, 1, header,
+                                                     payload, length, NULL,
+                                                     NULL);
+}
+
+static ssize_t uct_intra_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id,
+                                     uct_pack_callback_t pack_cb, void *arg,
+                                     unsigned flags)
+{
+    uct_intra_ep_t *ep = ucs_derived_of(tl_ep, uct_intra_ep_t);
+
+    return uct_intra_ep_am_common_send(ep, id, 0, 0, NULL, 0, pack_cb, arg);
+}
+
+/*
+ * Peers share the address space, so remote addresses are used as-is and the
+ * rkey is ignored. The dummy memory domain packs an empty rkey, so a peer may
+ * pass UCT_INVALID_RKEY instead of an unpacked one.
+ */
+static ucs_status_t uct_intra_ep_put_short(uct_ep_h tl_ep, const void *buffer,
+                                           unsigned length, uint64_t remote_addr,
+                                           uct_rkey_t rkey)
+{
+    return uct_sm_ep_put_short(tl_ep, buffer, length, remote_addr, 0);
+}
+
+static ssize_t uct_intra_ep_put_bcopy(uct_ep_h tl_ep, uct_pack_callback_t pack_cb,
+                                      void *arg, uint64_t remote_addr,
+                                      uct_rkey_t rkey)
+{
+    return uct_sm_ep_put_bcopy(tl_ep, pack_cb, arg, remote_addr, 0);
+}
+
+static ucs_status_t uct_intra_ep_get_bcopy(uct_ep_h tl_ep,
+                                           uct_unpack_callback_t unpack_cb,
+                                           void *arg, size_t length,
+                                           uint64_t remote_addr, uct_rkey_t rkey,
+                                           uct_completion_t *comp)
+{
+    return uct_sm_ep_get_bcopy(tl_ep, unpack_cb, arg, length, remote_addr, 0,
+                               comp);
+}
+
+static ucs_status_t uct_intra_ep_atomic32_post(uct_ep_h tl_ep, unsigned opcode,
+                                               uint32_t value,
+                                               uint64_t remote_addr,
+                                               uct_rkey_t rkey)
+{
+    return uct_sm_ep_atomic32_post(tl_ep, opcode, value, remote_addr, 0);
+}
+
+static ucs_status_t uct_intra_ep_atomic64_post(uct_ep_h tl_ep, unsigned opcode,
+                                               uint64_t value,
+                                               uint64_t remote_addr,
+                                               uct_rkey_t rkey)
+{
+    return uct_sm_ep_atomic64_post(tl_ep, opcode, value, remote_addr, 0);
+}
+
+static ucs_status_t uct_intra_ep_atomic32_fetch(uct_ep_h tl_ep,
+                                                uct_atomic_op_t opcode,
+                                                uint32_t value, uint32_t *result,
+                                                uint64_t remote_addr,
+                                                uct_rkey_t rkey,
+                                                uct_completion_t *comp)
+{
+    return uct_sm_ep_atomic32_fetch(tl_ep, opcode, value, result, remote_addr,
+                                    0, comp);
+}
+
+static ucs_status_t uct_intra_ep_atomic64_fetch(uct_ep_h tl_ep,
+                                                uct_atomic_op_t opcode,
+                                                uint64_t value, uint64_t *result,
+                                                uint64_t remote_addr,
+                                                uct_rkey_t rkey,
+                                                uct_completion_t *comp)
+{
+    return uct_sm_ep_atomic64_fetch(tl_ep, opcode, value, result, remote_addr,
+                                    0, comp);
+}
+
+static ucs_status_t uct_intra_ep_atomic_cswap32(uct_ep_h tl_ep,
+                                                uint32_t compare, uint32_t swap,
+                                                uint64_t remote_addr,
+                                                uct_rkey_t rkey,
+                                                uint32_t *result,
+                                                uct_completion_t *comp)
+{
+    return uct_sm_ep_atomic_cswap32(tl_ep, compare, swap, remote_addr, 0,
+                                    result, comp);
+}
+
+static ucs_status_t uct_intra_ep_atomic_cswap64(uct_ep_h tl_ep,
+                                                uint64_t compare, uint64_t swap,
+                                                uint64_t remote_addr,
+                                                uct_rkey_t rkey,
+                                                uint64_t *result,
+                                                uct_completion_t *comp)
+{
+    return uct_sm_ep_atomic_cswap64(tl_ep, compare, swap, remote_addr, 0,
+                                    result, comp);
+}
+
+static ucs_status_t uct_intra_ep_put_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                           size_t iovcnt, uint64_t remote_addr,
+                                           uct_rkey_t rkey,
+                                           uct_completion_t *comp)
+{
+    void *remote_ptr = (void*)remote_addr;
+    size_t total     = 0;
+    size_t iov_it, length;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, (size_t)UCT_SM_MAX_IOV, "uct_intra_ep_put_zcopy");
+
+    for (iov_it = 0; iov_it < iovcnt; ++iov_it) {
+        length = uct_iov_get_length(&iov[iov_it]);
+        memcpy(UCS_PTR_BYTE_OFFSET(remote_ptr, total), iov[iov_it].buffer,
+               length);
+        total += length;
+    }
+
+    ucs_trace_data("PUT_ZCOPY [length %zu] to 0x%"PRIx64, total, remote_addr);
+    UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), PUT, ZCOPY, total);
+    return UCS_OK;
+}
+
+static ucs_status_t uct_intra_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                           size_t iovcnt, uint64_t remote_addr,
+                                           uct_rkey_t rkey,
+                                           uct_completion_t *comp)
+{
+    void *remote_ptr = (void*)remote_addr;
+    size_t total     = 0;
+    size_t iov_it, length;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, (size_t)UCT_SM_MAX_IOV, "uct_intra_ep_get_zcopy");
+
+    for (iov_it = 0; iov_it < iovcnt; ++iov_it) {
+        length = uct_iov_get_length(&iov[iov_it]);
+        memcpy(iov[iov_it].buffer, UCS_PTR_BYTE_OFFSET(remote_ptr, total),
+               length);
+        total += length;
+    }
+
+    ucs_trace_data("GET_ZCOPY [length %zu] from 0x%"PRIx64, total,
+                   remote_addr);
+    UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), GET, ZCOPY, total);
+    return UCS_OK;
+}
+
+static ucs_status_t uct_intra_ep_pending_add(uct_ep_h tl_ep,
+                                             uct_pending_req_t *n,
+                                             unsigned flags)
+{
+    uct_intra_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_intra_iface_t);
+    uct_intra_ep_t *ep       = ucs_derived_of(tl_ep, uct_intra_ep_t);
+
+    /* check if resources became available */
+    if (uct_pending_arb_groups_is_empty(ep->arb_group) &&
+        uct_intra_ep_has_tx_resources(ep)) {
+        return UCS_ERR_BUSY;
+    }
+
+    uct_pending_req_arb_prio_push(&iface->arbiter, ep->arb_group, n, flags);
+    UCT_TL_EP_STAT_PEND(&ep->super);
+    return UCS_OK;
+}
+
+static ucs_arbiter_cb_result_t
+uct_intra_ep_process_pending(ucs_arbiter_t *arbiter, ucs_arbiter_group_t *group,
+                             ucs_arbiter_elem_t *elem, void *arg)
+{
+    uct_pending_req_t *req   = ucs_container_of(elem, uct_pending_req_t, priv);
+    uct_intra_ep_t *ep       = uct_pending_arb_group_container(group, elem,
+                                                               uct_intra_ep_t,
+                                                               arb_group);
+    uct_intra_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                              uct_intra_iface_t);
+    unsigned *count          = (unsigned*)arg;
+    ucs_status_t status;
+
+    if (!uct_intra_ep_has_tx_resources(ep)) {
+        return UCS_ARBITER_CB_RESULT_RESCHED_GROUP;
+    }
+
+    ucs_trace_data("progressing pending request %p", req);
+    iface->pending_ep = ep;
+    status            = req->func(req);
+    iface->pending_ep = NULL;
+    ucs_trace_data("status returned from progress pending: %s",
+                   ucs_status_string(status));
+
+    if (status == UCS_OK) {
+        (*count)++;
+        return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+    } else if (status == UCS_INPROGRESS) {
+        (*count)++;
+        return UCS_ARBITER_CB_RESULT_NEXT_GROUP;
+    } else {
+        return UCS_ARBITER_CB_RESULT_RESCHED_GROUP;
+    }
+}
+
+static ucs_arbiter_cb_result_t
+uct_intra_ep_arbiter_purge_cb(ucs_arbiter_t *arbiter, ucs_arbiter_group_t *group,
+                              ucs_arbiter_elem_t *elem, void *arg)
+{
+    uct_intra_ep_t *ep              = uct_pending_arb_group_container(
+                                              group, elem, uct_intra_ep_t,
+                                              arb_group);
+    uct_pending_req_t *req          = ucs_container_of(elem, uct_pending_req_t,
+                                                       priv);
+    uct_purge_cb_args_t *cb_args    = arg;
+    uct_pending_purge_callback_t cb = cb_args->cb;
+
+    if (cb != NULL) {
+        cb(req, cb_args->arg);
+    } else {
+        ucs_warn("ep=%p canceling user pending request %p", ep, req);
+    }
+    return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+}
+
+static void uct_intra_ep_pending_purge(uct_ep_h tl_ep,
+                                       uct_pending_purge_callback_t cb,
+                                       void *arg)
+{
+    uct_intra_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_intra_iface_t);
+    uct_intra_ep_t *ep       = ucs_derived_of(tl_ep, uct_intra_ep_t);
+    uct_purge_cb_args_t args = {cb, arg};
+    ucs_arbiter_prio_t prio;
+
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        ucs_arbiter_group_purge(&iface->arbiter, &ep->arb_group[prio],
+                                uct_intra_ep_arbiter_purge_cb, &args);
+    }
+}
+
+static ucs_status_t uct_intra_ep_flush(uct_ep_h tl_ep, unsigned flags,
+                                       uct_completion_t *comp)
+{
+    uct_intra_ep_t *ep = ucs_derived_of(tl_ep, uct_intra_ep_t);
+
+    /* all operations are completed when posted */
+    if (!uct_intra_ep_has_tx_resources(ep)) {
+        UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    ucs_memory_cpu_store_fence();
+    UCT_TL_EP_STAT_FLUSH(&ep->super);
+    return UCS_OK;
+}
+
+static ucs_status_t uct_intra_ep_check(uct_ep_h tl_ep, unsigned flags,
+                                       uct_completion_t *comp)
+{
+    uct_intra_ep_t *ep = ucs_derived_of(tl_ep, uct_intra_ep_t);
+
+    UCT_CHECK_PARAM(comp == NULL, "Unsupported completion on ep_check");
+    UCT_CHECK_PARAM(flags == 0, "Unsupported flags: %u", flags);
+
+    if (ep->fifo->head & UCT_INTRA_FIFO_HEAD_CLOSED) {
+        return uct_set_ep_failed(&UCS_CLASS_NAME(uct_intra_ep_t), tl_ep,
+                                 tl_ep->iface, UCS_ERR_ENDPOINT_TIMEOUT);
+    }
+
+    return UCS_OK;
+}
+
+static uct_iface_ops_t uct_intra_iface_ops = {
+    .ep_put_short             = uct_intra_ep_put_short,
+    .ep_put_bcopy             = uct_intra_ep_put_bcopy,
+    .ep_put_zcopy             = uct_intra_ep_put_zcopy,
+    .ep_get_bcopy             = uct_intra_ep_get_bcopy,
+    .ep_get_zcopy             = uct_intra_ep_get_zcopy,
+    .ep_am_short              = uct_intra_ep_am_short,
+    .ep_am_bcopy              = uct_intra_ep_am_bcopy,
+    .ep_atomic_cswap64        = uct_intra_ep_atomic_cswap64,
+    .ep_atomic64_post         = uct_intra_ep_atomic64_post,
+    .ep_atomic64_fetch        = uct_intra_ep_atomic64_fetch,
+    .ep_atomic_cswap32        = uct_intra_ep_atomic_cswap32,
+    .ep_atomic32_post         = uct_intra_ep_atomic32_post,
+    .ep_atomic32_fetch        = uct_intra_ep_atomic32_fetch,
+    .ep_pending_add           = uct_intra_ep_pending_add,
+    .ep_pending_purge         = uct_intra_ep_pending_purge,
+    .ep_flush                 = uct_intra_ep_flush,
+    .ep_fence                 = uct_sm_ep_fence,
+    .ep_check                 = uct_intra_ep_check,
+    .ep_create                = UCS_CLASS_NEW_FUNC_NAME(uct_intra_ep_t),
+    .ep_destroy               = UCS_CLASS_DELETE_FUNC_NAME(uct_intra_ep_t),
+    .iface_flush              = uct_intra_iface_flush,
+    .iface_fence              = uct_sm_iface_fence,
+    .iface_progress_enable    = uct_base_iface_progress_enable,
+    .iface_progress_disable   = uct_base_iface_progress_disable,
+    .iface_progress           = uct_intra_iface_progress,
+    .iface_event_fd_get       = uct_intra_iface_event_fd_get,
+    .iface_event_arm          = uct_intra_iface_event_arm,
+    .iface_close              = UCS_CLASS_DELETE_FUNC_NAME(uct_intra_iface_t),
+    .iface_query              = uct_intra_iface_query,
+    .iface_get_device_address = uct_intra_iface_get_device_address,
+    .iface_get_address        = uct_intra_iface_get_address,
+    .iface_is_reachable       = uct_intra_iface_is_reachable
+};
+
+/* The transport uses the dummy memory domain of the self component, and
+ * ignores rkeys, since remote addresses are used as-is */
+UCT_TL_DEFINE(&uct_self_component, intra, uct_sm_base_query_tl_devices,
+              uct_intra_iface_t, "INTRA_", uct_intra_iface_config_table,
+              uct_intra_iface_config_t);
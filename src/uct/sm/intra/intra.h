@@ -0,0 +1,106 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCT_INTRA_H
+#define UCT_INTRA_H
+
+#include <uct/sm/base/sm_iface.h>
+#include <uct/base/uct_iface.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/datastruct/arbiter.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/datastruct/mpool.h>
+
+
+/* Receive FIFO head flags, stored in the upper bits of the head index */
+#define UCT_INTRA_FIFO_HEAD_CLOSED       UCS_BIT(63) /* receiver is gone */
+#define UCT_INTRA_FIFO_HEAD_EVENT_ARMED  UCS_BIT(62) /* receiver waits for event */
+#define UCT_INTRA_FIFO_HEAD_FLAGS        (UCT_INTRA_FIFO_HEAD_CLOSED | \
+                                          UCT_INTRA_FIFO_HEAD_EVENT_ARMED)
+
+/* Default maximal number of receive completions to pick during RX poll */
+#define UCT_INTRA_IFACE_FIFO_MAX_POLL    16
+
+
+/* Device address: identifies the process (and its address space) */
+typedef uint64_t uct_intra_device_addr_t;
+
+
+/* Interface address: identifies the receive FIFO of the interface */
+typedef uint64_t uct_intra_iface_addr_t;
+
+
+typedef struct uct_intra_iface_config {
+    uct_sm_iface_config_t    super;
+    unsigned                 fifo_size;     /* Size of the receive FIFO */
+    size_t                   seg_size;      /* Maximal send size */
+    unsigned long            fifo_max_poll; /* Maximal RX completions per poll */
+    uct_iface_mpool_config_t mp;            /* Receive descriptors pool */
+} uct_intra_iface_config_t;
+
+
+/**
+ * Receive FIFO element. Senders claim the element whose sequence number is
+ * equal to the FIFO head, fill the receive descriptor which is currently
+ * attached to it, and publish it by setting the sequence number to head + 1.
+ * The receiver releases the element for the next round by setting the sequence
+ * number to the index of the element in the next round.
+ */
+typedef struct uct_intra_fifo_elem {
+    volatile uint64_t        seq;           /* Element sequence number */
+    uint8_t                  am_id;         /* Active message id */
+    uint32_t                 length;        /* Active message length */
+    void                     *desc;         /* Attached receive descriptor */
+    void                     *data;         /* Payload area of the descriptor */
+} UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE) uct_intra_fifo_elem_t;
+
+
+/**
+ * Multiple-producer single-consumer receive FIFO of an interface. The FIFO is
+ * reference counted by the owning interface and by the endpoints connected to
+ * it, so a sender never touches released memory even if the receiver closes
+ * its interface first.
+ */
+typedef struct uct_intra_fifo {
+    volatile uint64_t        head UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE);
+    uct_intra_iface_addr_t   id UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE);
+    volatile uint32_t        refcount;      /* Owning iface and connected eps */
+    int                      signal_fd;     /* Event fd of the receiver */
+    unsigned                 mask;          /* FIFO size - 1 */
+    ucs_list_link_t          list;          /* Entry in the process FIFO list */
+    uct_intra_fifo_elem_t    elems[0];
+} uct_intra_fifo_t;
+
+
+typedef struct uct_intra_iface {
+    uct_sm_iface_t           super;
+    uct_intra_fifo_t         *recv_fifo;      /* Receive FIFO */
+    uint64_t                 read_index;      /* Next FIFO element to read */
+    ucs_mpool_t              recv_desc_mp;    /* Receive descriptors */
+    void                     *last_recv_desc; /* Replaces a descriptor which
+                                                 was passed to the user */
+    uct_recv_desc_t          release_desc;
+    ucs_arbiter_t            arbiter;         /* Pending sends */
+    struct uct_intra_ep      *pending_ep;     /* Endpoint whose pending send
+                                                 is being dispatched */
+    unsigned                 rx_headroom;
+    struct {
+        unsigned             fifo_size;
+        size_t               seg_size;
+        unsigned             fifo_max_poll;
+    } config;
+} uct_intra_iface_t;
+
+
+typedef struct uct_intra_ep {
+    uct_base_ep_t            super;
+    uct_intra_fifo_t         *fifo;         /* Receive FIFO of the peer */
+    ucs_arbiter_group_t      arb_group[UCS_ARBITER_PRIO_LAST];
+                                            /* Pending sends, per priority
+                                               class */
+} uct_intra_ep_t;
+
+
+#endif
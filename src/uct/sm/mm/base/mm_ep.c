@@ -12,6 +12,7 @@
 #include "mm_ep.h"
 #include "uct/sm/base/sm_ep.h"
 
+#include <uct/base/uct_iov.inl>
 #include <ucs/arch/atomic.h>
 
 
@@ -19,9 +20,20 @@
 typedef enum {
     UCT_MM_SEND_AM_BCOPY,
     UCT_MM_SEND_AM_SHORT,
+    UCT_MM_SEND_AM_ZCOPY
 } uct_mm_send_op_t;
 
 
+/* AM Zcopy arguments */
+typedef struct {
+    const void       *header;
+    unsigned         header_length;
+    const uct_iov_t  *iov;
+    size_t           iovcnt;
+    uct_mm_pull_op_t *op;
+} uct_mm_ep_zcopy_args_t;
+
+
 /* Check if the resources on the remote peer are available for sending to it.
  * i.e. check if the remote receive FIFO has room in it.
  * return 1 if can send.
@@ -132,7 +144,7 @@ static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, const uct_ep_params_t *params)
     UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super.super);
 
     kh_init_inplace(uct_mm_remote_seg, &self->remote_segs);
-    ucs_arbiter_group_init(&self->arb_group);
+    uct_pending_arb_groups_init(self->arb_group);
 
     /* save remote md address */
     if (md->iface_addr_len > 0) {
@@ -163,6 +175,12 @@ static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, const uct_ep_params_t *params)
     self->signal.sockaddr = self->fifo_ctl->signal_sockaddr;
     self->keepalive       = NULL;
 
+    /* the peer can pull from this process only if it sees the same pids */
+    ucs_queue_head_init(&self->pull.ops);
+    self->pull.max        = (self->fifo_ctl->owner.pid_ns ==
+                             ucs_sys_get_ns(UCS_SYS_NS_TYPE_PID)) ?
+                            self->fifo_ctl->pull_max : 0;
+
     ucs_debug("created mm ep %p, connected to remote FIFO id 0x%"PRIx64,
               self, addr->fifo_seg_id);
 
@@ -178,10 +196,28 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_ep_t)
 {
     uct_mm_iface_t  *iface = ucs_derived_of(self->super.super.iface, uct_mm_iface_t);
     uct_mm_remote_seg_t remote_seg;
+    uct_mm_pull_op_t *op;
 
     ucs_free(self->keepalive);
     uct_mm_ep_pending_purge(&self->super.super, NULL, NULL);
 
+    if (!ucs_queue_is_empty(&self->pull.ops)) {
+        /* complete the operations which the receiver already passed and
+         * release their failure reports; if pulling the payload of the others
+         * fails, the report stays in the receiver's FIFO */
+        uct_mm_ep_progress_pull(self);
+    }
+
+    if (!ucs_queue_is_empty(&self->pull.ops)) {
+        ucs_queue_for_each_extract(op, &self->pull.ops, queue, 1) {
+            if (op->comp != NULL) {
+                uct_invoke_completion(op->comp, UCS_ERR_CANCELED);
+            }
+            ucs_mpool_put(op);
+        }
+        ucs_list_del(&self->pull.list);
+    }
+
     kh_foreach_value(&self->remote_segs, remote_seg, {
         uct_mm_iface_mapper_call(iface, mem_detach, &remote_seg);
     })
@@ -196,7 +232,7 @@ UCS_CLASS_DEFINE_DELETE_FUNC(uct_mm_ep_t, uct_ep_t);
 
 
 static inline ucs_status_t
-uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t head,
+uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t head, unsigned count,
                           uct_mm_fifo_element_t **elem)
 {
     uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface, uct_mm_iface_t);
@@ -205,9 +241,9 @@ uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t head,
 
     elem_index = head & iface->fifo_mask;
     *elem      = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems, elem_index);
-    new_head   = (head + 1) & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED;
+    new_head   = (head + count) & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED;
 
-    /* try to get ownership of the head element */
+    /* try to get ownership of the head element(s) */
     prev_head = ucs_atomic_cswap64(ucs_unaligned_ptr(&ep->fifo_ctl->head), head,
                                    new_head);
     if (prev_head != head) {
@@ -234,11 +270,15 @@ uct_mm_ep_am_common_send(uct_mm_send_op_t send_op, uct_mm_ep_t *ep,
                          uint64_t header, const void *payload,
                          uct_pack_callback_t pack_cb, void *arg)
 {
+    uct_mm_ep_zcopy_args_t *zcopy_args;
     uct_mm_fifo_element_t *elem;
+    uct_mm_pull_hdr_t *pull_hdr;
+    uct_mm_pull_iov_t *pull_iov;
     ucs_status_t status;
     void *base_address;
     uint8_t elem_flags;
     uint64_t head;
+    size_t i;
 
     UCT_CHECK_AM_ID(am_id);
 
@@ -246,7 +286,7 @@ retry:
     head = ep->fifo_ctl->head;
     /* check if there is room in the remote process's receive FIFO to write */
     if (!UCT_MM_EP_IS_ABLE_TO_SEND(head, ep->cached_tail, iface->config.fifo_size)) {
-        if (!ucs_arbiter_group_is_empty(&ep->arb_group)) {
+        if (!uct_pending_arb_groups_is_empty(ep->arb_group)) {
             /* pending isn't empty. don't send now to prevent out-of-order sending */
             UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
             return UCS_ERR_NO_RESOURCE;
@@ -261,7 +301,7 @@ retry:
         }
     }
 
-    status = uct_mm_ep_get_remote_elem(ep, head, &elem);
+    status = uct_mm_ep_get_remote_elem(ep, head, 1, &elem);
     if (status != UCS_OK) {
         ucs_assert(status == UCS_ERR_NO_RESOURCE);
         ucs_trace_poll("couldn't get an available FIFO element. retrying");
@@ -300,6 +340,37 @@ retry:
                            length, "TX: AM_BCOPY");
         UCT_TL_EP_STAT_OP(&ep->super, AM, BCOPY, length);
         break;
+    case UCT_MM_SEND_AM_ZCOPY:
+        /* describe the payload for the receiver to pull it */
+        zcopy_args       = arg;
+        pull_hdr         = (uct_mm_pull_hdr_t*)(elem + 1);
+        pull_hdr->pid    = iface->recv_fifo_ctl->owner.pid;
+        pull_hdr->length = length;
+        pull_hdr->iovcnt = zcopy_args->iovcnt;
+        pull_iov         = (uct_mm_pull_iov_t*)(pull_hdr + 1);
+        for (i = 0; i < zcopy_args->iovcnt; ++i) {
+            pull_iov[i].address = (uintptr_t)uct_iov_get_buffer(&zcopy_args->iov[i]);
+            pull_iov[i].length  = uct_iov_get_length(&zcopy_args->iov[i]);
+        }
+
+        memcpy(pull_iov + zcopy_args->iovcnt, zcopy_args->header,
+               zcopy_args->header_length);
+        elem_flags   = UCT_MM_FIFO_ELEM_FLAG_PULL;
+        elem->length = zcopy_args->header_length;
+
+        /* the operation completes when the receiver passes this element */
+        zcopy_args->op->index = head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED;
+        if (ucs_queue_is_empty(&ep->pull.ops)) {
+            ucs_list_add_tail(&iface->pull_eps, &ep->pull.list);
+        }
+        ucs_queue_push(&ep->pull.ops, &zcopy_args->op->queue);
+
+        uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_SEND, am_id,
+                           pull_iov + zcopy_args->iovcnt,
+                           zcopy_args->header_length, "TX: AM_ZCOPY");
+        UCT_TL_EP_STAT_OP(&ep->super, AM, ZCOPY,
+                          zcopy_args->header_length + length);
+        break;
     }
 
     elem->am_id = am_id;
@@ -324,6 +395,8 @@ retry:
         return UCS_OK;
     case UCT_MM_SEND_AM_BCOPY:
         return length;
+    case UCT_MM_SEND_AM_ZCOPY:
+        return UCS_INPROGRESS;
     default:
         return UCS_ERR_INVALID_PARAM;
     }
@@ -354,6 +427,233 @@ ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_
                                     NULL, pack_cb, arg);
 }
 
+static size_t uct_mm_ep_am_zcopy_pack(void *dest, void *arg)
+{
+    const uct_mm_ep_zcopy_args_t *zcopy_args = arg;
+    size_t length                            = zcopy_args->header_length;
+    size_t i;
+
+    memcpy(dest, zcopy_args->header, zcopy_args->header_length);
+    for (i = 0; i < zcopy_args->iovcnt; ++i) {
+        memcpy(UCS_PTR_BYTE_OFFSET(dest, length),
+               uct_iov_get_buffer(&zcopy_args->iov[i]),
+               uct_iov_get_length(&zcopy_args->iov[i]));
+        length += uct_iov_get_length(&zcopy_args->iov[i]);
+    }
+
+    return length;
+}
+
+/* Copy the payload of an AM Zcopy to the receive descriptors of consecutive
+ * FIFO elements, for a peer which cannot pull it from this process */
+static UCS_F_NOINLINE ucs_status_t
+uct_mm_ep_am_zcopy_multi(uct_mm_ep_t *ep, uint8_t am_id,
+                         const uct_mm_ep_zcopy_args_t *zcopy_args, size_t length)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                           uct_mm_iface_t);
+    unsigned num_elems    = ucs_div_round_up(length, iface->config.seg_size);
+    size_t iovcnt         = UCT_SM_MAX_IOV;
+    struct iovec iov[UCT_SM_MAX_IOV];
+    uct_mm_fifo_element_t *elem, *seg_elem;
+    uct_mm_multi_hdr_t *multi_hdr;
+    ucs_iov_iter_t iov_iter;
+    size_t offset, seg_length;
+    ucs_status_t status;
+    void *base_address;
+    uint64_t head;
+    unsigned i;
+
+    ucs_assert(num_elems <= (iface->config.fifo_size -
+                             iface->fifo_release_factor_mask));
+
+retry:
+    head = ep->fifo_ctl->head;
+    /* check if there is room for all elements in the remote FIFO */
+    if (!UCT_MM_EP_IS_ABLE_TO_SEND(head + num_elems - 1, ep->cached_tail,
+                                   iface->config.fifo_size)) {
+        if (!uct_pending_arb_groups_is_empty(ep->arb_group)) {
+            UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
+            return UCS_ERR_NO_RESOURCE;
+        }
+
+        uct_mm_ep_update_cached_tail(ep);
+        if (!UCT_MM_EP_IS_ABLE_TO_SEND(head + num_elems - 1, ep->cached_tail,
+                                       iface->config.fifo_size)) {
+            UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
+            return UCS_ERR_NO_RESOURCE;
+        }
+    }
+
+    status = uct_mm_ep_get_remote_elem(ep, head, num_elems, &elem);
+    if (status != UCS_OK) {
+        ucs_assert(status == UCS_ERR_NO_RESOURCE);
+        ucs_trace_poll("couldn't get %u available FIFO elements. retrying",
+                       num_elems);
+        goto retry;
+    }
+
+    ucs_iov_iter_init(&iov_iter);
+    uct_iov_to_iovec(iov, &iovcnt, zcopy_args->iov, zcopy_args->iovcnt,
+                     SIZE_MAX, &iov_iter);
+
+    /* fill the receive descriptors of all elements */
+    multi_hdr = (uct_mm_multi_hdr_t*)(elem + 1);
+    offset    = 0;
+    for (i = 0; i < num_elems; ++i) {
+        seg_elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems,
+                                              (head + i) & iface->fifo_mask);
+        status   = uct_mm_ep_get_remote_seg(ep, seg_elem->desc.seg_id,
+                                            seg_elem->desc.seg_size,
+                                            &base_address);
+        if (ucs_unlikely(status != UCS_OK)) {
+            return status;
+        }
+
+        seg_length = ucs_iov_copy(iov, iovcnt, offset,
+                                  UCS_PTR_BYTE_OFFSET(base_address,
+                                                      seg_elem->desc.offset),
+                                  iface->config.seg_size, UCS_IOV_COPY_TO_BUF);
+        offset    += seg_length;
+        if (i == 0) {
+            multi_hdr->length = seg_length;
+        } else {
+            seg_elem->length  = seg_length;
+            seg_elem->am_id   = am_id;
+        }
+    }
+
+    ucs_assert(offset == length);
+
+    multi_hdr->num_elems = num_elems;
+    memcpy(multi_hdr + 1, zcopy_args->header, zcopy_args->header_length);
+    elem->length         = zcopy_args->header_length;
+    elem->am_id          = am_id;
+
+    /* the receiver consumes the following elements together with the first
+     * one, but their owner bits have to be valid after a FIFO wraparound */
+    for (i = 1; i < num_elems; ++i) {
+        seg_elem        = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems,
+                                                     (head + i) &
+                                                     iface->fifo_mask);
+        seg_elem->flags = ((head + i) & iface->config.fifo_size) ?
+                          UCT_MM_FIFO_ELEM_FLAG_OWNER : 0;
+    }
+
+    uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_SEND, am_id,
+                       multi_hdr + 1, zcopy_args->header_length,
+                       "TX: AM_ZCOPY");
+    UCT_TL_EP_STAT_OP(&ep->super, AM, ZCOPY,
+                      zcopy_args->header_length + length);
+
+    /* make the first element visible to the receiver after all others */
+    ucs_memory_cpu_store_fence();
+    elem->flags = UCT_MM_FIFO_ELEM_FLAG_MULTI |
+                  ((head & iface->config.fifo_size) ?
+                   UCT_MM_FIFO_ELEM_FLAG_OWNER : 0);
+
+    if (ucs_unlikely(head & UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED)) {
+        uct_mm_ep_signal_remote(ep);
+    }
+
+    return UCS_OK;
+}
+
+ucs_status_t uct_mm_ep_am_zcopy(uct_ep_h tl_ep, uint8_t id, const void *header,
+                                unsigned header_length, const uct_iov_t *iov,
+                                size_t iovcnt, unsigned flags,
+                                uct_completion_t *comp)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_mm_iface_t);
+    uct_mm_ep_t *ep       = ucs_derived_of(tl_ep, uct_mm_ep_t);
+    size_t length         = uct_iov_total_length(iov, iovcnt);
+    uct_mm_ep_zcopy_args_t zcopy_args;
+    ssize_t status;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, iface->config.zcopy_max_iov, "uct_mm_ep_am_zcopy");
+    UCT_CHECK_LENGTH(header_length, 0, iface->config.zcopy_max_hdr,
+                     "am_zcopy header");
+    UCT_CHECK_LENGTH(length, 0, iface->config.zcopy_max, "am_zcopy");
+
+    zcopy_args.header        = header;
+    zcopy_args.header_length = header_length;
+    zcopy_args.iov           = iov;
+    zcopy_args.iovcnt        = iovcnt;
+
+    if (ucs_unlikely(length > ep->pull.max)) {
+        /* the peer cannot pull the payload, copy it to the receive
+         * descriptor(s) */
+        if ((header_length + length) > iface->config.seg_size) {
+            return uct_mm_ep_am_zcopy_multi(ep, id, &zcopy_args, length);
+        }
+
+        status = uct_mm_ep_am_common_send(UCT_MM_SEND_AM_BCOPY, ep, iface, id,
+                                          0, 0, NULL, uct_mm_ep_am_zcopy_pack,
+                                          &zcopy_args);
+        return (status < 0) ? (ucs_status_t)status : UCS_OK;
+    }
+
+    zcopy_args.op = ucs_mpool_get_inline(&iface->pull_op_mp);
+    if (ucs_unlikely(zcopy_args.op == NULL)) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    zcopy_args.op->comp = comp;
+    status = uct_mm_ep_am_common_send(UCT_MM_SEND_AM_ZCOPY, ep, iface, id,
+                                      length, 0, NULL, NULL, &zcopy_args);
+    if (ucs_unlikely(status != UCS_INPROGRESS)) {
+        ucs_mpool_put_inline(zcopy_args.op);
+    }
+
+    return (ucs_status_t)status;
+}
+
+/* Check whether the receiver reported a failure to pull the payload of the
+ * operation, and release the report. Must be called after the receiver passed
+ * the element of the operation. */
+static ucs_status_t
+uct_mm_ep_pull_status(uct_mm_ep_t *ep, const uct_mm_pull_op_t *op)
+{
+    uint64_t failed_index = op->index + 1;
+    unsigned i;
+
+    for (i = 0; i < UCT_MM_FIFO_PULL_FAILED_MAX; ++i) {
+        if (ucs_unlikely(ep->fifo_ctl->pull_failed[i] == failed_index)) {
+            ep->fifo_ctl->pull_failed[i] = 0;
+            return UCS_ERR_IO_ERROR;
+        }
+    }
+
+    return UCS_OK;
+}
+
+unsigned uct_mm_ep_progress_pull(uct_mm_ep_t *ep)
+{
+    unsigned count = 0;
+    uct_mm_pull_op_t *op;
+    uint64_t pull_index;
+    ucs_status_t status;
+
+    pull_index = ep->fifo_ctl->pull_index;
+    ucs_memory_cpu_load_fence();
+
+    ucs_queue_for_each_extract(op, &ep->pull.ops, queue,
+                               (int64_t)(pull_index - op->index) > 0) {
+        status = uct_mm_ep_pull_status(ep, op);
+        if (op->comp != NULL) {
+            uct_invoke_completion(op->comp, status);
+        }
+        ucs_mpool_put_inline(op);
+        ++count;
+    }
+
+    if (ucs_queue_is_empty(&ep->pull.ops)) {
+        ucs_list_del(&ep->pull.list);
+    }
+
+    return count;
+}
+
 static inline int uct_mm_ep_has_tx_resources(uct_mm_ep_t *ep)
 {
     uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface, uct_mm_iface_t);
@@ -369,15 +669,12 @@ ucs_status_t uct_mm_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *n,
 
     /* check if resources became available */
     if (uct_mm_ep_has_tx_resources(ep)) {
-        ucs_assert(ucs_arbiter_group_is_empty(&ep->arb_group));
+        ucs_assert(uct_pending_arb_groups_is_empty(ep->arb_group));
         return UCS_ERR_BUSY;
     }
 
-    UCS_STATIC_ASSERT(sizeof(uct_pending_req_priv_arb_t) <=
-                      UCT_PENDING_REQ_PRIV_LEN);
-    uct_pending_req_arb_group_push(&ep->arb_group, n);
-    /* add the ep's group to the arbiter */
-    ucs_arbiter_group_schedule(&iface->arbiter, &ep->arb_group);
+    /* add the request to the ep's group, and the group to the arbiter */
+    uct_pending_req_arb_prio_push(&iface->arbiter, ep->arb_group, n, flags);
     UCT_TL_EP_STAT_PEND(&ep->super);
 
     return UCS_OK;
@@ -389,7 +686,9 @@ ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
                                                   void *arg)
 {
     uct_pending_req_t *req = ucs_container_of(elem, uct_pending_req_t, priv);
-    uct_mm_ep_t *ep        = ucs_container_of(group, uct_mm_ep_t, arb_group);
+    uct_mm_ep_t *ep        = uct_pending_arb_group_container(group, elem,
+                                                             uct_mm_ep_t,
+                                                             arb_group);
     unsigned *count        = (unsigned*)arg;
     ucs_status_t status;
 
@@ -426,8 +725,10 @@ static ucs_arbiter_cb_result_t uct_mm_ep_abriter_purge_cb(ucs_arbiter_t *arbiter
                                                           ucs_arbiter_elem_t *elem,
                                                           void *arg)
 {
-    uct_mm_ep_t *ep                 = ucs_container_of(group, uct_mm_ep_t,
-                                                       arb_group);
+    uct_mm_ep_t *ep                 = uct_pending_arb_group_container(group,
+                                                                      elem,
+                                                                      uct_mm_ep_t,
+                                                                      arb_group);
     uct_pending_req_t *req          = ucs_container_of(elem, uct_pending_req_t,
                                                        priv);
     uct_purge_cb_args_t *cb_args    = arg;
@@ -447,18 +748,23 @@ void uct_mm_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
     uct_mm_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_mm_iface_t);
     uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
     uct_purge_cb_args_t  args = {cb, arg};
+    ucs_arbiter_prio_t prio;
 
-    ucs_arbiter_group_purge(&iface->arbiter, &ep->arb_group,
-                            uct_mm_ep_abriter_purge_cb, &args);
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        ucs_arbiter_group_purge(&iface->arbiter, &ep->arb_group[prio],
+                                uct_mm_ep_abriter_purge_cb, &args);
+    }
 }
 
 ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
                              uct_completion_t *comp)
 {
-    uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
+    uct_mm_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_mm_iface_t);
+    uct_mm_ep_t *ep       = ucs_derived_of(tl_ep, uct_mm_ep_t);
+    uct_mm_pull_op_t *op;
 
     if (!uct_mm_ep_has_tx_resources(ep)) {
-        if (!ucs_arbiter_group_is_empty(&ep->arb_group)) {
+        if (!uct_pending_arb_groups_is_empty(ep->arb_group)) {
             return UCS_ERR_NO_RESOURCE;
         } else {
             uct_mm_ep_update_cached_tail(ep);
@@ -468,6 +774,25 @@ ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
         }
     }
 
+    if (!ucs_queue_is_empty(&ep->pull.ops)) {
+        /* wait for the peer to pull the payload of all zcopy sends */
+        if (comp != NULL) {
+            op = ucs_mpool_get_inline(&iface->pull_op_mp);
+            if (op == NULL) {
+                return UCS_ERR_NO_MEMORY;
+            }
+
+            op->index = ucs_queue_tail_elem_non_empty(&ep->pull.ops,
+                                                      uct_mm_pull_op_t,
+                                                      queue)->index;
+            op->comp  = comp;
+            ucs_queue_push(&ep->pull.ops, &op->queue);
+        }
+
+        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+        return UCS_INPROGRESS;
+    }
+
     ucs_memory_cpu_store_fence();
     UCT_TL_EP_STAT_FLUSH(&ep->super);
     return UCS_OK;
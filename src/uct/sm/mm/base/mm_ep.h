@@ -25,6 +25,16 @@ typedef struct uct_mm_keepalive_info {
     char       proc[];    /* Process owner proc dir */
 } uct_mm_keepalive_info_t;
 
+/**
+ * Outstanding AM Zcopy operation, completed when the peer pulled its payload
+ */
+typedef struct uct_mm_pull_op {
+    ucs_queue_elem_t           queue;       /* entry in the ep queue */
+    uint64_t                   index;       /* FIFO index of the operation */
+    uct_completion_t           *comp;       /* user completion, can be NULL */
+} uct_mm_pull_op_t;
+
+
 /**
  * MM transport endpoint
  */
@@ -44,7 +54,9 @@ typedef struct uct_mm_ep {
 
     void                       *remote_iface_addr; /* remote md-specific address, can be NULL */
 
-    ucs_arbiter_group_t        arb_group;   /* the group that holds this ep's pending operations */
+    ucs_arbiter_group_t        arb_group[UCS_ARBITER_PRIO_LAST]; /* the groups that hold this ep's
+                                                                 pending operations, per
+                                                                 priority class */
 
     /* Used for signaling remote side wakeup */
     struct {
@@ -53,6 +65,13 @@ typedef struct uct_mm_ep {
     } signal;
 
     uct_mm_keepalive_info_t    *keepalive; /* keepalive info */
+
+    struct {
+        ucs_queue_head_t       ops;       /* outstanding AM Zcopy operations */
+        ucs_list_link_t        list;      /* entry in the iface list of
+                                             endpoints with outstanding ops */
+        size_t                 max;       /* maximal payload the peer pulls */
+    } pull;
 } uct_mm_ep_t;
 
 
@@ -64,6 +83,11 @@ ucs_status_t uct_mm_ep_am_short(uct_ep_h tl_ep, uint8_t id, uint64_t header,
 ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_cb,
                            void *arg, unsigned flags);
 
+ucs_status_t uct_mm_ep_am_zcopy(uct_ep_h tl_ep, uint8_t id, const void *header,
+                                unsigned header_length, const uct_iov_t *iov,
+                                size_t iovcnt, unsigned flags,
+                                uct_completion_t *comp);
+
 ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
                              uct_completion_t *comp);
 
@@ -76,6 +100,8 @@ ucs_status_t uct_mm_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *n,
 void uct_mm_ep_pending_purge(uct_ep_h ep, uct_pending_purge_callback_t cb,
                              void *arg);
 
+unsigned uct_mm_ep_progress_pull(uct_mm_ep_t *ep);
+
 ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
                                                   ucs_arbiter_group_t *group,
                                                   ucs_arbiter_elem_t *elem,
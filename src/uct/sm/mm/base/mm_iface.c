@@ -8,6 +8,10 @@
 #  include "config.h"
 #endif
 
+#ifndef _GNU_SOURCE
+#  define _GNU_SOURCE
+#endif
+
 #include "mm_iface.h"
 #include "mm_ep.h"
 
@@ -18,11 +22,15 @@
 #include <ucs/async/async.h>
 #include <ucs/sys/string.h>
 #include <sys/poll.h>
+#include <sys/uio.h>
 
 
 /* Maximal number of events to clear from the signaling pipe in single call */
 #define UCT_MM_IFACE_MAX_SIG_EVENTS  32
 
+/* Number of descriptors for pulled payload to allocate at once */
+#define UCT_MM_IFACE_PULL_DESC_GROW  8
+
 
 ucs_config_field_t uct_mm_iface_config_table[] = {
     {"SM_", "ALLOC=md,mmap,heap", NULL,
@@ -61,6 +69,25 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
      "Maximal number of receive completions to pick during RX poll",
      ucs_offsetof(uct_mm_iface_config_t, fifo_max_poll), UCS_CONFIG_TYPE_ULUNITS},
 
+    {"ZCOPY_MAX", "256k",
+     "Maximal payload of a zero-copy active message. The receiver pulls the payload\n"
+     "from the sender's memory using cross memory attach (process_vm_readv).\n"
+     "0 disables zero-copy active messages.",
+     ucs_offsetof(uct_mm_iface_config_t, zcopy_max), UCS_CONFIG_TYPE_MEMUNITS},
+
+    {"NUMA_POLICY", "preferred",
+     "NUMA memory policy of the receive FIFO and receive buffers:\n"
+     " default   - do not set a memory policy, pages are placed on first touch.\n"
+     " preferred - prefer allocating pages on the NUMA node of the receiver.\n"
+     " bind      - allocate pages only on the NUMA node of the receiver.",
+     ucs_offsetof(uct_mm_iface_config_t, numa_policy),
+     UCS_CONFIG_TYPE_ENUM(ucs_numa_policy_names)},
+
+    {"NUMA_NODE", "auto",
+     "NUMA node of the receive FIFO and receive buffers. \"auto\" selects the\n"
+     "NUMA node of the CPU the interface is created on.",
+     ucs_offsetof(uct_mm_iface_config_t, numa_node), UCS_CONFIG_TYPE_ULUNITS},
+
     {NULL}
 };
 
@@ -106,10 +133,20 @@ void uct_mm_iface_release_desc(uct_recv_desc_t *self, void *desc)
 ucs_status_t uct_mm_iface_flush(uct_iface_h tl_iface, unsigned flags,
                                 uct_completion_t *comp)
 {
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
+
     if (comp != NULL) {
         return UCS_ERR_UNSUPPORTED;
     }
 
+    /* wait for the pending sends and for the receivers to pull the payload
+     * of zcopy sends */
+    if (!ucs_arbiter_is_empty(&iface->arbiter) ||
+        !ucs_list_is_empty(&iface->pull_eps)) {
+        UCT_TL_IFACE_STAT_FLUSH_WAIT(&iface->super.super);
+        return UCS_INPROGRESS;
+    }
+
     ucs_memory_cpu_store_fence();
     UCT_TL_IFACE_STAT_FLUSH(ucs_derived_of(tl_iface, uct_base_iface_t));
     return UCS_OK;
@@ -143,10 +180,11 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
                                           sizeof(uct_mm_fifo_element_t);
     iface_attr->cap.am.max_bcopy        = iface->config.seg_size;
     iface_attr->cap.am.min_zcopy        = 0;
-    iface_attr->cap.am.max_zcopy        = 0;
+    iface_attr->cap.am.max_zcopy        = iface->config.zcopy_max;
     iface_attr->cap.am.opt_zcopy_align  = UCS_SYS_CACHE_LINE_SIZE;
     iface_attr->cap.am.align_mtu        = iface_attr->cap.am.opt_zcopy_align;
-    iface_attr->cap.am.max_iov          = 1;
+    iface_attr->cap.am.max_iov          = ucs_max(iface->config.zcopy_max_iov, 1);
+    iface_attr->cap.am.max_hdr          = iface->config.zcopy_max_hdr;
 
     iface_attr->iface_addr_len          = sizeof(uct_mm_iface_addr_t) +
                                           md->iface_addr_len;
@@ -163,6 +201,10 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
                                           UCT_IFACE_FLAG_CB_SYNC             |
                                           UCT_IFACE_FLAG_EP_CHECK            |
                                           UCT_IFACE_FLAG_CONNECT_TO_IFACE;
+    if (iface->config.zcopy_max > 0) {
+        iface_attr->cap.flags          |= UCT_IFACE_FLAG_AM_ZCOPY;
+    }
+
     iface_attr->cap.event_flags         = UCT_IFACE_FLAG_EVENT_SEND_COMP     |
                                           UCT_IFACE_FLAG_EVENT_RECV          |
                                           UCT_IFACE_FLAG_EVENT_FD;
@@ -219,7 +261,153 @@ uct_mm_assign_desc_to_fifo_elem(uct_mm_iface_t *iface,
     return UCS_OK;
 }
 
-static UCS_F_ALWAYS_INLINE void
+static UCS_F_NOINLINE int
+uct_mm_iface_pull_failed(uct_mm_iface_t *iface, const uct_mm_pull_hdr_t *pull_hdr,
+                         ssize_t delivered)
+{
+    unsigned i;
+
+    if ((delivered < 0) && (errno == ESRCH)) {
+        /* the sender is gone, nobody waits for the operation */
+        ucs_debug("mm_iface %p: sender pid %d of %u bytes is gone", iface,
+                  pull_hdr->pid, pull_hdr->length);
+        return 1;
+    }
+
+    /* report the failure to the sender, which completes the operation with an
+     * error; if there is no room to report it, retry the element later */
+    for (i = 0; i < UCT_MM_FIFO_PULL_FAILED_MAX; ++i) {
+        if (iface->recv_fifo_ctl->pull_failed[i] == 0) {
+            ucs_error("mm_iface %p: failed to pull %u bytes from pid %d, "
+                      "delivered %zd: %m", iface, pull_hdr->length,
+                      pull_hdr->pid, delivered);
+            iface->recv_fifo_ctl->pull_failed[i] = iface->read_index + 1;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static UCS_F_NOINLINE unsigned
+uct_mm_iface_process_pull(uct_mm_iface_t *iface, uct_mm_fifo_element_t *elem)
+{
+    uct_mm_pull_hdr_t *pull_hdr = (uct_mm_pull_hdr_t*)(elem + 1);
+    uct_mm_pull_iov_t *pull_iov = (uct_mm_pull_iov_t*)(pull_hdr + 1);
+    struct iovec remote_iov[UCT_SM_MAX_IOV];
+    struct iovec local_iov;
+    uct_mm_recv_desc_t *desc;
+    ucs_status_t status;
+    ssize_t delivered;
+    unsigned length;
+    void *data;
+    unsigned i;
+
+    ucs_assert(pull_hdr->iovcnt <= UCT_SM_MAX_IOV);
+    for (i = 0; i < pull_hdr->iovcnt; ++i) {
+        remote_iov[i].iov_base = (void*)(uintptr_t)pull_iov[i].address;
+        remote_iov[i].iov_len  = pull_iov[i].length;
+    }
+
+    desc = ucs_mpool_get_inline(&iface->pull_desc_mp);
+    if (ucs_unlikely(desc == NULL)) {
+        /* keep the element in the FIFO and retry on the next progress */
+        uct_iface_mpool_empty_warn(&iface->super.super, &iface->pull_desc_mp);
+        return 0;
+    }
+
+    /* the active message header is followed by the pulled payload */
+    data   = UCS_PTR_BYTE_OFFSET(desc + 1, iface->rx_headroom);
+    length = elem->length + pull_hdr->length;
+    memcpy(data, pull_iov + pull_hdr->iovcnt, elem->length);
+
+    local_iov.iov_base = UCS_PTR_BYTE_OFFSET(data, elem->length);
+    local_iov.iov_len  = pull_hdr->length;
+    delivered          = process_vm_readv(pull_hdr->pid, &local_iov, 1,
+                                          remote_iov, pull_hdr->iovcnt, 0);
+    if (ucs_unlikely(delivered != (ssize_t)pull_hdr->length)) {
+        ucs_mpool_put_inline(desc);
+        if (!uct_mm_iface_pull_failed(iface, pull_hdr, delivered)) {
+            return 0;
+        }
+
+        /* the failure report must be visible before the sender completes */
+        ucs_memory_cpu_store_fence();
+        iface->recv_fifo_ctl->pull_index = iface->read_index + 1;
+        return 1;
+    }
+
+    /* let the sender complete the operation and reuse its buffers */
+    iface->recv_fifo_ctl->pull_index = iface->read_index + 1;
+
+    uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_RECV,
+                       elem->am_id, data, length, "RX: AM_ZCOPY");
+
+    status = uct_mm_iface_invoke_am(iface, elem->am_id, data, length,
+                                    UCT_CB_PARAM_FLAG_DESC);
+    if (status == UCS_OK) {
+        ucs_mpool_put_inline(desc);
+    }
+
+    return 1;
+}
+
+static UCS_F_NOINLINE unsigned
+uct_mm_iface_process_multi(uct_mm_iface_t *iface, uct_mm_fifo_element_t *elem)
+{
+    uct_mm_multi_hdr_t *multi_hdr = (uct_mm_multi_hdr_t*)(elem + 1);
+    size_t offset                 = elem->length;
+    uct_mm_fifo_element_t *seg_elem;
+    uct_mm_recv_desc_t *desc;
+    ucs_status_t status;
+    size_t seg_length;
+    unsigned i;
+    void *data;
+
+    desc = ucs_mpool_get_inline(&iface->pull_desc_mp);
+    if (ucs_unlikely(desc == NULL)) {
+        uct_iface_mpool_empty_warn(&iface->super.super, &iface->pull_desc_mp);
+        return 0;
+    }
+
+    /* gather the active message header and the payload from the receive
+     * descriptors of all elements; the sender wrote them before this one */
+    data = UCS_PTR_BYTE_OFFSET(desc + 1, iface->rx_headroom);
+    memcpy(data, multi_hdr + 1, elem->length);
+    seg_elem   = elem;
+    seg_length = multi_hdr->length;
+    for (i = 0; i < multi_hdr->num_elems; ++i) {
+        if (i > 0) {
+            seg_elem   = UCT_MM_IFACE_GET_FIFO_ELEM(iface,
+                                                    iface->recv_fifo_elems,
+                                                    (iface->read_index + i) &
+                                                    iface->fifo_mask);
+            seg_length = seg_elem->length;
+        }
+
+        ucs_assert((offset + seg_length) <= (iface->config.zcopy_max_hdr +
+                                             iface->config.zcopy_max));
+        VALGRIND_MAKE_MEM_DEFINED(seg_elem->desc_data, seg_length);
+        memcpy(UCS_PTR_BYTE_OFFSET(data, offset), seg_elem->desc_data,
+               seg_length);
+        offset    += seg_length;
+    }
+
+    uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_RECV,
+                       elem->am_id, data, offset, "RX: AM_ZCOPY");
+
+    status = uct_mm_iface_invoke_am(iface, elem->am_id, data, offset,
+                                    UCT_CB_PARAM_FLAG_DESC);
+    if (status == UCS_OK) {
+        ucs_mpool_put_inline(desc);
+    }
+
+    return multi_hdr->num_elems;
+}
+
+/* Returns the number of FIFO elements consumed, 0 if the element should be
+ * processed again later */
+static UCS_F_ALWAYS_INLINE unsigned
 uct_mm_iface_process_recv(uct_mm_iface_t *iface,
                           uct_mm_fifo_element_t* elem)
 {
@@ -231,13 +419,23 @@ uct_mm_iface_process_recv(uct_mm_iface_t *iface,
         uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_RECV,
                            elem->am_id, elem + 1, elem->length, "RX: AM_SHORT");
         uct_mm_iface_invoke_am(iface, elem->am_id, elem + 1, elem->length, 0);
-        return;
+        return 1;
+    }
+
+    if (ucs_unlikely(elem->flags & (UCT_MM_FIFO_ELEM_FLAG_PULL |
+                                    UCT_MM_FIFO_ELEM_FLAG_MULTI))) {
+        if (elem->flags & UCT_MM_FIFO_ELEM_FLAG_PULL) {
+            /* pull the payload of zcopy messages from the sender's memory */
+            return uct_mm_iface_process_pull(iface, elem);
+        }
+
+        return uct_mm_iface_process_multi(iface, elem);
     }
 
     /* check the memory pool to make sure that there is a new descriptor available */
     if (ucs_unlikely(iface->last_recv_desc == NULL)) {
         UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
-                                 iface->last_recv_desc, return);
+                                 iface->last_recv_desc, return 1);
     }
 
     /* read bcopy messages from the receive descriptors */
@@ -256,6 +454,8 @@ uct_mm_iface_process_recv(uct_mm_iface_t *iface,
         UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
                                  iface->last_recv_desc, ucs_debug("recv mpool is empty"));
     }
+
+    return 1;
 }
 
 static UCS_F_ALWAYS_INLINE int
@@ -267,9 +467,30 @@ uct_mm_iface_fifo_has_new_data(uct_mm_iface_t *iface)
             (iface->read_index_elem->flags & 1));
 }
 
+static UCS_F_NOINLINE unsigned
+uct_mm_iface_poll_fifo_multi(uct_mm_iface_t *iface, unsigned count)
+{
+    if (count == 0) {
+        /* the element stays at the read index until it can be processed */
+        return 0;
+    }
+
+    iface->read_index      += count;
+    iface->read_index_elem  =
+        UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elems,
+                                   (iface->read_index & iface->fifo_mask));
+
+    /* the read index may have skipped a release point, so release all
+     * elements to make sure a sender waiting for several of them can go on */
+    iface->recv_fifo_ctl->tail = iface->read_index;
+    return 1;
+}
+
 static UCS_F_ALWAYS_INLINE unsigned
 uct_mm_iface_poll_fifo(uct_mm_iface_t *iface)
 {
+    unsigned count;
+
     if (!uct_mm_iface_fifo_has_new_data(iface)) {
         return 0;
     }
@@ -279,7 +500,10 @@ uct_mm_iface_poll_fifo(uct_mm_iface_t *iface)
     ucs_assert(iface->read_index <=
                (iface->recv_fifo_ctl->head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED));
 
-    uct_mm_iface_process_recv(iface, iface->read_index_elem);
+    count = uct_mm_iface_process_recv(iface, iface->read_index_elem);
+    if (ucs_unlikely(count != 1)) {
+        return uct_mm_iface_poll_fifo_multi(iface, count);
+    }
 
     /* raise the read_index */
     iface->read_index++;
@@ -322,6 +546,19 @@ uct_mm_iface_fifo_window_adjust(uct_mm_iface_t *iface,
     }
 }
 
+static UCS_F_NOINLINE unsigned
+uct_mm_iface_progress_pull(uct_mm_iface_t *iface)
+{
+    unsigned count = 0;
+    uct_mm_ep_t *ep, *tmp_ep;
+
+    ucs_list_for_each_safe(ep, tmp_ep, &iface->pull_eps, pull.list) {
+        count += uct_mm_ep_progress_pull(ep);
+    }
+
+    return count;
+}
+
 static unsigned uct_mm_iface_progress(uct_iface_h tl_iface)
 {
     uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
@@ -344,6 +581,13 @@ static unsigned uct_mm_iface_progress(uct_iface_h tl_iface)
     ucs_arbiter_dispatch(&iface->arbiter, 1, uct_mm_ep_process_pending,
                          &total_count);
 
+    /* complete zcopy sends whose payload was pulled by the receivers, after
+     * the pending sends so that sends from completion callbacks don't
+     * overtake them */
+    if (ucs_unlikely(!ucs_list_is_empty(&iface->pull_eps))) {
+        total_count += uct_mm_iface_progress_pull(iface);
+    }
+
     return total_count;
 }
 
@@ -361,6 +605,12 @@ static ucs_status_t uct_mm_iface_event_fd_arm(uct_iface_h tl_iface,
     uint64_t head, prev_head;
     int ret;
 
+    /* Receivers don't signal when they pull the payload of zcopy sends, so
+     * the completions can't be waited for */
+    if ((events & UCT_EVENT_SEND_COMP) && !ucs_list_is_empty(&iface->pull_eps)) {
+        return UCS_ERR_BUSY;
+    }
+
     /* Make the next sender which writes to the FIFO signal the receiver */
     head      = iface->recv_fifo_ctl->head;
     prev_head = ucs_atomic_cswap64(ucs_unaligned_ptr(&iface->recv_fifo_ctl->head),
@@ -401,6 +651,7 @@ static uct_iface_ops_t uct_mm_iface_ops = {
     .ep_get_bcopy             = uct_sm_ep_get_bcopy,
     .ep_am_short              = uct_mm_ep_am_short,
     .ep_am_bcopy              = uct_mm_ep_am_bcopy,
+    .ep_am_zcopy              = uct_mm_ep_am_zcopy,
     .ep_atomic_cswap64        = uct_sm_ep_atomic_cswap64,
     .ep_atomic64_post         = uct_sm_ep_atomic64_post,
     .ep_atomic64_fetch        = uct_sm_ep_atomic64_fetch,
@@ -428,6 +679,33 @@ static uct_iface_ops_t uct_mm_iface_ops = {
     .iface_is_reachable       = uct_mm_iface_is_reachable
 };
 
+static void uct_mm_iface_numa_policy_set(uct_mm_iface_t *iface,
+                                         ucs_numa_thread_policy_t *prev)
+{
+    ucs_status_t status;
+
+    status = ucs_numa_thread_policy_set(iface->config.numa_node,
+                                        iface->config.numa_policy, prev);
+    if (status != UCS_OK) {
+        ucs_debug("mm_iface %p: failed to set numa node %d policy: %s", iface,
+                  iface->config.numa_node, ucs_status_string(status));
+    }
+}
+
+static void uct_mm_iface_numa_bind(uct_mm_iface_t *iface, void *address,
+                                   size_t length, const char *name)
+{
+    ucs_status_t status;
+
+    status = ucs_numa_mem_bind(address, length, iface->config.numa_node,
+                               iface->config.numa_policy);
+    if (status != UCS_OK) {
+        ucs_debug("mm_iface %p: failed to place %s %p length %zu on numa "
+                  "node %d: %s", iface, name, address, length,
+                  iface->config.numa_node, ucs_status_string(status));
+    }
+}
+
 static void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj,
                                         uct_mem_h memh)
 {
@@ -436,6 +714,16 @@ static void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj,
     uct_mm_seg_t        *seg  = memh;
     size_t offset;
 
+    /* descriptors of a memory pool chunk are initialized one after another,
+     * so place the whole segment once, when its first descriptor is seen.
+     * The chunks allocated during the iface initialization are already placed
+     * by the thread policy, this moves the ones added later by the progress */
+    if (seg != iface->numa_last_seg) {
+        uct_mm_iface_numa_bind(iface, seg->address, seg->length,
+                               "receive descriptors");
+        iface->numa_last_seg = seg;
+    }
+
     if (seg->length > UINT_MAX) {
         ucs_error("mm: shared memory segment length cannot exceed %u", UINT_MAX);
         desc->info.seg_id   = UINT64_MAX;
@@ -549,9 +837,64 @@ static void uct_mm_iface_log_created(uct_mm_iface_t *iface)
     uct_mm_seg_t UCS_V_UNUSED *seg = iface->recv_fifo_mem.memh;
 
     ucs_debug("created mm iface %p FIFO id 0x%"PRIx64
-              " va %p size %zu (%u x %u elems)",
+              " va %p size %zu (%u x %u elems) numa node %d policy %s",
               iface, seg->seg_id, seg->address, seg->length,
-              iface->config.fifo_elem_size, iface->config.fifo_size);
+              iface->config.fifo_elem_size, iface->config.fifo_size,
+              iface->config.numa_node,
+              ucs_numa_policy_names[iface->config.numa_policy]);
+}
+
+static ucs_mpool_ops_t uct_mm_iface_pull_desc_mpool_ops = {
+    .chunk_alloc   = ucs_mpool_chunk_mmap,
+    .chunk_release = ucs_mpool_chunk_munmap,
+    .obj_init      = NULL,
+    .obj_cleanup   = NULL
+};
+
+static ucs_mpool_ops_t uct_mm_iface_pull_op_mpool_ops = {
+    .chunk_alloc   = ucs_mpool_chunk_malloc,
+    .chunk_release = ucs_mpool_chunk_free,
+    .obj_init      = NULL,
+    .obj_cleanup   = NULL
+};
+
+static void uct_mm_iface_init_zcopy(uct_mm_iface_t *iface,
+                                    const uct_mm_iface_config_t *mm_config)
+{
+    size_t hdr_space, multi_max;
+
+    iface->config.zcopy_max     = 0;
+    iface->config.zcopy_max_hdr = 0;
+    iface->config.zcopy_max_iov = 0;
+
+    if ((mm_config->zcopy_max == 0) || !uct_sm_iface_cma_is_supported()) {
+        return;
+    }
+
+    /* the FIFO element carries the pull header, the sender's iov array and
+     * the active message header; split the space between the last two */
+    hdr_space = iface->config.fifo_elem_size - sizeof(uct_mm_fifo_element_t) -
+                sizeof(uct_mm_pull_hdr_t);
+    iface->config.zcopy_max_iov = ucs_min(UCT_SM_MAX_IOV,
+                                          hdr_space / 2 /
+                                          sizeof(uct_mm_pull_iov_t));
+    if (iface->config.zcopy_max_iov == 0) {
+        ucs_debug("mm_iface %p: FIFO element size %u is too small for AM "
+                  "Zcopy", iface, iface->config.fifo_elem_size);
+        return;
+    }
+
+    iface->config.zcopy_max_hdr = hdr_space - (iface->config.zcopy_max_iov *
+                                               sizeof(uct_mm_pull_iov_t));
+
+    /* a sender which cannot be pulled from copies the payload to the receive
+     * descriptors of consecutive FIFO elements; since the tail is released in
+     * batches, only this many elements are sure to become free together */
+    multi_max                   = (iface->config.fifo_size -
+                                   iface->fifo_release_factor_mask) *
+                                  iface->config.seg_size;
+    iface->config.zcopy_max     = ucs_min(mm_config->zcopy_max, multi_max);
+    iface->config.zcopy_max     = ucs_min(iface->config.zcopy_max, UINT32_MAX);
 }
 
 static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
@@ -562,6 +905,7 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                     ucs_derived_of(tl_config, uct_mm_iface_config_t);
     uct_mm_fifo_element_t* fifo_elem_p;
     ucs_status_t status;
+    ucs_numa_thread_policy_t numa_prev;
     unsigned i;
     char proc[32];
 
@@ -603,6 +947,12 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                       UCT_MM_IFACE_FIFO_MAX_POLL :
                                       /* trim by the maximum unsigned integer value */
                                       ucs_min(mm_config->fifo_max_poll, UINT_MAX));
+    self->config.numa_policy       = mm_config->numa_policy;
+    self->config.numa_node         = (mm_config->numa_node == UCS_ULUNITS_AUTO) ?
+                                     ucs_numa_current_node() :
+                                     ucs_min(mm_config->numa_node, INT_MAX);
+    self->numa_last_seg            = NULL;
+    ucs_list_head_init(&self->pull_eps);
     self->fifo_prev_wnd_cons       = 0;
     self->fifo_poll_count          = self->config.fifo_max_poll;
     /* cppcheck-suppress internalAstError */
@@ -611,11 +961,17 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                      1)));
     self->fifo_mask                = self->config.fifo_size - 1;
     self->fifo_shift               = ucs_count_trailing_zero_bits(mm_config->fifo_size);
+    uct_mm_iface_init_zcopy(self, mm_config);
     self->rx_headroom              = (params->field_mask &
                                       UCT_IFACE_PARAM_FIELD_RX_HEADROOM) ?
                                      params->rx_headroom : 0;
     self->release_desc.cb          = uct_mm_iface_release_desc;
 
+    /* The receive FIFO and the first receive descriptors may be faulted in
+     * while they are allocated (e.g by a memory locking or a backing file
+     * test), so the policy has to be set for the thread prior to that */
+    uct_mm_iface_numa_policy_set(self, &numa_prev);
+
     /* Allocate the receive FIFO */
     status = uct_iface_mem_alloc(&self->super.super.super,
                                  UCT_MM_GET_FIFO_SIZE(self),
@@ -623,14 +979,24 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                  &self->recv_fifo_mem);
     if (status != UCS_OK) {
         ucs_error("mm_iface failed to allocate receive FIFO");
-        return status;
+        goto err_restore_numa_policy;
     }
 
+    /* set the policy of the FIFO mapping as well, so its pages which are not
+     * faulted in yet don't end up on the node of the sender which maps it */
+    uct_mm_iface_numa_bind(self, self->recv_fifo_mem.address,
+                           self->recv_fifo_mem.length, "receive FIFO");
+
     uct_mm_iface_set_fifo_ptrs(self->recv_fifo_mem.address,
                                &self->recv_fifo_ctl, &self->recv_fifo_elems);
     self->recv_fifo_ctl->head      = 0;
     self->recv_fifo_ctl->tail      = 0;
     self->recv_fifo_ctl->owner.pid = getpid();
+    self->recv_fifo_ctl->pull_index   = 0;
+    self->recv_fifo_ctl->owner.pid_ns = ucs_sys_get_ns(UCS_SYS_NS_TYPE_PID);
+    self->recv_fifo_ctl->pull_max     = self->config.zcopy_max;
+    memset((void*)self->recv_fifo_ctl->pull_failed, 0,
+           sizeof(self->recv_fifo_ctl->pull_failed));
     self->read_index               = 0;
     self->read_index_elem          = UCT_MM_IFACE_GET_FIFO_ELEM(self,
                                                                 self->recv_fifo_elems,
@@ -641,7 +1007,7 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                    &self->recv_fifo_ctl->owner.starttime);
     if (status != UCS_OK) {
         ucs_error("mm_iface failed to get process starttime");
-        return status;
+        goto err_free_fifo;
     }
 
     /* create a unix file descriptor to receive event notifications */
@@ -666,13 +1032,31 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         goto err_close_signal_fd;
     }
 
+    /* create memory pools for AM Zcopy; nothing is allocated unless used */
+    status = ucs_mpool_init(&self->pull_desc_mp, 0,
+                            sizeof(uct_mm_recv_desc_t) + self->rx_headroom +
+                            self->config.zcopy_max_hdr + self->config.zcopy_max,
+                            sizeof(uct_mm_recv_desc_t), UCS_SYS_CACHE_LINE_SIZE,
+                            UCT_MM_IFACE_PULL_DESC_GROW, UINT_MAX,
+                            &uct_mm_iface_pull_desc_mpool_ops, "mm_pull_desc");
+    if (status != UCS_OK) {
+        goto destroy_recv_mpool;
+    }
+
+    status = ucs_mpool_init(&self->pull_op_mp, 0, sizeof(uct_mm_pull_op_t), 0,
+                            UCS_SYS_CACHE_LINE_SIZE, 128, UINT_MAX,
+                            &uct_mm_iface_pull_op_mpool_ops, "mm_pull_op");
+    if (status != UCS_OK) {
+        goto destroy_pull_desc_mpool;
+    }
+
     /* set the first receive descriptor */
     self->last_recv_desc = ucs_mpool_get(&self->recv_desc_mp);
     VALGRIND_MAKE_MEM_DEFINED(self->last_recv_desc, sizeof(*(self->last_recv_desc)));
     if (self->last_recv_desc == NULL) {
         ucs_error("failed to get the first receive descriptor");
         status = UCS_ERR_NO_RESOURCE;
-        goto destroy_recv_mpool;
+        goto destroy_pull_op_mpool;
     }
 
     /* initiate the owner bit in all the FIFO elements and assign a receive descriptor
@@ -688,6 +1072,7 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         }
     }
 
+    ucs_numa_thread_policy_restore(&numa_prev);
     ucs_arbiter_init(&self->arbiter);
     uct_mm_iface_log_created(self);
 
@@ -696,12 +1081,18 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
 destroy_descs:
     uct_mm_iface_free_rx_descs(self, i);
     ucs_mpool_put(self->last_recv_desc);
+destroy_pull_op_mpool:
+    ucs_mpool_cleanup(&self->pull_op_mp, 1);
+destroy_pull_desc_mpool:
+    ucs_mpool_cleanup(&self->pull_desc_mp, 1);
 destroy_recv_mpool:
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
 err_close_signal_fd:
     close(self->signal_fd);
 err_free_fifo:
     uct_iface_mem_free(&self->recv_fifo_mem);
+err_restore_numa_policy:
+    ucs_numa_thread_policy_restore(&numa_prev);
 err:
     return status;
 }
@@ -716,6 +1107,8 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_iface_t)
     uct_mm_iface_free_rx_descs(self, self->config.fifo_size);
 
     ucs_mpool_put(self->last_recv_desc);
+    ucs_mpool_cleanup(&self->pull_op_mp, 1);
+    ucs_mpool_cleanup(&self->pull_desc_mp, 1);
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
     close(self->signal_fd);
     uct_iface_mem_free(&self->recv_fifo_mem);
@@ -15,6 +15,7 @@
 #include <ucs/arch/cpu.h>
 #include <ucs/debug/memtrack.h>
 #include <ucs/datastruct/arbiter.h>
+#include <ucs/memory/numa.h>
 #include <ucs/sys/compiler.h>
 #include <ucs/sys/sys.h>
 #include <sys/shm.h>
@@ -24,9 +25,18 @@
 enum {
     UCT_MM_FIFO_ELEM_FLAG_OWNER  = UCS_BIT(0), /* new/old info */
     UCT_MM_FIFO_ELEM_FLAG_INLINE = UCS_BIT(1), /* if inline or not */
+    UCT_MM_FIFO_ELEM_FLAG_PULL   = UCS_BIT(2), /* payload should be pulled from
+                                                  the sender's memory */
+    UCT_MM_FIFO_ELEM_FLAG_MULTI  = UCS_BIT(3), /* payload spans the receive
+                                                  descriptors of several
+                                                  FIFO elements */
 };
 
 
+/* Number of AM Zcopy pull failures a receiver can report at the same time */
+#define UCT_MM_FIFO_PULL_FAILED_MAX 8
+
+
 #define UCT_MM_FIFO_CTL_SIZE \
     ucs_align_up(sizeof(uct_mm_fifo_ctl_t), UCS_SYS_CACHE_LINE_SIZE)
 
@@ -84,6 +94,9 @@ typedef struct uct_mm_iface_config {
     ucs_ternary_value_t      hugetlb_mode;        /* Enable using huge pages for
                                                    * shared memory buffers */
     unsigned                 fifo_elem_size;      /* Size of the FIFO element size */
+    size_t                   zcopy_max;           /* Maximal AM Zcopy payload */
+    ucs_numa_policy_t        numa_policy;         /* NUMA policy of receive memory */
+    unsigned long            numa_node;           /* NUMA node of receive memory */
     uct_iface_mpool_config_t mp;
 } uct_mm_iface_config_t;
 
@@ -111,10 +124,22 @@ typedef struct uct_mm_fifo_ctl {
 
     /* 2nd cacheline */
     volatile uint64_t         tail;           /* How much was consumed */
+    volatile uint64_t         pull_index;     /* Index following the last element
+                                                 whose payload was pulled */
     struct {
         pid_t                 pid;            /* Process owner pid */
         ucs_time_t            starttime;      /* Process starttime */
+        ucs_sys_ns_t          pid_ns;         /* Process PID namespace */
     } owner;
+    uint32_t                  pull_max;       /* Maximal payload the owner pulls
+                                                 from a sender, 0 if it cannot */
+
+    /* 3rd cacheline */
+    volatile uint64_t         pull_failed[UCT_MM_FIFO_PULL_FAILED_MAX];
+                                              /* Index following an element whose
+                                                 payload could not be pulled,
+                                                 until its sender collects it,
+                                                 or 0 if the entry is free */
 } UCS_S_PACKED UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE) uct_mm_fifo_ctl_t;
 
 
@@ -146,6 +171,40 @@ typedef struct uct_mm_fifo_element {
 } UCS_S_PACKED uct_mm_fifo_element_t;
 
 
+/**
+ * Header of an AM Zcopy FIFO element, followed by the sender's iov array and
+ * the active message header
+ */
+typedef struct uct_mm_pull_hdr {
+    pid_t                     pid;            /* process to pull the payload from */
+    uint32_t                  length;         /* total payload length */
+    uint8_t                   iovcnt;         /* number of iov entries */
+} UCS_S_PACKED uct_mm_pull_hdr_t;
+
+
+/**
+ * Header of an AM Zcopy FIFO element whose payload was copied by the sender to
+ * the receive descriptors of this element and the following ones, followed by
+ * the active message header
+ */
+typedef struct uct_mm_multi_hdr {
+    uint32_t                  length;         /* payload length in the receive
+                                                 descriptor of this element; the
+                                                 following elements carry it in
+                                                 their 'length' field */
+    uint32_t                  num_elems;      /* number of FIFO elements */
+} UCS_S_PACKED uct_mm_multi_hdr_t;
+
+
+/**
+ * Remote memory region to pull from
+ */
+typedef struct uct_mm_pull_iov {
+    uint64_t                  address;
+    uint64_t                  length;
+} UCS_S_PACKED uct_mm_pull_iov_t;
+
+
 /*
  * MM receive descriptor:
  *
@@ -192,6 +251,12 @@ typedef struct uct_mm_iface {
 
     ucs_mpool_t             recv_desc_mp;
     uct_mm_recv_desc_t      *last_recv_desc;  /* next receive descriptor to use */
+    ucs_mpool_t             pull_desc_mp;     /* descriptors for pulled payload */
+    ucs_mpool_t             pull_op_mp;       /* outstanding AM Zcopy operations */
+    ucs_list_link_t         pull_eps;         /* endpoints with outstanding
+                                                 AM Zcopy operations */
+    const void              *numa_last_seg;   /* last receive descriptors segment
+                                                 placed on the NUMA node */
 
     int                     signal_fd;        /* Unix socket for receiving remote signal */
 
@@ -204,6 +269,12 @@ typedef struct uct_mm_iface {
         unsigned            fifo_elem_size;
         unsigned            seg_size;         /* size of the receive descriptor (for payload)*/
         unsigned            fifo_max_poll;
+        size_t              zcopy_max;        /* maximal AM Zcopy payload, 0 if
+                                                 AM Zcopy is not supported */
+        size_t              zcopy_max_hdr;    /* maximal AM Zcopy header */
+        size_t              zcopy_max_iov;    /* maximal AM Zcopy iov count */
+        ucs_numa_policy_t   numa_policy;      /* NUMA policy of receive memory */
+        int                 numa_node;        /* NUMA node of receive memory */
     } config;
 } uct_mm_iface_t;
 
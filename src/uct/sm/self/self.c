@@ -32,7 +32,7 @@
 
 /* Forward declarations */
 static uct_iface_ops_t uct_self_iface_ops;
-static uct_component_t uct_self_component;
+uct_component_t uct_self_component;
 
 
 static ucs_config_field_t uct_self_iface_config_table[] = {
@@ -375,7 +375,7 @@ static ucs_status_t uct_self_md_rkey_unpack(uct_component_t *component,
     return UCS_OK;
 }
 
-static uct_component_t uct_self_component = {
+uct_component_t uct_self_component = {
     .query_md_resources = uct_md_query_single_md_resource,
     .md_open            = uct_self_md_open,
     .cm_open            = ucs_empty_function_return_unsupported,
@@ -14,6 +14,10 @@
 typedef uint64_t uct_self_iface_addr_t;
 
 
+/* Shared with the intra-process transport, which uses the same dummy MD */
+extern uct_component_t uct_self_component;
+
+
 typedef struct uct_self_iface_config {
     uct_iface_config_t    super;
     size_t                seg_size;      /* Maximal send size */
@@ -14,6 +14,7 @@
 #include <ucs/sys/sock.h>
 #include <ucs/sys/string.h>
 #include <ucs/datastruct/conn_match.h>
+#include <ucs/datastruct/khash.h>
 #include <ucs/algorithm/crc.h>
 #include <ucs/sys/event_set.h>
 #include <ucs/sys/iovec.h>
@@ -30,6 +31,12 @@
 /* Maximum number of events to wait on event set */
 #define UCT_TCP_MAX_EVENTS                    16
 
+/* Number of submission queue entries of io_uring event engine */
+#define UCT_TCP_URING_ENTRIES                 256
+
+/* Number of receive buffers provided to io_uring, must be a power of 2 */
+#define UCT_TCP_URING_RX_BUFS                 64
+
 /* How long should be string to keep [%s:%s] string
  * where %s value can be -/Tx/Rx */
 #define UCT_TCP_EP_CTX_CAPS_STR_MAX           8
@@ -52,6 +59,10 @@
 
 #define UCT_TCP_CONFIG_MAX_CONN_RETRIES      "MAX_CONN_RETRIES"
 
+/* Maximal number of sockets which can be used by an endpoint to send
+ * PUT Zcopy payload */
+#define UCT_TCP_EP_MAX_STRIPES               16
+
 /* TX and RX caps */
 #define UCT_TCP_EP_CTX_CAPS                  (UCT_TCP_EP_FLAG_CTX_TYPE_TX | \
                                               UCT_TCP_EP_FLAG_CTX_TYPE_RX)
@@ -91,7 +102,25 @@ enum {
     /* EP is on connection matching context. */
     UCT_TCP_EP_FLAG_ON_MATCH_CTX       = UCS_BIT(6),
     /* EP failed and a callback for handling error is scheduled. */
-    UCT_TCP_EP_FLAG_FAILED             = UCS_BIT(7)
+    UCT_TCP_EP_FLAG_FAILED             = UCS_BIT(7),
+    /* EP created by the user which splits large PUT Zcopy payload between
+     * auxiliary EPs, its striping context is stored on the iface. */
+    UCT_TCP_EP_FLAG_STRIPE             = UCS_BIT(8),
+    /* EP sends parts of striped PUT Zcopy operations on behalf of another
+     * EP, its striping context is stored on the iface. */
+    UCT_TCP_EP_FLAG_STRIPE_AUX         = UCS_BIT(9),
+    /* Parts of a striped PUT Zcopy operation are waiting for an ACK on the
+     * auxiliary EPs, the EP mustn't send until all of them are acknowledged. */
+    UCT_TCP_EP_FLAG_STRIPE_WAIT_ACK    = UCS_BIT(10)
+};
+
+
+/**
+ * TCP device address flags
+ */
+enum {
+    /* The peer accepts auxiliary connections (UCT_TCP_CM_CONN_STRIPE_REQ) */
+    UCT_TCP_DEVICE_ADDR_FLAG_STRIPES   = UCS_BIT(0)
 };
 
 
@@ -123,8 +152,10 @@ typedef enum uct_tcp_ep_conn_state {
     UCT_TCP_EP_CONN_STATE_CONNECTED
 } uct_tcp_ep_conn_state_t;
 
-/* Forward declaration */
-typedef struct uct_tcp_ep uct_tcp_ep_t;
+/* Forward declarations */
+typedef struct uct_tcp_ep       uct_tcp_ep_t;
+typedef struct uct_tcp_uring    uct_tcp_uring_t;
+typedef struct uct_tcp_uring_ep uct_tcp_uring_ep_t;
 
 typedef unsigned (*uct_tcp_ep_progress_t)(uct_tcp_ep_t *ep);
 
@@ -155,10 +186,29 @@ typedef enum uct_tcp_cm_conn_event {
      * `UCT_TCP_CM_CONN_REQ` wasn't sent yet) and want to have RX capability
      * on a peer's EP in order to send AM data. */
     UCT_TCP_CM_CONN_ACK_WITH_REQ      = (UCT_TCP_CM_CONN_REQ |
-                                         UCT_TCP_CM_CONN_ACK)
+                                         UCT_TCP_CM_CONN_ACK),
+    /* Connection request from an auxiliary EP which sends a part of PUT Zcopy
+     * payload of another EP connected to the same peer. Such connection is
+     * used for RX only and doesn't participate in connection matching. */
+    UCT_TCP_CM_CONN_STRIPE_REQ        = (UCT_TCP_CM_CONN_REQ |
+                                         UCS_BIT(2))
 } uct_tcp_cm_conn_event_t;
 
 
+/**
+ * TCP device address. It has the layout of struct sockaddr_in, which is what
+ * older peers pack and unpack, and passes the capabilities of the iface in the
+ * bytes which are zero in struct sockaddr_in.
+ */
+typedef struct uct_tcp_device_addr {
+    sa_family_t                   sin_family;  /* Address family, AF_INET */
+    in_port_t                     sin_port;    /* Port, as in the iface address */
+    struct in_addr                sin_addr;    /* IPv4 address of the interface */
+    uint8_t                       flags;       /* UCT_TCP_DEVICE_ADDR_FLAG_xx */
+    uint8_t                       reserved[7]; /* Zero */
+} uct_tcp_device_addr_t;
+
+
 /**
  * TCP connection request packet
  */
@@ -249,12 +299,35 @@ typedef struct uct_tcp_ep_zcopy_tx {
 } uct_tcp_ep_zcopy_tx_t;
 
 
+/**
+ * TCP endpoint striping context, allocated only for the EPs which send
+ * PUT Zcopy payload through several connections and for their auxiliary EPs.
+ * The contexts are kept on the iface, so the EPs which don't use striping
+ * don't pay for it.
+ */
+typedef struct uct_tcp_ep_stripe {
+    uct_tcp_ep_t                  *parent;       /* EP which uses this auxiliary EP,
+                                                  * NULL for EPs created by the user */
+    unsigned                      num_wait_ack;  /* How many auxiliary EPs are waiting
+                                                  * for PUT ACK, the EP can't send until
+                                                  * it drops to 0 */
+    int                           eps_created;   /* Whether the auxiliary EPs were
+                                                  * already created */
+    uct_tcp_ep_t                  *eps[0];       /* Auxiliary EPs which send parts of
+                                                  * large PUT Zcopy payload */
+} uct_tcp_ep_stripe_t;
+
+
+/* Striping contexts of the EPs, indexed by the EP address */
+KHASH_MAP_INIT_INT64(uct_tcp_ep_stripes, uct_tcp_ep_stripe_t*);
+
+
 /**
  * TCP endpoint
  */
 struct uct_tcp_ep {
     uct_base_ep_t                 super;
-    uint8_t                       flags;            /* Endpoint flags */
+    uint16_t                      flags;            /* Endpoint flags */
     uint8_t                       conn_retries;     /* Number of connection attempts done */
     uct_tcp_ep_conn_state_t       conn_state;       /* State of connection with peer */
     int                           fd;               /* Socket file descriptor */
@@ -262,11 +335,15 @@ struct uct_tcp_ep {
                                                      * closed as soon as the EP is connected
                                                      * using the new fd */
     int                           events;           /* Current notifications */
+    uct_tcp_uring_ep_t            *uring_ep;        /* io_uring context, NULL if
+                                                     * no event was requested yet */
     uct_tcp_cm_conn_sn_t          conn_sn;          /* Connection sequence number */
     uct_tcp_ep_ctx_t              tx;               /* TX resources */
     uct_tcp_ep_ctx_t              rx;               /* RX resources */
     struct sockaddr_in            peer_addr;        /* Remote iface addr */
-    ucs_queue_head_t              pending_q;        /* Pending operations */
+    ucs_queue_head_t              pending_q[UCS_ARBITER_PRIO_LAST];
+                                                    /* Pending operations, per
+                                                     * priority class */
     ucs_queue_head_t              put_comp_q;       /* Flush completions waiting for
                                                      * outstanding PUTs acknowledgment */
     union {
@@ -284,8 +361,11 @@ typedef struct uct_tcp_iface {
     int                           listen_fd;         /* Server socket */
     ucs_conn_match_ctx_t          conn_match_ctx;    /* Connection matching context */
     ucs_list_link_t               ep_list;           /* List of endpoints */
+    khash_t(uct_tcp_ep_stripes)   ep_stripes;        /* Striping contexts of EPs */
     char                          if_name[IFNAMSIZ]; /* Network interface name */
     ucs_sys_event_set_t           *event_set;        /* Event set identifier */
+    uct_tcp_uring_t               *uring;            /* io_uring event engine, NULL if
+                                                      * the event set is used */
     ucs_mpool_t                   tx_mpool;          /* TX memory pool */
     ucs_mpool_t                   rx_mpool;          /* RX memory pool */
     size_t                        outstanding;       /* How much data in the EP send buffers
@@ -320,6 +400,12 @@ typedef struct uct_tcp_iface {
         unsigned                  syn_cnt;           /* Number of SYN retransmits that TCP should send
                                                       * before aborting the attempt to connect.
                                                       * It cannot exceed 255. */
+        struct {
+            unsigned              count;             /* Number of sockets used by EP to send
+                                                      * PUT Zcopy payload */
+            size_t                thresh;            /* Minimal PUT Zcopy payload which is split
+                                                      * between the sockets */
+        } stripe;
     } config;
 
     struct {
@@ -350,6 +436,10 @@ typedef struct uct_tcp_iface_config {
     uct_iface_mpool_config_t       tx_mpool;
     uct_iface_mpool_config_t       rx_mpool;
     ucs_range_spec_t               port_range;
+    int                            io_uring;
+    int                            io_uring_sqpoll;
+    unsigned                       stripes;
+    size_t                         stripe_thresh;
 } uct_tcp_iface_config_t;
 
 
@@ -395,7 +485,7 @@ ucs_status_t uct_tcp_ep_create(const uct_ep_params_t *params,
 
 const char *uct_tcp_ep_ctx_caps_str(uint8_t ep_ctx_caps, char *str_buffer);
 
-void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint8_t new_caps);
+void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint16_t new_caps);
 
 void uct_tcp_ep_add_ctx_cap(uct_tcp_ep_t *ep, uint8_t cap);
 
@@ -479,6 +569,27 @@ ucs_status_t uct_tcp_cm_handle_incoming_conn(uct_tcp_iface_t *iface,
 
 ucs_status_t uct_tcp_cm_conn_start(uct_tcp_ep_t *ep);
 
+ucs_status_t uct_tcp_uring_create(uct_tcp_iface_t *iface, unsigned entries,
+                                  int sqpoll, uct_tcp_uring_t **uring_p);
+
+void uct_tcp_uring_destroy(uct_tcp_uring_t *uring);
+
+int uct_tcp_uring_fd(uct_tcp_uring_t *uring);
+
+ucs_status_t uct_tcp_uring_arm(uct_tcp_uring_t *uring);
+
+unsigned uct_tcp_uring_progress(uct_tcp_uring_t *uring, unsigned max_events);
+
+void uct_tcp_uring_ep_update(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep);
+
+void uct_tcp_uring_ep_cleanup(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep);
+
+ucs_status_t uct_tcp_uring_ep_send_result(uct_tcp_uring_t *uring,
+                                          uct_tcp_ep_t *ep, size_t *length_p);
+
+ucs_status_t uct_tcp_uring_ep_recv(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep,
+                                   void *data, size_t *length_p);
+
 static inline void uct_tcp_iface_outstanding_inc(uct_tcp_iface_t *iface)
 {
     iface->outstanding++;
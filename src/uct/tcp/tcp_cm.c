@@ -121,6 +121,11 @@ static void uct_tcp_cm_trace_conn_pkt(const uct_tcp_ep_t *ep,
         p += strlen(event_str);
     }
 
+    if ((event & UCT_TCP_CM_CONN_STRIPE_REQ) == UCT_TCP_CM_CONN_STRIPE_REQ) {
+        ucs_snprintf_zero(p, sizeof(event_str) - (p - event_str), " (stripe)");
+        p += strlen(p);
+    }
+
     if (event_str == p) {
         ucs_snprintf_zero(event_str, sizeof(event_str), "UNKNOWN (%d)", event);
         log_level = UCS_LOG_LEVEL_ERROR;
@@ -180,7 +185,9 @@ ucs_status_t uct_tcp_cm_send_event(uct_tcp_ep_t *ep,
         }
 
         conn_pkt             = (uct_tcp_cm_conn_req_pkt_t*)(pkt_hdr + 1);
-        conn_pkt->event      = UCT_TCP_CM_CONN_REQ;
+        conn_pkt->event      = (ep->flags & UCT_TCP_EP_FLAG_STRIPE_AUX) ?
+                               UCT_TCP_CM_CONN_STRIPE_REQ :
+                               UCT_TCP_CM_CONN_REQ;
         conn_pkt->iface_addr = iface->config.ifaddr;
         conn_pkt->conn_sn    = ep->conn_sn;
         ucs_assert(ep->conn_sn < UCT_TCP_CM_CONN_SN_MAX);
@@ -468,7 +475,7 @@ uct_tcp_cm_handle_conn_req(uct_tcp_ep_t **ep_p,
     unsigned progress_count = 0;
     ucs_status_t status;
     uct_tcp_ep_t *peer_ep;
-    int connect_to_self;
+    int connect_to_self, match_conn;
 
     ucs_assert(/* EP received the connection request after the TCP
                 * connection was accepted */
@@ -484,7 +491,7 @@ uct_tcp_cm_handle_conn_req(uct_tcp_ep_t **ep_p,
     }
 
     uct_tcp_cm_trace_conn_pkt(ep, UCS_LOG_LEVEL_TRACE,
-                              "%s received from", UCT_TCP_CM_CONN_REQ);
+                              "%s received from", cm_req_pkt->event);
 
     uct_tcp_ep_add_ctx_cap(ep, UCT_TCP_EP_FLAG_CTX_TYPE_RX);
 
@@ -495,8 +502,12 @@ uct_tcp_cm_handle_conn_req(uct_tcp_ep_t **ep_p,
     ucs_assertv(!(ep->flags & UCT_TCP_EP_FLAG_CTX_TYPE_TX),
                 "ep %p mustn't have TX cap", ep);
 
+    /* Connections of auxiliary EPs which are used for PUT Zcopy striping
+     * are not matched, since they never carry the peer's TX data */
     connect_to_self = uct_tcp_ep_is_self(ep);
-    if (connect_to_self) {
+    match_conn      = !connect_to_self &&
+                      (cm_req_pkt->event != UCT_TCP_CM_CONN_STRIPE_REQ);
+    if (!match_conn) {
         goto accept_conn;
     }
 
@@ -516,7 +527,7 @@ accept_conn:
         goto out;
     }
 
-    if (!connect_to_self) {
+    if (match_conn) {
         uct_tcp_iface_remove_ep(ep);
         uct_tcp_cm_insert_ep(iface, ep);
     }
@@ -556,6 +567,7 @@ unsigned uct_tcp_cm_handle_conn_pkt(uct_tcp_ep_t **ep_p, void *pkt, uint32_t len
 
     switch (cm_event) {
     case UCT_TCP_CM_CONN_REQ:
+    case UCT_TCP_CM_CONN_STRIPE_REQ:
         /* Don't trace received CM packet here, because
          * EP doesn't contain the peer address */
         ucs_assertv(length == sizeof(*cm_req_pkt), "ep=%p", *ep_p);
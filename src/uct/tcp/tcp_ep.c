@@ -65,6 +65,12 @@ static inline int uct_tcp_ep_ctx_buf_need_progress(uct_tcp_ep_ctx_t *ctx)
     return ctx->offset < ctx->length;
 }
 
+static inline int uct_tcp_ep_pending_is_empty(uct_tcp_ep_t *ep)
+{
+    return ucs_queue_is_empty(&ep->pending_q[UCS_ARBITER_PRIO_HIGH]) &&
+           ucs_queue_is_empty(&ep->pending_q[UCS_ARBITER_PRIO_NORMAL]);
+}
+
 static inline ucs_status_t uct_tcp_ep_check_tx_res(uct_tcp_ep_t *ep)
 {
     if (ucs_unlikely(ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED)) {
@@ -78,6 +84,12 @@ static inline ucs_status_t uct_tcp_ep_check_tx_res(uct_tcp_ep_t *ep)
         return UCS_ERR_NO_RESOURCE;
     }
 
+    if (ucs_unlikely(ep->flags & UCT_TCP_EP_FLAG_STRIPE_WAIT_ACK)) {
+        /* Next operations mustn't overtake the parts of a striped PUT which
+         * are sent through other connections */
+        return UCS_ERR_NO_RESOURCE;
+    }
+
     return uct_tcp_ep_ctx_buf_empty(&ep->tx) ? UCS_OK : UCS_ERR_NO_RESOURCE;
 }
 
@@ -126,8 +138,17 @@ int uct_tcp_ep_is_self(const uct_tcp_ep_t *ep)
 
 static void uct_tcp_ep_cleanup(uct_tcp_ep_t *ep)
 {
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
     uct_tcp_ep_addr_cleanup(&ep->peer_addr);
 
+    /* The ring takes the TX buffer if a send request still uses it */
+    uct_tcp_ep_mod_events(ep, 0, ep->events);
+    if (iface->uring != NULL) {
+        uct_tcp_uring_ep_cleanup(iface->uring, ep);
+    }
+
     if (ep->tx.buf != NULL) {
         uct_tcp_ep_ctx_reset(&ep->tx);
     }
@@ -136,7 +157,6 @@ static void uct_tcp_ep_cleanup(uct_tcp_ep_t *ep)
         uct_tcp_ep_ctx_reset(&ep->rx);
     }
 
-    uct_tcp_ep_mod_events(ep, 0, ep->events);
     ucs_close_fd(&ep->fd);
     ucs_close_fd(&ep->stale_fd);
 }
@@ -156,6 +176,7 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_tcp_iface_t *iface,
     uct_tcp_ep_ctx_init(&self->rx);
 
     self->events       = 0;
+    self->uring_ep     = NULL;
     self->conn_retries = 0;
     self->fd           = fd;
     self->stale_fd     = -1;
@@ -164,7 +185,8 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_tcp_iface_t *iface,
     self->conn_sn      = UCT_TCP_CM_CONN_SN_MAX;
 
     ucs_list_head_init(&self->list);
-    ucs_queue_head_init(&self->pending_q);
+    ucs_queue_head_init(&self->pending_q[UCS_ARBITER_PRIO_HIGH]);
+    ucs_queue_head_init(&self->pending_q[UCS_ARBITER_PRIO_NORMAL]);
     ucs_queue_head_init(&self->put_comp_q);
 
     /* Make a socket non-blocking if an EP is created during accepting
@@ -203,7 +225,7 @@ const char *uct_tcp_ep_ctx_caps_str(uint8_t ep_ctx_caps, char *str_buffer)
     return str_buffer;
 }
 
-void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint8_t new_caps)
+void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint16_t new_caps)
 {
     char str_prev_ctx_caps[UCT_TCP_EP_CTX_CAPS_STR_MAX];
     char str_cur_ctx_caps[UCT_TCP_EP_CTX_CAPS_STR_MAX];
@@ -244,12 +266,122 @@ int uct_tcp_ep_failed_remove_filter(const ucs_callbackq_elem_t *elem,
     return (elem->cb == uct_tcp_ep_failed_progress) && (elem->arg == ep);
 }
 
+static uct_tcp_ep_stripe_t *uct_tcp_ep_stripe(uct_tcp_iface_t *iface,
+                                              uct_tcp_ep_t *ep)
+{
+    khiter_t iter;
+
+    ucs_assert(ep->flags & (UCT_TCP_EP_FLAG_STRIPE |
+                            UCT_TCP_EP_FLAG_STRIPE_AUX));
+
+    iter = kh_get(uct_tcp_ep_stripes, &iface->ep_stripes, (uintptr_t)ep);
+    ucs_assert(iter != kh_end(&iface->ep_stripes));
+    return kh_val(&iface->ep_stripes, iter);
+}
+
+static ucs_status_t uct_tcp_ep_stripe_alloc(uct_tcp_iface_t *iface,
+                                            uct_tcp_ep_t *ep, unsigned num_eps,
+                                            uct_tcp_ep_t *parent)
+{
+    uct_tcp_ep_stripe_t *stripe;
+    khiter_t iter;
+    int ret;
+
+    ucs_assert(!(ep->flags & (UCT_TCP_EP_FLAG_STRIPE |
+                              UCT_TCP_EP_FLAG_STRIPE_AUX)));
+
+    stripe = ucs_calloc(1, sizeof(*stripe) + (num_eps * sizeof(*stripe->eps)),
+                        "tcp_ep_stripe");
+    if (stripe == NULL) {
+        ucs_error("tcp_ep %p: failed to allocate striping context", ep);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    iter = kh_put(uct_tcp_ep_stripes, &iface->ep_stripes, (uintptr_t)ep,
+                  &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        ucs_error("tcp_ep %p: failed to add striping context", ep);
+        ucs_free(stripe);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ucs_assert(ret != UCS_KH_PUT_KEY_PRESENT);
+    kh_val(&iface->ep_stripes, iter) = stripe;
+
+    stripe->parent = parent;
+    ep->flags     |= (parent == NULL) ? UCT_TCP_EP_FLAG_STRIPE :
+                                        UCT_TCP_EP_FLAG_STRIPE_AUX;
+    return UCS_OK;
+}
+
+/* A part of a striped PUT sent through an auxiliary EP doesn't block the
+ * parent EP anymore */
+static void uct_tcp_ep_stripe_put_done(uct_tcp_iface_t *iface,
+                                       uct_tcp_ep_t *parent)
+{
+    uct_tcp_ep_stripe_t *stripe = uct_tcp_ep_stripe(iface, parent);
+
+    ucs_assert(parent->flags & UCT_TCP_EP_FLAG_STRIPE_WAIT_ACK);
+    ucs_assert(stripe->num_wait_ack > 0);
+    if (--stripe->num_wait_ack == 0) {
+        parent->flags &= ~UCT_TCP_EP_FLAG_STRIPE_WAIT_ACK;
+    }
+}
+
+static void uct_tcp_ep_stripes_cleanup(uct_tcp_iface_t *iface,
+                                      uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_stripe_t *stripe, *parent_stripe;
+    khiter_t iter;
+    unsigned i;
+
+    if (!(ep->flags & (UCT_TCP_EP_FLAG_STRIPE | UCT_TCP_EP_FLAG_STRIPE_AUX))) {
+        return;
+    }
+
+    stripe = uct_tcp_ep_stripe(iface, ep);
+    if (stripe->parent != NULL) {
+        /* the parent EP may still be used, forget this auxiliary EP */
+        parent_stripe = uct_tcp_ep_stripe(iface, stripe->parent);
+        if (ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK) {
+            uct_tcp_ep_stripe_put_done(iface, stripe->parent);
+        }
+
+        for (i = 0; i < (iface->config.stripe.count - 1); ++i) {
+            if (parent_stripe->eps[i] == ep) {
+                parent_stripe->eps[i] = NULL;
+                break;
+            }
+        }
+    } else {
+        for (i = 0; i < (iface->config.stripe.count - 1); ++i) {
+            if (stripe->eps[i] != NULL) {
+                uct_tcp_ep_destroy_internal(&stripe->eps[i]->super.super);
+                ucs_assert(stripe->eps[i] == NULL);
+            }
+        }
+
+        ucs_assert(stripe->num_wait_ack == 0);
+    }
+
+    /* the auxiliary EPs look up the context of the parent until they are
+     * destroyed, so it's removed last */
+    iter = kh_get(uct_tcp_ep_stripes, &iface->ep_stripes, (uintptr_t)ep);
+    ucs_assert(iter != kh_end(&iface->ep_stripes));
+    kh_del(uct_tcp_ep_stripes, &iface->ep_stripes, iter);
+    ucs_free(stripe);
+    ep->flags &= ~(UCT_TCP_EP_FLAG_STRIPE | UCT_TCP_EP_FLAG_STRIPE_AUX |
+                   UCT_TCP_EP_FLAG_STRIPE_WAIT_ACK);
+}
+
 static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(self->super.super.iface,
                                             uct_tcp_iface_t);
     uct_tcp_ep_put_completion_t *put_comp;
 
+    uct_tcp_ep_stripes_cleanup(iface, self);
+
     if (self->flags & UCT_TCP_EP_FLAG_ON_MATCH_CTX) {
         uct_tcp_cm_remove_ep(iface, self);
     } else {
@@ -290,6 +422,9 @@ void uct_tcp_ep_destroy(uct_ep_h tl_ep)
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                             uct_tcp_iface_t);
 
+    /* auxiliary EPs are used for TX only, release them right away */
+    uct_tcp_ep_stripes_cleanup(iface, ep);
+
     if ((ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
         ucs_test_all_flags(ep->flags, UCT_TCP_EP_CTX_CAPS)) {
         /* remove from the expected queue and then add it to the
@@ -311,6 +446,13 @@ static unsigned uct_tcp_ep_failed_progress(void *arg)
 
     ucs_assert(ep->flags & UCT_TCP_EP_FLAG_FAILED);
 
+    if (ep->flags & UCT_TCP_EP_FLAG_STRIPE_AUX) {
+        /* An auxiliary EP is not visible to the user, just release it and
+         * let the parent EP continue with the remaining connections */
+        uct_tcp_ep_destroy_internal(&ep->super.super);
+        return 1;
+    }
+
     uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CLOSED);
     uct_set_ep_failed(&UCS_CLASS_NAME(uct_tcp_ep_t),
                       &ep->super.super, &iface->super.super,
@@ -414,6 +556,50 @@ static ucs_status_t uct_tcp_ep_create_connected(uct_tcp_iface_t *iface,
     return UCS_OK;
 }
 
+static void uct_tcp_ep_stripes_create(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_stripe_t *stripe = uct_tcp_ep_stripe(iface, ep);
+    uct_tcp_ep_t *stripe_ep;
+    ucs_status_t status;
+    unsigned i;
+    int fd;
+
+    ucs_assert(ep->flags & UCT_TCP_EP_FLAG_STRIPE);
+    stripe->eps_created = 1;
+
+    for (i = 0; i < (iface->config.stripe.count - 1); ++i) {
+        status = ucs_socket_create(AF_INET, SOCK_STREAM, &fd);
+        if (status != UCS_OK) {
+            break;
+        }
+
+        status = uct_tcp_ep_init(iface, fd, &ep->peer_addr, &stripe_ep);
+        if (status != UCS_OK) {
+            ucs_close_fd(&fd);
+            break;
+        }
+
+        /* the parent has to be set prior sending the connection request */
+        status = uct_tcp_ep_stripe_alloc(iface, stripe_ep, 0, ep);
+        if (status != UCS_OK) {
+            uct_tcp_ep_destroy_internal(&stripe_ep->super.super);
+            break;
+        }
+
+        stripe_ep->conn_sn = ep->conn_sn;
+        stripe->eps[i]     = stripe_ep;
+        uct_tcp_ep_add_ctx_cap(stripe_ep, UCT_TCP_EP_FLAG_CTX_TYPE_TX);
+
+        status = uct_tcp_cm_conn_start(stripe_ep);
+        if (status != UCS_OK) {
+            uct_tcp_ep_destroy_internal(&stripe_ep->super.super);
+            break;
+        }
+
+        ucs_debug("tcp_ep %p: created stripe tcp_ep %p", ep, stripe_ep);
+    }
+}
+
 ucs_status_t uct_tcp_ep_create(const uct_ep_params_t *params,
                                uct_ep_h *ep_p)
 {
@@ -466,6 +652,17 @@ out_create_ep:
         }
     }
 
+    /* Striping is used only if the peer is able to accept auxiliary
+     * connections, older peers would fail to parse their requests */
+    if ((iface->config.stripe.count > 1) &&
+        !(ep->flags & UCT_TCP_EP_FLAG_STRIPE) && !uct_tcp_ep_is_self(ep) &&
+        (((const uct_tcp_device_addr_t*)params->dev_addr)->flags &
+         UCT_TCP_DEVICE_ADDR_FLAG_STRIPES)) {
+        /* the EP still works without striping if the allocation failed */
+        uct_tcp_ep_stripe_alloc(iface, ep, iface->config.stripe.count - 1,
+                                NULL);
+    }
+
     /* cppcheck-suppress autoVariables */
     *ep_p = &ep->super.super;
     return UCS_OK;
@@ -485,6 +682,11 @@ void uct_tcp_ep_mod_events(uct_tcp_ep_t *ep, int add, int rem)
         ucs_trace("tcp_ep %p: set events to %c%c", ep,
                   (new_events & UCS_EVENT_SET_EVREAD)  ? 'r' : '-',
                   (new_events & UCS_EVENT_SET_EVWRITE) ? 'w' : '-');
+        if (iface->uring != NULL) {
+            uct_tcp_uring_ep_update(iface->uring, ep);
+            return;
+        }
+
         if (new_events == 0) {
             status = ucs_event_set_del(iface->event_set, ep->fd);
         } else if (old_events != 0) {
@@ -509,6 +711,7 @@ static inline void uct_tcp_ep_handle_put_ack(uct_tcp_ep_t *ep,
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                             uct_tcp_iface_t);
     uct_tcp_ep_put_completion_t *put_comp;
+    uct_tcp_ep_t *parent;
 
     if (put_ack->sn == ep->tx.put_sn) {
         /* Since there are no other PUT operations in-flight, can remove flag
@@ -516,6 +719,18 @@ static inline void uct_tcp_ep_handle_put_ack(uct_tcp_ep_t *ep,
         ucs_assert(ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK);
         ep->flags &= ~UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK;
         uct_tcp_iface_outstanding_dec(iface);
+
+        if (ep->flags & UCT_TCP_EP_FLAG_STRIPE_AUX) {
+            /* The part of a striped PUT was written by the peer, resume
+             * the parent EP if all other parts were written too */
+            parent = uct_tcp_ep_stripe(iface, ep)->parent;
+            uct_tcp_ep_stripe_put_done(iface, parent);
+            if (!(parent->flags & UCT_TCP_EP_FLAG_STRIPE_WAIT_ACK) &&
+                !uct_tcp_ep_pending_is_empty(parent) &&
+                (uct_tcp_ep_check_tx_res(parent) == UCS_OK)) {
+                uct_tcp_ep_pending_queue_dispatch(parent);
+            }
+        }
     }
 
     ucs_queue_for_each_extract(put_comp, &ep->put_comp_q, elem,
@@ -529,11 +744,25 @@ static inline void uct_tcp_ep_handle_put_ack(uct_tcp_ep_t *ep,
 void uct_tcp_ep_pending_queue_dispatch(uct_tcp_ep_t *ep)
 {
     uct_pending_req_priv_queue_t *priv;
+    ucs_arbiter_prio_t prio;
+
+    /* normal priority requests are dispatched only after all high priority
+     * ones were sent */
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        uct_pending_queue_dispatch(priv, &ep->pending_q[prio],
+                                   uct_tcp_ep_ctx_buf_empty(&ep->tx) &&
+                                   !(ep->flags &
+                                     UCT_TCP_EP_FLAG_STRIPE_WAIT_ACK));
+        if (!ucs_queue_is_empty(&ep->pending_q[prio])) {
+            break;
+        }
+    }
 
-    uct_pending_queue_dispatch(priv, &ep->pending_q,
-                               uct_tcp_ep_ctx_buf_empty(&ep->tx));
     if (uct_tcp_ep_ctx_buf_empty(&ep->tx)) {
-        ucs_assert(ucs_queue_is_empty(&ep->pending_q));
+        /* if a striped PUT is in-flight, the pending queue is dispatched
+         * upon receiving its last ACK */
+        ucs_assert(uct_tcp_ep_pending_is_empty(ep) ||
+                   (ep->flags & UCT_TCP_EP_FLAG_STRIPE_WAIT_ACK));
         uct_tcp_ep_mod_events(ep, 0, UCS_EVENT_SET_EVWRITE);
     }
 }
@@ -573,6 +802,7 @@ static void uct_tcp_ep_handle_disconnected(uct_tcp_ep_t *ep, ucs_status_t status
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                             uct_tcp_iface_t);
     uct_tcp_ep_zcopy_tx_t *ctx;
+    uct_tcp_ep_t *parent;
 
     ucs_debug("tcp_ep %p: remote disconnected", ep);
 
@@ -594,6 +824,13 @@ static void uct_tcp_ep_handle_disconnected(uct_tcp_ep_t *ep, ucs_status_t status
              * PUT operation, decrease iface::outstanding counter */
             uct_tcp_iface_outstanding_dec(iface);
             ep->flags &= ~UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK;
+
+            if (ep->flags & UCT_TCP_EP_FLAG_STRIPE_AUX) {
+                /* a part of the parent's PUT may be lost */
+                parent = uct_tcp_ep_stripe(iface, ep)->parent;
+                uct_tcp_ep_stripe_put_done(iface, parent);
+                uct_tcp_ep_set_failed(parent);
+            }
         }
 
         uct_tcp_ep_tx_completed(ep, ep->tx.length - ep->tx.offset);
@@ -637,15 +874,22 @@ static inline ucs_status_t uct_tcp_ep_handle_send_err(uct_tcp_ep_t *ep,
 
 static inline ssize_t uct_tcp_ep_send(uct_tcp_ep_t *ep)
 {
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
     size_t sent_length;
     ucs_status_t status;
 
     ucs_assert(ep->tx.length > ep->tx.offset);
     sent_length = ep->tx.length - ep->tx.offset;
 
-    status = ucs_socket_send_nb(ep->fd,
-                                UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.offset),
-                                &sent_length);
+    if (iface->uring != NULL) {
+        status = uct_tcp_uring_ep_send_result(iface->uring, ep, &sent_length);
+    } else {
+        status = ucs_socket_send_nb(ep->fd,
+                                    UCS_PTR_BYTE_OFFSET(ep->tx.buf,
+                                                        ep->tx.offset),
+                                    &sent_length);
+    }
     if (ucs_unlikely((status != UCS_OK) &&
                      (status != UCS_ERR_NO_PROGRESS))) {
         return uct_tcp_ep_handle_send_err(ep, status);
@@ -659,6 +903,8 @@ static inline ssize_t uct_tcp_ep_send(uct_tcp_ep_t *ep)
 
 static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
 {
+    uct_tcp_iface_t *iface     = ucs_derived_of(ep->super.super.iface,
+                                                uct_tcp_iface_t);
     uct_tcp_ep_zcopy_tx_t *ctx = (uct_tcp_ep_zcopy_tx_t*)ep->tx.buf;
     size_t sent_length;
     ucs_status_t status;
@@ -666,8 +912,13 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
     ucs_assertv((ep->tx.offset < ep->tx.length) &&
                 (ctx->iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, &ctx->iov[ctx->iov_index],
-                                 ctx->iov_cnt - ctx->iov_index, &sent_length);
+    if (iface->uring != NULL) {
+        status = uct_tcp_uring_ep_send_result(iface->uring, ep, &sent_length);
+    } else {
+        status = ucs_socket_sendv_nb(ep->fd, &ctx->iov[ctx->iov_index],
+                                     ctx->iov_cnt - ctx->iov_index,
+                                     &sent_length);
+    }
     if (ucs_unlikely(status != UCS_OK)) {
         if (status == UCS_ERR_NO_PROGRESS) {
             ucs_assert(sent_length == 0);
@@ -811,16 +1062,29 @@ static inline void uct_tcp_ep_handle_recv_err(uct_tcp_ep_t *ep,
     }
 }
 
+/* With io_uring the data was already received to a buffer of the ring, and
+ * is copied from it */
+static inline ucs_status_t
+uct_tcp_ep_recv_nb(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, void *data,
+                   size_t *length_p)
+{
+    if (iface->uring != NULL) {
+        return uct_tcp_uring_ep_recv(iface->uring, ep, data, length_p);
+    }
+
+    return ucs_socket_recv_nb(ep->fd, data, length_p);
+}
+
 static inline unsigned uct_tcp_ep_recv(uct_tcp_ep_t *ep, size_t recv_length)
 {
-    uct_tcp_iface_t UCS_V_UNUSED *iface = ucs_derived_of(ep->super.super.iface,
-                                                         uct_tcp_iface_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
     ucs_status_t status;
 
     ucs_assertv(recv_length != 0, "ep=%p", ep);
 
-    status = ucs_socket_recv_nb(ep->fd, UCS_PTR_BYTE_OFFSET(ep->rx.buf,
-                                                            ep->rx.length),
+    status = uct_tcp_ep_recv_nb(iface, ep,
+                                UCS_PTR_BYTE_OFFSET(ep->rx.buf, ep->rx.length),
                                 &recv_length);
     if (ucs_unlikely(status != UCS_OK)) {
         uct_tcp_ep_handle_recv_err(ep, status);
@@ -875,13 +1139,13 @@ static unsigned uct_tcp_ep_progress_data_tx(uct_tcp_ep_t *ep)
         uct_tcp_ep_post_put_ack(ep);
     }
 
-    if (!ucs_queue_is_empty(&ep->pending_q)) {
+    if (!uct_tcp_ep_pending_is_empty(ep)) {
         uct_tcp_ep_pending_queue_dispatch(ep);
         return ret;
     }
 
     if (uct_tcp_ep_ctx_buf_empty(&ep->tx)) {
-        ucs_assert(ucs_queue_is_empty(&ep->pending_q));
+        ucs_assert(uct_tcp_ep_pending_is_empty(ep));
         uct_tcp_ep_mod_events(ep, 0, UCS_EVENT_SET_EVWRITE);
     }
 
@@ -1099,13 +1363,16 @@ err_no_res:
 
 static unsigned uct_tcp_ep_progress_put_rx(uct_tcp_ep_t *ep)
 {
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
     uct_tcp_ep_put_req_hdr_t *put_req;
     size_t recv_length;
     ucs_status_t status;
 
     put_req     = (uct_tcp_ep_put_req_hdr_t*)ep->rx.buf;
     recv_length = put_req->length;
-    status      = ucs_socket_recv_nb(ep->fd, (void*)(uintptr_t)put_req->addr,
+    status      = uct_tcp_ep_recv_nb(iface, ep,
+                                     (void*)(uintptr_t)put_req->addr,
                                      &recv_length);
     if (ucs_unlikely(status != UCS_OK)) {
         uct_tcp_ep_handle_recv_err(ep, status);
@@ -1134,6 +1401,7 @@ static unsigned uct_tcp_ep_progress_magic_number_rx(uct_tcp_ep_t *ep)
                                             uct_tcp_iface_t);
     char str_local_addr[UCS_SOCKADDR_STRING_LEN];
     char str_remote_addr[UCS_SOCKADDR_STRING_LEN];
+    struct linger linger = {.l_onoff = 1, .l_linger = 0};
     size_t recv_length, prev_length;
     uint64_t magic_number;
 
@@ -1169,6 +1437,12 @@ static unsigned uct_tcp_ep_progress_magic_number_rx(uct_tcp_ep_t *ep)
                   UCT_TCP_MAGIC_NUMBER, magic_number, ep,
                   ep->fd, ucs_socket_getname_str(ep->fd, str_remote_addr,
                                                  UCS_SOCKADDR_STRING_LEN));
+        if (iface->uring != NULL) {
+            /* The ring has already read the rest of the peer's data from
+             * the socket, so closing it would not reset the connection */
+            ucs_socket_setopt(ep->fd, SOL_SOCKET, SO_LINGER, &linger,
+                              sizeof(linger));
+        }
         goto err;
     }
 
@@ -1253,8 +1527,8 @@ uct_tcp_ep_am_sendv(uct_tcp_ep_t *ep, int short_sendv, uct_tcp_am_hdr_t *hdr,
                     size_t send_limit, const void *header,
                     struct iovec *iov, size_t iov_cnt)
 {
-    uct_tcp_iface_t UCS_V_UNUSED *iface = ucs_derived_of(ep->super.super.iface,
-                                                         uct_tcp_iface_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
     ucs_status_t status;
     size_t sent_length;
 
@@ -1263,7 +1537,13 @@ uct_tcp_ep_am_sendv(uct_tcp_ep_t *ep, int short_sendv, uct_tcp_am_hdr_t *hdr,
     ucs_assertv((ep->tx.length <= send_limit) &&
                 (iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, &sent_length);
+    if (iface->uring != NULL) {
+        /* The IOVs are sent by the ring after the caller saves them in the
+         * TX buffer */
+        status = uct_tcp_uring_ep_send_result(iface->uring, ep, &sent_length);
+    } else {
+        status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, &sent_length);
+    }
     if (ucs_unlikely((status != UCS_OK) && (status != UCS_ERR_NO_PROGRESS))) {
         return uct_tcp_ep_handle_send_err(ep, status);
     }
@@ -1434,12 +1714,13 @@ ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
 static inline ucs_status_t
 uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id,
                          const void *header, unsigned header_length,
-                         const uct_iov_t *iov, size_t iovcnt, const char *name,
-                         size_t *zcopy_payload_p, uct_tcp_ep_zcopy_tx_t **ctx_p)
+                         const uct_iov_t *iov, size_t iovcnt,
+                         ucs_iov_iter_t *uct_iov_iter_p, size_t max_length,
+                         const char *name, size_t *zcopy_payload_p,
+                         uct_tcp_ep_zcopy_tx_t **ctx_p)
 {
     uct_tcp_am_hdr_t *hdr = NULL;
     size_t io_vec_cnt;
-    ucs_iov_iter_t uct_iov_iter;
     uct_tcp_ep_zcopy_tx_t *ctx;
     ucs_status_t status;
 
@@ -1469,11 +1750,12 @@ uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id
         ctx->iov_cnt++;
     }
 
-    /* User-defined payload */
-    ucs_iov_iter_init(&uct_iov_iter);
-    io_vec_cnt       = iovcnt; 
+    /* User-defined payload, starting from the current position of the
+     * iterator */
+    io_vec_cnt       = iovcnt;
     *zcopy_payload_p = uct_iov_to_iovec(&ctx->iov[ctx->iov_cnt], &io_vec_cnt,
-                                        iov, iovcnt, SIZE_MAX, &uct_iov_iter);
+                                        iov, iovcnt, max_length,
+                                        uct_iov_iter_p);
     *ctx_p           = ctx;
     ctx->iov_cnt    += io_vec_cnt;
 
@@ -1489,6 +1771,7 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
     uct_tcp_iface_t *iface     = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
     uct_tcp_ep_zcopy_tx_t *ctx = NULL;
     size_t payload_length      = 0;
+    ucs_iov_iter_t uct_iov_iter;
     ucs_status_t status;
 
     UCT_CHECK_LENGTH(header_length + uct_iov_total_length(iov, iovcnt), 0,
@@ -1496,9 +1779,10 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
                      "am_zcopy");
     UCT_CHECK_AM_ID(am_id);
 
+    ucs_iov_iter_init(&uct_iov_iter);
     status = uct_tcp_ep_prepare_zcopy(iface, ep, am_id, header, header_length,
-                                      iov, iovcnt, "am_zcopy", &payload_length,
-                                      &ctx);
+                                      iov, iovcnt, &uct_iov_iter, SIZE_MAX,
+                                      "am_zcopy", &payload_length, &ctx);
     if (ucs_unlikely(status != UCS_OK)) {
         return status;
     }
@@ -1522,23 +1806,21 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
     return UCS_OK;
 }
 
-ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
-                                  size_t iovcnt, uint64_t remote_addr,
-                                  uct_rkey_t rkey, uct_completion_t *comp)
+static ucs_status_t
+uct_tcp_ep_put_zcopy_post(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
+                          const uct_iov_t *iov, size_t iovcnt,
+                          ucs_iov_iter_t *uct_iov_iter_p, size_t max_length,
+                          uint64_t remote_addr, uct_completion_t *comp,
+                          size_t *length_p)
 {
-    uct_tcp_ep_t *ep                 = ucs_derived_of(uct_ep, uct_tcp_ep_t);
-    uct_tcp_iface_t *iface           = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
     uct_tcp_ep_zcopy_tx_t *ctx       = NULL;
     uct_tcp_ep_put_req_hdr_t put_req = {0}; /* Suppress Cppcheck false-positive */
     ucs_status_t status;
 
-    UCT_CHECK_LENGTH(sizeof(put_req) + uct_iov_total_length(iov, iovcnt), 0,
-                     UCT_TCP_EP_PUT_ZCOPY_MAX - sizeof(uct_tcp_am_hdr_t),
-                     "put_zcopy");
-
     status = uct_tcp_ep_prepare_zcopy(iface, ep, UCT_TCP_EP_PUT_REQ_AM_ID,
                                       &put_req, sizeof(put_req),
-                                      iov, iovcnt, "put_zcopy",
+                                      iov, iovcnt, uct_iov_iter_p, max_length,
+                                      "put_zcopy",
                                       /* Set a payload length directly to the
                                        * TX length, since PUT Zcopy doesn't
                                        * set the payload length to TCP AM hdr */
@@ -1551,6 +1833,7 @@ ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
     put_req.addr      = remote_addr;
     put_req.length    = ep->tx.length;
     put_req.sn        = ep->tx.put_sn + 1;
+    *length_p         = put_req.length;
 
     status = uct_tcp_ep_am_sendv(ep, 0, &ctx->super, UCT_TCP_EP_PUT_ZCOPY_MAX,
                                  &put_req, ctx->iov, ctx->iov_cnt);
@@ -1581,6 +1864,127 @@ ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
     return UCS_OK;
 }
 
+static ucs_status_t
+uct_tcp_ep_put_zcopy_striped(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
+                             const uct_iov_t *iov, size_t iovcnt,
+                             size_t length, uint64_t remote_addr,
+                             uct_completion_t *comp)
+{
+    uct_tcp_ep_stripe_t *stripe = uct_tcp_ep_stripe(iface, ep);
+    unsigned num_stripe_eps     = 0;
+    unsigned num_posted         = 0;
+    unsigned num_inprogress     = 0;
+    uct_tcp_ep_t *stripe_eps[UCT_TCP_EP_MAX_STRIPES];
+    ucs_iov_iter_t uct_iov_iter, prev_uct_iov_iter;
+    size_t chunk_length, sent_length;
+    ucs_status_t status;
+    unsigned i;
+
+    /* If the EP has resources, none of its auxiliary EPs waits for PUT ACK,
+     * so the connected ones are idle */
+    if (uct_tcp_ep_check_tx_res(ep) == UCS_OK) {
+        if (!stripe->eps_created) {
+            /* The connections are established asynchronously, so they will
+             * be used starting from the next operations */
+            uct_tcp_ep_stripes_create(iface, ep);
+        } else {
+            for (i = 0; i < (iface->config.stripe.count - 1); ++i) {
+                if ((stripe->eps[i] != NULL) &&
+                    (uct_tcp_ep_check_tx_res(stripe->eps[i]) == UCS_OK)) {
+                    stripe_eps[num_stripe_eps++] = stripe->eps[i];
+                }
+            }
+        }
+    }
+
+    ucs_iov_iter_init(&uct_iov_iter);
+    chunk_length = length / (num_stripe_eps + 1);
+
+    /* Every part is written by the peer directly to its place in the remote
+     * buffer, so the parts don't need to be ordered */
+    for (i = 0; i < num_stripe_eps; ++i) {
+        prev_uct_iov_iter = uct_iov_iter;
+        status = uct_tcp_ep_put_zcopy_post(iface, stripe_eps[i], iov, iovcnt,
+                                           &uct_iov_iter, chunk_length,
+                                           remote_addr, comp, &sent_length);
+        if (status == UCS_INPROGRESS) {
+            ++num_inprogress;
+        } else if (status != UCS_OK) {
+            /* The rest of the payload is sent by the EP itself */
+            uct_iov_iter = prev_uct_iov_iter;
+            break;
+        }
+
+        ucs_assert(stripe_eps[i]->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK);
+        remote_addr += sent_length;
+        ++num_posted;
+    }
+
+    /* The EP sends the remaining part, including a part which couldn't be
+     * posted on an auxiliary EP */
+    status = uct_tcp_ep_put_zcopy_post(iface, ep, iov, iovcnt, &uct_iov_iter,
+                                       SIZE_MAX, remote_addr, comp,
+                                       &sent_length);
+
+    /* Block the EP until the peer acknowledges all parts sent through the
+     * auxiliary EPs */
+    stripe->num_wait_ack += num_posted;
+    if (num_posted != 0) {
+        ep->flags |= UCT_TCP_EP_FLAG_STRIPE_WAIT_ACK;
+    }
+
+    if (status == UCS_INPROGRESS) {
+        ++num_inprogress;
+    } else if (status != UCS_OK) {
+        if ((num_inprogress == 0) || (comp == NULL)) {
+            return status;
+        }
+
+        /* Some parts are still in-flight, report the error to the user from
+         * the completion callback */
+        if (comp->status == UCS_OK) {
+            comp->status = status;
+        }
+    }
+
+    if (num_inprogress == 0) {
+        return UCS_OK;
+    }
+
+    if (comp != NULL) {
+        /* The completion is shared by all parts of the operation */
+        comp->count += num_inprogress - 1;
+    }
+
+    return UCS_INPROGRESS;
+}
+
+ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep       = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
+    size_t length          = uct_iov_total_length(iov, iovcnt);
+    ucs_iov_iter_t uct_iov_iter;
+    size_t sent_length;
+
+    UCT_CHECK_LENGTH(sizeof(uct_tcp_ep_put_req_hdr_t) + length, 0,
+                     UCT_TCP_EP_PUT_ZCOPY_MAX - sizeof(uct_tcp_am_hdr_t),
+                     "put_zcopy");
+
+    if ((ep->flags & UCT_TCP_EP_FLAG_STRIPE) &&
+        (length >= iface->config.stripe.thresh)) {
+        return uct_tcp_ep_put_zcopy_striped(iface, ep, iov, iovcnt, length,
+                                            remote_addr, comp);
+    }
+
+    ucs_iov_iter_init(&uct_iov_iter);
+    return uct_tcp_ep_put_zcopy_post(iface, ep, iov, iovcnt, &uct_iov_iter,
+                                     SIZE_MAX, remote_addr, comp,
+                                     &sent_length);
+}
+
 ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
                                     unsigned flags)
 {
@@ -1590,7 +1994,8 @@ ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
         return UCS_ERR_BUSY;
     }
 
-    uct_pending_req_queue_push(&ep->pending_q, req);
+    uct_pending_req_queue_push(&ep->pending_q[uct_pending_req_prio(flags)],
+                               req);
     UCT_TL_EP_STAT_PEND(&ep->super);
     return UCS_OK;
 }
@@ -1600,8 +2005,11 @@ void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
 {
     uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
     uct_pending_req_priv_queue_t UCS_V_UNUSED *priv;
+    ucs_arbiter_prio_t prio;
 
-    uct_pending_queue_purge(priv, &ep->pending_q, 1, cb, arg);
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        uct_pending_queue_purge(priv, &ep->pending_q[prio], 1, cb, arg);
+    }
 }
 
 ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
@@ -1621,7 +2029,6 @@ ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
     }
 
     if (uct_tcp_ep_check_tx_res(ep) == UCS_ERR_NO_RESOURCE) {
-        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
         return UCS_ERR_NO_RESOURCE;
     }
 
@@ -1637,6 +2044,7 @@ ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
             ucs_queue_push(&ep->put_comp_q, &put_comp->elem);
         }
 
+        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
         return UCS_INPROGRESS;
     }
 
@@ -85,6 +85,36 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "let the operating system select the port number.",
    ucs_offsetof(uct_tcp_iface_config_t, port_range), UCS_CONFIG_TYPE_RANGE_SPEC},
 
+  {"IO_URING", "n",
+   "Use io_uring instead of epoll and socket system calls. Sends of all endpoints\n"
+   "are posted to the ring and submitted in a batch once per progress call, and\n"
+   "every connection has a multishot receive which fills buffers registered\n"
+   "with the ring. Completions are reaped without system calls, so an idle\n"
+   "progress call does not enter the kernel.\n"
+   " - no  : use epoll.\n"
+   " - try : use io_uring if it is supported by the kernel, otherwise epoll.\n"
+   " - yes : use io_uring, fail if it is not supported.",
+   ucs_offsetof(uct_tcp_iface_config_t, io_uring), UCS_CONFIG_TYPE_TERNARY},
+
+  {"IO_URING_SQPOLL", "n",
+   "Submit io_uring requests by a kernel thread which polls the submission queue,\n"
+   "instead of a system call. Requires IO_URING to be enabled, and a spare CPU\n"
+   "core for the kernel thread, otherwise it competes with the application.",
+   ucs_offsetof(uct_tcp_iface_config_t, io_uring_sqpoll), UCS_CONFIG_TYPE_BOOL},
+
+  {"STRIPES", "1",
+   "Number of sockets used by an endpoint to send large PUT Zcopy payloads.\n"
+   "If greater than 1, additional connections to the peer are established upon\n"
+   "the first large PUT Zcopy, and the payload of each next one is split between\n"
+   "the connections which are idle, so that a single transfer is not limited by\n"
+   "the throughput of one TCP stream.",
+   ucs_offsetof(uct_tcp_iface_config_t, stripes), UCS_CONFIG_TYPE_UINT},
+
+  {"STRIPE_THRESH", "256kb",
+   "Minimal PUT Zcopy payload size which is split between the sockets of an\n"
+   "endpoint, when STRIPES is greater than 1",
+   ucs_offsetof(uct_tcp_iface_config_t, stripe_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
   {NULL}
 };
 
@@ -94,9 +124,20 @@ static UCS_CLASS_DEFINE_DELETE_FUNC(uct_tcp_iface_t, uct_iface_t);
 static ucs_status_t uct_tcp_iface_get_device_address(uct_iface_h tl_iface,
                                                      uct_device_addr_t *addr)
 {
-    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
-
-    *(struct sockaddr_in*)addr = iface->config.ifaddr;
+    uct_tcp_iface_t *iface          = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+    uct_tcp_device_addr_t *dev_addr = (uct_tcp_device_addr_t*)addr;
+
+    UCS_STATIC_ASSERT(sizeof(uct_tcp_device_addr_t) ==
+                      sizeof(struct sockaddr_in));
+    UCS_STATIC_ASSERT(ucs_offsetof(uct_tcp_device_addr_t, sin_addr) ==
+                      ucs_offsetof(struct sockaddr_in, sin_addr));
+
+    memset(dev_addr, 0, sizeof(*dev_addr));
+    dev_addr->sin_family = iface->config.ifaddr.sin_family;
+    dev_addr->sin_port   = iface->config.ifaddr.sin_port;
+    dev_addr->sin_addr   = iface->config.ifaddr.sin_addr;
+    /* let the peers know that auxiliary connections are accepted */
+    dev_addr->flags      = UCT_TCP_DEVICE_ADDR_FLAG_STRIPES;
     return UCS_OK;
 }
 
@@ -133,7 +174,7 @@ static ucs_status_t uct_tcp_iface_query(uct_iface_h tl_iface, uct_iface_attr_t *
     }
 
     attr->iface_addr_len   = sizeof(in_port_t);
-    attr->device_addr_len  = sizeof(struct sockaddr_in);
+    attr->device_addr_len  = sizeof(uct_tcp_device_addr_t);
     attr->cap.flags        = UCT_IFACE_FLAG_CONNECT_TO_IFACE |
                              UCT_IFACE_FLAG_AM_SHORT         |
                              UCT_IFACE_FLAG_AM_BCOPY         |
@@ -190,9 +231,26 @@ static ucs_status_t uct_tcp_iface_event_fd_get(uct_iface_h tl_iface, int *fd_p)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
 
+    if (iface->uring != NULL) {
+        *fd_p = uct_tcp_uring_fd(iface->uring);
+        return UCS_OK;
+    }
+
     return ucs_event_set_fd_get(iface->event_set, fd_p);
 }
 
+static ucs_status_t uct_tcp_iface_event_arm(uct_iface_h tl_iface,
+                                            unsigned events)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+
+    if (iface->uring != NULL) {
+        return uct_tcp_uring_arm(iface->uring);
+    }
+
+    return UCS_OK;
+}
+
 static void uct_tcp_iface_handle_events(void *callback_data,
                                         int events, void *arg)
 {
@@ -217,6 +275,10 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
     unsigned read_events;
     ucs_status_t status;
 
+    if (iface->uring != NULL) {
+        return uct_tcp_uring_progress(iface->uring, max_events);
+    }
+
     do {
         read_events = ucs_min(ucs_sys_event_set_max_wait_events, max_events);
         status = ucs_event_set_wait(iface->event_set, &read_events,
@@ -318,7 +380,7 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .iface_progress_disable   = uct_base_iface_progress_disable,
     .iface_progress           = uct_tcp_iface_progress,
     .iface_event_fd_get       = uct_tcp_iface_event_fd_get,
-    .iface_event_arm          = ucs_empty_function_return_success,
+    .iface_event_arm          = uct_tcp_iface_event_arm,
     .iface_close              = UCS_CLASS_DELETE_FUNC_NAME(uct_tcp_iface_t),
     .iface_query              = uct_tcp_iface_query,
     .iface_get_address        = uct_tcp_iface_get_address,
@@ -528,6 +590,13 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         return UCS_ERR_INVALID_PARAM;
     }
 
+    if ((config->stripes == 0) || (config->stripes > UCT_TCP_EP_MAX_STRIPES)) {
+        ucs_error("unsupported value was specified (%u) for the number of "
+                  "stripes, expected from 1 to %u", config->stripes,
+                  UCT_TCP_EP_MAX_STRIPES);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
     self->config.zcopy.max_hdr     = self->config.tx_seg_size -
                                      self->config.zcopy.hdr_offset;
     self->config.prefer_default    = config->prefer_default;
@@ -536,6 +605,8 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     self->config.max_poll          = config->max_poll;
     self->config.max_conn_retries  = config->max_conn_retries;
     self->config.syn_cnt           = config->syn_cnt;
+    self->config.stripe.count      = config->stripes;
+    self->config.stripe.thresh     = config->stripe_thresh;
     self->sockopt.nodelay          = config->sockopt_nodelay;
     self->sockopt.sndbuf           = config->sockopt.sndbuf;
     self->sockopt.rcvbuf           = config->sockopt.rcvbuf;
@@ -549,6 +620,7 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     ucs_conn_match_init(&self->conn_match_ctx,
                         ucs_field_sizeof(uct_tcp_ep_t, peer_addr),
                         &uct_tcp_cm_conn_match_ops);
+    kh_init_inplace(uct_tcp_ep_stripes, &self->ep_stripes);
 
     if (self->config.tx_seg_size > self->config.rx_seg_size) {
         ucs_error("RX segment size (%zu) must be >= TX segment size (%zu)",
@@ -588,13 +660,36 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         goto err_cleanup_rx_mpool;
     }
 
+    self->uring = NULL;
+    if (config->io_uring != UCS_NO) {
+        status = uct_tcp_uring_create(self, UCT_TCP_URING_ENTRIES,
+                                      config->io_uring_sqpoll, &self->uring);
+        if (status != UCS_OK) {
+            if (config->io_uring == UCS_YES) {
+                ucs_error("tcp_iface %p: failed to create io_uring: %s", self,
+                          ucs_status_string(status));
+                goto err_cleanup_event_set;
+            }
+            ucs_debug("tcp_iface %p: io_uring is not available, using epoll",
+                      self);
+        } else {
+            /* The ring sends after AM Short returns, so the user's payload
+             * must be always copied to the TX buffer */
+            self->config.sendv_thresh = UCS_MEMUNITS_INF;
+        }
+    }
+
     status = uct_tcp_iface_listener_init(self);
     if (status != UCS_OK) {
-        goto err_cleanup_event_set;
+        goto err_destroy_uring;
     }
 
     return UCS_OK;
 
+err_destroy_uring:
+    if (self->uring != NULL) {
+        uct_tcp_uring_destroy(self->uring);
+    }
 err_cleanup_event_set:
     ucs_event_set_cleanup(self->event_set);
 err_cleanup_rx_mpool:
@@ -607,9 +702,12 @@ err:
 
 static void uct_tcp_iface_ep_list_cleanup(uct_tcp_iface_t *iface)
 {
-    uct_tcp_ep_t *ep, *tmp;
+    uct_tcp_ep_t *ep;
 
-    ucs_list_for_each_safe(ep, tmp, &iface->ep_list, list) {
+    /* Destroying an EP may destroy its auxiliary EPs from the same list,
+     * so always take the list head */
+    while (!ucs_list_is_empty(&iface->ep_list)) {
+        ep = ucs_list_head(&iface->ep_list, uct_tcp_ep_t, list);
         uct_tcp_ep_destroy_internal(&ep->super.super);
     }
 }
@@ -663,6 +761,13 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_iface_t)
 
     uct_tcp_iface_ep_list_cleanup(self);
     ucs_conn_match_cleanup(&self->conn_match_ctx);
+    ucs_assert(kh_size(&self->ep_stripes) == 0);
+    kh_destroy_inplace(uct_tcp_ep_stripes, &self->ep_stripes);
+
+    /* The ring returns the TX buffers of canceled sends to the pool */
+    if (self->uring != NULL) {
+        uct_tcp_uring_destroy(self->uring);
+    }
 
     ucs_mpool_cleanup(&self->rx_mpool, 1);
     ucs_mpool_cleanup(&self->tx_mpool, 1);
@@ -0,0 +1,1135 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "tcp.h"
+
+#include <ucs/debug/memtrack.h>
+#include <ucs/type/spinlock.h>
+
+
+#if HAVE_DECL___NR_IO_URING_SETUP && HAVE_DECL___NR_IO_URING_REGISTER && \
+    HAVE_DECL_IORING_FEAT_NODROP && HAVE_DECL_IORING_REGISTER_PBUF_RING && \
+    HAVE_DECL_IORING_RECV_MULTISHOT
+
+#include <ucs/arch/cpu.h>
+#include <ucs/sys/sock.h>
+#include <ucs/time/time.h>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <sched.h>
+
+
+#ifdef IORING_ENTER_SQ_WAIT
+#  define UCT_TCP_URING_ENTER_SQ_WAIT   IORING_ENTER_SQ_WAIT
+#else
+#  define UCT_TCP_URING_ENTER_SQ_WAIT   0
+#endif
+
+
+/* Idle time of the kernel submission thread before it goes to sleep, msec */
+#define UCT_TCP_URING_SQ_THREAD_IDLE    100
+
+/* Group ID of the receive buffers provided to the ring */
+#define UCT_TCP_URING_RX_BGID           0
+
+/* How long to wait for the requests canceled by destroyed endpoints when
+ * the ring is destroyed, seconds */
+#define UCT_TCP_URING_DRAIN_TIMEOUT     1.0
+
+
+/* Operations posted for an endpoint. The operation is kept in the lowest bits
+ * of the request's user data, and the address of the context in the others */
+enum {
+    UCT_TCP_URING_OP_RECV = 0, /* Multishot receive */
+    UCT_TCP_URING_OP_POLL = 1, /* Wait for the socket to become writable */
+    UCT_TCP_URING_OP_SEND = 2, /* Send of the endpoint's TX buffer */
+    UCT_TCP_URING_OP_LAST,
+    UCT_TCP_URING_OP_MASK = 3
+};
+
+
+enum {
+    /* The request is posted to the ring */
+    UCT_TCP_URING_FLAG_ARMED       = UCS_BIT(0),
+    /* Cancellation of the posted request is posted to the ring */
+    UCT_TCP_URING_FLAG_CANCELED    = UCS_BIT(1)
+};
+
+
+enum {
+    /* The context waits in the TX queue for a send or a poll request */
+    UCT_TCP_URING_EP_FLAG_TX_QUEUED = UCS_BIT(0),
+    /* Result of the completed send was not consumed by the endpoint yet */
+    UCT_TCP_URING_EP_FLAG_TX_DONE   = UCS_BIT(1),
+    /* The context is in the list of contexts with RX backlog */
+    UCT_TCP_URING_EP_FLAG_RX_QUEUED = UCS_BIT(2)
+};
+
+
+/**
+ * io_uring context of TCP endpoint. It is allocated separately from the
+ * endpoint, since it has to outlive the endpoint until all its requests
+ * complete.
+ */
+struct uct_tcp_uring_ep {
+    uct_tcp_ep_t         *ep;          /* Endpoint, NULL if it was destroyed */
+    ucs_list_link_t      list;         /* Entry in the list of contexts */
+    ucs_list_link_t      tx_list;      /* Entry in the TX queue */
+    ucs_list_link_t      rx_list;      /* Entry in the RX backlog list */
+    int                  in_progress;  /* Completion callback is running */
+    uint8_t              flags;        /* Context flags */
+    uint8_t              op_flags[UCT_TCP_URING_OP_LAST]; /* Per-request flags */
+    struct {
+        int              fd;           /* Socket of the posted receive */
+        const void       *data;        /* Received data not consumed yet */
+        size_t           length;       /* Length of the data */
+        ucs_status_t     status;       /* Error to report when the data is
+                                          consumed */
+        void             *backlog;     /* Data which the endpoint did not
+                                          consume in its callback */
+        size_t           backlog_offset;
+        size_t           backlog_length;
+    } rx;
+    struct {
+        struct msghdr    msg;          /* Message of the posted vector send */
+        int              result;       /* Result of the completed send */
+        void             *buf;         /* TX buffer taken over from the
+                                          destroyed endpoint, which is still
+                                          referenced by the posted send */
+    } tx;
+};
+
+
+struct uct_tcp_uring {
+    int                  fd;          /* io_uring file descriptor */
+    int                  sqpoll;      /* Submission is done by kernel thread */
+    int                  in_progress; /* Completions are being processed, so
+                                         new requests are submitted at once
+                                         when the processing is done */
+    ucs_spinlock_t       lock;        /* Protects submission queue and
+                                         contexts, since events may be
+                                         modified from async thread */
+    ucs_list_link_t      eps;         /* List of contexts */
+    ucs_list_link_t      tx_queue;    /* Contexts which need a TX request */
+    ucs_list_link_t      rx_backlog;  /* Contexts with received data which
+                                         the endpoint did not consume */
+    void                 *ring;       /* Mapped SQ and CQ rings */
+    size_t               ring_size;   /* Size of the mapped rings */
+    struct io_uring_sqe  *sqes;       /* Submission queue entries */
+    size_t               sqes_size;   /* Size of submission queue entries */
+    struct {
+        unsigned         *khead;      /* Consumed by the kernel */
+        unsigned         *ktail;      /* Published to the kernel */
+        unsigned         *kflags;     /* Kernel flags (NEED_WAKEUP) */
+        unsigned         *array;      /* Indices of SQEs */
+        unsigned         mask;        /* Ring mask */
+        unsigned         entries;     /* Number of entries */
+        unsigned         tail;        /* Local tail, published on submit */
+        unsigned         pending;     /* Filled, but not yet submitted */
+    } sq;
+    struct {
+        unsigned         *khead;      /* Consumed by us */
+        unsigned         *ktail;      /* Produced by the kernel */
+        unsigned         mask;        /* Ring mask */
+        struct io_uring_cqe *cqes;    /* Completion queue entries */
+    } cq;
+    struct {
+        struct io_uring_buf_ring *ring; /* Ring of the provided buffers */
+        size_t           ring_size;   /* Size of the ring */
+        void             *bufs;       /* Receive buffers */
+        size_t           buf_size;    /* Size of a receive buffer */
+        uint16_t         tail;        /* Local tail of the ring */
+    } rx;
+};
+
+
+static int uct_tcp_uring_enter(uct_tcp_uring_t *uring, unsigned to_submit,
+                               unsigned min_complete, unsigned flags)
+{
+    return syscall(__NR_io_uring_enter, uring->fd, to_submit, min_complete,
+                   flags, NULL, 0);
+}
+
+/* Must be called with the lock held */
+static void uct_tcp_uring_submit(uct_tcp_uring_t *uring)
+{
+    int ret;
+
+    if (uring->sq.pending == 0) {
+        return;
+    }
+
+    /* Make SQEs visible before the tail */
+    ucs_memory_cpu_store_fence();
+    *uring->sq.ktail = uring->sq.tail;
+
+    if (uring->sqpoll) {
+        uring->sq.pending = 0;
+        /* The tail store must be ordered with the flags load, otherwise the
+         * kernel thread may go to sleep without noticing the new entries */
+        ucs_memory_bus_fence();
+        if (*uring->sq.kflags & IORING_SQ_NEED_WAKEUP) {
+            uct_tcp_uring_enter(uring, 0, 0, IORING_ENTER_SQ_WAKEUP);
+        }
+        return;
+    }
+
+    ret = uct_tcp_uring_enter(uring, uring->sq.pending, 0, 0);
+    if (ret >= 0) {
+        uring->sq.pending -= ret;
+    } else if ((errno != EAGAIN) && (errno != EBUSY) && (errno != EINTR)) {
+        ucs_error("io_uring_enter(fd=%d, to_submit=%u) failed: %m",
+                  uring->fd, uring->sq.pending);
+    }
+}
+
+/* Must be called with the lock held */
+static struct io_uring_sqe *uct_tcp_uring_get_sqe(uct_tcp_uring_t *uring)
+{
+    struct io_uring_sqe *sqe;
+    unsigned index;
+
+    while ((uring->sq.tail - *(volatile unsigned*)uring->sq.khead) >=
+           uring->sq.entries) {
+        uct_tcp_uring_submit(uring);
+        if (uring->sqpoll) {
+            uct_tcp_uring_enter(uring, 0, 0, IORING_ENTER_SQ_WAKEUP |
+                                             UCT_TCP_URING_ENTER_SQ_WAIT);
+        }
+        ucs_memory_cpu_load_fence();
+    }
+
+    index                    = uring->sq.tail & uring->sq.mask;
+    sqe                      = &uring->sqes[index];
+    uring->sq.array[index]   = index;
+    ++uring->sq.tail;
+    ++uring->sq.pending;
+
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+static struct io_uring_sqe *
+uct_tcp_uring_ep_post(uct_tcp_uring_t *uring, uct_tcp_uring_ep_t *uep,
+                      int op, uint8_t opcode)
+{
+    struct io_uring_sqe *sqe = uct_tcp_uring_get_sqe(uring);
+
+    sqe->opcode         = opcode;
+    sqe->fd             = uep->ep->fd;
+    sqe->user_data      = (uintptr_t)uep | op;
+    uep->op_flags[op]  |= UCT_TCP_URING_FLAG_ARMED;
+    return sqe;
+}
+
+static void uct_tcp_uring_ep_rx_backlog_free(uct_tcp_uring_t *uring,
+                                             uct_tcp_uring_ep_t *uep)
+{
+    if (uep->flags & UCT_TCP_URING_EP_FLAG_RX_QUEUED) {
+        ucs_list_del(&uep->rx_list);
+        uep->flags &= ~UCT_TCP_URING_EP_FLAG_RX_QUEUED;
+    }
+
+    ucs_free(uep->rx.backlog);
+    uep->rx.backlog        = NULL;
+    uep->rx.backlog_offset = 0;
+    uep->rx.backlog_length = 0;
+}
+
+static void uct_tcp_uring_ep_post_recv(uct_tcp_uring_t *uring,
+                                       uct_tcp_uring_ep_t *uep)
+{
+    struct io_uring_sqe *sqe;
+
+    /* The receive stays posted and completes every time the data arrives,
+     * taking a buffer from the ring */
+    sqe            = uct_tcp_uring_ep_post(uring, uep, UCT_TCP_URING_OP_RECV,
+                                           IORING_OP_RECV);
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = UCT_TCP_URING_RX_BGID;
+
+    if (uep->rx.fd != uep->ep->fd) {
+        /* Drop what was left from the previous socket */
+        uct_tcp_uring_ep_rx_backlog_free(uring, uep);
+        uep->rx.fd = uep->ep->fd;
+    }
+    uep->rx.status = UCS_OK;
+}
+
+static void uct_tcp_uring_ep_post_tx(uct_tcp_uring_t *uring,
+                                     uct_tcp_uring_ep_t *uep)
+{
+    uct_tcp_ep_t *ep = uep->ep;
+    uct_tcp_ep_zcopy_tx_t *ctx;
+    struct io_uring_sqe *sqe;
+
+    if ((ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED) ||
+        (ep->tx.offset == ep->tx.length) ||
+        (uep->flags & UCT_TCP_URING_EP_FLAG_TX_DONE)) {
+        /* Nothing to send, or the result of the previous send was not
+         * consumed yet: wait until the socket is writable, as epoll does */
+        sqe                = uct_tcp_uring_ep_post(uring, uep,
+                                                   UCT_TCP_URING_OP_POLL,
+                                                   IORING_OP_POLL_ADD);
+        sqe->poll32_events = POLLOUT;
+    } else if (!(ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX)) {
+        sqe            = uct_tcp_uring_ep_post(uring, uep,
+                                               UCT_TCP_URING_OP_SEND,
+                                               IORING_OP_SEND);
+        sqe->addr      = (uintptr_t)UCS_PTR_BYTE_OFFSET(ep->tx.buf,
+                                                        ep->tx.offset);
+        sqe->len       = ep->tx.length - ep->tx.offset;
+        sqe->msg_flags = MSG_NOSIGNAL;
+    } else {
+        /* The IOVs are kept in the zcopy context in the TX buffer */
+        ctx                    = (uct_tcp_ep_zcopy_tx_t*)ep->tx.buf;
+        uep->tx.msg.msg_iov    = &ctx->iov[ctx->iov_index];
+        uep->tx.msg.msg_iovlen = ctx->iov_cnt - ctx->iov_index;
+        sqe                    = uct_tcp_uring_ep_post(uring, uep,
+                                                       UCT_TCP_URING_OP_SEND,
+                                                       IORING_OP_SENDMSG);
+        sqe->addr              = (uintptr_t)&uep->tx.msg;
+        sqe->len               = 1;
+        sqe->msg_flags         = MSG_NOSIGNAL;
+    }
+}
+
+static void uct_tcp_uring_ep_cancel(uct_tcp_uring_t *uring,
+                                    uct_tcp_uring_ep_t *uep, int op)
+{
+    struct io_uring_sqe *sqe = uct_tcp_uring_get_sqe(uring);
+
+    /* Completion of the cancellation itself is ignored */
+    sqe->opcode          = IORING_OP_ASYNC_CANCEL;
+    sqe->fd              = -1;
+    sqe->addr            = (uintptr_t)uep | op;
+    sqe->user_data       = 0;
+    uep->op_flags[op]   |= UCT_TCP_URING_FLAG_CANCELED;
+}
+
+static int uct_tcp_uring_ep_is_armed(uct_tcp_uring_ep_t *uep, int op)
+{
+    return uep->op_flags[op] & UCT_TCP_URING_FLAG_ARMED;
+}
+
+static void uct_tcp_uring_ep_tx_dequeue(uct_tcp_uring_ep_t *uep)
+{
+    if (uep->flags & UCT_TCP_URING_EP_FLAG_TX_QUEUED) {
+        ucs_list_del(&uep->tx_list);
+        uep->flags &= ~UCT_TCP_URING_EP_FLAG_TX_QUEUED;
+    }
+}
+
+static void uct_tcp_uring_ep_release(uct_tcp_uring_t *uring,
+                                     uct_tcp_uring_ep_t *uep)
+{
+    if (uep->tx.buf != NULL) {
+        ucs_mpool_put_inline(uep->tx.buf);
+    }
+
+    uct_tcp_uring_ep_tx_dequeue(uep);
+    uct_tcp_uring_ep_rx_backlog_free(uring, uep);
+    ucs_list_del(&uep->list);
+    ucs_free(uep);
+}
+
+/* Release the context if it is not referenced by the endpoint, the ring or
+ * the running callback. Must be called with the lock held. */
+static void uct_tcp_uring_ep_check_release(uct_tcp_uring_t *uring,
+                                           uct_tcp_uring_ep_t *uep)
+{
+    int op;
+
+    if ((uep->ep != NULL) || uep->in_progress) {
+        return;
+    }
+
+    for (op = 0; op < UCT_TCP_URING_OP_LAST; ++op) {
+        if (uct_tcp_uring_ep_is_armed(uep, op)) {
+            return;
+        }
+    }
+
+    uct_tcp_uring_ep_release(uring, uep);
+}
+
+static void uct_tcp_uring_ep_sync_cancel(uct_tcp_uring_t *uring,
+                                         uct_tcp_uring_ep_t *uep, int op,
+                                         int *canceled_p)
+{
+    if ((uep->op_flags[op] & (UCT_TCP_URING_FLAG_ARMED |
+                              UCT_TCP_URING_FLAG_CANCELED)) ==
+        UCT_TCP_URING_FLAG_ARMED) {
+        uct_tcp_uring_ep_cancel(uring, uep, op);
+        *canceled_p = 1;
+    }
+}
+
+/* Bring posted requests in line with the endpoint's events. The receive is
+ * posted at once, while the TX requests are posted when the TX queue is
+ * flushed, so the data prepared by the endpoint after the event was set is
+ * sent by the same request. Must be called with the lock held. Returns
+ * nonzero if a cancellation was posted. */
+static int uct_tcp_uring_ep_sync(uct_tcp_uring_t *uring,
+                                 uct_tcp_uring_ep_t *uep)
+{
+    int canceled = 0;
+
+    /* If the request is being canceled, it is posted again when the
+     * cancellation completes */
+    if (uep->ep->events & UCS_EVENT_SET_EVREAD) {
+        if (!uct_tcp_uring_ep_is_armed(uep, UCT_TCP_URING_OP_RECV)) {
+            uct_tcp_uring_ep_post_recv(uring, uep);
+        }
+    } else {
+        uct_tcp_uring_ep_sync_cancel(uring, uep, UCT_TCP_URING_OP_RECV,
+                                     &canceled);
+    }
+
+    if (uep->ep->events & UCS_EVENT_SET_EVWRITE) {
+        if (!uct_tcp_uring_ep_is_armed(uep, UCT_TCP_URING_OP_POLL) &&
+            !uct_tcp_uring_ep_is_armed(uep, UCT_TCP_URING_OP_SEND) &&
+            !(uep->flags & UCT_TCP_URING_EP_FLAG_TX_QUEUED)) {
+            ucs_list_add_tail(&uring->tx_queue, &uep->tx_list);
+            uep->flags |= UCT_TCP_URING_EP_FLAG_TX_QUEUED;
+        }
+    } else {
+        uct_tcp_uring_ep_tx_dequeue(uep);
+        uct_tcp_uring_ep_sync_cancel(uring, uep, UCT_TCP_URING_OP_POLL,
+                                     &canceled);
+        uct_tcp_uring_ep_sync_cancel(uring, uep, UCT_TCP_URING_OP_SEND,
+                                     &canceled);
+    }
+
+    return canceled;
+}
+
+/* Post TX requests of all queued endpoints and submit everything at once.
+ * Must be called with the lock held. */
+static void uct_tcp_uring_flush(uct_tcp_uring_t *uring)
+{
+    uct_tcp_uring_ep_t *uep, *tmp;
+
+    ucs_list_for_each_safe(uep, tmp, &uring->tx_queue, tx_list) {
+        uct_tcp_uring_ep_tx_dequeue(uep);
+        uct_tcp_uring_ep_post_tx(uring, uep);
+    }
+
+    uct_tcp_uring_submit(uring);
+}
+
+static void uct_tcp_uring_rx_buf_recycle(uct_tcp_uring_t *uring, uint16_t bid)
+{
+    struct io_uring_buf *buf;
+
+    buf       = &uring->rx.ring->bufs[uring->rx.tail &
+                                      (UCT_TCP_URING_RX_BUFS - 1)];
+    buf->addr = (uintptr_t)UCS_PTR_BYTE_OFFSET(uring->rx.bufs,
+                                               bid * uring->rx.buf_size);
+    buf->len  = uring->rx.buf_size;
+    buf->bid  = bid;
+    ++uring->rx.tail;
+}
+
+static void uct_tcp_uring_rx_bufs_publish(uct_tcp_uring_t *uring)
+{
+    /* Make the buffers visible before the tail */
+    ucs_memory_cpu_store_fence();
+    *(volatile uint16_t*)&uring->rx.ring->tail = uring->rx.tail;
+}
+
+static ucs_status_t uct_tcp_uring_rx_init(uct_tcp_uring_t *uring,
+                                          size_t buf_size)
+{
+    struct io_uring_buf_reg reg;
+    ucs_status_t status;
+    uint16_t bid;
+    int ret;
+
+    uring->rx.buf_size  = buf_size;
+    uring->rx.ring_size = ucs_align_up_pow2(UCT_TCP_URING_RX_BUFS *
+                                            sizeof(struct io_uring_buf),
+                                            ucs_get_page_size());
+    ret = ucs_posix_memalign((void**)&uring->rx.ring, ucs_get_page_size(),
+                             uring->rx.ring_size, "tcp_uring_buf_ring");
+    if (ret != 0) {
+        ucs_error("failed to allocate io_uring buffer ring");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    uring->rx.bufs = ucs_malloc(UCT_TCP_URING_RX_BUFS * buf_size,
+                                "tcp_uring_rx_bufs");
+    if (uring->rx.bufs == NULL) {
+        ucs_error("failed to allocate io_uring receive buffers");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free_ring;
+    }
+
+    memset(uring->rx.ring, 0, uring->rx.ring_size);
+    uring->rx.tail = 0;
+    for (bid = 0; bid < UCT_TCP_URING_RX_BUFS; ++bid) {
+        uct_tcp_uring_rx_buf_recycle(uring, bid);
+    }
+    uct_tcp_uring_rx_bufs_publish(uring);
+
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr    = (uintptr_t)uring->rx.ring;
+    reg.ring_entries = UCT_TCP_URING_RX_BUFS;
+    reg.bgid         = UCT_TCP_URING_RX_BGID;
+
+    ret = syscall(__NR_io_uring_register, uring->fd,
+                  IORING_REGISTER_PBUF_RING, &reg, 1);
+    if (ret < 0) {
+        ucs_debug("io_uring_register(fd=%d, PBUF_RING) failed: %m",
+                  uring->fd);
+        status = UCS_ERR_UNSUPPORTED;
+        goto err_free_bufs;
+    }
+
+    return UCS_OK;
+
+err_free_bufs:
+    ucs_free(uring->rx.bufs);
+err_free_ring:
+    ucs_free(uring->rx.ring);
+    return status;
+}
+
+ucs_status_t uct_tcp_uring_create(uct_tcp_iface_t *iface, unsigned entries,
+                                  int sqpoll, uct_tcp_uring_t **uring_p)
+{
+    struct io_uring_params params;
+    uct_tcp_uring_t *uring;
+    ucs_status_t status;
+    void *cq_base;
+
+    uring = ucs_calloc(1, sizeof(*uring), "tcp_uring");
+    if (uring == NULL) {
+        ucs_error("failed to allocate tcp io_uring");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    memset(&params, 0, sizeof(params));
+    if (sqpoll) {
+        params.flags          = IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = UCT_TCP_URING_SQ_THREAD_IDLE;
+    }
+
+    uring->fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (uring->fd < 0) {
+        ucs_debug("io_uring_setup(entries=%u, flags=0x%x) failed: %m",
+                  entries, params.flags);
+        status = UCS_ERR_UNSUPPORTED;
+        goto err_free;
+    }
+
+    /* Without NODROP completions of the requests could be lost, so the
+     * endpoint would never be progressed */
+    if (!(params.features & IORING_FEAT_NODROP) ||
+        !(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        ucs_debug("io_uring features 0x%x are not sufficient",
+                  params.features);
+        status = UCS_ERR_UNSUPPORTED;
+        goto err_close;
+    }
+
+    uring->ring_size = ucs_max(params.sq_off.array +
+                               (params.sq_entries * sizeof(unsigned)),
+                               params.cq_off.cqes +
+                               (params.cq_entries *
+                                sizeof(struct io_uring_cqe)));
+    uring->ring      = mmap(NULL, uring->ring_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, uring->fd,
+                            IORING_OFF_SQ_RING);
+    if (uring->ring == MAP_FAILED) {
+        ucs_error("failed to map io_uring rings: %m");
+        status = UCS_ERR_IO_ERROR;
+        goto err_close;
+    }
+
+    uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring->sqes      = mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, uring->fd,
+                            IORING_OFF_SQES);
+    if (uring->sqes == MAP_FAILED) {
+        ucs_error("failed to map io_uring submission entries: %m");
+        status = UCS_ERR_IO_ERROR;
+        goto err_unmap_ring;
+    }
+
+    /* Multishot receive with the provided buffers is supported since the
+     * kernel 6.0, older kernels fail the registration */
+    status = uct_tcp_uring_rx_init(uring, iface->config.rx_seg_size);
+    if (status != UCS_OK) {
+        goto err_unmap_sqes;
+    }
+
+    uring->sq.khead   = UCS_PTR_BYTE_OFFSET(uring->ring, params.sq_off.head);
+    uring->sq.ktail   = UCS_PTR_BYTE_OFFSET(uring->ring, params.sq_off.tail);
+    uring->sq.kflags  = UCS_PTR_BYTE_OFFSET(uring->ring, params.sq_off.flags);
+    uring->sq.array   = UCS_PTR_BYTE_OFFSET(uring->ring, params.sq_off.array);
+    uring->sq.mask    = *(unsigned*)UCS_PTR_BYTE_OFFSET(uring->ring,
+                                                       params.sq_off.ring_mask);
+    uring->sq.entries = params.sq_entries;
+    uring->sq.tail    = *uring->sq.ktail;
+    uring->sq.pending = 0;
+
+    cq_base           = uring->ring;
+    uring->cq.khead   = UCS_PTR_BYTE_OFFSET(cq_base, params.cq_off.head);
+    uring->cq.ktail   = UCS_PTR_BYTE_OFFSET(cq_base, params.cq_off.tail);
+    uring->cq.mask    = *(unsigned*)UCS_PTR_BYTE_OFFSET(cq_base,
+                                                       params.cq_off.ring_mask);
+    uring->cq.cqes    = UCS_PTR_BYTE_OFFSET(cq_base, params.cq_off.cqes);
+
+    uring->sqpoll     = sqpoll;
+    ucs_list_head_init(&uring->eps);
+    ucs_list_head_init(&uring->tx_queue);
+    ucs_list_head_init(&uring->rx_backlog);
+    ucs_spinlock_init(&uring->lock, 0);
+
+    ucs_debug("tcp_iface %p: created io_uring fd=%d sq_entries=%u "
+              "cq_entries=%u rx_bufs=%u%s", iface, uring->fd,
+              params.sq_entries, params.cq_entries, UCT_TCP_URING_RX_BUFS,
+              sqpoll ? " sqpoll" : "");
+
+    *uring_p = uring;
+    return UCS_OK;
+
+err_unmap_sqes:
+    munmap(uring->sqes, uring->sqes_size);
+err_unmap_ring:
+    munmap(uring->ring, uring->ring_size);
+err_close:
+    close(uring->fd);
+err_free:
+    ucs_free(uring);
+    return status;
+}
+
+int uct_tcp_uring_fd(uct_tcp_uring_t *uring)
+{
+    return uring->fd;
+}
+
+static int uct_tcp_uring_cq_is_empty(uct_tcp_uring_t *uring)
+{
+    return *(volatile unsigned*)uring->cq.ktail == *uring->cq.khead;
+}
+
+ucs_status_t uct_tcp_uring_arm(uct_tcp_uring_t *uring)
+{
+    ucs_spin_lock(&uring->lock);
+    uct_tcp_uring_flush(uring);
+    ucs_spin_unlock(&uring->lock);
+
+    return uct_tcp_uring_cq_is_empty(uring) ? UCS_OK : UCS_ERR_BUSY;
+}
+
+static void uct_tcp_uring_ep_rx_backlog_add(uct_tcp_uring_t *uring,
+                                            uct_tcp_uring_ep_t *uep)
+{
+    size_t length = uep->rx.backlog_length - uep->rx.backlog_offset;
+    void *backlog;
+
+    backlog = ucs_malloc(length + uep->rx.length, "tcp_uring_rx_backlog");
+    if (backlog == NULL) {
+        ucs_fatal("tcp_ep %p: failed to allocate %zu bytes of io_uring "
+                  "receive backlog", uep->ep, length + uep->rx.length);
+    }
+
+    if (uep->rx.backlog != NULL) {
+        memcpy(backlog, UCS_PTR_BYTE_OFFSET(uep->rx.backlog,
+                                            uep->rx.backlog_offset), length);
+        ucs_free(uep->rx.backlog);
+    }
+
+    memcpy(UCS_PTR_BYTE_OFFSET(backlog, length), uep->rx.data,
+           uep->rx.length);
+    uep->rx.backlog        = backlog;
+    uep->rx.backlog_offset = 0;
+    uep->rx.backlog_length = length + uep->rx.length;
+    uep->rx.data           = NULL;
+    uep->rx.length         = 0;
+
+    if (!(uep->flags & UCT_TCP_URING_EP_FLAG_RX_QUEUED)) {
+        ucs_list_add_tail(&uring->rx_backlog, &uep->rx_list);
+        uep->flags |= UCT_TCP_URING_EP_FLAG_RX_QUEUED;
+    }
+}
+
+static size_t uct_tcp_uring_ep_rx_remaining(uct_tcp_uring_ep_t *uep)
+{
+    return uep->rx.length + uep->rx.backlog_length - uep->rx.backlog_offset;
+}
+
+/* Pass the received data or error to the endpoint, which consumes it by
+ * uct_tcp_uring_ep_recv() from its RX callback */
+static unsigned uct_tcp_uring_ep_rx_deliver(uct_tcp_uring_t *uring,
+                                            uct_tcp_uring_ep_t *uep)
+{
+    unsigned count = 0;
+    size_t remaining;
+    uct_tcp_ep_t *ep;
+
+    for (;;) {
+        ep        = uep->ep;
+        remaining = uct_tcp_uring_ep_rx_remaining(uep);
+        if ((ep == NULL) || (ep->fd != uep->rx.fd) ||
+            !(ep->events & UCS_EVENT_SET_EVREAD) ||
+            ((remaining == 0) && (uep->rx.status == UCS_OK))) {
+            break;
+        }
+
+        ucs_assertv(ep->conn_state != UCT_TCP_EP_CONN_STATE_CLOSED,
+                    "ep=%p", ep);
+        count += uct_tcp_ep_cm_state[ep->conn_state].rx_progress(ep);
+
+        if ((remaining == 0) ||
+            (uct_tcp_uring_ep_rx_remaining(uep) == remaining)) {
+            /* The error was reported, or the endpoint does not need more
+             * data in its current state */
+            break;
+        }
+    }
+
+    /* The endpoint may have been destroyed by the callback */
+    ep = uep->ep;
+    if (uep->rx.length != 0) {
+        if ((ep == NULL) || (ep->fd != uep->rx.fd)) {
+            ucs_trace_data("tcp_ep %p: io_uring dropped %zu bytes received "
+                           "on closed socket", ep, uep->rx.length);
+            uep->rx.length = 0;
+        } else {
+            /* The buffer goes back to the ring, keep the rest of the data
+             * until the endpoint needs it */
+            uct_tcp_uring_ep_rx_backlog_add(uring, uep);
+        }
+    }
+
+    return count;
+}
+
+static unsigned uct_tcp_uring_ep_rx_completed(uct_tcp_uring_t *uring,
+                                              uct_tcp_uring_ep_t *uep,
+                                              int res, unsigned cqe_flags,
+                                              int canceled)
+{
+    unsigned count = 0;
+    uint16_t bid   = cqe_flags >> IORING_CQE_BUFFER_SHIFT;
+
+    if (!canceled && (uep->ep != NULL) && (uep->ep->fd == uep->rx.fd)) {
+        if (res > 0) {
+            ucs_assert(cqe_flags & IORING_CQE_F_BUFFER);
+            uep->rx.data   = UCS_PTR_BYTE_OFFSET(uring->rx.bufs,
+                                                 bid * uring->rx.buf_size);
+            uep->rx.length = res;
+            if (uep->rx.backlog != NULL) {
+                /* Keep the order of the data */
+                uct_tcp_uring_ep_rx_backlog_add(uring, uep);
+            }
+        } else if (res == 0) {
+            /* Connection closed by peer */
+            uep->rx.status = UCS_ERR_NOT_CONNECTED;
+        } else if ((res != -ENOBUFS) && (res != -ECANCELED)) {
+            /* Out of buffers is not an error, the receive is posted again
+             * when the buffers are returned to the ring */
+            uep->rx.status = ucs_socket_check_errno(-res);
+            if (uep->rx.status != UCS_ERR_NO_PROGRESS) {
+                ucs_debug("tcp_ep %p: io_uring recv(%d) failed: %s", uep->ep,
+                          uep->rx.fd, strerror(-res));
+            } else {
+                uep->rx.status = UCS_OK;
+            }
+        }
+
+        count = uct_tcp_uring_ep_rx_deliver(uring, uep);
+    }
+
+    if (cqe_flags & IORING_CQE_F_BUFFER) {
+        /* The data was either consumed or copied to the backlog */
+        uep->rx.length = 0;
+        uct_tcp_uring_rx_buf_recycle(uring, bid);
+        uct_tcp_uring_rx_bufs_publish(uring);
+    }
+
+    return count;
+}
+
+static unsigned uct_tcp_uring_ep_tx_completed(uct_tcp_uring_ep_t *uep,
+                                              int op, int res, int canceled)
+{
+    uct_tcp_ep_t *ep = uep->ep;
+
+    if (canceled || (ep == NULL)) {
+        return 0;
+    }
+
+    if (op == UCT_TCP_URING_OP_SEND) {
+        /* The endpoint takes the result from its TX callback */
+        uep->tx.result = res;
+        uep->flags    |= UCT_TCP_URING_EP_FLAG_TX_DONE;
+    } else if (res <= 0) {
+        return 0;
+    }
+
+    if (!(ep->events & UCS_EVENT_SET_EVWRITE)) {
+        return 0;
+    }
+
+    ucs_assertv(ep->conn_state != UCT_TCP_EP_CONN_STATE_CLOSED, "ep=%p", ep);
+    return uct_tcp_ep_cm_state[ep->conn_state].tx_progress(ep);
+}
+
+/* Returns the number of progressed operations */
+static unsigned uct_tcp_uring_process_cqe(uct_tcp_uring_t *uring,
+                                          const struct io_uring_cqe *cqe)
+{
+    unsigned count = 0;
+    uct_tcp_uring_ep_t *uep;
+    int res, op, canceled;
+    unsigned cqe_flags;
+
+    uep       = (uct_tcp_uring_ep_t*)(uintptr_t)(cqe->user_data &
+                                                 ~(uint64_t)UCT_TCP_URING_OP_MASK);
+    op        = cqe->user_data & UCT_TCP_URING_OP_MASK;
+    res       = cqe->res;
+    cqe_flags = cqe->flags;
+
+    ucs_spin_lock(&uring->lock);
+    canceled = uep->op_flags[op] & UCT_TCP_URING_FLAG_CANCELED;
+    if (!(cqe_flags & IORING_CQE_F_MORE)) {
+        /* The request is done, multishot receive may still be posted */
+        uep->op_flags[op] &= ~(UCT_TCP_URING_FLAG_ARMED |
+                               UCT_TCP_URING_FLAG_CANCELED);
+    }
+    uep->in_progress = 1;
+    ucs_spin_unlock(&uring->lock);
+
+    ucs_trace_poll("tcp_ep %p: io_uring op %d returned %d flags 0x%x",
+                   uep->ep, op, res, cqe_flags);
+
+    if (op == UCT_TCP_URING_OP_RECV) {
+        count = uct_tcp_uring_ep_rx_completed(uring, uep, res, cqe_flags,
+                                              canceled);
+    } else {
+        count = uct_tcp_uring_ep_tx_completed(uep, op, res, canceled);
+    }
+
+    /* The endpoint may have been destroyed by the callback; otherwise
+     * post the requests again to keep level-triggered semantics */
+    ucs_spin_lock(&uring->lock);
+    uep->in_progress = 0;
+    if (uep->ep == NULL) {
+        uct_tcp_uring_ep_check_release(uring, uep);
+    } else {
+        uct_tcp_uring_ep_sync(uring, uep);
+    }
+    ucs_spin_unlock(&uring->lock);
+
+    return count;
+}
+
+/* The endpoint which did not consume all received data is progressed on
+ * every call, as epoll reports a socket with data on every wait */
+static unsigned uct_tcp_uring_rx_backlog_progress(uct_tcp_uring_t *uring)
+{
+    unsigned count = 0;
+    uct_tcp_uring_ep_t *uep;
+    unsigned num_eps;
+
+    num_eps = ucs_list_length(&uring->rx_backlog);
+    while (num_eps-- > 0) {
+        ucs_spin_lock(&uring->lock);
+        if (ucs_list_is_empty(&uring->rx_backlog)) {
+            ucs_spin_unlock(&uring->lock);
+            break;
+        }
+
+        /* Rotate the list, so every context is progressed once */
+        uep = ucs_list_head(&uring->rx_backlog, uct_tcp_uring_ep_t, rx_list);
+        ucs_list_del(&uep->rx_list);
+        ucs_list_add_tail(&uring->rx_backlog, &uep->rx_list);
+        uep->in_progress = 1;
+        ucs_spin_unlock(&uring->lock);
+
+        count += uct_tcp_uring_ep_rx_deliver(uring, uep);
+
+        ucs_spin_lock(&uring->lock);
+        uep->in_progress = 0;
+        if (uep->ep == NULL) {
+            uct_tcp_uring_ep_check_release(uring, uep);
+        } else {
+            uct_tcp_uring_ep_sync(uring, uep);
+        }
+        ucs_spin_unlock(&uring->lock);
+    }
+
+    return count;
+}
+
+unsigned uct_tcp_uring_progress(uct_tcp_uring_t *uring, unsigned max_events)
+{
+    unsigned count  = 0;
+    unsigned events = 0;
+    const struct io_uring_cqe *cqe;
+    struct io_uring_cqe cqe_copy;
+    unsigned head, tail;
+
+    /* Submit the sends posted since the last call together with the
+     * requests posted during it */
+    ucs_spin_lock(&uring->lock);
+    uct_tcp_uring_flush(uring);
+    uring->in_progress = 1;
+    ucs_spin_unlock(&uring->lock);
+
+    if (ucs_unlikely(*(volatile unsigned*)uring->sq.kflags &
+                     IORING_SQ_CQ_OVERFLOW)) {
+        /* Move the completions which did not fit the CQ back to it */
+        uct_tcp_uring_enter(uring, 0, 0, IORING_ENTER_GETEVENTS);
+    }
+
+    head = *uring->cq.khead;
+    tail = *(volatile unsigned*)uring->cq.ktail;
+    ucs_memory_cpu_load_fence();
+
+    while ((head != tail) && (events < max_events)) {
+        cqe      = &uring->cq.cqes[head & uring->cq.mask];
+        cqe_copy = *cqe;
+
+        /* Release the entry before invoking the callback, since it could
+         * post new requests */
+        ucs_memory_cpu_store_fence();
+        *uring->cq.khead = ++head;
+
+        if (cqe_copy.user_data == 0) {
+            continue;
+        }
+
+        count += uct_tcp_uring_process_cqe(uring, &cqe_copy);
+        ++events;
+    }
+
+    count += uct_tcp_uring_rx_backlog_progress(uring);
+
+    /* Post all requests accumulated during the processing at once */
+    ucs_spin_lock(&uring->lock);
+    uct_tcp_uring_flush(uring);
+    uring->in_progress = 0;
+    ucs_spin_unlock(&uring->lock);
+
+    return count;
+}
+
+void uct_tcp_uring_destroy(uct_tcp_uring_t *uring)
+{
+    ucs_time_t deadline = ucs_get_time() +
+                          ucs_time_from_sec(UCT_TCP_URING_DRAIN_TIMEOUT);
+    uct_tcp_uring_ep_t *uep, *tmp;
+
+    /* The requests of the destroyed endpoints are canceled, wait for them
+     * to complete, since they may still use the TX and RX buffers */
+    while (!ucs_list_is_empty(&uring->eps) && (ucs_get_time() < deadline)) {
+        uct_tcp_uring_progress(uring, UINT_MAX);
+        uct_tcp_uring_enter(uring, 0, 0, IORING_ENTER_GETEVENTS);
+        sched_yield();
+    }
+
+    ucs_list_for_each_safe(uep, tmp, &uring->eps, list) {
+        ucs_assert(uep->ep == NULL);
+        ucs_debug("tcp_uring %p: releasing context %p with posted requests",
+                  uring, uep);
+        uct_tcp_uring_ep_release(uring, uep);
+    }
+
+    ucs_spinlock_destroy(&uring->lock);
+    munmap(uring->sqes, uring->sqes_size);
+    munmap(uring->ring, uring->ring_size);
+    close(uring->fd);
+    ucs_free(uring->rx.bufs);
+    ucs_free(uring->rx.ring);
+    ucs_free(uring);
+}
+
+void uct_tcp_uring_ep_update(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+    uct_tcp_uring_ep_t *uep;
+
+    ucs_spin_lock(&uring->lock);
+
+    uep = ep->uring_ep;
+    if (uep == NULL) {
+        if (ep->events == 0) {
+            goto out;
+        }
+
+        uep = ucs_calloc(1, sizeof(*uep), "tcp_uring_ep");
+        if (uep == NULL) {
+            ucs_fatal("tcp_ep %p: failed to allocate io_uring context", ep);
+        }
+
+        uep->ep        = ep;
+        uep->rx.fd     = -1;
+        uep->rx.status = UCS_OK;
+        ep->uring_ep   = uep;
+        ucs_list_add_tail(&uring->eps, &uep->list);
+    }
+
+    /* Outside of progress the receive and the cancellations are posted
+     * immediately: the iface may be waiting for an event on the ring, and
+     * the socket may be closed or replaced right after its events were
+     * cleared. The sends are posted by the next progress call. */
+    if (uct_tcp_uring_ep_sync(uring, uep) || !uring->in_progress) {
+        uct_tcp_uring_submit(uring);
+    }
+
+out:
+    ucs_spin_unlock(&uring->lock);
+}
+
+void uct_tcp_uring_ep_cleanup(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+    uct_tcp_uring_ep_t *uep = ep->uring_ep;
+
+    if (uep == NULL) {
+        return;
+    }
+
+    ucs_spin_lock(&uring->lock);
+    ucs_assert(ep->events == 0);
+    if (uct_tcp_uring_ep_is_armed(uep, UCT_TCP_URING_OP_SEND)) {
+        /* The canceled send may still read the buffer */
+        uep->tx.buf = ep->tx.buf;
+        ep->tx.buf  = NULL;
+    }
+    uep->ep      = NULL;
+    ep->uring_ep = NULL;
+    uct_tcp_uring_ep_check_release(uring, uep);
+    ucs_spin_unlock(&uring->lock);
+}
+
+ucs_status_t uct_tcp_uring_ep_send_result(uct_tcp_uring_t *uring,
+                                          uct_tcp_ep_t *ep, size_t *length_p)
+{
+    uct_tcp_uring_ep_t *uep = ep->uring_ep;
+
+    if ((uep == NULL) || !(uep->flags & UCT_TCP_URING_EP_FLAG_TX_DONE)) {
+        /* The data is sent by the request posted on the next flush */
+        *length_p = 0;
+        return UCS_ERR_NO_PROGRESS;
+    }
+
+    uep->flags &= ~UCT_TCP_URING_EP_FLAG_TX_DONE;
+    if (uep->tx.result >= 0) {
+        *length_p = uep->tx.result;
+        return UCS_OK;
+    }
+
+    *length_p = 0;
+    ucs_debug("tcp_ep %p: io_uring send(%d) failed: %s", ep, ep->fd,
+              strerror(-uep->tx.result));
+    return ucs_socket_check_errno(-uep->tx.result);
+}
+
+ucs_status_t uct_tcp_uring_ep_recv(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep,
+                                   void *data, size_t *length_p)
+{
+    uct_tcp_uring_ep_t *uep = ep->uring_ep;
+    size_t length           = 0;
+    ucs_status_t status;
+    size_t chunk;
+
+    if (uep == NULL) {
+        *length_p = 0;
+        return UCS_ERR_NO_PROGRESS;
+    }
+
+    if (uep->rx.backlog != NULL) {
+        length                  = ucs_min(*length_p, uep->rx.backlog_length -
+                                                     uep->rx.backlog_offset);
+        memcpy(data, UCS_PTR_BYTE_OFFSET(uep->rx.backlog,
+                                         uep->rx.backlog_offset), length);
+        uep->rx.backlog_offset += length;
+        if (uep->rx.backlog_offset == uep->rx.backlog_length) {
+            uct_tcp_uring_ep_rx_backlog_free(uring, uep);
+        }
+    }
+
+    chunk = ucs_min(*length_p - length, uep->rx.length);
+    if (chunk != 0) {
+        memcpy(UCS_PTR_BYTE_OFFSET(data, length), uep->rx.data, chunk);
+        uep->rx.data    = UCS_PTR_BYTE_OFFSET(uep->rx.data, chunk);
+        uep->rx.length -= chunk;
+        length         += chunk;
+    }
+
+    *length_p = length;
+    if (length != 0) {
+        return UCS_OK;
+    }
+
+    /* All data received before the error was consumed */
+    status         = (uep->rx.status != UCS_OK) ? uep->rx.status :
+                     UCS_ERR_NO_PROGRESS;
+    uep->rx.status = UCS_OK;
+    return status;
+}
+
+#else
+
+ucs_status_t uct_tcp_uring_create(uct_tcp_iface_t *iface, unsigned entries,
+                                  int sqpoll, uct_tcp_uring_t **uring_p)
+{
+    ucs_debug("io_uring is not supported");
+    return UCS_ERR_UNSUPPORTED;
+}
+
+void uct_tcp_uring_destroy(uct_tcp_uring_t *uring)
+{
+}
+
+int uct_tcp_uring_fd(uct_tcp_uring_t *uring)
+{
+    return -1;
+}
+
+ucs_status_t uct_tcp_uring_arm(uct_tcp_uring_t *uring)
+{
+    return UCS_ERR_UNSUPPORTED;
+}
+
+unsigned uct_tcp_uring_progress(uct_tcp_uring_t *uring, unsigned max_events)
+{
+    return 0;
+}
+
+void uct_tcp_uring_ep_update(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+}
+
+void uct_tcp_uring_ep_cleanup(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+}
+
+ucs_status_t uct_tcp_uring_ep_send_result(uct_tcp_uring_t *uring,
+                                          uct_tcp_ep_t *ep, size_t *length_p)
+{
+    return UCS_ERR_UNSUPPORTED;
+}
+
+ucs_status_t uct_tcp_uring_ep_recv(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep,
+                                   void *data, size_t *length_p)
+{
+    return UCS_ERR_UNSUPPORTED;
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include <arpa/inet.h>
 #include <sys/time.h>
 #include <iostream>
+#include <iomanip>
 #include <string.h>
 #include <getopt.h>
 #include <assert.h>
@@ -20,6 +21,7 @@
 #include <map>
 #include <algorithm>
 #include <limits>
+#include <cmath>
 
 #define ALIGNMENT       4096
 
@@ -36,6 +38,17 @@ static const char *io_op_names[] = {
     "completion"
 };
 
+/* IO requests arrival distribution, in open-loop mode */
+typedef enum {
+    ARRIVAL_CONST,
+    ARRIVAL_POISSON
+} arrival_t;
+
+static const char *arrival_names[] = {
+    "const",
+    "poisson"
+};
+
 /* test options */
 typedef struct {
     std::vector<const char*> servers;
@@ -49,6 +62,8 @@ typedef struct {
     size_t                   chunk_size;
     long                     iter_count;
     long                     window_size;
+    double                   io_rate;
+    arrival_t                arrival;
     std::vector<io_op_t>     operations;
     unsigned                 random_seed;
     size_t                   num_buffers;
@@ -132,6 +147,115 @@ const unsigned IoDemoRandom::_A = 1103515245U;
 const unsigned IoDemoRandom::_C = 12345U;
 const unsigned IoDemoRandom::_M = 0x7fffffffU;
 
+/**
+ * Latency histogram with logarithmic buckets: every power-of-2 range of
+ * nanoseconds is split to SUB_BUCKETS linear buckets, so a percentile is
+ * reported with a relative error of at most 1/SUB_BUCKETS.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram() : _buckets(NUM_BUCKETS) {
+        reset();
+    }
+
+    void reset() {
+        std::fill(_buckets.begin(), _buckets.end(), 0);
+        _count = 0;
+        _total = 0;
+        _min   = std::numeric_limits<double>::max();
+        _max   = 0;
+    }
+
+    void add(double latency) {
+        uint64_t nsec = (latency > 0) ? (uint64_t)(latency * 1e9) : 0;
+
+        ++_buckets[bucket_index(nsec)];
+        ++_count;
+        _total += latency;
+        _min    = std::min(_min, latency);
+        _max    = std::max(_max, latency);
+    }
+
+    void add(const LatencyHistogram &other) {
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            _buckets[i] += other._buckets[i];
+        }
+        _count += other._count;
+        _total += other._total;
+        _min    = std::min(_min, other._min);
+        _max    = std::max(_max, other._max);
+    }
+
+    size_t count() const {
+        return _count;
+    }
+
+    /* returns the latency in seconds below which the given fraction of
+     * samples fall */
+    double percentile(double fraction) const {
+        size_t threshold = (size_t)std::ceil(fraction * _count);
+        size_t sum       = 0;
+
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            sum += _buckets[i];
+            if ((sum > 0) && (sum >= threshold)) {
+                /* don't exceed the actual maximum because of bucket width */
+                return std::min(bucket_upper_bound(i) * 1e-9, _max);
+            }
+        }
+
+        return _max;
+    }
+
+    void print(std::ostream &os) const {
+        if (_count == 0) {
+            return;
+        }
+
+        os << "latency usec: min " << (_min * 1e6)
+           << " avg " << (_total / _count * 1e6)
+           << " p50 " << (percentile(0.5) * 1e6)
+           << " p90 " << (percentile(0.9) * 1e6)
+           << " p99 " << (percentile(0.99) * 1e6)
+           << " p99.9 " << (percentile(0.999) * 1e6)
+           << " max " << (_max * 1e6)
+           << " (" << _count << " samples)";
+    }
+
+private:
+    static const unsigned SUB_BUCKETS_LOG = 4;
+    static const unsigned SUB_BUCKETS     = 1u << SUB_BUCKETS_LOG;
+    static const unsigned NUM_BUCKETS     = (64 - SUB_BUCKETS_LOG + 1) *
+                                            SUB_BUCKETS;
+
+    static size_t bucket_index(uint64_t nsec) {
+        if (nsec < SUB_BUCKETS) {
+            return nsec;
+        }
+
+        unsigned msb   = 63 - __builtin_clzll(nsec);
+        unsigned shift = msb - SUB_BUCKETS_LOG;
+        return ((shift + 1) * SUB_BUCKETS) +
+               ((nsec >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    static double bucket_upper_bound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+
+        unsigned shift = (index / SUB_BUCKETS) - 1;
+        uint64_t mant  = SUB_BUCKETS + (index % SUB_BUCKETS) + 1;
+        return (double)((mant << shift) - 1);
+    }
+
+    std::vector<size_t> _buckets;
+    size_t              _count;
+    double              _total;
+    double              _min;
+    double              _max;
+};
+
 class P2pDemoCommon : public UcxContext {
 protected:
 
@@ -397,14 +521,15 @@ public:
     public:
         IoReadResponseCallback(size_t buffer_size,
             MemoryPool<IoReadResponseCallback>* pool) :
-            _counter(0), _io_counter(0), _chunk_cnt(0) {
+            _counter(0), _client(NULL), _sn(0), _chunk_cnt(0) {
             _buffer = malloc(buffer_size);
             _pool   = pool;
         }
         
-        void init(long *counter, uint32_t chunk_cnt = 1) {
+        void init(DemoClient *client, uint32_t sn, uint32_t chunk_cnt = 1) {
             _counter    = 0;
-            _io_counter = counter;
+            _client     = client;
+            _sn         = sn;
             _chunk_cnt  = chunk_cnt;
         }
 
@@ -418,7 +543,7 @@ public:
                 return;
             }
 
-            ++(*_io_counter);
+            _client->io_completed(_sn);
             _pool->put(this);
         }
 
@@ -428,7 +553,8 @@ public:
 
     private:
         long                                _counter;
-        long*                               _io_counter;
+        DemoClient*                         _client;
+        uint32_t                            _sn;
         uint32_t                            _chunk_cnt;
         void*                               _buffer;
         MemoryPool<IoReadResponseCallback>* _pool;
@@ -442,6 +568,7 @@ public:
         _status_str[ERROR]                 = "error";
         _status_str[RUNTIME_EXCEEDED]      = "run-time exceeded";
         _status_str[CONN_RETRIES_EXCEEDED] = "connection retries exceeded";
+        _server_latency.resize(opts().servers.size());
     }
 
     typedef enum {
@@ -451,16 +578,17 @@ public:
         CONN_RETRIES_EXCEEDED
     } status_t;
 
-    size_t do_io_read(UcxConnection *conn, uint32_t sn) {
+    size_t do_io_read(UcxConnection *conn, size_t server_index, uint32_t sn,
+                      double start_time) {
         size_t data_size = get_data_size();
 
         if (!send_io_message(conn, IO_READ, sn, data_size)) {
             return data_size;
         }
 
-        ++_num_sent;
+        io_started(server_index, sn, start_time);
         IoReadResponseCallback *r = _callback_pool.get();
-        r->init(&_num_completed, get_chunk_cnt(data_size));
+        r->init(this, sn, get_chunk_cnt(data_size));
         recv_data(conn, data_size, sn, r);
         conn->recv_data(r->buffer(), opts().iomsg_size, sn, r);
         next_buffer();
@@ -468,14 +596,15 @@ public:
         return data_size;
     }
 
-    size_t do_io_write(UcxConnection *conn, uint32_t sn) {
+    size_t do_io_write(UcxConnection *conn, size_t server_index, uint32_t sn,
+                       double start_time) {
         size_t data_size = get_data_size();
 
         if (!send_io_message(conn, IO_WRITE, sn, data_size)) {
             return data_size;
         }
 
-        ++_num_sent;
+        io_started(server_index, sn, start_time);
         VERBOSE_LOG << "sending data " << buffer() << " size "
                     << data_size << " sn " << sn;
         send_data(conn, data_size, sn);
@@ -493,10 +622,27 @@ public:
                     << " conn " << conn;
 
         if (hdr->op == IO_COMP) {
-            ++_num_completed;
+            io_completed(hdr->sn);
         }
     }
 
+    void io_completed(uint32_t sn) {
+        pending_io_map_t::iterator it = _pending_ios.find(sn);
+
+        ++_num_completed;
+        if (it == _pending_ios.end()) {
+            return;
+        }
+
+        /* in open-loop mode, the latency is measured from the time the IO
+         * was scheduled to be issued, so a backlog of delayed requests is
+         * accounted for */
+        double latency = get_time() - it->second.start_time;
+        _latency.add(latency);
+        _server_latency[it->second.server_index].add(latency);
+        _pending_ios.erase(it);
+    }
+
     virtual void dispatch_connection_error(UcxConnection *conn) {
         LOG << "setting error flag on connection " << conn;
         _status = ERROR;
@@ -538,6 +684,15 @@ public:
         return (_status == OK);
     }
 
+    // progress until the given time, returns false on error
+    bool wait_until(double time) {
+        while ((get_time() < time) && (_status == OK)) {
+            progress();
+        }
+
+        return (_status == OK);
+    }
+
     UcxConnection* connect(const char* server) {
         struct sockaddr_in connect_addr;
         std::string server_addr;
@@ -604,8 +759,12 @@ public:
         // TODO reset these values by canceling requests
         _num_sent      = 0;
         _num_completed = 0;
+        _pending_ios.clear();
+        reset_latency();
+        _total_latency.reset();
 
         double prev_time     = get_time();
+        double next_io_time  = prev_time;
         long total_iter      = 0;
         long total_prev_iter = 0;
         std::vector<op_info_t> info;
@@ -618,19 +777,36 @@ public:
         while ((total_iter < opts().iter_count) && (_status == OK)) {
             VERBOSE_LOG << " <<<< iteration " << total_iter << " >>>>";
 
+            /* In open-loop mode, latency is measured from the scheduled
+             * send time, so it includes the time spent waiting for a slot */
+            double start_time = next_io_time;
+            if (is_open_loop()) {
+                if (!wait_until(next_io_time)) {
+                    break;
+                }
+
+                next_io_time += get_interarrival_time();
+            }
+
             if (!wait_for_responses(opts().window_size - 1)) {
                 break;
             }
 
+            if (!is_open_loop()) {
+                start_time = get_time();
+            }
+
             size_t conn_num = IoDemoRandom::rand(0, conn.size() - 1);
             io_op_t op      = get_op();
             size_t size;
             switch (op) {
             case IO_READ:
-                size = do_io_read(conn[conn_num], total_iter);
+                size = do_io_read(conn[conn_num], conn_num, total_iter,
+                                  start_time);
                 break;
             case IO_WRITE:
-                size = do_io_write(conn[conn_num], total_iter);
+                size = do_io_write(conn[conn_num], conn_num, total_iter,
+                                   start_time);
                 break;
             default:
                 abort();
@@ -642,7 +818,9 @@ public:
             if (((total_iter % 10) == 0) && (total_iter > total_prev_iter)) {
                 double curr_time = get_time();
                 if (curr_time >= (prev_time + 1.0)) {
-                    if (!wait_for_responses(0)) {
+                    /* in open-loop mode, don't stop issuing IOs to drain
+                     * the outstanding ones */
+                    if (!is_open_loop() && !wait_for_responses(0)) {
                         break;
                     }
 
@@ -664,6 +842,12 @@ public:
             report_performance(total_iter - total_prev_iter,
                                curr_time - prev_time, info);
             check_time_limit(curr_time);
+
+            if (_total_latency.count() > 0) {
+                std::cout << get_time_str() << " total ";
+                _total_latency.print(std::cout);
+                std::cout << std::endl;
+            }
         }
 
         for (size_t i = 0; i < conn.size(); i++) {
@@ -708,6 +892,43 @@ private:
         size_t    total_bytes;
     } op_info_t;
 
+    typedef struct {
+        size_t    server_index;
+        double    start_time;
+    } pending_io_t;
+
+    typedef std::map<uint32_t, pending_io_t> pending_io_map_t;
+
+    inline bool is_open_loop() const {
+        return opts().io_rate > 0;
+    }
+
+    inline double get_interarrival_time() {
+        if (opts().arrival == ARRIVAL_POISSON) {
+            /* exponentially distributed, with a uniform sample in (0, 1] */
+            int max = std::numeric_limits<int>::max();
+            return -std::log(IoDemoRandom::rand(1, max) / (double)max) /
+                   opts().io_rate;
+        }
+
+        return 1.0 / opts().io_rate;
+    }
+
+    inline void io_started(size_t server_index, uint32_t sn, double start_time) {
+        pending_io_t pending_io = {server_index, start_time};
+
+        ++_num_sent;
+        _pending_ios[sn] = pending_io;
+    }
+
+    void reset_latency() {
+        _total_latency.add(_latency);
+        _latency.reset();
+        for (size_t i = 0; i < _server_latency.size(); ++i) {
+            _server_latency[i].reset();
+        }
+    }
+
     inline io_op_t get_op() {
         if (opts().operations.size() == 1) {
             return opts().operations[0];
@@ -764,8 +985,34 @@ private:
             if (opts().window_size == 1) {
                 std::cout << ", average latency: " << latency_usec << " usec";
             }
+            if (is_open_loop()) {
+                std::cout << ", target rate: " << opts().io_rate
+                          << " IO/s, achieved: " << (num_iters / elapsed)
+                          << " IO/s, outstanding: "
+                          << (_num_sent - _num_completed);
+            }
             std::cout << std::endl;
         }
+
+        if (_latency.count() > 0) {
+            std::cout << get_time_str() << " ";
+            _latency.print(std::cout);
+            std::cout << std::endl;
+
+            for (size_t i = 0; (_server_latency.size() > 1) &&
+                               (i < _server_latency.size()); ++i) {
+                if (_server_latency[i].count() == 0) {
+                    continue;
+                }
+
+                std::cout << get_time_str() << "     server "
+                          << opts().servers[i] << " ";
+                _server_latency[i].print(std::cout);
+                std::cout << std::endl;
+            }
+        }
+
+        reset_latency();
     }
 
 private:
@@ -775,6 +1022,10 @@ private:
     std::map<status_t, std::string>    _status_str;
     double                             _start_time;
     unsigned                           _retry;
+    pending_io_map_t                   _pending_ios;
+    LatencyHistogram                   _latency;
+    LatencyHistogram                   _total_latency;
+    std::vector<LatencyHistogram>      _server_latency;
 protected:    
     MemoryPool<IoReadResponseCallback> _callback_pool;
 };
@@ -866,10 +1117,12 @@ static int parse_args(int argc, char **argv, options_t *test_opts)
     test_opts->iomsg_size           = 256;
     test_opts->iter_count           = 1000;
     test_opts->window_size          = 1;
+    test_opts->io_rate              = 0;
+    test_opts->arrival              = ARRIVAL_CONST;
     test_opts->random_seed          = std::time(NULL);
     test_opts->verbose              = false;
 
-    while ((c = getopt(argc, argv, "p:c:r:d:b:i:w:k:o:t:l:s:v")) != -1) {
+    while ((c = getopt(argc, argv, "p:c:r:d:b:i:w:k:o:t:l:s:R:a:v")) != -1) {
         switch (c) {
         case 'p':
             test_opts->port_num = atoi(optarg);
@@ -953,6 +1206,29 @@ static int parse_args(int argc, char **argv, options_t *test_opts)
         case 's':
             test_opts->random_seed = strtoul(optarg, NULL, 0);
             break;
+        case 'R':
+            test_opts->io_rate = strtod(optarg, NULL);
+            if (test_opts->io_rate < 0) {
+                std::cout << "invalid IO rate '" << optarg << "'" << std::endl;
+                return -1;
+            }
+            break;
+        case 'a':
+            found = false;
+            for (int arrival_it = ARRIVAL_CONST; arrival_it <= ARRIVAL_POISSON;
+                 ++arrival_it) {
+                if (!strcmp(arrival_names[arrival_it], optarg)) {
+                    test_opts->arrival = static_cast<arrival_t>(arrival_it);
+                    found              = true;
+                }
+            }
+
+            if (!found) {
+                std::cout << "invalid arrival distribution '" << optarg << "'"
+                          << std::endl;
+                return -1;
+            }
+            break;
         case 'v':
             test_opts->verbose = true;
             break;
@@ -979,6 +1255,11 @@ static int parse_args(int argc, char **argv, options_t *test_opts)
             std::cout << "  -l <client run-time limit> Time limit to run the IO client (or \"inf\")" << std::endl;
             std::cout << "                             Examples: -l 17.5s; -l 10m; 15.5h" << std::endl;
             std::cout << "  -s <random seed>           Random seed to use for randomizing" << std::endl;
+            std::cout << "  -R <rate>                  Issue IO requests at this rate (per second), regardless" << std::endl;
+            std::cout << "                             of responses (open-loop mode). Latency is measured from" << std::endl;
+            std::cout << "                             the scheduled time of every request, and -w still limits" << std::endl;
+            std::cout << "                             the number of outstanding requests" << std::endl;
+            std::cout << "  -a <const|poisson>         Requests arrival distribution in open-loop mode" << std::endl;
             std::cout << "  -v                         Set verbose mode" << std::endl;
             std::cout << "" << std::endl;
             return -1;
@@ -0,0 +1,196 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <ucp/api/ucp.h>
+#include <sys/time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdio.h>
+
+
+/*
+ * Measure the time until a worker is fully connected to a peer worker over
+ * a given number of endpoints: create the endpoints, one by one or by a single
+ * ucp_ep_create_bulk() call, and flush all of them, which completes only after
+ * the wireup of every endpoint is done. The transports are selected by
+ * UCX_TLS, for example: UCX_TLS=posix or UCX_TLS=tcp.
+ */
+
+
+static double get_time()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + (tv.tv_usec * 1e-6);
+}
+
+static void flush_callback(void *request, ucs_status_t status)
+{
+}
+
+static void progress(ucp_worker_h worker1, ucp_worker_h worker2)
+{
+    ucp_worker_progress(worker1);
+    ucp_worker_progress(worker2);
+}
+
+static ucs_status_t wait_request(ucp_worker_h worker1, ucp_worker_h worker2,
+                                 void *request)
+{
+    ucs_status_t status;
+
+    if (!UCS_PTR_IS_PTR(request)) {
+        return UCS_PTR_STATUS(request);
+    }
+
+    do {
+        progress(worker1, worker2);
+        status = ucp_request_check_status(request);
+    } while (status == UCS_INPROGRESS);
+
+    ucp_request_free(request);
+    return status;
+}
+
+static void usage()
+{
+    printf("Usage: test_ucp_ep_create [options]\n");
+    printf("Options:\n");
+    printf("  -n <count>   Number of endpoints to create (default: 1024)\n");
+    printf("  -b           Create the endpoints by ucp_ep_create_bulk()\n");
+    printf("  -h           Show this help\n");
+}
+
+int main(int argc, char **argv)
+{
+    size_t count    = 1024;
+    int bulk        = 0;
+    ucp_worker_params_t worker_params;
+    ucp_ep_params_t *ep_params;
+    ucp_worker_h worker1, worker2;
+    ucp_address_t *address;
+    ucp_context_h context;
+    double start, created;
+    ucp_params_t params;
+    size_t address_length;
+    ucs_status_t status;
+    ucp_ep_h *eps;
+    size_t i;
+    int c;
+
+    while ((c = getopt(argc, argv, "n:bh")) != -1) {
+        switch (c) {
+        case 'n':
+            count = strtoul(optarg, NULL, 0);
+            break;
+        case 'b':
+            bulk = 1;
+            break;
+        case 'h':
+        default:
+            usage();
+            return (c == 'h') ? 0 : -1;
+        }
+    }
+
+    params.field_mask = UCP_PARAM_FIELD_FEATURES;
+    params.features   = UCP_FEATURE_TAG;
+
+    status = ucp_init(&params, NULL, &context);
+    if (status != UCS_OK) {
+        return -1;
+    }
+
+    worker_params.field_mask  = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+    worker_params.thread_mode = UCS_THREAD_MODE_SINGLE;
+
+    status = ucp_worker_create(context, &worker_params, &worker1);
+    if (status != UCS_OK) {
+        goto out_cleanup_context;
+    }
+
+    status = ucp_worker_create(context, &worker_params, &worker2);
+    if (status != UCS_OK) {
+        goto out_destroy_worker1;
+    }
+
+    status = ucp_worker_get_address(worker2, &address, &address_length);
+    if (status != UCS_OK) {
+        goto out_destroy_worker2;
+    }
+
+    ep_params = calloc(count, sizeof(*ep_params));
+    eps       = calloc(count, sizeof(*eps));
+    if ((ep_params == NULL) || (eps == NULL)) {
+        status = UCS_ERR_NO_MEMORY;
+        goto out_free;
+    }
+
+    for (i = 0; i < count; ++i) {
+        ep_params[i].field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+        ep_params[i].address    = address;
+    }
+
+    start = get_time();
+
+    if (bulk) {
+        status = ucp_ep_create_bulk(worker1, count, ep_params, eps);
+    } else {
+        for (i = 0; i < count; ++i) {
+            status = ucp_ep_create(worker1, &ep_params[i], &eps[i]);
+            if (status != UCS_OK) {
+                break;
+            }
+        }
+    }
+
+    if (status != UCS_OK) {
+        fprintf(stderr, "failed to create endpoints: %s\n",
+                ucs_status_string(status));
+        count = bulk ? 0 : i;
+        goto out_close_eps;
+    }
+
+    created = get_time();
+
+    for (i = 0; (i < count) && (status == UCS_OK); ++i) {
+        status = wait_request(worker1, worker2,
+                              ucp_ep_flush_nb(eps[i], 0, flush_callback));
+    }
+
+    if (status == UCS_OK) {
+        printf("%zu endpoints (%s): created in %.3f ms (%.2f us/ep), "
+               "connected in %.3f ms\n", count, bulk ? "bulk" : "one by one",
+               (created - start) * 1e3, (created - start) * 1e6 / count,
+               (get_time() - start) * 1e3);
+    } else {
+        fprintf(stderr, "failed to flush endpoints: %s\n",
+                ucs_status_string(status));
+    }
+
+out_close_eps:
+    for (i = 0; i < count; ++i) {
+        wait_request(worker1, worker2,
+                     ucp_ep_close_nb(eps[i], UCP_EP_CLOSE_MODE_FORCE));
+    }
+out_free:
+    free(eps);
+    free(ep_params);
+    ucp_worker_release_address(worker2, address);
+out_destroy_worker2:
+    ucp_worker_destroy(worker2);
+out_destroy_worker1:
+    ucp_worker_destroy(worker1);
+out_cleanup_context:
+    ucp_cleanup(context);
+    return (status == UCS_OK) ? 0 : -1;
+}
@@ -588,7 +588,9 @@ class test_ucp_am_nbx_rndv: public test_ucp_am_nbx {
 public:
     test_ucp_am_nbx_rndv()
     {
-        m_rx_dt = ucp_dt_make_contig(1);
+        m_rx_dt         = ucp_dt_make_contig(1);
+        m_in_handler    = false;
+        m_completed_in_handler = 0;
         modify_config("RNDV_THRESH", "128");
     }
 
@@ -611,10 +613,12 @@ public:
         params.datatype     = m_rx_dt_desc.dt();
         params.cb.recv_am   = am_data_recv_cb;
         params.user_data    = this;
+        m_in_handler        = true;
         ucs_status_ptr_t sp = ucp_am_recv_data_nbx(receiver().worker(),
                                                    data, m_rx_dt_desc.buf(),
                                                    m_rx_dt_desc.count(),
                                                    &params);
+        m_in_handler        = false;
         EXPECT_TRUE(UCS_PTR_IS_PTR(sp)) << "sp is: " << sp;
         ucp_request_release(sp);
 
@@ -628,6 +632,9 @@ public:
                                                                     (user_data);
         ASSERT_FALSE(self->m_am_received);
         self->m_am_received = true;
+        if (self->m_in_handler) {
+            ++self->m_completed_in_handler;
+        }
         EXPECT_UCS_OK(status);
         EXPECT_EQ(self->m_rx_buf, std::vector<char>(length, 'd'));
     }
@@ -635,6 +642,8 @@ public:
     ucp_datatype_t               m_rx_dt;
     ucp::data_type_desc_t        m_rx_dt_desc;
     std::vector<char>            m_rx_buf;
+    bool                         m_in_handler;
+    unsigned                     m_completed_in_handler;
 };
 
 UCS_TEST_P(test_ucp_am_nbx_rndv, rndv_auto, "RNDV_SCHEME=auto")
@@ -652,4 +661,18 @@ UCS_TEST_P(test_ucp_am_nbx_rndv, rndv_put, "RNDV_SCHEME=put_zcopy")
     test_am_send_recv(65536);
 }
 
+/* the receive may complete from within the RTS handler, when the transport
+ * fetches the data synchronously; the RTS descriptor must be released only
+ * once, after the handler returns */
+UCS_TEST_P(test_ucp_am_nbx_rndv, rndv_get_complete_in_handler,
+           "RNDV_SCHEME=get_zcopy")
+{
+    for (int i = 0; i < 100; ++i) {
+        test_am_send_recv(65536);
+    }
+
+    UCS_TEST_MESSAGE << m_completed_in_handler
+                     << " receives completed in the RTS handler";
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_rndv)
@@ -507,10 +507,13 @@ public:
                                      TEST_TAG, result);
         return result;
     }
+
+protected:
+    void kill_receiver();
 };
 
-UCS_TEST_P(test_ucp_peer_failure_keepalive, kill_receiver,
-           "KEEPALIVE_TIMEOUT=0.3", "KEEPALIVE_NUM_EPS=inf") {
+void test_ucp_peer_failure_keepalive::kill_receiver()
+{
     /* TODO: wireup is not tested yet */
 
     scoped_log_handler err_handler(wrap_errors_logger);
@@ -553,4 +556,27 @@ UCS_TEST_P(test_ucp_peer_failure_keepalive, kill_receiver,
     EXPECT_EQ(0, m_err_count); /* ensure no errors are detected */
 }
 
+UCS_TEST_P(test_ucp_peer_failure_keepalive, kill_receiver,
+           "KEEPALIVE_TIMEOUT=0.3", "KEEPALIVE_NUM_EPS=inf") {
+    kill_receiver();
+}
+
+/* Only one endpoint is checked on every timer tick, so the check of one of
+ * the endpoints is postponed */
+UCS_TEST_P(test_ucp_peer_failure_keepalive, kill_receiver_one_ep_per_round,
+           "KEEPALIVE_TIMEOUT=0.3", "KEEPALIVE_NUM_EPS=1") {
+    kill_receiver();
+}
+
+UCS_TEST_P(test_ucp_peer_failure_keepalive, idle_progress,
+           "KEEPALIVE_TIMEOUT=100s", "KEEPALIVE_NUM_EPS=inf") {
+    smoke_test(true);
+
+    /* No keepalive deadline is due, so the keepalive callback is not called
+     * from the worker progress */
+    progress();
+    EXPECT_EQ(UCS_CALLBACKQ_ID_NULL, sender().worker()->keepalive.cb_id);
+    EXPECT_FALSE(ucs_twheel_is_empty(&sender().worker()->keepalive.wheel));
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_peer_failure_keepalive)
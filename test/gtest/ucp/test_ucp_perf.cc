@@ -76,6 +76,18 @@ const test_perf::test_spec test_ucp_perf::tests[] =
     ucs_offsetof(ucx_perf_result_t, msgrate.total_average), 1e-6, 0.1, 100.0,
     UCX_PERF_TEST_FLAG_TAG_WILDCARD },
 
+  { "tag cq latency", "usec",
+    UCX_PERF_API_UCP, UCX_PERF_CMD_TAG, UCX_PERF_TEST_TYPE_PINGPONG,
+    UCP_PERF_DATATYPE_CONTIG, 0, 1, { 8 }, 1, 100000lu,
+    ucs_offsetof(ucx_perf_result_t, latency.total_average), 1e6, 0.001, 60.0,
+    UCX_PERF_TEST_FLAG_CQ },
+
+  { "tag cq mr", "Mpps",
+    UCX_PERF_API_UCP, UCX_PERF_CMD_TAG, UCX_PERF_TEST_TYPE_STREAM_UNI,
+    UCP_PERF_DATATYPE_CONTIG, 0, 1, { 8 }, 1, 2000000lu,
+    ucs_offsetof(ucx_perf_result_t, msgrate.total_average), 1e-6, 0.1, 100.0,
+    UCX_PERF_TEST_FLAG_CQ },
+
   { "tag bw", "MB/sec",
     UCX_PERF_API_UCP, UCX_PERF_CMD_TAG, UCX_PERF_TEST_TYPE_STREAM_UNI,
     UCT_PERF_DATA_LAYOUT_LAST, 0, 1, { 2048 }, 1, 100000lu,
@@ -104,6 +116,12 @@ const test_perf::test_spec test_ucp_perf::tests[] =
     ucs_offsetof(ucx_perf_result_t, bandwidth.total_average), MB, 200.0, 100000.0,
     0 },
 
+  { "put batch rate", "Mpps",
+    UCX_PERF_API_UCP, UCX_PERF_CMD_PUT_BATCH, UCX_PERF_TEST_TYPE_STREAM_UNI,
+    UCP_PERF_DATATYPE_CONTIG, 64, 3, { 8, 8, 8 }, 32, 1000000lu,
+    ucs_offsetof(ucx_perf_result_t, msgrate.total_average), 1e-6, 0.1, 100.0,
+    0 },
+
   { "get latency", "usec",
     UCX_PERF_API_UCP, UCX_PERF_CMD_GET, UCX_PERF_TEST_TYPE_STREAM_UNI,
     UCP_PERF_DATATYPE_CONTIG, 0, 1, { 8 }, 1, 100000lu,
@@ -195,3 +213,6 @@ UCS_TEST_P(test_ucp_perf, envelope) {
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_perf)
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_perf, intra, "intra")
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_perf, posix, "posix")
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_perf, sysv,  "sysv")
@@ -8,8 +8,10 @@
 #include "test_ucp_memheap.h"
 
 #include <ucs/sys/sys.h>
+#include <algorithm>
 extern "C" {
 #include <ucp/core/ucp_mm.h> /* for UCP_MEM_IS_ACCESSIBLE_FROM_CPU */
+#include <ucp/core/ucp_worker.h>
 }
 
 
@@ -48,6 +50,13 @@ public:
         request_release(status_ptr);
     }
 
+    void put_batch(size_t size, void *target_ptr, ucp_rkey_h rkey,
+                   void *expected_data, void *arg) {
+        ucs_status_ptr_t status_ptr = do_put_batch(size, target_ptr, rkey,
+                                                   expected_data, arg);
+        request_wait(status_ptr);
+    }
+
     void get_b(size_t size, void *target_ptr, ucp_rkey_h rkey,
                void *expected_data, void *arg) {
         ucs_status_ptr_t status_ptr = do_get(size, target_ptr, rkey,
@@ -63,6 +72,33 @@ public:
     }
 
 protected:
+    /* Put a random value to the slot of the given endpoint and flush the
+     * worker, return the time it took to flush */
+    ucs_time_t put_and_flush_worker(int ep_index, ucp_rkey_h rkey,
+                                    uint64_t *sbuf, uint64_t *rbuf) {
+        ucp_ep_h ep = sender().ep(0, ep_index);
+        ucp_request_param_t param;
+        ucs_time_t start_time;
+
+        sbuf[ep_index]     = ucs::rand();
+        param.op_attr_mask = 0;
+        request_release(ucp_put_nbx(ep, &sbuf[ep_index], sizeof(*sbuf),
+                                    (uintptr_t)&rbuf[ep_index], rkey, &param));
+        EXPECT_TRUE(ep->flags & UCP_EP_FLAG_RMA_DIRTY);
+
+        start_time = ucs_get_time();
+        flush_worker(sender());
+        start_time = ucs_get_time() - start_time;
+
+        EXPECT_FALSE(ep->flags & UCP_EP_FLAG_RMA_DIRTY);
+        EXPECT_EQ(sbuf[ep_index], rbuf[ep_index]) << "ep_index=" << ep_index;
+        return start_time;
+    }
+
+    bool is_ep_flush() {
+        return GetParam().variant == FLUSH_EP;
+    }
+
     void test_mem_types(send_func_t send_func) {
         std::vector<std::vector<ucs_memory_type_t> > pairs =
                 ucs::supported_mem_type_pairs();
@@ -102,6 +138,40 @@ private:
                            (uintptr_t)target_ptr, rkey, &param);
     }
 
+    ucs_status_ptr_t do_put_batch(size_t size, void *target_ptr,
+                                  ucp_rkey_h rkey, void *expected_data,
+                                  void *arg) {
+        static const size_t MAX_CHUNKS = 16;
+        ucs_memory_type_t *mem_types   = reinterpret_cast<ucs_memory_type_t*>(arg);
+        std::vector<ucp_put_batch_op_t> ops;
+        size_t offset, length;
+
+        mem_buffer::pattern_fill(expected_data, size, ucs::rand(), mem_types[0]);
+
+        /* Split the buffer to random chunks, and post the second half of the
+         * chunks before the first half, so some of them are coalesced */
+        for (offset = 0; offset < size; offset += length) {
+            length = ucs_min(size - offset,
+                             1 + (ucs::rand() % (size / MAX_CHUNKS + 1)));
+
+            ucp_put_batch_op_t op;
+            op.ep          = sender().ep();
+            op.buffer      = UCS_PTR_BYTE_OFFSET(expected_data, offset);
+            op.length      = length;
+            op.remote_addr = (uintptr_t)target_ptr + offset;
+            op.rkey        = rkey;
+            ops.push_back(op);
+        }
+
+        std::rotate(ops.begin(), ops.begin() + (ops.size() / 2), ops.end());
+
+        ucp_request_param_t param;
+        param.op_attr_mask = 0;
+        return ucp_put_batch_nbx(sender().worker(),
+                                 ops.empty() ? NULL : &ops[0], ops.size(),
+                                 &param);
+    }
+
     ucs_status_ptr_t do_get(size_t size, void *target_ptr, ucp_rkey_h rkey,
                             void *expected_data) {
         ucp_request_param_t param;
@@ -141,10 +211,6 @@ private:
                       target_mem_type, mem_map_flags, is_ep_flush(), mem_types);
        }
     }
-
-    bool is_ep_flush() {
-        return GetParam().variant == FLUSH_EP;
-    }
 };
 
 UCS_TEST_P(test_ucp_rma, put_blocking) {
@@ -155,6 +221,10 @@ UCS_TEST_P(test_ucp_rma, put_nonblocking) {
     test_mem_types(static_cast<send_func_t>(&test_ucp_rma::put_nbi));
 }
 
+UCS_TEST_P(test_ucp_rma, put_batch) {
+    test_mem_types(static_cast<send_func_t>(&test_ucp_rma::put_batch));
+}
+
 UCS_TEST_P(test_ucp_rma, get_blocking) {
     test_mem_types(static_cast<send_func_t>(&test_ucp_rma::get_b));
 }
@@ -163,4 +233,67 @@ UCS_TEST_P(test_ucp_rma, get_nonblocking) {
     test_mem_types(static_cast<send_func_t>(&test_ucp_rma::get_nbi));
 }
 
+UCS_TEST_P(test_ucp_rma, flush_worker_dirty_eps) {
+    static const unsigned num_iters = 100;
+    const int max_eps               = ucs_max(4, 256 / ucs::test_time_multiplier());
+    std::vector<ucp_rkey_h> rkeys;
+    std::vector<uint64_t> sbuf(max_eps);
+    size_t rkey_buffer_size;
+    void *rkey_buffer;
+    ucs_status_t status;
+    ucp_rkey_h rkey;
+
+    if (is_ep_flush()) {
+        UCS_TEST_SKIP_R("worker flush only");
+    }
+
+    mapped_buffer rbuf(max_eps * sizeof(uint64_t), receiver());
+    status = ucp_rkey_pack(receiver().ucph(), rbuf.memh(), &rkey_buffer,
+                           &rkey_buffer_size);
+    ASSERT_UCS_OK(status);
+
+    /* Worker flush time should depend on the number of endpoints which issued
+     * RMA since the last flush, rather than on the total number of endpoints */
+    for (int num_eps = 1; ; num_eps = ucs_min(num_eps * 4, max_eps)) {
+        while ((int)rkeys.size() < num_eps) {
+            if (!rkeys.empty()) {
+                sender().connect(&receiver(), get_ep_params(), rkeys.size());
+            }
+
+            status = ucp_ep_rkey_unpack(sender().ep(0, rkeys.size()),
+                                        rkey_buffer, &rkey);
+            ASSERT_UCS_OK(status);
+            rkeys.push_back(rkey);
+
+            /* Complete wireup of the new endpoint before measuring */
+            put_and_flush_worker(rkeys.size() - 1, rkey, &sbuf[0],
+                                 (uint64_t*)rbuf.ptr());
+        }
+
+        ucs_time_t flush_time = 0;
+        for (unsigned i = 0; i < num_iters; ++i) {
+            int ep_index = ucs::rand() % num_eps;
+            flush_time  += put_and_flush_worker(ep_index, rkeys[ep_index],
+                                                &sbuf[0], (uint64_t*)rbuf.ptr());
+        }
+
+        UCS_TEST_MESSAGE << num_eps << " endpoints: worker flush "
+                         << ucs_time_to_usec(flush_time) / num_iters
+                         << " usec";
+
+        if (num_eps == max_eps) {
+            break;
+        }
+    }
+
+    /* Fence should clear the map of resources with outstanding operations */
+    sender().fence();
+    EXPECT_EQ(0ul, sender().worker()->rma_dirty_tl_bitmap);
+
+    for (size_t i = 0; i < rkeys.size(); ++i) {
+        ucp_rkey_destroy(rkeys[i]);
+    }
+    ucp_rkey_buffer_release(rkey_buffer);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_rma)
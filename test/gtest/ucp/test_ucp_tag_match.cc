@@ -11,6 +11,10 @@
 extern "C" {
 #include <ucp/core/ucp_request.h>
 #include <ucp/core/ucp_types.h>
+#include <ucp/core/ucp_worker.h>
+#include <ucp/core/ucp_ep.inl>
+#include <ucp/tag/eager.h>
+#include <ucs/datastruct/ptr_map.inl>
 }
 
 using namespace ucs; /* For vector<char> serialization */
@@ -456,6 +460,133 @@ UCS_TEST_P(test_ucp_tag_match, sync_send_unexp) {
     request_free(my_send_req);
 }
 
+UCS_TEST_P(test_ucp_tag_match, unexp_compact, "TAG_UNEXP_DESC_MAX=0") {
+    static const unsigned num_msgs = 100;
+    ucp_tag_match_t *tm            = &receiver().worker()->tm;
+    std::vector<char> send_data(1000), recv_data(send_data.size());
+    std::vector<request*> send_reqs;
+    ucp_tag_recv_info_t info;
+    ucs_status_t status;
+
+    skip_loopback();
+
+    ucs::fill_random(send_data);
+    for (unsigned i = 0; i < num_msgs; ++i) {
+        send_reqs.push_back(send_nb(&send_data[0], send_data.size(), DATATYPE,
+                                    0x111337));
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(send_reqs.back()));
+    }
+
+    while (tm->unexpected.length < (num_msgs * send_data.size())) {
+        progress();
+    }
+
+    /* all unexpected data was copied out of transport descriptors */
+    EXPECT_EQ(0u, tm->unexpected.uct_desc_count);
+
+    for (unsigned i = 0; i < num_msgs; ++i) {
+        status = recv_b(&recv_data[0], recv_data.size(), DATATYPE, 0x1337,
+                        0xffff, &info);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(send_data.size(), info.length);
+        EXPECT_EQ(send_data, recv_data);
+    }
+
+    EXPECT_EQ(0u, tm->unexpected.length);
+    for (std::vector<request*>::iterator it = send_reqs.begin();
+         it != send_reqs.end(); ++it) {
+        wait_and_validate(*it);
+    }
+}
+
+UCS_TEST_P(test_ucp_tag_match, unexp_flood_fc, "TAG_UNEXP_MEM_LIMIT=16k",
+           "TAG_EAGER_FC=y") {
+    static const unsigned max_msgs = 1000;
+    static const size_t   msg_size = 1000;
+    ucp_tag_match_t *recv_tm       = &receiver().worker()->tm;
+    ucp_tag_match_t *send_tm       = &sender().worker()->tm;
+    std::vector<char> send_data(msg_size), recv_data(msg_size);
+    std::vector<request*> send_reqs;
+    ucp_recv_desc_t *rdesc;
+    ucp_tag_recv_info_t info;
+    ucs_status_t status;
+    ucs_time_t deadline;
+    unsigned i;
+
+    skip_loopback();
+
+    if (!ucp_ep_config_test_rndv_support(ucp_ep_config(sender().ep()))) {
+        UCS_TEST_SKIP_R("rendezvous is not supported");
+    }
+
+    /* the receiver can notify only the peers it has endpoints to */
+    receiver().connect(&sender(), get_ep_params());
+
+    /* flood the receiver with unexpected eager messages, until it asks the
+     * sender to switch to rendezvous */
+    ucs::fill_random(send_data);
+    for (i = 0; (i < max_msgs) &&
+                (kh_size(&send_tm->eager_fc.throttled_eps) == 0); ++i) {
+        send_reqs.push_back(send_nb(&send_data[0], msg_size, DATATYPE,
+                                    0x111337));
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(send_reqs.back()));
+        progress();
+    }
+
+    ASSERT_EQ(1u, kh_size(&send_tm->eager_fc.throttled_eps));
+    EXPECT_TRUE(recv_tm->unexpected.over_limit);
+
+    /* the receiver gets only the rendezvous request of the next message */
+    send_reqs.push_back(send_nb(&send_data[0], msg_size, DATATYPE, 0x111337));
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(send_reqs.back()));
+    ++i;
+    do {
+        progress();
+        rdesc = ucs_list_tail(&recv_tm->unexpected.all, ucp_recv_desc_t,
+                              tag_list[UCP_RDESC_ALL_LIST]);
+    } while (!(rdesc->flags & UCP_RECV_DESC_FLAG_RNDV));
+    EXPECT_LT(rdesc->length, msg_size);
+
+    /* draining the unexpected queue lets the sender use eager again */
+    for (; i > 0; --i) {
+        status = recv_b(&recv_data[0], msg_size, DATATYPE, 0x1337, 0xffff,
+                        &info);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(msg_size, info.length);
+        EXPECT_EQ(send_data, recv_data);
+    }
+
+    EXPECT_FALSE(recv_tm->unexpected.over_limit);
+    deadline = ucs_get_time() + ucs_time_from_sec(10.0);
+    while ((kh_size(&send_tm->eager_fc.throttled_eps) != 0) &&
+           (ucs_get_time() < deadline)) {
+        progress();
+    }
+    EXPECT_EQ(0u, kh_size(&send_tm->eager_fc.throttled_eps));
+
+    for (std::vector<request*>::iterator it = send_reqs.begin();
+         it != send_reqs.end(); ++it) {
+        wait_and_validate(*it);
+    }
+}
+
+UCS_TEST_P(test_ucp_tag_match, fc_unknown_ep, "TAG_EAGER_FC=y") {
+    ucp_tag_match_t *send_tm = &sender().worker()->tm;
+    ucp_eager_fc_hdr_t fc_hdr;
+    ucs_status_t status;
+
+    /* a flow control message for an endpoint which does not exist anymore
+     * must be dropped */
+    fc_hdr.ep_id    = ((ucs_ptr_map_key_t)UINT32_MAX <<
+                       UCS_PTR_MAP_KEY_INDEX_SHIFT) |
+                      UCS_PTR_MAP_KEY_INDIRECT_FLAG;
+    fc_hdr.throttle = 1;
+    status = ucp_am_handlers[UCP_AM_ID_EAGER_FC].cb(sender().worker(), &fc_hdr,
+                                                    sizeof(fc_hdr), 0);
+    EXPECT_UCS_OK(status);
+    EXPECT_EQ(0u, kh_size(&send_tm->eager_fc.throttled_eps));
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match)
 
 class test_ucp_tag_match_rndv : public test_ucp_tag_match {
@@ -804,3 +935,176 @@ UCS_TEST_P(test_ucp_tag_match_rndv, bidir_multi_exp_post, "RNDV_THRESH=0") {
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match_rndv)
+
+class test_ucp_tag_cq : public test_ucp_tag {
+protected:
+    typedef std::map<void*, ucp_cq_entry_t> cq_entries_t;
+
+    static const ucp_tag_t TAG = 0xc0c0;
+
+    void *send_cq(const void *buffer, size_t length, void *user_data) {
+        ucp_request_param_t param;
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_USER_DATA | UCP_OP_ATTR_FLAG_CQ;
+        param.user_data    = user_data;
+        return ucp_tag_send_nbx(sender().ep(), buffer, length, TAG, &param);
+    }
+
+    void *recv_cq(void *buffer, size_t length, void *user_data) {
+        ucp_request_param_t param;
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_USER_DATA | UCP_OP_ATTR_FLAG_CQ;
+        param.user_data    = user_data;
+        return ucp_tag_recv_nbx(receiver().worker(), buffer, length, TAG,
+                                (ucp_tag_t)-1, &param);
+    }
+
+    void poll_cq(entity &e, cq_entries_t &entries) {
+        ucp_cq_entry_t cq_entries[8];
+        unsigned i, count;
+
+        do {
+            count = ucp_worker_cq_poll(e.worker(), cq_entries,
+                                       ucs_static_array_size(cq_entries));
+            for (i = 0; i < count; ++i) {
+                /* every request is reported once */
+                EXPECT_TRUE(entries.insert(std::make_pair(cq_entries[i].request,
+                                                          cq_entries[i])).second);
+            }
+        } while (count > 0);
+    }
+
+    /* progress until all requests in the map are reported */
+    void wait_cq(const std::map<void*, void*> &requests,
+                 cq_entries_t &entries) {
+        ucs_time_t deadline = ucs::get_deadline();
+
+        while ((entries.size() < requests.size()) &&
+               (ucs_get_time() < deadline)) {
+            progress();
+            poll_cq(sender(), entries);
+            if (!is_loopback()) {
+                poll_cq(receiver(), entries);
+            }
+        }
+
+        ASSERT_EQ(requests.size(), entries.size());
+        for (std::map<void*, void*>::const_iterator it = requests.begin();
+             it != requests.end(); ++it) {
+            cq_entries_t::iterator entry = entries.find(it->first);
+            ASSERT_TRUE(entry != entries.end());
+            EXPECT_UCS_OK(entry->second.status);
+            EXPECT_EQ(it->second, entry->second.user_data);
+            ucp_request_free(entry->first);
+        }
+    }
+};
+
+UCS_TEST_P(test_ucp_tag_cq, send_recv) {
+    /* more than the default completion queue size, to make it grow */
+    static const size_t num_msgs = 1000;
+    static const size_t sizes[]  = { 8, 4096, 65536 };
+    std::vector<std::vector<char> > send_data(num_msgs), recv_data(num_msgs);
+    std::map<void*, void*> requests;
+    cq_entries_t entries;
+    void *request;
+    size_t i;
+
+    for (i = 0; i < num_msgs; ++i) {
+        send_data[i].resize(sizes[i % ucs_static_array_size(sizes)]);
+        recv_data[i].resize(send_data[i].size());
+        ucs::fill_random(send_data[i]);
+
+        request = recv_cq(&recv_data[i][0], recv_data[i].size(),
+                          &recv_data[i]);
+        ASSERT_UCS_PTR_OK(request);
+        if (request != NULL) {
+            requests[request] = &recv_data[i];
+        }
+    }
+
+    for (i = 0; i < num_msgs; ++i) {
+        request = send_cq(&send_data[i][0], send_data[i].size(),
+                          &send_data[i]);
+        ASSERT_UCS_PTR_OK(request);
+        if (request != NULL) {
+            requests[request] = &send_data[i];
+        }
+    }
+
+    wait_cq(requests, entries);
+    EXPECT_EQ(send_data, recv_data);
+}
+
+UCS_TEST_P(test_ucp_tag_cq, release_before_completion) {
+    std::vector<std::vector<char> > send_data(2, std::vector<char>(1024)),
+                                    recv_data(2, std::vector<char>(1024));
+    std::map<void*, void*> requests;
+    cq_entries_t entries;
+    void *request;
+    size_t i;
+
+    /* the first receive is released before it is completed */
+    for (i = 0; i < send_data.size(); ++i) {
+        ucs::fill_random(send_data[i]);
+        request = recv_cq(&recv_data[i][0], recv_data[i].size(),
+                          &recv_data[i]);
+        ASSERT_UCS_PTR_OK(request);
+        ASSERT_TRUE(request != NULL);
+        if (i == 0) {
+            ucp_request_free(request);
+        } else {
+            requests[request] = &recv_data[i];
+        }
+    }
+
+    for (i = 0; i < send_data.size(); ++i) {
+        request = send_cq(&send_data[i][0], send_data[i].size(),
+                          &send_data[i]);
+        ASSERT_UCS_PTR_OK(request);
+        if (request != NULL) {
+            requests[request] = &send_data[i];
+        }
+    }
+
+    wait_cq(requests, entries);
+    EXPECT_EQ(send_data, recv_data);
+
+    /* the released receive request is not reported */
+    short_progress_loop();
+    poll_cq(receiver(), entries);
+    EXPECT_EQ(requests.size(), entries.size());
+}
+
+UCS_TEST_P(test_ucp_tag_cq, grow_failure) {
+    std::vector<char> send_data(1024), recv_data(1024);
+    cq_entries_t entries;
+    ucs_status_t status;
+    void *request;
+
+    /* make the first allocation of the receiver completion queue fail */
+    receiver().worker()->cq.init_size = UCS_BIT(31);
+
+    ucs::fill_random(send_data);
+    request = recv_cq(&recv_data[0], recv_data.size(), &recv_data);
+    ASSERT_UCS_PTR_OK(request);
+    ASSERT_TRUE(request != NULL);
+
+    {
+        scoped_log_handler wrap_err(wrap_errors_logger);
+        send_b(&send_data[0], send_data.size(), ucp_dt_make_contig(1), TAG);
+        while ((status = ucp_request_check_status(request)) ==
+               UCS_INPROGRESS) {
+            progress();
+        }
+    }
+
+    /* the completion is not queued, but it is still visible on the request */
+    EXPECT_UCS_OK(status);
+    EXPECT_EQ(send_data, recv_data);
+    poll_cq(receiver(), entries);
+    EXPECT_TRUE(entries.empty());
+    ucp_request_free(request);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_cq)
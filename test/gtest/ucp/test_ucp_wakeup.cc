@@ -6,6 +6,10 @@
 
 #include "ucp_test.h"
 
+extern "C" {
+#include <ucp/core/ucp_worker.h>
+}
+
 #include <algorithm>
 #include <sys/epoll.h>
 #include <sys/poll.h>
@@ -44,6 +48,70 @@ protected:
         ASSERT_EQ(UCS_OK, status);
     }
 
+    void tx_wait() {
+        const ucp_datatype_t DATATYPE = ucp_dt_make_contig(1);
+        const size_t COUNT            = 20000;
+        const uint64_t TAG            = 0xdeadbeef;
+        std::string send_data(COUNT, '2'), recv_data(COUNT, '1');
+        void *sreq, *rreq;
+
+        sender().connect(&receiver(), get_ep_params());
+
+        rreq = ucp_tag_recv_nb(receiver().worker(), &recv_data[0], COUNT,
+                               DATATYPE, TAG, (ucp_tag_t)-1, recv_completion);
+
+        sreq = ucp_tag_send_nb(sender().ep(), &send_data[0], COUNT, DATATYPE,
+                               TAG, send_completion);
+
+        if (UCS_PTR_IS_PTR(sreq)) {
+            /* wait for send completion */
+            while (!ucp_request_is_completed(sreq)) {
+                ucp_worker_wait(sender().worker());
+                while (progress());
+            }
+            ucp_request_release(sreq);
+        } else {
+            ASSERT_UCS_OK(UCS_PTR_STATUS(sreq));
+        }
+
+        wait(rreq);
+
+        EXPECT_EQ(send_data, recv_data);
+    }
+
+    void rx_wait() {
+        const ucp_datatype_t DATATYPE = ucp_dt_make_contig(1);
+        const uint64_t TAG            = 0xdeadbeef;
+        uint64_t send_data            = 0x12121212;
+        uint64_t recv_data            = 0;
+        void *req;
+
+        sender().connect(&receiver(), get_ep_params());
+
+        req = ucp_tag_recv_nb(receiver().worker(), &recv_data,
+                              sizeof(recv_data), DATATYPE, TAG, (ucp_tag_t)-1,
+                              recv_completion);
+
+        void *sreq = ucp_tag_send_nb(sender().ep(), &send_data,
+                                     sizeof(send_data), DATATYPE, TAG,
+                                     send_completion);
+
+        /* the receiver waits without progressing the sender */
+        while (!ucp_request_is_completed(req)) {
+            ASSERT_UCS_OK(ucp_worker_wait(receiver().worker()));
+            ucp_worker_progress(receiver().worker());
+        }
+        ucp_request_release(req);
+
+        if (UCS_PTR_IS_PTR(sreq)) {
+            wait(sreq);
+        } else {
+            ASSERT_UCS_OK(UCS_PTR_STATUS(sreq));
+        }
+
+        EXPECT_EQ(send_data, recv_data);
+    }
+
     static size_t comp_cntr;
 };
 
@@ -120,34 +188,22 @@ UCS_TEST_P(test_ucp_wakeup, efd)
 UCS_TEST_SKIP_COND_P(test_ucp_wakeup, tx_wait, has_transport("tcp"),
                      "ZCOPY_THRESH=10000", "RNDV_THRESH=-1")
 {
-    const ucp_datatype_t DATATYPE = ucp_dt_make_contig(1);
-    const size_t COUNT            = 20000;
-    const uint64_t TAG            = 0xdeadbeef;
-    std::string send_data(COUNT, '2'), recv_data(COUNT, '1');
-    void *sreq, *rreq;
-
-    sender().connect(&receiver(), get_ep_params());
-
-    rreq = ucp_tag_recv_nb(receiver().worker(), &recv_data[0], COUNT, DATATYPE,
-                           TAG, (ucp_tag_t)-1, recv_completion);
-
-    sreq = ucp_tag_send_nb(sender().ep(), &send_data[0], COUNT, DATATYPE, TAG,
-                           send_completion);
-
-    if (UCS_PTR_IS_PTR(sreq)) {
-        /* wait for send completion */
-        while (!ucp_request_is_completed(sreq)) {
-            ucp_worker_wait(sender().worker());
-            while (progress());
-        }
-        ucp_request_release(sreq);
-    } else {
-        ASSERT_UCS_OK(UCS_PTR_STATUS(sreq));
-    }
+    tx_wait();
+}
 
-    wait(rreq);
+UCS_TEST_SKIP_COND_P(test_ucp_wakeup, tx_wait_spin, has_transport("tcp"),
+                     "ZCOPY_THRESH=10000", "RNDV_THRESH=-1",
+                     "WAIT_SPIN_TIME=100us")
+{
+    tx_wait();
+}
 
-    EXPECT_EQ(send_data, recv_data);
+/* The sender is not progressed while the receiver waits, so skip TCP for the
+ * same reason as in tx_wait */
+UCS_TEST_SKIP_COND_P(test_ucp_wakeup, rx_wait_spin, has_transport("tcp"),
+                     "WAIT_SPIN_TIME=1s", "WAIT_SPIN_ADAPTIVE=n")
+{
+    rx_wait();
 }
 
 UCS_TEST_P(test_ucp_wakeup, signal)
@@ -182,6 +238,47 @@ UCS_TEST_P(test_ucp_wakeup, signal)
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_wakeup)
 
+#ifdef ENABLE_STATS
+
+class test_ucp_wakeup_stats : public test_ucp_wakeup {
+public:
+    void init() {
+        stats_activate();
+        test_ucp_wakeup::init();
+    }
+
+    void cleanup() {
+        test_ucp_wakeup::cleanup();
+        stats_restore();
+    }
+
+protected:
+    uint64_t get_rx_wait_stat(unsigned counter) {
+        return UCS_STATS_GET_COUNTER(receiver().worker()->stats, counter);
+    }
+};
+
+/* The message is found while spinning, so the wait returns without blocking
+ * even though the sender is not progressed */
+UCS_TEST_SKIP_COND_P(test_ucp_wakeup_stats, rx_wait_spin, has_transport("tcp"),
+                     "WAIT_SPIN_TIME=1s", "WAIT_SPIN_ADAPTIVE=n")
+{
+    rx_wait();
+    EXPECT_GT(get_rx_wait_stat(UCP_WORKER_STAT_WAIT_SPIN), 0ul);
+    EXPECT_EQ(0ul, get_rx_wait_stat(UCP_WORKER_STAT_WAIT_SLEEP));
+}
+
+UCS_TEST_SKIP_COND_P(test_ucp_wakeup_stats, rx_wait_no_spin,
+                     has_transport("tcp"))
+{
+    rx_wait();
+    EXPECT_EQ(0ul, get_rx_wait_stat(UCP_WORKER_STAT_WAIT_SPIN));
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_wakeup_stats)
+
+#endif
+
 class test_ucp_wakeup_external_epollfd : public test_ucp_wakeup {
 public:
     virtual ucp_worker_params_t get_worker_params() {
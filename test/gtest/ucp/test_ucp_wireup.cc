@@ -15,6 +15,7 @@
 
 extern "C" {
 #include <ucp/wireup/address.h>
+#include <ucp/wireup/wireup.h>
 #include <ucp/core/ucp_ep.inl>
 #include <ucs/sys/math.h>
 }
@@ -528,6 +529,134 @@ UCS_TEST_P(test_ucp_wireup_1sided, empty_address) {
     ucs_free(buffer);
 }
 
+UCS_TEST_P(test_ucp_wireup_1sided, compact_address) {
+    ucp_context_h context = sender().ucph();
+    std::vector<ucp_unpacked_address> unpacked(3);
+    std::vector<void*> buffers(3);
+    std::vector<size_t> sizes(3);
+    ucs_status_t status;
+
+    /* Pack the same address in regular, compact and digest formats */
+    for (int i = 0; i < 3; ++i) {
+        context->config.ext.address_compact = (i > 0);
+        context->config.ext.address_digest  = (i > 1);
+        status = ucp_address_pack(sender().worker(), NULL,
+                                  std::numeric_limits<uint64_t>::max(),
+                                  UCP_ADDRESS_PACK_FLAGS_ALL, m_lanes2remote,
+                                  &sizes[i], &buffers[i]);
+        ASSERT_UCS_OK(status);
+        status = ucp_address_unpack(sender().worker(), buffers[i],
+                                    UCP_ADDRESS_PACK_FLAGS_ALL, &unpacked[i]);
+        ASSERT_UCS_OK(status);
+    }
+
+    context->config.ext.address_compact = 0;
+    context->config.ext.address_digest  = 0;
+
+    UCS_TEST_MESSAGE << "address size: " << sizes[0] << " compact: "
+                     << sizes[1] << " digest: " << sizes[2];
+    EXPECT_LE(sizes[2], sizes[1]);
+    if (!ucp_worker_is_unified_mode(sender().worker())) {
+        EXPECT_LE(sizes[1], sizes[0] + 2);
+    }
+
+    for (int i = 1; i < 3; ++i) {
+        ASSERT_EQ(unpacked[0].address_count, unpacked[i].address_count);
+        for (unsigned j = 0; j < unpacked[0].address_count; ++j) {
+            const ucp_address_entry_t *ae0 = &unpacked[0].address_list[j];
+            const ucp_address_entry_t *ae  = &unpacked[i].address_list[j];
+            EXPECT_EQ(ae0->tl_name_csum, ae->tl_name_csum);
+            EXPECT_EQ(ae0->iface_attr.cap_flags, ae->iface_attr.cap_flags);
+            EXPECT_EQ(ae0->iface_attr.event_flags, ae->iface_attr.event_flags);
+            EXPECT_EQ(ae0->iface_attr.priority, ae->iface_attr.priority);
+            EXPECT_EQ(ae0->iface_attr.overhead, ae->iface_attr.overhead);
+            EXPECT_EQ(ae0->iface_attr.lat_ovh, ae->iface_attr.lat_ovh);
+            EXPECT_EQ(ae0->iface_attr.bandwidth.dedicated,
+                      ae->iface_attr.bandwidth.dedicated);
+            EXPECT_EQ(ae0->iface_attr.bandwidth.shared,
+                      ae->iface_attr.bandwidth.shared);
+            EXPECT_EQ(ae0->iface_attr.atomic.atomic64.fop_flags,
+                      ae->iface_attr.atomic.atomic64.fop_flags);
+        }
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        ucs_free(unpacked[i].address_list);
+        ucs_free(buffers[i]);
+    }
+}
+
+UCS_TEST_P(test_ucp_wireup_1sided, address_cache) {
+    ucp_unpacked_address unpacked_address1, unpacked_address2;
+    ucs_status_t status;
+    size_t size, empty_size;
+    void *buffer, *empty_buffer;
+    int cached;
+
+    status = ucp_address_pack(sender().worker(), NULL,
+                              std::numeric_limits<uint64_t>::max(),
+                              UCP_ADDRESS_PACK_FLAGS_ALL, m_lanes2remote, &size,
+                              &buffer);
+    ASSERT_UCS_OK(status);
+
+    status = ucp_address_unpack_cached(receiver().worker(), buffer,
+                                       &unpacked_address1, &cached);
+    ASSERT_UCS_OK(status);
+    EXPECT_TRUE(cached);
+    EXPECT_EQ(sender().worker()->uuid, unpacked_address1.uuid);
+
+    /* The second unpack should return the same cached address list, which
+     * does not point into the packed buffer */
+    status = ucp_address_unpack_cached(receiver().worker(), buffer,
+                                       &unpacked_address2, &cached);
+    ASSERT_UCS_OK(status);
+    EXPECT_TRUE(cached);
+    EXPECT_EQ(unpacked_address1.address_list, unpacked_address2.address_list);
+    EXPECT_EQ(unpacked_address1.address_count, unpacked_address2.address_count);
+    EXPECT_EQ(1u, receiver().worker()->address_cache.count);
+
+    const ucp_address_entry_t *ae;
+    ucp_unpacked_address_for_each(ae, &unpacked_address2) {
+        if (ae->iface_addr != NULL) {
+            EXPECT_FALSE((ae->iface_addr >= buffer) &&
+                         (ae->iface_addr < UCS_PTR_BYTE_OFFSET(buffer, size)));
+        }
+    }
+
+    /* A shorter address of the same worker replaces the cached one, without
+     * comparing past its end */
+    status = ucp_address_pack(sender().worker(), NULL, 0,
+                              UCP_ADDRESS_PACK_FLAGS_ALL, m_lanes2remote,
+                              &empty_size, &empty_buffer);
+    ASSERT_UCS_OK(status);
+    ASSERT_LT(empty_size, size);
+
+    status = ucp_address_unpack_cached(receiver().worker(), empty_buffer,
+                                       &unpacked_address2, &cached);
+    ASSERT_UCS_OK(status);
+    EXPECT_TRUE(cached);
+    EXPECT_EQ(0u, unpacked_address2.address_count);
+    EXPECT_EQ(1u, receiver().worker()->address_cache.count);
+    ucs_free(empty_buffer);
+
+    /* The longer address replaces the shorter one again */
+    status = ucp_address_unpack_cached(receiver().worker(), buffer,
+                                       &unpacked_address2, &cached);
+    ASSERT_UCS_OK(status);
+    EXPECT_TRUE(cached);
+    EXPECT_EQ(unpacked_address1.address_count, unpacked_address2.address_count);
+    EXPECT_EQ(1u, receiver().worker()->address_cache.count);
+
+    ucs_free(buffer);
+}
+
+UCS_TEST_P(test_ucp_wireup_1sided, one_sided_wireup_compact_address,
+           "ADDRESS_COMPACT=y", "ADDRESS_DIGEST=y") {
+    sender().connect(&receiver(), get_ep_params());
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(), 1, 1);
+    flush_worker(sender());
+}
+
 UCS_TEST_P(test_ucp_wireup_1sided, one_sided_wireup) {
     sender().connect(&receiver(), get_ep_params());
     send_recv(sender().ep(), receiver().worker(), receiver().ep(), 1, 1);
@@ -704,6 +833,147 @@ UCS_TEST_P(test_ucp_wireup_1sided, multi_ep_1sided) {
     }
 }
 
+UCS_TEST_P(test_ucp_wireup_1sided, create_bulk) {
+    const unsigned count = 16;
+    std::vector<ucp_ep_params_t> ep_params(count, get_ep_params());
+    std::vector<ucp_ep_h> eps(count);
+    ucp_address_t *address;
+    size_t address_length;
+    ucs_status_t status;
+
+    /* skip the test if the peer is unreachable */
+    sender().connect(&receiver(), get_ep_params());
+
+    status = ucp_worker_get_address(receiver().worker(), &address,
+                                    &address_length);
+    ASSERT_UCS_OK(status);
+
+    for (unsigned i = 0; i < count; ++i) {
+        ep_params[i].field_mask |= UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+        ep_params[i].address     = address;
+    }
+
+    status = ucp_ep_create_bulk(sender().worker(), count, &ep_params[0],
+                                &eps[0]);
+    ucp_worker_release_address(receiver().worker(), address);
+    ASSERT_UCS_OK(status);
+
+    for (unsigned i = 0; i < count; ++i) {
+        /* same remote address layout should select the same configuration */
+        EXPECT_EQ(sender().ep()->cfg_index, eps[i]->cfg_index);
+        send_recv(eps[i], receiver().worker(), receiver().ep(), 8, 1);
+    }
+
+    for (unsigned i = 0; i < count; ++i) {
+        disconnect(eps[i]);
+    }
+}
+
+UCS_TEST_P(test_ucp_wireup_1sided, create_bulk_failure) {
+    const unsigned count = 8;
+    std::vector<ucp_ep_params_t> ep_params(count, get_ep_params());
+    std::vector<ucp_ep_h> eps(count);
+    ucp_address_t *address;
+    size_t address_length;
+    unsigned long num_eps;
+    ucs_status_t status;
+
+    sender().connect(&receiver(), get_ep_params());
+    num_eps = ucs_list_length(&sender().worker()->all_eps);
+
+    status = ucp_worker_get_address(receiver().worker(), &address,
+                                    &address_length);
+    ASSERT_UCS_OK(status);
+
+    for (unsigned i = 0; i < count; ++i) {
+        ep_params[i].field_mask |= UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+        ep_params[i].address     = address;
+    }
+
+    /* the last endpoint can't be created in bulk */
+    ep_params[count - 1].field_mask |= UCP_EP_PARAM_FIELD_FLAGS;
+    ep_params[count - 1].flags       = UCP_EP_PARAMS_FLAGS_CLIENT_SERVER;
+
+    {
+        scoped_log_handler wrap_err(wrap_errors_logger);
+        status = ucp_ep_create_bulk(sender().worker(), count, &ep_params[0],
+                                    &eps[0]);
+    }
+    ucp_worker_release_address(receiver().worker(), address);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, status);
+
+    /* the endpoints created before the failure are released */
+    EXPECT_EQ(num_eps, ucs_list_length(&sender().worker()->all_eps));
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(), 8, 1);
+}
+
+UCS_TEST_P(test_ucp_wireup_1sided, create_bulk_failure_matched) {
+    const unsigned count = 2;
+    std::vector<ucp_ep_params_t> ep_params(count, get_ep_params());
+    std::vector<ucp_ep_h> eps(count);
+    ucp_address_t *address;
+    size_t address_length;
+    unsigned long num_eps;
+    ucs_time_t deadline;
+    ucs_status_t status;
+    ucp_ep_h ep;
+
+    if (is_loopback()) {
+        UCS_TEST_SKIP_R("loopback endpoints are not matched");
+    }
+
+    /* the wireup request of the receiver creates an unexpected endpoint on
+     * the sender. The available transports connect to interfaces, so the
+     * request is sent explicitly, as a peer with p2p lanes would do. */
+    num_eps = ucs_list_length(&sender().worker()->all_eps);
+    receiver().connect(&sender(), get_ep_params());
+    UCS_ASYNC_BLOCK(&receiver().worker()->async);
+    status = ucp_wireup_send_request(receiver().ep());
+    UCS_ASYNC_UNBLOCK(&receiver().worker()->async);
+    ASSERT_UCS_OK(status);
+
+    deadline = ucs::get_deadline();
+    while ((ucs_list_length(&sender().worker()->all_eps) == num_eps) &&
+           (ucs_get_time() < deadline)) {
+        progress();
+    }
+    ASSERT_EQ(num_eps + 1, ucs_list_length(&sender().worker()->all_eps));
+
+    status = ucp_worker_get_address(receiver().worker(), &address,
+                                    &address_length);
+    ASSERT_UCS_OK(status);
+
+    /* the first endpoint is matched to the unexpected one, and the second one
+     * fails */
+    for (unsigned i = 0; i < count; ++i) {
+        ep_params[i].field_mask |= UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+        ep_params[i].address     = address;
+    }
+    ep_params[count - 1].field_mask |= UCP_EP_PARAM_FIELD_FLAGS;
+    ep_params[count - 1].flags       = UCP_EP_PARAMS_FLAGS_CLIENT_SERVER;
+
+    {
+        scoped_log_handler wrap_err(wrap_errors_logger);
+        status = ucp_ep_create_bulk(sender().worker(), count, &ep_params[0],
+                                    &eps[0]);
+    }
+    ucp_worker_release_address(receiver().worker(), address);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, status);
+
+    /* the matched endpoint is closed rather than destroyed, so it stays out
+     * of use as long as the peer may send to it */
+    ASSERT_EQ(num_eps + 1, ucs_list_length(&sender().worker()->all_eps));
+    ep = ucp_ep_from_ext_gen(ucs_list_tail(&sender().worker()->all_eps,
+                                           ucp_ep_ext_gen_t, ep_list));
+    EXPECT_FALSE(ep->flags & UCP_EP_FLAG_USED);
+    EXPECT_TRUE(ep->flags & UCP_EP_FLAG_CLOSED);
+
+    /* the peer still sends to this worker */
+    if (!(GetParam().variant & TEST_STREAM)) {
+        send_recv(receiver().ep(), sender().worker(), NULL, 8, 1);
+    }
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_1sided)
 
 class test_ucp_wireup_2sided : public test_ucp_wireup {
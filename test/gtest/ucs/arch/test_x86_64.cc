@@ -14,6 +14,7 @@ extern "C" {
 }
 
 #include <sys/mman.h>
+#include <algorithm>
 
 class test_arch : public ucs::test {
 protected:
@@ -24,8 +25,8 @@ protected:
         return ucs_memcpy_relaxed(dst, src, size);
     }
 
-    template <void* (C)(void*, const void*, size_t)>
-    double measure_memcpy_bandwidth(size_t size)
+    template <typename F>
+    double measure_memcpy_bandwidth(F func, size_t size, double duration = 0.5)
     {
         ucs_time_t start_time, end_time;
         void *src, *dst;
@@ -49,10 +50,10 @@ protected:
         iter = 0;
         start_time = ucs_get_time();
         do {
-            C(dst, src, size);
+            func(dst, src, size);
             end_time = ucs_get_time();
             ++iter;
-        } while (end_time < start_time + ucs_time_from_sec(0.5));
+        } while (end_time < start_time + ucs_time_from_sec(duration));
 
         result = size * iter / ucs_time_to_sec(end_time - start_time);
 
@@ -86,8 +87,8 @@ UCS_TEST_SKIP_COND_F(test_arch, memcpy, RUNNING_ON_VALGRIND || !ucs::perf_retry_
     for (size = 4096; size <= 256 * UCS_MBYTE; size *= 2) {
         secs = ucs_get_accurate_time();
         for (i = 0; ucs_get_accurate_time() - secs < timeout; i++) {
-            memcpy_bw       = measure_memcpy_bandwidth<memcpy>(size);
-            memcpy_relax_bw = measure_memcpy_bandwidth<memcpy_relaxed>(size);
+            memcpy_bw       = measure_memcpy_bandwidth(memcpy, size);
+            memcpy_relax_bw = measure_memcpy_bandwidth(memcpy_relaxed, size);
             if (memcpy_relax_bw / memcpy_bw >= diff) {
                 break;
             }
@@ -102,4 +103,67 @@ UCS_TEST_SKIP_COND_F(test_arch, memcpy, RUNNING_ON_VALGRIND || !ucs::perf_retry_
     }
 }
 
+UCS_TEST_F(test_arch, memcpy_kernels) {
+    const size_t max_size = 70000;
+    const size_t sizes[]  = {0, 1, 31, 32, 33, 63, 64, 65, 127, 128, 129, 255,
+                             256, 257, 1000, 4103, 65549};
+    std::vector<char> src(max_size + 64), dst(max_size + 64);
+
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = (char)ucs::rand();
+    }
+
+    for (int kernel = 0; kernel < UCS_X86_MEMCPY_LAST; ++kernel) {
+        ucs_x86_memcpy_kernel_t k = static_cast<ucs_x86_memcpy_kernel_t>(kernel);
+        ucs_x86_memcpy_func_t func = ucs_x86_memcpy_kernel_func(k);
+        if (func == NULL) {
+            UCS_TEST_MESSAGE << ucs_x86_memcpy_kernel_name(k)
+                             << " is not supported";
+            continue;
+        }
+
+        for (size_t i = 0; i < ucs_static_array_size(sizes); ++i) {
+            for (size_t src_offset = 0; src_offset < 3; ++src_offset) {
+                for (size_t dst_offset = 0; dst_offset < 3; ++dst_offset) {
+                    std::fill(dst.begin(), dst.end(), 0);
+                    func(&dst[dst_offset], &src[src_offset], sizes[i]);
+                    ASSERT_TRUE(std::equal(&src[src_offset],
+                                           &src[src_offset] + sizes[i],
+                                           &dst[dst_offset]))
+                        << ucs_x86_memcpy_kernel_name(k) << " size " << sizes[i]
+                        << " src_offset " << src_offset << " dst_offset "
+                        << dst_offset;
+                    /* must not write beyond the buffer */
+                    EXPECT_EQ(0, dst[dst_offset + sizes[i]]);
+                }
+            }
+        }
+    }
+}
+
+UCS_TEST_SKIP_COND_F(test_arch, memcpy_kernels_bw,
+                     RUNNING_ON_VALGRIND || !ucs::perf_retry_count) {
+    char memunits_str[256];
+
+    for (size_t size = 4096; size <= 64 * UCS_MBYTE; size *= 16) {
+        ucs_memunits_to_str(size, memunits_str, sizeof(memunits_str));
+        UCS_TEST_MESSAGE << memunits_str << ": selected "
+                         << ucs_x86_memcpy_kernel_name(
+                                    ucs_x86_memcpy_get_kernel(size));
+
+        for (int kernel = 0; kernel < UCS_X86_MEMCPY_LAST; ++kernel) {
+            ucs_x86_memcpy_kernel_t k =
+                    static_cast<ucs_x86_memcpy_kernel_t>(kernel);
+            ucs_x86_memcpy_func_t func = ucs_x86_memcpy_kernel_func(k);
+            if (func == NULL) {
+                continue;
+            }
+
+            double bw = measure_memcpy_bandwidth(func, size, 0.1);
+            UCS_TEST_MESSAGE << "    " << ucs_x86_memcpy_kernel_name(k) << ": "
+                             << (bw / UCS_GBYTE) << " GB/s";
+        }
+    }
+}
+
 #endif
@@ -0,0 +1,857 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+/*
+ * Microbenchmarks for UCS core data structures.
+ *
+ * Every benchmark builds a data structure of a given size, and measures the
+ * time of its hot-path operation from one or more threads. Every combination
+ * of benchmark, size and thread count is measured several times, and the
+ * statistics of the cost per operation are reported as a table or as JSON
+ * lines for scripts.
+ */
+
+extern "C" {
+#include <ucs/arch/atomic.h>
+#include <ucs/datastruct/arbiter.h>
+#include <ucs/datastruct/callbackq.h>
+#include <ucs/datastruct/frag_list.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/mpmc.h>
+#include <ucs/datastruct/mpool.inl>
+#include <ucs/datastruct/pgtable.h>
+#include <ucs/memory/rcache.h>
+#include <ucs/stats/stats.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/sys.h>
+#include <ucs/time/time.h>
+}
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <fnmatch.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/mman.h>
+#include <time.h>
+#include <vector>
+
+
+namespace ucs_bench {
+
+/* Number of pre-generated random indexes per thread */
+static const unsigned NUM_RANDOM = 4096;
+
+
+struct params {
+    size_t        size;    /* Size of the data structure */
+    unsigned      threads; /* Number of threads running the operation */
+    unsigned long iters;   /* Number of operations per thread */
+};
+
+
+/**
+ * Benchmark base class. init() builds the data structure, run() performs the
+ * measured operations from every thread, and cleanup() releases it all. A new
+ * object is created for every measurement.
+ */
+class bench {
+public:
+    virtual ~bench() {
+    }
+
+    virtual void init(const params &p) {
+        m_params = p;
+        m_random.resize(p.threads);
+        for (unsigned t = 0; t < p.threads; ++t) {
+            unsigned seed = t + 1; /* repeatable */
+            for (unsigned i = 0; i < NUM_RANDOM; ++i) {
+                m_random[t].push_back(rand_r(&seed) % p.size);
+            }
+        }
+    }
+
+    virtual void run(unsigned thread_index, unsigned long iters) = 0;
+
+    virtual void cleanup() {
+    }
+
+protected:
+    size_t random_index(unsigned thread_index, unsigned long i) const {
+        return m_random[thread_index][i % NUM_RANDOM];
+    }
+
+    params                            m_params;
+    std::vector<std::vector<size_t> > m_random;
+};
+
+
+/* Keeps the compiler from optimizing out the benchmarked operations */
+static volatile uintptr_t sink;
+
+
+/* Get and put elements from a memory pool, in batches. Pools are per-thread,
+ * since ucs_mpool_t is not thread-safe; size is the element size. */
+class bench_mpool : public bench {
+public:
+    static const unsigned BATCH = 16;
+
+    virtual void init(const params &p) {
+        static ucs_mpool_ops_t ops = {
+            ucs_mpool_chunk_malloc,
+            ucs_mpool_chunk_free,
+            NULL,
+            NULL
+        };
+
+        bench::init(p);
+        m_mps.resize(p.threads);
+        for (unsigned t = 0; t < p.threads; ++t) {
+            check(ucs_mpool_init(&m_mps[t], 0, p.size, 0, UCS_SYS_CACHE_LINE_SIZE,
+                                 256, UINT_MAX, &ops, "bench_mpool"));
+        }
+    }
+
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        ucs_mpool_t *mp = &m_mps[thread_index];
+        void *objs[BATCH];
+        unsigned long i;
+        unsigned j;
+
+        for (i = 0; i < iters; i += BATCH) {
+            for (j = 0; j < BATCH; ++j) {
+                objs[j] = ucs_mpool_get_inline(mp);
+            }
+            for (j = 0; j < BATCH; ++j) {
+                ucs_mpool_put_inline(objs[j]);
+            }
+        }
+    }
+
+    virtual void cleanup() {
+        for (size_t t = 0; t < m_mps.size(); ++t) {
+            ucs_mpool_cleanup(&m_mps[t], 1);
+        }
+    }
+
+private:
+    static void check(ucs_status_t status);
+
+    std::vector<ucs_mpool_t> m_mps;
+};
+
+
+/* Dispatch a callback queue with "size" registered callbacks */
+class bench_callbackq : public bench {
+public:
+    virtual void init(const params &p) {
+        bench::init(p);
+        ucs_callbackq_init(&m_cbq);
+        for (size_t i = 0; i < p.size; ++i) {
+            ucs_callbackq_add(&m_cbq, callback, this, UCS_CALLBACKQ_FLAG_FAST);
+        }
+    }
+
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        unsigned count = 0;
+
+        for (unsigned long i = 0; i < iters; ++i) {
+            count += ucs_callbackq_dispatch(&m_cbq);
+        }
+        sink = count;
+    }
+
+    virtual void cleanup() {
+        ucs_callbackq_remove_if(&m_cbq, remove_pred, NULL);
+        ucs_callbackq_cleanup(&m_cbq);
+    }
+
+private:
+    static unsigned callback(void *arg) {
+        return 1;
+    }
+
+    static int remove_pred(const ucs_callbackq_elem_t *elem, void *arg) {
+        return elem->cb == callback;
+    }
+
+    ucs_callbackq_t m_cbq;
+};
+
+
+/* Push an element to each of "size" arbiter groups, and dispatch them all */
+class bench_arbiter : public bench {
+public:
+    virtual void init(const params &p) {
+        bench::init(p);
+        ucs_arbiter_init(&m_arbiter);
+        m_groups.resize(p.size);
+        m_elems.resize(p.size);
+        for (size_t i = 0; i < p.size; ++i) {
+            ucs_arbiter_group_init(&m_groups[i]);
+            ucs_arbiter_elem_init(&m_elems[i]);
+        }
+    }
+
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        size_t i;
+
+        for (unsigned long n = 0; n < iters; n += m_params.size) {
+            for (i = 0; i < m_params.size; ++i) {
+                ucs_arbiter_group_push_elem(&m_groups[i], &m_elems[i]);
+                ucs_arbiter_group_schedule(&m_arbiter, &m_groups[i]);
+            }
+            ucs_arbiter_dispatch(&m_arbiter, 1, dispatch_cb, NULL);
+        }
+    }
+
+    virtual void cleanup() {
+        for (size_t i = 0; i < m_groups.size(); ++i) {
+            ucs_arbiter_group_cleanup(&m_groups[i]);
+        }
+        ucs_arbiter_cleanup(&m_arbiter);
+    }
+
+private:
+    static ucs_arbiter_cb_result_t
+    dispatch_cb(ucs_arbiter_t *arbiter, ucs_arbiter_group_t *group,
+                ucs_arbiter_elem_t *elem, void *arg) {
+        return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+    }
+
+    ucs_arbiter_t                    m_arbiter;
+    std::vector<ucs_arbiter_group_t> m_groups;
+    std::vector<ucs_arbiter_elem_t>  m_elems;
+};
+
+
+/* Page table with "size" regions */
+class bench_pgtable_base : public bench {
+public:
+    static const size_t REGION_SIZE = UCS_BIT(16);
+
+    virtual void init(const params &p) {
+        bench::init(p);
+        ucs_pgtable_init(&m_pgtable, pgd_alloc, pgd_release);
+        m_regions.resize(p.size);
+        for (size_t i = 0; i < p.size; ++i) {
+            /* spread the regions, leaving gaps between them */
+            m_regions[i].start = (i + 1) * 3 * REGION_SIZE;
+            m_regions[i].end   = m_regions[i].start + REGION_SIZE;
+        }
+    }
+
+    virtual void cleanup() {
+        ucs_pgtable_purge(&m_pgtable, purge_cb, NULL);
+        ucs_pgtable_cleanup(&m_pgtable);
+    }
+
+protected:
+    ucs_pgtable_t                 m_pgtable;
+    std::vector<ucs_pgt_region_t> m_regions;
+
+private:
+    static ucs_pgt_dir_t *pgd_alloc(const ucs_pgtable_t *pgtable) {
+        return new ucs_pgt_dir_t;
+    }
+
+    static void pgd_release(const ucs_pgtable_t *pgtable, ucs_pgt_dir_t *dir) {
+        delete dir;
+    }
+
+    static void purge_cb(const ucs_pgtable_t *pgtable, ucs_pgt_region_t *region,
+                         void *arg) {
+    }
+};
+
+
+/* Look up random addresses in a page table; lookups are read-only, so any
+ * number of threads may run them concurrently */
+class bench_pgtable_lookup : public bench_pgtable_base {
+public:
+    virtual void init(const params &p) {
+        bench_pgtable_base::init(p);
+        for (size_t i = 0; i < p.size; ++i) {
+            ucs_pgtable_insert(&m_pgtable, &m_regions[i]);
+        }
+    }
+
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        uintptr_t found = 0;
+        ucs_pgt_region_t *region;
+
+        for (unsigned long i = 0; i < iters; ++i) {
+            region = ucs_pgtable_lookup(&m_pgtable,
+                                        m_regions[random_index(thread_index, i)].start +
+                                        (i % REGION_SIZE));
+            found += (uintptr_t)region;
+        }
+        sink = found;
+    }
+};
+
+
+/* Insert and remove all regions of a page table */
+class bench_pgtable_insert : public bench_pgtable_base {
+public:
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        size_t i;
+
+        for (unsigned long n = 0; n < iters; n += m_params.size) {
+            for (i = 0; i < m_params.size; ++i) {
+                ucs_pgtable_insert(&m_pgtable, &m_regions[i]);
+            }
+            for (i = 0; i < m_params.size; ++i) {
+                ucs_pgtable_remove(&m_pgtable, &m_regions[i]);
+            }
+        }
+    }
+};
+
+
+/* Get and put cached regions of a registration cache holding "size" regions
+ * (the hit path) */
+class bench_rcache : public bench {
+public:
+    static const size_t REGION_SIZE = UCS_BIT(16);
+
+    virtual void init(const params &p) {
+        static const ucs_rcache_ops_t ops = {
+            mem_reg_cb,
+            mem_dereg_cb,
+            dump_region_cb
+        };
+        ucs_rcache_params_t rcache_params = {
+            sizeof(ucs_rcache_region_t),
+            UCS_PGT_ADDR_ALIGN,
+            ucs_get_page_size(),
+            0,
+            1000,
+            &ops,
+            NULL,
+            0
+        };
+        ucs_rcache_region_t *region;
+
+        bench::init(p);
+        m_length = p.size * REGION_SIZE * 2;
+        m_buffer = (char*)mmap(NULL, m_length, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (m_buffer == MAP_FAILED) {
+            fprintf(stderr, "mmap(%zu) failed: %m\n", m_length);
+            exit(1);
+        }
+
+        if (ucs_rcache_create(&rcache_params, "bench", ucs_stats_get_root(),
+                              &m_rcache) != UCS_OK) {
+            fprintf(stderr, "failed to create rcache\n");
+            exit(1);
+        }
+
+        /* populate the cache */
+        for (size_t i = 0; i < p.size; ++i) {
+            ucs_rcache_get(m_rcache, address(i), REGION_SIZE, PROT_READ, NULL,
+                           &region);
+            ucs_rcache_region_put(m_rcache, region);
+        }
+    }
+
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        ucs_rcache_region_t *region;
+
+        for (unsigned long i = 0; i < iters; ++i) {
+            ucs_rcache_get(m_rcache, address(random_index(thread_index, i)),
+                           REGION_SIZE, PROT_READ, NULL, &region);
+            ucs_rcache_region_put(m_rcache, region);
+        }
+    }
+
+    virtual void cleanup() {
+        ucs_rcache_destroy(m_rcache);
+        munmap(m_buffer, m_length);
+    }
+
+private:
+    void *address(size_t index) const {
+        /* leave a gap after every region, so they are not merged */
+        return m_buffer + (index * 2 * REGION_SIZE);
+    }
+
+    static ucs_status_t mem_reg_cb(void *context, ucs_rcache_t *rcache,
+                                   void *arg, ucs_rcache_region_t *region,
+                                   uint16_t flags) {
+        return UCS_OK;
+    }
+
+    static void mem_dereg_cb(void *context, ucs_rcache_t *rcache,
+                             ucs_rcache_region_t *region) {
+    }
+
+    static void dump_region_cb(void *context, ucs_rcache_t *rcache,
+                               ucs_rcache_region_t *region, char *buf,
+                               size_t max) {
+        *buf = '\0';
+    }
+
+    ucs_rcache_t *m_rcache;
+    char         *m_buffer;
+    size_t       m_length;
+};
+
+
+/* Insert windows of "size" out-of-order fragments, and pull them */
+class bench_frag_list : public bench {
+public:
+    virtual void init(const params &p) {
+        bench::init(p);
+        ucs_frag_list_init(0, &m_frags, -1 UCS_STATS_ARG(ucs_stats_get_root()));
+        m_elems.resize(p.size);
+        m_sn = 0;
+    }
+
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        uintptr_t count = 0;
+        size_t i;
+
+        for (unsigned long n = 0; n < iters; n += m_params.size) {
+            /* the first fragment of the window arrives last */
+            for (i = m_params.size; i > 0; --i) {
+                ucs_frag_list_insert(&m_frags, &m_elems[i - 1],
+                                     (ucs_frag_list_sn_t)(m_sn + i));
+            }
+            while (ucs_frag_list_pull(&m_frags) != NULL) {
+                ++count;
+            }
+            m_sn += m_params.size;
+        }
+        sink = count;
+    }
+
+    virtual void cleanup() {
+        ucs_frag_list_cleanup(&m_frags);
+    }
+
+private:
+    ucs_frag_list_t                   m_frags;
+    std::vector<ucs_frag_list_elem_t> m_elems;
+    ucs_frag_list_sn_t                m_sn;
+};
+
+
+/* Push and pull values through a queue of length "size", by all threads */
+class bench_mpmc : public bench {
+public:
+    virtual void init(const params &p) {
+        bench::init(p);
+        ucs_mpmc_queue_init(&m_mpmc, std::max<size_t>(p.size, p.threads));
+    }
+
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        uint64_t value;
+
+        for (unsigned long i = 0; i < iters; ++i) {
+            ucs_mpmc_queue_push(&m_mpmc, i & UCS_MASK(16));
+            /* there is at least one value in the queue - ours */
+            while (ucs_mpmc_queue_pull(&m_mpmc, &value) != UCS_OK);
+        }
+        sink = value;
+    }
+
+    virtual void cleanup() {
+        ucs_mpmc_queue_cleanup(&m_mpmc);
+    }
+
+private:
+    ucs_mpmc_queue_t m_mpmc;
+};
+
+
+KHASH_MAP_INIT_INT64(bench_map, uint64_t);
+
+
+/* Hash map with "size" keys */
+class bench_khash_base : public bench {
+public:
+    virtual void init(const params &p) {
+        bench::init(p);
+        kh_init_inplace(bench_map, &m_map);
+        for (size_t i = 0; i < p.size; ++i) {
+            insert(key(i));
+        }
+    }
+
+    virtual void cleanup() {
+        kh_destroy_inplace(bench_map, &m_map);
+    }
+
+protected:
+    static uint64_t key(size_t index) {
+        return index * 0x9e3779b97f4a7c15ul; /* spread the keys */
+    }
+
+    void insert(uint64_t key) {
+        int ret;
+        khiter_t iter = kh_put(bench_map, &m_map, key, &ret);
+        kh_value(&m_map, iter) = key;
+    }
+
+    khash_t(bench_map) m_map;
+};
+
+
+/* Look up random existing keys; lookups are read-only, so any number of
+ * threads may run them concurrently */
+class bench_khash_get : public bench_khash_base {
+public:
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        uint64_t sum = 0;
+        khiter_t iter;
+
+        for (unsigned long i = 0; i < iters; ++i) {
+            iter = kh_get(bench_map, &m_map,
+                          key(random_index(thread_index, i)));
+            sum += kh_value(&m_map, iter);
+        }
+        sink = sum;
+    }
+};
+
+
+/* Add and remove a key to a map of "size" keys */
+class bench_khash_put_del : public bench_khash_base {
+public:
+    virtual void run(unsigned thread_index, unsigned long iters) {
+        khiter_t iter;
+
+        for (unsigned long i = 0; i < iters; ++i) {
+            insert(key(m_params.size + (i % NUM_RANDOM)));
+            iter = kh_get(bench_map, &m_map,
+                          key(m_params.size + (i % NUM_RANDOM)));
+            kh_del(bench_map, &m_map, iter);
+        }
+    }
+};
+
+
+void bench_mpool::check(ucs_status_t status)
+{
+    if (status != UCS_OK) {
+        fprintf(stderr, "initialization failed: %s\n",
+                ucs_status_string(status));
+        exit(1);
+    }
+}
+
+
+template <typename T> bench *create() {
+    return new T;
+}
+
+
+struct bench_desc {
+    const char    *name;
+    const char    *desc;
+    bench*        (*create)();
+    bool          mt;       /* Supports multiple threads */
+    size_t        sizes[4]; /* Default sizes, 0-terminated */
+    unsigned long iters;    /* Default number of operations per thread */
+};
+
+
+static const bench_desc benchmarks[] = {
+    {"mpool", "memory pool get+put, size is element size",
+     create<bench_mpool>, true, {64, 1024, 8192}, 10000000},
+    {"callbackq", "callback queue dispatch, size is number of callbacks",
+     create<bench_callbackq>, false, {1, 4, 16}, 10000000},
+    {"arbiter", "arbiter push+dispatch, size is number of groups",
+     create<bench_arbiter>, false, {1, 16, 1024}, 10000000},
+    {"pgtable_lookup", "page table lookup, size is number of regions",
+     create<bench_pgtable_lookup>, true, {16, 1024, 65536}, 10000000},
+    {"pgtable_insert", "page table insert+remove, size is number of regions",
+     create<bench_pgtable_insert>, false, {16, 1024}, 1000000},
+    {"rcache", "registration cache get+put hit, size is number of regions",
+     create<bench_rcache>, true, {16, 1024}, 1000000},
+    {"frag_list", "fragment list insert+pull, size is reorder window",
+     create<bench_frag_list>, false, {1, 8, 64}, 10000000},
+    {"mpmc", "mpmc queue push+pull, size is queue length",
+     create<bench_mpmc>, true, {64, 1024}, 10000000},
+    {"khash_get", "hash map lookup, size is number of keys",
+     create<bench_khash_get>, true, {16, 1024, 65536}, 10000000},
+    {"khash_put_del", "hash map insert+remove, size is number of keys",
+     create<bench_khash_put_del>, false, {16, 1024, 65536}, 10000000},
+    {NULL}
+};
+
+
+struct thread_ctx {
+    bench             *b;
+    unsigned          index;
+    unsigned long     iters;
+    pthread_barrier_t *barrier;
+    ucs_time_t        start;
+    ucs_time_t        end;
+};
+
+
+static void *thread_func(void *arg)
+{
+    thread_ctx *ctx = (thread_ctx*)arg;
+
+    pthread_barrier_wait(ctx->barrier);
+    ctx->start = ucs_get_time();
+    ctx->b->run(ctx->index, ctx->iters);
+    ctx->end   = ucs_get_time();
+    return NULL;
+}
+
+
+/* Returns the elapsed time of a single measurement, in seconds */
+static double measure(const bench_desc *desc, const params &p)
+{
+    std::vector<thread_ctx> ctxs(p.threads);
+    std::vector<pthread_t> threads(p.threads);
+    pthread_barrier_t barrier;
+    ucs_time_t start, end;
+    bench *b;
+
+    b = desc->create();
+    b->init(p);
+
+    pthread_barrier_init(&barrier, NULL, p.threads);
+    for (unsigned t = 0; t < p.threads; ++t) {
+        ctxs[t].b       = b;
+        ctxs[t].index   = t;
+        ctxs[t].iters   = p.iters;
+        ctxs[t].barrier = &barrier;
+        if (t > 0) {
+            pthread_create(&threads[t], NULL, thread_func, &ctxs[t]);
+        }
+    }
+
+    thread_func(&ctxs[0]);
+
+    start = ctxs[0].start;
+    end   = ctxs[0].end;
+    for (unsigned t = 1; t < p.threads; ++t) {
+        pthread_join(threads[t], NULL);
+        start = std::min(start, ctxs[t].start);
+        end   = std::max(end, ctxs[t].end);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    b->cleanup();
+    delete b;
+
+    return ucs_time_to_sec(end - start);
+}
+
+
+struct options {
+    std::vector<std::string> patterns;
+    std::vector<size_t>      sizes;
+    std::vector<unsigned>    threads;
+    unsigned long            iters;
+    unsigned                 reps;
+    bool                     json;
+};
+
+
+static bool match(const options &opts, const char *name)
+{
+    if (opts.patterns.empty()) {
+        return true;
+    }
+
+    for (size_t i = 0; i < opts.patterns.size(); ++i) {
+        if (!fnmatch(opts.patterns[i].c_str(), name, 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+static void report(const options &opts, const bench_desc *desc,
+                   const params &p, std::vector<double> &ns_per_op)
+{
+    double mean, stddev, median, mops;
+    char timestamp[32];
+    struct tm tm;
+    time_t now;
+    size_t i;
+
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+    i      = ns_per_op.size() / 2;
+    median = (ns_per_op.size() % 2) ? ns_per_op[i] :
+             (ns_per_op[i - 1] + ns_per_op[i]) / 2;
+    mean   = 0;
+    for (i = 0; i < ns_per_op.size(); ++i) {
+        mean += ns_per_op[i];
+    }
+    mean  /= ns_per_op.size();
+    stddev = 0;
+    for (i = 0; i < ns_per_op.size(); ++i) {
+        stddev += (ns_per_op[i] - mean) * (ns_per_op[i] - mean);
+    }
+    stddev = (ns_per_op.size() > 1) ?
+             sqrt(stddev / (ns_per_op.size() - 1)) : 0;
+    /* total rate of all threads */
+    mops   = p.threads * 1000.0 / median;
+
+    if (opts.json) {
+        now = time(NULL);
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ",
+                 gmtime_r(&now, &tm));
+        printf("{\"name\":\"%s\",\"size\":%zu,\"threads\":%u,"
+               "\"iterations\":%lu,\"repetitions\":%zu,"
+               "\"ns_per_op\":{\"min\":%.3f,\"median\":%.3f,\"mean\":%.3f,"
+               "\"max\":%.3f,\"stddev\":%.3f},\"mops\":%.3f,"
+               "\"host\":\"%s\",\"timestamp\":\"%s\"}\n",
+               desc->name, p.size, p.threads, p.iters, ns_per_op.size(),
+               ns_per_op.front(), median, mean, ns_per_op.back(), stddev, mops,
+               ucs_get_host_name(), timestamp);
+    } else {
+        printf("%-16s %10zu %7u %10.3f %10.3f %10.3f %9.3f %10.3f\n",
+               desc->name, p.size, p.threads, ns_per_op.front(), median,
+               ns_per_op.back(), stddev, mops);
+    }
+    fflush(stdout);
+}
+
+
+static void run_bench(const options &opts, const bench_desc *desc)
+{
+    std::vector<size_t> sizes = opts.sizes;
+    std::vector<double> ns_per_op;
+    params p;
+
+    if (sizes.empty()) {
+        for (const size_t *size = desc->sizes; *size != 0; ++size) {
+            sizes.push_back(*size);
+        }
+    }
+
+    for (size_t s = 0; s < sizes.size(); ++s) {
+        for (size_t t = 0; t < opts.threads.size(); ++t) {
+            if ((opts.threads[t] > 1) && !desc->mt) {
+                continue;
+            }
+
+            p.size    = sizes[s];
+            p.threads = opts.threads[t];
+            p.iters   = opts.iters ? opts.iters : desc->iters;
+
+            /* warm-up */
+            measure(desc, p);
+
+            ns_per_op.clear();
+            for (unsigned r = 0; r < opts.reps; ++r) {
+                ns_per_op.push_back(measure(desc, p) * 1e9 / p.iters);
+            }
+            report(opts, desc, p, ns_per_op);
+        }
+    }
+}
+
+
+template <typename T>
+static void parse_list(const char *str, std::vector<T> &list)
+{
+    char *end;
+
+    list.clear();
+    do {
+        list.push_back(strtoul(str, &end, 0));
+        str = end + 1;
+    } while (*end == ',');
+}
+
+
+static void usage(const char *program)
+{
+    printf("Usage: %s [options]\n", program);
+    printf("  -b <pattern>[,...]  benchmarks to run, shell wildcards (all)\n");
+    printf("  -s <size>[,...]     data structure sizes (benchmark defaults)\n");
+    printf("  -t <count>[,...]    thread counts, single-threaded benchmarks\n"
+           "                      run only with 1 thread (1)\n");
+    printf("  -n <count>          operations per thread (benchmark default)\n");
+    printf("  -r <count>          repetitions of every measurement (5)\n");
+    printf("  -j                  print results as JSON, one object per line\n");
+    printf("  -l                  list benchmarks\n");
+    printf("  -h                  show this help message\n");
+}
+
+} // namespace ucs_bench
+
+
+using namespace ucs_bench;
+
+int main(int argc, char **argv)
+{
+    const bench_desc *desc;
+    options opts;
+    char *pattern;
+    int c;
+
+    opts.iters = 0;
+    opts.reps  = 5;
+    opts.json  = false;
+    opts.threads.push_back(1);
+
+    while ((c = getopt(argc, argv, "b:s:t:n:r:jlh")) != -1) {
+        switch (c) {
+        case 'b':
+            for (pattern = strtok(optarg, ","); pattern != NULL;
+                 pattern = strtok(NULL, ",")) {
+                opts.patterns.push_back(pattern);
+            }
+            break;
+        case 's':
+            parse_list(optarg, opts.sizes);
+            break;
+        case 't':
+            parse_list(optarg, opts.threads);
+            break;
+        case 'n':
+            opts.iters = strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            opts.reps = std::max(1ul, strtoul(optarg, NULL, 0));
+            break;
+        case 'j':
+            opts.json = true;
+            break;
+        case 'l':
+            for (desc = benchmarks; desc->name != NULL; ++desc) {
+                printf("%-16s %s%s\n", desc->name, desc->desc,
+                       desc->mt ? " (multi-threaded)" : "");
+            }
+            return 0;
+        case 'h':
+        default:
+            usage(argv[0]);
+            return (c == 'h') ? 0 : 1;
+        }
+    }
+
+    if (!opts.json) {
+        printf("%-16s %10s %7s %10s %10s %10s %9s %10s\n", "# benchmark",
+               "size", "threads", "min ns/op", "median", "max", "stddev",
+               "Mops/s");
+    }
+
+    for (desc = benchmarks; desc->name != NULL; ++desc) {
+        if (match(opts, desc->name)) {
+            run_bench(opts, desc);
+        }
+    }
+
+    return 0;
+}
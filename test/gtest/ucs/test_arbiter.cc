@@ -752,7 +752,7 @@ UCS_TEST_F(test_arbiter, result_stop) {
     for (int i = 0; i < N + 3; i++) {
        ucs_arbiter_dispatch(&m_arb1, 1, stop_cb, this);
        /* arbiter current position must not change on STOP */
-       EXPECT_EQ(m_arb1.list.next, &groups[0].tail->next->list);
+       EXPECT_EQ(m_arb1.list[UCS_ARBITER_PRIO_NORMAL].next, &groups[0].tail->next->list);
     }
 
     m_count = 0;
@@ -1077,3 +1077,177 @@ UCS_TEST_F(test_arbiter_random_resched, one_elem_many_groups) {
 UCS_TEST_F(test_arbiter_random_resched, many_elems_many_groups) {
     do_test_loop(42, 10, 4);
 }
+
+class test_arbiter_prio : public ucs::test {
+public:
+    virtual void init() {
+        ucs::test::init();
+        ucs_arbiter_init(&m_arb);
+        ucs_arbiter_group_init(&m_latency_group);
+        ucs_arbiter_elem_init(&m_latency_elem);
+        /* groups and elements are linked by pointers, so they must not be
+         * reallocated */
+        m_groups.reserve(MAX_GROUPS);
+        m_elems.reserve(MAX_ELEMS);
+        m_inject_at  = -1;
+        m_inject_pos = -1;
+    }
+
+    virtual void cleanup() {
+        for (size_t i = 0; i < m_groups.size(); ++i) {
+            ucs_arbiter_group_cleanup(&m_groups[i]);
+        }
+        ucs_arbiter_group_cleanup(&m_latency_group);
+        ucs_arbiter_cleanup(&m_arb);
+        ucs::test::cleanup();
+    }
+
+protected:
+    enum {
+        MAX_GROUPS = 64,
+        MAX_ELEMS  = 1024
+    };
+
+    struct prio_elem {
+        ucs_arbiter_elem_t elem;
+        ucs_arbiter_prio_t prio;
+    };
+
+    /* schedule "num_groups" groups of "num_elems" elements in class "prio" */
+    void add_groups(unsigned num_groups, unsigned num_elems,
+                    ucs_arbiter_prio_t prio)
+    {
+        size_t first_group = m_groups.size();
+        size_t first_elem  = m_elems.size();
+
+        ASSERT_LE(first_group + num_groups, (size_t)MAX_GROUPS);
+        ASSERT_LE(first_elem + (num_groups * num_elems), (size_t)MAX_ELEMS);
+        m_groups.resize(first_group + num_groups);
+        m_elems.resize(first_elem + (num_groups * num_elems));
+
+        for (unsigned i = 0; i < num_groups; ++i) {
+            ucs_arbiter_group_t *group = &m_groups[first_group + i];
+
+            ucs_arbiter_group_init(group);
+            for (unsigned j = 0; j < num_elems; ++j) {
+                prio_elem *e = &m_elems[first_elem + (i * num_elems) + j];
+                e->prio      = prio;
+                ucs_arbiter_elem_init(&e->elem);
+                ucs_arbiter_group_push_elem(group, &e->elem);
+            }
+            ucs_arbiter_group_schedule_prio(&m_arb, group, prio);
+        }
+    }
+
+    static ucs_arbiter_cb_result_t dispatch_cb(ucs_arbiter_t *arbiter,
+                                               ucs_arbiter_group_t *group,
+                                               ucs_arbiter_elem_t *elem,
+                                               void *arg)
+    {
+        test_arbiter_prio *self = reinterpret_cast<test_arbiter_prio*>(arg);
+
+        if (elem == &self->m_latency_elem) {
+            self->m_inject_pos = self->m_order.size();
+            return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+        }
+
+        self->m_order.push_back(ucs_container_of(elem, prio_elem, elem)->prio);
+
+        /* a small message is posted while the bulk transfer is in progress */
+        if (self->m_order.size() == (size_t)self->m_inject_at) {
+            ucs_arbiter_group_push_elem(&self->m_latency_group,
+                                        &self->m_latency_elem);
+            ucs_arbiter_group_schedule_prio(arbiter, &self->m_latency_group,
+                                            self->m_latency_prio);
+        }
+
+        return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+    }
+
+    /* @return how many bulk elements were dispatched after the small message
+     *         was posted and before it was dispatched */
+    int latency_under_load(ucs_arbiter_prio_t prio)
+    {
+        static const unsigned num_groups = 32;
+        static const unsigned num_elems  = 16;
+
+        m_latency_prio = prio;
+        m_inject_at    = num_groups * 2;
+        add_groups(num_groups, num_elems, UCS_ARBITER_PRIO_NORMAL);
+
+        ucs_arbiter_dispatch(&m_arb, 1, dispatch_cb, this);
+
+        EXPECT_TRUE(ucs_arbiter_is_empty(&m_arb));
+        EXPECT_EQ(num_groups * num_elems, m_order.size());
+        return m_inject_pos - m_inject_at;
+    }
+
+    ucs_arbiter_t                  m_arb;
+    std::vector<ucs_arbiter_group_t> m_groups;
+    std::vector<prio_elem>         m_elems;
+    std::vector<ucs_arbiter_prio_t> m_order;
+    ucs_arbiter_group_t            m_latency_group;
+    ucs_arbiter_elem_t             m_latency_elem;
+    ucs_arbiter_prio_t             m_latency_prio;
+    int                            m_inject_at;
+    int                            m_inject_pos;
+};
+
+UCS_TEST_F(test_arbiter_prio, latency_normal) {
+    /* waits for a dispatch round over all other bulk groups */
+    EXPECT_EQ(31, latency_under_load(UCS_ARBITER_PRIO_NORMAL));
+}
+
+UCS_TEST_F(test_arbiter_prio, latency_high) {
+    /* overtakes all bulk groups */
+    EXPECT_EQ(0, latency_under_load(UCS_ARBITER_PRIO_HIGH));
+}
+
+UCS_TEST_F(test_arbiter_prio, strict) {
+    static const unsigned num_elems = 8;
+
+    add_groups(10, num_elems, UCS_ARBITER_PRIO_NORMAL);
+    add_groups(3, num_elems, UCS_ARBITER_PRIO_HIGH);
+
+    /* more than one element per group, so groups are also put back on the
+     * arbiter by dispatch */
+    ucs_arbiter_dispatch(&m_arb, 2, dispatch_cb, this);
+
+    EXPECT_TRUE(ucs_arbiter_is_empty(&m_arb));
+    ASSERT_EQ(13 * num_elems, m_order.size());
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        EXPECT_EQ((i < (3 * num_elems)) ? UCS_ARBITER_PRIO_HIGH :
+                                          UCS_ARBITER_PRIO_NORMAL,
+                  m_order[i]) << "index " << i;
+    }
+}
+
+UCS_TEST_F(test_arbiter_prio, weighted) {
+    static const unsigned weight = 3;
+    unsigned high_left           = 4 * 8;
+    unsigned normal_left         = 6 * 8;
+    unsigned count               = 0;
+    std::vector<ucs_arbiter_prio_t> expected;
+
+    ucs_arbiter_set_weight(&m_arb, weight);
+    add_groups(6, 8, UCS_ARBITER_PRIO_NORMAL);
+    add_groups(4, 8, UCS_ARBITER_PRIO_HIGH);
+
+    ucs_arbiter_dispatch(&m_arb, 1, dispatch_cb, this);
+    EXPECT_TRUE(ucs_arbiter_is_empty(&m_arb));
+
+    /* "weight" high priority elements, then a normal priority one */
+    while ((high_left + normal_left) > 0) {
+        if ((high_left > 0) && ((normal_left == 0) || (count < weight))) {
+            expected.push_back(UCS_ARBITER_PRIO_HIGH);
+            --high_left;
+            ++count;
+        } else {
+            expected.push_back(UCS_ARBITER_PRIO_NORMAL);
+            --normal_left;
+            count = 0;
+        }
+    }
+
+    EXPECT_EQ(expected, m_order);
+}
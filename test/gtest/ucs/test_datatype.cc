@@ -10,6 +10,7 @@ extern "C" {
 #include <ucs/datastruct/array.inl>
 #include <ucs/datastruct/list.h>
 #include <ucs/datastruct/hlist.h>
+#include <ucs/datastruct/khash.h>
 #include <ucs/datastruct/ptr_array.h>
 #include <ucs/datastruct/ptr_map.inl>
 #include <ucs/datastruct/queue.h>
@@ -1059,3 +1060,136 @@ UCS_TEST_F(test_datatype, ptr_map) {
 
     ucs_ptr_map_destroy(&ptr_map);
 }
+
+UCS_TEST_F(test_datatype, ptr_map_stale_key) {
+    const size_t N = 100;
+    std::vector<ucs_ptr_map_key_t> keys, stale_keys;
+    ucs_ptr_map_key_t ptr_key;
+    ucs_ptr_map_t     ptr_map;
+    ucs_status_t      status;
+    std::vector<char> objs(N * 2);
+
+    status = ucs_ptr_map_init(&ptr_map);
+    ASSERT_EQ(UCS_OK, status);
+
+    for (size_t i = 0; i < N; ++i) {
+        status = ucs_ptr_map_put(&ptr_map, &objs[i * 2], 1, &ptr_key);
+        ASSERT_EQ(UCS_OK, status);
+        keys.push_back(ptr_key);
+    }
+
+    /* removed keys are not found, and a second removal fails */
+    for (size_t i = 0; i < N; i += 2) {
+        EXPECT_EQ(&objs[i * 2], ucs_ptr_map_extract(&ptr_map, keys[i]));
+        EXPECT_EQ(NULL, ucs_ptr_map_get(&ptr_map, keys[i]));
+        EXPECT_EQ(UCS_ERR_NO_ELEM, ucs_ptr_map_del(&ptr_map, keys[i]));
+        stale_keys.push_back(keys[i]);
+    }
+
+    /* new objects reuse the free slots with new keys, and the stale keys
+     * do not resolve to them */
+    for (size_t i = 0; i < N; i += 2) {
+        status = ucs_ptr_map_put(&ptr_map, &objs[i * 2], 1, &keys[i]);
+        ASSERT_EQ(UCS_OK, status);
+    }
+
+    EXPECT_EQ(N, ptr_map.length);
+    for (size_t i = 0; i < stale_keys.size(); ++i) {
+        EXPECT_EQ(NULL, ucs_ptr_map_get(&ptr_map, stale_keys[i]));
+    }
+
+    /* keys out of the table range */
+    EXPECT_EQ(NULL, ucs_ptr_map_get(&ptr_map,
+                                    (N << UCS_PTR_MAP_KEY_INDEX_SHIFT) |
+                                    UCS_PTR_MAP_KEY_INDIRECT_FLAG));
+
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(&objs[i * 2], ucs_ptr_map_get(&ptr_map, keys[i]));
+        EXPECT_EQ(UCS_OK, ucs_ptr_map_del(&ptr_map, keys[i]));
+    }
+
+    EXPECT_EQ(0u, ptr_map.count);
+    ucs_ptr_map_destroy(&ptr_map);
+}
+
+/* The hash table based implementation which ucs_ptr_map used before */
+KHASH_MAP_INIT_INT64(test_ptr_khash, void*);
+
+UCS_TEST_SKIP_COND_F(test_datatype, ptr_map_perf,
+                     (ucs::test_time_multiplier() > 1)) {
+    const size_t num_lookups = 4 * UCS_MBYTE;
+    const size_t counts[]    = { UCS_KBYTE, 16 * UCS_KBYTE, 128 * UCS_KBYTE,
+                                 UCS_MBYTE };
+
+    for (size_t c = 0; c < ucs_static_array_size(counts); ++c) {
+        const size_t count = counts[c];
+        std::vector<ucs_ptr_map_key_t> keys(count);
+        std::vector<size_t> order(num_lookups);
+        uint64_t next_id = 0;
+        ucs_ptr_map_t ptr_map;
+        khash_t(test_ptr_khash) khash;
+        uintptr_t sum = 0;
+        khiter_t iter;
+        int ret;
+
+        for (size_t i = 0; i < num_lookups; ++i) {
+            order[i] = ucs::rand() % count;
+        }
+
+        /* slot table */
+        ucs_ptr_map_init(&ptr_map);
+        ucs_time_t t0 = ucs_get_time();
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_UCS_OK(ucs_ptr_map_put(&ptr_map, &keys[i], 1, &keys[i]));
+        }
+        ucs_time_t t1 = ucs_get_time();
+        for (size_t i = 0; i < num_lookups; ++i) {
+            sum += (uintptr_t)ucs_ptr_map_get(&ptr_map, keys[order[i]]);
+        }
+        ucs_time_t t2 = ucs_get_time();
+        for (size_t i = 0; i < count; ++i) {
+            ucs_ptr_map_del(&ptr_map, keys[i]);
+        }
+        ucs_time_t t3 = ucs_get_time();
+        ucs_ptr_map_destroy(&ptr_map);
+
+        /* hash table */
+        kh_init_inplace(test_ptr_khash, &khash);
+        ucs_time_t t4 = ucs_get_time();
+        for (size_t i = 0; i < count; ++i) {
+            keys[i] = (next_id += UCS_PTR_MAP_KEY_MIN_ALIGN) |
+                      UCS_PTR_MAP_KEY_INDIRECT_FLAG;
+            iter    = kh_put(test_ptr_khash, &khash, keys[i], &ret);
+            kh_value(&khash, iter) = &keys[i];
+        }
+        ucs_time_t t5 = ucs_get_time();
+        for (size_t i = 0; i < num_lookups; ++i) {
+            iter = kh_get(test_ptr_khash, &khash, keys[order[i]]);
+            sum += (uintptr_t)kh_value(&khash, iter);
+        }
+        ucs_time_t t6 = ucs_get_time();
+        for (size_t i = 0; i < count; ++i) {
+            kh_del(test_ptr_khash, &khash,
+                   kh_get(test_ptr_khash, &khash, keys[i]));
+        }
+        ucs_time_t t7 = ucs_get_time();
+        kh_destroy_inplace(test_ptr_khash, &khash);
+
+        double slot_put_ns    = ucs_time_to_nsec(t1 - t0) / count;
+        double slot_get_ns    = ucs_time_to_nsec(t2 - t1) / num_lookups;
+        double slot_del_ns    = ucs_time_to_nsec(t3 - t2) / count;
+        double khash_put_ns   = ucs_time_to_nsec(t5 - t4) / count;
+        double khash_get_ns   = ucs_time_to_nsec(t6 - t5) / num_lookups;
+        double khash_del_ns   = ucs_time_to_nsec(t7 - t6) / count;
+
+        UCS_TEST_MESSAGE << count << " ids (nsec): slot put " << slot_put_ns
+                         << " get " << slot_get_ns << " del " << slot_del_ns
+                         << ", khash put " << khash_put_ns << " get "
+                         << khash_get_ns << " del " << khash_del_ns
+                         << " (" << (sum & 1) << ")";
+
+        if (ucs::perf_retry_count) {
+            EXPECT_LT(slot_get_ns, khash_get_ns);
+        }
+    }
+}
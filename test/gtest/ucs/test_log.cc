@@ -177,6 +177,10 @@ UCS_TEST_F(log_test_info, hello) {
     ucs_info("hello world");
 }
 
+UCS_TEST_F(log_test_info, hello_async, "LOG_ASYNC=y") {
+    ucs_info("hello world");
+}
+
 
 class log_test_print : public log_test {
     virtual void check_log_file() {
@@ -295,6 +299,98 @@ UCS_TEST_F(log_test_file_size, large_files, "LOG_FILE_SIZE=8k",
     test_log_file_max_size();
 }
 
+UCS_TEST_F(log_test_file_size, small_files_async, "LOG_FILE_SIZE=" +
+                                                  small_file_size,
+                                                  "LOG_FILE_ROTATE=4",
+                                                  "LOG_ASYNC=y") {
+    test_log_file_max_size();
+}
+
+UCS_TEST_F(log_test_file_size, large_files_async, "LOG_FILE_SIZE=8k",
+                                                  "LOG_FILE_ROTATE=4",
+                                                  "LOG_ASYNC=y") {
+    test_log_file_max_size();
+}
+
+
+class log_test_async : public log_test {
+protected:
+    static const int NUM_THREADS  = 8;
+    static const int NUM_MESSAGES = 2000;
+
+    static void *log_thread_func(void *arg) {
+        long thread_id = (long)arg;
+
+        for (int i = 0; i < NUM_MESSAGES; ++i) {
+            ucs_info("async message %ld %d", thread_id, i);
+        }
+        return NULL;
+    }
+
+    void count_messages(const std::string &log_file_name, void *arg) {
+        std::ifstream ifs(log_file_name.c_str());
+        std::string line;
+
+        while (std::getline(ifs, line)) {
+            size_t pos;
+            long thread_id;
+            int index;
+            unsigned long count;
+
+            if (((pos = line.find("async message ")) != std::string::npos) &&
+                (sscanf(line.c_str() + pos, "async message %ld %d", &thread_id,
+                        &index) == 2)) {
+                /* messages of every thread are written in order */
+                ASSERT_LT(thread_id, (long)NUM_THREADS);
+                EXPECT_GT(index, m_last_index[thread_id]);
+                m_last_index[thread_id] = index;
+                ++m_num_messages;
+            } else if (((pos = line.find("dropped ")) != std::string::npos) &&
+                       (sscanf(line.c_str() + pos, "dropped %lu log messages",
+                               &count) == 1)) {
+                m_num_dropped += count;
+            }
+        }
+    }
+
+    virtual void check_log_file() {
+        m_num_messages = 0;
+        m_num_dropped  = 0;
+        m_last_index.assign(NUM_THREADS, -1);
+        log_files_foreach(static_cast<log_file_foreach_cb>(
+                              &log_test_async::count_messages));
+
+        UCS_TEST_MESSAGE << "written: " << m_num_messages << ", dropped: "
+                         << m_num_dropped;
+        EXPECT_EQ(NUM_THREADS * NUM_MESSAGES, m_num_messages + m_num_dropped);
+    }
+
+    unsigned long    m_num_messages;
+    unsigned long    m_num_dropped;
+    std::vector<int> m_last_index;
+};
+
+UCS_TEST_F(log_test_async, multi_thread, "LOG_ASYNC=y",
+           "LOG_ASYNC_BUFFER=4k") {
+    std::vector<pthread_t> threads;
+
+    for (long i = 0; i < NUM_THREADS; ++i) {
+        pthread_t thread;
+        int ret = pthread_create(&thread, NULL, log_thread_func, (void*)i);
+        if (ret != 0) {
+            ADD_FAILURE() << "pthread_create failed: " << strerror(ret);
+            break;
+        }
+
+        threads.push_back(thread);
+    }
+
+    while (!threads.empty()) {
+        pthread_join(threads.back(), NULL);
+        threads.pop_back();
+    }
+}
+
 
 class log_test_backtrace : public log_test {
     virtual void check_log_file() {
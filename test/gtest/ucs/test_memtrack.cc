@@ -47,6 +47,48 @@ protected:
         EXPECT_EQ(peak_count, total.peak_count);
         EXPECT_EQ(peak_size,  total.peak_size);
     }
+
+    /* Read current and peak size of an allocation name from the dump */
+    bool dump_entry(const char *name, size_t *size, size_t *peak_size) {
+        std::string prefix = std::string(name) + ": size:";
+        bool found         = false;
+        char *buf, *line;
+        size_t buf_size;
+
+        FILE* tempf = open_memstream(&buf, &buf_size);
+        ucs_memtrack_dump(tempf);
+        fclose(tempf);
+
+        for (line = strtok(buf, "\n"); line != NULL;
+             line = strtok(NULL, "\n")) {
+            char *p = strstr(line, prefix.c_str());
+            if ((p != NULL) &&
+                (sscanf(p + prefix.length(), "%zu / %zu", size,
+                        peak_size) == 2)) {
+                found = true;
+                break;
+            }
+        }
+
+        free(buf);
+        return found;
+    }
+
+    static void *alloc_thread_func(void *arg) {
+        std::vector<void*> ptrs;
+
+        for (size_t i = 0; i < NUM_ALLOCS; ++i) {
+            ptrs.push_back(ucs_malloc(SAMPLED_SIZE, ALLOC_NAME));
+        }
+        while (!ptrs.empty()) {
+            ucs_free(ptrs.back());
+            ptrs.pop_back();
+        }
+        return NULL;
+    }
+
+    static const size_t NUM_ALLOCS   = 10000;
+    static const size_t SAMPLED_SIZE = 1000;
 };
 
 const char test_memtrack::ALLOC_NAME[] = "memtrack_test";
@@ -216,6 +258,56 @@ UCS_TEST_F(test_memtrack, mmap) {
     test_total(1, ALLOC_SIZE);
 }
 
+UCS_TEST_F(test_memtrack, sampled, "MEMTRACK_SAMPLE=4k") {
+    const double expected = NUM_ALLOCS * SAMPLED_SIZE;
+    std::vector<void*> ptrs;
+    size_t size, peak_size;
+
+    for (size_t i = 0; i < NUM_ALLOCS; ++i) {
+        ptrs.push_back(ucs_malloc(SAMPLED_SIZE, ALLOC_NAME));
+    }
+
+    /* the estimation error is expected to be around 2% */
+    ASSERT_TRUE(dump_entry(ALLOC_NAME, &size, &peak_size));
+    EXPECT_NEAR(expected, size, 0.1 * expected);
+
+    while (!ptrs.empty()) {
+        ucs_free(ptrs.back());
+        ptrs.pop_back();
+    }
+
+    ASSERT_TRUE(dump_entry(ALLOC_NAME, &size, &peak_size));
+    EXPECT_EQ(0ul, size);
+    EXPECT_NEAR(expected, peak_size, 0.1 * expected);
+}
+
+UCS_TEST_F(test_memtrack, sampled_mt, "MEMTRACK_SAMPLE=4k") {
+    const int num_threads = 4;
+    std::vector<pthread_t> threads;
+    size_t size, peak_size;
+
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_t thread;
+        int ret = pthread_create(&thread, NULL, alloc_thread_func, NULL);
+        if (ret != 0) {
+            ADD_FAILURE() << "pthread_create failed: " << strerror(ret);
+            break;
+        }
+
+        threads.push_back(thread);
+    }
+
+    while (!threads.empty()) {
+        pthread_join(threads.back(), NULL);
+        threads.pop_back();
+    }
+
+    ASSERT_TRUE(dump_entry(ALLOC_NAME, &size, &peak_size));
+    EXPECT_EQ(0ul, size);
+    EXPECT_GE(peak_size, NUM_ALLOCS * SAMPLED_SIZE / 2);
+    EXPECT_LE(peak_size, 2 * num_threads * NUM_ALLOCS * SAMPLED_SIZE);
+}
+
 UCS_TEST_F(test_memtrack, custom) {
     void *ptr, *initial_ptr;
 
@@ -6,6 +6,7 @@
 
 #include <common/test.h>
 extern "C" {
+#include <ucs/arch/atomic.h>
 #include <ucs/datastruct/mpool.h>
 }
 
@@ -203,3 +204,264 @@ UCS_TEST_F(test_mpool, infinite) {
 
     ucs_mpool_cleanup(&mp, 1);
 }
+
+class test_mpool_tcache : public test_mpool {
+protected:
+    static const unsigned NUM_OBJS   = 64;
+    static const unsigned CACHE_SIZE = 16;
+    static const unsigned NUM_THREADS = 4;
+
+    virtual void init() {
+        static ucs_mpool_ops_t ops = {
+           ucs_mpool_chunk_malloc,
+           ucs_mpool_chunk_free,
+           NULL,
+           NULL
+        };
+
+        test_mpool::init();
+
+        ucs_status_t status = ucs_mpool_init(&m_mp, 0, sizeof(uint64_t), 0,
+                                             sizeof(uint64_t), 32, UINT_MAX,
+                                             &ops, "test_tcache");
+        ASSERT_UCS_OK(status);
+
+        status = ucs_mpool_tcache_enable(&m_mp, CACHE_SIZE);
+        ASSERT_UCS_OK(status);
+
+        m_thread_counter = 0;
+    }
+
+    virtual void cleanup() {
+        ucs_mpool_cleanup(&m_mp, 1);
+        test_mpool::cleanup();
+    }
+
+    /* Get and put a batch of objects, and return the time it took */
+    ucs_time_t get_put_batch(ucs_mpool_t *mp, ucs_recursive_spinlock_t *lock,
+                             unsigned count)
+    {
+        void *objs[NUM_OBJS];
+
+        ucs_time_t start_time = ucs_get_time();
+        for (unsigned iter = 0; iter < count; ++iter) {
+            for (unsigned i = 0; i < NUM_OBJS; ++i) {
+                if (lock != NULL) {
+                    ucs_recursive_spin_lock(lock);
+                    objs[i] = ucs_mpool_get(mp);
+                    ucs_recursive_spin_unlock(lock);
+                } else {
+                    objs[i] = ucs_mpool_tcache_get(mp);
+                }
+            }
+
+            for (unsigned i = 0; i < NUM_OBJS; ++i) {
+                if (lock != NULL) {
+                    ucs_recursive_spin_lock(lock);
+                    ucs_mpool_put(objs[i]);
+                    ucs_recursive_spin_unlock(lock);
+                } else {
+                    ucs_mpool_tcache_put(objs[i]);
+                }
+            }
+        }
+
+        return ucs_get_time() - start_time;
+    }
+
+    ucs_mpool_t              m_mp;
+    volatile uint32_t        m_thread_counter;
+    std::vector<void*>       m_objs[NUM_THREADS];
+    ucs_mpool_t              m_locked_mp;
+    ucs_recursive_spinlock_t m_lock;
+};
+
+UCS_MT_TEST_F(test_mpool_tcache, get_put, 8) {
+    const unsigned num_iters = 10000 / ucs::test_time_multiplier();
+    uint64_t tag             = (uintptr_t)&tag;
+    std::vector<uint64_t*> objs;
+
+    for (unsigned iter = 0; iter < num_iters; ++iter) {
+        /* Exceed the thread cache size, to exercise refill and drain */
+        for (unsigned i = 0; i < NUM_OBJS; ++i) {
+            uint64_t *obj = (uint64_t*)ucs_mpool_tcache_get(&m_mp);
+            ASSERT_TRUE(obj != NULL);
+            *obj = tag + i;
+            objs.push_back(obj);
+        }
+
+        for (unsigned i = 0; i < NUM_OBJS; ++i) {
+            /* Another thread must not have got the same object */
+            ASSERT_EQ(tag + i, *objs[i]);
+            ucs_mpool_tcache_put(objs[i]);
+        }
+
+        objs.clear();
+    }
+}
+
+UCS_MT_TEST_F(test_mpool_tcache, put_other_thread, 4) {
+    const unsigned num_iters = 1000 / ucs::test_time_multiplier();
+    unsigned thread_index    = ucs_atomic_fadd32(&m_thread_counter, 1);
+
+    /* Every thread releases the objects allocated by the next thread */
+    for (unsigned iter = 0; iter < num_iters; ++iter) {
+        for (unsigned i = 0; i < NUM_OBJS; ++i) {
+            void *obj = ucs_mpool_tcache_get(&m_mp);
+            ASSERT_TRUE(obj != NULL);
+            m_objs[thread_index].push_back(obj);
+        }
+
+        barrier();
+
+        std::vector<void*> &other_objs =
+                m_objs[(thread_index + 1) % NUM_THREADS];
+        for (unsigned i = 0; i < other_objs.size(); ++i) {
+            ucs_mpool_tcache_put(other_objs[i]);
+        }
+        other_objs.clear();
+
+        barrier();
+    }
+}
+
+UCS_TEST_F(test_mpool_tcache, is_empty) {
+    ucs_mpool_ops_t ops = {
+       ucs_mpool_chunk_malloc,
+       ucs_mpool_chunk_free,
+       NULL,
+       NULL
+    };
+    std::vector<void*> objs;
+    ucs_mpool_t mp;
+
+    ucs_status_t status = ucs_mpool_init(&mp, 0, header_size + data_size,
+                                         header_size, align, 6, 18, &ops,
+                                         "test");
+    ASSERT_UCS_OK(status);
+
+    status = ucs_mpool_tcache_enable(&mp, 4);
+    ASSERT_UCS_OK(status);
+
+    for (unsigned i = 0; i < 18; ++i) {
+        void *obj = ucs_mpool_tcache_get(&mp);
+        ASSERT_TRUE(obj != NULL);
+        objs.push_back(obj);
+    }
+
+    EXPECT_TRUE(ucs_mpool_is_empty(&mp));
+    EXPECT_TRUE(NULL == ucs_mpool_tcache_get(&mp));
+
+    ucs_mpool_tcache_put(objs.back());
+    objs.pop_back();
+    EXPECT_FALSE(ucs_mpool_is_empty(&mp));
+
+    for (std::vector<void*>::iterator iter = objs.begin(); iter != objs.end();
+         ++iter) {
+        ucs_mpool_tcache_put(*iter);
+    }
+
+    ucs_mpool_cleanup(&mp, 1);
+}
+
+UCS_TEST_F(test_mpool_tcache, max_pools) {
+    ucs_mpool_ops_t ops = {
+       ucs_mpool_chunk_malloc,
+       ucs_mpool_chunk_free,
+       NULL,
+       NULL
+    };
+    std::vector<ucs_mpool_t> mps(UCS_MPOOL_TCACHE_MAX + 1);
+    unsigned num_enabled = 0;
+    ucs_status_t status;
+
+    /* The test fixture pool already uses one index */
+    for (unsigned i = 0; i < mps.size(); ++i) {
+        status = ucs_mpool_init(&mps[i], 0, sizeof(uint64_t), 0,
+                                sizeof(uint64_t), 8, UINT_MAX, &ops, "test");
+        ASSERT_UCS_OK(status);
+
+        status = ucs_mpool_tcache_enable(&mps[i], CACHE_SIZE);
+        if (status == UCS_OK) {
+            ++num_enabled;
+        } else {
+            EXPECT_EQ(UCS_ERR_EXCEEDS_LIMIT, status);
+        }
+
+        /* The pool is still usable without thread caches */
+        void *obj = ucs_mpool_tcache_get(&mps[i]);
+        ASSERT_TRUE(obj != NULL);
+        ucs_mpool_tcache_put(obj);
+    }
+
+    EXPECT_LT(num_enabled, (unsigned)UCS_MPOOL_TCACHE_MAX);
+
+    /* Index of a released pool can be reused, even though this thread still
+     * has a cache table entry from the released pool */
+    ucs_mpool_cleanup(&mps[0], 1);
+    status = ucs_mpool_init(&mps[0], 0, sizeof(uint64_t), 0, sizeof(uint64_t),
+                            8, UINT_MAX, &ops, "test");
+    ASSERT_UCS_OK(status);
+    ASSERT_UCS_OK(ucs_mpool_tcache_enable(&mps[0], CACHE_SIZE));
+
+    void *obj = ucs_mpool_tcache_get(&mps[0]);
+    ASSERT_TRUE(obj != NULL);
+    ucs_mpool_tcache_put(obj);
+
+    for (unsigned i = 0; i < mps.size(); ++i) {
+        ucs_mpool_cleanup(&mps[i], 1);
+    }
+}
+
+UCS_MT_TEST_F(test_mpool_tcache, perf_vs_lock, 4) {
+    /* Compare thread caches with a pool protected by a lock, like the pools
+     * of a multi-threaded UCP worker */
+    static const unsigned num_rounds = 3;
+    const unsigned count             = 20000 / ucs::test_time_multiplier();
+    ucs_time_t min_time_lock         = UCS_TIME_INFINITY;
+    ucs_time_t min_time_tcache       = UCS_TIME_INFINITY;
+
+    if (barrier()) {
+        ucs_mpool_ops_t ops = {
+           ucs_mpool_chunk_malloc,
+           ucs_mpool_chunk_free,
+           NULL,
+           NULL
+        };
+
+        ASSERT_UCS_OK(ucs_recursive_spinlock_init(&m_lock, 0));
+        ASSERT_UCS_OK(ucs_mpool_init(&m_locked_mp, 0, sizeof(uint64_t), 0,
+                                     sizeof(uint64_t), 32, UINT_MAX, &ops,
+                                     "test_locked"));
+    }
+    barrier();
+
+    for (unsigned round = 0; round < num_rounds; ++round) {
+        barrier();
+        ucs_time_t time_lock = get_put_batch(&m_locked_mp, &m_lock, count);
+        barrier();
+        ucs_time_t time_tcache = get_put_batch(&m_mp, NULL, count);
+
+        min_time_lock   = ucs_min(min_time_lock, time_lock);
+        min_time_tcache = ucs_min(min_time_tcache, time_tcache);
+    }
+
+    if (barrier()) {
+        double nsec_lock   = ucs_time_to_nsec(min_time_lock) /
+                             (count * NUM_OBJS);
+        double nsec_tcache = ucs_time_to_nsec(min_time_tcache) /
+                             (count * NUM_OBJS);
+        UCS_TEST_MESSAGE << num_threads() << " threads: " << nsec_lock
+                         << " nsec per get+put with a lock, " << nsec_tcache
+                         << " nsec with thread caches";
+
+        if (ucs::perf_retry_count && !RUNNING_ON_VALGRIND) {
+            EXPECT_LT(nsec_tcache, nsec_lock);
+        } else {
+            UCS_TEST_MESSAGE << "not validating performance";
+        }
+
+        ucs_mpool_cleanup(&m_locked_mp, 1);
+        ucs_recursive_spinlock_destroy(&m_lock);
+    }
+}
@@ -45,6 +45,84 @@ UCS_TEST_F(test_rcache_basic, create_fail) {
 }
 
 
+static ucs_status_t test_rcache_basic_mem_reg(void *context,
+                                              ucs_rcache_t *rcache, void *arg,
+                                              ucs_rcache_region_t *region,
+                                              uint16_t flags)
+{
+    return UCS_OK;
+}
+
+static void test_rcache_basic_mem_dereg(void *context, ucs_rcache_t *rcache,
+                                        ucs_rcache_region_t *region)
+{
+}
+
+static void test_rcache_basic_dump_region(void *context, ucs_rcache_t *rcache,
+                                          ucs_rcache_region_t *region,
+                                          char *buf, size_t max)
+{
+    buf[0] = '\0';
+}
+
+UCS_TEST_F(test_rcache_basic, max_caches) {
+    static const ucs_rcache_ops_t ops = {
+        test_rcache_basic_mem_reg,
+        test_rcache_basic_mem_dereg,
+        test_rcache_basic_dump_region
+    };
+    ucs_rcache_params_t params = {
+        sizeof(ucs_rcache_region_t),
+        UCS_PGT_ADDR_ALIGN,
+        ucs_get_page_size(),
+        UCM_EVENT_VM_UNMAPPED,
+        1000,
+        &ops,
+        NULL,
+        0
+    };
+    std::vector<ucs_rcache_t*> rcaches;
+    std::vector<char> buffer(ucs_get_page_size());
+    ucs_rcache_region_t *region;
+    ucs_rcache_t *rcache;
+    ucs_status_t status;
+    unsigned i;
+
+    /* caches above the thread table size are still created, and fall back
+     * to the locked lookup */
+    for (i = 0; i <= UCS_RCACHE_THREAD_TABLE_SIZE; ++i) {
+        status = ucs_rcache_create(&params, "test", ucs_stats_get_root(),
+                                   &rcache);
+        if (status == UCS_ERR_UNSUPPORTED) {
+            UCS_TEST_SKIP_R("memory events are not supported");
+        }
+        ASSERT_UCS_OK(status);
+        rcaches.push_back(rcache);
+    }
+
+    rcache = rcaches.back();
+    EXPECT_EQ(UCS_RCACHE_THREAD_INDEX_NONE, rcache->thread_index);
+    for (i = 0; i < 2; ++i) {
+        status = ucs_rcache_get(rcache, &buffer[0], buffer.size(),
+                                PROT_READ | PROT_WRITE, NULL, &region);
+        ASSERT_UCS_OK(status);
+        ucs_rcache_region_put(rcache, region);
+    }
+
+    /* a destroyed cache releases its index */
+    ASSERT_NE(UCS_RCACHE_THREAD_INDEX_NONE, rcaches.front()->thread_index);
+    ucs_rcache_destroy(rcaches.front());
+    status = ucs_rcache_create(&params, "test", ucs_stats_get_root(),
+                               &rcaches.front());
+    ASSERT_UCS_OK(status);
+    EXPECT_NE(UCS_RCACHE_THREAD_INDEX_NONE, rcaches.front()->thread_index);
+
+    for (i = 0; i < rcaches.size(); ++i) {
+        ucs_rcache_destroy(rcaches[i]);
+    }
+}
+
+
 class test_rcache : public ucs::test {
 protected:
 
@@ -542,6 +620,108 @@ UCS_MT_TEST_F(test_rcache, shared_region, 6) {
     shared_free(mem);
 }
 
+UCS_MT_TEST_F(test_rcache, get_invalidate_mt, 6) {
+    /*
+     * One thread keeps remapping the buffer while the others get and put
+     * regions of it. After the last remap, no thread may get a region which
+     * was registered before it.
+     */
+    static const size_t size = 16 * ucs_get_page_size();
+    const int count          = 1000 / ucs::test_time_multiplier();
+    region *region;
+    uint32_t id;
+
+    bool invalidator = barrier();
+    if (invalidator) {
+        m_ptr = alloc_pages(size, PROT_READ|PROT_WRITE);
+    }
+    barrier();
+
+    char *mem = (char*)m_ptr;
+    for (int i = 0; i < count; ++i) {
+        if (invalidator) {
+            void *ptr = mmap(mem, size, PROT_READ|PROT_WRITE,
+                             MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED, -1, 0);
+            EXPECT_EQ((void*)mem, ptr) << strerror(errno);
+        } else {
+            size_t offset = ucs::rand() % (size - ucs_get_page_size());
+            region = get(mem + offset, ucs_get_page_size());
+            EXPECT_LE(region->super.super.start, (uintptr_t)(mem + offset));
+            EXPECT_GE(region->super.super.end,
+                      (uintptr_t)(mem + offset + ucs_get_page_size()));
+            put(region);
+        }
+    }
+
+    region = get(mem, size);
+    id     = region->id;
+    put(region);
+
+    barrier();
+    if (invalidator) {
+        mmap(mem, size, PROT_READ|PROT_WRITE,
+             MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED, -1, 0);
+    }
+    barrier();
+
+    region = get(mem, size);
+    EXPECT_NE(id, region->id);
+    put(region);
+
+    barrier();
+    if (invalidator) {
+        munmap(mem, size);
+    }
+}
+
+UCS_MT_TEST_F(test_rcache, get_hit_perf, 4) {
+    /* All threads get and put regions of the same hot buffers */
+    static const size_t size     = 1 * 1024 * 1024;
+    static const unsigned nbufs  = 4;
+    const size_t count           = 1000000 / ucs::test_time_multiplier();
+    region *regions[nbufs];
+
+    if (barrier()) {
+        m_ptr = alloc_pages(size * nbufs, PROT_READ|PROT_WRITE);
+    }
+    barrier();
+
+    /* Page-aligned buffers, so adjacent regions are not merged */
+    char *mem = (char*)m_ptr;
+    for (unsigned i = 0; i < nbufs; ++i) {
+        regions[i] = get(mem + (i * size), size);
+    }
+
+    barrier();
+    ucs_time_t start_time = ucs_get_time();
+    for (size_t i = 0; i < count; ++i) {
+        unsigned index = i % nbufs;
+        region *region = get(mem + (index * size), size);
+        if (region != regions[index]) {
+            ADD_FAILURE() << "got a new region for a cached buffer";
+            put(region);
+            break;
+        }
+        put(region);
+    }
+    if (barrier()) {
+        double lat = ucs_time_to_nsec(ucs_get_time() - start_time) / count;
+        UCS_TEST_MESSAGE << num_threads() << " threads: " << lat
+                         << " nsec per get+put";
+    }
+
+    EXPECT_EQ(nbufs, m_reg_count);
+    barrier();
+
+    for (unsigned i = 0; i < nbufs; ++i) {
+        put(regions[i]);
+    }
+
+    if (barrier()) {
+        munmap(mem, size * nbufs);
+    }
+}
+
 class test_rcache_no_register : public test_rcache {
 protected:
     bool m_fail_reg;
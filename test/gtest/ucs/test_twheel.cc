@@ -220,6 +220,25 @@ UCS_TEST_SKIP_COND_F(twheel, add_overflow, true) {
 #endif
 }
 
+UCS_TEST_F(twheel, is_expired) {
+    struct hr_timer t;
+    ucs_time_t now;
+
+    EXPECT_FALSE(ucs_twheel_is_expired(&m_wheel, ucs_get_time()));
+
+    init_timer(&t, 0);
+    t.d = 4 * m_wheel.res;
+    add_timer(&t);
+
+    now = ucs_twheel_get_time(&m_wheel);
+    EXPECT_FALSE(ucs_twheel_is_expired(&m_wheel, now + m_wheel.res));
+    EXPECT_TRUE(ucs_twheel_is_expired(&m_wheel, now + 8 * m_wheel.res));
+
+    ucs_twheel_sweep(&m_wheel, now + 8 * m_wheel.res);
+    EXPECT_NE((ucs_time_t)0, t.end_time);
+    EXPECT_FALSE(ucs_twheel_is_expired(&m_wheel, now + 16 * m_wheel.res));
+}
+
 UCS_TEST_F(twheel, delayed_sweep) {
     std::vector<struct hr_timer> t(N_TIMERS);
 
@@ -5,6 +5,7 @@
 
 #include <common/test.h>
 #include <uct/uct_test.h>
+#include <uct/test_p2p_rma.h>
 
 extern "C" {
 #include <uct/api/uct.h>
@@ -255,3 +256,226 @@ UCS_TEST_P(test_uct_tcp, listener_flood_connect_and_close) {
 }
 
 _UCT_INSTANTIATE_TEST_CASE(test_uct_tcp, tcp)
+
+
+class test_uct_tcp_io_uring : public test_uct_tcp {
+public:
+    static const uint8_t AM_ID = 1;
+
+    void init() {
+        modify_config("IO_URING", "try");
+        test_uct_tcp::init();
+        if (m_tcp_iface->uring == NULL) {
+            UCS_TEST_SKIP_R("io_uring is not supported");
+        }
+    }
+
+    typedef struct {
+        uint32_t ep_index;
+        uint32_t sn;
+        size_t   length;
+    } am_hdr_t;
+
+    static size_t am_pack(void *dest, void *arg) {
+        const am_hdr_t *hdr = reinterpret_cast<const am_hdr_t*>(arg);
+
+        memcpy(dest, hdr, sizeof(*hdr));
+        memset(UCS_PTR_BYTE_OFFSET(dest, sizeof(*hdr)), hdr->sn & 0xff,
+               hdr->length - sizeof(*hdr));
+        return hdr->length;
+    }
+
+    static ucs_status_t am_handler(void *arg, void *data, size_t length,
+                                   unsigned flags) {
+        test_uct_tcp_io_uring *self = reinterpret_cast<test_uct_tcp_io_uring*>(arg);
+        const am_hdr_t *hdr         = reinterpret_cast<const am_hdr_t*>(data);
+        const uint8_t *payload      = reinterpret_cast<const uint8_t*>(hdr + 1);
+
+        /* messages of every endpoint arrive in order and intact */
+        EXPECT_EQ(hdr->length, length);
+        EXPECT_LT(hdr->ep_index, self->m_expected_sn.size());
+        if (hdr->ep_index < self->m_expected_sn.size()) {
+            EXPECT_EQ(self->m_expected_sn[hdr->ep_index]++, hdr->sn);
+        }
+        for (size_t i = 0; i < (length - sizeof(*hdr)); ++i) {
+            if (payload[i] != (hdr->sn & 0xff)) {
+                ADD_FAILURE() << "wrong payload at offset " << i;
+                break;
+            }
+        }
+
+        ++self->m_num_recvs;
+        return UCS_OK;
+    }
+
+protected:
+    std::vector<uint32_t> m_expected_sn;
+    volatile size_t       m_num_recvs;
+};
+
+UCS_TEST_P(test_uct_tcp_io_uring, am_bcopy_many_eps) {
+    const unsigned num_eps  = 8;
+    const unsigned count    = 200 / ucs::test_time_multiplier();
+    entity *receiver        = uct_test::create_entity(0);
+    std::vector<uint32_t> sn(num_eps, 0);
+    unsigned num_sent       = 0;
+    am_hdr_t hdr;
+    ssize_t packed_len;
+    unsigned i;
+
+    m_entities.push_back(receiver);
+    m_expected_sn.resize(num_eps, 0);
+    m_num_recvs = 0;
+    ASSERT_UCS_OK(uct_iface_set_am_handler(receiver->iface(), AM_ID,
+                                           am_handler, this, 0));
+
+    /* the payload of AM Short can't be sent by the ring after return */
+    EXPECT_EQ(UCS_MEMUNITS_INF, m_tcp_iface->config.sendv_thresh);
+
+    for (i = 0; i < num_eps; ++i) {
+        m_ent->connect(i, *receiver, i);
+    }
+
+    /* every endpoint posts its message between progress calls, so the sends
+     * of all endpoints are submitted together */
+    while (num_sent < (num_eps * count)) {
+        for (i = 0; i < num_eps; ++i) {
+            if (sn[i] == count) {
+                continue;
+            }
+
+            hdr.ep_index = i;
+            hdr.sn       = sn[i];
+            hdr.length   = sizeof(hdr) + ((sn[i] * 997) %
+                                          (m_ent->iface_attr().cap.am.max_bcopy -
+                                           sizeof(hdr)));
+            packed_len   = uct_ep_am_bcopy(m_ent->ep(i), AM_ID, am_pack,
+                                           &hdr, 0);
+            if (packed_len == UCS_ERR_NO_RESOURCE) {
+                continue;
+            }
+
+            ASSERT_EQ((ssize_t)hdr.length, packed_len);
+            ++sn[i];
+            ++num_sent;
+        }
+
+        progress();
+    }
+
+    wait_for_value(&m_num_recvs, (size_t)(num_eps * count), true);
+    EXPECT_EQ(num_eps * count, m_num_recvs);
+    for (i = 0; i < num_eps; ++i) {
+        EXPECT_EQ(count, m_expected_sn[i]) << "ep " << i;
+    }
+
+    flush();
+}
+
+UCS_TEST_P(test_uct_tcp_io_uring, listener_flood_connect_and_send_large) {
+    const size_t max_conn =
+        ucs_min(static_cast<size_t>(max_connections()), 128lu) /
+        ucs::test_time_multiplier();
+    const size_t msg_size = m_tcp_iface->config.rx_seg_size * 4;
+    test_listener_flood(*m_ent, max_conn, msg_size);
+}
+
+UCS_TEST_P(test_uct_tcp_io_uring, listener_flood_connect_and_close) {
+    const size_t max_conn =
+        ucs_min(static_cast<size_t>(max_connections()), 128lu) /
+        ucs::test_time_multiplier();
+    test_listener_flood(*m_ent, max_conn, 0);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_tcp_io_uring, tcp)
+
+
+class test_uct_tcp_stripes : public uct_p2p_rma_test {
+public:
+    void init() {
+        modify_config("STRIPES", ucs::to_string(num_stripes()));
+        modify_config("STRIPE_THRESH", "1kb");
+        uct_p2p_rma_test::init();
+    }
+
+    static unsigned num_stripes() {
+        return 4;
+    }
+
+    static uct_tcp_ep_stripe_t *ep_stripe(uct_ep_h tl_ep) {
+        uct_tcp_ep_t *ep       = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+        uct_tcp_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_tcp_iface_t);
+        khiter_t iter;
+
+        iter = kh_get(uct_tcp_ep_stripes, &iface->ep_stripes, (uintptr_t)ep);
+        EXPECT_EQ(!!(ep->flags & UCT_TCP_EP_FLAG_STRIPE),
+                  iter != kh_end(&iface->ep_stripes));
+        return (iter != kh_end(&iface->ep_stripes)) ?
+               kh_val(&iface->ep_stripes, iter) : NULL;
+    }
+
+    unsigned num_connected_stripe_eps() {
+        uct_tcp_ep_stripe_t *stripe = ep_stripe(sender_ep());
+        unsigned count              = 0;
+
+        if ((stripe == NULL) || !stripe->eps_created) {
+            return 0;
+        }
+
+        for (unsigned i = 0; i < (num_stripes() - 1); ++i) {
+            if ((stripe->eps[i] != NULL) &&
+                (stripe->eps[i]->conn_state ==
+                 UCT_TCP_EP_CONN_STATE_CONNECTED)) {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_uct_tcp_stripes, put_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY)) {
+    /* the first striped PUT establishes the additional connections */
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                    1ul, 4 * UCS_MBYTE, TEST_UCT_FLAG_SEND_ZCOPY);
+    EXPECT_EQ(num_stripes() - 1, num_connected_stripe_eps());
+
+    /* the next ones are split between the connections */
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                    UCS_KBYTE, 4 * UCS_MBYTE, TEST_UCT_FLAG_SEND_ZCOPY);
+}
+
+UCS_TEST_P(test_uct_tcp_stripes, old_peer) {
+    entity &sender   = *m_entities.front();
+    entity &receiver = *m_entities.back();
+    std::vector<char> iface_addr(receiver.iface_attr().iface_addr_len);
+    uct_tcp_device_addr_t dev_addr;
+    uct_ep_params_t ep_params;
+    uct_ep_h ep;
+
+    ASSERT_EQ(sizeof(dev_addr), receiver.iface_attr().device_addr_len);
+    ASSERT_UCS_OK(uct_iface_get_device_address(receiver.iface(),
+                                               (uct_device_addr_t*)&dev_addr));
+    ASSERT_UCS_OK(uct_iface_get_address(receiver.iface(),
+                                        (uct_iface_addr_t*)&iface_addr[0]));
+    EXPECT_TRUE(dev_addr.flags & UCT_TCP_DEVICE_ADDR_FLAG_STRIPES);
+
+    /* a peer which doesn't advertise the capability can't accept auxiliary
+     * connections, so striping must not be used for it. Older peers pack
+     * struct sockaddr_in, which has zero flags */
+    dev_addr.flags = 0;
+
+    ep_params.field_mask = UCT_EP_PARAM_FIELD_IFACE    |
+                           UCT_EP_PARAM_FIELD_DEV_ADDR |
+                           UCT_EP_PARAM_FIELD_IFACE_ADDR;
+    ep_params.iface      = sender.iface();
+    ep_params.dev_addr   = (uct_device_addr_t*)&dev_addr;
+    ep_params.iface_addr = (uct_iface_addr_t*)&iface_addr[0];
+    ASSERT_UCS_OK(uct_ep_create(&ep_params, &ep));
+
+    EXPECT_TRUE(ep_stripe(ep) == NULL);
+    uct_ep_destroy(ep);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_tcp_stripes, tcp)
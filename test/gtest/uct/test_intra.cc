@@ -0,0 +1,244 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+extern "C" {
+#include <uct/api/uct.h>
+#include <uct/sm/intra/intra.h>
+#include <ucs/time/time.h>
+}
+#include <common/test.h>
+#include "uct_test.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+
+class test_uct_intra : public uct_test {
+public:
+    static const uint8_t AM_ID = 5;
+
+    test_uct_intra() : m_receiver(NULL), m_num_recvs(0) {
+    }
+
+    virtual void init() {
+        uct_test::init();
+
+        m_receiver = uct_test::create_entity(0);
+        m_entities.push_back(m_receiver);
+
+        check_skip_test();
+    }
+
+    entity *create_sender() {
+        entity *sender = uct_test::create_entity(0);
+
+        m_entities.push_back(sender);
+        sender->connect(0, *m_receiver, 0);
+        return sender;
+    }
+
+    static uct_intra_fifo_t *ep_fifo(uct_ep_h ep) {
+        return ucs_derived_of(ep, uct_intra_ep_t)->fifo;
+    }
+
+    void set_am_handler() {
+        ucs_status_t status = uct_iface_set_am_handler(m_receiver->iface(),
+                                                       AM_ID, am_handler,
+                                                       this, 0);
+        ASSERT_UCS_OK(status);
+    }
+
+    static ucs_status_t am_handler(void *arg, void *data, size_t length,
+                                   unsigned flags) {
+        test_uct_intra *self = reinterpret_cast<test_uct_intra*>(arg);
+        uint64_t header      = *(uint64_t*)data;
+        unsigned sender      = header >> 32;
+        uint32_t sn          = header & UINT32_MAX;
+
+        /* messages of every sender arrive in the order they were sent */
+        EXPECT_LT(sender, self->m_expected_sn.size());
+        if (sender < self->m_expected_sn.size()) {
+            EXPECT_EQ(self->m_expected_sn[sender]++, sn) << "sender " << sender;
+        }
+        ++self->m_num_recvs;
+        return UCS_OK;
+    }
+
+protected:
+    struct producer {
+        pthread_t     thread;
+        uct_ep_h      ep;
+        unsigned      index;
+        unsigned      count;
+        unsigned      num_no_res;
+        bool          failed;
+        volatile bool *stop;
+    };
+
+    static void *producer_run(void *arg) {
+        producer *p = reinterpret_cast<producer*>(arg);
+        uint64_t header;
+        ucs_status_t status;
+        unsigned sn;
+
+        for (sn = 0; sn < p->count; ++sn) {
+            header = ((uint64_t)p->index << 32) | sn;
+            while ((status = uct_ep_am_short(p->ep, AM_ID, header, NULL,
+                                             0)) == UCS_ERR_NO_RESOURCE) {
+                if (*p->stop) {
+                    p->failed = true;
+                    return NULL;
+                }
+
+                ++p->num_no_res;
+                sched_yield();
+            }
+
+            if (status != UCS_OK) {
+                p->failed = true;
+                break;
+            }
+        }
+
+        return NULL;
+    }
+
+    entity                *m_receiver;
+    std::vector<uint32_t> m_expected_sn;
+    volatile size_t       m_num_recvs;
+};
+
+UCS_TEST_P(test_uct_intra, fifo_close_refcount) {
+    entity *sender = create_sender();
+    uct_intra_iface_addr_t iface_addr;
+    uct_intra_device_addr_t dev_addr;
+    uct_ep_params_t ep_params;
+    uct_intra_fifo_t *fifo;
+    ucs_status_t status;
+    uct_ep_h ep;
+
+    /* the FIFO is held by the receiver interface and by every endpoint */
+    fifo = ep_fifo(sender->ep(0));
+    EXPECT_EQ(2u, fifo->refcount);
+    sender->connect(1, *m_receiver, 0);
+    EXPECT_EQ(fifo, ep_fifo(sender->ep(1)));
+    EXPECT_EQ(3u, fifo->refcount);
+    sender->destroy_ep(1);
+    EXPECT_EQ(2u, fifo->refcount);
+
+    ASSERT_UCS_OK(uct_iface_get_device_address(m_receiver->iface(),
+                                               (uct_device_addr_t*)&dev_addr));
+    ASSERT_UCS_OK(uct_iface_get_address(m_receiver->iface(),
+                                        (uct_iface_addr_t*)&iface_addr));
+
+    /* closing the receiver keeps the FIFO of the connected endpoint alive */
+    m_entities.remove(m_receiver);
+    m_receiver = NULL;
+    EXPECT_EQ(1u, fifo->refcount);
+    EXPECT_TRUE(fifo->head & UCT_INTRA_FIFO_HEAD_CLOSED);
+
+    /* sending to a closed FIFO fails, instead of dropping the data */
+    status = uct_ep_am_short(sender->ep(0), AM_ID, 0, NULL, 0);
+    EXPECT_EQ(UCS_ERR_CONNECTION_RESET, status);
+    EXPECT_EQ((ssize_t)UCS_ERR_CONNECTION_RESET,
+              uct_ep_am_bcopy(sender->ep(0), AM_ID,
+                              (uct_pack_callback_t)ucs_empty_function_return_zero_int64,
+                              NULL, 0));
+
+    /* the closed interface cannot be connected anymore */
+    ep_params.field_mask = UCT_EP_PARAM_FIELD_IFACE    |
+                           UCT_EP_PARAM_FIELD_DEV_ADDR |
+                           UCT_EP_PARAM_FIELD_IFACE_ADDR;
+    ep_params.iface      = sender->iface();
+    ep_params.dev_addr   = (const uct_device_addr_t*)&dev_addr;
+    ep_params.iface_addr = (const uct_iface_addr_t*)&iface_addr;
+    {
+        scoped_log_handler wrap_err(wrap_errors_logger);
+        status = uct_ep_create(&ep_params, &ep);
+    }
+    EXPECT_EQ(UCS_ERR_UNREACHABLE, status);
+
+    /* the last endpoint releases the FIFO */
+    sender->destroy_ep(0);
+}
+
+UCS_TEST_P(test_uct_intra, multi_producer) {
+    static const unsigned num_producers = 4;
+    const unsigned count                = 2000 / ucs::test_time_multiplier();
+    std::vector<producer> producers(num_producers);
+    volatile bool stop                  = false;
+    ucs_time_t deadline;
+    unsigned i, num_no_res;
+
+    m_expected_sn.resize(num_producers, 0);
+    set_am_handler();
+
+    for (i = 0; i < num_producers; ++i) {
+        producers[i].ep         = create_sender()->ep(0);
+        producers[i].index      = i;
+        producers[i].count      = count;
+        producers[i].num_no_res = 0;
+        producers[i].failed     = false;
+        producers[i].stop       = &stop;
+    }
+
+    for (i = 0; i < num_producers; ++i) {
+        pthread_create(&producers[i].thread, NULL, producer_run, &producers[i]);
+    }
+
+    /* the receiver drains the FIFO while all producers write to it */
+    deadline = ucs_get_time() + ucs_time_from_sec(60.0 *
+                                                  ucs::test_time_multiplier());
+    while ((m_num_recvs < (num_producers * count)) &&
+           (ucs_get_time() < deadline)) {
+        if (m_receiver->progress() == 0) {
+            sched_yield();
+        }
+    }
+
+    /* don't let the producers wait for a receiver which gave up */
+    stop       = true;
+    num_no_res = 0;
+    for (i = 0; i < num_producers; ++i) {
+        pthread_join(producers[i].thread, NULL);
+        EXPECT_FALSE(producers[i].failed) << "producer " << i;
+        num_no_res += producers[i].num_no_res;
+    }
+
+    EXPECT_EQ(num_producers * count, m_num_recvs);
+    for (i = 0; i < num_producers; ++i) {
+        EXPECT_EQ(count, m_expected_sn[i]) << "producer " << i;
+    }
+
+    UCS_TEST_MESSAGE << num_producers * count << " messages, " << num_no_res
+                     << " times the FIFO was full";
+}
+
+UCS_TEST_P(test_uct_intra, rma_invalid_rkey) {
+    entity *sender  = create_sender();
+    uct_ep_h ep     = sender->ep(0);
+    uint64_t target = 0;
+    uint64_t value  = 0x1122334455667788ul;
+    uint64_t result = 0;
+
+    /* the rkey of the dummy memory domain is empty, so a peer may not unpack
+     * it, and RMA must use the remote address as-is */
+    ASSERT_UCS_OK(uct_ep_put_short(ep, &value, sizeof(value),
+                                   (uintptr_t)&target, UCT_INVALID_RKEY));
+    EXPECT_EQ(value, target);
+
+    ASSERT_UCS_OK(uct_ep_atomic64_post(ep, UCT_ATOMIC_OP_ADD, 1,
+                                       (uintptr_t)&target, UCT_INVALID_RKEY));
+    EXPECT_EQ(value + 1, target);
+
+    ASSERT_UCS_OK(uct_ep_atomic_cswap64(ep, value + 1, value,
+                                        (uintptr_t)&target, UCT_INVALID_RKEY,
+                                        &result, NULL));
+    EXPECT_EQ(value + 1, result);
+    EXPECT_EQ(value, target);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_intra, intra)
@@ -7,8 +7,11 @@
 extern "C" {
 #include <uct/api/uct.h>
 #include <uct/sm/mm/base/mm_md.h>
+#include <uct/sm/mm/base/mm_iface.h>
+#include <uct/sm/mm/base/mm_ep.h>
 #include <ucs/time/time.h>
 }
+#include <sys/mman.h>
 #include "uct_p2p_test.h"
 #include <common/test.h>
 #include "uct_test.h"
@@ -180,6 +183,25 @@ public:
         uct_rkey_release(GetParam()->component, &rkey_ob);
     }
 
+    ucs_status_t send_am_zcopy(void *buffer, size_t length,
+                               uct_completion_t *comp) {
+        uint64_t test_mm_hdr = 0xbeef;
+        uct_iov_t iov;
+
+        iov.buffer = buffer;
+        iov.length = length;
+        iov.memh   = UCT_MEM_HANDLE_NULL;
+        iov.stride = 0;
+        iov.count  = 1;
+
+        comp->func   = (uct_completion_callback_t)ucs_empty_function;
+        comp->count  = 1;
+        comp->status = UCS_OK;
+
+        return uct_ep_am_zcopy(m_e1->ep(0), 0, &test_mm_hdr,
+                               sizeof(test_mm_hdr), &iov, 1, 0, comp);
+    }
+
     void test_memh(void *ptr, uct_mem_h memh, size_t size) {
         test_attach(ptr, memh, size);
         test_attach(ptr, memh, size);
@@ -268,6 +290,260 @@ UCS_TEST_SKIP_COND_P(test_uct_mm, reg,
     ASSERT_UCS_OK(status);
 }
 
+UCS_TEST_SKIP_COND_P(test_uct_mm, am_zcopy_pull,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY | UCT_IFACE_FLAG_CB_SYNC))
+{
+    size_t length        = ucs_min(64 * UCS_KBYTE,
+                                   m_e1->iface_attr().cap.am.max_zcopy);
+    uint64_t test_mm_hdr = 0xbeef;
+    std::vector<uint8_t> sendbuf(length);
+    uct_completion_t comp;
+    recv_desc_t *recv_buffer;
+    ucs_status_t status;
+    uct_iov_t iov;
+
+    for (size_t i = 0; i < length; ++i) {
+        sendbuf[i] = i * 7;
+    }
+
+    recv_buffer = (recv_desc_t*)malloc(sizeof(*recv_buffer) + length);
+    recv_buffer->length = 0;
+    uct_iface_set_am_handler(m_e2->iface(), 0, mm_am_handler, recv_buffer, 0);
+
+    iov.buffer = &sendbuf[0];
+    iov.length = length;
+    iov.memh   = UCT_MEM_HANDLE_NULL;
+    iov.stride = 0;
+    iov.count  = 1;
+
+    comp.func   = (uct_completion_callback_t)ucs_empty_function;
+    comp.count  = 1;
+    comp.status = UCS_OK;
+
+    status = uct_ep_am_zcopy(m_e1->ep(0), 0, &test_mm_hdr, sizeof(test_mm_hdr),
+                             &iov, 1, 0, &comp);
+    ASSERT_EQ(UCS_INPROGRESS, status);
+
+    /* the send buffer is in use until the receiver pulls the payload */
+    for (int i = 0; i < 100; ++i) {
+        m_e1->progress();
+    }
+    EXPECT_EQ(1, comp.count);
+
+    wait_for_flag(&recv_buffer->length);
+    ASSERT_EQ(length, recv_buffer->length);
+    EXPECT_EQ(0, memcmp(&sendbuf[0], recv_buffer + 1, length));
+
+    wait_for_value(&comp.count, 0, true);
+    EXPECT_EQ(0, comp.count);
+    EXPECT_UCS_OK(comp.status);
+
+    free(recv_buffer);
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, am_zcopy_no_pull,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY | UCT_IFACE_FLAG_CB_SYNC))
+{
+    size_t length = m_e1->iface_attr().cap.am.max_zcopy;
+    std::vector<uint8_t> sendbuf(length);
+    uct_completion_t comp;
+    recv_desc_t *recv_buffer;
+    ucs_status_t status;
+
+    /* a peer in another PID namespace can't pull, so the payload is copied to
+     * the receive descriptors of several FIFO elements */
+    ucs_derived_of(m_e1->ep(0), uct_mm_ep_t)->pull.max = 0;
+    ASSERT_GT(length, m_e1->iface_attr().cap.am.max_bcopy);
+
+    recv_buffer = (recv_desc_t*)malloc(sizeof(*recv_buffer) + length);
+    uct_iface_set_am_handler(m_e2->iface(), 0, mm_am_handler, recv_buffer, 0);
+
+    /* send enough messages to wrap around the FIFO */
+    for (unsigned iter = 0; iter < 8; ++iter) {
+        size_t send_length = length - (iter * 1000);
+
+        for (size_t i = 0; i < send_length; ++i) {
+            sendbuf[i] = i * 7 + iter;
+        }
+
+        recv_buffer->length = 0;
+        do {
+            status = send_am_zcopy(&sendbuf[0], send_length, &comp);
+            progress();
+        } while (status == UCS_ERR_NO_RESOURCE);
+        ASSERT_UCS_OK(status);
+
+        /* the payload was copied, so the send buffer can be reused */
+        EXPECT_EQ(1, comp.count);
+        wait_for_flag(&recv_buffer->length);
+        ASSERT_EQ(send_length, recv_buffer->length);
+        EXPECT_EQ(0, memcmp(&sendbuf[0], recv_buffer + 1, send_length));
+    }
+
+    free(recv_buffer);
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, am_zcopy_pull_failed,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY | UCT_IFACE_FLAG_CB_SYNC))
+{
+    size_t length = ucs_min(ucs_get_page_size(),
+                            m_e1->iface_attr().cap.am.max_zcopy);
+    std::vector<uint8_t> sendbuf(length);
+    recv_desc_t *recv_buffer;
+    uct_completion_t comp;
+    ucs_status_t status;
+    void *bad_buffer;
+
+    if (ucs_derived_of(m_e1->ep(0), uct_mm_ep_t)->pull.max < length) {
+        UCS_TEST_SKIP_R("the peer can't pull");
+    }
+
+    recv_buffer = (recv_desc_t*)malloc(sizeof(*recv_buffer) + length);
+    recv_buffer->length = 0;
+    uct_iface_set_am_handler(m_e2->iface(), 0, mm_am_handler, recv_buffer, 0);
+
+    /* the receiver fails to read an inaccessible buffer */
+    bad_buffer = mmap(NULL, length, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1, 0);
+    ASSERT_NE(MAP_FAILED, bad_buffer);
+
+    status = send_am_zcopy(bad_buffer, length, &comp);
+    ASSERT_EQ(UCS_INPROGRESS, status);
+
+    {
+        scoped_log_handler wrap_err(wrap_errors_logger);
+        wait_for_value(&comp.count, 0, true);
+    }
+
+    /* the failure is reported to the sender, and the message is not delivered */
+    EXPECT_EQ(0, comp.count);
+    EXPECT_EQ(UCS_ERR_IO_ERROR, comp.status);
+    EXPECT_EQ(0u, recv_buffer->length);
+    munmap(bad_buffer, length);
+
+    /* the following messages are delivered */
+    for (size_t i = 0; i < length; ++i) {
+        sendbuf[i] = i * 3;
+    }
+
+    status = send_am_zcopy(&sendbuf[0], length, &comp);
+    ASSERT_EQ(UCS_INPROGRESS, status);
+
+    wait_for_flag(&recv_buffer->length);
+    ASSERT_EQ(length, recv_buffer->length);
+    EXPECT_EQ(0, memcmp(&sendbuf[0], recv_buffer + 1, length));
+
+    wait_for_value(&comp.count, 0, true);
+    EXPECT_UCS_OK(comp.status);
+
+    free(recv_buffer);
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, am_zcopy_pull_event,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC) ||
+                     !check_event_caps(UCT_IFACE_FLAG_EVENT_SEND_COMP |
+                                       UCT_IFACE_FLAG_EVENT_FD))
+{
+    size_t length = ucs_min(64 * UCS_KBYTE,
+                            m_e1->iface_attr().cap.am.max_zcopy);
+    std::vector<uint8_t> sendbuf(length);
+    recv_desc_t *recv_buffer;
+    uct_completion_t comp;
+    ucs_status_t status;
+
+    if (ucs_derived_of(m_e1->ep(0), uct_mm_ep_t)->pull.max < length) {
+        UCS_TEST_SKIP_R("the peer can't pull");
+    }
+
+    recv_buffer = (recv_desc_t*)malloc(sizeof(*recv_buffer) + length);
+    recv_buffer->length = 0;
+    uct_iface_set_am_handler(m_e2->iface(), 0, mm_am_handler, recv_buffer, 0);
+
+    EXPECT_UCS_OK(uct_iface_event_arm(m_e1->iface(), UCT_EVENT_SEND_COMP));
+
+    status = send_am_zcopy(&sendbuf[0], length, &comp);
+    ASSERT_EQ(UCS_INPROGRESS, status);
+
+    /* the receiver doesn't signal the sender when it pulls the payload, so the
+     * sender can't wait for the completion and has to keep progressing */
+    EXPECT_EQ(UCS_ERR_BUSY,
+              uct_iface_event_arm(m_e1->iface(), UCT_EVENT_SEND_COMP));
+
+    /* progress only the receiver, which pulls the payload */
+    ucs_time_t deadline = ucs_get_time() + ucs_time_from_sec(DEFAULT_TIMEOUT_SEC);
+    while ((recv_buffer->length == 0) && (ucs_get_time() < deadline)) {
+        m_e2->progress();
+    }
+    ASSERT_EQ(length, recv_buffer->length);
+    EXPECT_EQ(1, comp.count);
+    EXPECT_EQ(UCS_ERR_BUSY,
+              uct_iface_event_arm(m_e1->iface(), UCT_EVENT_SEND_COMP));
+
+    /* progressing the sender completes the operation */
+    while (comp.count != 0) {
+        EXPECT_EQ(UCS_ERR_BUSY,
+                  uct_iface_event_arm(m_e1->iface(), UCT_EVENT_SEND_COMP));
+        m_e1->progress();
+    }
+
+    EXPECT_UCS_OK(comp.status);
+    EXPECT_UCS_OK(uct_iface_event_arm(m_e1->iface(), UCT_EVENT_SEND_COMP));
+
+    free(recv_buffer);
+}
+
+UCS_TEST_P(test_uct_mm, numa_policy_default)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(m_e2->iface(), uct_mm_iface_t);
+
+    /* receive memory prefers the receiver's NUMA node unless overridden */
+    EXPECT_EQ(UCS_NUMA_POLICY_PREFERRED, iface->config.numa_policy);
+}
+
+UCS_TEST_P(test_uct_mm, numa_policy_none, "NUMA_POLICY=default")
+{
+    uct_mm_iface_t *iface = ucs_derived_of(m_e2->iface(), uct_mm_iface_t);
+
+    EXPECT_EQ(UCS_NUMA_POLICY_DEFAULT, iface->config.numa_policy);
+}
+
+UCS_TEST_P(test_uct_mm, fifo_numa_node)
+{
+#if HAVE_NUMA
+    uct_mm_iface_t *iface = ucs_derived_of(m_e2->iface(), uct_mm_iface_t);
+    int node              = -1;
+    int mode              = -1;
+    int ret;
+
+    if (numa_available() < 0) {
+        UCS_TEST_SKIP_R("NUMA is not available");
+    }
+
+    EXPECT_EQ(UCS_NUMA_POLICY_PREFERRED, iface->config.numa_policy);
+
+    /* the FIFO control and the receive descriptors are touched during the
+     * interface initialization, so their pages must be already allocated on
+     * the selected NUMA node */
+    ret = get_mempolicy(&node, NULL, 0, iface->recv_fifo_ctl,
+                        MPOL_F_NODE | MPOL_F_ADDR);
+    ASSERT_EQ(0, ret) << strerror(errno);
+    EXPECT_EQ(iface->config.numa_node, node);
+
+    ret = get_mempolicy(&node, NULL, 0, iface->last_recv_desc,
+                        MPOL_F_NODE | MPOL_F_ADDR);
+    ASSERT_EQ(0, ret) << strerror(errno);
+    EXPECT_EQ(iface->config.numa_node, node);
+
+    /* the thread policy is restored after the initialization */
+    ret = get_mempolicy(&mode, NULL, 0, NULL, 0);
+    ASSERT_EQ(0, ret) << strerror(errno);
+    EXPECT_EQ(MPOL_DEFAULT, mode);
+#else
+    UCS_TEST_SKIP_R("NUMA support is not compiled in");
+#endif
+}
+
 _UCT_INSTANTIATE_TEST_CASE(test_uct_mm, posix)
 _UCT_INSTANTIATE_TEST_CASE(test_uct_mm, sysv)
 _UCT_INSTANTIATE_TEST_CASE(test_uct_mm, xpmem)
@@ -46,6 +46,8 @@ public:
         uint64_t          data;
         int               countdown;  /* Actually send after X calls */
         int               send_count; /* Used by fairness test */
+        int               order;      /* Used by priority tests */
+        ucs_time_t        dispatch_time; /* Used by priority wait test */
         bool              pending;
         bool              delete_me;
     } pending_send_request_t;
@@ -207,6 +209,20 @@ public:
         return status;
     }
 
+    static ucs_status_t pending_send_op_ordered(uct_pending_req_t *self) {
+        pending_send_request_t *req = ucs_container_of(self,
+                                                       pending_send_request_t,
+                                                       uct);
+        ucs_status_t status         = pending_send_op(self);
+
+        if (status == UCS_OK) {
+            req->order         = n_dispatched++;
+            req->dispatch_time = ucs_get_time();
+        }
+
+        return status;
+    }
+
     static ucs_status_t pending_send_op_add_pending(uct_pending_req_t *self) {
         ucs_status_t status = pending_send_op(self);
         if (status == UCS_ERR_NO_RESOURCE) {
@@ -245,6 +261,8 @@ public:
         req->uct.func               = cb;
         req->delete_me              = delete_me;
         req->send_count             = 0;
+        req->order                  = -1;
+        req->dispatch_time          = 0;
 
         return req;
     }
@@ -253,6 +271,95 @@ public:
         delete req;
     }
 
+    pending_send_request_t *pending_add_ordered(unsigned ep_idx,
+                                                uint64_t send_data,
+                                                unsigned flags) {
+        pending_send_request_t *req = pending_alloc(send_data, ep_idx, 0, false,
+                                                    pending_send_op_ordered);
+        ucs_status_t status         = uct_ep_pending_add(m_e1->ep(ep_idx),
+                                                         &req->uct, flags);
+
+        EXPECT_UCS_OK(status);
+        req->pending = true;
+        ++n_pending;
+        return req;
+    }
+
+    typedef struct {
+        double   wait_usec;      /* Average time a control message waited */
+        unsigned min_ep_ahead;   /* Fewest bulk messages of the same endpoint
+                                    sent before a control message */
+        unsigned max_ep_ahead;   /* Most bulk messages of the same endpoint
+                                    sent before a control message */
+        unsigned max_all_ahead;  /* Most bulk messages of all endpoints sent
+                                    before a control message */
+    } control_wait_t;
+
+    /* Queue bulk traffic on every endpoint followed by one control message,
+     * added with the given pending flags, and measure how long the control
+     * messages wait behind the bulk traffic */
+    void measure_control_wait(unsigned num_eps, unsigned num_bulk,
+                              unsigned flags, uint64_t *send_data,
+                              control_wait_t *result) {
+        std::vector<pending_send_request_t*> bulk, ctrl;
+        unsigned ep_idx, ep_ahead, all_ahead;
+        ucs_time_t start_time, loop_end_limit;
+        size_t i, j;
+
+        /* fill the resources, so the next requests of every endpoint are
+         * queued */
+        for (ep_idx = 0; ep_idx < num_eps; ++ep_idx) {
+            send_ams_and_add_pending(send_data, PENDING_HDR, true, false,
+                                     ep_idx);
+        }
+
+        n_dispatched = 0;
+        for (ep_idx = 0; ep_idx < num_eps; ++ep_idx) {
+            for (i = 0; i < num_bulk; ++i) {
+                bulk.push_back(pending_add_ordered(ep_idx, (*send_data)++, 0));
+            }
+            ctrl.push_back(pending_add_ordered(ep_idx, (*send_data)++, flags));
+        }
+
+        start_time     = ucs_get_time();
+        loop_end_limit = ucs::get_deadline();
+        while ((n_pending > 0) && (ucs_get_time() < loop_end_limit)) {
+            progress();
+        }
+        ASSERT_EQ(0, n_pending);
+
+        result->wait_usec     = 0;
+        result->min_ep_ahead  = UINT_MAX;
+        result->max_ep_ahead  = 0;
+        result->max_all_ahead = 0;
+        for (i = 0; i < ctrl.size(); ++i) {
+            ep_ahead  = 0;
+            all_ahead = 0;
+            for (j = 0; j < bulk.size(); ++j) {
+                if (bulk[j]->order < ctrl[i]->order) {
+                    ++all_ahead;
+                    ep_ahead += (bulk[j]->ep == ctrl[i]->ep);
+                }
+            }
+
+            result->wait_usec    += ucs_time_to_usec(ctrl[i]->dispatch_time -
+                                                     start_time);
+            result->min_ep_ahead  = ucs_min(result->min_ep_ahead, ep_ahead);
+            result->max_ep_ahead  = ucs_max(result->max_ep_ahead, ep_ahead);
+            result->max_all_ahead = ucs_max(result->max_all_ahead, all_ahead);
+        }
+        result->wait_usec /= ctrl.size();
+
+        for (i = 0; i < bulk.size(); ++i) {
+            pending_delete(bulk[i]);
+        }
+        for (i = 0; i < ctrl.size(); ++i) {
+            pending_delete(ctrl[i]);
+        }
+
+        flush();
+    }
+
 protected:
     static const uint64_t AM_HDR;
     static const uint64_t PENDING_HDR;
@@ -261,11 +368,13 @@ protected:
     entity *m_e1, *m_e2;
     static int n_pending;
     static int n_purge;
+    static int n_dispatched;
     static bool pend_received;
 };
 
 int test_uct_pending::n_pending              = 0;
 int test_uct_pending::n_purge                = 0;
+int test_uct_pending::n_dispatched           = 0;
 bool test_uct_pending::pend_received         = false;
 const uint64_t test_uct_pending::AM_HDR      = 0x0ul;
 const uint64_t test_uct_pending::PENDING_HDR = 0x1ul;
@@ -650,4 +759,103 @@ UCS_TEST_SKIP_COND_P(test_uct_pending, send_ooo_with_comp,
     flush();
 }
 
+/*
+ * test that a high priority pending request overtakes the normal priority
+ * requests which were added before it
+ */
+UCS_TEST_SKIP_COND_P(test_uct_pending, pending_prio,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_PENDING) ||
+                     !(has_mm() || has_transport("intra") ||
+                       has_transport("tcp")))
+{
+    const int num_normal = 8;
+    uint64_t send_data   = 0xdeadbeef;
+    std::vector<pending_send_request_t*> reqs;
+    pending_send_request_t *req;
+    ucs_status_t status;
+
+    initialize();
+    install_handler_sync_or_async(m_e2->iface(), AM_ID, am_handler_simple, 0);
+
+    /* fill the resources, so the next requests are queued */
+    send_ams_and_add_pending(&send_data);
+
+    n_dispatched = 0;
+    for (int i = 0; i <= num_normal; ++i) {
+        req = pending_alloc(send_data++, 0, 0, false, pending_send_op_ordered);
+        status = uct_ep_pending_add(m_e1->ep(0), &req->uct,
+                                    (i == num_normal) ?
+                                    UCT_PENDING_FLAG_PRIO_HIGH : 0);
+        ASSERT_UCS_OK(status);
+        req->pending = true;
+        ++n_pending;
+        reqs.push_back(req);
+    }
+
+    ucs_time_t loop_end_limit = ucs::get_deadline();
+    while ((n_pending > 0) && (ucs_get_time() < loop_end_limit)) {
+        progress();
+    }
+    EXPECT_EQ(0, n_pending);
+
+    /* the high priority request is dispatched first, the rest in order */
+    EXPECT_EQ(0, reqs[num_normal]->order);
+    for (int i = 0; i < num_normal; ++i) {
+        EXPECT_EQ(i + 1, reqs[i]->order) << "request " << i;
+    }
+
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        pending_delete(reqs[i]);
+    }
+
+    flush();
+}
+
+/*
+ * test that high priority control messages don't wait behind the bulk traffic
+ * queued on several endpoints, while normal priority ones do
+ */
+UCS_TEST_SKIP_COND_P(test_uct_pending, pending_prio_wait,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_PENDING) ||
+                     !(has_mm() || has_transport("intra") ||
+                       has_transport("tcp")))
+{
+    const unsigned num_eps  = 4;
+    const unsigned num_bulk = RUNNING_ON_VALGRIND ? 16 : 256;
+    uint64_t send_data      = 0xdeadbeef;
+    control_wait_t normal, prio;
+
+    install_handler_sync_or_async(m_e2->iface(), AM_ID, am_handler_simple, 0);
+    for (unsigned i = 0; i < num_eps; ++i) {
+        m_e1->connect(i, *m_e2, i);
+    }
+    flush();
+
+    measure_control_wait(num_eps, num_bulk, 0, &send_data, &normal);
+    measure_control_wait(num_eps, num_bulk, UCT_PENDING_FLAG_PRIO_HIGH,
+                         &send_data, &prio);
+
+    UCS_TEST_MESSAGE << num_eps << " eps, " << num_bulk << " bulk messages "
+                     << "per ep, control message wait: normal "
+                     << normal.wait_usec << " usec (up to "
+                     << normal.max_all_ahead << " bulk ahead), high "
+                     << prio.wait_usec << " usec (up to "
+                     << prio.max_all_ahead << " bulk ahead)";
+
+    /* a normal control message waits for all bulk messages of its endpoint,
+     * a high priority one for none of them */
+    EXPECT_EQ(num_bulk, normal.min_ep_ahead);
+    EXPECT_EQ(num_bulk, normal.max_ep_ahead);
+    EXPECT_EQ(0u, prio.max_ep_ahead);
+    EXPECT_LT(prio.max_all_ahead, normal.max_all_ahead);
+    EXPECT_LT(prio.wait_usec, normal.wait_usec);
+
+    /* the shared memory transports dispatch all high priority groups first */
+    if (has_mm() || has_transport("intra")) {
+        EXPECT_EQ(0u, prio.max_all_ahead);
+    }
+}
+
 UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_uct_pending);
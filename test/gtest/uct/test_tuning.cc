@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2020.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+extern "C" {
+#include <uct/api/uct.h>
+#include <ucs/sys/math.h>
+}
+#include <common/test.h>
+#include "uct_test.h"
+
+#include <fstream>
+
+
+class test_uct_tuning : public uct_test {
+public:
+    virtual void init() {
+        const char *tmp_dir = getenv("TMPDIR");
+
+        uct_test::init();
+        m_profile_path = std::string((tmp_dir == NULL) ? "/tmp" : tmp_dir) +
+                         "/gtest_uct_tuning." + ucs::to_string(getpid());
+    }
+
+    virtual void cleanup() {
+        unlink(m_profile_path.c_str());
+        uct_test::cleanup();
+    }
+
+protected:
+    void write_profile(const std::string &dev_line) {
+        std::ofstream profile(m_profile_path.c_str());
+
+        profile << "# test profile" << std::endl
+                << std::endl
+                << "unknown/dev overhead=1 latency=2 bandwidth=3" << std::endl
+                << dev_line << std::endl;
+    }
+
+    std::string dev_id() const {
+        return GetParam()->tl_name + "/" + GetParam()->dev_name;
+    }
+
+    std::string m_profile_path;
+};
+
+
+UCS_TEST_P(test_uct_tuning, profile_override) {
+    entity *e = create_entity(0);
+    m_entities.push_back(e);
+    uct_iface_attr_t orig_attr = e->iface_attr();
+
+    write_profile(dev_id() + " overhead=123 latency=4567 bandwidth=890");
+    modify_config("TUNING_PATH", m_profile_path);
+
+    e = create_entity(0);
+    m_entities.push_back(e);
+    const uct_iface_attr_t &attr = e->iface_attr();
+
+    EXPECT_NEAR(123e-9,  attr.overhead,  1e-12);
+    EXPECT_NEAR(4567e-9, attr.latency.c, 1e-12);
+    EXPECT_DOUBLE_EQ(orig_attr.latency.m, attr.latency.m);
+    if (orig_attr.bandwidth.dedicated > 0) {
+        EXPECT_DOUBLE_EQ(890.0 * UCS_MBYTE, attr.bandwidth.dedicated);
+        EXPECT_DOUBLE_EQ(orig_attr.bandwidth.shared, attr.bandwidth.shared);
+    } else {
+        EXPECT_DOUBLE_EQ(890.0 * UCS_MBYTE, attr.bandwidth.shared);
+        EXPECT_DOUBLE_EQ(orig_attr.bandwidth.dedicated,
+                         attr.bandwidth.dedicated);
+    }
+
+    /* missing profile is ignored */
+    write_profile(dev_id() + " latency=100");
+    modify_config("TUNING_PATH", m_profile_path + ".missing");
+    {
+        scoped_log_handler wrap_warn(hide_warns_logger);
+        e = create_entity(0);
+    }
+    m_entities.push_back(e);
+    EXPECT_DOUBLE_EQ(orig_attr.overhead,  e->iface_attr().overhead);
+    EXPECT_DOUBLE_EQ(orig_attr.latency.c, e->iface_attr().latency.c);
+
+    /* values which are not listed keep the transport estimation */
+    modify_config("TUNING_PATH", m_profile_path);
+    e = create_entity(0);
+    m_entities.push_back(e);
+    EXPECT_DOUBLE_EQ(orig_attr.overhead, e->iface_attr().overhead);
+    EXPECT_NEAR(100e-9, e->iface_attr().latency.c, 1e-12);
+    EXPECT_DOUBLE_EQ(orig_attr.bandwidth.shared,
+                     e->iface_attr().bandwidth.shared);
+    EXPECT_DOUBLE_EQ(orig_attr.bandwidth.dedicated,
+                     e->iface_attr().bandwidth.dedicated);
+}
+
+UCT_INSTANTIATE_TEST_CASE(test_uct_tuning)
@@ -452,6 +452,7 @@ protected:
     tcp,                     \
     posix,                   \
     sysv,                    \
+    intra,                   \
     xpmem,                   \
     cma,                     \
     knem